@@ -0,0 +1,136 @@
+//! 前端基准: 词法分析与语法分析吞吐量 (MB/s)
+//!
+//! 比较单独词法分析、先生成标记向量再解析的两遍方式，
+//! 以及词法分析器直接向 LALRPOP 解析器供给标记的单遍方式；
+//! 另在数 MB 的生成源码上单独测量词法分析器吞吐量，
+//! 并对约 5 万行的生成源码计时类型检查，以及与 `qi check` 相同的解析加语义分析。
+//! 开始前先解析约 10 万行的生成项目并打印进程峰值内存。
+//!
+//! 运行: cargo bench --bench frontend
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use qi_compiler::lexer::Lexer;
+use qi_compiler::parser::{AstNode, Parser};
+use qi_compiler::semantic::{SemanticAnalyzer, TypeChecker};
+use qi_compiler::utils::memory;
+use std::hint::black_box;
+
+/// 生成约含 `函数数` 个函数的源码
+fn 生成源码(函数数: usize) -> String {
+    let mut 源码 = String::from("// 前端基准生成的源码\n包 基准;\n\n");
+    for i in 0..函数数 {
+        源码.push_str(&format!(
+            "函数 计算{i}(数值: 整数, 系数: 浮点数): 整数 {{\n\
+             \x20   变量 总和: 整数 = 0;\n\
+             \x20   /* 累加 */\n\
+             \x20   当 总和 < 数值 * 2 + {i} {{\n\
+             \x20       总和 = 总和 + 1;\n\
+             \x20   }}\n\
+             \x20   如果 总和 >= 100 {{\n\
+             \x20       返回 总和 - 1;\n\
+             \x20   }} 否则 {{\n\
+             \x20       打印(\"计算完成\", 系数, 3.25);\n\
+             \x20   }}\n\
+             \x20   返回 总和;\n\
+             }}\n\n"
+        ));
+    }
+    源码
+}
+
+/// 解析约 10 万行、分为 100 个模块的生成项目，保留全部 AST 后打印峰值内存
+fn 峰值内存报告(parser: &Parser) {
+    let 模块源码: Vec<String> = (0..100).map(|_| 生成源码(72)).collect();
+    let 行数: usize = 模块源码.iter().map(|源码| 源码.lines().count()).sum();
+    let 开始 = memory::format_peak_rss();
+    let 模块: Vec<_> = 模块源码.iter().map(|源码| parser.parse_source(源码).unwrap()).collect();
+    println!(
+        "解析 {} 行 ({} 个模块): 峰值内存 {} -> {}",
+        行数,
+        模块.len(),
+        开始,
+        memory::format_peak_rss(),
+    );
+}
+
+fn bench_frontend(c: &mut Criterion) {
+    let parser = Parser::new();
+    峰值内存报告(&parser);
+    let mut group = c.benchmark_group("前端");
+
+    for &函数数 in &[100usize, 1000] {
+        let 源码 = 生成源码(函数数);
+        parser.parse_source(&源码).expect("基准源码应能解析");
+        group.throughput(Throughput::Bytes(源码.len() as u64));
+
+        group.bench_with_input(BenchmarkId::new("词法分析", 函数数), &源码, |bench, 源码| {
+            bench.iter(|| black_box(Lexer::new(源码).tokenize().unwrap()))
+        });
+        group.bench_with_input(BenchmarkId::new("两遍解析", 函数数), &源码, |bench, 源码| {
+            bench.iter(|| {
+                let 标记 = Lexer::new(源码).tokenize().unwrap();
+                black_box(parser.parse(标记).unwrap())
+            })
+        });
+        group.bench_with_input(BenchmarkId::new("单遍解析", 函数数), &源码, |bench, 源码| {
+            bench.iter(|| black_box(parser.parse_source(源码).unwrap()))
+        });
+    }
+
+    group.finish();
+}
+
+fn bench_lexer(c: &mut Criterion) {
+    // 约 5 MB 源码
+    let 源码 = 生成源码(16_000);
+    let mut group = c.benchmark_group("词法分析器");
+    group.sample_size(20);
+    group.throughput(Throughput::Bytes(源码.len() as u64));
+
+    group.bench_function(BenchmarkId::new("标记向量", 源码.len()), |bench| {
+        bench.iter(|| black_box(Lexer::new(&源码).tokenize().unwrap()))
+    });
+    group.bench_function(BenchmarkId::new("逐个标记", 源码.len()), |bench| {
+        bench.iter(|| {
+            let mut 词法分析器 = Lexer::new(&源码);
+            let mut 数量 = 0usize;
+            while let Some(标记) = 词法分析器.next_significant_token() {
+                black_box(标记.unwrap());
+                数量 += 1;
+            }
+            数量
+        })
+    });
+
+    group.finish();
+}
+
+fn bench_check(c: &mut Criterion) {
+    // 约 5 万行源码
+    let 源码 = 生成源码(3600);
+    let 程序 = AstNode::程序(Parser::new().parse_source(&源码).unwrap());
+    let mut group = c.benchmark_group("类型检查");
+    group.sample_size(20);
+
+    group.bench_function(BenchmarkId::new("整个程序", 源码.lines().count()), |bench| {
+        bench.iter(|| {
+            let mut 检查器 = TypeChecker::new();
+            black_box(检查器.check(&程序).unwrap())
+        })
+    });
+
+    // 与 `qi check` 相同：解析后运行语义分析器
+    group.bench_function(BenchmarkId::new("解析与语义分析", 源码.lines().count()), |bench| {
+        let parser = Parser::new();
+        bench.iter(|| {
+            let 程序 = AstNode::程序(parser.parse_source(&源码).unwrap());
+            let mut 分析器 = SemanticAnalyzer::new();
+            black_box(分析器.analyze(&程序).is_ok())
+        })
+    });
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_frontend, bench_lexer, bench_check);
+criterion_main!(benches);
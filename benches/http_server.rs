@@ -0,0 +1,149 @@
+//! HTTP 服务器本地压测: 保持连接的并发客户端，类似 wrk
+//!
+//! 先做一轮定时压测并打印吞吐与 p50/p99 延迟，再由 criterion 比较
+//! 逐个请求与流水线批量请求的吞吐。
+//!
+//! 运行: cargo bench --bench http_server
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use qi_compiler::runtime::io::{HttpServer, HttpServerConfig, Response, Router};
+use std::io::{Read, Write};
+use std::net::{SocketAddr, TcpStream};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+const 请求报文: &[u8] = b"GET /plaintext HTTP/1.1\r\nHost: localhost\r\nUser-Agent: qi-bench\r\n\r\n";
+const 客户端数: usize = 64;
+const 压测时长: Duration = Duration::from_secs(3);
+const 每客户端请求: usize = 200;
+
+fn 启动服务器() -> (Arc<HttpServer>, std::thread::JoinHandle<()>) {
+    let 配置 = HttpServerConfig::new("127.0.0.1".to_string(), 0);
+    let 服务器 = Arc::new(HttpServer::bind(配置).unwrap());
+    let 副本 = Arc::clone(&服务器);
+    let 线程 = std::thread::spawn(move || {
+        let mut 路由 = Router::new();
+        路由.add("GET", "/plaintext", |_| Response::text(200, "Hello, World!"));
+        副本.serve(|请求| 路由.dispatch(请求)).unwrap();
+    });
+    (服务器, 线程)
+}
+
+fn 连接(地址: SocketAddr) -> TcpStream {
+    let 流 = TcpStream::connect(地址).unwrap();
+    流.set_nodelay(true).unwrap();
+    流
+}
+
+/// 响应长度固定，先探测一次，之后按长度整块读取
+fn 响应长度(地址: SocketAddr) -> usize {
+    let mut 流 = 连接(地址);
+    流.write_all(请求报文).unwrap();
+    let mut 已读 = Vec::new();
+    let mut 缓冲区 = [0u8; 1024];
+    loop {
+        let n = 流.read(&mut 缓冲区).unwrap();
+        已读.extend_from_slice(&缓冲区[..n]);
+        if let Some(头长) = 已读.windows(4).position(|w| w == b"\r\n\r\n").map(|p| p + 4) {
+            let 头 = String::from_utf8_lossy(&已读[..头长]).to_ascii_lowercase();
+            let 体长: usize = 头
+                .lines()
+                .find_map(|行| 行.strip_prefix("content-length:"))
+                .map(|值| 值.trim().parse().unwrap())
+                .unwrap();
+            return 头长 + 体长;
+        }
+    }
+}
+
+fn 百分位(排序后: &[Duration], 百分比: f64) -> Duration {
+    let 位置 = ((排序后.len() as f64 * 百分比).ceil() as usize).clamp(1, 排序后.len());
+    排序后[位置 - 1]
+}
+
+/// 定时压测：每个客户端在一条连接上逐个发请求，记录每个请求的延迟
+fn 定时压测(地址: SocketAddr, 响应长: usize) {
+    let 截止 = Instant::now() + 压测时长;
+    let 延迟们: Vec<Vec<Duration>> = std::thread::scope(|scope| {
+        let 客户端们: Vec<_> = (0..客户端数)
+            .map(|_| {
+                scope.spawn(move || {
+                    let mut 流 = 连接(地址);
+                    let mut 响应 = vec![0u8; 响应长];
+                    let mut 延迟 = Vec::with_capacity(64 * 1024);
+                    while Instant::now() < 截止 {
+                        let 开始 = Instant::now();
+                        流.write_all(请求报文).unwrap();
+                        流.read_exact(&mut 响应).unwrap();
+                        延迟.push(开始.elapsed());
+                    }
+                    延迟
+                })
+            })
+            .collect();
+        客户端们.into_iter().map(|客户端| 客户端.join().unwrap()).collect()
+    });
+
+    let mut 全部: Vec<Duration> = 延迟们.into_iter().flatten().collect();
+    全部.sort_unstable();
+    println!(
+        "HTTP服务器 {} 连接 {:?}: {:.0} 请求/秒, p50 {:?}, p99 {:?}, 最大 {:?}",
+        客户端数,
+        压测时长,
+        全部.len() as f64 / 压测时长.as_secs_f64(),
+        百分位(&全部, 0.50),
+        百分位(&全部, 0.99),
+        全部.last().copied().unwrap_or_default(),
+    );
+}
+
+/// 每个客户端发送 每客户端请求 个请求，流水线深度为 深度
+fn 运行客户端(地址: SocketAddr, 响应长: usize, 深度: usize) {
+    std::thread::scope(|scope| {
+        for _ in 0..客户端数 {
+            scope.spawn(move || {
+                let mut 流 = 连接(地址);
+                let 批量请求 = 请求报文.repeat(深度);
+                let mut 批量响应 = vec![0u8; 响应长 * 深度];
+                for _ in 0..每客户端请求 / 深度 {
+                    流.write_all(&批量请求).unwrap();
+                    流.read_exact(&mut 批量响应).unwrap();
+                }
+            });
+        }
+    });
+}
+
+fn bench_http_server(c: &mut Criterion) {
+    let (服务器, 线程) = 启动服务器();
+    let 地址 = 服务器.local_addr();
+    let 响应长 = 响应长度(地址);
+
+    定时压测(地址, 响应长);
+
+    let mut group = c.benchmark_group("HTTP服务器");
+    group.sample_size(10);
+    group.throughput(Throughput::Elements((客户端数 * 每客户端请求) as u64));
+    for 深度 in [1usize, 16] {
+        group.bench_with_input(BenchmarkId::new("流水线深度", 深度), &深度, |bench, &深度| {
+            bench.iter_custom(|迭代次数| {
+                let 开始 = Instant::now();
+                for _ in 0..迭代次数 {
+                    运行客户端(地址, 响应长, 深度);
+                }
+                开始.elapsed()
+            })
+        });
+    }
+    group.finish();
+
+    服务器.close();
+    线程.join().unwrap();
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().measurement_time(Duration::from_secs(5));
+    targets = bench_http_server
+}
+criterion_main!(benches);
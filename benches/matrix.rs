@@ -0,0 +1,40 @@
+//! 矩阵乘法基准: 分块 SIMD GEMM 与朴素三重循环对比
+//!
+//! 运行: cargo bench --bench matrix
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion};
+use qi_compiler::runtime::stdlib::矩阵;
+use std::hint::black_box;
+
+fn 样例(阶数: usize) -> 矩阵 {
+    let 数据 = (0..阶数 * 阶数).map(|i| (i % 17) as f64 * 0.25 - 2.0).collect();
+    矩阵::从数据(阶数, 阶数, 数据).unwrap()
+}
+
+fn bench_gemm(c: &mut Criterion) {
+    let mut group = c.benchmark_group("矩阵乘法");
+    group.sample_size(10);
+
+    for &阶数 in &[64usize, 256, 512] {
+        let a = 样例(阶数);
+        let b = 样例(阶数);
+        group.bench_with_input(BenchmarkId::new("分块", 阶数), &阶数, |bench, _| {
+            bench.iter(|| black_box(a.乘法(&b).unwrap()))
+        });
+        group.bench_with_input(BenchmarkId::new("朴素", 阶数), &阶数, |bench, _| {
+            bench.iter(|| black_box(a.朴素乘法(&b).unwrap()))
+        });
+    }
+
+    group.finish();
+}
+
+fn bench_gemv_transpose(c: &mut Criterion) {
+    let a = 样例(1024);
+    let x = vec![1.5; 1024];
+    c.bench_function("矩阵向量乘/1024", |bench| bench.iter(|| black_box(a.矩阵向量乘(&x).unwrap())));
+    c.bench_function("矩阵转置/1024", |bench| bench.iter(|| black_box(a.转置())));
+}
+
+criterion_group!(benches, bench_gemm, bench_gemv_transpose);
+criterion_main!(benches);
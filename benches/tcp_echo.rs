@@ -0,0 +1,84 @@
+//! 本地回显服务器吞吐基准: SO_REUSEPORT 多接收器与单接收器对比
+//!
+//! 运行: cargo bench --bench tcp_echo
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use qi_compiler::runtime::io::{ListenerConfig, TcpListener};
+use std::io::{Read, Write};
+use std::net::{SocketAddr, TcpStream};
+use std::time::{Duration, Instant};
+
+const 消息长度: usize = 64;
+const 客户端数: usize = 32;
+const 每客户端往返: usize = 200;
+
+fn 回显服务器(接收器数: usize) -> TcpListener {
+    let 配置 = ListenerConfig::new("127.0.0.1".to_string(), 0).with_workers(接收器数);
+    TcpListener::bind(&配置).unwrap()
+}
+
+/// 每次迭代新建连接并完成若干往返，同时计入接受连接和回显的开销
+fn 运行客户端(地址: SocketAddr) {
+    std::thread::scope(|scope| {
+        for _ in 0..客户端数 {
+            scope.spawn(move || {
+                let mut 流 = TcpStream::connect(地址).unwrap();
+                流.set_nodelay(true).unwrap();
+                let 请求 = [7u8; 消息长度];
+                let mut 回显 = [0u8; 消息长度];
+                for _ in 0..每客户端往返 {
+                    流.write_all(&请求).unwrap();
+                    流.read_exact(&mut 回显).unwrap();
+                }
+            });
+        }
+    });
+}
+
+fn bench_echo(c: &mut Criterion) {
+    let mut group = c.benchmark_group("TCP回显");
+    group.sample_size(10);
+    group.throughput(Throughput::Bytes((消息长度 * 客户端数 * 每客户端往返 * 2) as u64));
+
+    let 核心数 = std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1);
+    let mut 接收器配置 = vec![1usize, 核心数];
+    接收器配置.dedup();
+    for &接收器数 in &接收器配置 {
+        let 监听器 = 回显服务器(接收器数);
+        let 地址 = 监听器.local_addr();
+        std::thread::scope(|scope| {
+            let 服务 = scope.spawn(|| {
+                监听器.serve(|连接| {
+                    let mut 缓冲区 = [0u8; 4096];
+                    while let Ok(n) = 连接.read(&mut 缓冲区) {
+                        if n == 0 || 连接.write(&缓冲区[..n]).is_err() {
+                            break;
+                        }
+                    }
+                })
+            });
+
+            group.bench_with_input(BenchmarkId::new("接收器", 接收器数), &接收器数, |bench, _| {
+                bench.iter_custom(|迭代次数| {
+                    let 开始 = Instant::now();
+                    for _ in 0..迭代次数 {
+                        运行客户端(地址);
+                    }
+                    开始.elapsed()
+                })
+            });
+
+            监听器.close();
+            服务.join().unwrap().unwrap();
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().measurement_time(Duration::from_secs(5));
+    targets = bench_echo
+}
+criterion_main!(benches);
@@ -0,0 +1,129 @@
+//! UDP 回环每秒包数压测: 指标上报大小的小数据报
+//!
+//! 比较三种收发方式：逐包 send_to/recv_from、sendmmsg/recvmmsg 批量、
+//! GSO 分段发送配合 GRO 接收。先各做一轮定时压测并打印包/秒，
+//! 再由 criterion 逐批比较。
+//!
+//! 运行: cargo bench --bench udp_pps
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use qi_compiler::runtime::io::udp::GRO_SLOT_SIZE;
+use qi_compiler::runtime::io::{PacketBatch, UdpSocket};
+use std::net::SocketAddr;
+use std::time::{Duration, Instant};
+
+const 包大小: usize = 64;
+const 批大小: usize = 64;
+const 压测时长: Duration = Duration::from_secs(2);
+const 接收超时: Option<Duration> = Some(Duration::from_secs(1));
+
+#[derive(Clone, Copy, Debug)]
+enum 方式 {
+    逐包,
+    批量,
+    分段,
+}
+
+struct 回环 {
+    发送端: UdpSocket,
+    接收端: UdpSocket,
+    目标: SocketAddr,
+    批次: PacketBatch,
+    负载: Vec<u8>,
+}
+
+impl 回环 {
+    fn new(方式: 方式) -> Self {
+        let 发送端 = UdpSocket::bind("127.0.0.1", 0).unwrap();
+        let 接收端 = UdpSocket::bind("127.0.0.1", 0).unwrap();
+        接收端.set_buffer_sizes(4 << 20, 4 << 20).ok();
+        let 槽大小 = match 方式 {
+            方式::分段 if 接收端.enable_gro() => GRO_SLOT_SIZE,
+            _ => 2048,
+        };
+        let 目标 = 接收端.local_addr();
+        Self {
+            发送端,
+            接收端,
+            目标,
+            批次: PacketBatch::new(批大小, 槽大小),
+            负载: (0..包大小 * 批大小).map(|i| i as u8).collect(),
+        }
+    }
+
+    /// 发出一批数据报并全部收回，返回收到的数据报数
+    fn 往返(&mut self, 方式: 方式) -> usize {
+        match 方式 {
+            方式::逐包 => {
+                for 包 in self.负载.chunks(包大小) {
+                    self.发送端.send_to(包, self.目标).unwrap();
+                }
+                let mut 缓冲区 = [0u8; 2048];
+                let mut 收到 = 0;
+                while 收到 < 批大小 {
+                    match self.接收端.recv_from(&mut 缓冲区, 接收超时).unwrap() {
+                        Some(_) => 收到 += 1,
+                        None => break,
+                    }
+                }
+                收到
+            }
+            方式::批量 | 方式::分段 => {
+                if let 方式::批量 = 方式 {
+                    let 数据包: Vec<(&[u8], SocketAddr)> =
+                        self.负载.chunks(包大小).map(|包| (包, self.目标)).collect();
+                    self.发送端.send_batch(&数据包).unwrap();
+                } else {
+                    self.发送端.send_segments(&self.负载, 包大小, self.目标).unwrap();
+                }
+                let mut 收到 = 0;
+                while 收到 < 批大小 {
+                    if self.接收端.recv_batch(&mut self.批次, 接收超时).unwrap() == 0 {
+                        break;
+                    }
+                    收到 += self.批次.datagrams().count();
+                }
+                收到
+            }
+        }
+    }
+}
+
+fn 定时压测(方式: 方式) {
+    let mut 回环 = 回环::new(方式);
+    let 开始 = Instant::now();
+    let mut 总数 = 0usize;
+    while 开始.elapsed() < 压测时长 {
+        总数 += 回环.往返(方式);
+    }
+    println!(
+        "UDP回环 {:?} {} 字节: {:.0} 包/秒 (GSO {})",
+        方式,
+        包大小,
+        总数 as f64 / 开始.elapsed().as_secs_f64(),
+        回环.发送端.gso_enabled(),
+    );
+}
+
+fn bench_udp_pps(c: &mut Criterion) {
+    for 方式 in [方式::逐包, 方式::批量, 方式::分段] {
+        定时压测(方式);
+    }
+
+    let mut group = c.benchmark_group("UDP回环");
+    group.throughput(Throughput::Elements(批大小 as u64));
+    for 方式 in [方式::逐包, 方式::批量, 方式::分段] {
+        let mut 回环 = 回环::new(方式);
+        group.bench_function(BenchmarkId::new("收发方式", format!("{:?}", 方式)), |bench| {
+            bench.iter(|| 回环.往返(方式))
+        });
+    }
+    group.finish();
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().measurement_time(Duration::from_secs(5));
+    targets = bench_udp_pps
+}
+criterion_main!(benches);
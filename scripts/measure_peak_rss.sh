@@ -0,0 +1,122 @@
+#!/bin/bash
+
+# measure_peak_rss.sh - 生成约 10 万行的多模块项目并测量编译器峰值内存
+# Script to measure peak compiler RSS on a generated ~100k-line project
+#
+# 用法 | Usage: scripts/measure_peak_rss.sh [模块数] [每模块函数数] [基线修订]
+# 默认 100 个模块 × 72 个函数，约 10 万行 | Default: 100 modules x 72 functions
+# 给出基线修订（如 HEAD~1）时，同时构建该修订并测量同一项目，输出前后对比
+# With a baseline revision (e.g. HEAD~1), that revision is built as well and
+# measured on the same project, for a before/after comparison
+
+set -e  # 遇到错误时立即退出
+
+# 颜色定义
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+MODULES=${1:-100}
+FUNCTIONS=${2:-72}
+BASELINE=$3
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+WORK_DIR="$(mktemp -d)"
+cleanup() {
+    if [ -n "$BASELINE" ]; then
+        git -C "$PROJECT_ROOT" worktree remove --force "$WORK_DIR/基线源码" >/dev/null 2>&1 || true
+    fi
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+echo -e "${BLUE}========================================${NC}"
+echo -e "${BLUE}编译器峰值内存测量 | Compiler peak RSS${NC}"
+echo -e "${BLUE}========================================${NC}"
+
+echo -e "${YELLOW}正在构建编译器... | Building compiler...${NC}"
+(cd "$PROJECT_ROOT" && cargo build --release --bin qi)
+QI="$PROJECT_ROOT/target/release/qi"
+
+if [ -n "$BASELINE" ]; then
+    echo -e "${YELLOW}正在构建基线 $BASELINE... | Building baseline $BASELINE...${NC}"
+    git -C "$PROJECT_ROOT" worktree add --detach "$WORK_DIR/基线源码" "$BASELINE" >/dev/null
+    (cd "$WORK_DIR/基线源码" && cargo build --release --bin qi --target-dir "$PROJECT_ROOT/target/基线")
+    BASELINE_QI="$PROJECT_ROOT/target/基线/release/qi"
+fi
+
+# 每个模块是一个本地包：模块N/模块N.qi，函数与前端基准生成的源码相同
+echo -e "${YELLOW}正在生成项目... | Generating project...${NC}"
+MAIN="$WORK_DIR/主程序.qi"
+echo "包 主程序;" > "$MAIN"
+echo >> "$MAIN"
+for ((m = 0; m < MODULES; m++)); do
+    echo "导入 模块$m;" >> "$MAIN"
+    mkdir -p "$WORK_DIR/模块$m"
+    {
+        echo "包 模块$m;"
+        echo
+        for ((i = 0; i < FUNCTIONS; i++)); do
+            cat <<EOF
+公开 函数 计算$i(数值: 整数, 系数: 浮点数): 整数 {
+    变量 总和: 整数 = 0;
+    /* 累加 */
+    当 总和 < 数值 * 2 + $i {
+        总和 = 总和 + 1;
+    }
+    如果 总和 >= 100 {
+        返回 总和 - 1;
+    } 否则 {
+        打印("计算完成", 系数, 3.25);
+    }
+    返回 总和;
+}
+
+EOF
+        done
+    } > "$WORK_DIR/模块$m/模块$m.qi"
+done
+{
+    echo
+    echo "函数 入口() {"
+    echo "    打印行(模块0.计算0(1, 1.0));"
+    echo "}"
+} >> "$MAIN"
+
+lines=$(cat "$MAIN" "$WORK_DIR"/模块*/*.qi | wc -l | tr -d ' ')
+echo -e "${GREEN}生成 $MODULES 个模块，共 $lines 行 | Generated $MODULES modules, $lines lines${NC}"
+
+# 禁用缓存，确保每个模块都被解析和编译
+# 有 GNU time 时由它测量峰值内存，旧版本编译器不自行报告峰值内存也能对比
+measure() {
+    local label=$1
+    local qi=$2
+    local output
+    if [ -x /usr/bin/time ]; then
+        if ! output=$(/usr/bin/time -v "$qi" -v --no-cache compile "$MAIN" -o "$WORK_DIR/程序" 2>&1); then
+            echo "$output"
+            echo -e "${RED}$label 编译失败 | $label compilation failed${NC}"
+            exit 1
+        fi
+        local kb
+        kb=$(echo "$output" | sed -n 's/.*Maximum resident set size (kbytes): //p')
+        echo -e "${GREEN}$label: 峰值内存 $((kb / 1024)) MB ($kb KB)${NC}"
+    else
+        if ! output=$("$qi" -v --no-cache compile "$MAIN" -o "$WORK_DIR/程序" 2>&1); then
+            echo "$output"
+            echo -e "${RED}$label 编译失败 | $label compilation failed${NC}"
+            exit 1
+        fi
+        echo -e "${GREEN}$label:${NC}"
+    fi
+    echo "$output" | grep -E "编译完成|峰值内存" || true
+}
+
+cd "$WORK_DIR"
+if [ -n "$BASELINE" ]; then
+    measure "基线 $BASELINE" "$BASELINE_QI"
+fi
+measure "当前 | current" "$QI"
@@ -63,6 +63,22 @@ pub struct Cli {
     #[arg(short, long)]
     pub verbose: bool,
 
+    /// 启用快速浮点数学 | Enable fast-math for math intrinsics
+    #[arg(long)]
+    pub fast_math: bool,
+
+    /// 并行编译任务数（默认为 CPU 核心数） | Parallel compile jobs (default: CPU cores)
+    #[arg(short = 'j', long)]
+    pub jobs: Option<usize>,
+
+    /// 目标文件缓存目录（默认为 .qi_cache） | Object file cache directory (default: .qi_cache)
+    #[arg(long)]
+    pub cache_dir: Option<PathBuf>,
+
+    /// 禁用目标文件缓存 | Disable the object file cache
+    #[arg(long)]
+    pub no_cache: bool,
+
     /// 配置文件路径 | Config file path
     #[arg(long)]
     pub config: Option<PathBuf>,
@@ -288,6 +304,7 @@ impl Cli {
 
             if config.verbose {
                 println!("  编译完成，耗时: {}ms", result.duration_ms);
+                println!("  峰值内存: {}", crate::utils::memory::format_peak_rss());
             }
 
             // Handle warnings
@@ -477,6 +494,7 @@ impl Cli {
 
         if config.verbose {
             println!("  编译完成，耗时: {}ms", compile_result.duration_ms);
+            println!("  峰值内存: {}", crate::utils::memory::format_peak_rss());
         }
 
         // Handle warnings
@@ -717,9 +735,12 @@ impl Cli {
             return Err(CliError::NoInputFiles);
         }
 
-        use crate::parser::Parser;
+        use crate::parser::{AstNode, Parser};
+        use crate::semantic::SemanticAnalyzer;
+        let started = std::time::Instant::now();
         let parser = Parser::new();
         let mut all_passed = true;
+        let mut semantic_warnings = 0;
 
         for file in &files {
             if config.verbose {
@@ -730,10 +751,25 @@ impl Cli {
                 .map_err(|e| CliError::Io(e))?;
 
             match parser.parse_source(&source) {
-                Ok(_) => {
+                Ok(program) => {
                     if config.verbose {
                         println!("  ✓ 语法正确");
                     }
+
+                    // The analyzer does not know runtime builtins or imported
+                    // modules yet, so its findings are reported as warnings
+                    let mut analyzer = SemanticAnalyzer::new();
+                    match analyzer.analyze(&AstNode::程序(program)) {
+                        Ok(()) => {
+                            if config.verbose {
+                                println!("  ✓ 语义检查通过");
+                            }
+                        }
+                        Err(semantic_error) => {
+                            semantic_warnings += 1;
+                            eprintln!("  ⚠ 语义警告: {} ({:?})", semantic_error, file);
+                        }
+                    }
                 }
                 Err(parse_error) => {
                     all_passed = false;
@@ -742,9 +778,17 @@ impl Cli {
             }
         }
 
+        if config.verbose {
+            println!("  检查完成，耗时: {}ms", started.elapsed().as_millis());
+        }
+
         if all_passed {
             if !config.verbose {
-                println!("所有文件语法检查通过");
+                if semantic_warnings > 0 {
+                    println!("所有文件语法检查通过，{} 个文件有语义警告", semantic_warnings);
+                } else {
+                    println!("所有文件语法检查通过");
+                }
             }
         } else {
             return Err(CliError::Compilation(crate::CompilerError::Codegen(
@@ -259,6 +259,8 @@ pub struct IrBuilder {
     current_function_name: Option<String>,
     /// Current function's AST return type (for Future wrapping detection)
     current_function_ast_return_type: Option<crate::parser::ast::TypeNode>,
+    /// Emit `fast` flags on floating point math intrinsics
+    fast_math: bool,
 }
 
 impl IrBuilder {
@@ -290,6 +292,7 @@ impl IrBuilder {
             scope_level: 0,
             current_function_name: None,
             current_function_ast_return_type: None,
+            fast_math: false,
         }.register_runtime_functions()
     }
 
@@ -328,6 +331,59 @@ impl IrBuilder {
         self.external_functions.insert("malloc".to_string(), (vec!["i64".to_string()], "ptr".to_string()));
         self.external_functions.insert("free".to_string(), (vec!["ptr".to_string()], "void".to_string()));
 
+        // Whole-array and matrix kernels take explicit lengths since Qi arrays carry none
+        let array_math: [(&str, &[&str], &str); 19] = [
+            ("qi_runtime_array_sum_int", &["ptr", "i64"], "i64"),
+            ("qi_runtime_array_sum_float", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_min_int", &["ptr", "i64"], "i64"),
+            ("qi_runtime_array_max_int", &["ptr", "i64"], "i64"),
+            ("qi_runtime_array_min_float", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_max_float", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_dot_float", &["ptr", "ptr", "i64"], "double"),
+            ("qi_runtime_array_mean_int", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_mean_float", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_variance_int", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_variance_float", &["ptr", "i64"], "double"),
+            ("qi_runtime_array_sqrt_float", &["ptr", "i64"], "i32"),
+            ("qi_runtime_array_exp_float", &["ptr", "i64"], "i32"),
+            ("qi_runtime_array_log_float", &["ptr", "i64"], "i32"),
+            ("qi_runtime_array_clamp_int", &["ptr", "i64", "i64", "i64"], "i32"),
+            ("qi_runtime_array_clamp_float", &["ptr", "i64", "double", "double"], "i32"),
+            ("qi_runtime_matrix_multiply", &["ptr", "ptr", "ptr", "i64", "i64", "i64"], "i32"),
+            ("qi_runtime_matrix_vector_multiply", &["ptr", "ptr", "ptr", "i64", "i64"], "i32"),
+            ("qi_runtime_matrix_transpose", &["ptr", "ptr", "i64", "i64"], "i32"),
+        ];
+        for (name, params, ret) in array_math {
+            self.external_functions.insert(
+                name.to_string(),
+                (params.iter().map(|p| p.to_string()).collect(), ret.to_string()),
+            );
+        }
+
+        // Handle-based binary and positional file I/O
+        let file_io: [(&str, &[&str], &str); 8] = [
+            ("qi_runtime_file_read_int", &["i64"], "i64"),
+            ("qi_runtime_file_write_int", &["i64", "i64"], "i64"),
+            ("qi_runtime_file_read_byte", &["i64"], "i64"),
+            ("qi_runtime_file_write_byte", &["i64", "i64"], "i64"),
+            ("qi_runtime_file_eof", &["i64"], "i64"),
+            ("qi_runtime_file_pread", &["i64", "ptr", "i64", "i64"], "i64"),
+            ("qi_runtime_file_pwrite", &["i64", "ptr", "i64", "i64"], "i64"),
+            ("qi_runtime_file_flush", &["i64"], "i32"),
+        ];
+        for (name, params, ret) in file_io {
+            self.external_functions.insert(
+                name.to_string(),
+                (params.iter().map(|p| p.to_string()).collect(), ret.to_string()),
+            );
+        }
+
+        // Standard input scanning
+        self.external_functions.insert("qi_runtime_read_int".to_string(), (vec![], "i64".to_string()));
+        self.external_functions.insert("qi_runtime_read_float".to_string(), (vec![], "double".to_string()));
+        self.external_functions.insert("qi_runtime_read_word".to_string(), (vec![], "ptr".to_string()));
+        self.external_functions.insert("qi_runtime_read_line".to_string(), (vec![], "ptr".to_string()));
+
         // Other runtime functions can be added here if needed
         self
     }
@@ -471,6 +527,29 @@ impl IrBuilder {
         self.import_aliases = aliases;
     }
 
+    /// Enable or disable fast-math flags on math intrinsic calls
+    pub fn set_fast_math(&mut self, enabled: bool) {
+        self.fast_math = enabled;
+    }
+
+    /// Map a direct runtime math call to the equivalent LLVM intrinsic
+    /// Direct calls are lowered so LLVM can inline, constant-fold and vectorize them;
+    /// the `qi_runtime_math_*` FFI symbols remain for indirect calls (and `tan`, which has no intrinsic)
+    fn math_intrinsic(callee: &str) -> Option<&'static str> {
+        match callee {
+            "qi_runtime_math_sqrt" => Some("llvm.sqrt.f64"),
+            "qi_runtime_math_pow" => Some("llvm.pow.f64"),
+            "qi_runtime_math_sin" => Some("llvm.sin.f64"),
+            "qi_runtime_math_cos" => Some("llvm.cos.f64"),
+            "qi_runtime_math_floor" => Some("llvm.floor.f64"),
+            "qi_runtime_math_ceil" => Some("llvm.ceil.f64"),
+            "qi_runtime_math_round" => Some("llvm.round.f64"),
+            "qi_runtime_math_abs_float" => Some("llvm.fabs.f64"),
+            "qi_runtime_math_abs_int" => Some("llvm.abs.i64"),
+            _ => None,
+        }
+    }
+
     /// Process an import statement and register the imported module
     fn process_import(&mut self, import_stmt: &crate::parser::ast::ImportStatement) -> Result<(), String> {
         // Check if this is a relative path (starts with . or ..)
@@ -771,10 +850,43 @@ impl IrBuilder {
             "关闭文件" | "关闭" | "close" => Some("qi_runtime_file_close"),
             "读取文本" => Some("qi_runtime_file_read_string"),
             "写入文本" => Some("qi_runtime_file_write_string"),
+            "文件读取整数" => Some("qi_runtime_file_read_int"),
+            "文件写入整数" => Some("qi_runtime_file_write_int"),
+            "文件读取字节" | "读取字节" => Some("qi_runtime_file_read_byte"),
+            "文件写入字节" | "写入字节" => Some("qi_runtime_file_write_byte"),
+            "文件已结束" | "eof" => Some("qi_runtime_file_eof"),
+            "定位读取" | "pread" => Some("qi_runtime_file_pread"),
+            "定位写入" | "pwrite" => Some("qi_runtime_file_pwrite"),
+            "刷新文件" | "flush" => Some("qi_runtime_file_flush"),
+
+            // Standard input
+            "读取整数" | "read_int" => Some("qi_runtime_read_int"),
+            "读取浮点数" | "read_float" => Some("qi_runtime_read_float"),
+            "读取单词" | "read_word" => Some("qi_runtime_read_word"),
+            "读取行" | "read_line" => Some("qi_runtime_read_line"),
 
             // Array operations
             "创建数组" | "create_array" => Some("qi_runtime_array_create"),
             "数组长度" | "array_len" => Some("qi_runtime_array_length"),
+            "数组求和" | "array_sum" => Some("qi_runtime_array_sum_int"),
+            "浮点数组求和" | "array_sum_float" => Some("qi_runtime_array_sum_float"),
+            "数组最小值" | "array_min" => Some("qi_runtime_array_min_int"),
+            "浮点数组最小值" | "array_min_float" => Some("qi_runtime_array_min_float"),
+            "数组最大值" | "array_max" => Some("qi_runtime_array_max_int"),
+            "浮点数组最大值" | "array_max_float" => Some("qi_runtime_array_max_float"),
+            "点积" | "dot" => Some("qi_runtime_array_dot_float"),
+            "数组平均值" | "array_mean" => Some("qi_runtime_array_mean_int"),
+            "浮点数组平均值" | "array_mean_float" => Some("qi_runtime_array_mean_float"),
+            "数组方差" | "array_variance" => Some("qi_runtime_array_variance_int"),
+            "浮点数组方差" | "array_variance_float" => Some("qi_runtime_array_variance_float"),
+            "数组平方根" | "array_sqrt" => Some("qi_runtime_array_sqrt_float"),
+            "数组指数" | "array_exp" => Some("qi_runtime_array_exp_float"),
+            "数组对数" | "array_log" => Some("qi_runtime_array_log_float"),
+            "数组限幅" | "array_clamp" => Some("qi_runtime_array_clamp_int"),
+            "浮点数组限幅" | "array_clamp_float" => Some("qi_runtime_array_clamp_float"),
+            "矩阵乘法" | "matmul" => Some("qi_runtime_matrix_multiply"),
+            "矩阵向量乘" | "matvec" => Some("qi_runtime_matrix_vector_multiply"),
+            "矩阵转置" | "transpose" => Some("qi_runtime_matrix_transpose"),
 
             // Type conversions
             "整数转字符串" | "int_to_string" => Some("qi_runtime_int_to_string"),
@@ -808,6 +920,8 @@ impl IrBuilder {
             "发送" | "send" => Some("qi_runtime_channel_send"), // Default to int for now
             "接收" | "receive" => Some("qi_runtime_channel_receive"), // Default to int for now
             "关闭通道" | "close_channel" => Some("qi_runtime_channel_close"),
+            "创建进程通道" => Some("qi_runtime_ipc_create_channel"),
+            "打开进程通道" => Some("qi_runtime_ipc_open_channel"),
 
             // Timeout and error handling operations
             "设置超时" | "set_timeout" | "timeout" => Some("qi_runtime_set_timeout"),
@@ -958,7 +1072,9 @@ impl IrBuilder {
                             // Check if this is a function call that returns a string or number
                             let function_name = self.get_full_function_name(call_expr);
                             let ty = if let Some(runtime_func) = self.map_to_runtime_function(&function_name) {
-                                if runtime_func.contains("math_sqrt") || runtime_func.contains("math_pow") ||
+                                if let Some((_, ret_type)) = self.external_functions.get(runtime_func.as_str()) {
+                                    ret_type.as_str()  // Registered runtime signature
+                                } else if runtime_func.contains("math_sqrt") || runtime_func.contains("math_pow") ||
                                    runtime_func.contains("math_sin") || runtime_func.contains("math_cos") ||
                                    runtime_func.contains("math_tan") || runtime_func.contains("math_floor") ||
                                    runtime_func.contains("math_ceil") || runtime_func.contains("math_round") ||
@@ -986,6 +1102,7 @@ impl IrBuilder {
                                           runtime_func.contains("rwlock_create") ||
                                           runtime_func.contains("timer_create") ||
                                           runtime_func.contains("create_channel") ||
+                                          runtime_func.contains("open_channel") ||
                                           runtime_func.contains("create_task") {
                                     "ptr"  // Synchronization primitives and async constructs return pointers
                                 } else if runtime_func == "qi_runtime_set_timeout" || runtime_func == "qi_runtime_timer_expired" ||
@@ -2262,6 +2379,7 @@ impl IrBuilder {
                                       mapped_callee.contains("file_write") || mapped_callee.contains("tcp_connect") ||
                                       mapped_callee.contains("string_to_int") || mapped_callee.contains("float_to_int") ||
                                       mapped_callee.contains("create_channel") || mapped_callee.contains("create_task") ||
+                                      mapped_callee.contains("open_channel") ||
                                       mapped_callee.contains("create_timer") {
                                 "i64"  // Functions that explicitly return i64 or pointers treated as i64
                             } else if mapped_callee == "qi_runtime_set_timeout" || mapped_callee == "qi_runtime_timer_expired" ||
@@ -3658,6 +3776,8 @@ impl IrBuilder {
         ir.push_str("declare i32 @qi_runtime_channel_send(ptr, i64)\n");
         ir.push_str("declare i32 @qi_runtime_channel_receive(ptr, ptr)\n");
         ir.push_str("declare i32 @qi_runtime_channel_close(ptr)\n");
+        ir.push_str("declare ptr @qi_runtime_ipc_create_channel(ptr, i64)\n");
+        ir.push_str("declare ptr @qi_runtime_ipc_open_channel(ptr)\n");
         ir.push_str("\n");
 
         // Synchronization functions - WaitGroup operations
@@ -3745,6 +3865,15 @@ impl IrBuilder {
         ir.push_str("declare i64 @qi_io_file_size(ptr)\n");
         ir.push_str("declare i64 @qi_io_create_dir(ptr)\n");
         ir.push_str("declare i64 @qi_io_delete_dir(ptr)\n");
+        ir.push_str("declare i64 @qi_io_copy_file(ptr, ptr)\n");
+        ir.push_str("declare ptr @qi_io_walk_dir(ptr, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_io_open_appender(ptr, i64)\n");
+        ir.push_str("declare i64 @qi_io_appender_append(i64, ptr)\n");
+        ir.push_str("declare i64 @qi_io_appender_flush(i64)\n");
+        ir.push_str("declare i64 @qi_io_close_appender(i64)\n");
+        ir.push_str("declare i64 @qi_io_open_lines(ptr)\n");
+        ir.push_str("declare ptr @qi_io_next_line(i64)\n");
+        ir.push_str("declare i64 @qi_io_close_lines(i64)\n");
         ir.push_str("declare void @qi_io_free_string(ptr)\n");
         ir.push_str("\n");
 
@@ -3755,9 +3884,29 @@ impl IrBuilder {
         ir.push_str("declare i64 @qi_network_tcp_write(i64, ptr, i64)\n");
         ir.push_str("declare i64 @qi_network_tcp_close(i64)\n");
         ir.push_str("declare i64 @qi_network_tcp_flush(i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_connect_with_options(ptr, i16, i64, i64, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_writev(i64, ptr, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_readv(i64, ptr, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_write_zerocopy(i64, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_zerocopy_wait(i64, i64)\n");
         ir.push_str("declare i64 @qi_network_tcp_bytes_read(i64)\n");
         ir.push_str("declare i64 @qi_network_tcp_bytes_written(i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_listen(ptr, i16, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_accept(i64, i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_serve(i64, ptr)\n");
+        ir.push_str("declare i64 @qi_network_tcp_listener_port(i64)\n");
+        ir.push_str("declare i64 @qi_network_tcp_listener_close(i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_bind(ptr, i16)\n");
+        ir.push_str("declare i64 @qi_network_udp_send_to(i64, ptr, i16, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_recv(i64, ptr, i64, i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_recv_batch(i64, ptr, i64, ptr, i64, i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_send_batch(i64, ptr, i16, ptr, ptr, i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_local_port(i64)\n");
+        ir.push_str("declare i64 @qi_network_udp_close(i64)\n");
         ir.push_str("declare ptr @qi_network_resolve_host(ptr)\n");
+        ir.push_str("declare i64 @qi_network_resolve_host_async(ptr)\n");
+        ir.push_str("declare i64 @qi_network_resolve_ready(i64)\n");
+        ir.push_str("declare ptr @qi_network_resolve_wait(i64, i64)\n");
         ir.push_str("declare i64 @qi_network_port_available(i16)\n");
         ir.push_str("declare ptr @qi_network_get_local_ip()\n");
         ir.push_str("declare void @qi_network_free_string(ptr)\n");
@@ -3777,6 +3926,32 @@ impl IrBuilder {
         ir.push_str("declare ptr @qi_http_request_execute(i64)\n");
         ir.push_str("declare i64 @qi_http_get_status(ptr)\n");
         ir.push_str("declare void @qi_http_free_string(ptr)\n");
+        ir.push_str("declare i64 @qi_http_server_create(ptr, i16)\n");
+        ir.push_str("declare i64 @qi_http_server_route(i64, ptr, ptr, ptr)\n");
+        ir.push_str("declare i64 @qi_http_server_port(i64)\n");
+        ir.push_str("declare i64 @qi_http_server_next_request(i64, i64)\n");
+        ir.push_str("declare ptr @qi_http_server_request_method(i64)\n");
+        ir.push_str("declare ptr @qi_http_server_request_path(i64)\n");
+        ir.push_str("declare ptr @qi_http_server_request_header(i64, ptr)\n");
+        ir.push_str("declare ptr @qi_http_server_request_body(i64)\n");
+        ir.push_str("declare i64 @qi_http_server_respond(i64, i64, ptr, ptr)\n");
+        ir.push_str("declare i64 @qi_http_server_close(i64)\n");
+        ir.push_str("\n");
+
+        // Process functions
+        ir.push_str("; Process functions\n");
+        ir.push_str("declare i64 @qi_process_spawn(ptr, i64)\n");
+        ir.push_str("declare i64 @qi_process_pipeline(ptr)\n");
+        ir.push_str("declare i64 @qi_process_write(i64, ptr)\n");
+        ir.push_str("declare i64 @qi_process_close_input(i64)\n");
+        ir.push_str("declare ptr @qi_process_read(i64, i64)\n");
+        ir.push_str("declare ptr @qi_process_read_error(i64, i64)\n");
+        ir.push_str("declare i64 @qi_process_output_ended(i64)\n");
+        ir.push_str("declare i64 @qi_process_splice(i64, i64)\n");
+        ir.push_str("declare i64 @qi_process_wait(i64, i64)\n");
+        ir.push_str("declare i64 @qi_process_kill(i64)\n");
+        ir.push_str("declare i64 @qi_process_close(i64)\n");
+        ir.push_str("declare void @qi_process_free_string(ptr)\n");
         ir.push_str("\n");
 
         ir.push_str("; Print functions\n");
@@ -3820,6 +3995,18 @@ impl IrBuilder {
         ir.push_str("declare double @qi_runtime_math_ceil(double)\n");
         ir.push_str("declare double @qi_runtime_math_round(double)\n");
         ir.push_str("\n");
+
+        ir.push_str("; Math intrinsics (direct calls are lowered to these)\n");
+        ir.push_str("declare double @llvm.sqrt.f64(double)\n");
+        ir.push_str("declare double @llvm.pow.f64(double, double)\n");
+        ir.push_str("declare double @llvm.sin.f64(double)\n");
+        ir.push_str("declare double @llvm.cos.f64(double)\n");
+        ir.push_str("declare double @llvm.floor.f64(double)\n");
+        ir.push_str("declare double @llvm.ceil.f64(double)\n");
+        ir.push_str("declare double @llvm.round.f64(double)\n");
+        ir.push_str("declare double @llvm.fabs.f64(double)\n");
+        ir.push_str("declare i64 @llvm.abs.i64(i64, i1)\n");
+        ir.push_str("\n");
         
         ir.push_str("; File I/O operations\n");
         ir.push_str("declare i64 @qi_runtime_file_open(ptr, ptr)\n");
@@ -4215,6 +4402,12 @@ impl IrBuilder {
                                     } else if callee == "qi_runtime_create_channel" {
                                         // create_channel(i64) -> ptr
                                         "i64"
+                                    } else if callee == "qi_runtime_ipc_create_channel" {
+                                        // ipc_create_channel(name ptr, i64) -> ptr
+                                        if i == 0 { "ptr" } else { "i64" }
+                                    } else if callee == "qi_runtime_ipc_open_channel" {
+                                        // ipc_open_channel(name ptr) -> ptr
+                                        "ptr"
                                     } else {
                                         current_arg_type // Use the variable's actual type
                                     }
@@ -4394,9 +4587,13 @@ impl IrBuilder {
                                     _ => "ptr"
                                 }
                             }
+                        } else if let Some((_, ret_ty)) = self.external_functions.get(&callee as &str).filter(|_| callee.starts_with("qi_runtime_")) {
+                            // Runtime functions with registered signatures
+                            ret_ty.as_str()
                         } else if callee.starts_with("qi_runtime_") {
                             // Create functions return ptr - MUST BE FIRST
                             if callee == "qi_runtime_create_channel" || callee == "qi_runtime_waitgroup_create" ||
+                               callee == "qi_runtime_ipc_create_channel" || callee == "qi_runtime_ipc_open_channel" ||
                                callee == "qi_runtime_mutex_create" || callee == "qi_runtime_rwlock_create" ||
                                callee == "qi_runtime_condvar_create" || callee == "qi_runtime_once_create" ||
                                callee == "qi_runtime_timer_create" {
@@ -4444,20 +4641,33 @@ impl IrBuilder {
                         // IO functions - check return type based on function name
                         } else if callee.starts_with("qi_io_") {
                             match callee.as_str() {
-                                "qi_io_read_file" => "ptr",  // 读取文件 returns string
+                                "qi_io_read_file" | "qi_io_next_line" | "qi_io_walk_dir" => "ptr",  // Return strings
                                 "qi_io_file_size" | "qi_io_write_file" | "qi_io_append_file" |
                                 "qi_io_delete_file" | "qi_io_create_file" | "qi_io_file_exists" |
-                                "qi_io_create_dir" | "qi_io_delete_dir" => "i64",  // These return i64
+                                "qi_io_create_dir" | "qi_io_delete_dir" |
+                                "qi_io_open_lines" | "qi_io_close_lines" | "qi_io_copy_file" |
+                                "qi_io_open_appender" | "qi_io_appender_append" | "qi_io_appender_flush" |
+                                "qi_io_close_appender" => "i64",  // These return i64
                                 "qi_io_free_string" => "void",  // Cleanup function
                                 _ => "i64"  // Default for unknown IO functions
                             }
                         // Network functions - check return type based on function name
                         } else if callee.starts_with("qi_network_") {
                             match callee.as_str() {
-                                "qi_network_resolve_host" | "qi_network_get_local_ip" => "ptr",  // Return strings
+                                "qi_network_resolve_host" | "qi_network_get_local_ip" |
+                                "qi_network_resolve_wait" => "ptr",  // Return strings
                                 "qi_network_tcp_connect" | "qi_network_tcp_read" | "qi_network_tcp_write" |
                                 "qi_network_tcp_close" | "qi_network_tcp_flush" | "qi_network_tcp_bytes_read" |
-                                "qi_network_tcp_bytes_written" | "qi_network_port_available" => "i64",  // Return i64
+                                "qi_network_tcp_bytes_written" | "qi_network_port_available" |
+                                "qi_network_tcp_connect_with_options" | "qi_network_tcp_writev" |
+                                "qi_network_tcp_readv" | "qi_network_tcp_write_zerocopy" |
+                                "qi_network_tcp_zerocopy_wait" |
+                                "qi_network_tcp_listen" | "qi_network_tcp_accept" | "qi_network_tcp_serve" |
+                                "qi_network_tcp_listener_port" | "qi_network_tcp_listener_close" |
+                                "qi_network_resolve_host_async" | "qi_network_resolve_ready" |
+                                "qi_network_udp_bind" | "qi_network_udp_send_to" | "qi_network_udp_recv" |
+                                "qi_network_udp_recv_batch" | "qi_network_udp_send_batch" |
+                                "qi_network_udp_local_port" | "qi_network_udp_close" => "i64",  // Return i64
                                 "qi_network_free_string" => "void",  // Cleanup function
                                 _ => "i64"  // Default for unknown network functions
                             }
@@ -4465,13 +4675,24 @@ impl IrBuilder {
                         } else if callee.starts_with("qi_http_") {
                             match callee.as_str() {
                                 "qi_http_get" | "qi_http_post" | "qi_http_put" | "qi_http_delete" |
-                                "qi_http_request_execute" => "ptr",  // Return response strings
+                                "qi_http_request_execute" | "qi_http_server_request_method" |
+                                "qi_http_server_request_path" | "qi_http_server_request_header" |
+                                "qi_http_server_request_body" => "ptr",  // Return strings
                                 "qi_http_init" | "qi_http_request_create" | "qi_http_request_set_header" |
                                 "qi_http_request_set_body" | "qi_http_request_set_timeout" |
-                                "qi_http_get_status" => "i64",  // Return i64
+                                "qi_http_get_status" | "qi_http_server_create" | "qi_http_server_route" |
+                                "qi_http_server_port" | "qi_http_server_next_request" |
+                                "qi_http_server_respond" | "qi_http_server_close" => "i64",  // Return i64
                                 "qi_http_free_string" => "void",  // Cleanup function
                                 _ => "i64"  // Default for unknown HTTP functions
                             }
+                        // Process functions - check return type based on function name
+                        } else if callee.starts_with("qi_process_") {
+                            match callee.as_str() {
+                                "qi_process_read" | "qi_process_read_error" => "ptr",  // Return strings
+                                "qi_process_free_string" => "void",  // Cleanup function
+                                _ => "i64"  // Handles, byte counts and exit codes
+                            }
                         // Check hex-encoded Chinese function names
                         } else if callee == "e6_b1_82_e5_b9_b3_e6_96_b9_e6_a0_b9" { // 求平方根
                             "double"
@@ -4504,6 +4725,21 @@ impl IrBuilder {
                             if let Some(dest_var) = dest {
                                 ir.push_str(&format!("{} = load i64, ptr {}\n", dest_var, temp_ptr));
                             }
+                        } else if let Some(intrinsic) = Self::math_intrinsic(&final_callee) {
+                            // llvm.abs takes an extra "is INT_MIN poison" flag; keep wrapping semantics
+                            let (intrinsic_args, flags) = if intrinsic == "llvm.abs.i64" {
+                                (format!("{}, i1 false", args_str), "")
+                            } else {
+                                (args_str.clone(), if self.fast_math { "fast " } else { "" })
+                            };
+                            match dest {
+                                Some(dest_var) => {
+                                    ir.push_str(&format!("{} = call {}{} @{}({})\n", dest_var, flags, ret_type, intrinsic, intrinsic_args));
+                                }
+                                None => {
+                                    ir.push_str(&format!("call {}{} @{}({})\n", flags, ret_type, intrinsic, intrinsic_args));
+                                }
+                            }
                         } else {
                             match dest {
                                 Some(dest_var) => {
@@ -51,6 +51,11 @@ impl CodeGenerator {
         self.ir_builder.set_import_aliases(import_aliases);
     }
 
+    /// Enable fast-math flags on math intrinsic calls
+    pub fn set_fast_math(&mut self, enabled: bool) {
+        self.ir_builder.set_fast_math(enabled);
+    }
+
     /// Generate LLVM IR from AST
     pub fn generate(&mut self, ast: &crate::parser::ast::AstNode) -> Result<String, CodegenError> {
         let ir = self.ir_builder.build(ast)
@@ -112,7 +117,7 @@ mod tests {
     #[test]
     fn test_simple_code_generation() {
         let source = "变量 x = 42;".to_string();
-        let mut lexer = Lexer::new(source);
+        let mut lexer = Lexer::new(&source);
         let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
         let parser = Parser::new();
@@ -130,7 +135,7 @@ mod tests {
     #[test]
     fn test_function_code_generation() {
         let source = "函数 test() { 返回 42; }".to_string();
-        let mut lexer = Lexer::new(source);
+        let mut lexer = Lexer::new(&source);
         let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
         let parser = Parser::new();
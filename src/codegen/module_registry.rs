@@ -105,6 +105,12 @@ impl ModuleRegistry {
 
         // Register HTTP module (HTTP模块)
         self.register_http_module();
+
+        // Register HTTP server module (HTTP服务器模块)
+        self.register_http_server_module();
+
+        // Register process module (进程模块)
+        self.register_process_module();
     }
 
     /// Register the crypto module
@@ -235,6 +241,72 @@ impl ModuleRegistry {
             "整数",  // Returns 0 or 1 as i64
         ));
 
+        io_module.add_function(ModuleFunction::new(
+            "复制文件",
+            "qi_io_copy_file",
+            vec!["字符串".to_string(), "字符串".to_string()],
+            "整数",  // Returns bytes copied, -1 on failure
+        ));
+
+        // 遍历目录(路径, 通配符, 最大深度)：返回以换行分隔的文件路径
+        io_module.add_function(ModuleFunction::new(
+            "遍历目录",
+            "qi_io_walk_dir",
+            vec!["字符串".to_string(), "字符串".to_string(), "整数".to_string()],
+            "字符串",
+        ));
+
+        // 追加器：打开追加器(路径, 持久) 返回句柄，持久为 1 时每次追加落盘后返回
+        io_module.add_function(ModuleFunction::new(
+            "打开追加器",
+            "qi_io_open_appender",
+            vec!["字符串".to_string(), "整数".to_string()],
+            "整数",  // Returns handle, 0 on failure
+        ));
+
+        io_module.add_function(ModuleFunction::new(
+            "追加",
+            "qi_io_appender_append",
+            vec!["整数".to_string(), "字符串".to_string()],
+            "整数",  // Returns 0 or 1 as i64
+        ));
+
+        io_module.add_function(ModuleFunction::new(
+            "刷新追加器",
+            "qi_io_appender_flush",
+            vec!["整数".to_string()],
+            "整数",  // Returns 0 or 1 as i64
+        ));
+
+        io_module.add_function(ModuleFunction::new(
+            "关闭追加器",
+            "qi_io_close_appender",
+            vec!["整数".to_string()],
+            "整数",  // Returns 0 or 1 as i64
+        ));
+
+        // 逐行读取：返回句柄，读取下一行返回的字符串在下一次读取前有效，无需释放
+        io_module.add_function(ModuleFunction::new(
+            "逐行读取",
+            "qi_io_open_lines",
+            vec!["字符串".to_string()],
+            "整数",  // Returns handle, 0 on failure
+        ));
+
+        io_module.add_function(ModuleFunction::new(
+            "读取下一行",
+            "qi_io_next_line",
+            vec!["整数".to_string()],
+            "字符串",  // Null at end of file
+        ));
+
+        io_module.add_function(ModuleFunction::new(
+            "关闭行读取",
+            "qi_io_close_lines",
+            vec!["整数".to_string()],
+            "整数",  // Returns 0 or 1 as i64
+        ));
+
         // Register module with both Chinese and path formats
         self.modules.insert("io".to_string(), io_module.clone());
         self.modules.insert("标准库.io".to_string(), io_module);
@@ -273,6 +345,42 @@ impl ModuleRegistry {
             "整数",  // 返回成功/失败
         ));
 
+        // 选项位：1 NODELAY，2 QUICKACK，4 零拷贝，8 忙轮询
+        network_module.add_function(ModuleFunction::new(
+            "TCP连接带选项",
+            "qi_network_tcp_connect_with_options",
+            vec!["字符串".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 主机, 端口, 超时(毫秒), 选项位, 收发缓冲区大小(0 为默认)
+            "整数",  // 返回连接句柄
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "TCP分散写入",
+            "qi_network_tcp_writev",
+            vec!["整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 缓冲区指针数组, 长度数组, 个数
+            "整数",  // 返回写入总字节数
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "TCP分散读取",
+            "qi_network_tcp_readv",
+            vec!["整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 缓冲区指针数组, 长度数组, 个数
+            "整数",  // 返回读取总字节数
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "TCP零拷贝写入",
+            "qi_network_tcp_write_zerocopy",
+            vec!["整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 数据指针, 大小
+            "整数",  // 返回写入字节数
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "TCP等待零拷贝",
+            "qi_network_tcp_zerocopy_wait",
+            vec!["整数".to_string(), "整数".to_string()], // 句柄, 超时(毫秒, <0 一直等待)
+            "整数",  // 返回未完成的发送数，0 表示缓冲区可复用
+        ));
+
         network_module.add_function(ModuleFunction::new(
             "TCP刷新",
             "qi_network_tcp_flush",
@@ -280,6 +388,85 @@ impl ModuleRegistry {
             "整数",  // 返回成功/失败
         ));
 
+        // TCP 监听函数
+        network_module.add_function(ModuleFunction::new(
+            "监听",
+            "qi_network_tcp_listen",
+            vec!["字符串".to_string(), "整数".to_string(), "整数".to_string()], // 主机, 端口, 积压队列长度
+            "整数",  // 返回监听句柄
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "接受连接",
+            "qi_network_tcp_accept",
+            vec!["整数".to_string(), "整数".to_string()], // 监听句柄, 超时(毫秒, <0 一直等待)
+            "整数",  // 返回连接句柄，0 表示超时
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "监听端口",
+            "qi_network_tcp_listener_port",
+            vec!["整数".to_string()], // 监听句柄
+            "整数",  // 返回实际端口
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "关闭监听",
+            "qi_network_tcp_listener_close",
+            vec!["整数".to_string()], // 监听句柄
+            "整数",  // 返回成功/失败
+        ));
+
+        // UDP 函数：批量收发在一次系统调用内完成多个数据报
+        network_module.add_function(ModuleFunction::new(
+            "UDP绑定",
+            "qi_network_udp_bind",
+            vec!["字符串".to_string(), "整数".to_string()], // 主机, 端口
+            "整数",  // 返回套接字句柄
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP发送",
+            "qi_network_udp_send_to",
+            vec!["整数".to_string(), "字符串".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 目标主机, 目标端口, 数据指针, 大小
+            "整数",  // 返回发送字节数
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP接收",
+            "qi_network_udp_recv",
+            vec!["整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 缓冲区指针, 大小, 超时(毫秒, <0 一直等待)
+            "整数",  // 返回数据报长度，-2 表示超时
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP批量接收",
+            "qi_network_udp_recv_batch",
+            vec!["整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 缓冲区指针, 槽大小, 长度数组指针, 最大个数, 超时(毫秒)
+            "整数",  // 返回收到的数据报数，0 表示超时
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP批量发送",
+            "qi_network_udp_send_batch",
+            vec!["整数".to_string(), "字符串".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string(), "整数".to_string()], // 句柄, 目标主机, 目标端口, 数据指针, 长度数组指针, 个数
+            "整数",  // 返回发送的数据报数
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP端口",
+            "qi_network_udp_local_port",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回实际端口
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "UDP关闭",
+            "qi_network_udp_close",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回成功/失败
+        ));
+
         network_module.add_function(ModuleFunction::new(
             "解析主机",
             "qi_network_resolve_host",
@@ -287,6 +474,28 @@ impl ModuleRegistry {
             "字符串",  // 返回 IP 地址
         ));
 
+        // 后台解析：先取句柄，之后再等待结果
+        network_module.add_function(ModuleFunction::new(
+            "异步解析主机",
+            "qi_network_resolve_host_async",
+            vec!["字符串".to_string()], // 主机名
+            "整数",  // 返回解析句柄
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "解析完成",
+            "qi_network_resolve_ready",
+            vec!["整数".to_string()], // 解析句柄
+            "整数",  // 返回 1 已完成，0 进行中
+        ));
+
+        network_module.add_function(ModuleFunction::new(
+            "等待解析",
+            "qi_network_resolve_wait",
+            vec!["整数".to_string(), "整数".to_string()], // 解析句柄, 超时(毫秒, <0 一直等待)
+            "字符串",  // 返回 IP 地址
+        ));
+
         network_module.add_function(ModuleFunction::new(
             "端口可用",
             "qi_network_port_available",
@@ -387,6 +596,169 @@ impl ModuleRegistry {
         self.modules.insert("标准库.http".to_string(), http_module);
     }
 
+    /// Register the HTTP server module
+    fn register_http_server_module(&mut self) {
+        let mut server_module = Module::new("HTTP服务器");
+
+        server_module.add_function(ModuleFunction::new(
+            "创建服务器",
+            "qi_http_server_create",
+            vec!["字符串".to_string(), "整数".to_string()], // 主机, 端口(0 自动选择)
+            "整数",  // 返回服务器句柄
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "服务器端口",
+            "qi_http_server_port",
+            vec!["整数".to_string()], // 服务器句柄
+            "整数",  // 返回实际端口
+        ));
+
+        // 拉取式处理：在循环中等待请求，再用 启动 交给协程回复
+        server_module.add_function(ModuleFunction::new(
+            "等待请求",
+            "qi_http_server_next_request",
+            vec!["整数".to_string(), "整数".to_string()], // 服务器句柄, 超时(毫秒, <0 一直等待)
+            "整数",  // 返回请求句柄，0 表示超时
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "请求方法",
+            "qi_http_server_request_method",
+            vec!["整数".to_string()], // 请求句柄
+            "字符串",  // 返回方法
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "请求路径",
+            "qi_http_server_request_path",
+            vec!["整数".to_string()], // 请求句柄
+            "字符串",  // 返回路径和查询字符串
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "请求头",
+            "qi_http_server_request_header",
+            vec!["整数".to_string(), "字符串".to_string()], // 请求句柄, 名称
+            "字符串",  // 返回头部值
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "请求体",
+            "qi_http_server_request_body",
+            vec!["整数".to_string()], // 请求句柄
+            "字符串",  // 返回请求体
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "响应",
+            "qi_http_server_respond",
+            vec!["整数".to_string(), "整数".to_string(), "字符串".to_string(), "字符串".to_string()], // 请求句柄, 状态码, 内容类型, 响应体
+            "整数",  // 返回成功/失败
+        ));
+
+        server_module.add_function(ModuleFunction::new(
+            "关闭服务器",
+            "qi_http_server_close",
+            vec!["整数".to_string()], // 服务器句柄
+            "整数",  // 返回成功/失败
+        ));
+
+        // Register module with both Chinese and path formats
+        self.modules.insert("HTTP服务器".to_string(), server_module.clone());
+        self.modules.insert("标准库.HTTP服务器".to_string(), server_module);
+    }
+
+    /// Register the process module
+    fn register_process_module(&mut self) {
+        let mut process_module = Module::new("进程");
+
+        // 启动函数：单个命令不经过 shell，管道各段之间直接相连
+        process_module.add_function(ModuleFunction::new(
+            "启动进程",
+            "qi_process_spawn",
+            vec!["字符串".to_string(), "整数".to_string()], // 命令行, 是否捕获标准错误
+            "整数",  // 返回进程句柄，-2 表示命令不存在
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "启动管道",
+            "qi_process_pipeline",
+            vec!["字符串".to_string()], // 以 | 分隔的命令行
+            "整数",  // 返回进程句柄
+        ));
+
+        // 流式读写：读取返回当前已到达的输出
+        process_module.add_function(ModuleFunction::new(
+            "进程写入",
+            "qi_process_write",
+            vec!["整数".to_string(), "字符串".to_string()], // 句柄, 数据
+            "整数",  // 返回写入字节数
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "进程关闭输入",
+            "qi_process_close_input",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回成功/失败
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "进程读取",
+            "qi_process_read",
+            vec!["整数".to_string(), "整数".to_string()], // 句柄, 超时(毫秒, <0 一直等待)
+            "字符串",  // 返回已输出的内容
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "进程读取错误",
+            "qi_process_read_error",
+            vec!["整数".to_string(), "整数".to_string()], // 句柄, 超时(毫秒, <0 一直等待)
+            "字符串",  // 返回标准错误内容
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "进程输出结束",
+            "qi_process_output_ended",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回 1 表示输出已读完
+        ));
+
+        // 转接：把一个进程的输出直接接到另一个进程的输入
+        process_module.add_function(ModuleFunction::new(
+            "进程转接",
+            "qi_process_splice",
+            vec!["整数".to_string(), "整数".to_string()], // 来源句柄, 目标句柄
+            "整数",  // 返回转接字节数
+        ));
+
+        // 生命周期
+        process_module.add_function(ModuleFunction::new(
+            "进程等待",
+            "qi_process_wait",
+            vec!["整数".to_string(), "整数".to_string()], // 句柄, 超时(毫秒, <0 一直等待)
+            "整数",  // 返回退出码，-2 表示超时
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "进程终止",
+            "qi_process_kill",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回成功/失败
+        ));
+
+        process_module.add_function(ModuleFunction::new(
+            "关闭进程",
+            "qi_process_close",
+            vec!["整数".to_string()], // 句柄
+            "整数",  // 返回成功/失败
+        ));
+
+        // Register module with both Chinese and path formats
+        self.modules.insert("进程".to_string(), process_module.clone());
+        self.modules.insert("标准库.进程".to_string(), process_module);
+    }
+
     /// Get a module by path
     pub fn get_module(&self, path: &str) -> Option<&Module> {
         self.modules.get(path)
@@ -48,6 +48,18 @@ pub struct CompilerConfig {
     pub warnings_as_errors: bool,
     /// Verbose output
     pub verbose: bool,
+    /// Allow fast-math flags on floating point math intrinsics
+    #[serde(default)]
+    pub fast_math: bool,
+    /// Modules compiled in parallel; 0 uses one job per CPU core
+    #[serde(default)]
+    pub jobs: usize,
+    /// Object file cache directory; `None` uses `.qi_cache` in the working directory
+    #[serde(default)]
+    pub cache_dir: Option<PathBuf>,
+    /// Always recompile instead of reusing cached object files
+    #[serde(default)]
+    pub no_cache: bool,
 }
 
 impl Default for CompilerConfig {
@@ -62,6 +74,10 @@ impl Default for CompilerConfig {
             config_file: None,
             warnings_as_errors: false,
             verbose: false,
+            fast_math: false,
+            jobs: 0,
+            cache_dir: None,
+            no_cache: false,
         }
     }
 }
@@ -126,6 +142,10 @@ impl CompilerConfig {
         config.config_file = cli.config.clone();
         config.warnings_as_errors = cli.warnings_as_errors;
         config.verbose = cli.verbose;
+        config.fast_math = cli.fast_math;
+        config.jobs = cli.jobs.unwrap_or(0);
+        config.cache_dir = cli.cache_dir.clone();
+        config.no_cache = cli.no_cache;
 
         // Load config file if specified
         if let Some(config_file) = &config.config_file {
@@ -177,6 +197,27 @@ impl CompilerConfig {
         if !self.verbose {
             self.verbose = other.verbose;
         }
+        if !self.fast_math {
+            self.fast_math = other.fast_math;
+        }
+        if self.jobs == 0 {
+            self.jobs = other.jobs;
+        }
+        if self.cache_dir.is_none() {
+            self.cache_dir = other.cache_dir;
+        }
+        if !self.no_cache {
+            self.no_cache = other.no_cache;
+        }
+    }
+
+    /// Number of modules to compile in parallel
+    pub fn job_count(&self) -> usize {
+        if self.jobs > 0 {
+            self.jobs
+        } else {
+            std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1)
+        }
     }
 }
 
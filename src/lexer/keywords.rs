@@ -1,130 +1,208 @@
 //! Chinese keyword lookup for Qi language
+//!
+//! Keywords are stored in a static table addressed by a perfect hash that is
+//! found at compile time: a lookup hashes the identifier bytes once and does
+//! at most one string comparison, with no allocation and no SipHash.
 
 use crate::lexer::tokens::TokenKind;
 use crate::parser::ast::BasicType;
-use std::collections::HashMap;
 
-/// Chinese keyword lookup table
-pub struct KeywordTable {
-    keywords: HashMap<String, TokenKind>,
+/// Keyword spellings and their token kinds
+const KEYWORDS: &[(&str, TokenKind)] = &[
+    // Chinese keywords
+    ("如果", TokenKind::如果),
+    ("否则", TokenKind::否则),
+    ("循环", TokenKind::循环),
+    ("当", TokenKind::当),
+    ("对于", TokenKind::对于),
+    ("函数", TokenKind::函数),
+    ("返回", TokenKind::返回),
+    ("变量", TokenKind::变量),
+    ("常量", TokenKind::常量),
+    ("整数", TokenKind::类型关键词(BasicType::整数)),
+    ("字符串", TokenKind::类型关键词(BasicType::字符串)),
+    ("布尔", TokenKind::类型关键词(BasicType::布尔)),
+    ("浮点数", TokenKind::类型关键词(BasicType::浮点数)),
+
+    // Additional keywords for grammar
+    ("导入", TokenKind::导入),
+    ("导出", TokenKind::导出),
+    ("作为", TokenKind::作为),
+    ("在", TokenKind::在),
+    ("字符", TokenKind::类型关键词(BasicType::字符)),
+    ("空", TokenKind::类型关键词(BasicType::空)),
+    ("与", TokenKind::与),
+    ("或", TokenKind::或),
+    ("参数", TokenKind::参数),
+    ("包", TokenKind::包),
+    ("模块", TokenKind::模块),
+    ("公开", TokenKind::公开),
+    ("私有", TokenKind::私有),
+
+    // Boolean literals
+    ("真", TokenKind::布尔字面量(true)),
+    ("假", TokenKind::布尔字面量(false)),
+
+    // Type keywords - 基础类型
+    ("长整数", TokenKind::类型关键词(BasicType::长整数)),
+    ("短整数", TokenKind::类型关键词(BasicType::短整数)),
+    ("字节", TokenKind::类型关键词(BasicType::字节)),
+
+    // Type keywords - 容器类型
+    ("字典", TokenKind::类型关键词(BasicType::字典)),
+    ("列表", TokenKind::类型关键词(BasicType::列表)),
+    ("集合", TokenKind::类型关键词(BasicType::集合)),
+
+    // Type keywords - 指针和引用类型
+    ("指针", TokenKind::类型关键词(BasicType::指针)),
+    ("引用", TokenKind::类型关键词(BasicType::引用)),
+    ("可变引用", TokenKind::类型关键词(BasicType::可变引用)),
+
+    // Type keywords - 复合类型
+    ("类型", TokenKind::类型),
+    ("枚举", TokenKind::枚举),
+    ("数组", TokenKind::数组),
+    ("方法", TokenKind::方法),
+    ("自己", TokenKind::自己),
+
+    // Concurrency keywords - 并发关键字
+    ("启动", TokenKind::启动),
+    ("协程", TokenKind::协程),
+    ("通道", TokenKind::通道),
+    ("选择", TokenKind::选择),
+    ("情况", TokenKind::情况),
+    ("并发", TokenKind::并发),
+    ("未来", TokenKind::未来),
+
+    // Synchronization keywords - 同步关键字
+    ("等待组", TokenKind::等待组),
+    ("互斥锁", TokenKind::互斥锁),
+    ("读写锁", TokenKind::读写锁),
+    ("条件变量", TokenKind::条件变量),
+    ("仅一次", TokenKind::仅一次),
+
+    // Timeout and error handling keywords - 超时和错误处理关键字
+    ("尝试", TokenKind::尝试),
+    ("捕获", TokenKind::捕获),
+    ("重试", TokenKind::重试),
+    ("超时", TokenKind::超时),
+
+    // Control flow keywords - 控制流关键字
+    ("跳出", TokenKind::跳出),
+    ("继续", TokenKind::继续),
+
+    // Pointer operations - 指针操作
+    ("解引用", TokenKind::解引用),
+    ("取地址", TokenKind::取地址关键字),
+
+    // Minimal English keywords for debugging/testing only
+    ("let", TokenKind::变量),
+    ("print", TokenKind::标识符),
+    ("true", TokenKind::布尔字面量(true)),
+    ("false", TokenKind::布尔字面量(false)),
+];
+
+/// Number of hash slots; a power of two several times the keyword count
+const TABLE_SIZE: usize = 512;
+
+/// Length in bytes of the longest keyword
+const MAX_KEYWORD_LEN: usize = {
+    let mut max = 0;
+    let mut i = 0;
+    while i < KEYWORDS.len() {
+        if KEYWORDS[i].0.len() > max {
+            max = KEYWORDS[i].0.len();
+        }
+        i += 1;
+    }
+    max
+};
+
+/// Seeded FNV-1a over the UTF-8 bytes, folded to a slot index
+const fn slot(seed: u32, bytes: &[u8]) -> usize {
+    let mut hash = 0x811c_9dc5u32 ^ seed.wrapping_mul(0x9e37_79b9);
+    let mut i = 0;
+    while i < bytes.len() {
+        hash ^= bytes[i] as u32;
+        hash = hash.wrapping_mul(0x0100_0193);
+        i += 1;
+    }
+    (hash ^ (hash >> 16)) as usize & (TABLE_SIZE - 1)
 }
 
-impl KeywordTable {
-    pub fn new() -> Self {
-        let mut keywords = HashMap::new();
-
-        // Populate Chinese keywords
-        keywords.insert("如果".to_string(), TokenKind::如果);
-        keywords.insert("否则".to_string(), TokenKind::否则);
-        keywords.insert("循环".to_string(), TokenKind::循环);
-        keywords.insert("当".to_string(), TokenKind::当);
-        keywords.insert("对于".to_string(), TokenKind::对于);
-        keywords.insert("函数".to_string(), TokenKind::函数);
-        keywords.insert("返回".to_string(), TokenKind::返回);
-        keywords.insert("变量".to_string(), TokenKind::变量);
-        keywords.insert("常量".to_string(), TokenKind::常量);
-        keywords.insert("整数".to_string(), TokenKind::类型关键词(BasicType::整数));
-        keywords.insert("字符串".to_string(), TokenKind::类型关键词(BasicType::字符串));
-        keywords.insert("布尔".to_string(), TokenKind::类型关键词(BasicType::布尔));
-        keywords.insert("浮点数".to_string(), TokenKind::类型关键词(BasicType::浮点数));
-
-        // Additional keywords for grammar
-        keywords.insert("导入".to_string(), TokenKind::导入);
-        keywords.insert("导出".to_string(), TokenKind::导出);
-        keywords.insert("作为".to_string(), TokenKind::作为);
-        keywords.insert("在".to_string(), TokenKind::在);
-        keywords.insert("字符".to_string(), TokenKind::类型关键词(BasicType::字符));
-        keywords.insert("空".to_string(), TokenKind::类型关键词(BasicType::空));
-        keywords.insert("与".to_string(), TokenKind::与);
-        keywords.insert("或".to_string(), TokenKind::或);
-        keywords.insert("参数".to_string(), TokenKind::参数);
-        keywords.insert("包".to_string(), TokenKind::包);
-        keywords.insert("模块".to_string(), TokenKind::模块);
-        keywords.insert("公开".to_string(), TokenKind::公开);
-        keywords.insert("私有".to_string(), TokenKind::私有);
-
-        // Boolean literals
-        keywords.insert("真".to_string(), TokenKind::布尔字面量(true));
-        keywords.insert("假".to_string(), TokenKind::布尔字面量(false));
-
-        // Type keywords - 基础类型
-        keywords.insert("长整数".to_string(), TokenKind::类型关键词(BasicType::长整数));
-        keywords.insert("短整数".to_string(), TokenKind::类型关键词(BasicType::短整数));
-        keywords.insert("字节".to_string(), TokenKind::类型关键词(BasicType::字节));
-
-        // Type keywords - 容器类型
-        keywords.insert("字典".to_string(), TokenKind::类型关键词(BasicType::字典));
-        keywords.insert("列表".to_string(), TokenKind::类型关键词(BasicType::列表));
-        keywords.insert("集合".to_string(), TokenKind::类型关键词(BasicType::集合));
-
-        // Type keywords - 指针和引用类型
-        keywords.insert("指针".to_string(), TokenKind::类型关键词(BasicType::指针));
-        keywords.insert("引用".to_string(), TokenKind::类型关键词(BasicType::引用));
-        keywords.insert("可变引用".to_string(), TokenKind::类型关键词(BasicType::可变引用));
-
-        // Type keywords - 复合类型
-        keywords.insert("类型".to_string(), TokenKind::类型);
-        keywords.insert("枚举".to_string(), TokenKind::枚举);
-        keywords.insert("数组".to_string(), TokenKind::数组);
-        keywords.insert("方法".to_string(), TokenKind::方法);
-        keywords.insert("自己".to_string(), TokenKind::自己);
-
-        // Concurrency keywords - 并发关键字
-        keywords.insert("启动".to_string(), TokenKind::启动);
-        keywords.insert("协程".to_string(), TokenKind::协程);
-        keywords.insert("通道".to_string(), TokenKind::通道);
-        keywords.insert("选择".to_string(), TokenKind::选择);
-        keywords.insert("情况".to_string(), TokenKind::情况);
-        keywords.insert("并发".to_string(), TokenKind::并发);
-        keywords.insert("未来".to_string(), TokenKind::未来);
-
-        // Synchronization keywords - 同步关键字
-        keywords.insert("等待组".to_string(), TokenKind::等待组);
-        keywords.insert("互斥锁".to_string(), TokenKind::互斥锁);
-        keywords.insert("读写锁".to_string(), TokenKind::读写锁);
-        keywords.insert("条件变量".to_string(), TokenKind::条件变量);
-        keywords.insert("仅一次".to_string(), TokenKind::仅一次);
-
-        // Timeout and error handling keywords - 超时和错误处理关键字
-        keywords.insert("尝试".to_string(), TokenKind::尝试);
-        keywords.insert("捕获".to_string(), TokenKind::捕获);
-        keywords.insert("重试".to_string(), TokenKind::重试);
-        keywords.insert("超时".to_string(), TokenKind::超时);
-        keywords.insert("否则".to_string(), TokenKind::否则);
-
-        // Control flow keywords - 控制流关键字
-        keywords.insert("跳出".to_string(), TokenKind::跳出);
-        keywords.insert("继续".to_string(), TokenKind::继续);
-
-        // Pointer operations - 指针操作
-        keywords.insert("解引用".to_string(), TokenKind::解引用);
-        keywords.insert("取地址".to_string(), TokenKind::取地址关键字);
-
-        // Minimal English keywords for debugging/testing only
-        keywords.insert("let".to_string(), TokenKind::变量);
-        keywords.insert("print".to_string(), TokenKind::标识符);
-        keywords.insert("true".to_string(), TokenKind::布尔字面量(true));
-        keywords.insert("false".to_string(), TokenKind::布尔字面量(false));
-
-        Self { keywords }
-    }
+/// Perfect hash: `slots[slot(seed, keyword)]` holds the keyword's index + 1
+struct PerfectHash {
+    seed: u32,
+    slots: [u8; TABLE_SIZE],
+}
 
-    /// Check if a string is a keyword and return the corresponding token kind
-    pub fn lookup(&self, text: &str) -> Option<TokenKind> {
-        self.keywords.get(text).cloned()
+/// Search for a seed under which no two keywords share a slot
+const fn build() -> PerfectHash {
+    assert!(KEYWORDS.len() < u8::MAX as usize, "keyword table too large for u8 slots");
+
+    let mut seed = 0;
+    loop {
+        let mut slots = [0u8; TABLE_SIZE];
+        let mut collision = false;
+        let mut i = 0;
+        while i < KEYWORDS.len() {
+            let index = slot(seed, KEYWORDS[i].0.as_bytes());
+            if slots[index] != 0 {
+                collision = true;
+                break;
+            }
+            slots[index] = (i + 1) as u8;
+            i += 1;
+        }
+        if !collision {
+            return PerfectHash { seed, slots };
+        }
+        seed += 1;
+        assert!(seed < 10_000, "no perfect hash seed for the keyword table");
     }
+}
+
+static TABLE: PerfectHash = build();
 
-    /// Check if a string is a keyword
-    pub fn is_keyword(&self, text: &str) -> bool {
-        self.keywords.contains_key(text)
+/// Check if a string is a keyword and return the corresponding token kind
+pub fn lookup(text: &str) -> Option<TokenKind> {
+    if text.len() > MAX_KEYWORD_LEN {
+        return None;
+    }
+    match TABLE.slots[slot(TABLE.seed, text.as_bytes())] {
+        0 => None,
+        index => {
+            let (keyword, kind) = &KEYWORDS[index as usize - 1];
+            if *keyword == text {
+                Some(kind.clone())
+            } else {
+                None
+            }
+        }
     }
 }
 
-impl Default for KeywordTable {
-    fn default() -> Self {
-        Self::new()
-    }
+/// Check if a string is a keyword
+pub fn is_keyword(text: &str) -> bool {
+    lookup(text).is_some()
 }
 
-/// Global keyword lookup table
-pub static KEYWORDS: once_cell::sync::Lazy<KeywordTable> = once_cell::sync::Lazy::new(KeywordTable::new);
\ No newline at end of file
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_every_keyword_is_found() {
+        for (keyword, kind) in KEYWORDS {
+            assert_eq!(lookup(keyword).as_ref(), Some(kind), "{}", keyword);
+        }
+    }
+
+    #[test]
+    fn test_non_keywords() {
+        for text in ["计数", "如果x", "否则如果", "x", "", "打印机", "条件变量名"] {
+            assert!(!is_keyword(text), "{}", text);
+        }
+        assert_eq!(lookup("print"), Some(TokenKind::标识符));
+    }
+}
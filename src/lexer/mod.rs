@@ -11,8 +11,13 @@ use crate::utils::diagnostics::{DiagnosticManager, DiagnosticLevel};
 
 
 /// Qi language lexical analyzer
-pub struct Lexer {
-    source: String,
+///
+/// Tokens borrow their text from the source, so scanning allocates nothing
+/// beyond the token vector itself.
+pub struct Lexer<'src> {
+    source: &'src str,
+    /// Byte view of `source`; `position` is always on a char boundary
+    bytes: &'src [u8],
     position: usize,
     line: usize,
     column: usize,
@@ -20,11 +25,12 @@ pub struct Lexer {
     diagnostics: DiagnosticManager,
 }
 
-impl Lexer {
+impl<'src> Lexer<'src> {
     /// Create a new lexer for the given source code
-    pub fn new(source: String) -> Self {
+    pub fn new(source: &'src str) -> Self {
         Self {
             source,
+            bytes: source.as_bytes(),
             position: 0,
             line: 1,
             column: 1,
@@ -44,32 +50,18 @@ impl Lexer {
     }
 
     /// Tokenize the entire source code
-    pub fn tokenize(&mut self) -> Result<Vec<Token>, LexicalError> {
+    pub fn tokenize(&mut self) -> Result<Vec<Token<'src>>, LexicalError> {
         let mut tokens = Vec::new();
         let mut first_error: Option<LexicalError> = None;
 
-        while !self.is_at_end() {
-            // Skip whitespace
-            self.skip_whitespace();
-
-            if self.is_at_end() {
-                break;
-            }
-
-            match self.next_token() {
-                Ok(Some(token)) => {
-                    tokens.push(token);
-                }
-                Ok(None) => {
-                    // None returned (e.g., for comments), just continue the loop
-                }
+        while let Some(result) = self.next_significant_token() {
+            match result {
+                Ok(token) => tokens.push(token),
                 Err(e) => {
                     // Store first error but continue scanning for more errors
                     if first_error.is_none() {
                         first_error = Some(e);
                     }
-                    // Skip the problematic character to continue scanning
-                    self.advance();
                 }
             }
         }
@@ -77,7 +69,7 @@ impl Lexer {
         // Add EOF token
         tokens.push(Token {
             kind: TokenKind::文件结束,
-            text: String::new(),
+            text: "",
             span: tokens::Span::new(self.position, self.position),
             line: self.line,
             column: self.column,
@@ -93,8 +85,31 @@ impl Lexer {
         }
     }
 
+    /// Scan the next token, skipping whitespace and comments
+    ///
+    /// Returns `None` at end of input. After an error the offending character
+    /// is skipped, so scanning can continue to collect further diagnostics.
+    pub fn next_significant_token(&mut self) -> Option<Result<Token<'src>, LexicalError>> {
+        loop {
+            self.skip_whitespace();
+            if self.is_at_end() {
+                return None;
+            }
+
+            match self.next_token() {
+                Ok(Some(token)) => return Some(Ok(token)),
+                // Comments produce no token
+                Ok(None) => continue,
+                Err(e) => {
+                    self.advance();
+                    return Some(Err(e));
+                }
+            }
+        }
+    }
+
     /// Get the next token
-    fn next_token(&mut self) -> Result<Option<Token>, LexicalError> {
+    fn next_token(&mut self) -> Result<Option<Token<'src>>, LexicalError> {
         let start_pos = self.position;
         let start_line = self.line;
         let start_column = self.column;
@@ -112,20 +127,47 @@ impl Lexer {
             ';' => Ok(Some(self.make_single_char_token(TokenKind::分号, start_pos, start_line, start_column))),
             ',' => Ok(Some(self.make_single_char_token(TokenKind::逗号, start_pos, start_line, start_column))),
             ':' => {
-                // Check for :: (double colon)
+                // Check for :: (double colon) and := (short declaration)
                 if self.peek_char() == Some(':') {
+                    self.advance();
                     Ok(Some(self.make_two_char_token(TokenKind::双冒号, start_pos, start_line, start_column)))
+                } else if self.peek_char() == Some('=') {
+                    self.advance();
+                    Ok(Some(self.make_two_char_token(TokenKind::短声明, start_pos, start_line, start_column)))
                 } else {
                     Ok(Some(self.make_single_char_token(TokenKind::冒号, start_pos, start_line, start_column)))
                 }
             }
-            '.' => Ok(Some(self.make_single_char_token(TokenKind::点, start_pos, start_line, start_column))),
+            '.' => {
+                if self.peek_char() == Some('.') {
+                    self.advance();
+                    Ok(Some(self.make_two_char_token(TokenKind::范围, start_pos, start_line, start_column)))
+                } else {
+                    Ok(Some(self.make_single_char_token(TokenKind::点, start_pos, start_line, start_column)))
+                }
+            }
 
             // Operators and comments
             '+' => Ok(Some(self.make_single_char_token(TokenKind::加, start_pos, start_line, start_column))),
             '*' => Ok(Some(self.make_single_char_token(TokenKind::乘, start_pos, start_line, start_column))),
             '%' => Ok(Some(self.make_single_char_token(TokenKind::取余, start_pos, start_line, start_column))),
-            '&' => Ok(Some(self.make_single_char_token(TokenKind::取地址, start_pos, start_line, start_column))),
+            '&' => {
+                if self.peek_char() == Some('&') {
+                    self.advance();
+                    Ok(Some(self.make_two_char_token(TokenKind::与, start_pos, start_line, start_column)))
+                } else {
+                    Ok(Some(self.make_single_char_token(TokenKind::取地址, start_pos, start_line, start_column)))
+                }
+            }
+            '|' => {
+                if self.peek_char() == Some('|') {
+                    self.advance();
+                    Ok(Some(self.make_two_char_token(TokenKind::或, start_pos, start_line, start_column)))
+                } else {
+                    self.report_invalid_character_error(c, start_pos, start_line, start_column, "可能想要使用 '||' 表示逻辑或");
+                    Err(LexicalError::InvalidCharacter(c, start_line, start_column))
+                }
+            }
             '/' => {
                 if self.peek_char() == Some('/') {
                     // Check if it's a doc comment (///)
@@ -184,6 +226,9 @@ impl Lexer {
                 if self.peek_char() == Some('=') {
                     self.advance();
                     Ok(Some(self.make_two_char_token(TokenKind::小于等于, start_pos, start_line, start_column)))
+                } else if self.peek_char() == Some('-') {
+                    self.advance();
+                    Ok(Some(self.make_two_char_token(TokenKind::通道箭头, start_pos, start_line, start_column)))
                 } else {
                     Ok(Some(self.make_single_char_token(TokenKind::小于, start_pos, start_line, start_column)))
                 }
@@ -206,14 +251,9 @@ impl Lexer {
             // Numbers
             '0'..='9' => Ok(Some(self.scan_number(start_pos, start_line, start_column)?)),
 
-            // Identifiers and keywords
+            // Identifiers and keywords, Latin or Chinese
             c if c.is_alphabetic() || c == '_' => {
-                // Handle Chinese characters and standard identifiers
-                if self.unicode_handler.is_chinese_char(c) {
-                    Ok(Some(self.scan_chinese_identifier(start_pos, start_line, start_column)))
-                } else {
-                    Ok(Some(self.scan_identifier(start_pos, start_line, start_column)))
-                }
+                Ok(Some(self.scan_identifier(start_pos, start_line, start_column)))
             }
 
             // Chinese punctuation tokens
@@ -223,9 +263,10 @@ impl Lexer {
             '】' => Ok(Some(self.make_single_char_token(TokenKind::中文右大括号, start_pos, start_line, start_column))),
             '，' => Ok(Some(self.make_single_char_token(TokenKind::中文逗号, start_pos, start_line, start_column))),
             '；' => Ok(Some(self.make_single_char_token(TokenKind::中文分号, start_pos, start_line, start_column))),
+            '：' => Ok(Some(self.make_single_char_token(TokenKind::中文冒号, start_pos, start_line, start_column))),
 
             // Other Chinese punctuation (treat as whitespace/end of statements)
-            c if "。！？：".contains(c) ||
+            c if "。！？".contains(c) ||
                c == '"' || c == '"' ||
                c == '《' || c == '》' => {
                 self.advance();
@@ -246,12 +287,11 @@ impl Lexer {
     }
 
     /// Create a single character token
-    fn make_single_char_token(&mut self, kind: TokenKind, start_pos: usize, start_line: usize, start_column: usize) -> Token {
-        let text = self.current_char().unwrap().to_string();
+    fn make_single_char_token(&mut self, kind: TokenKind, start_pos: usize, start_line: usize, start_column: usize) -> Token<'src> {
         self.advance();
         Token {
             kind,
-            text,
+            text: &self.source[start_pos..self.position],
             span: tokens::Span::new(start_pos, self.position),
             line: start_line,
             column: start_column,
@@ -259,11 +299,11 @@ impl Lexer {
     }
 
     /// Create a two character token
-    fn make_two_char_token(&mut self, kind: TokenKind, start_pos: usize, start_line: usize, start_column: usize) -> Token {
+    fn make_two_char_token(&mut self, kind: TokenKind, start_pos: usize, start_line: usize, start_column: usize) -> Token<'src> {
         self.advance(); // Advance to include the second character
         Token {
             kind,
-            text: self.source[start_pos..self.position].to_string(),
+            text: &self.source[start_pos..self.position],
             span: tokens::Span::new(start_pos, self.position),
             line: start_line,
             column: start_column,
@@ -271,15 +311,24 @@ impl Lexer {
     }
 
     /// Scan a string literal
-    fn scan_string_literal(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token, LexicalError> {
+    fn scan_string_literal(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token<'src>, LexicalError> {
         self.advance(); // Skip opening quote
-        let start_content = self.position;
 
-        while !self.is_at_end() && self.current_char() != Some('"') {
-            if self.current_char() == Some('\\') {
-                self.advance(); // Skip escape character
+        while let Some(&b) = self.bytes.get(self.position) {
+            match b {
+                b'"' => break,
+                b'\\' => {
+                    self.advance(); // Skip escape character
+                    self.advance();
+                }
+                b'\n' => self.advance(),
+                // Plain ASCII content: one byte, one column
+                b if b < 0x80 => {
+                    self.position += 1;
+                    self.column += 1;
+                }
+                _ => self.advance(),
             }
-            self.advance();
         }
 
         if self.is_at_end() {
@@ -287,15 +336,12 @@ impl Lexer {
             return Err(LexicalError::UnterminatedString(start_line, start_column));
         }
 
-        let end_content = self.position;
         self.advance(); // Skip closing quote
         let end_pos = self.position;
 
-        let _content = self.source[start_content..end_content].to_string();
-
         Ok(Token {
             kind: TokenKind::字符串字面量,
-            text: self.source[start_pos..end_pos].to_string(),
+            text: &self.source[start_pos..end_pos],
             span: tokens::Span::new(start_pos, end_pos),
             line: start_line,
             column: start_column,
@@ -303,7 +349,7 @@ impl Lexer {
     }
 
     /// Scan a character literal
-    fn scan_char_literal(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token, LexicalError> {
+    fn scan_char_literal(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token<'src>, LexicalError> {
         self.advance(); // Skip opening quote
 
         if self.is_at_end() {
@@ -348,7 +394,7 @@ impl Lexer {
 
         Ok(Token {
             kind: TokenKind::字符字面量(final_char),
-            text: self.source[start_pos..end_pos].to_string(),
+            text: &self.source[start_pos..end_pos],
             span: tokens::Span::new(start_pos, end_pos),
             line: start_line,
             column: start_column,
@@ -356,19 +402,15 @@ impl Lexer {
     }
 
     /// Scan a number (integer or float)
-    fn scan_number(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token, LexicalError> {
-        while !self.is_at_end() && self.current_char().unwrap().is_ascii_digit() {
-            self.advance();
-        }
+    fn scan_number(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Result<Token<'src>, LexicalError> {
+        self.skip_ascii_digits();
 
-        // Check for float
-        if self.current_char() == Some('.') {
+        // Check for float; a second '.' starts a range such as 0..10
+        if self.current_char() == Some('.') && self.peek_char().map_or(false, |c| c.is_ascii_digit()) {
             self.advance();
-            while !self.is_at_end() && self.current_char().unwrap().is_ascii_digit() {
-                self.advance();
-            }
+            self.skip_ascii_digits();
 
-            let number_str = self.source[start_pos..self.position].to_string();
+            let number_str = &self.source[start_pos..self.position];
 
             // Validate float format
             if number_str.parse::<f64>().is_err() {
@@ -378,13 +420,13 @@ impl Lexer {
 
             Ok(Token {
                 kind: TokenKind::浮点数字面量,
-                text: number_str.clone(),
+                text: number_str,
                 span: tokens::Span::new(start_pos, self.position),
                 line: start_line,
                 column: start_column,
             })
         } else {
-            let number_str = self.source[start_pos..self.position].to_string();
+            let number_str = &self.source[start_pos..self.position];
 
             // Validate integer format
             let value = if let Ok(val) = number_str.parse::<i64>() {
@@ -396,7 +438,7 @@ impl Lexer {
 
             Ok(Token {
                 kind: TokenKind::整数字面量(value),
-                text: number_str.clone(),
+                text: number_str,
                 span: tokens::Span::new(start_pos, self.position),
                 line: start_line,
                 column: start_column,
@@ -404,39 +446,27 @@ impl Lexer {
         }
     }
 
-    /// Scan a standard identifier
-    fn scan_identifier(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Token {
-        while !self.is_at_end() {
-            let c = self.current_char().unwrap();
-            // Support mixed Latin and Chinese identifiers (e.g., MD5哈希, SHA256哈希)
-            if c.is_alphanumeric() || c == '_' || self.unicode_handler.is_chinese_char(c) {
-                self.advance();
-            } else {
-                break;
-            }
-        }
-
-        let text = &self.source[start_pos..self.position];
-
-        // Check if it's a keyword
-        let kind = keywords::KEYWORDS.lookup(text)
-            .unwrap_or(TokenKind::标识符);
-
-        Token {
-            kind,
-            text: text.to_string(),
-            span: tokens::Span::new(start_pos, self.position),
-            line: start_line,
-            column: start_column,
-        }
+    /// Skip a run of ASCII digits
+    fn skip_ascii_digits(&mut self) {
+        let run = self.bytes[self.position..].iter().take_while(|b| b.is_ascii_digit()).count();
+        self.position += run;
+        self.column += run;
     }
 
-    /// Scan a Chinese identifier or keyword
-    fn scan_chinese_identifier(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Token {
-        while !self.is_at_end() {
-            let c = self.current_char().unwrap();
-            if self.unicode_handler.is_chinese_char(c) || c.is_alphanumeric() || c == '_' {
-                self.advance();
+    /// Scan an identifier or keyword (Latin, Chinese or mixed, e.g. MD5哈希)
+    fn scan_identifier(&mut self, start_pos: usize, start_line: usize, start_column: usize) -> Token<'src> {
+        while let Some(&b) = self.bytes.get(self.position) {
+            if b.is_ascii_alphanumeric() || b == b'_' {
+                // ASCII fast path: one byte, one column, never a newline
+                self.position += 1;
+                self.column += 1;
+            } else if b >= 0x80 {
+                let c = self.current_char().unwrap();
+                if c.is_alphanumeric() || self.unicode_handler.is_chinese_char(c) {
+                    self.advance();
+                } else {
+                    break;
+                }
             } else {
                 break;
             }
@@ -444,13 +474,12 @@ impl Lexer {
 
         let text = &self.source[start_pos..self.position];
 
-        // Check if it's a Chinese keyword
-        let kind = keywords::KEYWORDS.lookup(text)
-            .unwrap_or(TokenKind::标识符);
+        // Check if it's a keyword
+        let kind = keywords::lookup(text).unwrap_or(TokenKind::标识符);
 
         Token {
             kind,
-            text: text.to_string(),
+            text,
             span: tokens::Span::new(start_pos, self.position),
             line: start_line,
             column: start_column,
@@ -459,73 +488,75 @@ impl Lexer {
 
     /// Advance to the next character
     fn advance(&mut self) {
-        if self.is_at_end() {
-            return;
-        }
+        let b = match self.bytes.get(self.position) {
+            Some(&b) => b,
+            None => return,
+        };
 
-        let current_char = self.current_char().unwrap_or('\0');
-        if current_char == '\n' {
-            self.line += 1;
-            self.column = 1;
+        if b < 0x80 {
+            self.position += 1;
+            if b == b'\n' {
+                self.line += 1;
+                self.column = 1;
+            } else {
+                self.column += 1;
+            }
         } else {
+            let current_char = self.decode_at(self.position);
             self.column += self.unicode_handler.char_width(current_char);
+            self.position += current_char.len_utf8();
         }
-        self.position += current_char.len_utf8();
     }
 
     /// Skip whitespace characters
     fn skip_whitespace(&mut self) {
-        while !self.is_at_end() {
-            let current_char = self.current_char().unwrap_or('\0');
-            if !current_char.is_whitespace() {
+        while let Some(&b) = self.bytes.get(self.position) {
+            if b < 0x80 {
+                if !(b as char).is_whitespace() {
+                    break;
+                }
+            } else if !self.decode_at(self.position).is_whitespace() {
                 break;
             }
-
-            if current_char == '\n' {
-                self.line += 1;
-                self.column = 1;
-            } else {
-                self.column += self.unicode_handler.char_width(current_char);
-            }
-            self.position += current_char.len_utf8();
+            self.advance();
         }
     }
 
     /// Check if we're at the end of the source
     fn is_at_end(&self) -> bool {
-        self.position >= self.source.len()
+        self.position >= self.bytes.len()
+    }
+
+    /// Decode the character starting at byte offset `pos`
+    fn decode_at(&self, pos: usize) -> char {
+        self.source[pos..].chars().next().unwrap_or('\0')
+    }
+
+    /// Character at byte offset `pos`, decoding UTF-8 only for non-ASCII bytes
+    fn char_at(&self, pos: usize) -> Option<char> {
+        match *self.bytes.get(pos)? {
+            b if b < 0x80 => Some(b as char),
+            _ => Some(self.decode_at(pos)),
+        }
     }
 
     /// Get the current character
     fn current_char(&self) -> Option<char> {
-        self.source[self.position..].chars().next()
+        self.char_at(self.position)
     }
 
     /// Look ahead at the next character
     fn peek_char(&self) -> Option<char> {
-        // Get current character
-        let current_char = self.current_char()?;
-
-        // Get current character length in bytes
-        let char_len = current_char.len_utf8();
-
-        // Look ahead from the position after current character
-        self.source[self.position + char_len..].chars().next()
+        self.peek_char_at_offset(1)
     }
 
     /// Look ahead at character at specific offset (character-based)
     fn peek_char_at_offset(&self, offset: usize) -> Option<char> {
-        if offset == 0 {
-            return self.current_char();
-        }
-
-        let mut chars = self.source[self.position..].chars();
+        let mut pos = self.position;
         for _ in 0..offset {
-            if chars.next().is_none() {
-                return None;
-            }
+            pos += utf8_width(*self.bytes.get(pos)?);
         }
-        chars.next()
+        self.char_at(pos)
     }
 
     /// Skip line comment (// to end of line)
@@ -535,7 +566,7 @@ impl Lexer {
         self.advance(); // skip second '/'
 
         // Skip until end of line or file
-        while !self.is_at_end() && self.current_char() != Some('\n') {
+        while !self.is_at_end() && self.bytes[self.position] != b'\n' {
             self.advance();
         }
     }
@@ -718,6 +749,16 @@ impl Lexer {
     }
 }
 
+/// Length in bytes of the UTF-8 sequence introduced by `lead`
+fn utf8_width(lead: u8) -> usize {
+    match lead {
+        0x00..=0x7F => 1,
+        0xC0..=0xDF => 2,
+        0xE0..=0xEF => 3,
+        _ => 4,
+    }
+}
+
 /// Lexical analysis errors
 #[derive(Debug, thiserror::Error)]
 pub enum LexicalError {
@@ -736,4 +777,8 @@ pub enum LexicalError {
     /// Unexpected end of file
     #[error("意外的文件结束")]
     UnexpectedEof,
+
+    /// A valid token that no grammar rule accepts
+    #[error("意外的符号: '{0}' 在第 {1} 行第 {2} 列")]
+    UnexpectedSymbol(String, usize, usize),
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 //! Token definitions for Qi language
 
 /// Source code span
-#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Default)]
 pub struct Span {
     pub start: usize,
     pub end: usize,
@@ -59,8 +59,11 @@ pub enum TokenKind {
     右方括号,  // ]
     冒号,      // :
     双冒号,    // ::
+    短声明,    // :=
     箭头,      // ->
+    通道箭头,  // <-
     点,        // .
+    范围,      // ..
 
     // Chinese punctuation tokens
     中文左括号,  // （
@@ -69,6 +72,7 @@ pub enum TokenKind {
     中文右大括号, // 】
     中文逗号,    // ，
     中文分号,    // ；
+    中文冒号,    // ：
 
     // Additional keywords for grammar
     导入,      // import
@@ -78,8 +82,8 @@ pub enum TokenKind {
     字符,      // char
     空,        // null/void
     参数,      // parameter
-    与,        // and
-    或,        // or
+    与,        // and (与 or &&)
+    或,        // or (或 or ||)
     包,        // package
     模块,      // module
     公开,      // public
@@ -139,17 +143,19 @@ pub enum TokenKind {
 }
 
 /// Token with source location information
+///
+/// `text` borrows the token's spelling from the source being lexed.
 #[derive(Debug, Clone)]
-pub struct Token {
+pub struct Token<'src> {
     pub kind: TokenKind,
-    pub text: String,
+    pub text: &'src str,
     pub span: Span,
     pub line: usize,
     pub column: usize,
 }
 
-impl Token {
-    pub fn new(kind: TokenKind, text: String, span: Span, line: usize, column: usize) -> Self {
+impl<'src> Token<'src> {
+    pub fn new(kind: TokenKind, text: &'src str, span: Span, line: usize, column: usize) -> Self {
         Self {
             kind,
             text,
@@ -109,8 +109,8 @@ impl QiCompiler {
     /// Compile a project with multiple files and import resolution
     fn compile_project(&self, entry_file: PathBuf) -> Result<CompilationResult, CompilerError> {
         let mut module_registry = crate::semantic::module::ModuleRegistry::new();
-        let mut compiled_modules = std::collections::HashMap::new();
-        let warnings = Vec::new();
+        let mut compiled_modules = ParsedModules::new();
+        let mut warnings = Vec::new();
 
         // 1. Parse and register all modules
         self.parse_and_collect_modules(
@@ -122,123 +122,327 @@ impl QiCompiler {
         // 1.5. Process public imports (re-exports)
         self.process_public_imports(&mut module_registry, &compiled_modules)?;
 
-    let mut object_files: Vec<PathBuf> = Vec::new();
-    let mut ir_files: Vec<PathBuf> = Vec::new();
+        // 2. Resolve each module's imports. Modules are visited in path order so
+        // that errors, and the object order handed to the linker, do not depend
+        // on hash map iteration order.
+        let mut module_paths: Vec<&PathBuf> = compiled_modules.keys().collect();
+        module_paths.sort();
+        let mut jobs = Vec::with_capacity(module_paths.len());
+        for module_path in module_paths {
+            let (external_functions, import_aliases) =
+                self.resolve_module_imports(module_path, &module_registry)?;
+            let module = &compiled_modules[module_path];
+            jobs.push(ModuleJob {
+                module_path,
+                ast: &module.ast,
+                source_hash: &module.source_hash,
+                external_functions,
+                import_aliases,
+            });
+        }
 
-        // 2. Compile each module independently
-        for (module_path, ast) in &compiled_modules {
-            // Get module info by file path (normalize for consistent lookup)
-            let path_key = module_path.canonicalize()
-                .unwrap_or_else(|_| module_path.clone())
-                .to_string_lossy()
-                .to_string();
-            let current_module = module_registry.get_module(&path_key);
-
-            // Collect external function signatures from imported modules
-            let mut external_functions = std::collections::HashMap::new();
-            // Collect import aliases for namespace resolution
-            let mut import_aliases = std::collections::HashMap::new();
-
-            if let Some(module) = current_module {
-                // Get current module's package name
-                let current_package_name = module.package_name.as_ref();
-
-                for import in &module.imports {
-                    // Check if this is a standard library import
-                    let is_stdlib = import.module_path.get(0).map(|s| s.as_str()) == Some("标准库");
-
-                    if is_stdlib {
-                        // Skip file resolution for standard library imports
-                        // Standard library modules are built-in and handled by ModuleRegistry in codegen
-                        let module_name = import.module_path.last().unwrap_or(&import.module_path[0]);
-                        let alias_name = import.alias.as_ref().unwrap_or(module_name);
-                        import_aliases.insert(alias_name.clone(), module_name.clone());
-                        continue;
-                    }
+        // 3. Generate IR and compile each module to an object file in parallel,
+        // reusing cached objects for modules whose inputs are unchanged
+        let cache = self.open_cache(&mut warnings);
+        let (ir_files, object_files) = self.compile_modules(jobs, cache.as_ref())?;
 
-                    // Resolve import path to actual module
-                    let import_path = self.resolve_import_path(module_path, &import.module_path)?;
-                    let import_path_key = import_path.canonicalize()
-                        .unwrap_or_else(|_| import_path.clone())
-                        .to_string_lossy()
-                        .to_string();
+        // 4. Link all object files
+        let executable_path = if cfg!(windows) {
+            entry_file.with_extension("exe") // e.g., "main.exe"
+        } else {
+            entry_file.with_extension("")   // e.g., "main"
+        };
+        self.link_objects(&object_files, &executable_path)?;
 
-                    if let Some(imported_module) = module_registry.get_module(&import_path_key) {
-                        // Use package name for the alias
-                        let import_module_name = imported_module.package_name.as_ref()
-                            .unwrap_or(&imported_module.name);
-
-                        // Set up alias mapping
-                        let alias_name = import.alias.as_ref().unwrap_or(import_module_name);
-                        import_aliases.insert(alias_name.clone(), import_module_name.clone());
-
-                        // IMPORTANT: Only add functions from different packages as external
-                        // Functions from the same package are compiled together and should be local
-                        let is_same_package = match (current_package_name, imported_module.package_name.as_ref()) {
-                            (Some(current), Some(imported)) => current == imported,
-                            (None, None) => true, // Both have no package name
-                            _ => false, // One has package name, other doesn't
-                        };
-
-                        if !is_same_package {
-                            // Add all exported functions from imported module as external
-                            for (func_name, symbol) in &imported_module.exports {
-                                if symbol.kind == crate::semantic::module::SymbolKind::Function {
-                                    if let Some(sig) = &symbol.function_signature {
-                                        // Mangle the function name same way as builder does
-                                        let mangled_name = self.mangle_function_name(func_name);
-                                        let param_types: Vec<String> = sig.parameters.iter()
-                                            .map(|(_, ty)| ty.clone())
-                                            .collect();
-
-                                        // Only register the original function name
-                                        external_functions.insert(mangled_name, (param_types, sig.return_type.clone()));
-                                    }
+        Ok(CompilationResult {
+            executable_path,
+            ir_paths: ir_files,
+            object_paths: object_files,
+            duration_ms: 0, // Will be set by caller
+            warnings,
+        })
+    }
+
+    /// Collect the external function signatures and import aliases a module's
+    /// code generator needs from the modules it imports
+    fn resolve_module_imports(
+        &self,
+        module_path: &PathBuf,
+        module_registry: &ModuleRegistry,
+    ) -> Result<(ExternalFunctions, std::collections::HashMap<String, String>), CompilerError> {
+        // Get module info by file path (normalize for consistent lookup)
+        let path_key = module_path.canonicalize()
+            .unwrap_or_else(|_| module_path.clone())
+            .to_string_lossy()
+            .to_string();
+        let current_module = module_registry.get_module(&path_key);
+
+        // Collect external function signatures from imported modules
+        let mut external_functions = std::collections::HashMap::new();
+        // Collect import aliases for namespace resolution
+        let mut import_aliases = std::collections::HashMap::new();
+
+        if let Some(module) = current_module {
+            // Get current module's package name
+            let current_package_name = module.package_name.as_ref();
+
+            for import in &module.imports {
+                // Check if this is a standard library import
+                let is_stdlib = import.module_path.get(0).map(|s| s.as_str()) == Some("标准库");
+
+                if is_stdlib {
+                    // Skip file resolution for standard library imports
+                    // Standard library modules are built-in and handled by ModuleRegistry in codegen
+                    let module_name = import.module_path.last().unwrap_or(&import.module_path[0]);
+                    let alias_name = import.alias.as_ref().unwrap_or(module_name);
+                    import_aliases.insert(alias_name.clone(), module_name.clone());
+                    continue;
+                }
+
+                // Resolve import path to actual module
+                let import_path = self.resolve_import_path(module_path, &import.module_path)?;
+                let import_path_key = import_path.canonicalize()
+                    .unwrap_or_else(|_| import_path.clone())
+                    .to_string_lossy()
+                    .to_string();
+
+                if let Some(imported_module) = module_registry.get_module(&import_path_key) {
+                    // Use package name for the alias
+                    let import_module_name = imported_module.package_name.as_ref()
+                        .unwrap_or(&imported_module.name);
+
+                    // Set up alias mapping
+                    let alias_name = import.alias.as_ref().unwrap_or(import_module_name);
+                    import_aliases.insert(alias_name.clone(), import_module_name.clone());
+
+                    // IMPORTANT: Only add functions from different packages as external
+                    // Functions from the same package are compiled together and should be local
+                    let is_same_package = match (current_package_name, imported_module.package_name.as_ref()) {
+                        (Some(current), Some(imported)) => current == imported,
+                        (None, None) => true, // Both have no package name
+                        _ => false, // One has package name, other doesn't
+                    };
+
+                    if !is_same_package {
+                        // Add all exported functions from imported module as external
+                        for (func_name, symbol) in &imported_module.exports {
+                            if symbol.kind == crate::semantic::module::SymbolKind::Function {
+                                if let Some(sig) = &symbol.function_signature {
+                                    // Mangle the function name same way as builder does
+                                    let mangled_name = self.mangle_function_name(func_name);
+                                    let param_types: Vec<String> = sig.parameters.iter()
+                                        .map(|(_, ty)| ty.clone())
+                                        .collect();
+
+                                    // Only register the original function name
+                                    external_functions.insert(mangled_name, (param_types, sig.return_type.clone()));
                                 }
                             }
                         }
                     }
                 }
             }
+        }
 
-            // Generate LLVM IR for this module
-            let mut codegen = crate::codegen::CodeGenerator::new(self.config.target_platform.clone());
-            
-            // Set external functions for this module
-            codegen.set_external_functions(external_functions);
+        Ok((external_functions, import_aliases))
+    }
+
+    /// Open the object file cache, unless it is disabled
+    ///
+    /// A cache that cannot be opened only costs the reuse, so it becomes a
+    /// warning rather than a build failure.
+    fn open_cache(&self, warnings: &mut Vec<String>) -> Option<std::sync::Mutex<crate::utils::CompilationCache>> {
+        if self.config.no_cache {
+            return None;
+        }
+        let cache = match &self.config.cache_dir {
+            Some(dir) => crate::utils::CompilationCache::with_cache_dir(dir.clone()),
+            None => crate::utils::CompilationCache::new(),
+        };
+        match cache {
+            Ok(cache) => Some(std::sync::Mutex::new(cache)),
+            Err(e) => {
+                warnings.push(format!("无法打开编译缓存: {}", e));
+                None
+            }
+        }
+    }
+
+    /// Cache key and input hash for a module's object file
+    ///
+    /// The key names the slot (module path and build settings); the hash
+    /// covers everything code generation reads, so a changed source file, a
+    /// changed signature in an imported module or a rebuilt compiler misses
+    /// the cache.
+    fn module_cache_key(&self, job: &ModuleJob<'_>) -> (String, String) {
+        use crate::utils::cache::ContentHasher;
+
+        let target = self.config.target_platform.to_string();
+        let optimization = self.config.optimization_level.to_string();
+        let fast_math = if self.config.fast_math { "fast-math" } else { "" };
+
+        let module_path = job.module_path.canonicalize()
+            .unwrap_or_else(|_| job.module_path.clone());
+        let mut key = ContentHasher::new();
+        key.field(module_path.to_string_lossy().as_bytes())
+            .field(&target)
+            .field(&optimization)
+            .field(fast_math);
+
+        let mut inputs = ContentHasher::new();
+        inputs.field(crate::utils::cache::compiler_build_id())
+            .field(&target)
+            .field(&optimization)
+            .field(fast_math)
+            .field(job.source_hash);
+
+        // Hash maps iterate in arbitrary order; sort for a stable hash
+        let mut external_functions: Vec<_> = job.external_functions.iter().collect();
+        external_functions.sort();
+        for (name, (params, return_type)) in external_functions {
+            inputs.field(name).field(return_type);
+            inputs.field((params.len() as u64).to_le_bytes());
+            for param in params {
+                inputs.field(param);
+            }
+        }
+        let mut import_aliases: Vec<_> = job.import_aliases.iter().collect();
+        import_aliases.sort();
+        for (alias, module) in import_aliases {
+            inputs.field(alias).field(module);
+        }
 
-            // Set import aliases for namespace resolution
-            codegen.set_import_aliases(import_aliases);
+        (key.finish(), inputs.finish())
+    }
 
-            let ir_content = codegen.generate(&ast)
-                .map_err(|e| CompilerError::Codegen(format!("代码生成失败 {}: {:?}", module_path.display(), e)))?;
+    /// Run code generation and `clang -c` for every module on a bounded pool
+    /// of worker threads.
+    ///
+    /// Results come back in job order. When modules fail, the error of the
+    /// first failing job is returned, which is the error a sequential build
+    /// would have reported: after a failure, workers skip only the jobs that
+    /// come after it.
+    fn compile_modules(
+        &self,
+        jobs: Vec<ModuleJob<'_>>,
+        cache: Option<&std::sync::Mutex<crate::utils::CompilationCache>>,
+    ) -> Result<(Vec<PathBuf>, Vec<PathBuf>), CompilerError> {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+        use std::sync::Mutex;
+
+        let job_count = jobs.len();
+        let worker_count = self.config.job_count().min(job_count).max(1);
+        let jobs: Vec<Mutex<Option<ModuleJob<'_>>>> = jobs.into_iter().map(|job| Mutex::new(Some(job))).collect();
+        let results: Vec<Mutex<Option<Result<(Option<PathBuf>, PathBuf), CompilerError>>>> =
+            (0..job_count).map(|_| Mutex::new(None)).collect();
+        let next_job = AtomicUsize::new(0);
+        let first_failure = AtomicUsize::new(usize::MAX);
+
+        let worker = || loop {
+            let index = next_job.fetch_add(1, Ordering::Relaxed);
+            if index >= job_count || index > first_failure.load(Ordering::Acquire) {
+                break;
+            }
+            let job = jobs[index].lock().unwrap().take().expect("each job runs once");
+            let result = self.compile_module(job, cache);
+            if result.is_err() {
+                first_failure.fetch_min(index, Ordering::AcqRel);
+            }
+            *results[index].lock().unwrap() = Some(result);
+        };
 
-            // Write LLVM IR to file
-            let ir_path = module_path.with_extension("ll");
-            std::fs::write(&ir_path, ir_content)
-                .map_err(CompilerError::Io)?;
-            ir_files.push(ir_path.clone());
+        if worker_count == 1 {
+            worker();
+        } else {
+            std::thread::scope(|scope| {
+                for _ in 0..worker_count {
+                    scope.spawn(&worker);
+                }
+            });
+        }
 
-            // Compile IR to object file (.o)
-            let obj_path = self.compile_ir_to_object(&ir_path)?;
-            object_files.push(obj_path);
+        let mut ir_files = Vec::with_capacity(job_count);
+        let mut object_files = Vec::with_capacity(job_count);
+        for result in results {
+            // Jobs after the first failure may have been skipped
+            match result.into_inner().unwrap() {
+                Some(Ok((ir_path, obj_path))) => {
+                    ir_files.extend(ir_path);
+                    object_files.push(obj_path);
+                }
+                Some(Err(e)) => return Err(e),
+                None => break,
+            }
         }
+        Ok((ir_files, object_files))
+    }
 
-        // 3. Link all object files
-        let executable_path = if cfg!(windows) {
-            entry_file.with_extension("exe") // e.g., "main.exe"
-        } else {
-            entry_file.with_extension("")   // e.g., "main"
-        };
-        self.link_objects(&object_files, &executable_path)?;
+    /// Generate LLVM IR for one module, write it next to the source file and
+    /// compile it to an object file
+    ///
+    /// On a cache hit the cached object is copied next to the source file
+    /// instead and no IR file is written. The object is copied rather than
+    /// linked because `qi run` deletes the object files after running.
+    fn compile_module(
+        &self,
+        job: ModuleJob<'_>,
+        cache: Option<&std::sync::Mutex<crate::utils::CompilationCache>>,
+    ) -> Result<(Option<PathBuf>, PathBuf), CompilerError> {
+        let module_path = job.module_path;
+        let obj_path = module_path.with_extension("o");
+
+        let cache_key = cache.map(|_| self.module_cache_key(&job));
+        if let (Some(cache), Some((key, source_hash))) = (cache, &cache_key) {
+            let cached = cache.lock().unwrap().lookup(key, source_hash);
+            // Copy outside the lock; a file removed meanwhile is just a miss
+            if let Some(cached) = cached {
+                if std::fs::copy(&cached, &obj_path).is_ok() {
+                    return Ok((None, obj_path));
+                }
+            }
+        }
 
-        Ok(CompilationResult {
-            executable_path,
-            ir_paths: ir_files,
-            object_paths: object_files,
-            duration_ms: 0, // Will be set by caller
-            warnings,
-        })
+        // Generate LLVM IR for this module
+        let mut codegen = crate::codegen::CodeGenerator::new(self.config.target_platform.clone());
+
+        // Set external functions for this module
+        codegen.set_external_functions(job.external_functions);
+
+        // Set import aliases for namespace resolution
+        codegen.set_import_aliases(job.import_aliases);
+
+        codegen.set_fast_math(self.config.fast_math);
+
+        let ir_content = codegen.generate(job.ast)
+            .map_err(|e| CompilerError::Codegen(format!("代码生成失败 {}: {:?}", module_path.display(), e)))?;
+
+        // Write LLVM IR to file
+        let ir_path = module_path.with_extension("ll");
+        std::fs::write(&ir_path, ir_content)
+            .map_err(CompilerError::Io)?;
+
+        // Compile IR to object file (.o)
+        let obj_path = self.compile_ir_to_object(&ir_path)?;
+
+        if let (Some(cache), Some((key, source_hash))) = (cache, cache_key) {
+            let stored = std::fs::read(&obj_path).map_err(crate::utils::cache::CacheError::from).and_then(|object| {
+                cache.lock().unwrap().put(
+                    key,
+                    source_hash,
+                    &object,
+                    vec![module_path.clone()],
+                    self.config.target_platform.to_string(),
+                    self.config.optimization_level.to_string(),
+                )
+            });
+            if let Err(e) = stored {
+                if self.config.verbose {
+                    eprintln!("警告: 无法缓存 {}: {}", obj_path.display(), e);
+                }
+            }
+        }
+
+        Ok((Some(ir_path), obj_path))
     }
 
     /// Mangle function name (same logic as codegen::builder)
@@ -274,7 +478,7 @@ impl QiCompiler {
         if !output.status.success() {
             let error = String::from_utf8_lossy(&output.stderr);
             return Err(CompilerError::Codegen(
-                format!("LLVM IR 编译为目标文件失败: {}", error)
+                format!("LLVM IR 编译为目标文件失败 {}: {}", ir_path.display(), error)
             ));
         }
 
@@ -415,8 +619,8 @@ impl QiCompiler {
         &self,
         file_path: &PathBuf,
         module_registry: &mut crate::semantic::module::ModuleRegistry,
-        compiled_modules: &mut std::collections::HashMap<PathBuf, crate::parser::ast::AstNode>,
-    ) -> Result<crate::parser::ast::AstNode, CompilerError> {
+        compiled_modules: &mut ParsedModules,
+    ) -> Result<std::sync::Arc<crate::parser::ast::AstNode>, CompilerError> {
         self.parse_and_collect_modules_internal(
             file_path,
             module_registry,
@@ -426,27 +630,30 @@ impl QiCompiler {
     }
 
     /// Internal implementation with visited set to prevent infinite recursion
+    ///
+    /// Each module's AST is parsed once and shared through an `Arc`; cache
+    /// hits and the returned handle never copy the tree.
     fn parse_and_collect_modules_internal(
         &self,
         file_path: &PathBuf,
         module_registry: &mut crate::semantic::module::ModuleRegistry,
-        compiled_modules: &mut std::collections::HashMap<PathBuf, crate::parser::ast::AstNode>,
+        compiled_modules: &mut ParsedModules,
         visited: &mut std::collections::HashSet<PathBuf>,
-    ) -> Result<crate::parser::ast::AstNode, CompilerError> {
+    ) -> Result<std::sync::Arc<crate::parser::ast::AstNode>, CompilerError> {
         // Prevent infinite recursion
         if visited.contains(file_path) {
-            return Ok(compiled_modules.get(file_path).cloned()
-                .unwrap_or_else(|| crate::parser::ast::AstNode::程序(crate::parser::ast::Program {
+            return Ok(compiled_modules.get(file_path).map(|module| std::sync::Arc::clone(&module.ast))
+                .unwrap_or_else(|| std::sync::Arc::new(crate::parser::ast::AstNode::程序(crate::parser::ast::Program {
                     package_name: None,
                     imports: vec![],
                     statements: vec![],
                     source_span: Default::default(),
-                })));
+                }))));
         }
 
         // Check if already compiled
-        if let Some(ast) = compiled_modules.get(file_path) {
-            return Ok(ast.clone());
+        if let Some(module) = compiled_modules.get(file_path) {
+            return Ok(std::sync::Arc::clone(&module.ast));
         }
 
         // Mark as visited to prevent cycles
@@ -455,17 +662,16 @@ impl QiCompiler {
         // Read and parse the file
         let source_code = std::fs::read_to_string(file_path)
             .map_err(CompilerError::Io)?;
-
-        let mut lexer = crate::lexer::Lexer::new(source_code);
-        let tokens = lexer.tokenize()
-            .map_err(|e| CompilerError::Lexical(format!("{}", e)))?;
+        // Hash exactly the text that is parsed, so the object cache can never
+        // pair this AST with a later edit of the file
+        let source_hash = crate::utils::cache::hash_bytes(source_code.as_bytes());
 
         let parser = crate::parser::Parser::new();
-        let program = parser.parse(tokens)
-            .map_err(|e| CompilerError::Parse(format!("解析错误 {}: {}", file_path.display(), e)))?;
-
-        // Convert program to AST node and extract imports
-        let ast = crate::parser::ast::AstNode::程序(program.clone());
+        let program = parser.parse_source(&source_code)
+            .map_err(|e| match e {
+                crate::parser::ParseError::Lexical(e) => CompilerError::Lexical(format!("{}", e)),
+                e => CompilerError::Parse(format!("解析错误 {}: {}", file_path.display(), e)),
+            })?;
 
         // Register current module
         let module_name = file_path.file_stem()
@@ -517,8 +723,12 @@ impl QiCompiler {
             )?;
         }
 
-        // Store the compiled AST
-        compiled_modules.insert(file_path.clone(), ast.clone());
+        // Store the compiled AST; the program moves into the shared node
+        let ast = std::sync::Arc::new(crate::parser::ast::AstNode::程序(program));
+        compiled_modules.insert(file_path.clone(), ParsedModule {
+            ast: std::sync::Arc::clone(&ast),
+            source_hash,
+        });
 
         Ok(ast)
     }
@@ -650,7 +860,7 @@ impl QiCompiler {
         entry_file: &PathBuf,
         package_name: &str,
         module_registry: &mut crate::semantic::module::ModuleRegistry,
-        compiled_modules: &mut std::collections::HashMap<PathBuf, crate::parser::ast::AstNode>,
+        compiled_modules: &mut ParsedModules,
         visited: &mut std::collections::HashSet<PathBuf>,
     ) -> Result<(), CompilerError> {
         // Get the directory containing the entry file
@@ -714,7 +924,7 @@ impl QiCompiler {
         entry_file: &PathBuf,
         package_name: &str,
         module_registry: &mut crate::semantic::module::ModuleRegistry,
-        compiled_modules: &mut std::collections::HashMap<PathBuf, crate::parser::ast::AstNode>,
+        compiled_modules: &mut ParsedModules,
         visited: &mut std::collections::HashSet<PathBuf>,
     ) -> Result<(), CompilerError> {
         // Only auto-discover files that don't have imports to avoid conflicts
@@ -796,7 +1006,7 @@ impl QiCompiler {
     fn process_public_imports(
         &self,
         module_registry: &mut ModuleRegistry,
-        compiled_modules: &std::collections::HashMap<PathBuf, crate::parser::ast::AstNode>
+        compiled_modules: &ParsedModules
     ) -> Result<(), CompilerError> {
         // Collect all modules that need re-export processing
         let module_paths: Vec<PathBuf> = compiled_modules.keys().cloned().collect();
@@ -818,8 +1028,8 @@ impl QiCompiler {
                 module.imports.iter()
                     .filter(|imp| {
                         // Check if this is a public import by looking at AST
-                        if let Some(ast_node) = compiled_modules.get(&module_path) {
-                            if let crate::parser::ast::AstNode::程序(ast) = ast_node {
+                        if let Some(module) = compiled_modules.get(&module_path) {
+                            if let crate::parser::ast::AstNode::程序(ast) = &*module.ast {
                                 ast.imports.iter().any(|ast_imp| {
                                     ast_imp.is_public && ast_imp.module_path == imp.module_path
                                 })
@@ -866,6 +1076,27 @@ impl QiCompiler {
     }
 }
 
+/// External function signatures (parameter types, return type) by mangled name
+type ExternalFunctions = std::collections::HashMap<String, (Vec<String>, String)>;
+
+/// A parsed module and the SHA-256 of the source it was parsed from
+struct ParsedModule {
+    ast: std::sync::Arc<crate::parser::ast::AstNode>,
+    source_hash: String,
+}
+
+/// Parsed modules by source path
+type ParsedModules = std::collections::HashMap<PathBuf, ParsedModule>;
+
+/// One module's code generation inputs, handed to a compile worker
+struct ModuleJob<'a> {
+    module_path: &'a PathBuf,
+    ast: &'a crate::parser::ast::AstNode,
+    source_hash: &'a str,
+    external_functions: ExternalFunctions,
+    import_aliases: std::collections::HashMap<String, String>,
+}
+
 /// Result of a compilation operation
 #[derive(Debug, Clone)]
 pub struct CompilationResult {
@@ -3,7 +3,7 @@
 use crate::lexer::tokens::Span;
 
 /// Visibility modifier for declarations
-#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub enum Visibility {
     公开,  // public
     私有,  // private (default)
@@ -241,7 +241,7 @@ pub struct AssignmentExpression {
 }
 
 /// Type node
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub enum TypeNode {
     基础类型(BasicType),
     函数类型(FunctionType),
@@ -259,7 +259,7 @@ pub enum TypeNode {
 }
 
 /// Basic types
-#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub enum BasicType {
     // 数值类型
     整数,      // i32
@@ -287,14 +287,14 @@ pub enum BasicType {
 }
 
 /// Function type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct FunctionType {
     pub parameters: Vec<TypeNode>,
     pub return_type: Box<TypeNode>,
 }
 
 /// Array type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct ArrayType {
     pub element_type: Box<TypeNode>,
     pub size: Option<usize>,
@@ -334,7 +334,7 @@ pub struct StructDeclaration {
 }
 
 /// Struct field definition
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct StructField {
     pub name: String,
     pub type_annotation: TypeNode,
@@ -367,7 +367,7 @@ pub struct EnumDeclaration {
 }
 
 /// Enum variant definition
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct EnumVariant {
     pub name: String,
     pub value: Option<i64>, // Optional explicit value
@@ -375,7 +375,7 @@ pub struct EnumVariant {
 }
 
 /// Struct type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct StructType {
     pub name: String,
     pub fields: Vec<StructField>,
@@ -383,7 +383,7 @@ pub struct StructType {
 }
 
 /// Enum type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct EnumType {
     pub name: String,
     pub variants: Vec<EnumVariant>,
@@ -423,38 +423,38 @@ pub struct AwaitExpression {
 // Additional type definitions for complete type system support
 
 /// Dictionary type (map/dict)
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct DictionaryType {
     pub key_type: Box<TypeNode>,
     pub value_type: Box<TypeNode>,
 }
 
 /// List type (Vec/List)
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct ListType {
     pub element_type: Box<TypeNode>,
 }
 
 /// Set type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct SetType {
     pub element_type: Box<TypeNode>,
 }
 
 /// Channel type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct ChannelType {
     pub element_type: Box<TypeNode>,
 }
 
 /// Pointer type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct PointerType {
     pub target_type: Box<TypeNode>,
 }
 
 /// Reference type
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct ReferenceType {
     pub target_type: Box<TypeNode>,
     pub is_mutable: bool, // true for 可变引用, false for 引用
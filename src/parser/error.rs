@@ -43,6 +43,10 @@ pub enum ParseError {
     /// Parse failed
     #[error("解析失败")]
     ParseFailed,
+
+    /// Lexical error reported while streaming tokens into the parser
+    #[error("{0}")]
+    Lexical(#[from] crate::lexer::LexicalError),
 }
 
 impl ParseError {
@@ -128,13 +132,13 @@ pub enum RecoveryStrategy {
 /// Parser error context information
 /// 解析器错误上下文信息
 #[derive(Debug, Clone)]
-pub struct ErrorContext {
+pub struct ErrorContext<'src> {
     /// Expected token kinds
     /// 期望的token类型
     pub expected: Vec<TokenKind>,
     /// Actual token received
     /// 实际收到的token
-    pub actual: Token,
+    pub actual: Token<'src>,
     /// Current parsing rule/function
     /// 当前解析规则/函数
     pub rule: String,
@@ -146,7 +150,7 @@ pub struct ErrorContext {
 /// Enhanced parser error with recovery
 /// 带恢复功能的增强解析器错误
 #[derive(Debug, Clone)]
-pub struct ParserError {
+pub struct ParserError<'src> {
     /// Error code
     /// 错误代码
     pub code: String,
@@ -158,7 +162,7 @@ pub struct ParserError {
     pub english_message: String,
     /// Error context
     /// 错误上下文
-    pub context: ErrorContext,
+    pub context: ErrorContext<'src>,
     /// Suggested recovery strategy
     /// 建议的恢复策略
     pub recovery_strategy: RecoveryStrategy,
@@ -272,7 +276,7 @@ impl ParserErrorRecovery {
 
     /// Report a syntax error with enhanced information
     /// 报告带有增强信息的语法错误
-    pub fn report_syntax_error(&mut self, context: ErrorContext) -> ParserError {
+    pub fn report_syntax_error<'src>(&mut self, context: ErrorContext<'src>) -> ParserError<'src> {
         let (code, message, english_message, suggestion) = self.generate_error_details(&context);
 
         let span = context.actual.span;
@@ -290,7 +294,7 @@ impl ParserErrorRecovery {
                 file_path: None,
                 span: Some(span),
                 suggestion: Some(suggestion.clone()),
-                related_code: Some(context.actual.text.clone()),
+                related_code: Some(context.actual.text.to_string()),
             }
         });
 
@@ -448,7 +452,10 @@ impl ParserErrorRecovery {
             TokenKind::中文逗号 => "，".to_string(),
             TokenKind::冒号 => ":".to_string(),
             TokenKind::双冒号 => "::".to_string(),
+            TokenKind::短声明 => ":=".to_string(),
+            TokenKind::中文冒号 => "：".to_string(),
             TokenKind::点 => ".".to_string(),
+            TokenKind::范围 => "..".to_string(),
             TokenKind::加 => "+".to_string(),
             TokenKind::减 => "-".to_string(),
             TokenKind::乘 => "*".to_string(),
@@ -466,6 +473,7 @@ impl ParserErrorRecovery {
             TokenKind::或 => "||".to_string(),
             TokenKind::非 => "!".to_string(),
             TokenKind::箭头 => "->".to_string(),
+            TokenKind::通道箭头 => "<-".to_string(),
             TokenKind::函数 => "函数".to_string(),
             TokenKind::变量 => "变量".to_string(),
             TokenKind::常量 => "常量".to_string(),
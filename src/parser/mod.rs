@@ -2,6 +2,7 @@
 
 pub mod ast;
 pub mod error;
+pub mod token_stream;
 
 // Include the generated LALRPOP parser
 include!(concat!(env!("OUT_DIR"), "/parser/grammar.rs"));
@@ -17,6 +18,8 @@ pub use ast::{
 };
 pub use error::ParseError;
 
+use token_stream::{SliceStream, TokenStream};
+
 /// Qi language parser using LALRPOP-generated parser
 pub struct Parser {
     _private: (),
@@ -29,149 +32,28 @@ impl Parser {
     }
 
     /// Parse source code directly into an AST
+    ///
+    /// Tokens are streamed from the lexer into the parser in a single pass;
+    /// comments and whitespace never reach the grammar.
     pub fn parse_source(&self, source: &str) -> Result<Program, ParseError> {
-        // Preprocess: strip BOM and comments to support fixtures that include them
-        fn strip_comments(input: &str) -> String {
-            // Strip UTF-8 BOM if present
-            let s = if input.starts_with('\u{feff}') {
-                &input["\u{feff}".len()..]
-            } else {
-                input
-            };
-
-            let bytes = s.as_bytes();
-            let mut out = String::with_capacity(s.len());
-            let mut i = 0;
-            let n = bytes.len();
-
-            let mut in_line_comment = false;
-            let mut in_block_comment = false;
-            let mut in_string = false;
-            let mut in_char = false;
-            let mut escape = false;
-
-            while i < n {
-                if in_line_comment {
-                    // End of line ends the comment
-                    if bytes[i] == b'\n' {
-                        in_line_comment = false;
-                        out.push('\n');
-                    }
-                    i += 1;
-                    continue;
-                }
-
-                if in_block_comment {
-                    if i + 1 < n && bytes[i] == b'*' && bytes[i + 1] == b'/' {
-                        in_block_comment = false;
-                        i += 2;
-                    } else {
-                        i += 1;
-                    }
-                    continue;
-                }
-
-                if in_string {
-                    // Read next UTF-8 char
-                    let ch = s[i..].chars().next().unwrap();
-                    let len = ch.len_utf8();
-                    out.push(ch);
-                    if !escape {
-                        if ch == '"' {
-                            in_string = false;
-                        } else if ch == '\\' {
-                            escape = true;
-                        }
-                    } else {
-                        // escaped char consumed
-                        escape = false;
-                    }
-                    i += len;
-                    continue;
-                }
-
-                if in_char {
-                    let ch = s[i..].chars().next().unwrap();
-                    let len = ch.len_utf8();
-                    out.push(ch);
-                    if !escape {
-                        if ch == '\'' {
-                            in_char = false;
-                        } else if ch == '\\' {
-                            escape = true;
-                        }
-                    } else {
-                        escape = false;
-                    }
-                    i += len;
-                    continue;
-                }
+        // Strip UTF-8 BOM if present
+        let source = source.strip_prefix('\u{feff}').unwrap_or(source);
 
-                // Not inside any literal or comment
-                if i + 1 < n && bytes[i] == b'/' && bytes[i + 1] == b'/' {
-                    in_line_comment = true;
-                    i += 2;
-                    continue;
-                }
-                if i + 1 < n && bytes[i] == b'/' && bytes[i + 1] == b'*' {
-                    in_block_comment = true;
-                    i += 2;
-                    continue;
-                }
-
-                // Handle start of string/char literals or just copy next char
-                let ch = s[i..].chars().next().unwrap();
-                let len = ch.len_utf8();
-                if ch == '"' {
-                    in_string = true;
-                    escape = false;
-                    out.push(ch);
-                    i += len;
-                    continue;
-                }
-                if ch == '\'' {
-                    in_char = true;
-                    escape = false;
-                    out.push(ch);
-                    i += len;
-                    continue;
-                }
-
-                out.push(ch);
-                i += len;
-            }
-
-            out
-        }
-
-        let cleaned = strip_comments(source);
-
-        // Use LALRPOP-generated parser with cleaned string input
-        use crate::parser::__parse__Program::ProgramParser;
-        ProgramParser::new()
-            .parse(&cleaned)
-            .map_err(|_| ParseError::ParseFailed)
+        __parse__Program::ProgramParser::new()
+            .parse(TokenStream::new(source))
+            .map_err(|e| token_stream::convert_error(e, |offset| token_stream::line_column(source, offset)))
     }
 
-    /// Parse tokens into an AST (legacy method - tokenizes first)
-    pub fn parse(&self, tokens: Vec<crate::lexer::Token>) -> Result<Program, ParseError> {
-        // Reconstruct source from tokens preserving original structure
-        // Use the original span information to maintain proper spacing
-        let mut source = String::new();
-        let mut last_end = 0;
-
-        for token in &tokens {
-            // Preserve spacing between tokens based on original positions
-            if token.span.start > last_end {
-                // Add the original whitespace/newlines that were between tokens
-                // For now, add a space if there was a gap
-                source.push(' ');
-            }
-            source.push_str(&token.text);
-            last_end = token.span.end;
-        }
-
-        self.parse_source(&source.trim())
+    /// Parse tokens produced by [`crate::lexer::Lexer::tokenize`] into an AST
+    pub fn parse(&self, tokens: Vec<crate::lexer::Token<'_>>) -> Result<Program, ParseError> {
+        __parse__Program::ProgramParser::new()
+            .parse(SliceStream::new(&tokens))
+            .map_err(|e| {
+                token_stream::convert_error(e, |offset| {
+                    let index = tokens.partition_point(|t| t.span.start < offset);
+                    tokens.get(index).map_or((0, 0), |t| (t.line, t.column))
+                })
+            })
     }
 }
 
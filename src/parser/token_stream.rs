@@ -0,0 +1,499 @@
+//! Token stream adapter between the Qi lexer and the LALRPOP parser
+//! 词法分析器到语法分析器的标记流适配
+//!
+//! The grammar declares an `extern` token type, so the parser consumes
+//! `(start, Tok, end)` triples produced here instead of re-lexing the
+//! source with LALRPOP's built-in regex lexer. Byte spans from the lexer
+//! are passed through unchanged, which keeps error locations exact.
+
+use crate::lexer::{Lexer, LexicalError, Token, TokenKind};
+use crate::parser::ast::BasicType;
+use crate::parser::error::ParseError;
+
+/// Item type consumed by the generated parser
+pub type Spanned<'input> = Result<(usize, Tok<'input>, usize), LexicalError>;
+
+macro_rules! symbols {
+    ($($name:ident => $spelling:literal,)*) => {
+        /// Keywords and punctuation recognised by the grammar
+        #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+        pub enum Symbol {
+            $($name,)*
+        }
+
+        impl Symbol {
+            /// Every symbol, in declaration order
+            pub const ALL: &'static [Symbol] = &[$(Symbol::$name,)*];
+
+            /// Look up the symbol written as `text`
+            pub fn from_spelling(text: &str) -> Option<Symbol> {
+                match text {
+                    $($spelling => Some(Symbol::$name),)*
+                    _ => None,
+                }
+            }
+
+            /// Source spelling of the symbol
+            pub fn spelling(self) -> &'static str {
+                match self {
+                    $(Symbol::$name => $spelling,)*
+                }
+            }
+        }
+    };
+}
+
+symbols! {
+    // 关键字
+    与 => "与",
+    作为 => "作为",
+    假 => "假",
+    公开 => "公开",
+    函数 => "函数",
+    列表 => "列表",
+    创建通道 => "创建通道",
+    包 => "包",
+    取地址关键字 => "取地址",
+    变量 => "变量",
+    可变引用 => "可变引用",
+    否则 => "否则",
+    否则如果 => "否则如果",
+    启动 => "启动",
+    在 => "在",
+    如果 => "如果",
+    字典 => "字典",
+    字符 => "字符",
+    字符串 => "字符串",
+    字节 => "字节",
+    对于 => "对于",
+    导入 => "导入",
+    布尔 => "布尔",
+    常量 => "常量",
+    引用 => "引用",
+    当 => "当",
+    情况 => "情况",
+    或 => "或",
+    指针 => "指针",
+    数组 => "数组",
+    整数 => "整数",
+    未来 => "未来",
+    浮点数 => "浮点数",
+    真 => "真",
+    短整数 => "短整数",
+    空 => "空",
+    等待 => "等待",
+    类型 => "类型",
+    继续 => "继续",
+    解引用 => "解引用",
+    跳出 => "跳出",
+    返回 => "返回",
+    选择 => "选择",
+    通道 => "通道",
+    长整数 => "长整数",
+    集合 => "集合",
+    默认 => "默认",
+
+    // 标点符号
+    赋值 => "=",
+    加 => "+",
+    减 => "-",
+    乘 => "*",
+    除 => "/",
+    取余 => "%",
+    取地址 => "&",
+    等于 => "==",
+    不等于 => "!=",
+    大于 => ">",
+    小于 => "<",
+    大于等于 => ">=",
+    小于等于 => "<=",
+    逻辑与 => "&&",
+    逻辑或 => "||",
+    分号 => ";",
+    逗号 => ",",
+    左括号 => "(",
+    右括号 => ")",
+    左大括号 => "{",
+    右大括号 => "}",
+    左方括号 => "[",
+    右方括号 => "]",
+    冒号 => ":",
+    双冒号 => "::",
+    短声明 => ":=",
+    通道箭头 => "<-",
+    点 => ".",
+    范围 => "..",
+    中文左括号 => "（",
+    中文右括号 => "）",
+    中文左大括号 => "【",
+    中文右大括号 => "】",
+    中文逗号 => "，",
+    中文分号 => "；",
+    中文冒号 => "：",
+}
+
+/// Token as seen by the grammar
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum Tok<'input> {
+    Symbol(Symbol),
+    Ident(&'input str),
+    Int(i64),
+    Float(&'input str),
+    /// String literal including its surrounding quotes
+    Str(&'input str),
+    Char(char),
+}
+
+/// Convert a lexer token into a grammar token
+///
+/// Keywords and punctuation are mapped from the lexer's `TokenKind`, so the
+/// text of a token is not compared again. The grammar only reserves the
+/// words listed in [`Symbol`]: lexer keywords outside that list (`循环`,
+/// `模块`, ...) and the lexer's English aliases (`let`, `true`, ...) are
+/// identifiers, and the few grammar words the lexer does not know are picked
+/// out of its identifiers.
+fn classify<'input>(
+    kind: &TokenKind,
+    text: &'input str,
+    line: usize,
+    column: usize,
+) -> Result<Tok<'input>, LexicalError> {
+    match kind {
+        TokenKind::整数字面量(value) => Ok(Tok::Int(*value)),
+        TokenKind::浮点数字面量 => Ok(Tok::Float(text)),
+        TokenKind::字符串字面量 => Ok(Tok::Str(text)),
+        TokenKind::字符字面量(c) => Ok(Tok::Char(*c)),
+        TokenKind::错误 => Err(LexicalError::UnexpectedSymbol(text.to_string(), line, column)),
+        TokenKind::标识符 => Ok(grammar_word(text).map_or(Tok::Ident(text), Tok::Symbol)),
+        _ => match keyword_symbol(kind, text) {
+            Some(symbol) => Ok(Tok::Symbol(symbol)),
+            None if is_word(text) => Ok(Tok::Ident(text)),
+            None => Err(LexicalError::UnexpectedSymbol(text.to_string(), line, column)),
+        },
+    }
+}
+
+/// Grammar keywords that the lexer's keyword table leaves as identifiers
+fn grammar_word(text: &str) -> Option<Symbol> {
+    match text {
+        "否则如果" => Some(Symbol::否则如果),
+        "创建通道" => Some(Symbol::创建通道),
+        "等待" => Some(Symbol::等待),
+        "默认" => Some(Symbol::默认),
+        _ => None,
+    }
+}
+
+/// Grammar symbol for a lexer keyword or punctuation token
+///
+/// `text` is only inspected for kinds the lexer shares between spellings.
+fn keyword_symbol(kind: &TokenKind, text: &str) -> Option<Symbol> {
+    let english = text.as_bytes().first().map_or(false, u8::is_ascii_alphabetic);
+    let symbol = match kind {
+        // Keywords
+        TokenKind::如果 => Symbol::如果,
+        TokenKind::否则 => Symbol::否则,
+        TokenKind::当 => Symbol::当,
+        TokenKind::对于 => Symbol::对于,
+        TokenKind::函数 => Symbol::函数,
+        TokenKind::返回 => Symbol::返回,
+        TokenKind::变量 if !english => Symbol::变量,
+        TokenKind::常量 => Symbol::常量,
+        TokenKind::字符串 => Symbol::字符串,
+        TokenKind::布尔 => Symbol::布尔,
+        TokenKind::类型 => Symbol::类型,
+        TokenKind::数组 => Symbol::数组,
+        TokenKind::导入 => Symbol::导入,
+        TokenKind::作为 => Symbol::作为,
+        TokenKind::在 => Symbol::在,
+        TokenKind::字符 => Symbol::字符,
+        TokenKind::空 => Symbol::空,
+        TokenKind::包 => Symbol::包,
+        TokenKind::公开 => Symbol::公开,
+        TokenKind::启动 => Symbol::启动,
+        TokenKind::通道 => Symbol::通道,
+        TokenKind::选择 => Symbol::选择,
+        TokenKind::情况 => Symbol::情况,
+        TokenKind::未来 => Symbol::未来,
+        TokenKind::真 => Symbol::真,
+        TokenKind::假 => Symbol::假,
+        TokenKind::布尔字面量(true) if !english => Symbol::真,
+        TokenKind::布尔字面量(false) if !english => Symbol::假,
+        TokenKind::跳出 => Symbol::跳出,
+        TokenKind::继续 => Symbol::继续,
+        TokenKind::解引用 => Symbol::解引用,
+        TokenKind::取地址关键字 => Symbol::取地址关键字,
+        TokenKind::类型关键词(basic) => match basic {
+            BasicType::整数 => Symbol::整数,
+            BasicType::长整数 => Symbol::长整数,
+            BasicType::短整数 => Symbol::短整数,
+            BasicType::字节 => Symbol::字节,
+            BasicType::浮点数 => Symbol::浮点数,
+            BasicType::布尔 => Symbol::布尔,
+            BasicType::字符 => Symbol::字符,
+            BasicType::字符串 => Symbol::字符串,
+            BasicType::空 => Symbol::空,
+            BasicType::数组 => Symbol::数组,
+            BasicType::字典 => Symbol::字典,
+            BasicType::列表 => Symbol::列表,
+            BasicType::集合 => Symbol::集合,
+            BasicType::指针 => Symbol::指针,
+            BasicType::引用 => Symbol::引用,
+            BasicType::可变引用 => Symbol::可变引用,
+        },
+        // `与` and `&&`, `或` and `||` share a kind
+        TokenKind::与 if text.starts_with('&') => Symbol::逻辑与,
+        TokenKind::与 => Symbol::与,
+        TokenKind::或 if text.starts_with('|') => Symbol::逻辑或,
+        TokenKind::或 => Symbol::或,
+
+        // Punctuation
+        TokenKind::赋值 => Symbol::赋值,
+        TokenKind::加 => Symbol::加,
+        TokenKind::减 => Symbol::减,
+        TokenKind::乘 => Symbol::乘,
+        TokenKind::除 => Symbol::除,
+        TokenKind::取余 => Symbol::取余,
+        TokenKind::取地址 => Symbol::取地址,
+        TokenKind::等于 => Symbol::等于,
+        TokenKind::不等于 => Symbol::不等于,
+        TokenKind::大于 => Symbol::大于,
+        TokenKind::小于 => Symbol::小于,
+        TokenKind::大于等于 => Symbol::大于等于,
+        TokenKind::小于等于 => Symbol::小于等于,
+        TokenKind::分号 => Symbol::分号,
+        TokenKind::逗号 => Symbol::逗号,
+        TokenKind::左括号 => Symbol::左括号,
+        TokenKind::右括号 => Symbol::右括号,
+        TokenKind::左大括号 => Symbol::左大括号,
+        TokenKind::右大括号 => Symbol::右大括号,
+        TokenKind::左方括号 => Symbol::左方括号,
+        TokenKind::右方括号 => Symbol::右方括号,
+        TokenKind::冒号 => Symbol::冒号,
+        TokenKind::双冒号 => Symbol::双冒号,
+        TokenKind::短声明 => Symbol::短声明,
+        TokenKind::通道箭头 => Symbol::通道箭头,
+        TokenKind::点 => Symbol::点,
+        TokenKind::范围 => Symbol::范围,
+        TokenKind::中文左括号 => Symbol::中文左括号,
+        TokenKind::中文右括号 => Symbol::中文右括号,
+        TokenKind::中文左大括号 => Symbol::中文左大括号,
+        TokenKind::中文右大括号 => Symbol::中文右大括号,
+        TokenKind::中文逗号 => Symbol::中文逗号,
+        TokenKind::中文分号 => Symbol::中文分号,
+        TokenKind::中文冒号 => Symbol::中文冒号,
+        _ => return None,
+    };
+    Some(symbol)
+}
+
+fn is_word(text: &str) -> bool {
+    text.chars().next().map_or(false, |c| c.is_alphabetic() || c == '_')
+}
+
+/// Streaming tokens straight from the lexer
+pub struct TokenStream<'input> {
+    lexer: Lexer<'input>,
+}
+
+impl<'input> TokenStream<'input> {
+    pub fn new(source: &'input str) -> Self {
+        Self {
+            lexer: Lexer::new(source),
+        }
+    }
+}
+
+impl<'input> Iterator for TokenStream<'input> {
+    type Item = Spanned<'input>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let token = match self.lexer.next_significant_token()? {
+            Ok(token) => token,
+            Err(e) => return Some(Err(e)),
+        };
+        let (start, end) = (token.span.start, token.span.end);
+        Some(classify(&token.kind, token.text, token.line, token.column).map(|tok| (start, tok, end)))
+    }
+}
+
+/// Tokens from an already tokenized source
+pub struct SliceStream<'input> {
+    tokens: std::slice::Iter<'input, Token<'input>>,
+}
+
+impl<'input> SliceStream<'input> {
+    pub fn new(tokens: &'input [Token<'input>]) -> Self {
+        Self { tokens: tokens.iter() }
+    }
+}
+
+impl<'input> Iterator for SliceStream<'input> {
+    type Item = Spanned<'input>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let token = self.tokens.next()?;
+        if token.kind == TokenKind::文件结束 {
+            return None;
+        }
+        Some(
+            classify(&token.kind, token.text, token.line, token.column)
+                .map(|tok| (token.span.start, tok, token.span.end)),
+        )
+    }
+}
+
+/// Convert a LALRPOP error into a [`ParseError`]
+///
+/// `locate` maps a byte offset to a 1-based (line, column) pair.
+pub fn convert_error(
+    error: lalrpop_util::ParseError<usize, Tok<'_>, LexicalError>,
+    locate: impl Fn(usize) -> (usize, usize),
+) -> ParseError {
+    use lalrpop_util::ParseError as E;
+
+    match error {
+        E::InvalidToken { location } => {
+            let (line, column) = locate(location);
+            ParseError::InvalidSyntax("无效的标记".to_string(), line, column)
+        }
+        E::UnrecognizedEof { .. } => ParseError::UnexpectedEof,
+        E::UnrecognizedToken { token: (start, tok, _), expected } => {
+            let (line, column) = locate(start);
+            ParseError::InvalidSyntax(
+                format!("意外的标记 {}, 期望 {}", describe(&tok), expected.join(", ")),
+                line,
+                column,
+            )
+        }
+        E::ExtraToken { token: (start, tok, _) } => {
+            let (line, column) = locate(start);
+            ParseError::InvalidSyntax(format!("多余的标记 {}", describe(&tok)), line, column)
+        }
+        E::User { error } => ParseError::Lexical(error),
+    }
+}
+
+fn describe(tok: &Tok<'_>) -> String {
+    match tok {
+        Tok::Symbol(symbol) => format!("'{}'", symbol.spelling()),
+        Tok::Ident(name) => format!("标识符 '{}'", name),
+        Tok::Int(value) => format!("整数 {}", value),
+        Tok::Float(text) => format!("浮点数 {}", text),
+        Tok::Str(text) => format!("字符串 {}", text),
+        Tok::Char(c) => format!("字符 {:?}", c),
+    }
+}
+
+/// 1-based line and column (in characters) of a byte offset
+pub fn line_column(source: &str, offset: usize) -> (usize, usize) {
+    let before = &source[..offset.min(source.len())];
+    let line = before.matches('\n').count() + 1;
+    let line_start = before.rfind('\n').map_or(0, |i| i + 1);
+    (line, before[line_start..].chars().count() + 1)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn 标记(source: &str) -> Vec<Tok<'_>> {
+        TokenStream::new(source).map(|t| t.unwrap().1).collect()
+    }
+
+    #[test]
+    fn test_keywords_and_identifiers() {
+        assert_eq!(
+            标记("变量 计数 = 打印;"),
+            vec![
+                Tok::Symbol(Symbol::变量),
+                Tok::Ident("计数"),
+                Tok::Symbol(Symbol::赋值),
+                Tok::Ident("打印"),
+                Tok::Symbol(Symbol::分号),
+            ]
+        );
+        assert_eq!(标记("取地址 & true"), vec![
+            Tok::Symbol(Symbol::取地址关键字),
+            Tok::Symbol(Symbol::取地址),
+            Tok::Ident("true"),
+        ]);
+    }
+
+    #[test]
+    fn test_multi_char_symbols() {
+        assert_eq!(
+            标记("a::b := 0..10 && x || y <- 通道：；"),
+            vec![
+                Tok::Ident("a"),
+                Tok::Symbol(Symbol::双冒号),
+                Tok::Ident("b"),
+                Tok::Symbol(Symbol::短声明),
+                Tok::Int(0),
+                Tok::Symbol(Symbol::范围),
+                Tok::Int(10),
+                Tok::Symbol(Symbol::逻辑与),
+                Tok::Ident("x"),
+                Tok::Symbol(Symbol::逻辑或),
+                Tok::Ident("y"),
+                Tok::Symbol(Symbol::通道箭头),
+                Tok::Symbol(Symbol::通道),
+                Tok::Symbol(Symbol::中文冒号),
+                Tok::Symbol(Symbol::中文分号),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_literals_and_comments() {
+        assert_eq!(
+            标记("// 注释\n\"你好\" 3.14 'a' /* 块 */ 42"),
+            vec![Tok::Str("\"你好\""), Tok::Float("3.14"), Tok::Char('a'), Tok::Int(42)]
+        );
+    }
+
+    #[test]
+    fn test_spans_keep_byte_offsets() {
+        let spans: Vec<(usize, usize)> = TokenStream::new("变量 x")
+            .map(|t| {
+                let (start, _, end) = t.unwrap();
+                (start, end)
+            })
+            .collect();
+        assert_eq!(spans, vec![(0, 6), (7, 8)]);
+        assert_eq!(line_column("变量\n  x", 9), (2, 3));
+    }
+
+    #[test]
+    fn test_symbols_unused_by_grammar_are_errors() {
+        let result: Vec<_> = TokenStream::new("x -> y").collect();
+        assert!(matches!(result[1], Err(LexicalError::UnexpectedSymbol(ref s, 1, 3)) if s == "->"));
+    }
+
+    #[test]
+    fn test_every_symbol_spelling_maps_to_its_symbol() {
+        for &symbol in Symbol::ALL {
+            assert_eq!(标记(symbol.spelling()), vec![Tok::Symbol(symbol)], "{}", symbol.spelling());
+        }
+        assert_eq!(
+            标记("let print true false 循环 模块"),
+            vec![
+                Tok::Ident("let"),
+                Tok::Ident("print"),
+                Tok::Ident("true"),
+                Tok::Ident("false"),
+                Tok::Ident("循环"),
+                Tok::Ident("模块"),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_slice_stream_matches_source_stream() {
+        let source = "函数 主() { 返回 1; }";
+        let tokens = Lexer::new(source).tokenize().unwrap();
+        let from_slice: Vec<_> = SliceStream::new(&tokens).map(|t| t.unwrap()).collect();
+        let from_source: Vec<_> = TokenStream::new(source).map(|t| t.unwrap()).collect();
+        assert_eq!(from_slice, from_source);
+    }
+}
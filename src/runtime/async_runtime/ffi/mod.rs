@@ -35,6 +35,7 @@ fn ensure_runtime_initialized() {
         let _ = TASK_STORE.set(Mutex::new(HashMap::new()));
         // Initialize the channel registry
         let _ = CHANNEL_REGISTRY.set(Mutex::new(HashMap::new()));
+        let _ = IPC_CHANNEL_REGISTRY.set(Mutex::new(HashMap::new()));
         // Initialize the timer registry
         let _ = TIMER_REGISTRY.set(Mutex::new(HashMap::new()));
     });
@@ -269,11 +270,26 @@ pub extern "C" fn qi_runtime_spawn_goroutine_with_args(
 use std::sync::mpsc::{self, Sender, Receiver};
 use std::sync::Arc;
 use std::time::{SystemTime, UNIX_EPOCH, Duration};
+use std::ffi::CStr;
+use std::os::raw::c_char;
+use super::ipc::IpcChannel;
 
 /// Global channel registry
 static CHANNEL_REGISTRY: OnceLock<Mutex<HashMap<u64, Arc<ChannelInstance>>>> = OnceLock::new();
 static mut NEXT_CHANNEL_ID: u64 = 1;
 
+/// Inter-process channels, sharing the channel ID counter so the same
+/// send/receive/close calls work on either kind
+static IPC_CHANNEL_REGISTRY: OnceLock<Mutex<HashMap<u64, Arc<IpcChannel>>>> = OnceLock::new();
+
+/// Tag bit set in inter-process channel IDs, so operations on in-process
+/// channels never take the IPC registry lock
+const IPC_CHANNEL_TAG: u64 = 1 << 62;
+
+fn is_ipc_channel(channel_id: u64) -> bool {
+    channel_id & IPC_CHANNEL_TAG != 0
+}
+
 /// Global timer registry
 static TIMER_REGISTRY: OnceLock<Mutex<HashMap<u64, Arc<Mutex<TimerInstance>>>>> = OnceLock::new();
 static mut NEXT_TIMER_ID: u64 = 1;
@@ -332,6 +348,80 @@ pub extern "C" fn qi_runtime_create_channel(buffer_size: i64) -> *mut c_void {
     std::ptr::null_mut()
 }
 
+/// Look up an inter-process channel; the registry lock is released
+/// before the caller blocks on it
+fn lookup_ipc_channel(channel_id: u64) -> Option<Arc<IpcChannel>> {
+    IPC_CHANNEL_REGISTRY
+        .get()?
+        .lock()
+        .ok()
+        .and_then(|registry_guard| registry_guard.get(&channel_id).cloned())
+}
+
+fn register_ipc_channel(channel: IpcChannel) -> *mut c_void {
+    let channel_id = unsafe {
+        let id = NEXT_CHANNEL_ID;
+        NEXT_CHANNEL_ID += 1;
+        id | IPC_CHANNEL_TAG
+    };
+
+    if let Some(registry) = IPC_CHANNEL_REGISTRY.get() {
+        if let Ok(mut registry_guard) = registry.lock() {
+            registry_guard.insert(channel_id, Arc::new(channel));
+            if debug_enabled() {
+                eprintln!("DEBUG: Registered IPC channel with ID {}", channel_id);
+            }
+            return channel_id as *mut c_void;
+        }
+    }
+
+    std::ptr::null_mut()
+}
+
+/// Create an inter-process channel backed by a shared-memory ring
+/// name: Name other processes pass to qi_runtime_ipc_open_channel
+/// capacity: Ring size in values (0 = default)
+/// Returns: Channel handle usable with the regular channel calls, or null on error
+#[no_mangle]
+pub extern "C" fn qi_runtime_ipc_create_channel(name: *const c_char, capacity: i64) -> *mut c_void {
+    ensure_runtime_initialized();
+    if name.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    let name = unsafe { CStr::from_ptr(name).to_string_lossy().to_string() };
+    match IpcChannel::create(&name, capacity.max(0) as usize) {
+        Ok(channel) => register_ipc_channel(channel),
+        Err(error) => {
+            if debug_enabled() {
+                eprintln!("DEBUG: Failed to create IPC channel {}: {:?}", name, error);
+            }
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Open an inter-process channel created by another process
+/// Returns: Channel handle usable with the regular channel calls, or null on error
+#[no_mangle]
+pub extern "C" fn qi_runtime_ipc_open_channel(name: *const c_char) -> *mut c_void {
+    ensure_runtime_initialized();
+    if name.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    let name = unsafe { CStr::from_ptr(name).to_string_lossy().to_string() };
+    match IpcChannel::open(&name) {
+        Ok(channel) => register_ipc_channel(channel),
+        Err(error) => {
+            if debug_enabled() {
+                eprintln!("DEBUG: Failed to open IPC channel {}: {:?}", name, error);
+            }
+            std::ptr::null_mut()
+        }
+    }
+}
+
 /// Send a value to a channel (i64 value)
 #[no_mangle]
 pub extern "C" fn qi_runtime_channel_send(channel: *mut c_void, value: i64) -> i32 {
@@ -342,6 +432,13 @@ pub extern "C" fn qi_runtime_channel_send(channel: *mut c_void, value: i64) -> i
 
     let channel_id = channel as u64;
 
+    if is_ipc_channel(channel_id) {
+        return match lookup_ipc_channel(channel_id).map(|ipc_channel| ipc_channel.send(value)) {
+            Some(Ok(())) => 0,
+            _ => -1,
+        };
+    }
+
     // Box the i64 value to send through the channel
     let value_ptr = Box::into_raw(Box::new(value)) as *mut c_void;
 
@@ -383,6 +480,19 @@ pub extern "C" fn qi_runtime_channel_receive(channel: *mut c_void, result_ptr: *
 
     let channel_id = channel as u64;
 
+    if is_ipc_channel(channel_id) {
+        return match lookup_ipc_channel(channel_id).map(|ipc_channel| ipc_channel.recv()) {
+            Some(Ok(value)) => {
+                // Same boxed representation as in-process channels
+                unsafe {
+                    *result_ptr = Box::into_raw(Box::new(value)) as *mut c_void;
+                }
+                0
+            }
+            _ => -1,
+        };
+    }
+
     if let Some(registry) = CHANNEL_REGISTRY.get() {
         if let Ok(registry_guard) = registry.lock() {
             if let Some(channel_instance) = registry_guard.get(&channel_id) {
@@ -417,6 +527,42 @@ pub extern "C" fn qi_runtime_channel_receive(channel: *mut c_void, result_ptr: *
     -1 // Error
 }
 
+/// Close a channel and release its handle
+/// For inter-process channels the peer's pending and future receives see
+/// the close once the ring is drained
+/// Returns: 0 on success, -1 if the handle is unknown
+#[no_mangle]
+pub extern "C" fn qi_runtime_channel_close(channel: *mut c_void) -> i32 {
+    ensure_runtime_initialized();
+    if debug_enabled() {
+        eprintln!("DEBUG: channel_close called with channel {:?}", channel);
+    }
+
+    let channel_id = channel as u64;
+
+    if is_ipc_channel(channel_id) {
+        if let Some(registry) = IPC_CHANNEL_REGISTRY.get() {
+            if let Ok(mut registry_guard) = registry.lock() {
+                if let Some(ipc_channel) = registry_guard.remove(&channel_id) {
+                    ipc_channel.close();
+                    return 0;
+                }
+            }
+        }
+        return -1;
+    }
+
+    if let Some(registry) = CHANNEL_REGISTRY.get() {
+        if let Ok(mut registry_guard) = registry.lock() {
+            if registry_guard.remove(&channel_id).is_some() {
+                return 0;
+            }
+        }
+    }
+
+    -1 // Error
+}
+
 /// Select statement implementation
 #[no_mangle]
 pub extern "C" fn qi_runtime_select(select_cases: *mut c_void) -> *mut c_void {
@@ -0,0 +1,482 @@
+//! Inter-process channels over a shared-memory ring buffer.
+//!
+//! An `IpcChannel` is a single-producer, single-consumer ring of `i64`
+//! values in a POSIX shared memory object, so two processes can exchange
+//! the same values an in-process `通道` carries. One process creates the
+//! channel under a name and the other opens it; after that, sends and
+//! receives only touch the shared mapping. A futex on the mapping is used
+//! to sleep when the ring is empty or full, and the other side only pays
+//! for a wake-up system call while someone is actually asleep.
+//!
+//! Exactly one process (or thread) may send and one may receive. Other
+//! Unix targets without futexes poll with short sleeps instead.
+
+use std::ffi::CString;
+use std::sync::atomic::{fence, AtomicU32, AtomicU64, Ordering};
+use std::time::{Duration, Instant};
+
+use crate::runtime::{RuntimeError, RuntimeResult};
+
+/// Identifies a mapping created by this module ("qi-ipc1")
+const MAGIC: u64 = 0x0031_6370_692d_6971;
+/// Default number of slots when the caller passes 0
+pub const DEFAULT_CAPACITY: usize = 1024;
+/// Upper bound on slots, keeping the mapping under 8 MiB
+const MAX_CAPACITY: usize = 1 << 20;
+/// Longest single sleep before re-checking for a closed peer
+const WAIT_SLICE: Duration = Duration::from_millis(100);
+
+/// Counter on its own cache line, so producer and consumer don't share one
+#[repr(C, align(64))]
+struct Padded<T>(T);
+
+/// Layout at the start of the shared mapping; the slots follow it
+#[repr(C)]
+struct Header {
+    magic: AtomicU64,
+    capacity: AtomicU64,
+    /// Next slot to read, written only by the consumer
+    head: Padded<AtomicU64>,
+    /// Next slot to write, written only by the producer
+    tail: Padded<AtomicU64>,
+    /// Bumped by the producer to wake a waiting consumer
+    readable: Padded<AtomicU32>,
+    /// Bumped by the consumer to wake a waiting producer
+    writable: Padded<AtomicU32>,
+    consumer_waiting: AtomicU32,
+    producer_waiting: AtomicU32,
+    closed: AtomicU32,
+}
+
+/// Why a send or receive did not complete
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ChannelStatus {
+    /// The ring stayed full or empty until the timeout
+    Timeout,
+    /// The channel was closed (and, for receives, drained)
+    Closed,
+}
+
+/// One end of a shared-memory channel
+#[derive(Debug)]
+pub struct IpcChannel {
+    name: String,
+    base: *mut u8,
+    mapping_len: usize,
+    capacity: u64,
+    /// The creator unlinks the name when dropped
+    owner: bool,
+}
+
+// The mapping is shared memory accessed only through atomics
+unsafe impl Send for IpcChannel {}
+unsafe impl Sync for IpcChannel {}
+
+impl IpcChannel {
+    /// Create a channel with room for `capacity` values (rounded up to a
+    /// power of two) and publish it under `name`
+    pub fn create(name: &str, capacity: usize) -> RuntimeResult<Self> {
+        let capacity = match capacity {
+            0 => DEFAULT_CAPACITY,
+            n => n.min(MAX_CAPACITY).next_power_of_two(),
+        };
+        let path = shm_path(name)?;
+        let fd = unsafe {
+            libc::shm_open(path.as_ptr(), libc::O_CREAT | libc::O_EXCL | libc::O_RDWR, 0o600 as libc::mode_t)
+        };
+        if fd < 0 {
+            return Err(os_error("创建共享内存失败", name));
+        }
+
+        let mapping_len = mapping_len(capacity as u64);
+        let mapped = if unsafe { libc::ftruncate(fd, mapping_len as libc::off_t) } == 0 {
+            map(fd, mapping_len)
+        } else {
+            Err(os_error("设置共享内存大小失败", name))
+        };
+        unsafe { libc::close(fd) };
+        let base = match mapped {
+            Ok(base) => base,
+            Err(error) => {
+                unsafe { libc::shm_unlink(path.as_ptr()) };
+                return Err(error);
+            }
+        };
+
+        // The object is zero-filled; the magic is written last so openers
+        // never see a half-initialised header
+        let channel = Self { name: name.to_string(), base, mapping_len, capacity: capacity as u64, owner: true };
+        channel.header().capacity.store(capacity as u64, Ordering::Relaxed);
+        channel.header().magic.store(MAGIC, Ordering::Release);
+        Ok(channel)
+    }
+
+    /// Open a channel another process created with `create`
+    pub fn open(name: &str) -> RuntimeResult<Self> {
+        let path = shm_path(name)?;
+        let fd = unsafe { libc::shm_open(path.as_ptr(), libc::O_RDWR, 0) };
+        if fd < 0 {
+            return Err(os_error("打开共享内存失败", name));
+        }
+
+        let mut stat: libc::stat = unsafe { std::mem::zeroed() };
+        let size = if unsafe { libc::fstat(fd, &mut stat) } == 0 { stat.st_size as usize } else { 0 };
+        let mapped = if size >= std::mem::size_of::<Header>() {
+            map(fd, size)
+        } else {
+            Err(invalid_channel(name))
+        };
+        unsafe { libc::close(fd) };
+        let base = mapped?;
+
+        let mut channel = Self { name: name.to_string(), base, mapping_len: size, capacity: 0, owner: false };
+        let capacity = channel.header().capacity.load(Ordering::Relaxed);
+        if channel.header().magic.load(Ordering::Acquire) != MAGIC
+            || !capacity.is_power_of_two()
+            || mapping_len(capacity) > size
+        {
+            return Err(invalid_channel(name));
+        }
+        channel.capacity = capacity;
+        Ok(channel)
+    }
+
+    /// Remove a channel name left behind by a process that exited without
+    /// dropping its creator end
+    pub fn unlink(name: &str) -> bool {
+        match shm_path(name) {
+            Ok(path) => unsafe { libc::shm_unlink(path.as_ptr()) == 0 },
+            Err(_) => false,
+        }
+    }
+
+    /// Name the channel was created under
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Number of slots in the ring
+    pub fn capacity(&self) -> usize {
+        self.capacity as usize
+    }
+
+    /// Number of values waiting to be received
+    pub fn len(&self) -> usize {
+        let header = self.header();
+        let tail = header.tail.0.load(Ordering::Acquire);
+        tail.wrapping_sub(header.head.0.load(Ordering::Acquire)) as usize
+    }
+
+    /// Check whether no values are waiting
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Send a value, waiting while the ring is full
+    pub fn send(&self, value: i64) -> Result<(), ChannelStatus> {
+        self.send_timeout(value, None)
+    }
+
+    /// Send a value without waiting
+    pub fn try_send(&self, value: i64) -> Result<(), ChannelStatus> {
+        self.send_timeout(value, Some(Duration::ZERO))
+    }
+
+    /// Send a value, waiting up to `timeout` (`None` for ever) for space
+    pub fn send_timeout(&self, value: i64, timeout: Option<Duration>) -> Result<(), ChannelStatus> {
+        let header = self.header();
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        let tail = header.tail.0.load(Ordering::Relaxed);
+        loop {
+            if self.is_closed() {
+                return Err(ChannelStatus::Closed);
+            }
+            if tail.wrapping_sub(header.head.0.load(Ordering::Acquire)) < self.capacity {
+                break;
+            }
+            wait_for(
+                &header.writable.0,
+                &header.producer_waiting,
+                || tail.wrapping_sub(header.head.0.load(Ordering::Acquire)) < self.capacity || self.is_closed(),
+                deadline,
+            )
+            .ok_or(ChannelStatus::Timeout)?;
+        }
+
+        unsafe { self.slot(tail).write_volatile(value) };
+        header.tail.0.store(tail.wrapping_add(1), Ordering::Release);
+        wake(&header.readable.0, &header.consumer_waiting);
+        Ok(())
+    }
+
+    /// Receive a value, waiting until one arrives or the channel is closed
+    pub fn recv(&self) -> Result<i64, ChannelStatus> {
+        self.recv_timeout(None)
+    }
+
+    /// Receive a value without waiting
+    pub fn try_recv(&self) -> Result<i64, ChannelStatus> {
+        self.recv_timeout(Some(Duration::ZERO))
+    }
+
+    /// Receive a value, waiting up to `timeout` (`None` for ever)
+    ///
+    /// Values sent before `close` are still delivered; `Closed` is only
+    /// returned once the ring is empty.
+    pub fn recv_timeout(&self, timeout: Option<Duration>) -> Result<i64, ChannelStatus> {
+        let header = self.header();
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        let head = header.head.0.load(Ordering::Relaxed);
+        loop {
+            if header.tail.0.load(Ordering::Acquire) != head {
+                break;
+            }
+            if self.is_closed() {
+                return Err(ChannelStatus::Closed);
+            }
+            wait_for(
+                &header.readable.0,
+                &header.consumer_waiting,
+                || header.tail.0.load(Ordering::Acquire) != head || self.is_closed(),
+                deadline,
+            )
+            .ok_or(ChannelStatus::Timeout)?;
+        }
+
+        let value = unsafe { self.slot(head).read_volatile() };
+        header.head.0.store(head.wrapping_add(1), Ordering::Release);
+        wake(&header.writable.0, &header.producer_waiting);
+        Ok(value)
+    }
+
+    /// Close the channel for both ends and wake anyone waiting
+    pub fn close(&self) {
+        let header = self.header();
+        header.closed.store(1, Ordering::Release);
+        header.readable.0.fetch_add(1, Ordering::Release);
+        header.writable.0.fetch_add(1, Ordering::Release);
+        futex_wake(&header.readable.0);
+        futex_wake(&header.writable.0);
+    }
+
+    /// Check whether either end has closed the channel
+    pub fn is_closed(&self) -> bool {
+        self.header().closed.load(Ordering::Acquire) != 0
+    }
+
+    fn header(&self) -> &Header {
+        unsafe { &*(self.base as *const Header) }
+    }
+
+    fn slot(&self, position: u64) -> *mut i64 {
+        let index = (position & (self.capacity - 1)) as usize;
+        unsafe { (self.base.add(std::mem::size_of::<Header>()) as *mut i64).add(index) }
+    }
+}
+
+impl Drop for IpcChannel {
+    fn drop(&mut self) {
+        unsafe { libc::munmap(self.base as *mut libc::c_void, self.mapping_len) };
+        if self.owner {
+            Self::unlink(&self.name);
+        }
+    }
+}
+
+fn mapping_len(capacity: u64) -> usize {
+    std::mem::size_of::<Header>() + capacity as usize * std::mem::size_of::<i64>()
+}
+
+fn shm_path(name: &str) -> RuntimeResult<CString> {
+    let trimmed = name.trim_start_matches('/');
+    if trimmed.is_empty() || trimmed.contains('/') {
+        return Err(invalid_channel(name));
+    }
+    CString::new(format!("/{}", trimmed)).map_err(|_| invalid_channel(name))
+}
+
+fn map(fd: libc::c_int, len: usize) -> RuntimeResult<*mut u8> {
+    let base = unsafe {
+        libc::mmap(std::ptr::null_mut(), len, libc::PROT_READ | libc::PROT_WRITE, libc::MAP_SHARED, fd, 0)
+    };
+    if base == libc::MAP_FAILED {
+        Err(os_error("映射共享内存失败", ""))
+    } else {
+        Ok(base as *mut u8)
+    }
+}
+
+fn os_error(context: &str, name: &str) -> RuntimeError {
+    let message = format!("{} {}: {}", context, name, std::io::Error::last_os_error());
+    RuntimeError::system_error(message.clone(), message)
+}
+
+fn invalid_channel(name: &str) -> RuntimeError {
+    let message = format!("无效的进程通道: {}", name);
+    RuntimeError::system_error(message.clone(), message)
+}
+
+/// Sleep on `word` until `ready` holds, returning `None` on timeout
+///
+/// The waiter raises `waiting` before its final check, and the other side
+/// publishes before checking `waiting`; with a full fence on both sides at
+/// least one of them sees the other, so no wake-up is lost.
+fn wait_for(
+    word: &AtomicU32,
+    waiting: &AtomicU32,
+    ready: impl Fn() -> bool,
+    deadline: Option<Instant>,
+) -> Option<()> {
+    loop {
+        let slice = match deadline {
+            Some(deadline) => match deadline.checked_duration_since(Instant::now()) {
+                Some(remaining) if !remaining.is_zero() => remaining.min(WAIT_SLICE),
+                _ => return if ready() { Some(()) } else { None },
+            },
+            None => WAIT_SLICE,
+        };
+
+        let observed = word.load(Ordering::Acquire);
+        waiting.store(1, Ordering::Relaxed);
+        fence(Ordering::SeqCst);
+        if ready() {
+            waiting.store(0, Ordering::Relaxed);
+            return Some(());
+        }
+        futex_wait(word, observed, slice);
+        waiting.store(0, Ordering::Relaxed);
+        if ready() {
+            return Some(());
+        }
+    }
+}
+
+/// Wake the other side if it announced it is about to sleep
+fn wake(word: &AtomicU32, waiting: &AtomicU32) {
+    fence(Ordering::SeqCst);
+    if waiting.load(Ordering::Relaxed) != 0 {
+        word.fetch_add(1, Ordering::Release);
+        futex_wake(word);
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn futex_wait(word: &AtomicU32, expected: u32, timeout: Duration) {
+    let timespec = libc::timespec {
+        tv_sec: timeout.as_secs() as libc::time_t,
+        tv_nsec: timeout.subsec_nanos() as libc::c_long,
+    };
+    // Not FUTEX_PRIVATE: the word lives in memory shared between processes
+    unsafe {
+        libc::syscall(libc::SYS_futex, word.as_ptr(), libc::FUTEX_WAIT, expected, &timespec as *const libc::timespec);
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn futex_wake(word: &AtomicU32) {
+    unsafe {
+        libc::syscall(libc::SYS_futex, word.as_ptr(), libc::FUTEX_WAKE, i32::MAX);
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn futex_wait(word: &AtomicU32, expected: u32, timeout: Duration) {
+    let deadline = Instant::now() + timeout;
+    while word.load(Ordering::Acquire) == expected && Instant::now() < deadline {
+        std::thread::sleep(Duration::from_micros(50));
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn futex_wake(_word: &AtomicU32) {}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn unique_name(tag: &str) -> String {
+        format!("qi-test-{}-{}", tag, std::process::id())
+    }
+
+    #[test]
+    fn test_send_receive_and_close() {
+        let name = unique_name("basic");
+        let producer = IpcChannel::create(&name, 3).unwrap();
+        assert_eq!(producer.capacity(), 4);
+        assert!(IpcChannel::create(&name, 4).is_err());
+
+        let consumer = IpcChannel::open(&name).unwrap();
+        assert_eq!(consumer.try_recv(), Err(ChannelStatus::Timeout));
+        for value in 0..4 {
+            producer.send(value).unwrap();
+        }
+        assert_eq!(producer.try_send(4), Err(ChannelStatus::Timeout));
+        assert_eq!(consumer.len(), 4);
+        assert_eq!(consumer.recv(), Ok(0));
+        producer.try_send(4).unwrap();
+
+        // Values sent before close are still delivered
+        producer.close();
+        assert_eq!(producer.send(5), Err(ChannelStatus::Closed));
+        let drained: Vec<i64> = std::iter::from_fn(|| consumer.recv().ok()).collect();
+        assert_eq!(drained, vec![1, 2, 3, 4]);
+        assert_eq!(consumer.recv(), Err(ChannelStatus::Closed));
+
+        // Dropping the creator removes the name
+        drop(producer);
+        assert!(IpcChannel::open(&name).is_err());
+        assert!(IpcChannel::open("bad/name").is_err());
+    }
+
+    #[test]
+    fn test_blocking_transfer_across_threads() {
+        let name = unique_name("threads");
+        let producer = IpcChannel::create(&name, 64).unwrap();
+        let consumer = IpcChannel::open(&name).unwrap();
+
+        const COUNT: i64 = 200_000;
+        let sender = std::thread::spawn(move || {
+            for value in 0..COUNT {
+                producer.send(value).unwrap();
+            }
+            producer.close();
+            producer
+        });
+        let mut expected = 0;
+        while let Ok(value) = consumer.recv() {
+            assert_eq!(value, expected);
+            expected += 1;
+        }
+        assert_eq!(expected, COUNT);
+        drop(sender.join().unwrap());
+    }
+
+    #[test]
+    fn test_transfer_between_processes() {
+        let name = unique_name("fork");
+        let channel = IpcChannel::create(&name, 16).unwrap();
+        // Opened by name before forking: the test process is multi-threaded,
+        // so the child must not allocate or take locks another thread may
+        // have held at the fork. It only sends, closes and exits.
+        let sender = IpcChannel::open(&name).unwrap();
+
+        let pid = unsafe { libc::fork() };
+        assert!(pid >= 0);
+        if pid == 0 {
+            for value in 0..1000i64 {
+                if sender.send(value * value).is_err() {
+                    unsafe { libc::_exit(2) };
+                }
+            }
+            sender.close();
+            unsafe { libc::_exit(0) };
+        }
+        drop(sender);
+
+        let received: Vec<i64> = std::iter::from_fn(|| channel.recv_timeout(Some(Duration::from_secs(10))).ok()).collect();
+        let mut status = 0;
+        unsafe { libc::waitpid(pid, &mut status, 0) };
+        assert_eq!(status, 0);
+        assert_eq!(received, (0..1000i64).map(|value| value * value).collect::<Vec<_>>());
+    }
+}
@@ -10,6 +10,7 @@
 //! - **Task Queue**: Lock-free concurrent task queues
 //! - **Pool**: Worker thread pool with adaptive sizing
 //! - **FFI**: C bindings for low-level syscalls (epoll, kqueue, IOCP)
+//! - **IPC**: Shared-memory channels between processes
 //!
 //! # Features
 //!
@@ -39,6 +40,7 @@ pub mod queue;
 pub mod state;
 pub mod ffi;
 pub mod future;
+pub mod ipc;
 
 // Re-export core types
 pub use executor::{Executor, ExecutorHandle};
@@ -48,6 +50,7 @@ pub use pool::{WorkerPool, PoolConfig};
 pub use queue::{TaskQueue, QueueHandle};
 pub use state::{AsyncState, StateManager};
 pub use future::Future;
+pub use ipc::{IpcChannel, ChannelStatus};
 
 use std::sync::Arc;
 use std::time::Duration;
@@ -99,6 +102,9 @@ pub struct Runtime {
 impl Runtime {
     /// Create a new async runtime with the given configuration
     pub fn new(config: RuntimeConfig) -> RuntimeResult<Self> {
+        if config.worker_threads > 0 {
+            pool::configure_data_parallel_workers(config.worker_threads);
+        }
         let pool = Arc::new(WorkerPool::new(PoolConfig {
             worker_count: config.worker_threads,
             queue_capacity: config.queue_capacity,
@@ -1,6 +1,11 @@
 //! Worker pool abstraction for the async runtime
 
+use std::collections::VecDeque;
 use std::fmt;
+use std::ops::Range;
+use std::panic::{self, AssertUnwindSafe};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex, OnceLock};
 
 use crate::runtime::{RuntimeResult, RuntimeError};
 
@@ -90,6 +95,246 @@ impl fmt::Debug for WorkerPool {
     }
 }
 
+/// Worker count requested by the first `Runtime`, before the pool starts
+static DATA_PARALLEL_WORKERS: OnceLock<usize> = OnceLock::new();
+
+/// Size the data-parallel pool from the runtime configuration
+///
+/// Only the first call before the pool starts has an effect.
+pub fn configure_data_parallel_workers(workers: usize) {
+    let _ = DATA_PARALLEL_WORKERS.set(workers.max(1));
+}
+
+/// Persistent threads behind the data-parallel helpers below
+///
+/// Started on first use with one thread fewer than the runtime's worker
+/// count, since the calling thread always takes part. A batch is a job
+/// `Fn(usize)` run for every index in `0..count`; participants claim
+/// indices from a shared counter, so the caller finishes the batch on its
+/// own when every pool thread is busy (including nested calls from inside
+/// a job) and never waits on a thread that cannot help.
+struct DataParallelPool {
+    queue: &'static BatchQueue,
+    /// Threads that started, plus the calling thread
+    workers: usize,
+}
+
+/// Batches waiting for pool threads, one entry per helper wanted
+struct BatchQueue {
+    batches: Mutex<VecDeque<Arc<Batch>>>,
+    batch_ready: Condvar,
+}
+
+/// One call's jobs, shared by the caller and the pool threads that help
+struct Batch {
+    /// Lifetime-erased borrow of the caller's job; only dereferenced for
+    /// a claimed index, and the caller returns only once every claimed
+    /// index has finished
+    job: *const (dyn Fn(usize) + Sync),
+    count: usize,
+    next: AtomicUsize,
+    finished: Mutex<usize>,
+    all_finished: Condvar,
+    panicked: AtomicBool,
+}
+
+// SAFETY: `job` points to a `Sync` closure that outlives every use (see above)
+unsafe impl Send for Batch {}
+unsafe impl Sync for Batch {}
+
+impl Batch {
+    /// Run claimed indices until none are left
+    fn help(&self) {
+        loop {
+            let index = self.next.fetch_add(1, Ordering::Relaxed);
+            if index >= self.count {
+                return;
+            }
+            // SAFETY: the index was claimed below `count`, so the caller is
+            // still waiting in `run` and the borrowed job is alive
+            let job = unsafe { &*self.job };
+            if panic::catch_unwind(AssertUnwindSafe(|| job(index))).is_err() {
+                self.panicked.store(true, Ordering::Relaxed);
+            }
+            let mut finished = self.finished.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+            *finished += 1;
+            if *finished == self.count {
+                self.all_finished.notify_all();
+            }
+        }
+    }
+}
+
+impl BatchQueue {
+    fn run_worker(&self) {
+        loop {
+            let batch = {
+                let mut batches = self.batches.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+                loop {
+                    if let Some(batch) = batches.pop_front() {
+                        break batch;
+                    }
+                    batches = self.batch_ready.wait(batches).unwrap_or_else(|poisoned| poisoned.into_inner());
+                }
+            };
+            batch.help();
+        }
+    }
+}
+
+impl DataParallelPool {
+    fn global() -> &'static DataParallelPool {
+        static POOL: OnceLock<DataParallelPool> = OnceLock::new();
+        POOL.get_or_init(|| {
+            let requested = *DATA_PARALLEL_WORKERS.get_or_init(|| PoolConfig::default().worker_count.max(1));
+            let queue: &'static BatchQueue = Box::leak(Box::new(BatchQueue {
+                batches: Mutex::new(VecDeque::new()),
+                batch_ready: Condvar::new(),
+            }));
+            let started = (1..requested)
+                .filter(|index| {
+                    std::thread::Builder::new()
+                        .name(format!("qi-data-{}", index))
+                        .spawn(move || queue.run_worker())
+                        .is_ok()
+                })
+                .count();
+            DataParallelPool { queue, workers: started + 1 }
+        })
+    }
+
+    /// Run `job(index)` for every index in `0..count` and wait for all of them
+    fn run(&self, count: usize, job: &(dyn Fn(usize) + Sync)) {
+        if count <= 1 || self.workers == 1 {
+            (0..count).for_each(job);
+            return;
+        }
+
+        // SAFETY: only the lifetime is erased; see `Batch::job`
+        let job: *const (dyn Fn(usize) + Sync + 'static) = unsafe { std::mem::transmute(job) };
+        let batch = Arc::new(Batch {
+            job,
+            count,
+            next: AtomicUsize::new(0),
+            finished: Mutex::new(0),
+            all_finished: Condvar::new(),
+            panicked: AtomicBool::new(false),
+        });
+        let helpers = (count - 1).min(self.workers - 1);
+        {
+            let mut batches = self.queue.batches.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+            batches.extend(std::iter::repeat_with(|| Arc::clone(&batch)).take(helpers));
+        }
+        if helpers == 1 {
+            self.queue.batch_ready.notify_one();
+        } else {
+            self.queue.batch_ready.notify_all();
+        }
+
+        batch.help();
+        let mut finished = batch.finished.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+        while *finished < count {
+            finished = batch.all_finished.wait(finished).unwrap_or_else(|poisoned| poisoned.into_inner());
+        }
+        drop(finished);
+        if batch.panicked.load(Ordering::Relaxed) {
+            panic!("数据并行工作线程崩溃");
+        }
+    }
+}
+
+/// Run `job(index)` for every index in `0..count` on the data-parallel pool
+///
+/// Returns once every job has finished; the calling thread takes part.
+pub fn parallel_for(count: usize, job: impl Fn(usize) + Sync) {
+    DataParallelPool::global().run(count, &job);
+}
+
+/// Number of parts to split `len` items of at least `min_chunk` each into
+fn data_parallel_workers(len: usize, min_chunk: usize) -> usize {
+    let by_size = len / min_chunk.max(1);
+    if by_size <= 1 {
+        return 1;
+    }
+    DataParallelPool::global().workers.min(by_size).max(1)
+}
+
+/// Split `0..len` into contiguous ranges and map each one on the pool
+///
+/// Results are returned in range order, so reductions over them are
+/// deterministic for a given machine. Inputs smaller than two chunks run
+/// inline on the calling thread.
+pub fn parallel_map_ranges<T, F>(len: usize, min_chunk: usize, job: F) -> Vec<T>
+where
+    T: Send,
+    F: Fn(Range<usize>) -> T + Sync,
+{
+    let workers = data_parallel_workers(len, min_chunk);
+    if workers == 1 {
+        return vec![job(0..len)];
+    }
+
+    let chunk = (len + workers - 1) / workers;
+    let results: Vec<Mutex<Option<T>>> = (0..workers).map(|_| Mutex::new(None)).collect();
+    parallel_for(workers, |index| {
+        let range = (index * chunk).min(len)..((index + 1) * chunk).min(len);
+        *results[index].lock().unwrap() = Some(job(range));
+    });
+    results
+        .into_iter()
+        .map(|slot| slot.into_inner().unwrap().expect("数据并行任务未完成"))
+        .collect()
+}
+
+/// Apply `job` to disjoint mutable chunks of `data` on the pool
+pub fn parallel_for_each_chunk_mut<T, F>(data: &mut [T], min_chunk: usize, job: F)
+where
+    T: Send,
+    F: Fn(&mut [T]) + Sync,
+{
+    let workers = data_parallel_workers(data.len(), min_chunk);
+    if workers == 1 {
+        job(data);
+        return;
+    }
+
+    let chunk = (data.len() + workers - 1) / workers;
+    let parts: Vec<Mutex<Option<&mut [T]>>> = data.chunks_mut(chunk).map(|part| Mutex::new(Some(part))).collect();
+    parallel_for(parts.len(), |index| {
+        if let Some(part) = parts[index].lock().unwrap().take() {
+            job(part);
+        }
+    });
+}
+
+/// Apply `job` to disjoint bands of whole rows in a row-major buffer
+///
+/// `job` receives the index of the band's first row and the band itself,
+/// so row-oriented kernels (matrix products, image filters) can locate
+/// their matching input rows. Each band runs once, on one thread, so a
+/// kernel can keep per-band scratch buffers across its whole loop nest.
+pub fn parallel_for_each_row_band_mut<T, F>(data: &mut [T], row_len: usize, min_rows: usize, job: F)
+where
+    T: Send,
+    F: Fn(usize, &mut [T]) + Sync,
+{
+    let rows = if row_len == 0 { 0 } else { data.len() / row_len };
+    let workers = data_parallel_workers(rows, min_rows);
+    if workers == 1 {
+        job(0, data);
+        return;
+    }
+
+    let band_rows = (rows + workers - 1) / workers;
+    let bands: Vec<Mutex<Option<&mut [T]>>> =
+        data.chunks_mut(band_rows * row_len).map(|band| Mutex::new(Some(band))).collect();
+    parallel_for(bands.len(), |index| {
+        if let Some(band) = bands[index].lock().unwrap().take() {
+            job(index * band_rows, band);
+        }
+    });
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -124,4 +369,41 @@ mod tests {
         assert!(!pool.work_stealing_enabled());
         assert!(format!("{:?}", pool).contains("WorkerPool"));
     }
+
+    #[test]
+    fn test_parallel_helpers_cover_every_item() {
+        let sums = parallel_map_ranges(10_001, 100, |range| range.sum::<usize>());
+        assert_eq!(sums.iter().sum::<usize>(), (0..10_001).sum::<usize>());
+        assert_eq!(parallel_map_ranges(5, 100, |range| range.len()), vec![5]);
+
+        let mut data = vec![1u32; 10_001];
+        parallel_for_each_chunk_mut(&mut data, 100, |part| part.iter_mut().for_each(|v| *v += 1));
+        assert!(data.iter().all(|&v| v == 2));
+
+        let mut grid = vec![0usize; 7 * 300];
+        parallel_for_each_row_band_mut(&mut grid, 7, 10, |first_row, band| {
+            for (offset, row) in band.chunks_mut(7).enumerate() {
+                row.fill(first_row + offset);
+            }
+        });
+        assert!(grid.chunks(7).enumerate().all(|(row, cells)| cells.iter().all(|&v| v == row)));
+    }
+
+    #[test]
+    fn test_parallel_for_nests_and_propagates_panics() {
+        let total = AtomicUsize::new(0);
+        parallel_for(8, |_| {
+            parallel_for(8, |_| {
+                total.fetch_add(1, Ordering::Relaxed);
+            });
+        });
+        assert_eq!(total.load(Ordering::Relaxed), 64);
+
+        let result = panic::catch_unwind(|| parallel_for(8, |index| assert_ne!(index, 3)));
+        assert!(result.is_err());
+
+        // The pool keeps working after a job panicked
+        let sums = parallel_map_ranges(100_000, 1_000, |range| range.len());
+        assert_eq!(sums.iter().sum::<usize>(), 100_000);
+    }
 }
@@ -6,9 +6,18 @@
 #![allow(static_mut_refs)]
 
 use std::ffi::{c_char, c_int, CStr};
-use std::sync::{Mutex, Once};
+use std::sync::{Mutex, Once, OnceLock};
+use std::time::Instant;
 
 use crate::runtime::{RuntimeEnvironment, RuntimeConfig};
+use crate::runtime::io::{with_stdin, FileHandleTable, FileOperation, FileOperationType, HttpRequest};
+use crate::runtime::io::http_ffi;
+use crate::runtime::io::metrics::{self, IoCategory, IoMetricsSnapshot, IoOpKind};
+use crate::runtime::stdlib::{matrix, vector_math, ConversionModule};
+use crate::runtime::stdlib::number_format::{
+    format_float, format_float_with_point, format_int, parse_float_ascii, parse_int_ascii,
+    FLOAT_BUFFER_SIZE, INT_BUFFER_SIZE,
+};
 
 static RUNTIME_INIT: Once = Once::new();
 static mut RUNTIME: Option<Mutex<RuntimeEnvironment>> = None;
@@ -106,17 +115,13 @@ pub extern "C" fn qi_runtime_print(s: *const c_char) -> c_int {
         return -1;
     }
 
+    let start_time = Instant::now();
     unsafe {
         if let Ok(rust_str) = CStr::from_ptr(s).to_str() {
             print!("{}", rust_str);
             // Force flush to ensure output appears immediately
             std::io::Write::flush(&mut std::io::stdout()).unwrap_or(());
-
-            if let Some(runtime_mutex) = RUNTIME.as_ref() {
-                if let Ok(mut runtime) = runtime_mutex.lock() {
-                    runtime.increment_io_operations();
-                }
-            }
+            record_print(rust_str.len(), start_time);
             0
         } else {
             eprintln!("无效的 UTF-8 字符串");
@@ -132,17 +137,13 @@ pub extern "C" fn qi_runtime_println(s: *const c_char) -> c_int {
         return -1;
     }
 
+    let start_time = Instant::now();
     unsafe {
         if let Ok(rust_str) = CStr::from_ptr(s).to_str() {
             println!("{}", rust_str);
             // Ensure output is flushed (println! should flush, but let's be explicit)
             std::io::Write::flush(&mut std::io::stdout()).unwrap_or(());
-
-            if let Some(runtime_mutex) = RUNTIME.as_ref() {
-                if let Ok(mut runtime) = runtime_mutex.lock() {
-                    runtime.increment_io_operations();
-                }
-            }
+            record_print(rust_str.len(), start_time);
             0
         } else {
             eprintln!("无效的 UTF-8 字符串");
@@ -154,103 +155,77 @@ pub extern "C" fn qi_runtime_println(s: *const c_char) -> c_int {
 /// Print an integer
 #[no_mangle]
 pub extern "C" fn qi_runtime_print_int(value: i64) -> c_int {
-    print!("{}", value);
+    let start_time = Instant::now();
+    let mut buffer = [0u8; INT_BUFFER_SIZE];
+    let text = format_int(value, &mut buffer);
+    print!("{}", text);
     // Force flush to ensure output appears immediately
     std::io::Write::flush(&mut std::io::stdout()).unwrap_or(());
 
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
 /// Print an integer with newline
 #[no_mangle]
 pub extern "C" fn qi_runtime_println_int(value: i64) -> c_int {
-    println!("{}", value);
+    let start_time = Instant::now();
+    let mut buffer = [0u8; INT_BUFFER_SIZE];
+    let text = format_int(value, &mut buffer);
+    println!("{}", text);
     
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
 /// Print a float
 #[no_mangle]
 pub extern "C" fn qi_runtime_print_float(value: f64) -> c_int {
-    print!("{}", value);
+    let start_time = Instant::now();
+    let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+    let text = format_float(value, &mut buffer);
+    print!("{}", text);
     // Force flush to ensure output appears immediately
     std::io::Write::flush(&mut std::io::stdout()).unwrap_or(());
 
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
 /// Print a float with newline
 #[no_mangle]
 pub extern "C" fn qi_runtime_println_float(value: f64) -> c_int {
+    let start_time = Instant::now();
     // Format to always show decimal point for float values
-    if value.fract() == 0.0 {
-        println!("{:.1}", value);  // Show one decimal place for whole numbers
-    } else {
-        println!("{}", value);      // Show normal format for fractions
-    }
+    let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+    let text = format_float_with_point(value, true, &mut buffer);
+    println!("{}", text);
 
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
 /// Print a boolean value (accepts i32: 0 = false, non-zero = true)
 #[no_mangle]
 pub extern "C" fn qi_runtime_print_bool(value: i32) -> c_int {
+    let start_time = Instant::now();
     let text = if value != 0 { "真" } else { "假" };
     print!("{}", text);
     // Force flush to ensure output appears immediately
     std::io::Write::flush(&mut std::io::stdout()).unwrap_or(());
 
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
 /// Print a boolean value with newline (accepts i32: 0 = false, non-zero = true)
 #[no_mangle]
 pub extern "C" fn qi_runtime_println_bool(value: i32) -> c_int {
+    let start_time = Instant::now();
     let text = if value != 0 { "真" } else { "假" };
     println!("{}", text);
 
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
-    }
+    record_print(text.len(), start_time);
     0
 }
 
@@ -345,15 +320,62 @@ pub extern "C" fn qi_runtime_gc_collect() {
     }
 }
 
+/// Count a console write on the process-wide I/O counters
+///
+/// Prints are the most frequent runtime calls, so they record lock-free
+/// instead of taking the runtime mutex.
+fn record_print(bytes: usize, start_time: Instant) {
+    metrics::global().record(IoOpKind::Print, bytes as u64, start_time.elapsed());
+}
+
+/// Per-kind I/O counters and latency percentiles as JSON
+fn io_metrics_json(snapshot: &IoMetricsSnapshot) -> serde_json::Value {
+    let operations: serde_json::Map<String, serde_json::Value> = snapshot
+        .iter()
+        .filter(|(_, op)| op.operations + op.failures > 0)
+        .map(|(kind, op)| {
+            let entry = serde_json::json!({
+                "operations": op.operations,
+                "failures": op.failures,
+                "bytes": op.bytes,
+                "mean_us": op.mean().as_micros() as u64,
+                "p50_us": op.percentile(0.50).as_micros() as u64,
+                "p99_us": op.percentile(0.99).as_micros() as u64,
+            });
+            (kind.name().to_string(), entry)
+        })
+        .collect();
+    serde_json::json!({
+        "total_operations": snapshot.total_operations(),
+        "bytes_read": snapshot.bytes_read(),
+        "bytes_written": snapshot.bytes_written(),
+        "last_operation": snapshot.last_operation,
+        "operations": operations,
+    })
+}
+
 /// Get runtime metrics as JSON string
+///
+/// I/O counters from the runtime's interfaces, the shared HTTP client and
+/// the print paths are merged into an `io` object with per-kind latency
+/// percentiles, and added to the `io_operations` and `network_operations`
+/// totals.
 #[no_mangle]
 pub extern "C" fn qi_runtime_get_metrics() -> *const c_char {
     unsafe {
         if let Some(runtime_mutex) = RUNTIME.as_ref() {
             if let Ok(runtime) = runtime_mutex.lock() {
-                let metrics = runtime.get_metrics();
-                if let Ok(json) = serde_json::to_string(metrics) {
-                    let c_string = std::ffi::CString::new(json).unwrap();
+                let mut io = metrics::global().snapshot();
+                io.merge(&runtime.file_system.io_metrics());
+                io.merge(&runtime.network_manager.io_metrics());
+                io.merge(&http_ffi::获取HTTP客户端().io_metrics());
+
+                let mut runtime_metrics = runtime.get_metrics().clone();
+                runtime_metrics.io_operations += io.total_operations();
+                runtime_metrics.network_operations += io.category_operations(IoCategory::Network);
+                if let Ok(mut report) = serde_json::to_value(&runtime_metrics) {
+                    report["io"] = io_metrics_json(&io);
+                    let c_string = std::ffi::CString::new(report.to_string()).unwrap();
                     return c_string.into_raw();
                 }
             }
@@ -523,8 +545,15 @@ pub extern "C" fn qi_runtime_math_round(x: f64) -> f64 {
 // File I/O Operations
 // ============================================================================
 
+/// Per-handle buffer size for files opened through the FFI
+const FILE_BUFFER_SIZE: usize = 64 * 1024;
+
 /// Open a file (returns file handle or negative on error)
-/// Simplified implementation using path hash as handle
+///
+/// `mode` follows C conventions: `r` reads, `w` truncates, `a` appends, and
+/// a trailing `+` allows the other direction as well. Handles live in the
+/// lock-free `FileHandleTable`, so concurrent file calls do not contend on
+/// the runtime lock.
 #[no_mangle]
 pub extern "C" fn qi_runtime_file_open(path: *const c_char, mode: *const c_char) -> i64 {
     if path.is_null() || mode.is_null() {
@@ -532,27 +561,30 @@ pub extern "C" fn qi_runtime_file_open(path: *const c_char, mode: *const c_char)
     }
 
     unsafe {
-        if let (Ok(path_str), Ok(_mode_str)) = (
+        if let (Ok(path_str), Ok(mode_str)) = (
             CStr::from_ptr(path).to_str(),
             CStr::from_ptr(mode).to_str(),
         ) {
-            // Use a hash of the path as a temporary handle
-            use std::collections::hash_map::DefaultHasher;
-            use std::hash::{Hash, Hasher};
-
-            let mut hasher = DefaultHasher::new();
-            path_str.hash(&mut hasher);
-            let handle = hasher.finish() as i64;
+            let operation_type = match mode_str.trim_end_matches(['b', '+']) {
+                "r" | "读" | "" => FileOperationType::Read,
+                "w" | "写" => FileOperationType::Write,
+                "a" | "追加" => FileOperationType::Append,
+                _ => {
+                    eprintln!("文件打开失败: 无效的模式 {}", mode_str);
+                    return -1;
+                }
+            };
+            let update = mode_str.contains('+');
+            let operation = FileOperation::new(path_str, operation_type)
+                .with_buffer_size(FILE_BUFFER_SIZE);
 
-            // Update I/O operation count
-            if let Some(runtime_mutex) = RUNTIME.as_ref() {
-                if let Ok(mut runtime) = runtime_mutex.lock() {
-                    runtime.increment_io_operations();
+            match FileHandleTable::global().open(&operation, update) {
+                Ok(handle) => handle,
+                Err(e) => {
+                    eprintln!("文件打开失败: {}", e);
+                    -1
                 }
             }
-
-            // Return a positive handle on success
-            if handle <= 0 { 1 } else { handle }
         } else {
             eprintln!("文件打开失败: 无效的UTF-8字符串");
             -1
@@ -560,8 +592,7 @@ pub extern "C" fn qi_runtime_file_open(path: *const c_char, mode: *const c_char)
     }
 }
 
-/// Read from file (returns bytes read or negative on error)
-/// Simplified implementation that simulates reading data
+/// Read from file (returns bytes read, 0 at end of file, or negative on error)
 #[no_mangle]
 pub extern "C" fn qi_runtime_file_read(
     handle: i64,
@@ -572,65 +603,120 @@ pub extern "C" fn qi_runtime_file_read(
         return -1;
     }
 
-    // For this simplified implementation, we simulate reading sample data
-    let sample_data = b"sample file content from Qi runtime";
-    let bytes_to_copy = std::cmp::min(size, sample_data.len());
+    let buffer = unsafe { std::slice::from_raw_parts_mut(buffer, size) };
+    FileHandleTable::global().read(handle, buffer).map_or(-1, |count| count as i64)
+}
 
-    unsafe {
-        std::ptr::copy_nonoverlapping(sample_data.as_ptr(), buffer, bytes_to_copy);
+/// Write to file (returns bytes written or negative on error)
+///
+/// Writes are buffered per handle; they reach the file on flush, close, a
+/// switch to reading, or when the buffer fills.
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_write(
+    handle: i64,
+    data: *const u8,
+    size: usize,
+) -> i64 {
+    if handle <= 0 || data.is_null() || size == 0 {
+        return -1;
     }
 
-    // Update I/O operation count
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
+    let data = unsafe { std::slice::from_raw_parts(data, size) };
+    FileHandleTable::global().write(handle, data).map_or(-1, |count| count as i64)
+}
+
+/// Read a little-endian 64-bit integer (returns 0 at end of file; see `qi_runtime_file_eof`)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_read_int(handle: i64) -> i64 {
+    FileHandleTable::global().read_i64(handle).ok().flatten().unwrap_or(0)
+}
+
+/// Write a little-endian 64-bit integer (returns bytes written or negative on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_write_int(handle: i64, value: i64) -> i64 {
+    FileHandleTable::global().write_i64(handle, value).map_or(-1, |_| 8)
+}
+
+/// Read one byte (returns the byte value, or -1 at end of file or on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_read_byte(handle: i64) -> i64 {
+    match FileHandleTable::global().read_u8(handle) {
+        Ok(Some(byte)) => byte as i64,
+        _ => -1,
     }
+}
 
-    bytes_to_copy as i64
+/// Write the low 8 bits of `value` as one byte (returns 1 or negative on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_write_byte(handle: i64, value: i64) -> i64 {
+    FileHandleTable::global().write_u8(handle, value as u8).map_or(-1, |_| 1)
 }
 
-/// Write to file (returns bytes written or negative on error)
-/// Simplified implementation that simulates writing data
+/// Whether the last sequential read hit end of file (1 yes, 0 no, negative on error)
 #[no_mangle]
-pub extern "C" fn qi_runtime_file_write(
+pub extern "C" fn qi_runtime_file_eof(handle: i64) -> i64 {
+    FileHandleTable::global().is_eof(handle).map_or(-1, |eof| eof as i64)
+}
+
+/// Positional read at `offset` (returns bytes read or negative on error)
+///
+/// Does not move the sequential position and runs outside the handle's lock,
+/// so several threads can read one file in parallel.
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_pread(
     handle: i64,
-    data: *const u8,
+    buffer: *mut u8,
     size: usize,
+    offset: i64,
 ) -> i64 {
-    if handle <= 0 || data.is_null() || size == 0 {
+    if handle <= 0 || buffer.is_null() || size == 0 || offset < 0 {
         return -1;
     }
 
-    // For this simplified implementation, we simulate successful writes
-    // In a full implementation, we would look up the file handle and write to it
+    let buffer = unsafe { std::slice::from_raw_parts_mut(buffer, size) };
+    FileHandleTable::global()
+        .read_at(handle, buffer, offset as u64)
+        .map_or(-1, |count| count as i64)
+}
 
-    // Update I/O operation count
-    unsafe {
-        if let Some(runtime_mutex) = RUNTIME.as_ref() {
-            if let Ok(mut runtime) = runtime_mutex.lock() {
-                runtime.increment_io_operations();
-            }
-        }
+/// Positional write at `offset` (returns bytes written or negative on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_pwrite(
+    handle: i64,
+    data: *const u8,
+    size: usize,
+    offset: i64,
+) -> i64 {
+    if handle <= 0 || data.is_null() || size == 0 || offset < 0 {
+        return -1;
     }
 
-    size as i64
+    let data = unsafe { std::slice::from_raw_parts(data, size) };
+    FileHandleTable::global()
+        .write_at(handle, data, offset as u64)
+        .map_or(-1, |count| count as i64)
+}
+
+/// Flush buffered writes (returns 0 or negative on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_file_flush(handle: i64) -> c_int {
+    FileHandleTable::global().flush(handle).map_or(-1, |_| 0)
 }
 
-/// Close file
-/// Simplified implementation that simulates closing
+/// Close file, flushing buffered writes (returns 0 or negative on error)
 #[no_mangle]
 pub extern "C" fn qi_runtime_file_close(handle: i64) -> c_int {
     if handle <= 0 {
         return -1;
     }
 
-    // For this simplified implementation, we simulate successful closure
-    // In a full implementation, we would look up and close the file handle
-
-    0
+    match FileHandleTable::global().close(handle) {
+        Ok(()) => 0,
+        Err(e) => {
+            eprintln!("文件关闭失败: {}", e);
+            -1
+        }
+    }
 }
 
 /// Read entire file as string (caller must free the result)
@@ -688,6 +774,24 @@ pub extern "C" fn qi_runtime_file_write_string(path: *const c_char, content: *co
 // Network Operations
 // ============================================================================
 
+/// Run an HTTP request on the shared pooled client and return the body
+/// as a C string, or null on failure
+fn http_response_body(request: HttpRequest) -> *mut c_char {
+    match http_ffi::获取HTTP客户端().execute(request) {
+        Ok(response) => {
+            // Counted by the shared client's I/O counters
+            let body = String::from_utf8_lossy(&response.body).into_owned();
+            std::ffi::CString::new(body)
+                .map(|c_string| c_string.into_raw())
+                .unwrap_or(std::ptr::null_mut())
+        }
+        Err(e) => {
+            eprintln!("HTTP请求失败: {}", e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
 /// Make HTTP GET request (caller must free the result)
 #[no_mangle]
 pub extern "C" fn qi_runtime_http_get(url: *const c_char) -> *mut c_char {
@@ -697,20 +801,7 @@ pub extern "C" fn qi_runtime_http_get(url: *const c_char) -> *mut c_char {
 
     unsafe {
         if let Ok(url_str) = CStr::from_ptr(url).to_str() {
-            // For this simplified implementation, we simulate a successful HTTP response
-            // In a full implementation, we would use the network interface
-            let mock_response = r#"{"message": "Mock HTTP response from Qi runtime", "status": "success"}"#;
-
-            if let Ok(c_string) = std::ffi::CString::new(mock_response) {
-                // Update I/O operation count
-                if let Some(runtime_mutex) = RUNTIME.as_ref() {
-                    if let Ok(mut runtime) = runtime_mutex.lock() {
-                        runtime.increment_io_operations();
-                    }
-                }
-
-                return c_string.into_raw();
-            }
+            return http_response_body(HttpRequest::get(url_str.to_string()));
         } else {
             eprintln!("HTTP请求失败: 无效的UTF-8 URL字符串");
         }
@@ -731,22 +822,7 @@ pub extern "C" fn qi_runtime_http_post(url: *const c_char, data: *const c_char)
             CStr::from_ptr(url).to_str(),
             CStr::from_ptr(data).to_str(),
         ) {
-            // For this simplified implementation, we simulate a successful HTTP response
-            let mock_response = format!(
-                r#"{{"message": "Mock POST response", "received_data": "{}", "status": "success"}}"#,
-                data_str
-            );
-
-            if let Ok(c_string) = std::ffi::CString::new(mock_response) {
-                // Update I/O operation count
-                if let Some(runtime_mutex) = RUNTIME.as_ref() {
-                    if let Ok(mut runtime) = runtime_mutex.lock() {
-                        runtime.increment_io_operations();
-                    }
-                }
-
-                return c_string.into_raw();
-            }
+            return http_response_body(HttpRequest::post(url_str.to_string(), data_str.as_bytes().to_vec()));
         } else {
             eprintln!("HTTP POST请求失败: 无效的UTF-8字符串");
         }
@@ -800,6 +876,71 @@ pub extern "C" fn qi_runtime_tcp_close(handle: i64) -> c_int {
     0
 }
 
+// ============================================================================
+// Standard Input
+// ============================================================================
+
+// All input builtins read through the stdin scanner shared with
+// StandardIo, see `io::with_stdin`.
+
+/// Read the next integer from stdin (0 at end of input or on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_read_int() -> i64 {
+    with_stdin(|scanner| match scanner.read_int() {
+        Ok(value) => value.unwrap_or(0),
+        Err(e) => {
+            eprintln!("读取整数失败: {}", e);
+            0
+        }
+    })
+}
+
+/// Read the next float from stdin (0.0 at end of input or on error)
+#[no_mangle]
+pub extern "C" fn qi_runtime_read_float() -> f64 {
+    with_stdin(|scanner| match scanner.read_float() {
+        Ok(value) => value.unwrap_or(0.0),
+        Err(e) => {
+            eprintln!("读取浮点数失败: {}", e);
+            0.0
+        }
+    })
+}
+
+/// Read the next word from stdin (caller must free; null at end of input)
+#[no_mangle]
+pub extern "C" fn qi_runtime_read_word() -> *mut c_char {
+    with_stdin(|scanner| match scanner.next_token() {
+        Ok(Some(word)) => bytes_to_c_string(word),
+        Ok(None) => std::ptr::null_mut(),
+        Err(e) => {
+            eprintln!("读取单词失败: {}", e);
+            std::ptr::null_mut()
+        }
+    })
+}
+
+/// Read the next line from stdin (caller must free; null at end of input)
+#[no_mangle]
+pub extern "C" fn qi_runtime_read_line() -> *mut c_char {
+    with_stdin(|scanner| match scanner.next_line() {
+        Ok(Some(line)) => bytes_to_c_string(line),
+        Ok(None) => std::ptr::null_mut(),
+        Err(e) => {
+            eprintln!("读取行失败: {}", e);
+            std::ptr::null_mut()
+        }
+    })
+}
+
+/// Copy borrowed input bytes into a C string (the only copy on these paths)
+fn bytes_to_c_string(bytes: &[u8]) -> *mut c_char {
+    match std::ffi::CString::new(bytes) {
+        Ok(c_string) => c_string.into_raw(),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
 // ============================================================================
 // Array Operations
 // ============================================================================
@@ -830,6 +971,292 @@ pub extern "C" fn qi_runtime_array_length(array: *const u8) -> i64 {
     }
 }
 
+// ============================================================================
+// Array Math Operations
+// ============================================================================
+//
+// Qi arrays are contiguous 8-byte cells without a length header, so every
+// bulk kernel takes the element count explicitly.
+
+/// View `len` elements at `ptr` as a slice (empty for null or non-positive length)
+unsafe fn array_slice<'a, T>(ptr: *const T, len: i64) -> &'a [T] {
+    if ptr.is_null() || len <= 0 {
+        &[]
+    } else {
+        std::slice::from_raw_parts(ptr, len as usize)
+    }
+}
+
+/// Mutable variant of `array_slice`
+unsafe fn array_slice_mut<'a, T>(ptr: *mut T, len: i64) -> &'a mut [T] {
+    if ptr.is_null() || len <= 0 {
+        &mut []
+    } else {
+        std::slice::from_raw_parts_mut(ptr, len as usize)
+    }
+}
+
+/// Sum of an integer array
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_sum_int(array: *const i64, len: i64) -> i64 {
+    vector_math::sum_i64(unsafe { array_slice(array, len) })
+}
+
+/// Sum of a float array
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_sum_float(array: *const f64, len: i64) -> f64 {
+    vector_math::sum_f64(unsafe { array_slice(array, len) })
+}
+
+/// Smallest element of an integer array (0 when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_min_int(array: *const i64, len: i64) -> i64 {
+    vector_math::min_i64(unsafe { array_slice(array, len) }).unwrap_or(0)
+}
+
+/// Largest element of an integer array (0 when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_max_int(array: *const i64, len: i64) -> i64 {
+    vector_math::max_i64(unsafe { array_slice(array, len) }).unwrap_or(0)
+}
+
+/// Smallest element of a float array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_min_float(array: *const f64, len: i64) -> f64 {
+    vector_math::min_f64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Largest element of a float array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_max_float(array: *const f64, len: i64) -> f64 {
+    vector_math::max_f64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Dot product of two float arrays of length `len`
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_dot_float(a: *const f64, b: *const f64, len: i64) -> f64 {
+    unsafe { vector_math::dot_f64(array_slice(a, len), array_slice(b, len)) }
+}
+
+/// Mean of an integer array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_mean_int(array: *const i64, len: i64) -> f64 {
+    vector_math::mean_i64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Mean of a float array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_mean_float(array: *const f64, len: i64) -> f64 {
+    vector_math::mean_f64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Population variance of an integer array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_variance_int(array: *const i64, len: i64) -> f64 {
+    vector_math::variance_i64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Population variance of a float array (NaN when empty)
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_variance_float(array: *const f64, len: i64) -> f64 {
+    vector_math::variance_f64(unsafe { array_slice(array, len) }).unwrap_or(f64::NAN)
+}
+
+/// Replace each element of a float array with its square root
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_sqrt_float(array: *mut f64, len: i64) -> c_int {
+    vector_math::sqrt_in_place(unsafe { array_slice_mut(array, len) });
+    0
+}
+
+/// Replace each element of a float array with its exponential
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_exp_float(array: *mut f64, len: i64) -> c_int {
+    vector_math::exp_in_place(unsafe { array_slice_mut(array, len) });
+    0
+}
+
+/// Replace each element of a float array with its natural logarithm
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_log_float(array: *mut f64, len: i64) -> c_int {
+    vector_math::ln_in_place(unsafe { array_slice_mut(array, len) });
+    0
+}
+
+/// Clamp each element of an integer array into `[min, max]`
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_clamp_int(array: *mut i64, len: i64, min: i64, max: i64) -> c_int {
+    if min > max {
+        eprintln!("数组限幅失败: 最小值不能大于最大值");
+        return -1;
+    }
+    vector_math::clamp_i64_in_place(unsafe { array_slice_mut(array, len) }, min, max);
+    0
+}
+
+/// Clamp each element of a float array into `[min, max]`
+#[no_mangle]
+pub extern "C" fn qi_runtime_array_clamp_float(array: *mut f64, len: i64, min: f64, max: f64) -> c_int {
+    if !(min <= max) {
+        eprintln!("数组限幅失败: 最小值不能大于最大值");
+        return -1;
+    }
+    vector_math::clamp_f64_in_place(unsafe { array_slice_mut(array, len) }, min, max);
+    0
+}
+
+// ============================================================================
+// Matrix Operations
+// ============================================================================
+//
+// Matrices are row-major float arrays; dimensions are passed explicitly.
+// Negative or overflowing dimensions and null buffers for non-empty
+// matrices return -1 instead of reaching the kernels' length checks.
+
+/// Element count of a rows×cols matrix, if it is addressable
+fn matrix_len(rows: i64, cols: i64) -> Option<usize> {
+    let rows = usize::try_from(rows).ok()?;
+    let cols = usize::try_from(cols).ok()?;
+    rows.checked_mul(cols)
+        .filter(|&len| len <= isize::MAX as usize / std::mem::size_of::<f64>())
+}
+
+/// Borrow a matrix buffer of `len` elements; `None` if it is null but non-empty
+unsafe fn matrix_slice<'a>(ptr: *const f64, len: usize) -> Option<&'a [f64]> {
+    if len == 0 {
+        Some(&[])
+    } else if ptr.is_null() {
+        None
+    } else {
+        Some(std::slice::from_raw_parts(ptr, len))
+    }
+}
+
+/// Whether two `f64` buffers share any memory
+fn buffers_overlap(a: *const f64, a_len: usize, b: *const f64, b_len: usize) -> bool {
+    let size = std::mem::size_of::<f64>();
+    let (a_start, b_start) = (a as usize, b as usize);
+    a_len != 0 && b_len != 0 && a_start < b_start + b_len * size && b_start < a_start + a_len * size
+}
+
+/// Run `compute` on the `len`-element output buffer `out`
+///
+/// When `out` overlaps one of `inputs` (e.g. `C = A·C`), `compute` writes a
+/// temporary buffer that is copied out afterwards, so no input is
+/// overwritten before it has been read and no `&mut` aliases a `&`.
+/// Returns `false` if `out` is null but non-empty.
+unsafe fn with_matrix_output(
+    out: *mut f64,
+    len: usize,
+    inputs: &[(*const f64, usize)],
+    compute: impl FnOnce(&mut [f64]),
+) -> bool {
+    if len == 0 {
+        compute(&mut []);
+        return true;
+    }
+    if out.is_null() {
+        return false;
+    }
+    if inputs.iter().any(|&(input, input_len)| buffers_overlap(out, len, input, input_len)) {
+        let mut result = vec![0.0; len];
+        compute(&mut result);
+        std::ptr::copy_nonoverlapping(result.as_ptr(), out, len);
+    } else {
+        compute(std::slice::from_raw_parts_mut(out, len));
+    }
+    true
+}
+
+/// Multiply an m×k matrix by a k×n matrix into `c` (m×n, overwritten)
+///
+/// `c` may overlap `a` or `b`; the product is then computed out of place.
+#[no_mangle]
+pub extern "C" fn qi_runtime_matrix_multiply(
+    a: *const f64,
+    b: *const f64,
+    c: *mut f64,
+    m: i64,
+    n: i64,
+    k: i64,
+) -> c_int {
+    let (Some(a_len), Some(b_len), Some(c_len)) = (matrix_len(m, k), matrix_len(k, n), matrix_len(m, n)) else {
+        eprintln!("矩阵乘法失败: 无效的矩阵维度");
+        return -1;
+    };
+    let (Some(a_slice), Some(b_slice)) = (unsafe { matrix_slice(a, a_len) }, unsafe { matrix_slice(b, b_len) }) else {
+        eprintln!("矩阵乘法失败: 矩阵指针为空");
+        return -1;
+    };
+    let written = unsafe {
+        with_matrix_output(c, c_len, &[(a, a_len), (b, b_len)], |c| {
+            c.fill(0.0);
+            matrix::gemm(m as usize, n as usize, k as usize, a_slice, b_slice, c);
+        })
+    };
+    if !written {
+        eprintln!("矩阵乘法失败: 矩阵指针为空");
+        return -1;
+    }
+    0
+}
+
+/// Multiply a rows×cols matrix by a vector into `y` (length rows)
+///
+/// `y` may overlap `a` or `x`; the product is then computed out of place.
+#[no_mangle]
+pub extern "C" fn qi_runtime_matrix_vector_multiply(
+    a: *const f64,
+    x: *const f64,
+    y: *mut f64,
+    rows: i64,
+    cols: i64,
+) -> c_int {
+    let (Some(a_len), Some(x_len), Some(y_len)) = (matrix_len(rows, cols), matrix_len(cols, 1), matrix_len(rows, 1)) else {
+        eprintln!("矩阵向量乘法失败: 无效的矩阵维度");
+        return -1;
+    };
+    let (Some(a_slice), Some(x_slice)) = (unsafe { matrix_slice(a, a_len) }, unsafe { matrix_slice(x, x_len) }) else {
+        eprintln!("矩阵向量乘法失败: 矩阵指针为空");
+        return -1;
+    };
+    let written = unsafe {
+        with_matrix_output(y, y_len, &[(a, a_len), (x, x_len)], |y| {
+            matrix::gemv(rows as usize, cols as usize, a_slice, x_slice, y);
+        })
+    };
+    if !written {
+        eprintln!("矩阵向量乘法失败: 矩阵指针为空");
+        return -1;
+    }
+    0
+}
+
+/// Transpose a rows×cols matrix into `out` (cols×rows)
+///
+/// `out` may be `a` itself; the transpose is then computed out of place.
+#[no_mangle]
+pub extern "C" fn qi_runtime_matrix_transpose(a: *const f64, out: *mut f64, rows: i64, cols: i64) -> c_int {
+    let Some(len) = matrix_len(rows, cols) else {
+        eprintln!("矩阵转置失败: 无效的矩阵维度");
+        return -1;
+    };
+    let Some(a_slice) = (unsafe { matrix_slice(a, len) }) else {
+        eprintln!("矩阵转置失败: 矩阵指针为空");
+        return -1;
+    };
+    let written = unsafe {
+        with_matrix_output(out, len, &[(a, len)], |out| {
+            matrix::transpose(rows as usize, cols as usize, a_slice, out);
+        })
+    };
+    if !written {
+        eprintln!("矩阵转置失败: 矩阵指针为空");
+        return -1;
+    }
+    0
+}
+
 // ============================================================================
 // Type Conversion
 // ============================================================================
@@ -837,8 +1264,8 @@ pub extern "C" fn qi_runtime_array_length(array: *const u8) -> i64 {
 /// Convert integer to string (caller must free the result)
 #[no_mangle]
 pub extern "C" fn qi_runtime_int_to_string(value: i64) -> *mut c_char {
-    let string = value.to_string();
-    if let Ok(c_string) = std::ffi::CString::new(string) {
+    let mut buffer = [0u8; INT_BUFFER_SIZE];
+    if let Ok(c_string) = std::ffi::CString::new(format_int(value, &mut buffer)) {
         c_string.into_raw()
     } else {
         std::ptr::null_mut()
@@ -848,8 +1275,8 @@ pub extern "C" fn qi_runtime_int_to_string(value: i64) -> *mut c_char {
 /// Convert float to string (caller must free the result)
 #[no_mangle]
 pub extern "C" fn qi_runtime_float_to_string(value: f64) -> *mut c_char {
-    let string = value.to_string();
-    if let Ok(c_string) = std::ffi::CString::new(string) {
+    let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+    if let Ok(c_string) = std::ffi::CString::new(format_float(value, &mut buffer)) {
         c_string.into_raw()
     } else {
         std::ptr::null_mut()
@@ -864,8 +1291,14 @@ pub extern "C" fn qi_runtime_string_to_int(s: *const c_char) -> i64 {
     }
     
     unsafe {
-        if let Ok(rust_str) = CStr::from_ptr(s).to_str() {
-            rust_str.parse::<i64>().unwrap_or(0)
+        let bytes = CStr::from_ptr(s).to_bytes();
+        if bytes.is_ascii() {
+            return parse_int_ascii(bytes).unwrap_or(0);
+        }
+
+        // Non-ASCII input may be a Chinese numeral such as "一百二十三"
+        if let Ok(rust_str) = std::str::from_utf8(bytes) {
+            chinese_conversion().string_to_int(rust_str).unwrap_or(0)
         } else {
             0
         }
@@ -880,14 +1313,29 @@ pub extern "C" fn qi_runtime_string_to_float(s: *const c_char) -> f64 {
     }
     
     unsafe {
-        if let Ok(rust_str) = CStr::from_ptr(s).to_str() {
-            rust_str.parse::<f64>().unwrap_or(0.0)
+        let bytes = CStr::from_ptr(s).to_bytes();
+        if bytes.is_ascii() {
+            return parse_float_ascii(bytes).unwrap_or(0.0);
+        }
+
+        if let Ok(rust_str) = std::str::from_utf8(bytes) {
+            chinese_conversion().string_to_float(rust_str).unwrap_or(0.0)
         } else {
             0.0
         }
     }
 }
 
+/// Shared conversion module used for Chinese numeral fallbacks
+fn chinese_conversion() -> &'static ConversionModule {
+    static CHINESE_CONVERSION: OnceLock<ConversionModule> = OnceLock::new();
+    CHINESE_CONVERSION.get_or_init(|| {
+        let mut module = ConversionModule::new();
+        module.set_chinese_formatting(true);
+        module
+    })
+}
+
 /// Convert integer to float
 #[no_mangle]
 pub extern "C" fn qi_runtime_int_to_float(value: i64) -> f64 {
@@ -957,6 +1405,79 @@ mod tests {
         let result = qi_runtime_math_abs_int(-42);
         assert_eq!(result, 42);
     }
+
+    #[test]
+    fn test_number_conversions() {
+        use std::ffi::CString;
+
+        let text = qi_runtime_int_to_string(-1234567);
+        unsafe {
+            assert_eq!(CStr::from_ptr(text).to_str().unwrap(), "-1234567");
+            qi_runtime_free_string(text);
+        }
+
+        let text = qi_runtime_float_to_string(0.1);
+        unsafe {
+            assert_eq!(CStr::from_ptr(text).to_str().unwrap(), "0.1");
+            qi_runtime_free_string(text);
+        }
+
+        let ascii = CString::new("9876").unwrap();
+        assert_eq!(qi_runtime_string_to_int(ascii.as_ptr()), 9876);
+
+        let chinese = CString::new("一百二十三").unwrap();
+        assert_eq!(qi_runtime_string_to_int(chinese.as_ptr()), 123);
+
+        let float = CString::new("-2.75").unwrap();
+        assert_eq!(qi_runtime_string_to_float(float.as_ptr()), -2.75);
+    }
+
+    #[test]
+    fn test_matrix_ffi_rejects_invalid_arguments() {
+        let a = [1.0, 2.0, 3.0, 4.0];
+        let mut c = [0.0; 4];
+        assert_eq!(qi_runtime_matrix_multiply(a.as_ptr(), a.as_ptr(), c.as_mut_ptr(), 2, 2, 2), 0);
+        assert_eq!(c, [7.0, 10.0, 15.0, 22.0]);
+
+        let null = std::ptr::null::<f64>();
+        assert_eq!(qi_runtime_matrix_multiply(null, a.as_ptr(), c.as_mut_ptr(), 2, 2, 2), -1);
+        assert_eq!(qi_runtime_matrix_multiply(a.as_ptr(), a.as_ptr(), c.as_mut_ptr(), i64::MAX, 2, 2), -1);
+        assert_eq!(qi_runtime_matrix_vector_multiply(a.as_ptr(), null, c.as_mut_ptr(), 2, 2), -1);
+        assert_eq!(qi_runtime_matrix_transpose(a.as_ptr(), std::ptr::null_mut(), 2, 2), -1);
+        assert_eq!(qi_runtime_matrix_transpose(a.as_ptr(), c.as_mut_ptr(), -1, 2), -1);
+
+        // Empty matrices need no buffers
+        assert_eq!(qi_runtime_matrix_transpose(null, std::ptr::null_mut(), 0, 5), 0);
+    }
+
+    #[test]
+    fn test_matrix_ffi_handles_aliased_output() {
+        let a = [1.0, 2.0, 3.0, 4.0];
+
+        // C = A·C
+        let mut c = [5.0, 6.0, 7.0, 8.0];
+        assert_eq!(qi_runtime_matrix_multiply(a.as_ptr(), c.as_ptr(), c.as_mut_ptr(), 2, 2, 2), 0);
+        assert_eq!(c, [19.0, 22.0, 43.0, 50.0]);
+
+        // A = A·A
+        let mut square = a;
+        assert_eq!(qi_runtime_matrix_multiply(square.as_ptr(), square.as_ptr(), square.as_mut_ptr(), 2, 2, 2), 0);
+        assert_eq!(square, [7.0, 10.0, 15.0, 22.0]);
+
+        // x = A·x, and y overlapping the matrix
+        let mut x = [1.0, 1.0];
+        assert_eq!(qi_runtime_matrix_vector_multiply(a.as_ptr(), x.as_ptr(), x.as_mut_ptr(), 2, 2), 0);
+        assert_eq!(x, [3.0, 7.0]);
+        let mut packed = [1.0, 2.0, 3.0, 4.0, 1.0, 1.0];
+        let base = packed.as_mut_ptr();
+        assert_eq!(qi_runtime_matrix_vector_multiply(base, unsafe { base.add(4) }, unsafe { base.add(3) }, 2, 2), 0);
+        assert_eq!(packed, [1.0, 2.0, 3.0, 3.0, 7.0, 1.0]);
+
+        // In-place transpose
+        let mut t = [1.0, 2.0, 3.0, 4.0, 5.0, 6.0];
+        assert_eq!(qi_runtime_matrix_transpose(t.as_ptr(), t.as_mut_ptr(), 2, 3), 0);
+        assert_eq!(t, [1.0, 4.0, 2.0, 5.0, 3.0, 6.0]);
+    }
 }
 
 // ============================================================================
@@ -0,0 +1,500 @@
+//! DNS Resolver Cache
+//!
+//! Host names are resolved through the system resolver (`getaddrinfo`),
+//! which honours `/etc/hosts`, `nsswitch.conf` and search domains, but
+//! lookups run on a small pool of dedicated resolver threads rather than
+//! on the caller. Results are cached: successful lookups for
+//! `positive_ttl`, failures for `negative_ttl`. `getaddrinfo` does not
+//! report record TTLs, so both are configured rather than taken from the
+//! answer. A lookup that is already in flight is shared by every caller
+//! asking for the same host, so a burst of connects issues one query.
+
+use std::collections::{HashMap, VecDeque};
+use std::io;
+use std::net::{IpAddr, SocketAddr, ToSocketAddrs};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, OnceLock};
+use std::time::{Duration, Instant};
+
+use super::{IoError, IoResult};
+
+/// Default lifetime of a successful lookup
+pub const DEFAULT_POSITIVE_TTL: Duration = Duration::from_secs(30);
+/// Default lifetime of a failed lookup
+pub const DEFAULT_NEGATIVE_TTL: Duration = Duration::from_secs(5);
+/// Default number of cached host names
+const DEFAULT_MAX_ENTRIES: usize = 4096;
+/// Default number of resolver threads
+const DEFAULT_THREADS: usize = 4;
+
+/// Addresses of one host, in resolver order
+pub type Addresses = Arc<[IpAddr]>;
+
+/// Function that performs one uncached lookup
+pub type LookupFn = fn(&str) -> io::Result<Vec<IpAddr>>;
+
+/// Resolver configuration
+#[derive(Debug, Clone)]
+pub struct ResolverConfig {
+    /// How long successful lookups are cached
+    pub positive_ttl: Duration,
+    /// How long failed lookups are cached
+    pub negative_ttl: Duration,
+    /// Most host names kept in the cache
+    pub max_entries: usize,
+    /// Resolver threads running lookups
+    pub threads: usize,
+}
+
+impl Default for ResolverConfig {
+    fn default() -> Self {
+        Self {
+            positive_ttl: DEFAULT_POSITIVE_TTL,
+            negative_ttl: DEFAULT_NEGATIVE_TTL,
+            max_entries: DEFAULT_MAX_ENTRIES,
+            threads: DEFAULT_THREADS,
+        }
+    }
+}
+
+/// Resolver counters
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ResolverStats {
+    /// Answers served from a fresh cache entry
+    pub hits: u64,
+    /// Callers that joined a lookup already in flight
+    pub coalesced: u64,
+    /// Lookups sent to the system resolver
+    pub lookups: u64,
+}
+
+type LookupResult = Result<Addresses, String>;
+
+/// One lookup, shared by every caller waiting on the same host
+struct Lookup {
+    host: String,
+    /// Result and the moment it stops being fresh
+    outcome: Mutex<Option<(LookupResult, Instant)>>,
+    done: Condvar,
+}
+
+impl Lookup {
+    fn lock(&self) -> MutexGuard<'_, Option<(LookupResult, Instant)>> {
+        self.outcome.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    /// In flight, or finished and not yet expired
+    fn is_usable(&self, now: Instant) -> bool {
+        self.lock().as_ref().map_or(true, |(_, expires)| *expires > now)
+    }
+
+    fn wait(&self, timeout: Option<Duration>) -> Option<LookupResult> {
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        let mut outcome = self.lock();
+        loop {
+            if let Some((result, _)) = outcome.as_ref() {
+                return Some(result.clone());
+            }
+            outcome = match deadline {
+                None => self.done.wait(outcome).unwrap_or_else(|poisoned| poisoned.into_inner()),
+                Some(deadline) => {
+                    let remaining = deadline.checked_duration_since(Instant::now()).filter(|d| !d.is_zero())?;
+                    self.done
+                        .wait_timeout(outcome, remaining)
+                        .unwrap_or_else(|poisoned| poisoned.into_inner())
+                        .0
+                }
+            };
+        }
+    }
+}
+
+struct Shared {
+    config: ResolverConfig,
+    lookup: LookupFn,
+    cache: Mutex<HashMap<String, Arc<Lookup>>>,
+    jobs: Mutex<VecDeque<Arc<Lookup>>>,
+    job_ready: Condvar,
+    shutdown: AtomicBool,
+    hits: AtomicU64,
+    coalesced: AtomicU64,
+    lookups: AtomicU64,
+}
+
+impl Shared {
+    fn run_worker(&self) {
+        loop {
+            let job = {
+                let mut jobs = self.jobs.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+                loop {
+                    if self.shutdown.load(Ordering::Acquire) {
+                        return;
+                    }
+                    if let Some(job) = jobs.pop_front() {
+                        break job;
+                    }
+                    jobs = self.job_ready.wait(jobs).unwrap_or_else(|poisoned| poisoned.into_inner());
+                }
+            };
+
+            self.lookups.fetch_add(1, Ordering::Relaxed);
+            let (result, ttl) = match (self.lookup)(&job.host) {
+                Ok(addresses) if !addresses.is_empty() => (Ok(addresses.into()), self.config.positive_ttl),
+                Ok(_) => (Err("无法解析地址".to_string()), self.config.negative_ttl),
+                Err(e) => (Err(format!("解析地址失败: {}", e)), self.config.negative_ttl),
+            };
+            *job.lock() = Some((result, Instant::now() + ttl));
+            job.done.notify_all();
+        }
+    }
+}
+
+/// Caching resolver with coalesced background lookups
+pub struct Resolver {
+    shared: Arc<Shared>,
+    /// Why no resolver thread could be started; lookups fail with it
+    /// instead of waiting forever on an empty worker pool
+    spawn_error: Option<String>,
+}
+
+impl Resolver {
+    /// Create a resolver using the system resolver
+    pub fn new(config: ResolverConfig) -> Self {
+        Self::with_lookup(config, system_lookup)
+    }
+
+    /// Create a resolver that performs lookups with `lookup`
+    pub fn with_lookup(config: ResolverConfig, lookup: LookupFn) -> Self {
+        let threads = config.threads.max(1);
+        let shared = Arc::new(Shared {
+            config,
+            lookup,
+            cache: Mutex::new(HashMap::new()),
+            jobs: Mutex::new(VecDeque::new()),
+            job_ready: Condvar::new(),
+            shutdown: AtomicBool::new(false),
+            hits: AtomicU64::new(0),
+            coalesced: AtomicU64::new(0),
+            lookups: AtomicU64::new(0),
+        });
+        let mut started = 0;
+        let mut spawn_error = None;
+        for index in 0..threads {
+            let shared = Arc::clone(&shared);
+            match std::thread::Builder::new()
+                .name(format!("qi-dns-{}", index))
+                .spawn(move || shared.run_worker())
+            {
+                Ok(_) => started += 1,
+                Err(e) => spawn_error = Some(format!("无法启动解析线程: {}", e)),
+            }
+        }
+        Self { shared, spawn_error: if started == 0 { spawn_error } else { None } }
+    }
+
+    /// Process-wide resolver with the default configuration
+    pub fn global() -> &'static Resolver {
+        static GLOBAL: OnceLock<Resolver> = OnceLock::new();
+        GLOBAL.get_or_init(|| Resolver::new(ResolverConfig::default()))
+    }
+
+    /// Resolve `host`, waiting for the lookup if it is not cached
+    pub fn resolve(&self, host: &str) -> IoResult<Addresses> {
+        self.resolve_async(host).wait()
+    }
+
+    /// Start resolving `host` without waiting
+    pub fn resolve_async(&self, host: &str) -> PendingLookup {
+        let host = strip_brackets(host);
+        if let Ok(ip) = host.parse::<IpAddr>() {
+            return PendingLookup::ready(host, Ok(Arc::from([ip])));
+        }
+
+        let key = host.to_ascii_lowercase();
+        let now = Instant::now();
+        let mut cache = self.shared.cache.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+        if let Some(lookup) = cache.get(&key) {
+            let finished = lookup.lock().as_ref().map(|(_, expires)| *expires > now);
+            match finished {
+                Some(true) => {
+                    self.shared.hits.fetch_add(1, Ordering::Relaxed);
+                    return PendingLookup::shared(Arc::clone(lookup));
+                }
+                None => {
+                    self.shared.coalesced.fetch_add(1, Ordering::Relaxed);
+                    return PendingLookup::shared(Arc::clone(lookup));
+                }
+                Some(false) => {}
+            }
+        }
+
+        if cache.len() >= self.shared.config.max_entries {
+            cache.retain(|_, lookup| lookup.is_usable(now));
+            if cache.len() >= self.shared.config.max_entries {
+                // Still full of fresh entries: drop one finished entry
+                let victim = cache
+                    .iter()
+                    .find(|(_, lookup)| lookup.lock().is_some())
+                    .map(|(host, _)| host.clone());
+                if let Some(victim) = victim {
+                    cache.remove(&victim);
+                }
+            }
+        }
+
+        let lookup = Arc::new(Lookup {
+            host: key.clone(),
+            outcome: Mutex::new(None),
+            done: Condvar::new(),
+        });
+        if let Some(error) = &self.spawn_error {
+            // Nothing would ever run the job, and `resolve` has no timeout
+            *lookup.lock() = Some((Err(error.clone()), now + self.shared.config.negative_ttl));
+            cache.insert(key, Arc::clone(&lookup));
+            return PendingLookup::shared(lookup);
+        }
+        cache.insert(key, Arc::clone(&lookup));
+        drop(cache);
+
+        self.shared
+            .jobs
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .push_back(Arc::clone(&lookup));
+        self.shared.job_ready.notify_one();
+        PendingLookup::shared(lookup)
+    }
+
+    /// Resolve `host` and pair the first address with `port`
+    pub fn resolve_socket_addr(&self, host: &str, port: u16) -> IoResult<SocketAddr> {
+        let addresses = self.resolve(host)?;
+        Ok(SocketAddr::new(addresses[0], port))
+    }
+
+    /// Drop every cached result; lookups in flight still complete
+    pub fn clear(&self) {
+        self.shared.cache.lock().unwrap_or_else(|poisoned| poisoned.into_inner()).clear();
+    }
+
+    /// Number of cached host names, including lookups in flight
+    pub fn cached_hosts(&self) -> usize {
+        self.shared.cache.lock().unwrap_or_else(|poisoned| poisoned.into_inner()).len()
+    }
+
+    /// Snapshot of the counters
+    pub fn stats(&self) -> ResolverStats {
+        ResolverStats {
+            hits: self.shared.hits.load(Ordering::Relaxed),
+            coalesced: self.shared.coalesced.load(Ordering::Relaxed),
+            lookups: self.shared.lookups.load(Ordering::Relaxed),
+        }
+    }
+}
+
+impl Drop for Resolver {
+    fn drop(&mut self) {
+        // Resolver threads exit once they finish their current lookup
+        self.shared.shutdown.store(true, Ordering::Release);
+        self.shared.job_ready.notify_all();
+    }
+}
+
+impl std::fmt::Debug for Resolver {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("Resolver")
+            .field("config", &self.shared.config)
+            .field("stats", &self.stats())
+            .finish()
+    }
+}
+
+/// Lookup started by `Resolver::resolve_async`
+#[derive(Clone)]
+pub struct PendingLookup {
+    lookup: Arc<Lookup>,
+}
+
+impl PendingLookup {
+    fn ready(host: &str, result: LookupResult) -> Self {
+        Self {
+            lookup: Arc::new(Lookup {
+                host: host.to_string(),
+                outcome: Mutex::new(Some((result, Instant::now()))),
+                done: Condvar::new(),
+            }),
+        }
+    }
+
+    fn shared(lookup: Arc<Lookup>) -> Self {
+        Self { lookup }
+    }
+
+    /// Host being resolved
+    pub fn host(&self) -> &str {
+        &self.lookup.host
+    }
+
+    /// Check whether the result is available
+    pub fn is_ready(&self) -> bool {
+        self.lookup.lock().is_some()
+    }
+
+    /// Wait for the result
+    pub fn wait(&self) -> IoResult<Addresses> {
+        self.wait_timeout(None).unwrap_or_else(|| Err(IoError::Timeout { timeout_ms: 0 }))
+    }
+
+    /// Wait up to `timeout` (`None` waits indefinitely); `None` on timeout
+    pub fn wait_timeout(&self, timeout: Option<Duration>) -> Option<IoResult<Addresses>> {
+        let result = self.lookup.wait(timeout)?;
+        Some(result.map_err(|message| IoError::NetworkOperationFailed {
+            endpoint: self.lookup.host.clone(),
+            message,
+        }))
+    }
+}
+
+impl std::fmt::Debug for PendingLookup {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("PendingLookup")
+            .field("host", &self.lookup.host)
+            .field("ready", &self.is_ready())
+            .finish()
+    }
+}
+
+/// Resolve `host` with the global resolver
+pub fn resolve(host: &str) -> IoResult<Addresses> {
+    Resolver::global().resolve(host)
+}
+
+/// Resolve `host:port` to its first address with the global resolver
+pub fn resolve_socket_addr(host: &str, port: u16) -> IoResult<SocketAddr> {
+    Resolver::global().resolve_socket_addr(host, port)
+}
+
+/// Blocking lookup through `getaddrinfo`, keeping each address once
+fn system_lookup(host: &str) -> io::Result<Vec<IpAddr>> {
+    let mut addresses: Vec<IpAddr> = Vec::new();
+    for address in (host, 0).to_socket_addrs()? {
+        if !addresses.contains(&address.ip()) {
+            addresses.push(address.ip());
+        }
+    }
+    Ok(addresses)
+}
+
+fn strip_brackets(host: &str) -> &str {
+    host.strip_prefix('[').and_then(|host| host.strip_suffix(']')).unwrap_or(host)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::net::Ipv4Addr;
+    use std::sync::atomic::AtomicUsize;
+
+    static 查询次数: AtomicUsize = AtomicUsize::new(0);
+
+    /// Slow fake resolver: `*.test` resolves, everything else fails
+    fn 模拟查询(host: &str) -> io::Result<Vec<IpAddr>> {
+        查询次数.fetch_add(1, Ordering::SeqCst);
+        std::thread::sleep(Duration::from_millis(50));
+        match host.strip_suffix(".test") {
+            Some(name) => Ok(vec![IpAddr::V4(Ipv4Addr::new(10, 0, 0, name.len() as u8))]),
+            None => Err(io::Error::new(io::ErrorKind::NotFound, "no such host")),
+        }
+    }
+
+    fn 模拟解析器(ttl: Duration) -> Resolver {
+        let config = ResolverConfig {
+            positive_ttl: ttl,
+            negative_ttl: ttl,
+            max_entries: 4,
+            threads: 2,
+        };
+        Resolver::with_lookup(config, 模拟查询)
+    }
+
+    #[test]
+    fn test_cache_coalescing_and_expiry() {
+        let resolver = 模拟解析器(Duration::from_millis(300));
+
+        // 16 concurrent callers share one lookup
+        std::thread::scope(|scope| {
+            for _ in 0..16 {
+                scope.spawn(|| {
+                    let addresses = resolver.resolve("abc.TEST").unwrap();
+                    assert_eq!(&addresses[..], &[IpAddr::V4(Ipv4Addr::new(10, 0, 0, 3))]);
+                });
+            }
+        });
+        let stats = resolver.stats();
+        assert_eq!(stats.lookups, 1);
+        assert_eq!(stats.hits + stats.coalesced, 15);
+
+        // Fresh entries are served without a lookup
+        let started = Instant::now();
+        assert!(resolver.resolve("abc.test").is_ok());
+        assert!(started.elapsed() < Duration::from_millis(40));
+        assert_eq!(resolver.stats().lookups, 1);
+
+        // Failures are cached too
+        assert!(resolver.resolve("missing.example").is_err());
+        assert!(resolver.resolve("missing.example").is_err());
+        assert_eq!(resolver.stats().lookups, 2);
+
+        // Expired entries are looked up again
+        std::thread::sleep(Duration::from_millis(350));
+        assert!(resolver.resolve("abc.test").is_ok());
+        assert!(resolver.resolve("missing.example").is_err());
+        assert_eq!(resolver.stats().lookups, 4);
+
+        // Literals never reach the resolver
+        let addresses = resolver.resolve("[::1]").unwrap();
+        assert_eq!(addresses[0], "::1".parse::<IpAddr>().unwrap());
+        assert_eq!(resolver.resolve_socket_addr("127.0.0.1", 80).unwrap().port(), 80);
+        assert_eq!(resolver.stats().lookups, 4);
+    }
+
+    #[test]
+    fn test_async_lookup_and_eviction() {
+        let resolver = 模拟解析器(Duration::from_secs(60));
+
+        let pending = resolver.resolve_async("async.test");
+        assert!(!pending.is_ready());
+        assert!(pending.wait_timeout(Some(Duration::ZERO)).is_none());
+        let addresses = pending.wait_timeout(Some(Duration::from_secs(5))).unwrap().unwrap();
+        assert_eq!(addresses[0], IpAddr::V4(Ipv4Addr::new(10, 0, 0, 5)));
+        assert!(pending.is_ready());
+
+        // The cache never grows past max_entries
+        for name in ["a.test", "b.test", "c.test", "d.test", "e.test"] {
+            resolver.resolve(name).unwrap();
+        }
+        assert!(resolver.cached_hosts() <= 4);
+
+        resolver.clear();
+        assert_eq!(resolver.cached_hosts(), 0);
+    }
+
+    #[test]
+    fn test_lookup_fails_without_resolver_threads() {
+        let mut resolver = 模拟解析器(Duration::from_secs(60));
+        resolver.spawn_error = Some("无法启动解析线程".to_string());
+
+        let pending = resolver.resolve_async("nobody.test");
+        assert!(pending.is_ready());
+        assert!(pending.wait().is_err());
+        assert!(resolver.resolve("127.0.0.1").is_ok());
+        assert_eq!(resolver.stats().lookups, 0);
+    }
+
+    #[test]
+    fn test_system_resolver() {
+        let addresses = resolve("localhost").unwrap();
+        assert!(addresses.iter().all(|address| address.is_loopback()));
+        assert!(Resolver::global().stats().lookups >= 1);
+        assert!(resolve("localhost").is_ok());
+    }
+}
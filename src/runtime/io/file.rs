@@ -3,6 +3,11 @@
 //! 提供文件读写、创建、删除等操作
 
 use crate::runtime::stdlib::{StdlibResult, StdlibValue, StdlibError};
+use super::mapped::MappedFile;
+use super::scanner::{byte_lines, InputScanner};
+use super::transfer::{copy_file, Appender};
+use super::walker::{walk, WalkOptions};
+use super::IoError;
 use std::fs;
 use std::path::Path;
 
@@ -51,6 +56,146 @@ impl From<std::io::Error> for IO错误 {
     }
 }
 
+impl From<IoError> for IO错误 {
+    fn from(err: IoError) -> Self {
+        match err {
+            IoError::SystemIoError(e) => IO错误::from(e),
+            other => IO错误::读取错误(other.to_string()),
+        }
+    }
+}
+
+/// 只读文件视图
+///
+/// 常规文件通过 mmap 映射后直接借用，不复制到堆上；管道或 `/proc`
+/// 等无法映射的文件读入内存。
+///
+/// 映射反映的是文件本身而不是快照：视图存活期间文件被其他进程修改，
+/// 借出的字节会随之改变，访问被截掉的部分会触发 SIGBUS。因此视图只借出
+/// 字节，每次取文本时重新验证 UTF-8，不在打开时验证一次后假定它不变。
+/// 需要与文件脱钩的内容时请用 `读取`。
+#[derive(Debug)]
+pub struct 文件视图 {
+    内容: 视图内容,
+}
+
+#[derive(Debug)]
+enum 视图内容 {
+    映射(MappedFile),
+    内存(Vec<u8>),
+}
+
+impl 文件视图 {
+    /// 打开文件视图
+    pub fn 打开(路径: impl AsRef<Path>) -> Result<Self, IO错误> {
+        let 路径 = 路径.as_ref();
+        if let Some(映射) = MappedFile::open(路径)? {
+            if !映射.is_empty() {
+                return Ok(Self { 内容: 视图内容::映射(映射) });
+            }
+        }
+
+        Ok(Self { 内容: 视图内容::内存(fs::read(路径)?) })
+    }
+
+    /// 借用的原始字节
+    pub fn 字节(&self) -> &[u8] {
+        match &self.内容 {
+            视图内容::映射(映射) => 映射.as_bytes(),
+            视图内容::内存(字节) => 字节,
+        }
+    }
+
+    /// 借用的文本内容，每次调用时验证 UTF-8
+    pub fn 文本(&self) -> Result<&str, IO错误> {
+        std::str::from_utf8(self.字节())
+            .map_err(|e| IO错误::读取错误(format!("文件不是有效的UTF-8: {}", e)))
+    }
+
+    /// 字节长度
+    pub fn 长度(&self) -> usize {
+        self.字节().len()
+    }
+
+    /// 是否由 mmap 映射提供
+    pub fn 是否映射(&self) -> bool {
+        matches!(self.内容, 视图内容::映射(_))
+    }
+
+    /// 按行借用原始字节（去掉行尾的 `\n` / `\r\n`）
+    pub fn 行(&self) -> impl Iterator<Item = &[u8]> {
+        byte_lines(self.字节())
+    }
+}
+
+/// 流式逐行读取器
+///
+/// 每次返回的行借用自内部缓冲区（或映射），下一次读取前有效，
+/// 读取过程中不按行分配内存。
+#[derive(Debug)]
+pub struct 行读取器 {
+    扫描器: InputScanner<fs::File>,
+}
+
+impl 行读取器 {
+    /// 打开文件进行逐行读取
+    pub fn 打开(路径: impl AsRef<Path>) -> Result<Self, IO错误> {
+        Ok(Self { 扫描器: InputScanner::open(路径)? })
+    }
+
+    /// 读取下一行原始字节，文件结束时返回 `None`
+    pub fn 下一行字节(&mut self) -> Result<Option<&[u8]>, IO错误> {
+        Ok(self.扫描器.next_line()?)
+    }
+
+    /// 读取下一行文本，文件结束时返回 `None`
+    pub fn 下一行(&mut self) -> Result<Option<&str>, IO错误> {
+        match self.扫描器.next_line()? {
+            Some(行) => std::str::from_utf8(行)
+                .map(Some)
+                .map_err(|e| IO错误::读取错误(format!("行不是有效的UTF-8: {}", e))),
+            None => Ok(None),
+        }
+    }
+}
+
+/// 持久追加器
+///
+/// 保持文件打开，多次追加合并为一次向量写入。持久模式下每次追加在数据
+/// 落盘后才返回，多个并发追加共享一次 fdatasync（组提交）。
+#[derive(Debug)]
+pub struct 追加器 {
+    内部: Appender,
+    持久: bool,
+}
+
+impl 追加器 {
+    /// 打开文件进行追加（不存在则创建）
+    pub fn 打开(路径: impl AsRef<Path>, 持久: bool) -> Result<Self, IO错误> {
+        Ok(Self { 内部: Appender::open(路径)?, 持久 })
+    }
+
+    /// 追加内容
+    pub fn 追加(&self, 内容: impl Into<Vec<u8>>) -> Result<(), IO错误> {
+        let 结果 = if self.持久 {
+            self.内部.append_durable(内容)
+        } else {
+            self.内部.append(内容)
+        };
+        结果.map_err(|e| IO错误::写入错误(e.to_string()))
+    }
+
+    /// 将缓冲的追加写入文件
+    pub fn 刷新(&self) -> Result<(), IO错误> {
+        self.内部.flush().map_err(|e| IO错误::写入错误(e.to_string()))
+    }
+
+    /// 将已追加的内容同步到磁盘
+    pub fn 同步(&self) -> Result<(), IO错误> {
+        self.内部.sync().map_err(|e| IO错误::写入错误(e.to_string()))
+    }
+}
+
 /// 文件操作枚举
 #[derive(Debug, Clone, PartialEq)]
 pub enum 文件操作 {
@@ -74,6 +219,10 @@ pub enum 文件操作 {
     删除目录,
     /// 列出目录内容
     列出目录,
+    /// 复制文件（内核内复制，不经过字符串）
+    复制,
+    /// 并行递归遍历目录
+    遍历目录,
 }
 
 /// 文件模块
@@ -85,6 +234,21 @@ impl 文件模块 {
         Self
     }
 
+    /// 以只读视图方式读取文件（常规文件使用 mmap，不复制内容）
+    pub fn 映射读取(&self, 路径: &str) -> StdlibResult<文件视图> {
+        Ok(文件视图::打开(路径)?)
+    }
+
+    /// 打开文件进行流式逐行读取
+    pub fn 逐行读取(&self, 路径: &str) -> StdlibResult<行读取器> {
+        Ok(行读取器::打开(路径)?)
+    }
+
+    /// 打开持久追加器
+    pub fn 打开追加器(&self, 路径: &str, 持久: bool) -> StdlibResult<追加器> {
+        Ok(追加器::打开(路径, 持久)?)
+    }
+
     /// 执行文件操作
     pub fn 执行操作(&self, 操作: 文件操作, 参数: &[StdlibValue]) -> StdlibResult<StdlibValue> {
         match 操作 {
@@ -98,6 +262,8 @@ impl 文件模块 {
             文件操作::创建目录 => self.创建目录(参数),
             文件操作::删除目录 => self.删除目录(参数),
             文件操作::列出目录 => self.列出目录内容(参数),
+            文件操作::复制 => self.复制文件(参数),
+            文件操作::遍历目录 => self.遍历目录(参数),
         }
     }
 
@@ -159,6 +325,24 @@ impl 文件模块 {
         Ok(StdlibValue::Boolean(true))
     }
 
+    /// 复制文件，返回复制的字节数
+    fn 复制文件(&self, 参数: &[StdlibValue]) -> StdlibResult<StdlibValue> {
+        if 参数.len() != 2 {
+            return Err(IO错误::通用错误("复制文件需要2个参数：源路径、目标路径".to_string()).into());
+        }
+
+        let 源路径 = 参数[0].as_string()
+            .ok_or_else(|| IO错误::无效路径("源路径必须是字符串".to_string()))?;
+
+        let 目标路径 = 参数[1].as_string()
+            .ok_or_else(|| IO错误::无效路径("目标路径必须是字符串".to_string()))?;
+
+        let 字节数 = copy_file(&源路径, &目标路径)
+            .map_err(IO错误::from)?;
+
+        Ok(StdlibValue::Integer(字节数 as i64))
+    }
+
     /// 删除文件
     fn 删除文件(&self, 参数: &[StdlibValue]) -> StdlibResult<StdlibValue> {
         if 参数.len() != 1 {
@@ -247,6 +431,39 @@ impl 文件模块 {
         Ok(StdlibValue::Boolean(true))
     }
 
+    /// 并行递归遍历目录
+    ///
+    /// 参数：目录路径，可选的包含通配符（如 `**/*.qi`，空字符串表示全部），
+    /// 可选的最大深度（0 表示不限）。返回排序后的文件路径数组。
+    fn 遍历目录(&self, 参数: &[StdlibValue]) -> StdlibResult<StdlibValue> {
+        if 参数.is_empty() || 参数.len() > 3 {
+            return Err(IO错误::通用错误("遍历目录需要1到3个参数：目录路径、通配符、最大深度".to_string()).into());
+        }
+
+        let 路径 = 参数[0].as_string()
+            .ok_or_else(|| IO错误::无效路径("目录路径必须是字符串".to_string()))?;
+
+        let mut 选项 = WalkOptions::new();
+        if let Some(StdlibValue::String(模式)) = 参数.get(1) {
+            if !模式.is_empty() {
+                选项 = 选项.with_include(模式).map_err(IO错误::from)?;
+            }
+        }
+        if let Some(StdlibValue::Integer(深度)) = 参数.get(2) {
+            if *深度 > 0 {
+                选项 = 选项.with_max_depth(*深度 as usize);
+            }
+        }
+
+        let 条目 = walk(&路径, &选项)
+            .map_err(IO错误::from)?
+            .into_iter()
+            .map(|entry| StdlibValue::String(entry.path.to_string_lossy().to_string()))
+            .collect();
+
+        Ok(StdlibValue::Array(条目))
+    }
+
     /// 列出目录内容
     fn 列出目录内容(&self, 参数: &[StdlibValue]) -> StdlibResult<StdlibValue> {
         if 参数.len() != 1 {
@@ -300,6 +517,91 @@ mod tests {
         let _ = fs::remove_file(测试文件);
     }
 
+    #[test]
+    fn test_mapped_view_and_line_reader() {
+        let 模块 = 文件模块::创建();
+        let 测试文件 = "/tmp/test_qi_view_lines.txt";
+        fs::write(测试文件, "第一行\r\n第二行\n\n最后").unwrap();
+
+        let 视图 = 模块.映射读取(测试文件).unwrap();
+        assert_eq!(视图.文本().unwrap(), "第一行\r\n第二行\n\n最后");
+        let 行列表: Vec<&[u8]> = 视图.行().collect();
+        assert_eq!(行列表, vec!["第一行".as_bytes(), "第二行".as_bytes(), b"", "最后".as_bytes()]);
+
+        let mut 读取器 = 模块.逐行读取(测试文件).unwrap();
+        let mut 行列表 = Vec::new();
+        while let Some(行) = 读取器.下一行().unwrap() {
+            行列表.push(行.to_string());
+        }
+        assert_eq!(行列表, vec!["第一行", "第二行", "", "最后"]);
+
+        assert!(模块.映射读取("/tmp/不存在的文件_qi.txt").is_err());
+
+        // 非 UTF-8 文件仍可按字节借用，取文本时报错
+        fs::write(测试文件, b"\xff\xfe").unwrap();
+        let 视图 = 模块.映射读取(测试文件).unwrap();
+        assert_eq!(视图.字节(), b"\xff\xfe");
+        assert!(视图.文本().is_err());
+
+        let _ = fs::remove_file(测试文件);
+    }
+
+    #[test]
+    fn test_copy_and_appender() {
+        let 模块 = 文件模块::创建();
+        let 源文件 = "/tmp/test_qi_copy_src.txt";
+        let 目标文件 = "/tmp/test_qi_copy_dst.txt";
+        fs::write(源文件, "复制的内容").unwrap();
+
+        let 参数 = vec![
+            StdlibValue::String(源文件.to_string()),
+            StdlibValue::String(目标文件.to_string()),
+        ];
+        let 结果 = 模块.执行操作(文件操作::复制, &参数).unwrap();
+        assert!(matches!(结果, StdlibValue::Integer(15)));
+        assert_eq!(fs::read_to_string(目标文件).unwrap(), "复制的内容");
+
+        let 追加 = 模块.打开追加器(目标文件, true).unwrap();
+        追加.追加("，追加一").unwrap();
+        assert_eq!(fs::read_to_string(目标文件).unwrap(), "复制的内容，追加一");
+
+        let 追加 = 模块.打开追加器(目标文件, false).unwrap();
+        追加.追加("，追加二").unwrap();
+        追加.刷新().unwrap();
+        assert_eq!(fs::read_to_string(目标文件).unwrap(), "复制的内容，追加一，追加二");
+
+        let _ = fs::remove_file(源文件);
+        let _ = fs::remove_file(目标文件);
+    }
+
+    #[test]
+    fn test_walk_directory() {
+        let 模块 = 文件模块::创建();
+        let 根目录 = "/tmp/test_qi_walk_dir";
+        let _ = fs::remove_dir_all(根目录);
+        fs::create_dir_all(format!("{}/子目录", 根目录)).unwrap();
+        fs::write(format!("{}/主.qi", 根目录), "").unwrap();
+        fs::write(format!("{}/子目录/模块.qi", 根目录), "").unwrap();
+        fs::write(format!("{}/子目录/说明.txt", 根目录), "").unwrap();
+
+        let 参数 = vec![
+            StdlibValue::String(根目录.to_string()),
+            StdlibValue::String("**/*.qi".to_string()),
+        ];
+        match 模块.执行操作(文件操作::遍历目录, &参数).unwrap() {
+            StdlibValue::Array(条目) => {
+                let 路径: Vec<_> = 条目.iter().filter_map(|v| v.as_string()).collect();
+                assert_eq!(路径, vec![
+                    format!("{}/主.qi", 根目录),
+                    format!("{}/子目录/模块.qi", 根目录),
+                ]);
+            }
+            其他 => panic!("遍历目录应返回数组: {:?}", 其他),
+        }
+
+        let _ = fs::remove_dir_all(根目录);
+    }
+
     #[test]
     fn test_file_exists() {
         let 模块 = 文件模块::创建();
@@ -7,6 +7,8 @@ use std::path::{Path, PathBuf};
 use std::fs::{File, OpenOptions};
 use std::io::{Read, Write, BufReader, BufWriter};
 use super::{IoResult, IoError, IoStatistics};
+use super::metrics::{IoCounters, IoOpKind, IoMetricsSnapshot};
+use super::walker::{self, WalkEntry, WalkOptions};
 use std::time::{Duration, Instant};
 
 /// File character encoding
@@ -117,7 +119,7 @@ pub struct FileSystemInterface {
     /// Default buffer size for file operations
     default_buffer_size: usize,
     /// I/O statistics
-    statistics: std::sync::Mutex<IoStatistics>,
+    statistics: IoCounters,
     /// Default timeout for operations
     default_timeout: Option<Duration>,
 }
@@ -127,15 +129,14 @@ impl FileSystemInterface {
     pub fn new(buffer_size: usize) -> IoResult<Self> {
         Ok(Self {
             default_buffer_size: buffer_size,
-            statistics: std::sync::Mutex::new(IoStatistics::new()),
+            statistics: IoCounters::new(),
             default_timeout: Some(Duration::from_secs(30)),
         })
     }
 
     /// Initialize the file system interface
     pub fn initialize(&mut self) -> IoResult<()> {
-        let mut stats = self.statistics.lock().unwrap();
-        stats.reset();
+        self.statistics.reset();
         Ok(())
     }
 
@@ -147,17 +148,8 @@ impl FileSystemInterface {
 
         let result = self.read_file_string_impl(&operation);
 
-        match &result {
-            Ok(content) => {
-                let elapsed = start_time.elapsed();
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_read(content.len() as u64, elapsed.as_millis() as f64);
-            }
-            Err(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_failure();
-            }
-        }
+        let bytes = result.as_ref().map_or(0, |content| content.len() as u64);
+        self.statistics.record_result(IoOpKind::FileRead, &result, bytes, start_time.elapsed());
 
         result
     }
@@ -170,17 +162,7 @@ impl FileSystemInterface {
 
         let result = self.write_file_string_impl(&operation, content);
 
-        match &result {
-            Ok(()) => {
-                let elapsed = start_time.elapsed();
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_write(content.len() as u64, elapsed.as_millis() as f64);
-            }
-            Err(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_failure();
-            }
-        }
+        self.statistics.record_result(IoOpKind::FileWrite, &result, content.len() as u64, start_time.elapsed());
 
         result
     }
@@ -193,17 +175,7 @@ impl FileSystemInterface {
 
         let result = self.append_file_string_impl(&operation, content);
 
-        match &result {
-            Ok(()) => {
-                let elapsed = start_time.elapsed();
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_write(content.len() as u64, elapsed.as_millis() as f64);
-            }
-            Err(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_failure();
-            }
-        }
+        self.statistics.record_result(IoOpKind::FileAppend, &result, content.len() as u64, start_time.elapsed());
 
         result
     }
@@ -285,15 +257,28 @@ impl FileSystemInterface {
         }
     }
 
+    /// Recursively list `path` in parallel
+    ///
+    /// Unlike calling `list_directory` per level, entry kinds come from the
+    /// directory listing itself, so no entry is stat'ed. Results are sorted
+    /// by path; use `walker::walk_channel` to stream them instead.
+    pub fn walk_directory<P: AsRef<Path>>(&self, path: P, options: &WalkOptions) -> IoResult<Vec<WalkEntry>> {
+        walker::walk(path, options)
+    }
+
     /// Get file system statistics
     pub fn get_statistics(&self) -> IoStatistics {
-        self.statistics.lock().unwrap().clone()
+        self.statistics.snapshot().to_statistics()
+    }
+
+    /// Get per-operation counters and latency histograms
+    pub fn io_metrics(&self) -> IoMetricsSnapshot {
+        self.statistics.snapshot()
     }
 
     /// Reset statistics
     pub fn reset_statistics(&mut self) {
-        let mut stats = self.statistics.lock().unwrap();
-        stats.reset();
+        self.statistics.reset();
     }
 
     /// Cleanup resources
@@ -508,11 +493,8 @@ mod tests {
         assert_eq!(stats.success_rate(), 1.0);
 
         // Simulate some operations
-        {
-            let mut stats = fs.statistics.lock().unwrap();
-            stats.record_read(1024, 10.5);
-            stats.record_write(512, 5.0);
-        }
+        fs.statistics.record(IoOpKind::FileRead, 1024, Duration::from_micros(10_500));
+        fs.statistics.record(IoOpKind::FileWrite, 512, Duration::from_millis(5));
 
         let updated_stats = fs.get_statistics();
         assert_eq!(updated_stats.total_operations(), 2);
@@ -0,0 +1,458 @@
+//! File Handle Table
+//!
+//! Handle-based file access for the runtime FFI. Open files live in a
+//! `HandleSlab`, so a call locks only its own file and stale handles are
+//! rejected by generation.
+//!
+//! Every open file keeps its own `BufReader`/`BufWriter` sized from
+//! `FileOperation::buffer_size`. Positional reads and writes go through a
+//! duplicated descriptor outside the slot lock, so several threads can
+//! `pread` one file in parallel.
+
+use std::fs::{File, OpenOptions};
+use std::io::{self, BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::sync::{Arc, OnceLock};
+
+use super::filesystem::{FileOperation, FileOperationType};
+use super::slab::{Handle, HandleSlab};
+use super::{IoError, IoResult};
+
+/// Opaque file handle issued by `FileHandleTable`
+pub type FileHandle = Handle;
+
+/// Buffered stream state; switching between reading and writing flushes or
+/// discards the buffer so the file position stays consistent
+enum Stream {
+    Reader(BufReader<File>),
+    Writer(BufWriter<File>),
+    /// Placeholder while switching modes, or after a failed switch
+    Broken,
+}
+
+struct OpenFile {
+    stream: Stream,
+    /// Duplicate descriptor for positional I/O outside the slot lock
+    positional: Arc<File>,
+    buffer_size: usize,
+    /// Whether the last sequential read hit end of file
+    eof: bool,
+}
+
+impl OpenFile {
+    fn reader(&mut self) -> io::Result<&mut BufReader<File>> {
+        if let Stream::Writer(_) = self.stream {
+            let Stream::Writer(mut writer) = std::mem::replace(&mut self.stream, Stream::Broken) else {
+                unreachable!();
+            };
+            writer.flush()?;
+            let file = writer.into_inner().map_err(|e| e.into_error())?;
+            self.stream = Stream::Reader(BufReader::with_capacity(self.buffer_size, file));
+        }
+        match &mut self.stream {
+            Stream::Reader(reader) => Ok(reader),
+            _ => Err(broken_stream()),
+        }
+    }
+
+    fn writer(&mut self) -> io::Result<&mut BufWriter<File>> {
+        if let Stream::Reader(reader) = &mut self.stream {
+            // Step the file position back over read-ahead that was not consumed
+            reader.seek(SeekFrom::Current(0))?;
+            let Stream::Reader(reader) = std::mem::replace(&mut self.stream, Stream::Broken) else {
+                unreachable!();
+            };
+            self.stream = Stream::Writer(BufWriter::with_capacity(self.buffer_size, reader.into_inner()));
+        }
+        match &mut self.stream {
+            Stream::Writer(writer) => Ok(writer),
+            _ => Err(broken_stream()),
+        }
+    }
+
+    /// Make the file contents match what positional I/O will see
+    fn sync_for_positional(&mut self) -> io::Result<()> {
+        match &mut self.stream {
+            Stream::Writer(writer) => writer.flush(),
+            // Drop read-ahead so later sequential reads observe positional writes
+            Stream::Reader(reader) => reader.seek(SeekFrom::Current(0)).map(|_| ()),
+            Stream::Broken => Err(broken_stream()),
+        }
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        match &mut self.stream {
+            Stream::Writer(writer) => writer.flush(),
+            _ => Ok(()),
+        }
+    }
+}
+
+fn broken_stream() -> io::Error {
+    io::Error::new(io::ErrorKind::Other, "文件流在切换读写模式时失败")
+}
+
+/// Open files addressed by generation-checked handles
+pub struct FileHandleTable {
+    files: HandleSlab<OpenFile>,
+}
+
+impl FileHandleTable {
+    /// Create an empty table
+    pub fn new() -> Self {
+        Self { files: HandleSlab::new() }
+    }
+
+    /// Process-wide table used by the runtime FFI
+    pub fn global() -> &'static FileHandleTable {
+        static TABLE: OnceLock<FileHandleTable> = OnceLock::new();
+        TABLE.get_or_init(FileHandleTable::new)
+    }
+
+    /// Open a file according to `operation` and return its handle
+    ///
+    /// Read operations open read-only, `Write`/`Create` truncate and
+    /// `Append` appends. With `update` set, write modes may also read and
+    /// read mode may also write. The buffer size comes from
+    /// `FileOperation::with_buffer_size`.
+    pub fn open(&self, operation: &FileOperation, update: bool) -> IoResult<FileHandle> {
+        let mut options = OpenOptions::new();
+        match operation.operation_type {
+            FileOperationType::Read | FileOperationType::ReadMetadata => {
+                options.read(true).write(update);
+            }
+            FileOperationType::Write | FileOperationType::Create => {
+                options.write(true).create(true).truncate(true).read(update);
+            }
+            FileOperationType::Append => {
+                options.append(true).create(true).read(update);
+            }
+            FileOperationType::Delete => {
+                return Err(IoError::FileOperationFailed {
+                    path: operation.path.to_string_lossy().to_string(),
+                    message: "删除操作不能打开文件句柄".to_string(),
+                });
+            }
+        }
+
+        let open_error = |e: io::Error| IoError::FileOperationFailed {
+            path: operation.path.to_string_lossy().to_string(),
+            message: format!("打开文件失败: {}", e),
+        };
+        let file = options.open(&operation.path).map_err(open_error)?;
+        let positional = Arc::new(file.try_clone().map_err(open_error)?);
+
+        let buffer_size = operation.buffer_size.max(1);
+        let stream = if operation.operation_type == FileOperationType::Read
+            || operation.operation_type == FileOperationType::ReadMetadata
+        {
+            Stream::Reader(BufReader::with_capacity(buffer_size, file))
+        } else {
+            Stream::Writer(BufWriter::with_capacity(buffer_size, file))
+        };
+
+        let file = OpenFile { stream, positional, buffer_size, eof: false };
+        self.files.insert(file).ok_or_else(|| IoError::FileOperationFailed {
+            path: operation.path.to_string_lossy().to_string(),
+            message: "打开的文件句柄过多".to_string(),
+        })
+    }
+
+    /// Read up to `buffer.len()` bytes; `Ok(0)` at end of file
+    pub fn read(&self, handle: FileHandle, buffer: &mut [u8]) -> IoResult<usize> {
+        self.with_file(handle, |file| {
+            let count = file.reader()?.read(buffer)?;
+            file.eof = count == 0 && !buffer.is_empty();
+            Ok(count)
+        })
+    }
+
+    /// Write all of `data` into the handle's buffer
+    pub fn write(&self, handle: FileHandle, data: &[u8]) -> IoResult<usize> {
+        self.with_file(handle, |file| {
+            file.writer()?.write_all(data)?;
+            Ok(data.len())
+        })
+    }
+
+    /// Read a little-endian `i64`; `Ok(None)` if fewer than 8 bytes remain
+    pub fn read_i64(&self, handle: FileHandle) -> IoResult<Option<i64>> {
+        let mut bytes = [0u8; 8];
+        self.read_exact_or_eof(handle, &mut bytes)
+            .map(|complete| complete.then(|| i64::from_le_bytes(bytes)))
+    }
+
+    /// Write a little-endian `i64`
+    pub fn write_i64(&self, handle: FileHandle, value: i64) -> IoResult<()> {
+        self.write(handle, &value.to_le_bytes()).map(|_| ())
+    }
+
+    /// Read one byte; `Ok(None)` at end of file
+    pub fn read_u8(&self, handle: FileHandle) -> IoResult<Option<u8>> {
+        let mut byte = [0u8; 1];
+        self.read_exact_or_eof(handle, &mut byte).map(|complete| complete.then(|| byte[0]))
+    }
+
+    /// Write one byte
+    pub fn write_u8(&self, handle: FileHandle, value: u8) -> IoResult<()> {
+        self.write(handle, &[value]).map(|_| ())
+    }
+
+    /// Fill `buffer` completely or consume nothing
+    ///
+    /// A value cut short by end of file (or a read error) is unread again,
+    /// so the caller can retry once the file has grown or read the tail
+    /// byte by byte.
+    fn read_exact_or_eof(&self, handle: FileHandle, buffer: &mut [u8]) -> IoResult<bool> {
+        self.with_file(handle, |file| {
+            let reader = file.reader()?;
+            let mut filled = 0;
+            let mut error = None;
+            while filled < buffer.len() {
+                match reader.read(&mut buffer[filled..]) {
+                    Ok(0) => break,
+                    Ok(count) => filled += count,
+                    Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                    Err(e) => {
+                        error = Some(e);
+                        break;
+                    }
+                }
+            }
+            if filled > 0 && filled < buffer.len() {
+                reader.seek_relative(-(filled as i64))?;
+            }
+            if let Some(e) = error {
+                return Err(e);
+            }
+            file.eof = filled < buffer.len();
+            Ok(!file.eof)
+        })
+    }
+
+    /// Whether the last sequential read on the handle reached end of file
+    pub fn is_eof(&self, handle: FileHandle) -> IoResult<bool> {
+        self.with_file(handle, |file| Ok(file.eof))
+    }
+
+    /// Read at `offset` without moving the sequential position
+    ///
+    /// Only the buffered state is synchronized under the slot lock; the read
+    /// itself runs unlocked, so concurrent positional reads do not serialize.
+    pub fn read_at(&self, handle: FileHandle, buffer: &mut [u8], offset: u64) -> IoResult<usize> {
+        let file = self.positional(handle)?;
+        Ok(read_at(&file, buffer, offset)?)
+    }
+
+    /// Write at `offset` without moving the sequential position
+    pub fn write_at(&self, handle: FileHandle, data: &[u8], offset: u64) -> IoResult<usize> {
+        let file = self.positional(handle)?;
+        let mut written = 0;
+        while written < data.len() {
+            match write_at(&file, &data[written..], offset + written as u64) {
+                Ok(0) => return Err(io::Error::from(io::ErrorKind::WriteZero).into()),
+                Ok(count) => written += count,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                Err(e) => return Err(e.into()),
+            }
+        }
+        Ok(written)
+    }
+
+    /// Flush buffered writes to the operating system
+    pub fn flush(&self, handle: FileHandle) -> IoResult<()> {
+        self.with_file(handle, |file| file.flush())
+    }
+
+    /// Flush and close the handle; the handle is invalid afterwards
+    pub fn close(&self, handle: FileHandle) -> IoResult<()> {
+        let mut file = self.files.remove(handle).ok_or_else(|| invalid_handle(handle))?;
+        file.flush()?;
+        Ok(())
+    }
+
+    fn positional(&self, handle: FileHandle) -> IoResult<Arc<File>> {
+        self.with_file(handle, |file| {
+            file.sync_for_positional()?;
+            Ok(Arc::clone(&file.positional))
+        })
+    }
+
+    fn with_file<T>(
+        &self,
+        handle: FileHandle,
+        operation: impl FnOnce(&mut OpenFile) -> io::Result<T>,
+    ) -> IoResult<T> {
+        match self.files.with(handle, operation) {
+            Some(result) => Ok(result?),
+            None => Err(invalid_handle(handle)),
+        }
+    }
+}
+
+impl Default for FileHandleTable {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl std::fmt::Debug for FileHandleTable {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("FileHandleTable")
+            .field("files", &self.files)
+            .finish()
+    }
+}
+
+fn invalid_handle(handle: FileHandle) -> IoError {
+    IoError::ResourceNotFound { resource: format!("文件句柄 {}", handle) }
+}
+
+#[cfg(unix)]
+fn read_at(file: &File, buffer: &mut [u8], offset: u64) -> io::Result<usize> {
+    std::os::unix::fs::FileExt::read_at(file, buffer, offset)
+}
+
+#[cfg(unix)]
+fn write_at(file: &File, data: &[u8], offset: u64) -> io::Result<usize> {
+    std::os::unix::fs::FileExt::write_at(file, data, offset)
+}
+
+#[cfg(windows)]
+fn read_at(file: &File, buffer: &mut [u8], offset: u64) -> io::Result<usize> {
+    std::os::windows::fs::FileExt::seek_read(file, buffer, offset)
+}
+
+#[cfg(windows)]
+fn write_at(file: &File, data: &[u8], offset: u64) -> io::Result<usize> {
+    std::os::windows::fs::FileExt::seek_write(file, data, offset)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn temp_path(name: &str) -> std::path::PathBuf {
+        std::env::temp_dir().join(format!("qi_handles_{}_{}", name, std::process::id()))
+    }
+
+    #[test]
+    fn test_buffered_typed_round_trip() {
+        let table = FileHandleTable::new();
+        let path = temp_path("typed");
+
+        let operation = FileOperation::new(&path, FileOperationType::Write).with_buffer_size(16);
+        let handle = table.open(&operation, false).unwrap();
+        table.write_i64(handle, -42).unwrap();
+        table.write_u8(handle, 7).unwrap();
+        table.write(handle, "文本".as_bytes()).unwrap();
+        table.close(handle).unwrap();
+
+        let handle = table.open(&FileOperation::new(&path, FileOperationType::Read), false).unwrap();
+        assert_eq!(table.read_i64(handle).unwrap(), Some(-42));
+        assert_eq!(table.read_u8(handle).unwrap(), Some(7));
+        let mut text = [0u8; 6];
+        assert_eq!(table.read(handle, &mut text).unwrap(), 6);
+        assert_eq!(&text, "文本".as_bytes());
+        assert_eq!(table.read_u8(handle).unwrap(), None);
+        assert!(table.is_eof(handle).unwrap());
+        table.close(handle).unwrap();
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_partial_value_at_eof_is_not_consumed() {
+        let table = FileHandleTable::new();
+        let path = temp_path("partial");
+        std::fs::write(&path, [1u8, 2, 3]).unwrap();
+
+        let handle = table.open(&FileOperation::new(&path, FileOperationType::Read), false).unwrap();
+        assert_eq!(table.read_i64(handle).unwrap(), None);
+        assert!(table.is_eof(handle).unwrap());
+
+        // The three bytes are still there, and a retry succeeds once the file grows
+        assert_eq!(table.read_u8(handle).unwrap(), Some(1));
+        std::fs::OpenOptions::new().append(true).open(&path).unwrap().write_all(&[0; 7]).unwrap();
+        assert_eq!(table.read_i64(handle).unwrap(), Some(i64::from_le_bytes([2, 3, 0, 0, 0, 0, 0, 0])));
+        table.close(handle).unwrap();
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_stale_handles_are_rejected() {
+        let table = FileHandleTable::new();
+        let path = temp_path("stale");
+
+        let first = table.open(&FileOperation::new(&path, FileOperationType::Write), false).unwrap();
+        table.close(first).unwrap();
+        assert!(table.close(first).is_err());
+
+        // The slot is reused with a new generation
+        let second = table.open(&FileOperation::new(&path, FileOperationType::Write), false).unwrap();
+        assert_eq!(first & 0xffff_ffff, second & 0xffff_ffff);
+        assert_ne!(first, second);
+        assert!(table.write(first, b"x").is_err());
+        assert!(table.write(second, b"x").is_ok());
+        assert!(table.read(0, &mut [0u8; 1]).is_err());
+        assert!(table.read(-5, &mut [0u8; 1]).is_err());
+        table.close(second).unwrap();
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_positional_io_and_mode_switching() {
+        let table = FileHandleTable::new();
+        let path = temp_path("positional");
+
+        let handle = table.open(&FileOperation::new(&path, FileOperationType::Write), true).unwrap();
+        table.write(handle, b"0123456789").unwrap();
+        // Buffered data must be visible to positional reads
+        let mut middle = [0u8; 3];
+        assert_eq!(table.read_at(handle, &mut middle, 4).unwrap(), 3);
+        assert_eq!(&middle, b"456");
+
+        table.write_at(handle, b"ab", 0).unwrap();
+        table.close(handle).unwrap();
+        assert_eq!(std::fs::read(&path).unwrap(), b"ab23456789");
+
+        let handle = table.open(&FileOperation::new(&path, FileOperationType::Read), true).unwrap();
+        let mut head = [0u8; 2];
+        table.read(handle, &mut head).unwrap();
+        table.write(handle, b"XY").unwrap();
+        table.close(handle).unwrap();
+        assert_eq!(std::fs::read(&path).unwrap(), b"abXY456789");
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_parallel_handles() {
+        let table = FileHandleTable::new();
+        let paths: Vec<_> = (0..8).map(|i| temp_path(&format!("parallel_{}", i))).collect();
+
+        std::thread::scope(|scope| {
+            for path in &paths {
+                let table = &table;
+                scope.spawn(move || {
+                    for round in 0..20 {
+                        let operation = FileOperation::new(path, FileOperationType::Write);
+                        let handle = table.open(&operation, false).unwrap();
+                        table.write_i64(handle, round).unwrap();
+                        table.close(handle).unwrap();
+                    }
+                });
+            }
+        });
+
+        for path in &paths {
+            let handle = table.open(&FileOperation::new(path, FileOperationType::Read), false).unwrap();
+            assert_eq!(table.read_i64(handle).unwrap(), Some(19));
+            table.close(handle).unwrap();
+            std::fs::remove_file(path).unwrap();
+        }
+        // Closed slots are recycled instead of growing the slab
+        assert!(table.files.allocated_slots() <= 8);
+    }
+}
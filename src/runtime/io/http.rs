@@ -3,10 +3,19 @@
 //! This module provides network operations including HTTP requests,
 //! TCP connections, and network timeout management.
 
-use std::net::{TcpStream, ToSocketAddrs};
+use std::net::TcpStream;
 use std::time::{Duration, Instant};
-use std::io::{Read, Write};
+use std::io::{IoSlice, IoSliceMut, Read, Write};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use super::{IoResult, IoError, IoStatistics};
+use super::metrics::{IoCounters, IoOpKind, IoMetricsSnapshot};
+use super::dns;
+use super::http_client::{resolve_location, HttpTransport, StreamingResponse};
+#[cfg(unix)]
+use super::listener::set_int_option;
+
+/// Most buffers passed to one `writev` (the kernel's `UIO_MAXIOV`)
+const MAX_IOVECS: usize = 1024;
 
 /// HTTP request methods
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -33,6 +42,12 @@ impl HttpMethod {
             HttpMethod::Patch => "PATCH",
         }
     }
+
+    /// Whether repeating the request has the same effect as sending it once
+    /// (RFC 9110 §9.2.2), so it may be resent after a dropped connection
+    pub fn is_idempotent(&self) -> bool {
+        !matches!(self, HttpMethod::Post | HttpMethod::Patch)
+    }
 }
 
 /// HTTP request configuration
@@ -145,6 +160,19 @@ pub struct TcpConnectionConfig {
     pub bind_address: Option<String>,
     /// Connection buffer size
     pub buffer_size: usize,
+    /// Disable Nagle's algorithm (`TCP_NODELAY`)
+    pub nodelay: bool,
+    /// Kernel send buffer size (`SO_SNDBUF`); `None` keeps the system default
+    pub send_buffer_size: Option<usize>,
+    /// Kernel receive buffer size (`SO_RCVBUF`); `None` keeps the system default
+    pub recv_buffer_size: Option<usize>,
+    /// Acknowledge reads immediately instead of delaying ACKs (`TCP_QUICKACK`, Linux)
+    pub quickack: bool,
+    /// Busy-poll the device queue on blocking reads (`SO_BUSY_POLL`, Linux)
+    pub busy_poll: Option<Duration>,
+    /// Writes through `write_zerocopy` of at least this many bytes use
+    /// `MSG_ZEROCOPY` (Linux); `None` disables zero-copy
+    pub zerocopy_threshold: Option<usize>,
 }
 
 impl TcpConnectionConfig {
@@ -157,6 +185,12 @@ impl TcpConnectionConfig {
             keep_alive: false,
             bind_address: None,
             buffer_size: 8192,
+            nodelay: false,
+            send_buffer_size: None,
+            recv_buffer_size: None,
+            quickack: false,
+            busy_poll: None,
+            zerocopy_threshold: None,
         }
     }
 
@@ -177,6 +211,64 @@ impl TcpConnectionConfig {
         self.bind_address = Some(bind_address);
         self
     }
+
+    /// Set `TCP_NODELAY`
+    pub fn with_nodelay(mut self, nodelay: bool) -> Self {
+        self.nodelay = nodelay;
+        self
+    }
+
+    /// Set kernel send and receive buffer sizes
+    pub fn with_buffer_sizes(mut self, send: Option<usize>, recv: Option<usize>) -> Self {
+        self.send_buffer_size = send;
+        self.recv_buffer_size = recv;
+        self
+    }
+
+    /// Set `TCP_QUICKACK`
+    ///
+    /// The kernel drops back to delayed ACKs on its own, so the option is
+    /// re-armed after every read.
+    pub fn with_quickack(mut self, quickack: bool) -> Self {
+        self.quickack = quickack;
+        self
+    }
+
+    /// Busy-poll for up to `duration` before sleeping on a blocking read
+    ///
+    /// Raising it above `net.core.busy_read` needs `CAP_NET_ADMIN`; like
+    /// `quickack`, it is a hint and is skipped if the kernel refuses it.
+    pub fn with_busy_poll(mut self, duration: Duration) -> Self {
+        self.busy_poll = Some(duration);
+        self
+    }
+
+    /// Send buffers of at least `threshold` bytes with `MSG_ZEROCOPY`
+    ///
+    /// Below roughly 10 KiB the page pinning and completion handling cost
+    /// more than the copy they save.
+    pub fn with_zerocopy(mut self, threshold: usize) -> Self {
+        self.zerocopy_threshold = Some(threshold.max(1));
+        self
+    }
+}
+
+/// Zero-copy send bookkeeping for one connection
+///
+/// Each successful `MSG_ZEROCOPY` send gets the next sequence number; the
+/// kernel reports finished ranges on the socket error queue.
+#[derive(Debug, Default)]
+struct ZeroCopyState {
+    enabled: AtomicBool,
+    issued: AtomicU64,
+    completed: AtomicU64,
+    /// Sends the kernel completed by copying after all
+    copied: AtomicU64,
+}
+
+/// Clamp a size to the `int` socket options take
+fn clamp_option(value: usize) -> libc::c_int {
+    value.min(libc::c_int::MAX as usize) as libc::c_int
 }
 
 /// TCP connection
@@ -189,9 +281,11 @@ pub struct TcpConnection {
     /// Connection established timestamp
     established_at: Instant,
     /// Bytes read
-    bytes_read: u64,
+    bytes_read: AtomicU64,
     /// Bytes written
-    bytes_written: u64,
+    bytes_written: AtomicU64,
+    /// Outstanding `MSG_ZEROCOPY` sends
+    zerocopy: ZeroCopyState,
 }
 
 impl TcpConnection {
@@ -199,18 +293,8 @@ impl TcpConnection {
     pub fn connect(config: TcpConnectionConfig) -> IoResult<Self> {
         let start_time = Instant::now();
 
-        // Resolve address
-        let addr = format!("{}:{}", config.host, config.port)
-            .to_socket_addrs()
-            .map_err(|e| IoError::NetworkOperationFailed {
-                endpoint: config.host.clone(),
-                message: format!("解析地址失败: {}", e),
-            })?
-            .next()
-            .ok_or_else(|| IoError::NetworkOperationFailed {
-                endpoint: config.host.clone(),
-                message: "无法解析地址".to_string(),
-            })?;
+        // Resolve address through the shared cache
+        let addr = dns::resolve_socket_addr(&config.host, config.port)?;
 
         // Connect with timeout
         #[cfg(unix)]
@@ -228,13 +312,100 @@ impl TcpConnection {
             })?
         };
 
-        Ok(Self {
+        let connection = Self {
             stream,
             config,
             established_at: start_time,
-            bytes_read: 0,
-            bytes_written: 0,
-        })
+            bytes_read: AtomicU64::new(0),
+            bytes_written: AtomicU64::new(0),
+            zerocopy: ZeroCopyState::default(),
+        };
+        connection.apply_socket_options()?;
+        Ok(connection)
+    }
+
+    /// Wrap a connection taken from a listener
+    ///
+    /// Accepted sockets are non-blocking; reads and writes wait for
+    /// readiness in `poll` so callers still see blocking semantics.
+    pub fn from_accepted(stream: TcpStream, peer: std::net::SocketAddr) -> Self {
+        Self {
+            stream,
+            config: TcpConnectionConfig::new(peer.ip().to_string(), peer.port()),
+            established_at: Instant::now(),
+            bytes_read: AtomicU64::new(0),
+            bytes_written: AtomicU64::new(0),
+            zerocopy: ZeroCopyState::default(),
+        }
+    }
+
+    /// Wrap a connection taken from a listener and apply the socket
+    /// options in `config`
+    pub fn from_accepted_with_config(
+        stream: TcpStream,
+        peer: std::net::SocketAddr,
+        config: TcpConnectionConfig,
+    ) -> IoResult<Self> {
+        let connection = Self { config, ..Self::from_accepted(stream, peer) };
+        connection.apply_socket_options()?;
+        Ok(connection)
+    }
+
+    /// Apply the socket options from the configuration
+    ///
+    /// Buffer sizes take effect after the handshake here, so the window
+    /// scale was negotiated from the system default; on Linux that default
+    /// already allows windows up to `tcp_rmem`'s maximum.
+    #[cfg(unix)]
+    fn apply_socket_options(&self) -> IoResult<()> {
+        use std::os::unix::io::AsRawFd;
+
+        let fd = self.stream.as_raw_fd();
+        let config = &self.config;
+        let endpoint = format!("{}:{}", config.host, config.port);
+        let failed = |option: &str, e: std::io::Error| IoError::NetworkOperationFailed {
+            endpoint: endpoint.clone(),
+            message: format!("设置 {} 失败: {}", option, e),
+        };
+
+        if config.nodelay {
+            self.stream.set_nodelay(true).map_err(|e| failed("TCP_NODELAY", e))?;
+        }
+        if config.keep_alive {
+            set_int_option(fd, libc::SOL_SOCKET, libc::SO_KEEPALIVE, 1).map_err(|e| failed("SO_KEEPALIVE", e))?;
+        }
+        if let Some(size) = config.send_buffer_size {
+            set_int_option(fd, libc::SOL_SOCKET, libc::SO_SNDBUF, clamp_option(size))
+                .map_err(|e| failed("SO_SNDBUF", e))?;
+        }
+        if let Some(size) = config.recv_buffer_size {
+            set_int_option(fd, libc::SOL_SOCKET, libc::SO_RCVBUF, clamp_option(size))
+                .map_err(|e| failed("SO_RCVBUF", e))?;
+        }
+
+        #[cfg(target_os = "linux")]
+        {
+            // Hints: unprivileged processes may not raise busy polling
+            if config.quickack {
+                let _ = set_int_option(fd, libc::IPPROTO_TCP, libc::TCP_QUICKACK, 1);
+            }
+            if let Some(duration) = config.busy_poll {
+                let _ = set_int_option(fd, libc::SOL_SOCKET, libc::SO_BUSY_POLL, clamp_option(duration.as_micros() as usize));
+            }
+            if config.zerocopy_threshold.is_some() {
+                let enabled = set_int_option(fd, libc::SOL_SOCKET, libc::SO_ZEROCOPY, 1).is_ok();
+                self.zerocopy.enabled.store(enabled, Ordering::Relaxed);
+            }
+        }
+        Ok(())
+    }
+
+    #[cfg(not(unix))]
+    fn apply_socket_options(&self) -> IoResult<()> {
+        if self.config.nodelay {
+            self.stream.set_nodelay(true)?;
+        }
+        Ok(())
     }
 
     /// Connect with timeout on Unix systems
@@ -292,10 +463,14 @@ impl TcpConnection {
     }
 
     /// Read data from connection
-    pub fn read(&mut self, buf: &mut [u8]) -> IoResult<usize> {
-        match self.stream.read(buf) {
+    ///
+    /// Takes `&self` (sockets are full duplex), so one thread can block in
+    /// `read` while another writes to the same connection.
+    pub fn read(&self, buf: &mut [u8]) -> IoResult<usize> {
+        match self.retry_when_ready(libc::POLLIN, || (&self.stream).read(buf)) {
             Ok(bytes_read) => {
-                self.bytes_read += bytes_read as u64;
+                self.bytes_read.fetch_add(bytes_read as u64, Ordering::Relaxed);
+                self.rearm_quickack();
                 Ok(bytes_read)
             }
             Err(e) => Err(IoError::NetworkOperationFailed {
@@ -306,10 +481,10 @@ impl TcpConnection {
     }
 
     /// Write data to connection
-    pub fn write(&mut self, buf: &[u8]) -> IoResult<usize> {
-        match self.stream.write(buf) {
+    pub fn write(&self, buf: &[u8]) -> IoResult<usize> {
+        match self.retry_when_ready(libc::POLLOUT, || (&self.stream).write(buf)) {
             Ok(bytes_written) => {
-                self.bytes_written += bytes_written as u64;
+                self.bytes_written.fetch_add(bytes_written as u64, Ordering::Relaxed);
                 Ok(bytes_written)
             }
             Err(e) => Err(IoError::NetworkOperationFailed {
@@ -319,9 +494,247 @@ impl TcpConnection {
         }
     }
 
+    /// Read into several buffers with one `readv`
+    pub fn read_vectored(&self, bufs: &mut [IoSliceMut<'_>]) -> IoResult<usize> {
+        match self.retry_when_ready(libc::POLLIN, || (&self.stream).read_vectored(bufs)) {
+            Ok(bytes_read) => {
+                self.bytes_read.fetch_add(bytes_read as u64, Ordering::Relaxed);
+                self.rearm_quickack();
+                Ok(bytes_read)
+            }
+            Err(e) => Err(IoError::NetworkOperationFailed {
+                endpoint: format!("{}:{}", self.config.host, self.config.port),
+                message: format!("读取数据失败: {}", e),
+            }),
+        }
+    }
+
+    /// Write several buffers in order, as one stream of bytes
+    ///
+    /// Uses `writev`, so a frame header and its payload go out together
+    /// without being copied into one buffer first. Returns once every
+    /// byte is written.
+    pub fn write_vectored(&self, bufs: &[&[u8]]) -> IoResult<usize> {
+        let parts: Vec<&[u8]> = bufs.iter().copied().filter(|part| !part.is_empty()).collect();
+        let (mut index, mut offset, mut total) = (0, 0, 0);
+        while index < parts.len() {
+            let slices: Vec<IoSlice<'_>> = std::iter::once(&parts[index][offset..])
+                .chain(parts[index + 1..].iter().copied())
+                .take(MAX_IOVECS)
+                .map(IoSlice::new)
+                .collect();
+            let mut written = match self.retry_when_ready(libc::POLLOUT, || (&self.stream).write_vectored(&slices)) {
+                Ok(0) => Err(std::io::ErrorKind::WriteZero.into()),
+                Ok(written) => Ok(written),
+                Err(e) => Err(e),
+            }
+            .map_err(|e| IoError::NetworkOperationFailed {
+                endpoint: format!("{}:{}", self.config.host, self.config.port),
+                message: format!("写入数据失败: {}", e),
+            })?;
+            self.bytes_written.fetch_add(written as u64, Ordering::Relaxed);
+            total += written;
+            while index < parts.len() && written >= parts[index].len() - offset {
+                written -= parts[index].len() - offset;
+                index += 1;
+                offset = 0;
+            }
+            offset += written;
+        }
+        Ok(total)
+    }
+
+    /// Write with `MSG_ZEROCOPY` when enabled and `buf` is large enough
+    ///
+    /// The kernel sends straight from `buf`'s pages, so its contents must
+    /// stay unchanged until `wait_zerocopy` (or `zerocopy_pending`)
+    /// reports the send complete. Smaller writes, and sockets without
+    /// zero-copy, fall back to a normal copying `write`.
+    pub fn write_zerocopy(&self, buf: &[u8]) -> IoResult<usize> {
+        let threshold = self.config.zerocopy_threshold.unwrap_or(usize::MAX);
+        if !self.zerocopy.enabled.load(Ordering::Relaxed) || buf.len() < threshold {
+            return self.write(buf);
+        }
+
+        #[cfg(target_os = "linux")]
+        {
+            use std::os::unix::io::AsRawFd;
+
+            let fd = self.stream.as_raw_fd();
+            let result = self.retry_when_ready(libc::POLLOUT, || {
+                let sent = unsafe {
+                    libc::send(fd, buf.as_ptr() as *const libc::c_void, buf.len(), libc::MSG_ZEROCOPY)
+                };
+                if sent < 0 {
+                    Err(std::io::Error::last_os_error())
+                } else {
+                    Ok(sent as usize)
+                }
+            });
+            return match result {
+                Ok(sent) => {
+                    self.zerocopy.issued.fetch_add(1, Ordering::AcqRel);
+                    self.bytes_written.fetch_add(sent as u64, Ordering::Relaxed);
+                    Ok(sent)
+                }
+                // Out of optmem for pinned pages: copy this one instead
+                Err(e) if e.raw_os_error() == Some(libc::ENOBUFS) => self.write(buf),
+                Err(e) => Err(IoError::NetworkOperationFailed {
+                    endpoint: format!("{}:{}", self.config.host, self.config.port),
+                    message: format!("写入数据失败: {}", e),
+                }),
+            };
+        }
+
+        #[cfg(not(target_os = "linux"))]
+        return self.write(buf);
+    }
+
+    /// Number of zero-copy sends whose buffers the kernel still holds
+    pub fn zerocopy_pending(&self) -> u64 {
+        let _ = self.reap_zerocopy();
+        self.zerocopy.issued.load(Ordering::Acquire) - self.zerocopy.completed.load(Ordering::Acquire)
+    }
+
+    /// Number of zero-copy sends the kernel completed by copying instead,
+    /// which suggests the threshold is too low for this route
+    pub fn zerocopy_copied(&self) -> u64 {
+        self.zerocopy.copied.load(Ordering::Relaxed)
+    }
+
+    /// Wait until every zero-copy send has completed, or `timeout` passes
+    ///
+    /// Returns the number of sends still pending (0 once all buffers may
+    /// be reused).
+    pub fn wait_zerocopy(&self, timeout: Option<Duration>) -> IoResult<u64> {
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        loop {
+            let pending = self.zerocopy_pending();
+            if pending == 0 {
+                return Ok(0);
+            }
+            let wait_ms = match deadline {
+                Some(deadline) => match deadline.checked_duration_since(Instant::now()) {
+                    Some(remaining) if !remaining.is_zero() => (remaining.as_millis() as i32).clamp(1, 100),
+                    _ => return Ok(pending),
+                },
+                None => 100,
+            };
+            // Completions arrive on the error queue, which polls as POLLERR
+            let ready = self.poll_timeout(0, wait_ms)?;
+            if ready & (libc::POLLHUP | libc::POLLNVAL) != 0 {
+                return Ok(self.zerocopy_pending());
+            }
+        }
+    }
+
+    /// Drain zero-copy completions from the socket error queue
+    #[cfg(target_os = "linux")]
+    fn reap_zerocopy(&self) -> std::io::Result<()> {
+        use std::os::unix::io::AsRawFd;
+
+        const SO_EE_ORIGIN_ZEROCOPY: u8 = 5;
+        const SO_EE_CODE_ZEROCOPY_COPIED: u8 = 1;
+
+        if self.zerocopy.issued.load(Ordering::Acquire) == self.zerocopy.completed.load(Ordering::Acquire) {
+            return Ok(());
+        }
+        loop {
+            let mut control = [0u64; 16];
+            let mut header: libc::msghdr = unsafe { std::mem::zeroed() };
+            header.msg_control = control.as_mut_ptr() as *mut libc::c_void;
+            header.msg_controllen = std::mem::size_of_val(&control) as _;
+            let result = unsafe { libc::recvmsg(self.stream.as_raw_fd(), &mut header, libc::MSG_ERRQUEUE) };
+            if result < 0 {
+                let error = std::io::Error::last_os_error();
+                return match error.kind() {
+                    std::io::ErrorKind::WouldBlock => Ok(()),
+                    std::io::ErrorKind::Interrupted => continue,
+                    _ => Err(error),
+                };
+            }
+
+            let mut message = unsafe { libc::CMSG_FIRSTHDR(&header) };
+            while !message.is_null() {
+                let cmsg = unsafe { &*message };
+                let is_recverr = (cmsg.cmsg_level == libc::SOL_IP && cmsg.cmsg_type == libc::IP_RECVERR)
+                    || (cmsg.cmsg_level == libc::SOL_IPV6 && cmsg.cmsg_type == libc::IPV6_RECVERR);
+                if is_recverr {
+                    let error = unsafe {
+                        std::ptr::read_unaligned(libc::CMSG_DATA(message) as *const libc::sock_extended_err)
+                    };
+                    if error.ee_origin == SO_EE_ORIGIN_ZEROCOPY {
+                        // ee_info..=ee_data is the range of finished sends
+                        let finished = error.ee_data.wrapping_sub(error.ee_info).wrapping_add(1) as u64;
+                        self.zerocopy.completed.fetch_add(finished, Ordering::AcqRel);
+                        if error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED != 0 {
+                            self.zerocopy.copied.fetch_add(finished, Ordering::Relaxed);
+                        }
+                    }
+                }
+                message = unsafe { libc::CMSG_NXTHDR(&header, message) };
+            }
+        }
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    fn reap_zerocopy(&self) -> std::io::Result<()> {
+        Ok(())
+    }
+
+    /// Re-arm `TCP_QUICKACK`, which the kernel clears on its own
+    fn rearm_quickack(&self) {
+        #[cfg(target_os = "linux")]
+        if self.config.quickack {
+            use std::os::unix::io::AsRawFd;
+            let _ = set_int_option(self.stream.as_raw_fd(), libc::IPPROTO_TCP, libc::TCP_QUICKACK, 1);
+        }
+    }
+
+    /// Run `operation`, waiting in `poll` whenever a non-blocking socket
+    /// is not ready yet
+    fn retry_when_ready<T>(
+        &self,
+        events: libc::c_short,
+        mut operation: impl FnMut() -> std::io::Result<T>,
+    ) -> std::io::Result<T> {
+        loop {
+            match operation() {
+                Err(e) if e.kind() == std::io::ErrorKind::WouldBlock => self.wait_ready(events)?,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+                result => return result,
+            }
+        }
+    }
+
+    fn wait_ready(&self, events: libc::c_short) -> std::io::Result<()> {
+        self.poll_timeout(events, -1).map(|_| ())
+    }
+
+    /// Wait up to `timeout_ms` (-1 for ever) and return the ready events
+    #[cfg(unix)]
+    fn poll_timeout(&self, events: libc::c_short, timeout_ms: i32) -> std::io::Result<libc::c_short> {
+        use std::os::unix::io::AsRawFd;
+
+        let mut pollfd = libc::pollfd { fd: self.stream.as_raw_fd(), events, revents: 0 };
+        if unsafe { libc::poll(&mut pollfd, 1, timeout_ms) } < 0 {
+            let error = std::io::Error::last_os_error();
+            if error.kind() != std::io::ErrorKind::Interrupted {
+                return Err(error);
+            }
+        }
+        Ok(pollfd.revents)
+    }
+
+    #[cfg(not(unix))]
+    fn poll_timeout(&self, _events: libc::c_short, _timeout_ms: i32) -> std::io::Result<libc::c_short> {
+        std::thread::yield_now();
+        Ok(0)
+    }
+
     /// Flush pending writes
-    pub fn flush(&mut self) -> IoResult<()> {
-        self.stream.flush().map_err(|e| IoError::NetworkOperationFailed {
+    pub fn flush(&self) -> IoResult<()> {
+        (&self.stream).flush().map_err(|e| IoError::NetworkOperationFailed {
             endpoint: format!("{}:{}", self.config.host, self.config.port),
             message: format!("刷新缓冲区失败: {}", e),
         })
@@ -334,12 +747,31 @@ impl TcpConnection {
 
     /// Get bytes read
     pub fn bytes_read(&self) -> u64 {
-        self.bytes_read
+        self.bytes_read.load(Ordering::Relaxed)
     }
 
     /// Get bytes written
     pub fn bytes_written(&self) -> u64 {
-        self.bytes_written
+        self.bytes_written.load(Ordering::Relaxed)
+    }
+
+    /// Set read and write timeouts; `None` blocks indefinitely
+    pub fn set_timeout(&self, timeout: Option<Duration>) -> IoResult<()> {
+        self.stream
+            .set_read_timeout(timeout)
+            .and_then(|_| self.stream.set_write_timeout(timeout))
+            .map_err(|e| IoError::NetworkOperationFailed {
+                endpoint: format!("{}:{}", self.config.host, self.config.port),
+                message: format!("设置超时失败: {}", e),
+            })
+    }
+
+    /// Shut down both directions, waking any thread blocked on the socket
+    pub fn shutdown(&self) -> IoResult<()> {
+        self.stream.shutdown(std::net::Shutdown::Both).map_err(|e| IoError::NetworkOperationFailed {
+            endpoint: format!("{}:{}", self.config.host, self.config.port),
+            message: format!("关闭连接失败: {}", e),
+        })
     }
 
     /// Get local address
@@ -359,82 +791,131 @@ impl TcpConnection {
     }
 }
 
+#[cfg(unix)]
+impl std::os::unix::io::AsRawFd for TcpConnection {
+    fn as_raw_fd(&self) -> std::os::unix::io::RawFd {
+        self.stream.as_raw_fd()
+    }
+}
+
 /// HTTP client
 #[derive(Debug)]
 pub struct HttpClient {
     /// Default timeout
     default_timeout: Duration,
     /// I/O statistics
-    statistics: std::sync::Mutex<IoStatistics>,
+    statistics: IoCounters,
+    /// Keep-alive connection pool and wire protocol
+    transport: HttpTransport,
 }
 
 impl HttpClient {
     /// Create new HTTP client
     pub fn new() -> Self {
-        Self {
-            default_timeout: Duration::from_secs(30),
-            statistics: std::sync::Mutex::new(IoStatistics::new()),
-        }
+        Self::with_timeout(Duration::from_secs(30))
     }
 
     /// Create HTTP client with default timeout
     pub fn with_timeout(timeout: Duration) -> Self {
         Self {
             default_timeout: timeout,
-            statistics: std::sync::Mutex::new(IoStatistics::new()),
+            statistics: IoCounters::new(),
+            transport: HttpTransport::new(),
         }
     }
 
-    /// Execute HTTP request
+    /// Execute HTTP request, following redirects and reading the whole body
     pub fn execute(&self, request: HttpRequest) -> IoResult<HttpResponse> {
         let start_time = Instant::now();
-
-        // For this implementation, we'll simulate HTTP requests
-        // In a real implementation, we would use an HTTP client library
-        let response = self.simulate_http_request(&request);
-
-        let elapsed = start_time.elapsed();
-
-        match &response {
-            Ok(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_read(response.as_ref().unwrap().body.len() as u64, elapsed.as_millis() as f64);
-            }
-            Err(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_failure();
-            }
-        }
+        let response = self.fetch(request, start_time);
+        let bytes = response.as_ref().map_or(0, |response| response.body.len() as u64);
+        self.statistics.record_result(IoOpKind::HttpRequest, &response, bytes, start_time.elapsed());
 
         response
     }
 
     /// Get statistics
     pub fn get_statistics(&self) -> IoStatistics {
-        self.statistics.lock().unwrap().clone()
+        self.statistics.snapshot().to_statistics()
+    }
+
+    /// Get per-operation counters and latency histograms
+    pub fn io_metrics(&self) -> IoMetricsSnapshot {
+        self.statistics.snapshot()
     }
 
     /// Reset statistics
     pub fn reset_statistics(&mut self) {
-        let mut stats = self.statistics.lock().unwrap();
-        stats.reset();
+        self.statistics.reset();
     }
 
-    /// Simulate HTTP request (placeholder implementation)
-    fn simulate_http_request(&self, request: &HttpRequest) -> IoResult<HttpResponse> {
-        // This is a simulation - in a real implementation we would make actual HTTP requests
-        let response_time = std::time::Duration::from_millis(150);
+    /// Send a single request and return as soon as the response head arrives
+    ///
+    /// The body is decoded as it is read, so large responses can be
+    /// streamed. Redirects are not followed.
+    pub fn send(&self, request: &HttpRequest) -> IoResult<StreamingResponse> {
+        self.transport.send(request)
+    }
 
-        Ok(HttpResponse {
-            status_code: 200,
-            headers: std::collections::HashMap::from([
-                ("content-type".to_string(), "application/json".to_string()),
-                ("content-length".to_string(), "13".to_string()),
-            ]),
-            body: b"Hello, World!".to_vec(),
-            response_time_ms: response_time.as_millis() as u64,
-            redirect_count: 0,
-        })
+    /// Get the transport and its connection pool
+    pub fn transport(&self) -> &HttpTransport {
+        &self.transport
+    }
+
+    fn fetch(&self, mut request: HttpRequest, start_time: Instant) -> IoResult<HttpResponse> {
+        let mut redirect_count = 0;
+        loop {
+            let response = self.transport.send(&request)?;
+            let status_code = response.status_code();
+            let location = match status_code {
+                301 | 302 | 303 | 307 | 308 if request.follow_redirects => {
+                    response.head.header_str("location").map(str::to_string)
+                }
+                _ => None,
+            };
+
+            if let Some(location) = location {
+                if redirect_count >= request.max_redirects {
+                    return Err(IoError::NetworkOperationFailed {
+                        endpoint: request.url,
+                        message: format!("重定向次数超过 {}", request.max_redirects),
+                    });
+                }
+                // Drain the redirect body so its connection can be reused
+                response.read_to_end()?;
+                request.url = resolve_location(&request.url, &location)?;
+                if status_code == 303 || (matches!(status_code, 301 | 302) && request.method == HttpMethod::Post) {
+                    request.method = HttpMethod::Get;
+                    request.body = None;
+                    request.headers.retain(|name, _| {
+                        !name.eq_ignore_ascii_case("content-length") && !name.eq_ignore_ascii_case("content-type")
+                    });
+                }
+                redirect_count += 1;
+                continue;
+            }
+
+            let mut headers = std::collections::HashMap::new();
+            for (name, value) in response.head.headers() {
+                let value = String::from_utf8_lossy(value);
+                headers
+                    .entry(name.to_ascii_lowercase())
+                    .and_modify(|existing: &mut String| {
+                        existing.push_str(", ");
+                        existing.push_str(&value);
+                    })
+                    .or_insert_with(|| value.into_owned());
+            }
+            let body = response.read_to_end()?;
+
+            return Ok(HttpResponse {
+                status_code,
+                headers,
+                body,
+                response_time_ms: start_time.elapsed().as_millis() as u64,
+                redirect_count,
+            });
+        }
     }
 }
 
@@ -450,7 +931,7 @@ pub struct TcpManager {
     /// Default timeout
     default_timeout: Duration,
     /// I/O statistics
-    statistics: std::sync::Mutex<IoStatistics>,
+    statistics: IoCounters,
 }
 
 impl TcpManager {
@@ -458,7 +939,7 @@ impl TcpManager {
     pub fn new() -> Self {
         Self {
             default_timeout: Duration::from_secs(30),
-            statistics: std::sync::Mutex::new(IoStatistics::new()),
+            statistics: IoCounters::new(),
         }
     }
 
@@ -466,7 +947,7 @@ impl TcpManager {
     pub fn with_timeout(timeout: Duration) -> Self {
         Self {
             default_timeout: timeout,
-            statistics: std::sync::Mutex::new(IoStatistics::new()),
+            statistics: IoCounters::new(),
         }
     }
 
@@ -475,31 +956,24 @@ impl TcpManager {
         let start_time = Instant::now();
         let result = TcpConnection::connect(config);
 
-        match &result {
-            Ok(_) => {
-                let elapsed = start_time.elapsed();
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_network_operations();
-                // Network operations don't have byte counts easily accessible
-            }
-            Err(_) => {
-                let mut stats = self.statistics.lock().unwrap();
-                stats.record_failure();
-            }
-        }
+        self.statistics.record_result(IoOpKind::TcpConnect, &result, 0, start_time.elapsed());
 
         result
     }
 
     /// Get statistics
     pub fn get_statistics(&self) -> IoStatistics {
-        self.statistics.lock().unwrap().clone()
+        self.statistics.snapshot().to_statistics()
+    }
+
+    /// Get per-operation counters and latency histograms
+    pub fn io_metrics(&self) -> IoMetricsSnapshot {
+        self.statistics.snapshot()
     }
 
     /// Reset statistics
     pub fn reset_statistics(&mut self) {
-        let mut stats = self.statistics.lock().unwrap();
-        stats.reset();
+        self.statistics.reset();
     }
 
     /// Initialize the TCP manager
@@ -607,14 +1081,10 @@ mod tests {
     #[test]
     fn test_http_client() {
         let client = HttpClient::new();
-        let request = HttpRequest::get("https://example.com".to_string());
 
-        let response = client.execute(request);
-        assert!(response.is_ok());
-
-        let response = response.unwrap();
-        assert_eq!(response.status_code, 200);
-        assert_eq!(response.body_as_string().unwrap(), "Hello, World!");
+        // There is no TLS layer, so HTTPS is rejected before connecting
+        let request = HttpRequest::get("https://example.com".to_string());
+        assert!(client.execute(request).is_err());
     }
 
     #[test]
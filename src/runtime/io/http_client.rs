@@ -0,0 +1,1043 @@
+//! HTTP/1.1 Client Transport
+//!
+//! Wire-level half of `HttpClient`. Connections are pooled per host and
+//! port and reused while the server keeps them alive. Response heads are
+//! parsed by `http_parse`, so nothing is allocated per header. Bodies (content-length,
+//! chunked or read-until-close) are decoded incrementally as the caller
+//! reads, so large bodies stream through a fixed-size buffer.
+//!
+//! Only plain `http://` URLs are supported; there is no TLS layer.
+
+use std::collections::HashMap;
+use std::io::{self, Read, Write};
+use std::ops::Range;
+use std::sync::{Arc, Mutex, MutexGuard};
+use std::time::{Duration, Instant};
+
+use super::http::{HttpMethod, HttpRequest, TcpConnection, TcpConnectionConfig};
+use super::http_parse::{self, HeaderBlock, MAX_HEAD_SIZE};
+use super::{IoError, IoResult};
+
+/// Socket read buffer per pooled connection
+const READ_BUFFER_SIZE: usize = 16 * 1024;
+/// Longest chunk-size or trailer line
+const MAX_LINE_SIZE: usize = 8 * 1024;
+/// Request bodies up to this size are sent in the same write as the head
+const INLINE_BODY_SIZE: usize = 64 * 1024;
+/// Idle connections kept per host
+const MAX_IDLE_PER_HOST: usize = 8;
+/// Idle connections older than this are closed instead of reused
+const IDLE_TIMEOUT: Duration = Duration::from_secs(60);
+
+/// Parsed `http://` URL borrowing from the request
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct HttpUrl<'a> {
+    /// Host name or address, without IPv6 brackets
+    pub host: &'a str,
+    /// Port, 80 when absent
+    pub port: u16,
+    /// Path and query sent on the request line
+    pub target: &'a str,
+}
+
+impl<'a> HttpUrl<'a> {
+    /// Parse an absolute `http://` URL
+    pub fn parse(url: &'a str) -> IoResult<Self> {
+        let invalid = |message: &str| IoError::NetworkOperationFailed {
+            endpoint: url.to_string(),
+            message: message.to_string(),
+        };
+
+        let rest = match strip_scheme(url, "http://") {
+            Some(rest) => rest,
+            None if strip_scheme(url, "https://").is_some() => return Err(invalid("不支持 HTTPS")),
+            None => return Err(invalid("仅支持 http:// 地址")),
+        };
+        let rest = rest.split('#').next().unwrap_or("");
+        let split = rest.find(|c| c == '/' || c == '?').unwrap_or(rest.len());
+        let (authority, target) = rest.split_at(split);
+        let authority = authority.rsplit('@').next().unwrap_or(authority);
+
+        let (host, port) = if let Some(bracketed) = authority.strip_prefix('[') {
+            let end = bracketed.find(']').ok_or_else(|| invalid("IPv6 地址缺少 ]"))?;
+            let port = match &bracketed[end + 1..] {
+                "" => 80,
+                port => port
+                    .strip_prefix(':')
+                    .and_then(|port| port.parse().ok())
+                    .ok_or_else(|| invalid("端口无效"))?,
+            };
+            (&bracketed[..end], port)
+        } else {
+            match authority.rsplit_once(':') {
+                Some((host, port)) => (host, port.parse().map_err(|_| invalid("端口无效"))?),
+                None => (authority, 80),
+            }
+        };
+        if host.is_empty() {
+            return Err(invalid("缺少主机名"));
+        }
+
+        Ok(Self {
+            host,
+            port,
+            target: if target.is_empty() { "/" } else { target },
+        })
+    }
+
+    /// Write `host[:port]` as used in the Host header and socket address
+    fn write_authority(&self, out: &mut Vec<u8>, always_port: bool) {
+        if self.host.contains(':') {
+            let _ = write!(out, "[{}]", self.host);
+        } else {
+            out.extend_from_slice(self.host.as_bytes());
+        }
+        if always_port || self.port != 80 {
+            let _ = write!(out, ":{}", self.port);
+        }
+    }
+}
+
+fn strip_scheme<'a>(url: &'a str, scheme: &str) -> Option<&'a str> {
+    match url.get(..scheme.len()) {
+        Some(prefix) if prefix.eq_ignore_ascii_case(scheme) => Some(&url[scheme.len()..]),
+        _ => None,
+    }
+}
+
+/// Resolve a `Location` header against the URL that produced it
+pub fn resolve_location(base: &str, location: &str) -> IoResult<String> {
+    if strip_scheme(location, "http://").is_some() || strip_scheme(location, "https://").is_some() {
+        return Ok(location.to_string());
+    }
+    if let Some(rest) = location.strip_prefix("//") {
+        return Ok(format!("http://{}", rest));
+    }
+
+    let url = HttpUrl::parse(base)?;
+    let mut resolved = b"http://".to_vec();
+    url.write_authority(&mut resolved, false);
+    if location.starts_with('/') {
+        resolved.extend_from_slice(location.as_bytes());
+    } else {
+        let path = url.target.split('?').next().unwrap_or("/");
+        let directory = &path[..path.rfind('/').map_or(0, |slash| slash + 1)];
+        if !directory.starts_with('/') {
+            resolved.push(b'/');
+        }
+        resolved.extend_from_slice(directory.as_bytes());
+        resolved.extend_from_slice(location.as_bytes());
+    }
+    Ok(String::from_utf8(resolved).unwrap_or_default())
+}
+
+/// Status line and headers of a response
+#[derive(Debug, Clone)]
+pub struct ResponseHead {
+    /// Status code
+    pub status_code: u16,
+    /// 0 for HTTP/1.0, 1 for HTTP/1.1
+    pub minor_version: u8,
+    reason: Range<usize>,
+    headers: HeaderBlock,
+}
+
+impl ResponseHead {
+    /// Parse a head from the start of `buffer`
+    ///
+    /// Returns the head and its length in bytes, or `None` while the blank
+    /// line that ends it has not arrived yet.
+    pub fn parse(buffer: &[u8]) -> IoResult<Option<(Self, usize)>> {
+        let length = match http_parse::find_head_end(buffer) {
+            Some(length) => length,
+            None if buffer.len() >= MAX_HEAD_SIZE => return Err(protocol_error("响应头过大")),
+            None => return Ok(None),
+        };
+        let raw = buffer[..length].to_vec();
+        let (status_line, next) = http_parse::next_line(&raw, 0).map_err(protocol_error)?;
+        let (minor_version, status_code, reason) = parse_status_line(&raw, status_line)?;
+        let headers = HeaderBlock::parse(raw, next).map_err(protocol_error)?;
+
+        Ok(Some((
+            Self {
+                status_code,
+                minor_version,
+                reason,
+                headers,
+            },
+            length,
+        )))
+    }
+
+    /// Get the reason phrase
+    pub fn reason(&self) -> &str {
+        std::str::from_utf8(&self.headers.raw()[self.reason.clone()]).unwrap_or("")
+    }
+
+    /// Get the first value of header `name` (case-insensitive)
+    pub fn header(&self, name: &str) -> Option<&[u8]> {
+        self.headers.header(name)
+    }
+
+    /// Get the first value of header `name` as text
+    pub fn header_str(&self, name: &str) -> Option<&str> {
+        self.headers.header_str(name)
+    }
+
+    /// Iterate over headers in the order received
+    pub fn headers(&self) -> impl Iterator<Item = (&str, &[u8])> + '_ {
+        self.headers.iter()
+    }
+
+    /// Check whether a comma-separated header lists `token`
+    pub fn has_token(&self, name: &str, token: &str) -> bool {
+        self.headers.has_token(name, token)
+    }
+
+    /// Check whether the server lets the connection be reused
+    pub fn keep_alive(&self) -> bool {
+        self.headers.keep_alive(self.minor_version)
+    }
+
+    /// Get the declared body length, if any
+    pub fn content_length(&self) -> IoResult<Option<u64>> {
+        self.headers.content_length().map_err(protocol_error)
+    }
+}
+
+fn parse_status_line(raw: &[u8], line: Range<usize>) -> IoResult<(u8, u16, Range<usize>)> {
+    let bytes = &raw[line.clone()];
+    let invalid = || protocol_error("状态行无效");
+    if bytes.len() < 12 || !bytes.starts_with(b"HTTP/1.") || bytes[8] != b' ' {
+        return Err(invalid());
+    }
+    let minor_version = match bytes[7] {
+        digit @ b'0'..=b'9' => digit - b'0',
+        _ => return Err(invalid()),
+    };
+    let mut status_code = 0u16;
+    for &digit in &bytes[9..12] {
+        if !digit.is_ascii_digit() {
+            return Err(invalid());
+        }
+        status_code = status_code * 10 + (digit - b'0') as u16;
+    }
+    let reason = match bytes.get(12) {
+        None => line.end..line.end,
+        Some(b' ') => line.start + 13..line.end,
+        Some(_) => return Err(invalid()),
+    };
+    Ok((minor_version, status_code, reason))
+}
+
+fn protocol_error(message: &str) -> IoError {
+    IoError::NetworkOperationFailed {
+        endpoint: "http".to_string(),
+        message: message.to_string(),
+    }
+}
+
+fn truncated_error() -> IoError {
+    protocol_error("响应体不完整: 连接提前关闭")
+}
+
+/// TCP connection with its read buffer, kept together in the pool
+#[derive(Debug)]
+struct PooledConnection {
+    connection: TcpConnection,
+    buffer: Vec<u8>,
+    start: usize,
+    end: usize,
+    idle_since: Instant,
+    /// Whether this connection already served a response
+    reused: bool,
+}
+
+impl PooledConnection {
+    fn connect(url: &HttpUrl<'_>, timeout: Duration) -> IoResult<Self> {
+        let host = if url.host.contains(':') { format!("[{}]", url.host) } else { url.host.to_string() };
+        let config = TcpConnectionConfig::new(host, url.port)
+            .with_timeout(timeout)
+            .with_keep_alive(true);
+        Ok(Self {
+            connection: TcpConnection::connect(config)?,
+            buffer: vec![0; READ_BUFFER_SIZE],
+            start: 0,
+            end: 0,
+            idle_since: Instant::now(),
+            reused: false,
+        })
+    }
+
+    fn buffered(&self) -> &[u8] {
+        &self.buffer[self.start..self.end]
+    }
+
+    fn consume(&mut self, count: usize) {
+        self.start += count;
+        if self.start == self.end {
+            self.start = 0;
+            self.end = 0;
+        }
+    }
+
+    /// Read more bytes after those already buffered; 0 means end of stream
+    fn fill(&mut self) -> IoResult<usize> {
+        if self.end == self.buffer.len() {
+            if self.start > 0 {
+                self.buffer.copy_within(self.start..self.end, 0);
+                self.end -= self.start;
+                self.start = 0;
+            } else if self.buffer.len() < MAX_HEAD_SIZE {
+                self.buffer.resize((self.buffer.len() * 2).min(MAX_HEAD_SIZE), 0);
+            } else {
+                return Err(protocol_error("响应头过大"));
+            }
+        }
+        let count = self.connection.read(&mut self.buffer[self.end..])?;
+        self.end += count;
+        Ok(count)
+    }
+
+    /// Copy out buffered bytes, or read large requests straight from the socket
+    fn read_into(&mut self, out: &mut [u8]) -> IoResult<usize> {
+        if self.start == self.end {
+            if out.len() >= self.buffer.len() {
+                return self.connection.read(out);
+            }
+            if self.fill()? == 0 {
+                return Ok(0);
+            }
+        }
+        let count = out.len().min(self.end - self.start);
+        out[..count].copy_from_slice(&self.buffer[self.start..self.start + count]);
+        self.consume(count);
+        Ok(count)
+    }
+
+    /// Take one line from the stream and hand it to `parse` without its line ending
+    fn take_line<R>(&mut self, parse: impl FnOnce(&[u8]) -> R) -> IoResult<R> {
+        loop {
+            if let Some(offset) = self.buffered().iter().position(|&byte| byte == b'\n') {
+                let line = &self.buffer[self.start..self.start + offset];
+                let result = parse(line.strip_suffix(b"\r").unwrap_or(line));
+                self.consume(offset + 1);
+                return Ok(result);
+            }
+            if self.end - self.start > MAX_LINE_SIZE {
+                return Err(protocol_error("分块行过长"));
+            }
+            if self.fill()? == 0 {
+                return Err(truncated_error());
+            }
+        }
+    }
+
+    /// Write all of `data`, adding every byte that went out to `sent`
+    fn write_all(&self, mut data: &[u8], sent: &mut usize) -> IoResult<()> {
+        while !data.is_empty() {
+            match self.connection.write(data)? {
+                0 => return Err(protocol_error("连接已关闭")),
+                written => {
+                    *sent += written;
+                    data = &data[written..];
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Check an idle connection before reuse: not expired, and the server
+    /// has not closed it or sent anything unsolicited
+    fn is_reusable(&self) -> bool {
+        if self.idle_since.elapsed() >= IDLE_TIMEOUT || self.start != self.end {
+            return false;
+        }
+        #[cfg(unix)]
+        {
+            use std::os::unix::io::AsRawFd;
+
+            let mut pollfd = libc::pollfd {
+                fd: self.connection.as_raw_fd(),
+                events: libc::POLLIN,
+                revents: 0,
+            };
+            if unsafe { libc::poll(&mut pollfd, 1, 0) } != 0 {
+                return false;
+            }
+        }
+        true
+    }
+}
+
+type PoolKey = (String, u16);
+
+/// Idle keep-alive connections grouped by host and port
+#[derive(Debug, Default)]
+pub struct ConnectionPool {
+    idle: Mutex<HashMap<PoolKey, Vec<PooledConnection>>>,
+}
+
+impl ConnectionPool {
+    /// Create an empty pool
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of idle connections across all hosts
+    pub fn idle_connections(&self) -> usize {
+        self.lock().values().map(Vec::len).sum()
+    }
+
+    /// Close every idle connection
+    pub fn clear(&self) {
+        self.lock().clear();
+    }
+
+    fn lock(&self) -> MutexGuard<'_, HashMap<PoolKey, Vec<PooledConnection>>> {
+        self.idle.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    fn checkout(&self, key: &PoolKey) -> Option<PooledConnection> {
+        loop {
+            // Pop under the lock, check liveness outside it
+            let connection = self.lock().get_mut(key)?.pop()?;
+            if connection.is_reusable() {
+                return Some(connection);
+            }
+        }
+    }
+
+    fn checkin(&self, key: PoolKey, mut connection: PooledConnection) {
+        connection.idle_since = Instant::now();
+        connection.reused = true;
+        let mut idle = self.lock();
+        let connections = idle.entry(key).or_default();
+        if connections.len() < MAX_IDLE_PER_HOST {
+            connections.push(connection);
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum ChunkState {
+    Size,
+    Data(u64),
+    DataEnd,
+    Trailers,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum BodyState {
+    Length(u64),
+    Chunked(ChunkState),
+    UntilClose,
+    Done,
+}
+
+/// Incrementally decoded response body
+///
+/// The connection goes back to the pool as soon as the body has been read
+/// to the end; dropping the body earlier closes the connection instead.
+#[derive(Debug)]
+pub struct ResponseBody {
+    connection: Option<PooledConnection>,
+    state: BodyState,
+    reusable: bool,
+    pool: Arc<ConnectionPool>,
+    key: PoolKey,
+}
+
+impl ResponseBody {
+    /// Check whether the whole body has been read
+    pub fn is_finished(&self) -> bool {
+        self.state == BodyState::Done
+    }
+
+    fn read_body(&mut self, out: &mut [u8]) -> IoResult<usize> {
+        if out.is_empty() {
+            return Ok(0);
+        }
+        loop {
+            if self.state == BodyState::Done {
+                self.finish();
+                return Ok(0);
+            }
+            let connection = match self.connection.as_mut() {
+                Some(connection) => connection,
+                None => return Ok(0),
+            };
+
+            let produced = match self.state {
+                BodyState::Length(remaining) => {
+                    let limit = out.len().min(remaining.min(usize::MAX as u64) as usize);
+                    let count = connection.read_into(&mut out[..limit])?;
+                    if count == 0 {
+                        return Err(truncated_error());
+                    }
+                    let left = remaining - count as u64;
+                    self.state = if left == 0 { BodyState::Done } else { BodyState::Length(left) };
+                    Some(count)
+                }
+                BodyState::UntilClose => {
+                    let count = connection.read_into(out)?;
+                    if count == 0 {
+                        self.state = BodyState::Done;
+                    }
+                    Some(count)
+                }
+                BodyState::Chunked(ChunkState::Size) => {
+                    let size = connection.take_line(http_parse::parse_chunk_size)?.map_err(protocol_error)?;
+                    self.state = BodyState::Chunked(if size == 0 { ChunkState::Trailers } else { ChunkState::Data(size) });
+                    None
+                }
+                BodyState::Chunked(ChunkState::Data(remaining)) => {
+                    let limit = out.len().min(remaining.min(usize::MAX as u64) as usize);
+                    let count = connection.read_into(&mut out[..limit])?;
+                    if count == 0 {
+                        return Err(truncated_error());
+                    }
+                    let left = remaining - count as u64;
+                    self.state = BodyState::Chunked(if left == 0 { ChunkState::DataEnd } else { ChunkState::Data(left) });
+                    Some(count)
+                }
+                BodyState::Chunked(ChunkState::DataEnd) => {
+                    if !connection.take_line(|line| line.is_empty())? {
+                        return Err(protocol_error("分块数据后缺少换行"));
+                    }
+                    self.state = BodyState::Chunked(ChunkState::Size);
+                    None
+                }
+                BodyState::Chunked(ChunkState::Trailers) => {
+                    if connection.take_line(|line| line.is_empty())? {
+                        self.state = BodyState::Done;
+                    }
+                    None
+                }
+                BodyState::Done => None,
+            };
+
+            if let Some(count) = produced {
+                if self.state == BodyState::Done {
+                    self.finish();
+                }
+                return Ok(count);
+            }
+        }
+    }
+
+    /// Return the connection to the pool if the server allows reuse
+    fn finish(&mut self) {
+        if let Some(connection) = self.connection.take() {
+            if self.reusable && connection.buffered().is_empty() {
+                self.pool.checkin(self.key.clone(), connection);
+            }
+        }
+    }
+}
+
+impl Read for ResponseBody {
+    fn read(&mut self, out: &mut [u8]) -> io::Result<usize> {
+        self.read_body(out).map_err(into_io_error)
+    }
+}
+
+fn into_io_error(error: IoError) -> io::Error {
+    match error {
+        IoError::SystemIoError(error) => error,
+        other => io::Error::new(io::ErrorKind::Other, other.to_string()),
+    }
+}
+
+/// Response whose body is read on demand
+#[derive(Debug)]
+pub struct StreamingResponse {
+    /// Status line and headers
+    pub head: ResponseHead,
+    /// Body reader
+    pub body: ResponseBody,
+    /// Time until the response head arrived
+    pub elapsed: Duration,
+}
+
+impl StreamingResponse {
+    /// Get the status code
+    pub fn status_code(&self) -> u16 {
+        self.head.status_code
+    }
+
+    /// Read the rest of the body into memory
+    pub fn read_to_end(mut self) -> IoResult<Vec<u8>> {
+        // Trust the declared length only as a capacity hint, capped
+        let hint = self.head.content_length().ok().flatten().unwrap_or(0).min(16 << 20) as usize;
+        let mut body = Vec::with_capacity(hint);
+        let mut chunk = [0u8; READ_BUFFER_SIZE];
+        loop {
+            match self.body.read_body(&mut chunk)? {
+                0 => return Ok(body),
+                count => body.extend_from_slice(&chunk[..count]),
+            }
+        }
+    }
+}
+
+impl Read for StreamingResponse {
+    fn read(&mut self, out: &mut [u8]) -> io::Result<usize> {
+        self.body.read(out)
+    }
+}
+
+/// Result of one request/response exchange on a connection
+enum ExchangeError {
+    /// The connection failed before any response byte arrived; on a pooled
+    /// connection the server most likely closed it while idle. Retrying is
+    /// safe if no request byte was `sent` or the method is idempotent.
+    Stale { error: IoError, sent: bool },
+    Failed(IoError),
+}
+
+/// Keep-alive HTTP/1.1 transport shared by all requests of an `HttpClient`
+#[derive(Debug, Default)]
+pub struct HttpTransport {
+    pool: Arc<ConnectionPool>,
+}
+
+impl HttpTransport {
+    /// Create a transport with an empty pool
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Get the connection pool
+    pub fn pool(&self) -> &ConnectionPool {
+        &self.pool
+    }
+
+    /// Send `request` and return once the response head has arrived
+    pub fn send(&self, request: &HttpRequest) -> IoResult<StreamingResponse> {
+        let start_time = Instant::now();
+        let url = HttpUrl::parse(&request.url)?;
+        let key = (url.host.to_string(), url.port);
+
+        let body = request.body.as_deref().unwrap_or(&[]);
+        let mut message = Vec::with_capacity(256 + body.len().min(INLINE_BODY_SIZE));
+        write_request_head(&mut message, request, &url);
+        let inline_body = body.len() <= INLINE_BODY_SIZE;
+        if inline_body {
+            message.extend_from_slice(body);
+        }
+        let trailing_body = if inline_body { &[][..] } else { body };
+
+        let mut pooled = self.pool.checkout(&key);
+        loop {
+            let connection = match pooled.take() {
+                Some(connection) => connection,
+                None => PooledConnection::connect(&url, request.timeout)?,
+            };
+            let reused = connection.reused;
+            match exchange(connection, &message, trailing_body, request.timeout) {
+                Ok((connection, head)) => {
+                    let state = body_state(&head, request.method)?;
+                    // After a 101 the connection speaks another protocol
+                    let reusable = head.keep_alive()
+                        && state != BodyState::UntilClose
+                        && !(100..200).contains(&head.status_code);
+                    let mut body = ResponseBody {
+                        connection: Some(connection),
+                        state,
+                        reusable,
+                        pool: Arc::clone(&self.pool),
+                        key,
+                    };
+                    if body.state == BodyState::Done {
+                        body.finish();
+                    }
+                    return Ok(StreamingResponse {
+                        head,
+                        body,
+                        elapsed: start_time.elapsed(),
+                    });
+                }
+                // Retry once on a fresh connection, unless a non-idempotent
+                // request may already have reached the server
+                Err(ExchangeError::Stale { sent, .. }) if reused && (!sent || request.method.is_idempotent()) => {
+                    continue
+                }
+                Err(ExchangeError::Stale { error, .. }) | Err(ExchangeError::Failed(error)) => return Err(error),
+            }
+        }
+    }
+}
+
+fn exchange(
+    mut connection: PooledConnection,
+    message: &[u8],
+    trailing_body: &[u8],
+    timeout: Duration,
+) -> Result<(PooledConnection, ResponseHead), ExchangeError> {
+    let timeout = if timeout.is_zero() { None } else { Some(timeout) };
+    connection.connection.set_timeout(timeout).map_err(ExchangeError::Failed)?;
+
+    let mut sent = 0;
+    if let Err(error) = connection.write_all(message, &mut sent) {
+        return Err(ExchangeError::Stale { error, sent: sent > 0 });
+    }
+    connection.write_all(trailing_body, &mut sent).map_err(ExchangeError::Failed)?;
+
+    let mut received = false;
+    loop {
+        match ResponseHead::parse(connection.buffered()) {
+            Ok(Some((head, length))) => {
+                connection.consume(length);
+                // Skip interim responses such as 100 Continue
+                if (100..200).contains(&head.status_code) && head.status_code != 101 {
+                    continue;
+                }
+                return Ok((connection, head));
+            }
+            Ok(None) => {}
+            Err(error) => return Err(ExchangeError::Failed(error)),
+        }
+        match connection.fill() {
+            Ok(0) if !received => {
+                return Err(ExchangeError::Stale { error: protocol_error("连接在响应前关闭"), sent: true })
+            }
+            Ok(0) => return Err(ExchangeError::Failed(protocol_error("响应头不完整"))),
+            Ok(_) => received = true,
+            Err(error) if !received => return Err(ExchangeError::Stale { error, sent: true }),
+            Err(error) => return Err(ExchangeError::Failed(error)),
+        }
+    }
+}
+
+fn body_state(head: &ResponseHead, method: HttpMethod) -> IoResult<BodyState> {
+    if method == HttpMethod::Head || matches!(head.status_code, 100..=199 | 204 | 304) {
+        return Ok(BodyState::Done);
+    }
+    if head.headers.has_transfer_encoding() {
+        // Any coding other than a final chunked is delimited by close
+        return Ok(if head.headers.is_chunked() { BodyState::Chunked(ChunkState::Size) } else { BodyState::UntilClose });
+    }
+    Ok(match head.content_length()? {
+        Some(0) => BodyState::Done,
+        Some(length) => BodyState::Length(length),
+        None => BodyState::UntilClose,
+    })
+}
+
+fn write_request_head(out: &mut Vec<u8>, request: &HttpRequest, url: &HttpUrl<'_>) {
+    let has_header = |name: &str| request.headers.keys().any(|header| header.eq_ignore_ascii_case(name));
+
+    out.extend_from_slice(request.method.as_str().as_bytes());
+    out.push(b' ');
+    if !url.target.starts_with('/') {
+        out.push(b'/');
+    }
+    out.extend_from_slice(url.target.as_bytes());
+    out.extend_from_slice(b" HTTP/1.1\r\n");
+
+    if !has_header("host") {
+        out.extend_from_slice(b"Host: ");
+        url.write_authority(out, false);
+        out.extend_from_slice(b"\r\n");
+    }
+    for (name, value) in &request.headers {
+        // Refuse header injection through embedded line breaks
+        if name.is_empty() || !name.bytes().all(http_parse::is_token_byte) || value.contains(['\r', '\n']) {
+            continue;
+        }
+        let _ = write!(out, "{}: {}\r\n", name, value);
+    }
+    let sends_body = request.body.is_some()
+        || matches!(request.method, HttpMethod::Post | HttpMethod::Put | HttpMethod::Patch);
+    if sends_body && !has_header("content-length") {
+        let _ = write!(out, "Content-Length: {}\r\n", request.body.as_ref().map_or(0, Vec::len));
+    }
+    out.extend_from_slice(b"\r\n");
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::{BufRead, BufReader};
+    use std::net::{TcpListener, TcpStream};
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    const 大响应长度: usize = 8 << 20;
+
+    /// 进程内 HTTP 测试服务器，按路径返回不同编码的响应
+    struct 测试服务器 {
+        端口: u16,
+        连接数: Arc<AtomicUsize>,
+    }
+
+    impl 测试服务器 {
+        fn 启动() -> Self {
+            let 监听器 = TcpListener::bind("127.0.0.1:0").unwrap();
+            let 端口 = 监听器.local_addr().unwrap().port();
+            let 连接数 = Arc::new(AtomicUsize::new(0));
+            let 计数 = Arc::clone(&连接数);
+            std::thread::spawn(move || {
+                for 流 in 监听器.incoming() {
+                    let 流 = match 流 {
+                        Ok(流) => 流,
+                        Err(_) => break,
+                    };
+                    计数.fetch_add(1, Ordering::SeqCst);
+                    std::thread::spawn(move || Self::处理连接(流));
+                }
+            });
+            Self { 端口, 连接数 }
+        }
+
+        fn 地址(&self, 路径: &str) -> String {
+            format!("http://127.0.0.1:{}{}", self.端口, 路径)
+        }
+
+        fn 处理连接(流: TcpStream) {
+            let mut 读取器 = BufReader::new(流.try_clone().unwrap());
+            let mut 写入器 = 流;
+            let mut 挂断 = false;
+            loop {
+                let mut 请求行 = String::new();
+                if 读取器.read_line(&mut 请求行).unwrap_or(0) == 0 {
+                    return;
+                }
+                let 路径 = 请求行.split_whitespace().nth(1).unwrap_or("/").to_string();
+                let mut 请求体长度 = 0;
+                loop {
+                    let mut 行 = String::new();
+                    读取器.read_line(&mut 行).unwrap();
+                    if 行.trim().is_empty() {
+                        break;
+                    }
+                    if let Some((名称, 值)) = 行.split_once(':') {
+                        if 名称.eq_ignore_ascii_case("content-length") {
+                            请求体长度 = 值.trim().parse().unwrap();
+                        }
+                    }
+                }
+                let mut 请求体 = vec![0u8; 请求体长度];
+                读取器.read_exact(&mut 请求体).unwrap();
+                if 挂断 {
+                    // 读完请求后不回复直接关闭，模拟空闲连接被服务器关闭的竞争
+                    return;
+                }
+
+                match 路径.as_str() {
+                    "/length" => {
+                        写入器.write_all(b"HTTP/1.1 200 OK\r\nContent-Length: 5\r\nX-Test: a\r\n\r\nhello").unwrap();
+                    }
+                    "/chunked" => {
+                        // 逐字节发送，检验增量解码
+                        let 响应 = b"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n4\r\nWiki\r\n5;ext=1\r\npedia\r\n0\r\nX-Trailer: y\r\n\r\n";
+                        for 字节 in 响应.iter() {
+                            写入器.write_all(std::slice::from_ref(字节)).unwrap();
+                        }
+                    }
+                    "/close" => {
+                        写入器.write_all(b"HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nuntil close").unwrap();
+                        return;
+                    }
+                    "/once" => {
+                        // 声明保持连接，但回复后立即关闭
+                        写入器.write_all(b"HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nonce").unwrap();
+                        return;
+                    }
+                    "/large" => {
+                        写入器.write_all(b"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n").unwrap();
+                        let 块: Vec<u8> = (0..65536).map(|i| (i % 251) as u8).collect();
+                        for _ in 0..大响应长度 / 块.len() {
+                            write!(写入器, "{:x}\r\n", 块.len()).unwrap();
+                            写入器.write_all(&块).unwrap();
+                            写入器.write_all(b"\r\n").unwrap();
+                        }
+                        写入器.write_all(b"0\r\n\r\n").unwrap();
+                    }
+                    "/hangup" => {
+                        写入器.write_all(b"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello").unwrap();
+                        挂断 = true;
+                    }
+                    "/upgrade" => {
+                        写入器.write_all(b"HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: test\r\n\r\n").unwrap();
+                    }
+                    "/redirect" => {
+                        写入器.write_all(b"HTTP/1.1 303 See Other\r\nLocation: /length\r\nContent-Length: 0\r\n\r\n").unwrap();
+                    }
+                    "/echo" => {
+                        write!(写入器, "HTTP/1.1 201 Created\r\nContent-Length: {}\r\n\r\n", 请求体.len()).unwrap();
+                        写入器.write_all(&请求体).unwrap();
+                    }
+                    _ => {
+                        写入器.write_all(b"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n").unwrap();
+                    }
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_parse_url() {
+        let url = HttpUrl::parse("http://example.com:8080/a/b?x=1#frag").unwrap();
+        assert_eq!((url.host, url.port, url.target), ("example.com", 8080, "/a/b?x=1"));
+
+        let url = HttpUrl::parse("HTTP://[::1]?q").unwrap();
+        assert_eq!((url.host, url.port, url.target), ("::1", 80, "?q"));
+
+        assert!(HttpUrl::parse("https://example.com").is_err());
+        assert!(HttpUrl::parse("ftp://example.com").is_err());
+        assert!(HttpUrl::parse("http://host:port/").is_err());
+
+        assert_eq!(resolve_location("http://h:81/a/b", "/c").unwrap(), "http://h:81/c");
+        assert_eq!(resolve_location("http://h/a/b", "c").unwrap(), "http://h/a/c");
+        assert_eq!(resolve_location("http://h/a", "http://o/p").unwrap(), "http://o/p");
+    }
+
+    #[test]
+    fn test_parse_response_head() {
+        let 响应 = b"HTTP/1.1 200 OK\r\nContent-Length: 3\r\nConnection: Keep-Alive, Upgrade\r\nX-Empty:\r\n\r\nabc";
+        assert!(ResponseHead::parse(&响应[..20]).unwrap().is_none());
+
+        let (head, length) = ResponseHead::parse(响应).unwrap().unwrap();
+        assert_eq!(length, 响应.len() - 3);
+        assert_eq!((head.status_code, head.minor_version, head.reason()), (200, 1, "OK"));
+        assert_eq!(head.header("content-length"), Some(&b"3"[..]));
+        assert_eq!(head.header_str("X-EMPTY"), Some(""));
+        assert!(head.has_token("connection", "keep-alive"));
+        assert!(head.keep_alive());
+        assert_eq!(head.content_length().unwrap(), Some(3));
+        assert_eq!(head.headers().count(), 3);
+
+        let (head, _) = ResponseHead::parse(b"HTTP/1.0 204\n\n").unwrap().unwrap();
+        assert_eq!((head.status_code, head.reason()), (204, ""));
+        assert!(!head.keep_alive());
+
+        assert!(ResponseHead::parse(b"HTTP/2 200 OK\r\n\r\n").is_err());
+        assert!(ResponseHead::parse(b"HTTP/1.1 200 OK\r\nBad Header: x\r\n\r\n").is_err());
+        assert!(ResponseHead::parse(b"HTTP/1.1 200 OK\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n")
+            .unwrap()
+            .unwrap()
+            .0
+            .content_length()
+            .is_err());
+    }
+
+    #[test]
+    fn test_keep_alive_reuses_connection() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+        for _ in 0..5 {
+            let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/length"))).unwrap();
+            assert_eq!(响应.status_code(), 200);
+            assert_eq!(响应.head.header_str("x-test"), Some("a"));
+            assert_eq!(响应.read_to_end().unwrap(), b"hello");
+        }
+        assert_eq!(服务器.连接数.load(Ordering::SeqCst), 1);
+        assert_eq!(传输.pool().idle_connections(), 1);
+
+        // 未读完就丢弃的响应不会把连接放回连接池
+        let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/large"))).unwrap();
+        drop(响应);
+        assert_eq!(传输.pool().idle_connections(), 0);
+    }
+
+    #[test]
+    fn test_chunked_close_and_post_bodies() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+
+        let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/chunked"))).unwrap();
+        assert_eq!(响应.read_to_end().unwrap(), b"Wikipedia");
+        assert_eq!(传输.pool().idle_connections(), 1);
+
+        let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/close"))).unwrap();
+        assert_eq!(响应.read_to_end().unwrap(), b"until close");
+        assert_eq!(传输.pool().idle_connections(), 0);
+
+        let 请求体: Vec<u8> = (0..200_000u32).map(|i| i as u8).collect();
+        let 响应 = 传输.send(&HttpRequest::post(服务器.地址("/echo"), 请求体.clone())).unwrap();
+        assert_eq!(响应.status_code(), 201);
+        assert_eq!(响应.read_to_end().unwrap(), 请求体);
+
+        let mut 请求 = HttpRequest::get(服务器.地址("/length"));
+        请求.method = HttpMethod::Head;
+        let 响应 = 传输.send(&请求).unwrap();
+        assert!(响应.body.is_finished());
+    }
+
+    #[test]
+    fn test_streams_large_body() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+        let mut 响应 = 传输.send(&HttpRequest::get(服务器.地址("/large"))).unwrap();
+
+        let mut 缓冲区 = [0u8; 4096];
+        let mut 总长度 = 0;
+        loop {
+            let n = 响应.read(&mut 缓冲区).unwrap();
+            if n == 0 {
+                break;
+            }
+            for (偏移, &字节) in 缓冲区[..n].iter().enumerate() {
+                assert_eq!(字节, (((总长度 + 偏移) % 65536) % 251) as u8);
+            }
+            总长度 += n;
+        }
+        assert_eq!(总长度, 大响应长度);
+        assert_eq!(传输.pool().idle_connections(), 1);
+    }
+
+    #[test]
+    fn test_closed_idle_connection_is_replaced() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+        for _ in 0..3 {
+            let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/once"))).unwrap();
+            assert_eq!(响应.read_to_end().unwrap(), b"once");
+        }
+        assert_eq!(服务器.连接数.load(Ordering::SeqCst), 3);
+    }
+
+    #[test]
+    fn test_stale_connection_retry_respects_idempotency() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+
+        // GET 可以在新连接上重发
+        传输.send(&HttpRequest::get(服务器.地址("/hangup"))).unwrap().read_to_end().unwrap();
+        let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/length"))).unwrap();
+        assert_eq!(响应.read_to_end().unwrap(), b"hello");
+        assert_eq!(服务器.连接数.load(Ordering::SeqCst), 2);
+
+        // POST 已经发出，不能重发
+        传输.send(&HttpRequest::get(服务器.地址("/hangup"))).unwrap().read_to_end().unwrap();
+        assert!(传输.send(&HttpRequest::post(服务器.地址("/echo"), b"once".to_vec())).is_err());
+        assert_eq!(服务器.连接数.load(Ordering::SeqCst), 2);
+    }
+
+    #[test]
+    fn test_upgrade_response_is_not_pooled() {
+        let 服务器 = 测试服务器::启动();
+        let 传输 = HttpTransport::new();
+        let 响应 = 传输.send(&HttpRequest::get(服务器.地址("/upgrade"))).unwrap();
+        assert_eq!(响应.status_code(), 101);
+        assert!(响应.body.is_finished());
+        assert_eq!(传输.pool().idle_connections(), 0);
+    }
+
+    #[test]
+    fn test_redirect_through_client() {
+        let 服务器 = 测试服务器::启动();
+        let 客户端 = super::super::http::HttpClient::new();
+        let 响应 = 客户端.execute(HttpRequest::get(服务器.地址("/redirect"))).unwrap();
+        assert_eq!(响应.status_code, 200);
+        assert_eq!(响应.redirect_count, 1);
+        assert_eq!(响应.body, b"hello");
+        assert_eq!(响应.get_header("x-test").map(String::as_str), Some("a"));
+        assert_eq!(服务器.连接数.load(Ordering::SeqCst), 1);
+
+        let 响应 = 客户端.execute(HttpRequest::get(服务器.地址("/missing"))).unwrap();
+        assert_eq!(响应.status_code, 404);
+        assert!(!响应.is_success());
+    }
+}
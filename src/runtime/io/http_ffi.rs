@@ -1,25 +1,27 @@
 //! HTTP 模块 FFI 接口
 //!
-//! 为 Qi 语言提供 C 接口的 HTTP 客户端操作
+//! 为 Qi 语言提供 C 接口的 HTTP 客户端与服务器操作
 
 use super::http::{HttpClient, HttpRequest, HttpMethod};
+use super::http_server::{HttpServer, HttpServerConfig, Request, Response, Router};
+use super::slab::HandleSlab;
 use std::ffi::{CStr, CString};
-use std::os::raw::c_char;
-use std::time::Duration;
-use std::sync::OnceLock;
+use std::os::raw::{c_char, c_void};
+use std::time::{Duration, Instant};
+use std::sync::{Arc, Condvar, OnceLock, RwLock};
 use std::sync::Mutex;
-use std::collections::HashMap;
+use std::collections::{HashMap, VecDeque};
 
-// 全局 HTTP 客户端
-static HTTP客户端: OnceLock<Mutex<HttpClient>> = OnceLock::new();
+// 全局 HTTP 客户端；内部自带连接池，请求之间无需加锁
+static HTTP客户端: OnceLock<HttpClient> = OnceLock::new();
 
 // HTTP 请求池（用于异步请求管理）
 static HTTP请求池: OnceLock<Mutex<HashMap<i64, HttpRequest>>> = OnceLock::new();
 static 请求句柄计数器: OnceLock<Mutex<i64>> = OnceLock::new();
 
 #[allow(non_snake_case)]
-fn 获取HTTP客户端() -> &'static Mutex<HttpClient> {
-    HTTP客户端.get_or_init(|| Mutex::new(HttpClient::new()))
+pub(crate) fn 获取HTTP客户端() -> &'static HttpClient {
+    HTTP客户端.get_or_init(HttpClient::new)
 }
 
 fn 获取请求池() -> &'static Mutex<HashMap<i64, HttpRequest>> {
@@ -30,6 +32,46 @@ fn 获取请求句柄计数器() -> &'static Mutex<i64> {
     请求句柄计数器.get_or_init(|| Mutex::new(0))
 }
 
+// HTTP 服务器表：服务线程持有 Arc，关闭句柄后服务随之停止
+static HTTP服务器表: OnceLock<HandleSlab<Arc<服务器状态>>> = OnceLock::new();
+
+// 待回复请求表：连接线程等待回复槽，处理函数通过请求句柄回复
+static 待回复请求表: OnceLock<HandleSlab<待回复请求>> = OnceLock::new();
+
+/// 等待回复的检查间隔，用于发现服务器已关闭
+const 回复检查间隔: Duration = Duration::from_millis(100);
+
+struct 服务器状态 {
+    服务器: HttpServer,
+    路由: RwLock<Router>,
+    // 未匹配路由的请求排队，等待 qi_http_server_next_request 取走
+    队列: Mutex<VecDeque<i64>>,
+    队列信号: Condvar,
+}
+
+#[derive(Default)]
+struct 回复槽 {
+    响应: Mutex<Option<Response>>,
+    信号: Condvar,
+}
+
+struct 待回复请求 {
+    请求: Request,
+    回复: Arc<回复槽>,
+}
+
+fn 获取服务器表() -> &'static HandleSlab<Arc<服务器状态>> {
+    HTTP服务器表.get_or_init(HandleSlab::new)
+}
+
+fn 查找服务器(句柄: i64) -> Option<Arc<服务器状态>> {
+    获取服务器表().with(句柄, |状态| Arc::clone(状态))
+}
+
+fn 获取待回复请求表() -> &'static HandleSlab<待回复请求> {
+    待回复请求表.get_or_init(HandleSlab::new)
+}
+
 /// 初始化 HTTP 模块
 #[no_mangle]
 pub extern "C" fn qi_http_init() -> i64 {
@@ -49,7 +91,7 @@ pub extern "C" fn qi_http_get(url: *const c_char) -> *mut c_char {
         let 地址 = CStr::from_ptr(url).to_string_lossy().to_string();
         let 请求 = HttpRequest::get(地址);
 
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => {
                 match 响应.body_as_string() {
@@ -76,7 +118,7 @@ pub extern "C" fn qi_http_post(url: *const c_char, body: *const c_char) -> *mut
 
         let 请求 = HttpRequest::post(地址, 请求体.into_bytes());
 
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => {
                 match 响应.body_as_string() {
@@ -104,7 +146,7 @@ pub extern "C" fn qi_http_put(url: *const c_char, body: *const c_char) -> *mut c
         请求.method = HttpMethod::Put;
         请求.body = Some(请求体.into_bytes());
 
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => {
                 match 响应.body_as_string() {
@@ -130,7 +172,7 @@ pub extern "C" fn qi_http_delete(url: *const c_char) -> *mut c_char {
         let mut 请求 = HttpRequest::get(地址);
         请求.method = HttpMethod::Delete;
 
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => {
                 match 响应.body_as_string() {
@@ -244,9 +286,9 @@ pub extern "C" fn qi_http_request_set_timeout(handle: i64, timeout_ms: i64) -> i
 /// 返回响应体字符串（需要调用 qi_http_free_string 释放）
 #[no_mangle]
 pub extern "C" fn qi_http_request_execute(handle: i64) -> *mut c_char {
-    let mut 请求池 = 获取请求池().lock().unwrap();
-    if let Some(请求) = 请求池.remove(&handle) {
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+    let 请求 = 获取请求池().lock().unwrap().remove(&handle);
+    if let Some(请求) = 请求 {
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => {
                 match 响应.body_as_string() {
@@ -272,7 +314,7 @@ pub extern "C" fn qi_http_get_status(url: *const c_char) -> i64 {
         let 地址 = CStr::from_ptr(url).to_string_lossy().to_string();
         let 请求 = HttpRequest::get(地址);
 
-        let 客户端 = 获取HTTP客户端().lock().unwrap();
+        let 客户端 = 获取HTTP客户端();
         match 客户端.execute(请求) {
             Ok(响应) => 响应.status_code as i64,
             Err(_) => -1,
@@ -290,6 +332,244 @@ pub extern "C" fn qi_http_free_string(s: *mut c_char) {
     }
 }
 
+/// 创建 HTTP 服务器并在后台开始服务
+/// 端口为 0 时自动选择；未匹配路由的请求由 qi_http_server_next_request 取走
+/// 返回服务器句柄（>0 成功，<0 失败）
+#[no_mangle]
+pub extern "C" fn qi_http_server_create(host: *const c_char, port: u16) -> i64 {
+    if host.is_null() {
+        return -1;
+    }
+
+    let 主机 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    let 服务器 = match HttpServer::bind(HttpServerConfig::new(主机, port)) {
+        Ok(服务器) => 服务器,
+        Err(_) => return -1,
+    };
+    let 状态 = Arc::new(服务器状态 {
+        服务器,
+        路由: RwLock::new(Router::new()),
+        队列: Mutex::new(VecDeque::new()),
+        队列信号: Condvar::new(),
+    });
+    let 句柄 = match 获取服务器表().insert(Arc::clone(&状态)) {
+        Some(句柄) => 句柄,
+        None => return -1,
+    };
+
+    std::thread::spawn(move || {
+        let 结果 = 状态.服务器.serve(|请求| {
+            let 路由 = 状态.路由.read().unwrap_or_else(|poisoned| poisoned.into_inner());
+            match 路由.try_dispatch(请求) {
+                Ok(响应) => 响应,
+                Err(请求) => {
+                    drop(路由);
+                    排队等待回复(&状态, 请求)
+                }
+            }
+        });
+        if 结果.is_err() {
+            qi_http_server_close(句柄);
+        }
+    });
+    句柄
+}
+
+/// 为 method 与 path 注册处理函数；path 以 * 结尾时按前缀匹配，method 为 * 时匹配任意方法
+/// 每个请求在其连接线程上调用 handler(请求句柄)，处理函数须调用 qi_http_server_respond，
+/// 未回复时返回 500
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_http_server_route(
+    server: i64,
+    method: *const c_char,
+    path: *const c_char,
+    handler: *const c_void,
+) -> i64 {
+    if method.is_null() || path.is_null() || handler.is_null() {
+        return 0;
+    }
+    let 状态 = match 查找服务器(server) {
+        Some(状态) => 状态,
+        None => return 0,
+    };
+
+    let 方法 = unsafe { CStr::from_ptr(method).to_string_lossy().to_string() };
+    let 路径 = unsafe { CStr::from_ptr(path).to_string_lossy().to_string() };
+    let 处理函数 = unsafe { std::mem::transmute::<*const c_void, extern "C" fn(i64)>(handler) };
+    let mut 路由 = 状态.路由.write().unwrap_or_else(|poisoned| poisoned.into_inner());
+    路由.add(&方法, &路径, move |请求| 调用处理函数(处理函数, 请求));
+    1
+}
+
+fn 调用处理函数(处理函数: extern "C" fn(i64), 请求: Request) -> Response {
+    let 回复 = Arc::new(回复槽::default());
+    let 句柄 = match 获取待回复请求表().insert(待回复请求 { 请求, 回复: Arc::clone(&回复) }) {
+        Some(句柄) => 句柄,
+        None => return Response::text(503, "Service Unavailable"),
+    };
+    处理函数(句柄);
+    获取待回复请求表().remove(句柄);
+    let 响应 = 回复.响应.lock().unwrap_or_else(|poisoned| poisoned.into_inner()).take();
+    响应.unwrap_or_else(|| Response::text(500, "Internal Server Error"))
+}
+
+fn 排队等待回复(状态: &服务器状态, 请求: Request) -> Response {
+    let 回复 = Arc::new(回复槽::default());
+    let 句柄 = match 获取待回复请求表().insert(待回复请求 { 请求, 回复: Arc::clone(&回复) }) {
+        Some(句柄) => 句柄,
+        None => return Response::text(503, "Service Unavailable"),
+    };
+    状态.队列.lock().unwrap_or_else(|poisoned| poisoned.into_inner()).push_back(句柄);
+    状态.队列信号.notify_one();
+
+    let mut 响应 = 回复.响应.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+    loop {
+        if let Some(响应) = 响应.take() {
+            return 响应;
+        }
+        // 服务器关闭时收回请求；若已被处理函数取走，则继续等它回复
+        if 状态.服务器.is_closed() && 获取待回复请求表().remove(句柄).is_some() {
+            return Response::text(503, "Service Unavailable");
+        }
+        响应 = 回复.信号.wait_timeout(响应, 回复检查间隔)
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .0;
+    }
+}
+
+/// 获取服务器实际绑定的端口
+#[no_mangle]
+pub extern "C" fn qi_http_server_port(server: i64) -> i64 {
+    match 查找服务器(server) {
+        Some(状态) => 状态.服务器.local_addr().port() as i64,
+        None => -1,
+    }
+}
+
+/// 等待下一个未匹配路由的请求，可在协程中调用 qi_http_server_respond 回复
+/// timeout_ms < 0 表示一直等待
+/// 返回请求句柄（>0 成功，0 超时，<0 失败或服务器已关闭）
+#[no_mangle]
+pub extern "C" fn qi_http_server_next_request(server: i64, timeout_ms: i64) -> i64 {
+    let 状态 = match 查找服务器(server) {
+        Some(状态) => 状态,
+        None => return -1,
+    };
+
+    let 截止 = (timeout_ms >= 0).then(|| Instant::now() + Duration::from_millis(timeout_ms as u64));
+    let mut 队列 = 状态.队列.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+    loop {
+        if let Some(句柄) = 队列.pop_front() {
+            return 句柄;
+        }
+        if 状态.服务器.is_closed() {
+            return -1;
+        }
+        let 等待 = match 截止 {
+            Some(截止) => match 截止.checked_duration_since(Instant::now()) {
+                Some(剩余) if !剩余.is_zero() => 剩余.min(回复检查间隔),
+                _ => return 0,
+            },
+            None => 回复检查间隔,
+        };
+        队列 = 状态.队列信号.wait_timeout(队列, 等待)
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .0;
+    }
+}
+
+fn 读取请求<R>(请求: i64, 读取: impl FnOnce(&Request) -> R) -> Option<R> {
+    获取待回复请求表().with(请求, |待回复| 读取(&待回复.请求))
+}
+
+fn 转换为字符串指针(内容: &[u8]) -> *mut c_char {
+    // C 字符串在第一个 NUL 处截断
+    let 长度 = 内容.iter().position(|&字节| 字节 == 0).unwrap_or(内容.len());
+    CString::new(&内容[..长度]).map_or(std::ptr::null_mut(), CString::into_raw)
+}
+
+/// 获取请求方法
+/// 返回字符串（需要调用 qi_http_free_string 释放），句柄无效时返回空指针
+#[no_mangle]
+pub extern "C" fn qi_http_server_request_method(request: i64) -> *mut c_char {
+    读取请求(request, |请求| 转换为字符串指针(请求.method().as_bytes())).unwrap_or(std::ptr::null_mut())
+}
+
+/// 获取请求路径（含查询字符串）
+/// 返回字符串（需要调用 qi_http_free_string 释放），句柄无效时返回空指针
+#[no_mangle]
+pub extern "C" fn qi_http_server_request_path(request: i64) -> *mut c_char {
+    读取请求(request, |请求| 转换为字符串指针(请求.target().as_bytes())).unwrap_or(std::ptr::null_mut())
+}
+
+/// 获取请求头，名称不区分大小写
+/// 返回字符串（需要调用 qi_http_free_string 释放），不存在时返回空指针
+#[no_mangle]
+pub extern "C" fn qi_http_server_request_header(request: i64, name: *const c_char) -> *mut c_char {
+    if name.is_null() {
+        return std::ptr::null_mut();
+    }
+    let 名称 = unsafe { CStr::from_ptr(name).to_string_lossy().to_string() };
+    读取请求(request, |请求| 请求.header(&名称).map(转换为字符串指针))
+        .flatten()
+        .unwrap_or(std::ptr::null_mut())
+}
+
+/// 获取请求体
+/// 返回字符串（需要调用 qi_http_free_string 释放），句柄无效时返回空指针
+#[no_mangle]
+pub extern "C" fn qi_http_server_request_body(request: i64) -> *mut c_char {
+    读取请求(request, |请求| 转换为字符串指针(请求.body())).unwrap_or(std::ptr::null_mut())
+}
+
+/// 回复请求，回复后请求句柄失效
+/// content_type 为空指针时使用 text/plain
+/// 返回 1 成功，0 失败（句柄无效或已回复）
+#[no_mangle]
+pub extern "C" fn qi_http_server_respond(
+    request: i64,
+    status: i64,
+    content_type: *const c_char,
+    body: *const c_char,
+) -> i64 {
+    let 待回复 = match 获取待回复请求表().remove(request) {
+        Some(待回复) => 待回复,
+        None => return 0,
+    };
+
+    let 状态码 = if (100..=999).contains(&status) { status as u16 } else { 500 };
+    let 类型 = if content_type.is_null() {
+        "text/plain; charset=utf-8".to_string()
+    } else {
+        unsafe { CStr::from_ptr(content_type).to_string_lossy().to_string() }
+    };
+    let 内容 = if body.is_null() {
+        Vec::new()
+    } else {
+        unsafe { CStr::from_ptr(body).to_bytes().to_vec() }
+    };
+    let 响应 = Response::new(状态码).with_header("Content-Type", &类型).with_body(内容);
+
+    *待回复.回复.响应.lock().unwrap_or_else(|poisoned| poisoned.into_inner()) = Some(响应);
+    待回复.回复.信号.notify_one();
+    1
+}
+
+/// 关闭服务器，等待中的 qi_http_server_next_request 与未回复请求随之返回
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_http_server_close(server: i64) -> i64 {
+    match 获取服务器表().remove(server) {
+        Some(状态) => {
+            状态.服务器.close();
+            状态.队列信号.notify_all();
+            1
+        }
+        None => 0,
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -303,17 +583,30 @@ mod tests {
 
     #[test]
     fn test_http_get() {
+        use std::io::{Read, Write};
+
         qi_http_init();
 
-        let url = CString::new("https://example.com").unwrap();
+        // 本地服务器回复一次后关闭
+        let 监听器 = std::net::TcpListener::bind("127.0.0.1:0").unwrap();
+        let 端口 = 监听器.local_addr().unwrap().port();
+        let 服务器 = std::thread::spawn(move || {
+            let (mut 流, _) = 监听器.accept().unwrap();
+            let mut 请求 = [0u8; 1024];
+            let _ = 流.read(&mut 请求).unwrap();
+            流.write_all(b"HTTP/1.1 200 OK\r\nContent-Length: 13\r\nConnection: close\r\n\r\nHello, World!").unwrap();
+        });
+
+        let url = CString::new(format!("http://127.0.0.1:{}/", 端口)).unwrap();
         let response = qi_http_get(url.as_ptr());
+        assert!(!response.is_null());
+        let response_str = unsafe { CStr::from_ptr(response).to_string_lossy().into_owned() };
+        assert_eq!(response_str, "Hello, World!");
+        qi_http_free_string(response);
+        服务器.join().unwrap();
 
-        // 在模拟实现中应该返回 "Hello, World!"
-        if !response.is_null() {
-            let response_str = unsafe { CStr::from_ptr(response).to_string_lossy() };
-            assert_eq!(response_str, "Hello, World!");
-            qi_http_free_string(response);
-        }
+        let url = CString::new("https://example.com").unwrap();
+        assert!(qi_http_get(url.as_ptr()).is_null());
     }
 
     #[test]
@@ -337,4 +630,74 @@ mod tests {
         let result = qi_http_request_set_timeout(handle, 5000);
         assert_eq!(result, 1);
     }
+
+    extern "C" fn 问候处理(请求: i64) {
+        let 方法 = qi_http_server_request_method(请求);
+        let 内容 = format!("{}:你好", unsafe { CStr::from_ptr(方法).to_string_lossy() });
+        qi_http_free_string(方法);
+        let 内容 = CString::new(内容).unwrap();
+        assert_eq!(qi_http_server_respond(请求, 200, std::ptr::null(), 内容.as_ptr()), 1);
+    }
+
+    extern "C" fn 不回复处理(_请求: i64) {}
+
+    #[test]
+    fn test_http_server_routes_and_queue() {
+        let 主机 = CString::new("127.0.0.1").unwrap();
+        let 服务器 = qi_http_server_create(主机.as_ptr(), 0);
+        assert!(服务器 > 0);
+        let 端口 = qi_http_server_port(服务器);
+
+        let 方法 = CString::new("GET").unwrap();
+        let 路径 = CString::new("/hello").unwrap();
+        assert_eq!(qi_http_server_route(服务器, 方法.as_ptr(), 路径.as_ptr(), 问候处理 as *const c_void), 1);
+        let 任意 = CString::new("*").unwrap();
+        let 前缀 = CString::new("/silent/*").unwrap();
+        assert_eq!(qi_http_server_route(服务器, 任意.as_ptr(), 前缀.as_ptr(), 不回复处理 as *const c_void), 1);
+        assert_eq!(qi_http_server_next_request(服务器, 10), 0);
+
+        // 未匹配路由的请求由等待请求的一方回复
+        let 处理者 = std::thread::spawn(move || {
+            let 请求 = qi_http_server_next_request(服务器, 5000);
+            assert!(请求 > 0);
+            let 路径 = qi_http_server_request_path(请求);
+            let 头名 = CString::new("x-name").unwrap();
+            let 头 = qi_http_server_request_header(请求, 头名.as_ptr());
+            let 请求体 = qi_http_server_request_body(请求);
+            let 内容 = unsafe {
+                format!(
+                    "{}|{}|{}",
+                    CStr::from_ptr(路径).to_string_lossy(),
+                    CStr::from_ptr(头).to_string_lossy(),
+                    CStr::from_ptr(请求体).to_string_lossy()
+                )
+            };
+            for 字符串 in [路径, 头, 请求体] {
+                qi_http_free_string(字符串);
+            }
+            let 类型 = CString::new("application/json").unwrap();
+            let 内容 = CString::new(内容).unwrap();
+            assert_eq!(qi_http_server_respond(请求, 201, 类型.as_ptr(), 内容.as_ptr()), 1);
+            assert_eq!(qi_http_server_respond(请求, 201, 类型.as_ptr(), 内容.as_ptr()), 0);
+        });
+
+        let 客户端 = 获取HTTP客户端();
+        let 响应 = 客户端.execute(HttpRequest::get(format!("http://127.0.0.1:{}/hello", 端口))).unwrap();
+        assert_eq!(响应.status_code, 200);
+        assert_eq!(响应.body_as_string().unwrap(), "GET:你好");
+
+        let 请求 = HttpRequest::post(format!("http://127.0.0.1:{}/queued?a=1", 端口), b"payload".to_vec())
+            .with_header("X-Name".to_string(), "齐".to_string());
+        let 响应 = 客户端.execute(请求).unwrap();
+        处理者.join().unwrap();
+        assert_eq!(响应.status_code, 201);
+        assert_eq!(响应.body_as_string().unwrap(), "/queued?a=1|齐|payload");
+
+        let 响应 = 客户端.execute(HttpRequest::get(format!("http://127.0.0.1:{}/silent/x", 端口))).unwrap();
+        assert_eq!(响应.status_code, 500);
+
+        assert_eq!(qi_http_server_close(服务器), 1);
+        assert_eq!(qi_http_server_close(服务器), 0);
+        assert_eq!(qi_http_server_next_request(服务器, 10), -1);
+    }
 }
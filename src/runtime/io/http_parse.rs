@@ -0,0 +1,342 @@
+//! HTTP/1.x Head Parsing
+//!
+//! Shared by the HTTP client and server. Finding line ends and rejecting
+//! control characters is the hot loop of head parsing, so both scan 16
+//! bytes at a time with SSE2 on x86_64, where SSE2 is part of the baseline
+//! instruction set and needs no runtime detection; other targets use the
+//! scalar loops. Parsed headers are byte ranges into a single copy of the
+//! head, so no string is allocated per header.
+
+use std::ops::Range;
+
+/// Largest accepted head (start line plus headers)
+pub const MAX_HEAD_SIZE: usize = 64 * 1024;
+/// Most headers accepted in one head
+pub const MAX_HEADERS: usize = 128;
+
+/// Parse failures carry a static message; callers map them to their own
+/// error type (`IoError` for the client, a 400 response for the server)
+pub type ParseResult<T> = Result<T, &'static str>;
+
+/// Position of the first `needle` in `bytes`
+pub fn find_byte(bytes: &[u8], needle: u8) -> Option<usize> {
+    // SAFETY: SSE2 is always available on x86_64
+    #[cfg(target_arch = "x86_64")]
+    return unsafe { sse2::find_byte(bytes, needle) };
+    #[cfg(not(target_arch = "x86_64"))]
+    return scalar::find_byte(bytes, needle);
+}
+
+/// Position of the first byte that ends or invalidates a header line:
+/// CR, LF, any other control character except tab, or DEL
+pub fn find_control(bytes: &[u8]) -> Option<usize> {
+    // SAFETY: SSE2 is always available on x86_64
+    #[cfg(target_arch = "x86_64")]
+    return unsafe { sse2::find_control(bytes) };
+    #[cfg(not(target_arch = "x86_64"))]
+    return scalar::find_control(bytes);
+}
+
+/// Length of the head through its terminating blank line, accepting bare
+/// `\n` line endings; `None` while the head is incomplete
+pub fn find_head_end(buffer: &[u8]) -> Option<usize> {
+    let mut position = 0;
+    while let Some(offset) = find_byte(&buffer[position..], b'\n') {
+        let next = position + offset + 1;
+        match buffer.get(next) {
+            Some(b'\n') => return Some(next + 1),
+            Some(b'\r') => match buffer.get(next + 1) {
+                Some(b'\n') => return Some(next + 2),
+                Some(_) => position = next,
+                None => return None,
+            },
+            Some(_) => position = next,
+            None => return None,
+        }
+    }
+    None
+}
+
+/// Split the line starting at `start`; returns its range without the line
+/// ending and the start of the next line
+pub fn next_line(raw: &[u8], start: usize) -> ParseResult<(Range<usize>, usize)> {
+    let end = start + find_control(&raw[start..]).ok_or("缺少换行")?;
+    match (raw[end], raw.get(end + 1)) {
+        (b'\n', _) => Ok((start..end, end + 1)),
+        (b'\r', Some(b'\n')) => Ok((start..end, end + 2)),
+        _ => Err("包含非法控制字符"),
+    }
+}
+
+/// Check for an RFC 9110 token character
+pub fn is_token_byte(byte: u8) -> bool {
+    byte.is_ascii_alphanumeric() || b"!#$%&'*+-.^_`|~".contains(&byte)
+}
+
+/// Strip optional whitespace (spaces and tabs) from both ends
+pub fn trim_ows(mut bytes: &[u8]) -> &[u8] {
+    while let [b' ' | b'\t', rest @ ..] = bytes {
+        bytes = rest;
+    }
+    while let [rest @ .., b' ' | b'\t'] = bytes {
+        bytes = rest;
+    }
+    bytes
+}
+
+/// Headers of one message as ranges into its head
+#[derive(Debug, Clone, Default)]
+pub struct HeaderBlock {
+    raw: Vec<u8>,
+    headers: Vec<(Range<usize>, Range<usize>)>,
+}
+
+impl HeaderBlock {
+    /// Parse header lines from `start` up to the blank line ending `raw`
+    ///
+    /// `raw` is the complete head as measured by `find_head_end`.
+    pub fn parse(raw: Vec<u8>, start: usize) -> ParseResult<Self> {
+        let mut headers = Vec::new();
+        let mut position = start;
+        loop {
+            let (line, next) = next_line(&raw, position)?;
+            position = next;
+            if line.is_empty() {
+                break;
+            }
+            if headers.len() == MAX_HEADERS {
+                return Err("头部数量过多");
+            }
+            headers.push(parse_header_line(&raw, line)?);
+        }
+        Ok(Self { raw, headers })
+    }
+
+    /// Get the complete head bytes
+    pub fn raw(&self) -> &[u8] {
+        &self.raw
+    }
+
+    /// Get the first value of header `name` (case-insensitive)
+    pub fn header(&self, name: &str) -> Option<&[u8]> {
+        self.iter()
+            .find(|(header, _)| header.eq_ignore_ascii_case(name))
+            .map(|(_, value)| value)
+    }
+
+    /// Get the first value of header `name` as text
+    pub fn header_str(&self, name: &str) -> Option<&str> {
+        self.header(name).and_then(|value| std::str::from_utf8(value).ok())
+    }
+
+    /// Iterate over headers in the order received
+    pub fn iter(&self) -> impl Iterator<Item = (&str, &[u8])> + '_ {
+        self.headers.iter().map(move |(name, value)| {
+            // Names were checked to be ASCII tokens while parsing
+            let name = std::str::from_utf8(&self.raw[name.clone()]).unwrap_or("");
+            (name, &self.raw[value.clone()])
+        })
+    }
+
+    /// Number of headers
+    pub fn len(&self) -> usize {
+        self.headers.len()
+    }
+
+    /// Check whether there are no headers
+    pub fn is_empty(&self) -> bool {
+        self.headers.is_empty()
+    }
+
+    /// Check whether a comma-separated header lists `token`
+    pub fn has_token(&self, name: &str, token: &str) -> bool {
+        self.iter()
+            .filter(|(header, _)| header.eq_ignore_ascii_case(name))
+            .flat_map(|(_, value)| value.split(|&byte| byte == b','))
+            .any(|item| trim_ows(item).eq_ignore_ascii_case(token.as_bytes()))
+    }
+
+    /// Decide keep-alive from the Connection header and protocol version
+    pub fn keep_alive(&self, minor_version: u8) -> bool {
+        if self.has_token("connection", "close") {
+            false
+        } else {
+            minor_version >= 1 || self.has_token("connection", "keep-alive")
+        }
+    }
+
+    /// Get the declared body length, rejecting invalid or conflicting values
+    pub fn content_length(&self) -> ParseResult<Option<u64>> {
+        let mut length = None;
+        for (name, value) in self.iter() {
+            if !name.eq_ignore_ascii_case("content-length") {
+                continue;
+            }
+            let value = std::str::from_utf8(trim_ows(value))
+                .ok()
+                .filter(|value| !value.is_empty() && value.bytes().all(|byte| byte.is_ascii_digit()))
+                .and_then(|value| value.parse::<u64>().ok())
+                .ok_or("Content-Length 无效")?;
+            if length.map_or(false, |previous| previous != value) {
+                return Err("Content-Length 冲突");
+            }
+            length = Some(value);
+        }
+        Ok(length)
+    }
+
+    /// Check for a Transfer-Encoding header of any kind
+    pub fn has_transfer_encoding(&self) -> bool {
+        self.header("transfer-encoding").is_some()
+    }
+
+    /// Check whether the final transfer coding is chunked
+    pub fn is_chunked(&self) -> bool {
+        self.iter()
+            .filter(|(name, _)| name.eq_ignore_ascii_case("transfer-encoding"))
+            .flat_map(|(_, value)| value.split(|&byte| byte == b','))
+            .last()
+            .map_or(false, |coding| trim_ows(coding).eq_ignore_ascii_case(b"chunked"))
+    }
+}
+
+fn parse_header_line(raw: &[u8], line: Range<usize>) -> ParseResult<(Range<usize>, Range<usize>)> {
+    let bytes = &raw[line.clone()];
+    if matches!(bytes.first(), Some(b' ') | Some(b'\t')) {
+        return Err("不支持折叠的头部");
+    }
+    let colon = find_byte(bytes, b':').ok_or("头部缺少冒号")?;
+    if colon == 0 || !bytes[..colon].iter().all(|&byte| is_token_byte(byte)) {
+        return Err("头部名称无效");
+    }
+
+    let value = trim_ows(&bytes[colon + 1..]);
+    let value_start = line.start + (value.as_ptr() as usize - bytes.as_ptr() as usize);
+    Ok((line.start..line.start + colon, value_start..value_start + value.len()))
+}
+
+/// Parse one chunk-size line (extensions after `;` are ignored)
+pub fn parse_chunk_size(line: &[u8]) -> ParseResult<u64> {
+    let digits = trim_ows(line.split(|&byte| byte == b';').next().unwrap_or(line));
+    if digits.is_empty() || digits.len() > 16 {
+        return Err("分块大小无效");
+    }
+    let mut size = 0u64;
+    for &digit in digits {
+        let value = (digit as char).to_digit(16).ok_or("分块大小无效")?;
+        size = size << 4 | value as u64;
+    }
+    Ok(size)
+}
+
+#[cfg(any(test, not(target_arch = "x86_64")))]
+mod scalar {
+    pub fn find_byte(bytes: &[u8], needle: u8) -> Option<usize> {
+        bytes.iter().position(|&byte| byte == needle)
+    }
+
+    pub fn find_control(bytes: &[u8]) -> Option<usize> {
+        bytes.iter().position(|&byte| (byte < 0x20 && byte != b'\t') || byte == 0x7f)
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+mod sse2 {
+    use std::arch::x86_64::*;
+
+    #[target_feature(enable = "sse2")]
+    pub unsafe fn find_byte(bytes: &[u8], needle: u8) -> Option<usize> {
+        let pattern = _mm_set1_epi8(needle as i8);
+        let mut offset = 0;
+        while offset + 16 <= bytes.len() {
+            let block = _mm_loadu_si128(bytes.as_ptr().add(offset) as *const __m128i);
+            let mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+            if mask != 0 {
+                return Some(offset + mask.trailing_zeros() as usize);
+            }
+            offset += 16;
+        }
+        bytes[offset..].iter().position(|&byte| byte == needle).map(|position| offset + position)
+    }
+
+    #[target_feature(enable = "sse2")]
+    pub unsafe fn find_control(bytes: &[u8]) -> Option<usize> {
+        let below_space = _mm_set1_epi8(0x1f);
+        let tab = _mm_set1_epi8(b'\t' as i8);
+        let del = _mm_set1_epi8(0x7f);
+        let mut offset = 0;
+        while offset + 16 <= bytes.len() {
+            let block = _mm_loadu_si128(bytes.as_ptr().add(offset) as *const __m128i);
+            // Unsigned `byte <= 0x1f` via min, so bytes >= 0x80 pass
+            let control = _mm_cmpeq_epi8(_mm_min_epu8(block, below_space), block);
+            let control = _mm_andnot_si128(_mm_cmpeq_epi8(block, tab), control);
+            let invalid = _mm_or_si128(control, _mm_cmpeq_epi8(block, del));
+            let mask = _mm_movemask_epi8(invalid);
+            if mask != 0 {
+                return Some(offset + mask.trailing_zeros() as usize);
+            }
+            offset += 16;
+        }
+        bytes[offset..]
+            .iter()
+            .position(|&byte| (byte < 0x20 && byte != b'\t') || byte == 0x7f)
+            .map(|position| offset + position)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_scans_match_scalar() {
+        let mut 数据: Vec<u8> = (0..200u32).map(|i| b'a' + (i % 26) as u8).collect();
+        for 位置 in [0usize, 7, 15, 16, 17, 31, 100, 199] {
+            for 字节 in [b'\n', b'\r', 0x00, 0x7f, 0x1f] {
+                let 原值 = 数据[位置];
+                数据[位置] = 字节;
+                for 起点 in [0usize, 1, 3] {
+                    let 片段 = &数据[起点.min(位置)..];
+                    assert_eq!(find_control(片段), scalar::find_control(片段));
+                    assert_eq!(find_byte(片段, 字节), scalar::find_byte(片段, 字节));
+                }
+                数据[位置] = 原值;
+            }
+        }
+        // Tabs and obs-text are allowed inside header values
+        assert_eq!(find_control("a\tb值\u{80}".as_bytes()), None);
+        assert_eq!(find_control(&[b'x'; 40]), None);
+    }
+
+    #[test]
+    fn test_find_head_end() {
+        assert_eq!(find_head_end(b"GET / HTTP/1.1\r\nHost: a\r\n\r\nbody"), Some(27));
+        assert_eq!(find_head_end(b"GET / HTTP/1.1\nHost: a\n\nbody"), Some(24));
+        assert_eq!(find_head_end(b"GET / HTTP/1.1\r\nHost: a\r\n\r"), None);
+        assert_eq!(find_head_end(b"GET / HTTP/1.1\r\nHost: a\r\n"), None);
+    }
+
+    #[test]
+    fn test_header_block() {
+        let 头部 = b"X: 1\r\nConnection: Keep-Alive, Upgrade\r\nContent-Length:  7 \r\nEmpty:\r\n\r\n".to_vec();
+        let 头部 = HeaderBlock::parse(头部, 0).unwrap();
+        assert_eq!(头部.len(), 4);
+        assert_eq!(头部.header("x"), Some(&b"1"[..]));
+        assert_eq!(头部.header_str("EMPTY"), Some(""));
+        assert!(头部.has_token("connection", "keep-alive"));
+        assert!(头部.keep_alive(0));
+        assert_eq!(头部.content_length().unwrap(), Some(7));
+
+        assert!(HeaderBlock::parse(b"Bad Name: 1\r\n\r\n".to_vec(), 0).is_err());
+        assert!(HeaderBlock::parse(b"X: a\x01b\r\n\r\n".to_vec(), 0).is_err());
+        assert!(HeaderBlock::parse(b" folded\r\n\r\n".to_vec(), 0).is_err());
+        let 冲突 = HeaderBlock::parse(b"Content-Length: 1\r\nContent-Length: 2\r\n\r\n".to_vec(), 0).unwrap();
+        assert!(冲突.content_length().is_err());
+        let 负数 = HeaderBlock::parse(b"Content-Length: +1\r\n\r\n".to_vec(), 0).unwrap();
+        assert!(负数.content_length().is_err());
+
+        assert_eq!(parse_chunk_size(b"1aF;name=value"), Ok(0x1af));
+        assert!(parse_chunk_size(b"").is_err());
+        assert!(parse_chunk_size(b"10000000000000000").is_err());
+    }
+}
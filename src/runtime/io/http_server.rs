@@ -0,0 +1,1117 @@
+//! HTTP/1.1 Server
+//!
+//! Server half of the HTTP module, built on the `SO_REUSEPORT` listener.
+//! Every connection runs on its own thread, as goroutines do, and waits in
+//! `poll` in short slices so an idle or closed server is noticed promptly.
+//! Heads are parsed by `http_parse`; a request split over several reads is
+//! parsed incrementally, never rescanned from its start. All complete
+//! requests already in the read buffer are handled before the next read, so
+//! pipelined requests are answered in order with one `writev`: response
+//! heads are serialized into a single buffer and bodies are passed as
+//! separate slices, never copied.
+
+use std::io::{self, IoSlice, Read, Write};
+use std::net::{SocketAddr, TcpStream};
+use std::ops::Range;
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+use super::http_parse::{self, HeaderBlock, MAX_HEAD_SIZE};
+use super::listener::{ListenerConfig, TcpListener, DEFAULT_BACKLOG};
+use super::IoResult;
+
+/// Bytes requested from the socket per read
+const READ_BUFFER_SIZE: usize = 16 * 1024;
+/// Longest chunk-size or trailer line in a request body
+const MAX_LINE_SIZE: usize = 8 * 1024;
+/// Most pipelined requests answered in one batch
+const MAX_PIPELINE: usize = 64;
+/// Most slices passed to one `writev`
+const MAX_IOVECS: usize = 1024;
+/// Longest single wait in `poll` before re-checking for shutdown
+const POLL_SLICE_MS: i32 = 100;
+/// Default request body limit
+pub const DEFAULT_MAX_BODY_SIZE: usize = 8 * 1024 * 1024;
+/// Default idle time before a kept-alive connection is closed
+pub const DEFAULT_KEEP_ALIVE_TIMEOUT: Duration = Duration::from_secs(30);
+
+/// HTTP server configuration
+#[derive(Debug, Clone)]
+pub struct HttpServerConfig {
+    /// Local address to bind
+    pub host: String,
+    /// Local port; 0 picks a free port
+    pub port: u16,
+    /// Number of acceptor sockets
+    pub workers: usize,
+    /// Pending-connection queue length per acceptor socket
+    pub backlog: i32,
+    /// Largest request body accepted; larger bodies get 413
+    pub max_body_size: usize,
+    /// Idle time after which a kept-alive connection is closed
+    pub keep_alive_timeout: Duration,
+}
+
+impl HttpServerConfig {
+    /// Create a configuration with default limits
+    pub fn new(host: String, port: u16) -> Self {
+        let listener = ListenerConfig::new(host.clone(), port);
+        Self {
+            host,
+            port,
+            workers: listener.workers,
+            backlog: DEFAULT_BACKLOG,
+            max_body_size: DEFAULT_MAX_BODY_SIZE,
+            keep_alive_timeout: DEFAULT_KEEP_ALIVE_TIMEOUT,
+        }
+    }
+
+    /// Set the number of acceptor sockets
+    pub fn with_workers(mut self, workers: usize) -> Self {
+        self.workers = workers.max(1);
+        self
+    }
+
+    /// Set the largest accepted request body
+    pub fn with_max_body_size(mut self, max_body_size: usize) -> Self {
+        self.max_body_size = max_body_size;
+        self
+    }
+
+    /// Set the idle timeout for kept-alive connections
+    pub fn with_keep_alive_timeout(mut self, timeout: Duration) -> Self {
+        self.keep_alive_timeout = timeout;
+        self
+    }
+
+    fn listener_config(&self) -> ListenerConfig {
+        ListenerConfig::new(self.host.clone(), self.port)
+            .with_backlog(self.backlog)
+            .with_workers(self.workers)
+    }
+}
+
+/// One parsed request
+#[derive(Debug, Clone)]
+pub struct Request {
+    head: HeaderBlock,
+    method: Range<usize>,
+    target: Range<usize>,
+    minor_version: u8,
+    body: Vec<u8>,
+    peer: SocketAddr,
+}
+
+impl Request {
+    /// Request method, e.g. `GET`
+    pub fn method(&self) -> &str {
+        self.text(self.method.clone())
+    }
+
+    /// Request target as sent, path plus query
+    pub fn target(&self) -> &str {
+        self.text(self.target.clone())
+    }
+
+    /// Path part of the target
+    pub fn path(&self) -> &str {
+        let target = self.target();
+        target.split('?').next().unwrap_or(target)
+    }
+
+    /// Query part of the target, without the `?`
+    pub fn query(&self) -> Option<&str> {
+        self.target().split_once('?').map(|(_, query)| query)
+    }
+
+    /// 0 for HTTP/1.0, 1 for HTTP/1.1
+    pub fn minor_version(&self) -> u8 {
+        self.minor_version
+    }
+
+    /// Get the first value of header `name` (case-insensitive)
+    pub fn header(&self, name: &str) -> Option<&[u8]> {
+        self.head.header(name)
+    }
+
+    /// Get the first value of header `name` as text
+    pub fn header_str(&self, name: &str) -> Option<&str> {
+        self.head.header_str(name)
+    }
+
+    /// Iterate over headers in the order received
+    pub fn headers(&self) -> impl Iterator<Item = (&str, &[u8])> + '_ {
+        self.head.iter()
+    }
+
+    /// Decoded request body
+    pub fn body(&self) -> &[u8] {
+        &self.body
+    }
+
+    /// Take the decoded request body
+    pub fn into_body(self) -> Vec<u8> {
+        self.body
+    }
+
+    /// Address of the client
+    pub fn peer(&self) -> SocketAddr {
+        self.peer
+    }
+
+    /// Check whether the client lets the connection be reused
+    pub fn keep_alive(&self) -> bool {
+        self.head.keep_alive(self.minor_version)
+    }
+
+    fn text(&self, range: Range<usize>) -> &str {
+        // The request line was checked to be ASCII while parsing
+        std::str::from_utf8(&self.head.raw()[range]).unwrap_or("")
+    }
+}
+
+/// Response body; borrowed variants are written without copying
+#[derive(Debug, Clone)]
+pub enum Body {
+    Empty,
+    Static(&'static [u8]),
+    Owned(Vec<u8>),
+    Shared(Arc<[u8]>),
+}
+
+impl Body {
+    /// Body bytes
+    pub fn as_bytes(&self) -> &[u8] {
+        match self {
+            Body::Empty => &[],
+            Body::Static(bytes) => bytes,
+            Body::Owned(bytes) => bytes,
+            Body::Shared(bytes) => bytes,
+        }
+    }
+}
+
+impl From<Vec<u8>> for Body {
+    fn from(bytes: Vec<u8>) -> Self {
+        Body::Owned(bytes)
+    }
+}
+
+impl From<String> for Body {
+    fn from(text: String) -> Self {
+        Body::Owned(text.into_bytes())
+    }
+}
+
+impl From<&'static str> for Body {
+    fn from(text: &'static str) -> Self {
+        Body::Static(text.as_bytes())
+    }
+}
+
+impl From<Arc<[u8]>> for Body {
+    fn from(bytes: Arc<[u8]>) -> Self {
+        Body::Shared(bytes)
+    }
+}
+
+/// Response built by a handler
+///
+/// `Content-Length` and `Connection` are added by the server.
+#[derive(Debug, Clone)]
+pub struct Response {
+    /// Status code
+    pub status: u16,
+    /// Extra headers in the order written
+    pub headers: Vec<(String, String)>,
+    /// Response body
+    pub body: Body,
+}
+
+impl Response {
+    /// Create an empty response with `status`
+    pub fn new(status: u16) -> Self {
+        Self {
+            status,
+            headers: Vec::new(),
+            body: Body::Empty,
+        }
+    }
+
+    /// Create a plain-text response
+    pub fn text(status: u16, body: impl Into<Body>) -> Self {
+        Self::new(status)
+            .with_header("Content-Type", "text/plain; charset=utf-8")
+            .with_body(body)
+    }
+
+    /// Add a header
+    pub fn with_header(mut self, name: &str, value: &str) -> Self {
+        self.headers.push((name.to_string(), value.to_string()));
+        self
+    }
+
+    /// Set the body
+    pub fn with_body(mut self, body: impl Into<Body>) -> Self {
+        self.body = body.into();
+        self
+    }
+
+    fn asks_close(&self) -> bool {
+        self.headers.iter().any(|(name, value)| {
+            name.eq_ignore_ascii_case("connection")
+                && value.split(',').any(|token| token.trim().eq_ignore_ascii_case("close"))
+        })
+    }
+}
+
+type RouteHandler = Box<dyn Fn(Request) -> Response + Send + Sync>;
+
+struct Route {
+    /// `None` matches any method
+    method: Option<String>,
+    /// Exact path, or a prefix when the pattern ended in `*`
+    path: String,
+    prefix: bool,
+    handler: RouteHandler,
+}
+
+/// Dispatches requests by method and path
+///
+/// Routes are tried in the order added. A pattern ending in `*` matches
+/// every path with that prefix; the method `*` matches any method.
+/// Unmatched requests go to the fallback, which answers 404 by default.
+#[derive(Default)]
+pub struct Router {
+    routes: Vec<Route>,
+    fallback: Option<RouteHandler>,
+}
+
+impl Router {
+    /// Create a router with no routes
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Add a route
+    pub fn add<F>(&mut self, method: &str, pattern: &str, handler: F) -> &mut Self
+    where
+        F: Fn(Request) -> Response + Send + Sync + 'static,
+    {
+        let (path, prefix) = match pattern.strip_suffix('*') {
+            Some(path) => (path, true),
+            None => (pattern, false),
+        };
+        self.routes.push(Route {
+            method: (method != "*").then(|| method.to_ascii_uppercase()),
+            path: path.to_string(),
+            prefix,
+            handler: Box::new(handler),
+        });
+        self
+    }
+
+    /// Handle requests that match no route
+    pub fn set_fallback<F>(&mut self, handler: F) -> &mut Self
+    where
+        F: Fn(Request) -> Response + Send + Sync + 'static,
+    {
+        self.fallback = Some(Box::new(handler));
+        self
+    }
+
+    /// Run the handler for `request`
+    pub fn dispatch(&self, request: Request) -> Response {
+        match self.try_dispatch(request) {
+            Ok(response) => response,
+            Err(_) => Response::text(404, "Not Found"),
+        }
+    }
+
+    /// Run the matching route or fallback; hands `request` back when
+    /// neither exists
+    pub fn try_dispatch(&self, request: Request) -> Result<Response, Request> {
+        let route = self.routes.iter().find(|route| {
+            route.method.as_deref().map_or(true, |method| method == request.method())
+                && if route.prefix {
+                    request.path().starts_with(&route.path)
+                } else {
+                    request.path() == route.path
+                }
+        });
+        match (route, &self.fallback) {
+            (Some(route), _) => Ok((route.handler)(request)),
+            (None, Some(fallback)) => Ok(fallback(request)),
+            (None, None) => Err(request),
+        }
+    }
+}
+
+impl std::fmt::Debug for Router {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("Router").field("routes", &self.routes.len()).finish()
+    }
+}
+
+/// HTTP/1.1 server
+#[derive(Debug)]
+pub struct HttpServer {
+    listener: TcpListener,
+    config: HttpServerConfig,
+}
+
+impl HttpServer {
+    /// Bind the listening sockets
+    pub fn bind(config: HttpServerConfig) -> IoResult<Self> {
+        let listener = TcpListener::bind(&config.listener_config())?;
+        Ok(Self { listener, config })
+    }
+
+    /// Address the server is bound to
+    pub fn local_addr(&self) -> SocketAddr {
+        self.listener.local_addr()
+    }
+
+    /// Serve requests until the server is closed
+    ///
+    /// `handler` runs on the connection's thread; pipelined requests on one
+    /// connection are handled in order. Returns once the server is closed
+    /// and every connection has finished.
+    pub fn serve<F>(&self, handler: F) -> IoResult<()>
+    where
+        F: Fn(Request) -> Response + Sync,
+    {
+        self.listener.serve_streams(|stream, peer| {
+            let mut connection = Connection {
+                stream,
+                peer,
+                server: self,
+                buffer: Vec::with_capacity(READ_BUFFER_SIZE),
+                continue_sent: false,
+                parser: RequestParser::default(),
+            };
+            // A failed connection only affects its own client
+            let _ = connection.run(&handler);
+        })
+    }
+
+    /// Stop accepting; open connections close after their current batch
+    pub fn close(&self) {
+        self.listener.close();
+    }
+
+    /// Check whether `close` has been called
+    pub fn is_closed(&self) -> bool {
+        self.listener.is_closed()
+    }
+}
+
+/// Outcome of parsing the front of the read buffer
+enum Parsed {
+    Complete(Request, usize),
+    Incomplete { expects_continue: bool },
+    Invalid(u16, &'static str),
+}
+
+/// Response ready to be written
+struct Outgoing {
+    response: Response,
+    head_only: bool,
+    keep_alive: bool,
+}
+
+struct Connection<'a> {
+    stream: TcpStream,
+    peer: SocketAddr,
+    server: &'a HttpServer,
+    /// Received bytes not yet consumed by a complete request
+    buffer: Vec<u8>,
+    /// Whether `100 Continue` was sent for the request being received
+    continue_sent: bool,
+    /// Parse state of the request being received
+    parser: RequestParser,
+}
+
+impl Connection<'_> {
+    fn run<F>(&mut self, handler: &F) -> io::Result<()>
+    where
+        F: Fn(Request) -> Response,
+    {
+        let mut batch = Vec::new();
+        let mut idle_since = Instant::now();
+        loop {
+            let mut consumed = 0;
+            let mut closing = false;
+            while batch.len() < MAX_PIPELINE && !closing {
+                match self.parser.parse(&self.buffer[consumed..], self.peer, self.server.config.max_body_size) {
+                    Parsed::Complete(request, length) => {
+                        consumed += length;
+                        self.continue_sent = false;
+                        let head_only = request.method() == "HEAD";
+                        let keep_alive = request.keep_alive() && !self.server.is_closed();
+                        let response = handler(request);
+                        let keep_alive = keep_alive && !response.asks_close();
+                        closing = !keep_alive;
+                        batch.push(Outgoing { response, head_only, keep_alive });
+                    }
+                    Parsed::Incomplete { expects_continue } => {
+                        if expects_continue && !self.continue_sent && batch.is_empty() {
+                            self.continue_sent = true;
+                            self.write_all_vectored(&[b"HTTP/1.1 100 Continue\r\n\r\n"])?;
+                        }
+                        break;
+                    }
+                    Parsed::Invalid(status, message) => {
+                        closing = true;
+                        batch.push(Outgoing {
+                            response: Response::text(status, message),
+                            head_only: false,
+                            keep_alive: false,
+                        });
+                    }
+                }
+            }
+            self.buffer.drain(..consumed);
+
+            if !batch.is_empty() {
+                self.write_batch(&batch)?;
+                batch.clear();
+                if closing {
+                    // Let the client read the last response before the close
+                    let _ = self.stream.shutdown(std::net::Shutdown::Write);
+                    return Ok(());
+                }
+                idle_since = Instant::now();
+                if consumed > 0 && !self.buffer.is_empty() {
+                    // More pipelined requests may already be complete
+                    continue;
+                }
+            }
+
+            if !self.fill(idle_since)? {
+                return Ok(());
+            }
+        }
+    }
+
+    /// Read more bytes; `false` when the peer closed, the connection sat
+    /// idle too long, or the server is shutting down
+    fn fill(&mut self, idle_since: Instant) -> io::Result<bool> {
+        let timeout = self.server.config.keep_alive_timeout;
+        loop {
+            if self.server.is_closed() && self.buffer.is_empty() {
+                return Ok(false);
+            }
+            let remaining = match timeout.checked_sub(idle_since.elapsed()) {
+                Some(remaining) if !remaining.is_zero() => remaining,
+                _ => return Ok(false),
+            };
+            let slice = (remaining.as_millis() as i32).clamp(1, POLL_SLICE_MS);
+            if !wait_ready(&self.stream, libc::POLLIN, slice)? {
+                continue;
+            }
+
+            let start = self.buffer.len();
+            self.buffer.resize(start + READ_BUFFER_SIZE, 0);
+            let result = (&self.stream).read(&mut self.buffer[start..]);
+            match result {
+                Ok(count) => {
+                    self.buffer.truncate(start + count);
+                    return Ok(count > 0);
+                }
+                Err(e) => {
+                    self.buffer.truncate(start);
+                    if !matches!(e.kind(), io::ErrorKind::WouldBlock | io::ErrorKind::Interrupted) {
+                        return Err(e);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Write every response of a batch with as few `writev` calls as fit
+    fn write_batch(&self, batch: &[Outgoing]) -> io::Result<()> {
+        let mut heads = Vec::with_capacity(batch.len() * 128);
+        let mut head_ends = Vec::with_capacity(batch.len());
+        for outgoing in batch {
+            write_response_head(&mut heads, outgoing);
+            head_ends.push(heads.len());
+        }
+
+        let mut parts: Vec<&[u8]> = Vec::with_capacity(batch.len() * 2);
+        let mut start = 0;
+        for (outgoing, &end) in batch.iter().zip(&head_ends) {
+            parts.push(&heads[start..end]);
+            start = end;
+            if !outgoing.head_only && has_body(outgoing.response.status) {
+                parts.push(outgoing.response.body.as_bytes());
+            }
+        }
+        self.write_all_vectored(&parts)
+    }
+
+    fn write_all_vectored(&self, parts: &[&[u8]]) -> io::Result<()> {
+        let parts: Vec<&[u8]> = parts.iter().copied().filter(|part| !part.is_empty()).collect();
+        let mut index = 0;
+        let mut offset = 0;
+        let mut stalled_since = Instant::now();
+        while index < parts.len() {
+            let slices: Vec<IoSlice<'_>> = std::iter::once(&parts[index][offset..])
+                .chain(parts[index + 1..].iter().copied())
+                .take(MAX_IOVECS)
+                .map(IoSlice::new)
+                .collect();
+            match (&self.stream).write_vectored(&slices) {
+                Ok(0) => return Err(io::ErrorKind::WriteZero.into()),
+                Ok(mut written) => {
+                    while index < parts.len() && written >= parts[index].len() - offset {
+                        written -= parts[index].len() - offset;
+                        index += 1;
+                        offset = 0;
+                    }
+                    offset += written;
+                    stalled_since = Instant::now();
+                }
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+                Err(e) if e.kind() == io::ErrorKind::WouldBlock => {
+                    // A client that stops reading is dropped like an idle one
+                    if stalled_since.elapsed() >= self.server.config.keep_alive_timeout {
+                        return Err(io::ErrorKind::TimedOut.into());
+                    }
+                    wait_ready(&self.stream, libc::POLLOUT, POLL_SLICE_MS)?;
+                }
+                Err(e) => return Err(e),
+            }
+        }
+        Ok(())
+    }
+}
+
+/// Progress on the request at the front of the read buffer
+///
+/// Kept across reads, so each read only scans the bytes it added: the head
+/// is parsed once, and a chunked body is decoded up to where the last read
+/// stopped. Offsets are relative to the start of the request.
+#[derive(Default)]
+struct RequestParser {
+    /// Bytes already searched for the end of the head
+    scanned: usize,
+    /// Parsed head, once the blank line ending it has arrived
+    head: Option<RequestHead>,
+}
+
+struct RequestHead {
+    head: HeaderBlock,
+    method: Range<usize>,
+    target: Range<usize>,
+    minor_version: u8,
+    /// Leading blank lines plus the head
+    body_start: usize,
+    expects_continue: bool,
+    body: BodyDecoder,
+}
+
+enum BodyDecoder {
+    Length(usize),
+    Chunked(ChunkedDecoder),
+}
+
+impl RequestParser {
+    /// Parse one request from the front of `buffer`, which holds everything
+    /// passed on earlier calls plus what has arrived since
+    ///
+    /// The state is reset once a request is complete or rejected.
+    fn parse(&mut self, buffer: &[u8], peer: SocketAddr, max_body_size: usize) -> Parsed {
+        let parsed = self.advance(buffer, peer, max_body_size);
+        if !matches!(parsed, Parsed::Incomplete { .. }) {
+            *self = Self::default();
+        }
+        parsed
+    }
+
+    fn advance(&mut self, buffer: &[u8], peer: SocketAddr, max_body_size: usize) -> Parsed {
+        let head = match &mut self.head {
+            Some(head) => head,
+            None => match parse_head(buffer, &mut self.scanned, max_body_size) {
+                Ok(Some(head)) => self.head.insert(head),
+                Ok(None) => return Parsed::Incomplete { expects_continue: false },
+                Err(invalid) => return invalid,
+            },
+        };
+
+        let rest = &buffer[head.body_start..];
+        let (body, body_length) = match &mut head.body {
+            BodyDecoder::Length(length) => match rest.get(..*length) {
+                Some(body) => (body.to_vec(), *length),
+                None => return Parsed::Incomplete { expects_continue: head.expects_continue },
+            },
+            BodyDecoder::Chunked(decoder) => match decoder.decode(rest, max_body_size) {
+                Ok(true) => (std::mem::take(&mut decoder.body), decoder.position),
+                Ok(false) => return Parsed::Incomplete { expects_continue: head.expects_continue },
+                Err(invalid) => return invalid,
+            },
+        };
+
+        let head = self.head.take().expect("head parsed above");
+        let request = Request {
+            head: head.head,
+            method: head.method,
+            target: head.target,
+            minor_version: head.minor_version,
+            body,
+            peer,
+        };
+        Parsed::Complete(request, head.body_start + body_length)
+    }
+}
+
+/// Parse the head at the front of `buffer`, resuming the search for its end
+/// at `scanned`; `Ok(None)` while it is incomplete
+fn parse_head(buffer: &[u8], scanned: &mut usize, max_body_size: usize) -> Result<Option<RequestHead>, Parsed> {
+    // Tolerate blank lines between pipelined requests (RFC 9112 §2.2)
+    let skipped = buffer.iter().take_while(|&&byte| byte == b'\r' || byte == b'\n').count();
+
+    // A terminator cut by the previous read starts at most 3 bytes back
+    let resume = scanned.saturating_sub(3).max(skipped);
+    let head_length = match http_parse::find_head_end(&buffer[resume..]) {
+        Some(length) => resume + length - skipped,
+        None if buffer.len() - skipped >= MAX_HEAD_SIZE => return Err(Parsed::Invalid(431, "请求头过大")),
+        None => {
+            *scanned = buffer.len();
+            return Ok(None);
+        }
+    };
+    let raw = buffer[skipped..skipped + head_length].to_vec();
+    let invalid = |message| Parsed::Invalid(400, message);
+    let (request_line, next) = http_parse::next_line(&raw, 0).map_err(invalid)?;
+    let (method, target, minor_version) = parse_request_line(&raw, request_line).map_err(invalid)?;
+    let head = HeaderBlock::parse(raw, next).map_err(invalid)?;
+    if minor_version >= 1 && head.header("host").is_none() {
+        return Err(Parsed::Invalid(400, "缺少 Host 头"));
+    }
+
+    let body = if head.has_transfer_encoding() {
+        if !head.is_chunked() {
+            return Err(Parsed::Invalid(400, "不支持的传输编码"));
+        }
+        BodyDecoder::Chunked(ChunkedDecoder::default())
+    } else {
+        let length = head.content_length().map_err(invalid)?.unwrap_or(0);
+        if length > max_body_size as u64 {
+            return Err(Parsed::Invalid(413, "请求体过大"));
+        }
+        BodyDecoder::Length(length as usize)
+    };
+
+    Ok(Some(RequestHead {
+        expects_continue: head.has_token("expect", "100-continue"),
+        head,
+        method,
+        target,
+        minor_version,
+        body_start: skipped + head_length,
+        body,
+    }))
+}
+
+fn parse_request_line(raw: &[u8], line: Range<usize>) -> Result<(Range<usize>, Range<usize>, u8), &'static str> {
+    let bytes = &raw[line.clone()];
+    let invalid = "请求行无效";
+    let first = http_parse::find_byte(bytes, b' ').ok_or(invalid)?;
+    let last = bytes.iter().rposition(|&byte| byte == b' ').ok_or(invalid)?;
+    if first == 0 || last <= first + 1 || !bytes[..first].iter().all(|&byte| http_parse::is_token_byte(byte)) {
+        return Err(invalid);
+    }
+    let target = &bytes[first + 1..last];
+    if !target.iter().all(|&byte| byte.is_ascii_graphic()) {
+        return Err(invalid);
+    }
+    let minor_version = match &bytes[last + 1..] {
+        [b'H', b'T', b'T', b'P', b'/', b'1', b'.', digit @ b'0'..=b'9'] => digit - b'0',
+        _ => return Err("不支持的 HTTP 版本"),
+    };
+    Ok((
+        line.start..line.start + first,
+        line.start + first + 1..line.start + last,
+        minor_version,
+    ))
+}
+
+/// Incremental decoder for a chunked request body
+#[derive(Default)]
+struct ChunkedDecoder {
+    /// Data of the chunks decoded so far
+    body: Vec<u8>,
+    /// Bytes of the encoded body consumed so far
+    position: usize,
+    state: ChunkState,
+}
+
+#[derive(Default, Clone, Copy)]
+enum ChunkState {
+    #[default]
+    Size,
+    Data(usize),
+    DataEnd,
+    Trailers,
+}
+
+impl ChunkedDecoder {
+    /// Decode from where the previous call stopped; `Ok(true)` once the
+    /// closing blank line after the trailers has been read
+    fn decode(&mut self, buffer: &[u8], max_body_size: usize) -> Result<bool, Parsed> {
+        loop {
+            match self.state {
+                ChunkState::Size => {
+                    let line = match take_line(buffer, &mut self.position)? {
+                        Some(line) => line,
+                        None => return Ok(false),
+                    };
+                    let size = http_parse::parse_chunk_size(line).map_err(|message| Parsed::Invalid(400, message))?;
+                    if size == 0 {
+                        self.state = ChunkState::Trailers;
+                        continue;
+                    }
+                    if self.body.len() as u64 + size > max_body_size as u64 {
+                        return Err(Parsed::Invalid(413, "请求体过大"));
+                    }
+                    self.state = ChunkState::Data(size as usize);
+                }
+                ChunkState::Data(remaining) => {
+                    let available = (buffer.len() - self.position).min(remaining);
+                    if available == 0 {
+                        return Ok(false);
+                    }
+                    self.body.extend_from_slice(&buffer[self.position..self.position + available]);
+                    self.position += available;
+                    self.state = if available == remaining {
+                        ChunkState::DataEnd
+                    } else {
+                        ChunkState::Data(remaining - available)
+                    };
+                }
+                ChunkState::DataEnd => {
+                    match &buffer[self.position..] {
+                        [b'\r', b'\n', ..] => self.position += 2,
+                        [b'\n', ..] => self.position += 1,
+                        [] | [b'\r'] => return Ok(false),
+                        _ => return Err(Parsed::Invalid(400, "分块数据后缺少换行")),
+                    }
+                    self.state = ChunkState::Size;
+                }
+                // Trailers are read and dropped up to the closing blank line
+                ChunkState::Trailers => match take_line(buffer, &mut self.position)? {
+                    Some([]) => return Ok(true),
+                    Some(_) => {}
+                    None => return Ok(false),
+                },
+            }
+        }
+    }
+}
+
+fn take_line<'a>(buffer: &'a [u8], position: &mut usize) -> Result<Option<&'a [u8]>, Parsed> {
+    let rest = &buffer[*position..];
+    match http_parse::find_byte(rest, b'\n') {
+        Some(end) => {
+            *position += end + 1;
+            Ok(Some(rest[..end].strip_suffix(b"\r").unwrap_or(&rest[..end])))
+        }
+        None if rest.len() > MAX_LINE_SIZE => Err(Parsed::Invalid(400, "分块行过长")),
+        None => Ok(None),
+    }
+}
+
+fn has_body(status: u16) -> bool {
+    !(100..200).contains(&status) && status != 204 && status != 304
+}
+
+fn write_response_head(out: &mut Vec<u8>, outgoing: &Outgoing) {
+    let response = &outgoing.response;
+    let _ = write!(out, "HTTP/1.1 {} {}\r\n", response.status, reason_phrase(response.status));
+    for (name, value) in &response.headers {
+        let reserved = name.eq_ignore_ascii_case("content-length") || name.eq_ignore_ascii_case("connection");
+        // Values with line breaks would let a handler inject headers
+        if reserved || value.contains(['\r', '\n']) || name.contains(['\r', '\n', ':']) {
+            continue;
+        }
+        let _ = write!(out, "{}: {}\r\n", name, value);
+    }
+    if has_body(response.status) {
+        let _ = write!(out, "Content-Length: {}\r\n", response.body.as_bytes().len());
+    }
+    if !outgoing.keep_alive {
+        out.extend_from_slice(b"Connection: close\r\n");
+    }
+    out.extend_from_slice(b"\r\n");
+}
+
+/// Standard reason phrase for `status`
+pub fn reason_phrase(status: u16) -> &'static str {
+    match status {
+        100 => "Continue",
+        200 => "OK",
+        201 => "Created",
+        202 => "Accepted",
+        204 => "No Content",
+        301 => "Moved Permanently",
+        302 => "Found",
+        304 => "Not Modified",
+        307 => "Temporary Redirect",
+        308 => "Permanent Redirect",
+        400 => "Bad Request",
+        401 => "Unauthorized",
+        403 => "Forbidden",
+        404 => "Not Found",
+        405 => "Method Not Allowed",
+        408 => "Request Timeout",
+        413 => "Content Too Large",
+        431 => "Request Header Fields Too Large",
+        500 => "Internal Server Error",
+        501 => "Not Implemented",
+        502 => "Bad Gateway",
+        503 => "Service Unavailable",
+        _ => "",
+    }
+}
+
+/// Wait up to `timeout_ms` for `events`; `false` on timeout
+fn wait_ready(stream: &TcpStream, events: libc::c_short, timeout_ms: i32) -> io::Result<bool> {
+    use std::os::unix::io::AsRawFd;
+
+    let mut pollfd = libc::pollfd { fd: stream.as_raw_fd(), events, revents: 0 };
+    match unsafe { libc::poll(&mut pollfd, 1, timeout_ms) } {
+        -1 => {
+            let error = io::Error::last_os_error();
+            if error.kind() == io::ErrorKind::Interrupted {
+                Ok(false)
+            } else {
+                Err(error)
+            }
+        }
+        0 => Ok(false),
+        _ => Ok(true),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::BufRead;
+    use std::net::Shutdown;
+
+    struct 测试服务器 {
+        服务器: Arc<HttpServer>,
+        线程: Option<std::thread::JoinHandle<IoResult<()>>>,
+    }
+
+    impl 测试服务器 {
+        fn 启动(配置: HttpServerConfig) -> Self {
+            let 服务器 = Arc::new(HttpServer::bind(配置).unwrap());
+            let 副本 = Arc::clone(&服务器);
+            let 线程 = std::thread::spawn(move || {
+                let mut 路由 = Router::new();
+                路由.add("GET", "/hello", |_| Response::text(200, "你好"))
+                    .add("POST", "/echo", |请求| {
+                        let 内容 = 请求.into_body();
+                        Response::new(200).with_body(内容)
+                    })
+                    .add("*", "/static/*", |请求| {
+                        Response::text(200, 请求.path().to_string()).with_header("X-Query", 请求.query().unwrap_or(""))
+                    })
+                    .add("GET", "/bye", |_| Response::text(200, "再见").with_header("Connection", "close"));
+                副本.serve(|请求| 路由.dispatch(请求))
+            });
+            Self { 服务器, 线程: Some(线程) }
+        }
+
+        fn 连接(&self) -> TcpStream {
+            let 流 = TcpStream::connect(self.服务器.local_addr()).unwrap();
+            流.set_read_timeout(Some(Duration::from_secs(5))).unwrap();
+            流
+        }
+    }
+
+    impl Drop for 测试服务器 {
+        fn drop(&mut self) {
+            self.服务器.close();
+            if let Some(线程) = self.线程.take() {
+                线程.join().unwrap().unwrap();
+            }
+        }
+    }
+
+    fn 默认配置() -> HttpServerConfig {
+        HttpServerConfig::new("127.0.0.1".to_string(), 0).with_workers(2)
+    }
+
+    /// Read one response; returns the status, lowercased headers and body
+    fn 读取响应(读取器: &mut io::BufReader<&TcpStream>) -> (u16, Vec<(String, String)>, Vec<u8>) {
+        let mut 行 = String::new();
+        读取器.read_line(&mut 行).unwrap();
+        let 状态 = 行[9..12].parse().unwrap();
+        let mut 头部 = Vec::new();
+        loop {
+            行.clear();
+            读取器.read_line(&mut 行).unwrap();
+            let 内容 = 行.trim_end();
+            if 内容.is_empty() {
+                break;
+            }
+            let (名称, 值) = 内容.split_once(':').unwrap();
+            头部.push((名称.to_ascii_lowercase(), 值.trim().to_string()));
+        }
+        let 长度 = 头部
+            .iter()
+            .find(|(名称, _)| 名称 == "content-length")
+            .map_or(0, |(_, 值)| 值.parse().unwrap());
+        let mut 响应体 = vec![0; 长度];
+        读取器.read_exact(&mut 响应体).unwrap();
+        (状态, 头部, 响应体)
+    }
+
+    #[test]
+    fn test_pipelined_keep_alive_requests() {
+        let 服务器 = 测试服务器::启动(默认配置());
+        let 流 = 服务器.连接();
+        let mut 读取器 = io::BufReader::new(&流);
+
+        // Three pipelined requests in one write, answered in order
+        (&流)
+            .write_all(
+                b"GET /hello HTTP/1.1\r\nHost: x\r\n\r\n\
+                  POST /echo HTTP/1.1\r\nHost: x\r\nContent-Length: 5\r\n\r\nhello\
+                  GET /static/a/b?q=1 HTTP/1.1\r\nHost: x\r\n\r\n",
+            )
+            .unwrap();
+        let (状态, 头部, 响应体) = 读取响应(&mut 读取器);
+        assert_eq!(状态, 200);
+        assert_eq!(响应体, "你好".as_bytes());
+        assert!(头部.iter().all(|(名称, _)| 名称 != "connection"));
+        assert_eq!(读取响应(&mut 读取器).2, b"hello");
+        let (_, 头部, 响应体) = 读取响应(&mut 读取器);
+        assert_eq!(响应体, b"/static/a/b");
+        assert!(头部.contains(&("x-query".to_string(), "q=1".to_string())));
+
+        // The same connection stays usable, even with a request split mid-head
+        (&流).write_all(b"GET /missing HTTP/1.1\r\nHo").unwrap();
+        std::thread::sleep(Duration::from_millis(20));
+        (&流).write_all(b"st: x\r\n\r\n").unwrap();
+        assert_eq!(读取响应(&mut 读取器).0, 404);
+
+        // HEAD keeps the length but sends no body
+        (&流).write_all(b"HEAD /static/x HTTP/1.1\r\nHost: x\r\n\r\nGET /hello HTTP/1.1\r\nHost: x\r\n\r\n").unwrap();
+        let mut 行 = String::new();
+        while 行 != "\r\n" {
+            行.clear();
+            读取器.read_line(&mut 行).unwrap();
+        }
+        assert_eq!(读取响应(&mut 读取器).2, "你好".as_bytes());
+    }
+
+    #[test]
+    fn test_chunked_body_and_continue() {
+        let 服务器 = 测试服务器::启动(默认配置());
+        let 流 = 服务器.连接();
+        let mut 读取器 = io::BufReader::new(&流);
+
+        (&流)
+            .write_all(b"POST /echo HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n4;ext=1\r\ndefg\r\n0\r\nX-Trailer: 1\r\n\r\n")
+            .unwrap();
+        assert_eq!(读取响应(&mut 读取器).2, b"abcdefg");
+
+        // The body is only sent after 100 Continue
+        (&流)
+            .write_all(b"POST /echo HTTP/1.1\r\nHost: x\r\nExpect: 100-continue\r\nContent-Length: 3\r\n\r\n")
+            .unwrap();
+        let mut 行 = String::new();
+        读取器.read_line(&mut 行).unwrap();
+        assert_eq!(行, "HTTP/1.1 100 Continue\r\n");
+        读取器.read_line(&mut 行).unwrap();
+        (&流).write_all(b"xyz").unwrap();
+        assert_eq!(读取响应(&mut 读取器).2, b"xyz");
+    }
+
+    #[test]
+    fn test_parser_resumes_across_reads() {
+        let 请求 = b"\r\nPOST /echo HTTP/1.1\r\nHost: x\r\nTransfer-Encoding: chunked\r\n\r\n\
+                    3\r\nabc\r\n10\r\n0123456789abcdef\r\n0\r\nX-Trailer: 1\r\n\r\nGET";
+        let 请求长度 = 请求.len() - 3;
+        let 对端: SocketAddr = "127.0.0.1:1".parse().unwrap();
+
+        // Feed one byte at a time; the head is parsed exactly once
+        let mut 解析器 = RequestParser::default();
+        for 长度 in 1..请求长度 {
+            match 解析器.parse(&请求[..长度], 对端, 1024) {
+                Parsed::Incomplete { .. } => {}
+                _ => panic!("请求在 {} 字节处提前完成", 长度),
+            }
+            let 头部已解析 = 长度 >= 请求.windows(4).position(|窗口| 窗口 == b"\r\n\r\n").unwrap() + 4;
+            assert_eq!(解析器.head.is_some(), 头部已解析);
+        }
+        match 解析器.parse(请求, 对端, 1024) {
+            Parsed::Complete(请求, 长度) => {
+                assert_eq!(长度, 请求长度);
+                assert_eq!((请求.method(), 请求.path()), ("POST", "/echo"));
+                assert_eq!(请求.body(), b"abc0123456789abcdef");
+            }
+            _ => panic!("请求未完成"),
+        }
+        assert!(解析器.head.is_none());
+
+        // Limits are still enforced chunk by chunk
+        let mut 解析器 = RequestParser::default();
+        assert!(matches!(解析器.parse(&请求[..请求长度], 对端, 8), Parsed::Invalid(413, _)));
+    }
+
+    #[test]
+    fn test_errors_and_connection_close() {
+        let 服务器 = 测试服务器::启动(默认配置().with_max_body_size(16));
+
+        let 请求们: [(&[u8], u16); 5] = [
+            (b"GET /hello\r\n\r\n", 400),
+            (b"GET /hello HTTP/1.1\r\n\r\n", 400),
+            (b"GET /hello HTTP/1.1\r\nHost: x\r\nBad\x01: y\r\n\r\n", 400),
+            (b"POST /echo HTTP/1.1\r\nHost: x\r\nContent-Length: 17\r\n\r\n", 413),
+            (b"GET /bye HTTP/1.1\r\nHost: x\r\n\r\n", 200),
+        ];
+        for (请求, 预期) in 请求们 {
+            let 流 = 服务器.连接();
+            (&流).write_all(请求).unwrap();
+            let mut 读取器 = io::BufReader::new(&流);
+            let (状态, 头部, _) = 读取响应(&mut 读取器);
+            assert_eq!(状态, 预期);
+            assert!(头部.contains(&("connection".to_string(), "close".to_string())));
+            // The server closes its side after the response
+            let mut 剩余 = Vec::new();
+            读取器.read_to_end(&mut 剩余).unwrap();
+            assert!(剩余.is_empty());
+        }
+
+        // HTTP/1.0 closes by default
+        let 流 = 服务器.连接();
+        (&流).write_all(b"GET /hello HTTP/1.0\r\n\r\n").unwrap();
+        let mut 读取器 = io::BufReader::new(&流);
+        assert_eq!(读取响应(&mut 读取器).0, 200);
+        let mut 剩余 = Vec::new();
+        读取器.read_to_end(&mut 剩余).unwrap();
+        assert!(剩余.is_empty());
+    }
+
+    #[test]
+    fn test_idle_connections_close() {
+        let 服务器 = 测试服务器::启动(默认配置().with_keep_alive_timeout(Duration::from_millis(100)));
+        let 流 = 服务器.连接();
+        let 开始 = Instant::now();
+        let mut 缓冲 = [0u8; 16];
+        assert_eq!((&流).read(&mut 缓冲).unwrap(), 0);
+        assert!(开始.elapsed() < Duration::from_secs(2));
+
+        // Closing the server ends open connections and returns from serve
+        let 流 = 服务器.连接();
+        (&流).write_all(b"GET /hello HTTP/1.1\r\nHost: x\r\n\r\n").unwrap();
+        assert_eq!(读取响应(&mut io::BufReader::new(&流)).0, 200);
+        let _ = 流.shutdown(Shutdown::Write);
+        drop(服务器);
+    }
+}
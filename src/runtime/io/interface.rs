@@ -7,10 +7,11 @@
 use std::sync::Arc;
 use std::sync::Mutex;
 use std::collections::HashMap;
-use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+use std::time::{Duration, Instant};
 
 use crate::runtime::{RuntimeResult, RuntimeError};
 use super::filesystem::FileSystemInterface;
+use super::metrics::{IoCategory, IoCounters, IoMetricsSnapshot, IoOpKind};
 use super::http::NetworkInterface;
 use super::stdio::{StandardIo, ConsoleInterface};
 
@@ -26,7 +27,7 @@ pub struct IoInterface {
     /// Console interface
     console: Arc<Mutex<ConsoleInterface>>,
     /// I/O statistics
-    stats: Arc<Mutex<IoStats>>,
+    stats: Arc<IoCounters>,
     /// Configuration
     config: Arc<Mutex<IoConfig>>,
 }
@@ -124,6 +125,29 @@ pub struct IoStats {
     pub last_operation_timestamp: Option<u64>,
 }
 
+impl From<&IoMetricsSnapshot> for IoStats {
+    fn from(snapshot: &IoMetricsSnapshot) -> Self {
+        let combined = snapshot.combined();
+        Self {
+            total_operations: snapshot.total_operations(),
+            file_operations: snapshot.category_operations(IoCategory::File),
+            network_operations: snapshot.category_operations(IoCategory::Network),
+            stdio_operations: snapshot.category_operations(IoCategory::Stdio),
+            total_bytes_read: snapshot.bytes_read(),
+            total_bytes_written: snapshot.bytes_written(),
+            cache_hits: 0,
+            cache_misses: 0,
+            operations_by_type: snapshot
+                .iter()
+                .filter(|(_, op)| op.operations + op.failures > 0)
+                .map(|(kind, op)| (kind.name().to_string(), op.operations + op.failures))
+                .collect(),
+            avg_operation_time_ms: combined.mean().as_secs_f64() * 1000.0,
+            last_operation_timestamp: snapshot.last_operation,
+        }
+    }
+}
+
 /// I/O operation context
 #[derive(Debug, Clone)]
 pub struct IoOperation {
@@ -162,7 +186,7 @@ impl IoInterface {
             network: Arc::new(Mutex::new(network)),
             stdio: Arc::new(Mutex::new(stdio)),
             console: Arc::new(Mutex::new(console)),
-            stats: Arc::new(Mutex::new(IoStats::default())),
+            stats: Arc::new(IoCounters::new()),
             config: Arc::new(Mutex::new(config)),
         })
     }
@@ -179,7 +203,7 @@ impl IoInterface {
             network: Arc::new(Mutex::new(network)),
             stdio: Arc::new(Mutex::new(stdio)),
             console: Arc::new(Mutex::new(console)),
-            stats: Arc::new(Mutex::new(IoStats::default())),
+            stats: Arc::new(IoCounters::new()),
             config: Arc::new(Mutex::new(config)),
         })
     }
@@ -189,25 +213,14 @@ impl IoInterface {
     /// Read file contents as string
     pub fn read_file(&self, path: &str) -> RuntimeResult<String> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("read_file");
 
         let result = {
             let fs = self.filesystem.lock().unwrap();
             fs.read_file_string(path)
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "read_file".to_string(),
-            resource: path.to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: result.as_ref().map(|s| s.len() as u64).unwrap_or(0),
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        let bytes = result.as_ref().map_or(0, |body| body.len() as u64);
+        self.stats.record_result(IoOpKind::FileRead, &result, bytes, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::io_error(e.to_string(), "文件读取失败".to_string()))
     }
@@ -215,25 +228,13 @@ impl IoInterface {
     /// Write string to file
     pub fn write_file(&self, path: &str, content: &str) -> RuntimeResult<()> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("write_file");
 
         let result = {
             let fs = self.filesystem.lock().unwrap();
             fs.write_file_string(path, content)
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "write_file".to_string(),
-            resource: path.to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: content.len() as u64,
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        self.stats.record_result(IoOpKind::FileWrite, &result, content.len() as u64, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::io_error(e.to_string(), "文件写入失败".to_string()))
     }
@@ -241,25 +242,13 @@ impl IoInterface {
     /// Append string to file
     pub fn append_file(&self, path: &str, content: &str) -> RuntimeResult<()> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("append_file");
 
         let result = {
             let fs = self.filesystem.lock().unwrap();
             fs.append_file_string(path, content)
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "append_file".to_string(),
-            resource: path.to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: content.len() as u64,
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        self.stats.record_result(IoOpKind::FileAppend, &result, content.len() as u64, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::io_error(e.to_string(), "文件追加失败".to_string()))
     }
@@ -309,7 +298,6 @@ impl IoInterface {
     /// Make HTTP GET request
     pub fn http_get(&self, url: &str) -> RuntimeResult<String> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("http_get");
 
         let config = self.config.lock().unwrap();
         let request = super::http::HttpRequest::get(url.to_string())
@@ -324,18 +312,8 @@ impl IoInterface {
             })
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "http_get".to_string(),
-            resource: url.to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: result.as_ref().map(|s| s.len() as u64).unwrap_or(0),
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        let bytes = result.as_ref().map_or(0, |body| body.len() as u64);
+        self.stats.record_result(IoOpKind::HttpGet, &result, bytes, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::network_error(e.to_string(), "HTTP请求失败".to_string()))
     }
@@ -343,7 +321,6 @@ impl IoInterface {
     /// Make HTTP POST request
     pub fn http_post(&self, url: &str, body: &str) -> RuntimeResult<String> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("http_post");
 
         let config = self.config.lock().unwrap();
         let request = super::http::HttpRequest::post(url.to_string(), body.as_bytes().to_vec())
@@ -358,18 +335,8 @@ impl IoInterface {
             })
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "http_post".to_string(),
-            resource: url.to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: result.as_ref().map(|s| s.len() as u64).unwrap_or(0),
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        let bytes = result.as_ref().map_or(0, |body| body.len() as u64);
+        self.stats.record_result(IoOpKind::HttpPost, &result, bytes, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::network_error(e.to_string(), "HTTP请求失败".to_string()))
     }
@@ -379,25 +346,13 @@ impl IoInterface {
     /// Print to standard output
     pub fn print(&self, text: &str) -> RuntimeResult<()> {
         let start_time = Instant::now();
-        let operation_id = self.generate_operation_id("print");
 
         let result = {
             let mut stdio = self.stdio.lock().unwrap();
             stdio.print(text)
         };
 
-        let duration = start_time.elapsed();
-        self.record_operation(&IoOperation {
-            id: operation_id,
-            operation_type: "print".to_string(),
-            resource: "stdout".to_string(),
-            timestamp: SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs(),
-            duration_ms: duration.as_millis() as f64,
-            bytes_transferred: text.len() as u64,
-            success: result.is_ok(),
-            error_message: result.as_ref().err().map(|e| e.to_string()),
-            metadata: HashMap::new(),
-        });
+        self.stats.record_result(IoOpKind::Print, &result, text.len() as u64, start_time.elapsed());
 
         result.map_err(|e| RuntimeError::io_error(e.to_string(), "标准输出失败".to_string()))
     }
@@ -442,6 +397,26 @@ impl IoInterface {
         result.map_err(|e| RuntimeError::io_error(e.to_string(), "标准输入失败".to_string()))
     }
 
+    /// Read the next integer from standard input (`None` at end of input)
+    pub fn read_int(&self) -> RuntimeResult<Option<i64>> {
+        let result = {
+            let mut stdio = self.stdio.lock().unwrap();
+            stdio.read_int()
+        };
+
+        result.map_err(|e| RuntimeError::io_error(e.to_string(), "标准输入失败".to_string()))
+    }
+
+    /// Read the next float from standard input (`None` at end of input)
+    pub fn read_float(&self) -> RuntimeResult<Option<f64>> {
+        let result = {
+            let mut stdio = self.stdio.lock().unwrap();
+            stdio.read_float()
+        };
+
+        result.map_err(|e| RuntimeError::io_error(e.to_string(), "标准输入失败".to_string()))
+    }
+
     /// Print to standard error
     pub fn eprint(&self, text: &str) -> RuntimeResult<()> {
         let result = {
@@ -518,8 +493,12 @@ impl IoInterface {
 
     /// Get I/O statistics
     pub fn get_io_stats(&self) -> RuntimeResult<IoStats> {
-        let stats = self.stats.lock().unwrap();
-        Ok(stats.clone())
+        Ok(IoStats::from(&self.stats.snapshot()))
+    }
+
+    /// Get per-operation counters and latency histograms
+    pub fn get_io_metrics(&self) -> IoMetricsSnapshot {
+        self.stats.snapshot()
     }
 
     /// Get configuration
@@ -536,8 +515,7 @@ impl IoInterface {
 
     /// Reset statistics
     pub fn reset_stats(&self) -> RuntimeResult<()> {
-        let mut stats = self.stats.lock().unwrap();
-        *stats = IoStats::default();
+        self.stats.reset();
         Ok(())
     }
 
@@ -562,62 +540,13 @@ impl IoInterface {
         }
 
         // Reset statistics
-        let mut stats = self.stats.lock().unwrap();
-        *stats = IoStats::default();
+        self.stats.reset();
 
         Ok(())
     }
 
     /// Private helper methods
 
-    fn generate_operation_id(&self, operation_type: &str) -> String {
-        format!("{}_{}", operation_type, SystemTime::now()
-            .duration_since(UNIX_EPOCH)
-            .unwrap_or_default()
-            .as_millis())
-    }
-
-    fn record_operation(&self, operation: &IoOperation) {
-        let mut stats = self.stats.lock().unwrap();
-
-        stats.total_operations += 1;
-        stats.last_operation_timestamp = Some(operation.timestamp);
-
-        // Update operation type counts
-        match operation.operation_type.as_str() {
-            op if op.starts_with("read_file") || op.starts_with("write_file") || op.starts_with("append_file") => {
-                stats.file_operations += 1;
-            }
-            op if op.starts_with("http_") => {
-                stats.network_operations += 1;
-            }
-            op if op.starts_with("print") || op.starts_with("read_line") => {
-                stats.stdio_operations += 1;
-            }
-            _ => {}
-        }
-
-        *stats.operations_by_type.entry(operation.operation_type.clone()).or_insert(0) += 1;
-
-        // Update byte counts
-        stats.total_bytes_read += if operation.operation_type.contains("read") || operation.operation_type.contains("get") {
-            operation.bytes_transferred
-        } else {
-            0
-        };
-        stats.total_bytes_written += if operation.operation_type.contains("write") || operation.operation_type.contains("post") || operation.operation_type.contains("print") {
-            operation.bytes_transferred
-        } else {
-            0
-        };
-
-        // Update average operation time
-        if stats.total_operations > 0 {
-            let total_time = stats.avg_operation_time_ms * (stats.total_operations - 1) as f64 + operation.duration_ms;
-            stats.avg_operation_time_ms = total_time / stats.total_operations as f64;
-        }
-    }
-
     fn map_string_to_color(&self, color_str: &str) -> RuntimeResult<super::stdio::ConsoleColor> {
         match color_str.to_lowercase().as_str() {
             "red" => Ok(super::stdio::ConsoleColor::Red),
@@ -717,6 +646,8 @@ mod tests {
 
         let stats = io_interface.get_io_stats().unwrap();
         assert!(stats.total_operations > 0);
+        assert_eq!(stats.stdio_operations, 1);
+        assert_eq!(stats.operations_by_type.get("print"), Some(&1));
 
         // Reset stats
         let _ = io_interface.reset_stats();
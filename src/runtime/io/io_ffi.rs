@@ -2,11 +2,14 @@
 //!
 //! 为 Qi 语言提供 C 接口的文件操作函数
 
-use super::file::{文件模块, 文件操作};
+use super::file::{文件模块, 文件操作, 文件视图, 行读取器, 追加器};
+use super::slab::HandleSlab;
 use crate::runtime::stdlib::StdlibValue;
+use std::collections::HashMap;
 use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
-use std::sync::OnceLock;
+use std::sync::atomic::{AtomicI64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
 
 // 全局文件模块实例
 static 全局文件模块: OnceLock<文件模块> = OnceLock::new();
@@ -22,6 +25,9 @@ pub extern "C" fn qi_io_init() {
 }
 
 /// 读取文件内容
+///
+/// 总是把文件复制到新分配的字符串中返回，之后对文件的修改或截断不会影响它。
+/// 需要零复制读取时使用 `qi_io_open_view`。返回值必须用 `qi_io_free_string` 释放。
 #[no_mangle]
 pub extern "C" fn qi_io_read_file(path: *const c_char) -> *mut c_char {
     if path.is_null() {
@@ -202,6 +208,273 @@ pub extern "C" fn qi_io_delete_dir(path: *const c_char) -> i64 {
     }
 }
 
+/// 复制文件，返回复制的字节数（失败返回 -1）
+#[no_mangle]
+pub extern "C" fn qi_io_copy_file(from: *const c_char, to: *const c_char) -> i64 {
+    if from.is_null() || to.is_null() {
+        return -1;
+    }
+
+    unsafe {
+        let 源路径 = CStr::from_ptr(from).to_string_lossy().to_string();
+        let 目标路径 = CStr::from_ptr(to).to_string_lossy().to_string();
+        let 参数 = vec![
+            StdlibValue::String(源路径),
+            StdlibValue::String(目标路径),
+        ];
+
+        let 模块 = 获取文件模块();
+        match 模块.执行操作(文件操作::复制, &参数) {
+            Ok(StdlibValue::Integer(字节数)) => 字节数,
+            _ => -1,
+        }
+    }
+}
+
+/// 并行递归遍历目录，返回以换行分隔的文件路径（需用 `qi_io_free_string` 释放）
+///
+/// `pattern` 为空字符串时返回全部文件；`max_depth` 为 0 表示不限深度。
+#[no_mangle]
+pub extern "C" fn qi_io_walk_dir(path: *const c_char, pattern: *const c_char, max_depth: i64) -> *mut c_char {
+    if path.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    unsafe {
+        let 路径 = CStr::from_ptr(path).to_string_lossy().to_string();
+        let 模式 = if pattern.is_null() {
+            String::new()
+        } else {
+            CStr::from_ptr(pattern).to_string_lossy().to_string()
+        };
+        let 参数 = vec![
+            StdlibValue::String(路径),
+            StdlibValue::String(模式),
+            StdlibValue::Integer(max_depth),
+        ];
+
+        let 模块 = 获取文件模块();
+        match 模块.执行操作(文件操作::遍历目录, &参数) {
+            Ok(StdlibValue::Array(条目)) => {
+                let 列表: Vec<String> = 条目.into_iter().filter_map(|v| v.as_string()).collect();
+                CString::new(列表.join("\n")).map_or(std::ptr::null_mut(), CString::into_raw)
+            }
+            _ => std::ptr::null_mut(),
+        }
+    }
+}
+
+// 追加器表：查表后立即释放表锁，持久追加等待组提交时不阻塞其他句柄
+static 追加器表: OnceLock<Mutex<HashMap<i64, Arc<追加器>>>> = OnceLock::new();
+static 下一个追加器句柄: AtomicI64 = AtomicI64::new(1);
+
+fn 获取追加器表() -> &'static Mutex<HashMap<i64, Arc<追加器>>> {
+    追加器表.get_or_init(|| Mutex::new(HashMap::new()))
+}
+
+fn 查找追加器(handle: i64) -> Option<Arc<追加器>> {
+    获取追加器表().lock().unwrap().get(&handle).cloned()
+}
+
+/// 打开持久追加器，返回句柄（失败返回 0）
+///
+/// `durable` 非零时每次追加在数据落盘后返回，并发追加共享一次同步。
+#[no_mangle]
+pub extern "C" fn qi_io_open_appender(path: *const c_char, durable: i64) -> i64 {
+    if path.is_null() {
+        return 0;
+    }
+
+    let 路径 = unsafe { CStr::from_ptr(path).to_string_lossy().to_string() };
+    match 获取文件模块().打开追加器(&路径, durable != 0) {
+        Ok(追加) => {
+            let 句柄 = 下一个追加器句柄.fetch_add(1, Ordering::Relaxed);
+            获取追加器表().lock().unwrap().insert(句柄, Arc::new(追加));
+            句柄
+        }
+        Err(_) => 0,
+    }
+}
+
+/// 通过追加器追加内容
+#[no_mangle]
+pub extern "C" fn qi_io_appender_append(handle: i64, content: *const c_char) -> i64 {
+    if content.is_null() {
+        return 0;
+    }
+
+    let Some(追加) = 查找追加器(handle) else {
+        return 0;
+    };
+    let 内容 = unsafe { CStr::from_ptr(content).to_bytes() };
+    match 追加.追加(内容) {
+        Ok(()) => 1,
+        Err(_) => 0,
+    }
+}
+
+/// 将追加器缓冲的内容写入文件
+#[no_mangle]
+pub extern "C" fn qi_io_appender_flush(handle: i64) -> i64 {
+    match 查找追加器(handle).map(|追加| 追加.刷新()) {
+        Some(Ok(())) => 1,
+        _ => 0,
+    }
+}
+
+/// 关闭追加器，写入剩余内容
+#[no_mangle]
+pub extern "C" fn qi_io_close_appender(handle: i64) -> i64 {
+    let 追加 = 获取追加器表().lock().unwrap().remove(&handle);
+    match 追加.map(|追加| 追加.刷新()) {
+        Some(Ok(())) => 1,
+        _ => 0,
+    }
+}
+
+/// 逐行读取器及其复用的行缓冲区
+struct 行句柄 {
+    读取器: 行读取器,
+    行缓冲: Vec<u8>,
+}
+
+// 每个句柄独占一个槽位锁，阻塞读取只锁住自己的读取器
+static 行读取器表: OnceLock<HandleSlab<行句柄>> = OnceLock::new();
+
+fn 获取行读取器表() -> &'static HandleSlab<行句柄> {
+    行读取器表.get_or_init(HandleSlab::new)
+}
+
+/// 打开文件进行逐行读取，返回句柄（失败返回 0）
+#[no_mangle]
+pub extern "C" fn qi_io_open_lines(path: *const c_char) -> i64 {
+    if path.is_null() {
+        return 0;
+    }
+
+    let 路径 = unsafe { CStr::from_ptr(path).to_string_lossy().to_string() };
+    match 获取文件模块().逐行读取(&路径) {
+        Ok(读取器) => 获取行读取器表()
+            .insert(行句柄 { 读取器, 行缓冲: Vec::new() })
+            .unwrap_or(0),
+        Err(_) => 0,
+    }
+}
+
+/// 读取下一行（不含换行符），文件结束或出错时返回空指针
+///
+/// Qi 字符串以 NUL 结尾，而扫描器给出的行直接指向只读映射或读缓冲区，
+/// 行尾没有可写的结束符，所以这里把行复制到句柄复用的缓冲区后再补 NUL。
+/// 返回的字符串在同一句柄的下一次调用或关闭前有效，不要释放。
+/// 不需要 C 字符串时用 `qi_io_next_line_bytes` 免去复制。
+#[no_mangle]
+pub extern "C" fn qi_io_next_line(handle: i64) -> *mut c_char {
+    获取行读取器表()
+        .with(handle, |行句柄 { 读取器, 行缓冲 }| match 读取器.下一行字节() {
+            Ok(Some(行)) => {
+                行缓冲.clear();
+                行缓冲.extend_from_slice(行);
+                行缓冲.push(0);
+                行缓冲.as_mut_ptr() as *mut c_char
+            }
+            _ => std::ptr::null_mut(),
+        })
+        .unwrap_or(std::ptr::null_mut())
+}
+
+/// 读取下一行的原始字节（不含换行符，不复制），文件结束或出错时返回空指针
+///
+/// 行长度写入 `len`。返回的指针直接指向读取器的映射或缓冲区，不以 NUL
+/// 结尾，在同一句柄的下一次调用或关闭前有效，不要释放。
+#[no_mangle]
+pub extern "C" fn qi_io_next_line_bytes(handle: i64, len: *mut i64) -> *const u8 {
+    if len.is_null() {
+        return std::ptr::null();
+    }
+
+    // 读取器留在槽位中不会移动，返回的切片在释放槽位锁后仍然有效
+    let 行 = 获取行读取器表()
+        .with(handle, |行句柄| match 行句柄.读取器.下一行字节() {
+            Ok(Some(行)) => Some((行.as_ptr(), 行.len())),
+            _ => None,
+        })
+        .flatten();
+    match 行 {
+        Some((指针, 长度)) => {
+            unsafe { *len = 长度 as i64 };
+            指针
+        }
+        None => {
+            unsafe { *len = 0 };
+            std::ptr::null()
+        }
+    }
+}
+
+/// 关闭逐行读取器
+#[no_mangle]
+pub extern "C" fn qi_io_close_lines(handle: i64) -> i64 {
+    match 获取行读取器表().remove(handle) {
+        Some(_) => 1,
+        None => 0,
+    }
+}
+
+static 文件视图表: OnceLock<HandleSlab<文件视图>> = OnceLock::new();
+
+fn 获取文件视图表() -> &'static HandleSlab<文件视图> {
+    文件视图表.get_or_init(HandleSlab::new)
+}
+
+/// 打开只读文件视图，返回句柄（失败返回 0）
+///
+/// 常规文件通过 mmap 映射，不复制内容。用 `qi_io_view_bytes` 借用内容，
+/// 用完后必须用 `qi_io_close_view` 释放映射。
+#[no_mangle]
+pub extern "C" fn qi_io_open_view(path: *const c_char) -> i64 {
+    if path.is_null() {
+        return 0;
+    }
+
+    let 路径 = unsafe { CStr::from_ptr(path).to_string_lossy().to_string() };
+    match 获取文件模块().映射读取(&路径) {
+        Ok(视图) => 获取文件视图表().insert(视图).unwrap_or(0),
+        Err(_) => 0,
+    }
+}
+
+/// 借用文件视图的字节，长度写入 `len`；无效句柄返回空指针
+///
+/// 返回的指针不以 NUL 结尾，内容不保证是 UTF-8，在 `qi_io_close_view`
+/// 前有效，不要释放。文件在此期间被修改会直接反映到借出的字节中。
+#[no_mangle]
+pub extern "C" fn qi_io_view_bytes(handle: i64, len: *mut i64) -> *const u8 {
+    if len.is_null() {
+        return std::ptr::null();
+    }
+
+    // 映射和内存缓冲都不随槽位锁释放而移动，借出的指针在关闭前有效
+    match 获取文件视图表().with(handle, |视图| (视图.字节().as_ptr(), 视图.长度())) {
+        Some((指针, 长度)) => {
+            unsafe { *len = 长度 as i64 };
+            指针
+        }
+        None => {
+            unsafe { *len = 0 };
+            std::ptr::null()
+        }
+    }
+}
+
+/// 关闭文件视图并释放映射
+#[no_mangle]
+pub extern "C" fn qi_io_close_view(handle: i64) -> i64 {
+    match 获取文件视图表().remove(handle) {
+        Some(_) => 1,
+        None => 0,
+    }
+}
+
 /// 释放字符串内存
 #[no_mangle]
 pub extern "C" fn qi_io_free_string(s: *mut c_char) {
@@ -239,6 +512,95 @@ mod tests {
         let _ = std::fs::remove_file("/tmp/test_qi_ffi.txt");
     }
 
+    #[test]
+    fn test_line_reader_ffi() {
+        let 路径 = "/tmp/test_qi_lines_ffi.txt";
+        std::fs::write(路径, "甲\n乙\r\n丙").unwrap();
+        let path = CString::new(路径).unwrap();
+
+        let handle = qi_io_open_lines(path.as_ptr());
+        assert!(handle > 0);
+
+        let mut lines = Vec::new();
+        loop {
+            let line = qi_io_next_line(handle);
+            if line.is_null() {
+                break;
+            }
+            lines.push(unsafe { CStr::from_ptr(line).to_string_lossy().into_owned() });
+        }
+        assert_eq!(lines, vec!["甲", "乙", "丙"]);
+
+        assert_eq!(qi_io_close_lines(handle), 1);
+        assert!(qi_io_next_line(handle).is_null());
+
+        // 字节接口直接借出读取器中的行
+        let handle = qi_io_open_lines(path.as_ptr());
+        let mut lines = Vec::new();
+        let mut len = -1;
+        loop {
+            let line = qi_io_next_line_bytes(handle, &mut len);
+            if line.is_null() {
+                break;
+            }
+            lines.push(unsafe { std::slice::from_raw_parts(line, len as usize) }.to_vec());
+        }
+        assert_eq!(len, 0);
+        assert_eq!(lines, vec!["甲".as_bytes(), "乙".as_bytes(), "丙".as_bytes()]);
+        assert_eq!(qi_io_close_lines(handle), 1);
+        assert!(qi_io_next_line_bytes(handle, &mut len).is_null());
+
+        let _ = std::fs::remove_file(路径);
+    }
+
+    #[test]
+    fn test_file_view_ffi() {
+        let 路径 = "/tmp/test_qi_view_ffi.txt";
+        std::fs::write(路径, "视图内容").unwrap();
+        let path = CString::new(路径).unwrap();
+
+        let handle = qi_io_open_view(path.as_ptr());
+        assert!(handle > 0);
+
+        let mut len = 0;
+        let bytes = qi_io_view_bytes(handle, &mut len);
+        assert!(!bytes.is_null());
+        assert_eq!(unsafe { std::slice::from_raw_parts(bytes, len as usize) }, "视图内容".as_bytes());
+
+        assert_eq!(qi_io_close_view(handle), 1);
+        assert!(qi_io_view_bytes(handle, &mut len).is_null());
+        assert_eq!(len, 0);
+        assert_eq!(qi_io_close_view(handle), 0);
+
+        let missing = CString::new("/tmp/不存在的视图_qi.txt").unwrap();
+        assert_eq!(qi_io_open_view(missing.as_ptr()), 0);
+
+        let _ = std::fs::remove_file(路径);
+    }
+
+    #[test]
+    fn test_copy_and_appender_ffi() {
+        let 源 = CString::new("/tmp/test_qi_copy_ffi_src.txt").unwrap();
+        let 目标 = CString::new("/tmp/test_qi_copy_ffi_dst.txt").unwrap();
+        let 内容 = CString::new("原始").unwrap();
+        assert_eq!(qi_io_write_file(源.as_ptr(), 内容.as_ptr()), 1);
+
+        assert_eq!(qi_io_copy_file(源.as_ptr(), 目标.as_ptr()), 6);
+
+        let handle = qi_io_open_appender(目标.as_ptr(), 0);
+        assert!(handle > 0);
+        for 片段 in ["甲", "乙", "丙"] {
+            let 片段 = CString::new(片段).unwrap();
+            assert_eq!(qi_io_appender_append(handle, 片段.as_ptr()), 1);
+        }
+        assert_eq!(qi_io_close_appender(handle), 1);
+        assert_eq!(qi_io_appender_append(handle, 内容.as_ptr()), 0);
+        assert_eq!(std::fs::read_to_string("/tmp/test_qi_copy_ffi_dst.txt").unwrap(), "原始甲乙丙");
+
+        let _ = std::fs::remove_file("/tmp/test_qi_copy_ffi_src.txt");
+        let _ = std::fs::remove_file("/tmp/test_qi_copy_ffi_dst.txt");
+    }
+
     #[test]
     fn test_file_exists_ffi() {
         let path = CString::new("/tmp/test_qi_exists_ffi.txt").unwrap();
@@ -0,0 +1,489 @@
+//! TCP Listener
+//!
+//! Server side of the network module. A listener owns one listening socket
+//! per acceptor worker, all bound to the same address with `SO_REUSEPORT`,
+//! so the kernel spreads incoming connections across the acceptors instead
+//! of waking all of them on one shared queue. Sockets are non-blocking and
+//! connections are taken with `accept4(SOCK_NONBLOCK | SOCK_CLOEXEC)`;
+//! acceptors wait in `poll` in short slices so a closed listener is noticed
+//! promptly.
+
+use std::io;
+use std::net::{SocketAddr, TcpListener as StdTcpListener, TcpStream, ToSocketAddrs};
+use std::os::unix::io::{AsRawFd, FromRawFd, RawFd};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+use super::http::TcpConnection;
+use super::{IoError, IoResult};
+
+/// Default length of each socket's pending-connection queue
+pub const DEFAULT_BACKLOG: i32 = 1024;
+/// Longest single wait in `poll` before re-checking for shutdown
+const ACCEPT_POLL_MS: i32 = 100;
+/// Pause after running out of descriptors before accepting again
+const ACCEPT_BACKOFF: Duration = Duration::from_millis(10);
+
+/// Listener configuration
+#[derive(Debug, Clone)]
+pub struct ListenerConfig {
+    /// Local address to bind
+    pub host: String,
+    /// Local port; 0 picks a free port shared by every acceptor
+    pub port: u16,
+    /// Pending-connection queue length per acceptor socket
+    pub backlog: i32,
+    /// Number of acceptor sockets
+    pub workers: usize,
+}
+
+impl ListenerConfig {
+    /// Create configuration with one acceptor per runtime worker
+    pub fn new(host: String, port: u16) -> Self {
+        Self {
+            host,
+            port,
+            backlog: DEFAULT_BACKLOG,
+            workers: crate::runtime::async_runtime::PoolConfig::default().worker_count.max(1),
+        }
+    }
+
+    /// Set backlog
+    pub fn with_backlog(mut self, backlog: i32) -> Self {
+        self.backlog = backlog;
+        self
+    }
+
+    /// Set number of acceptor sockets
+    pub fn with_workers(mut self, workers: usize) -> Self {
+        self.workers = workers.max(1);
+        self
+    }
+}
+
+/// TCP listener with one `SO_REUSEPORT` socket per acceptor
+#[derive(Debug)]
+pub struct TcpListener {
+    sockets: Vec<StdTcpListener>,
+    local_addr: SocketAddr,
+    closed: AtomicBool,
+    /// Rotates the first socket tried by `accept`
+    next_socket: AtomicUsize,
+}
+
+impl TcpListener {
+    /// Bind and listen on every acceptor socket
+    pub fn bind(config: &ListenerConfig) -> IoResult<Self> {
+        let endpoint = format!("{}:{}", config.host, config.port);
+        let mut addr = endpoint
+            .to_socket_addrs()
+            .map_err(|e| IoError::NetworkOperationFailed {
+                endpoint: endpoint.clone(),
+                message: format!("解析地址失败: {}", e),
+            })?
+            .next()
+            .ok_or_else(|| IoError::NetworkOperationFailed {
+                endpoint: endpoint.clone(),
+                message: "无法解析地址".to_string(),
+            })?;
+
+        let backlog = if config.backlog > 0 { config.backlog } else { DEFAULT_BACKLOG };
+        let mut sockets = Vec::with_capacity(config.workers.max(1));
+        for _ in 0..config.workers.max(1) {
+            let socket = listen_reuse_port(&addr, backlog).map_err(|e| IoError::NetworkOperationFailed {
+                endpoint: addr.to_string(),
+                message: format!("监听失败: {}", e),
+            })?;
+            // With port 0 the first bind picks the port; the others join it
+            if addr.port() == 0 {
+                addr = socket.local_addr()?;
+            }
+            sockets.push(socket);
+        }
+
+        Ok(Self {
+            sockets,
+            local_addr: addr,
+            closed: AtomicBool::new(false),
+            next_socket: AtomicUsize::new(0),
+        })
+    }
+
+    /// Get the bound address
+    pub fn local_addr(&self) -> SocketAddr {
+        self.local_addr
+    }
+
+    /// Get number of acceptor sockets
+    pub fn worker_count(&self) -> usize {
+        self.sockets.len()
+    }
+
+    /// Accept from whichever acceptor socket is ready first
+    ///
+    /// `None` as timeout waits until a connection arrives or the listener
+    /// is closed. Returns `Ok(None)` on timeout or after `close`.
+    pub fn accept(&self, timeout: Option<Duration>) -> IoResult<Option<(TcpStream, SocketAddr)>> {
+        let fds: Vec<RawFd> = self.sockets.iter().map(|socket| socket.as_raw_fd()).collect();
+        self.accept_from(&fds, timeout)
+    }
+
+    /// Accept only from the socket owned by acceptor `worker`
+    pub fn accept_on(&self, worker: usize, timeout: Option<Duration>) -> IoResult<Option<(TcpStream, SocketAddr)>> {
+        let socket = self.sockets.get(worker).ok_or_else(|| IoError::ResourceNotFound {
+            resource: format!("接收器 {}", worker),
+        })?;
+        self.accept_from(&[socket.as_raw_fd()], timeout)
+    }
+
+    /// Run the server loop until the listener is closed
+    ///
+    /// Each acceptor socket gets its own thread, and every accepted
+    /// connection runs `handler` on a fresh thread, as `启动` does for
+    /// goroutines. Returns once the listener is closed and all handlers
+    /// have finished.
+    pub fn serve<F>(&self, handler: F) -> IoResult<()>
+    where
+        F: Fn(TcpConnection) + Sync,
+    {
+        self.serve_streams(|stream, peer| handler(TcpConnection::from_accepted(stream, peer)))
+    }
+
+    /// Like `serve`, but hands each handler the raw non-blocking stream
+    pub fn serve_streams<F>(&self, handler: F) -> IoResult<()>
+    where
+        F: Fn(TcpStream, SocketAddr) + Sync,
+    {
+        let handler = &handler;
+        std::thread::scope(|scope| {
+            let acceptors: Vec<_> = (0..self.sockets.len())
+                .map(|worker| {
+                    scope.spawn(move || -> IoResult<()> {
+                        loop {
+                            match self.accept_on(worker, None) {
+                                Ok(Some((stream, peer))) => {
+                                    scope.spawn(move || handler(stream, peer));
+                                }
+                                Ok(None) => return Ok(()),
+                                Err(IoError::SystemIoError(e)) if is_resource_exhausted(&e) => {
+                                    std::thread::sleep(ACCEPT_BACKOFF);
+                                }
+                                Err(e) => {
+                                    self.close();
+                                    return Err(e);
+                                }
+                            }
+                        }
+                    })
+                })
+                .collect();
+
+            acceptors
+                .into_iter()
+                .map(|acceptor| acceptor.join().unwrap_or(Ok(())))
+                .collect::<IoResult<Vec<()>>>()
+                .map(|_| ())
+        })
+    }
+
+    /// Stop accepting; blocked `accept` calls and `serve` loops return
+    pub fn close(&self) {
+        if !self.closed.swap(true, Ordering::AcqRel) {
+            for socket in &self.sockets {
+                // Wakes pollers on Linux; elsewhere the poll slice expires
+                unsafe { libc::shutdown(socket.as_raw_fd(), libc::SHUT_RD) };
+            }
+        }
+    }
+
+    /// Check whether `close` has been called
+    pub fn is_closed(&self) -> bool {
+        self.closed.load(Ordering::Acquire)
+    }
+
+    fn accept_from(&self, fds: &[RawFd], timeout: Option<Duration>) -> IoResult<Option<(TcpStream, SocketAddr)>> {
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        let mut pollfds: Vec<libc::pollfd> = fds
+            .iter()
+            .map(|&fd| libc::pollfd { fd, events: libc::POLLIN, revents: 0 })
+            .collect();
+
+        loop {
+            if self.is_closed() {
+                return Ok(None);
+            }
+
+            // Drain whatever is already queued before sleeping in poll
+            let start = self.next_socket.fetch_add(1, Ordering::Relaxed);
+            for offset in 0..fds.len() {
+                if let Some(accepted) = try_accept(fds[(start + offset) % fds.len()])? {
+                    return Ok(Some(accepted));
+                }
+            }
+
+            let slice = match deadline {
+                Some(deadline) => {
+                    let remaining = deadline.saturating_duration_since(Instant::now());
+                    if remaining.is_zero() {
+                        return Ok(None);
+                    }
+                    (remaining.as_millis() as i32).clamp(1, ACCEPT_POLL_MS)
+                }
+                None => ACCEPT_POLL_MS,
+            };
+            let ready = unsafe { libc::poll(pollfds.as_mut_ptr(), pollfds.len() as libc::nfds_t, slice) };
+            if ready < 0 {
+                let error = io::Error::last_os_error();
+                if error.kind() != io::ErrorKind::Interrupted {
+                    return Err(error.into());
+                }
+            }
+        }
+    }
+}
+
+impl Drop for TcpListener {
+    fn drop(&mut self) {
+        self.close();
+    }
+}
+
+/// Create a non-blocking listening socket bound with `SO_REUSEPORT`
+fn listen_reuse_port(addr: &SocketAddr, backlog: i32) -> io::Result<StdTcpListener> {
+    let domain = if addr.is_ipv4() { libc::AF_INET } else { libc::AF_INET6 };
+    let fd = new_socket(domain)?;
+    // Owns the descriptor from here on, so early returns close it
+    let listener = unsafe { StdTcpListener::from_raw_fd(fd) };
+
+    for option in [libc::SO_REUSEADDR, libc::SO_REUSEPORT] {
+        set_int_option(fd, libc::SOL_SOCKET, option, 1)?;
+    }
+
+    let (storage, length) = socket_addr_to_raw(addr);
+    if unsafe { libc::bind(fd, &storage as *const _ as *const libc::sockaddr, length) } < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    if unsafe { libc::listen(fd, backlog) } < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    listener.set_nonblocking(true)?;
+    Ok(listener)
+}
+
+#[cfg(target_os = "linux")]
+fn new_socket(domain: libc::c_int) -> io::Result<RawFd> {
+    let fd = unsafe { libc::socket(domain, libc::SOCK_STREAM | libc::SOCK_CLOEXEC, 0) };
+    if fd < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(fd)
+}
+
+#[cfg(not(target_os = "linux"))]
+fn new_socket(domain: libc::c_int) -> io::Result<RawFd> {
+    let fd = unsafe { libc::socket(domain, libc::SOCK_STREAM, 0) };
+    if fd < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    unsafe { libc::fcntl(fd, libc::F_SETFD, libc::FD_CLOEXEC) };
+    Ok(fd)
+}
+
+/// Accept one pending connection; `Ok(None)` when the queue is empty
+fn try_accept(fd: RawFd) -> io::Result<Option<(TcpStream, SocketAddr)>> {
+    loop {
+        let mut storage: libc::sockaddr_storage = unsafe { std::mem::zeroed() };
+        let mut length = std::mem::size_of::<libc::sockaddr_storage>() as libc::socklen_t;
+        let client = accept_nonblocking(fd, &mut storage, &mut length);
+        if client < 0 {
+            let error = io::Error::last_os_error();
+            match error.raw_os_error() {
+                Some(code) if code == libc::EAGAIN || code == libc::EWOULDBLOCK => return Ok(None),
+                // The peer gave up before we got to it, or a signal arrived
+                Some(libc::ECONNABORTED) | Some(libc::EINTR) => continue,
+                // Raced with `close` shutting the socket down
+                Some(libc::EINVAL) => return Ok(None),
+                _ => return Err(error),
+            }
+        }
+        let stream = unsafe { TcpStream::from_raw_fd(client) };
+        let peer = match raw_to_socket_addr(&storage) {
+            Some(peer) => peer,
+            None => stream.peer_addr()?,
+        };
+        return Ok(Some((stream, peer)));
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn accept_nonblocking(fd: RawFd, storage: &mut libc::sockaddr_storage, length: &mut libc::socklen_t) -> RawFd {
+    unsafe {
+        libc::accept4(
+            fd,
+            storage as *mut _ as *mut libc::sockaddr,
+            length,
+            libc::SOCK_NONBLOCK | libc::SOCK_CLOEXEC,
+        )
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn accept_nonblocking(fd: RawFd, storage: &mut libc::sockaddr_storage, length: &mut libc::socklen_t) -> RawFd {
+    let client = unsafe { libc::accept(fd, storage as *mut _ as *mut libc::sockaddr, length) };
+    if client >= 0 {
+        unsafe {
+            let flags = libc::fcntl(client, libc::F_GETFL);
+            libc::fcntl(client, libc::F_SETFL, flags | libc::O_NONBLOCK);
+            libc::fcntl(client, libc::F_SETFD, libc::FD_CLOEXEC);
+        }
+    }
+    client
+}
+
+fn is_resource_exhausted(error: &io::Error) -> bool {
+    matches!(
+        error.raw_os_error(),
+        Some(libc::EMFILE) | Some(libc::ENFILE) | Some(libc::ENOBUFS) | Some(libc::ENOMEM)
+    )
+}
+
+pub(super) fn set_int_option(fd: RawFd, level: libc::c_int, name: libc::c_int, value: libc::c_int) -> io::Result<()> {
+    let result = unsafe {
+        libc::setsockopt(
+            fd,
+            level,
+            name,
+            &value as *const _ as *const libc::c_void,
+            std::mem::size_of::<libc::c_int>() as libc::socklen_t,
+        )
+    };
+    if result < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(())
+    }
+}
+
+pub(super) fn socket_addr_to_raw(addr: &SocketAddr) -> (libc::sockaddr_storage, libc::socklen_t) {
+    let mut storage: libc::sockaddr_storage = unsafe { std::mem::zeroed() };
+    let length = match addr {
+        SocketAddr::V4(v4) => {
+            let raw = unsafe { &mut *(&mut storage as *mut _ as *mut libc::sockaddr_in) };
+            raw.sin_family = libc::AF_INET as libc::sa_family_t;
+            raw.sin_port = v4.port().to_be();
+            raw.sin_addr = libc::in_addr { s_addr: u32::from_ne_bytes(v4.ip().octets()) };
+            std::mem::size_of::<libc::sockaddr_in>()
+        }
+        SocketAddr::V6(v6) => {
+            let raw = unsafe { &mut *(&mut storage as *mut _ as *mut libc::sockaddr_in6) };
+            raw.sin6_family = libc::AF_INET6 as libc::sa_family_t;
+            raw.sin6_port = v6.port().to_be();
+            raw.sin6_flowinfo = v6.flowinfo();
+            raw.sin6_addr = libc::in6_addr { s6_addr: v6.ip().octets() };
+            raw.sin6_scope_id = v6.scope_id();
+            std::mem::size_of::<libc::sockaddr_in6>()
+        }
+    };
+    (storage, length as libc::socklen_t)
+}
+
+pub(super) fn raw_to_socket_addr(storage: &libc::sockaddr_storage) -> Option<SocketAddr> {
+    match storage.ss_family as libc::c_int {
+        libc::AF_INET => {
+            let raw = unsafe { &*(storage as *const _ as *const libc::sockaddr_in) };
+            let ip = std::net::Ipv4Addr::from(raw.sin_addr.s_addr.to_ne_bytes());
+            Some(SocketAddr::from((ip, u16::from_be(raw.sin_port))))
+        }
+        libc::AF_INET6 => {
+            let raw = unsafe { &*(storage as *const _ as *const libc::sockaddr_in6) };
+            let ip = std::net::Ipv6Addr::from(raw.sin6_addr.s6_addr);
+            Some(SocketAddr::V6(std::net::SocketAddrV6::new(
+                ip,
+                u16::from_be(raw.sin6_port),
+                raw.sin6_flowinfo,
+                raw.sin6_scope_id,
+            )))
+        }
+        _ => None,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::{Read, Write};
+
+    fn 本地监听(workers: usize) -> TcpListener {
+        TcpListener::bind(&ListenerConfig::new("127.0.0.1".to_string(), 0).with_workers(workers)).unwrap()
+    }
+
+    #[test]
+    fn test_reuse_port_sockets_share_address() {
+        let listener = 本地监听(4);
+        assert_eq!(listener.worker_count(), 4);
+        assert_ne!(listener.local_addr().port(), 0);
+        for socket in &listener.sockets {
+            assert_eq!(socket.local_addr().unwrap(), listener.local_addr());
+        }
+    }
+
+    #[test]
+    fn test_accept_timeout_and_nonblocking_stream() {
+        let listener = 本地监听(2);
+        assert!(listener.accept(Some(Duration::from_millis(20))).unwrap().is_none());
+
+        let mut client = TcpStream::connect(listener.local_addr()).unwrap();
+        let (stream, peer) = listener.accept(Some(Duration::from_secs(5))).unwrap().unwrap();
+        assert_eq!(peer, client.local_addr().unwrap());
+
+        // Accepted sockets are non-blocking; the connection wrapper waits for readiness
+        let mut probe = [0u8; 1];
+        assert_eq!((&stream).read(&mut probe).unwrap_err().kind(), io::ErrorKind::WouldBlock);
+        let connection = TcpConnection::from_accepted(stream, peer);
+        client.write_all(b"hi").unwrap();
+        let mut buffer = [0u8; 2];
+        let mut filled = 0;
+        while filled < 2 {
+            filled += connection.read(&mut buffer[filled..]).unwrap();
+        }
+        assert_eq!(&buffer, b"hi");
+    }
+
+    #[test]
+    fn test_serve_echo_until_closed() {
+        let listener = 本地监听(3);
+        let addr = listener.local_addr();
+        std::thread::scope(|scope| {
+            let server = scope.spawn(|| {
+                listener.serve(|connection| {
+                    let mut buffer = [0u8; 256];
+                    while let Ok(n) = connection.read(&mut buffer) {
+                        if n == 0 || connection.write(&buffer[..n]).is_err() {
+                            break;
+                        }
+                    }
+                })
+            });
+
+            let clients: Vec<_> = (0..32)
+                .map(|i| {
+                    scope.spawn(move || {
+                        let mut stream = TcpStream::connect(addr).unwrap();
+                        let message = format!("客户端{}", i);
+                        stream.write_all(message.as_bytes()).unwrap();
+                        let mut echo = vec![0u8; message.len()];
+                        stream.read_exact(&mut echo).unwrap();
+                        assert_eq!(echo, message.as_bytes());
+                    })
+                })
+                .collect();
+            for client in clients {
+                client.join().unwrap();
+            }
+
+            listener.close();
+            server.join().unwrap().unwrap();
+        });
+        assert!(listener.accept(None).unwrap().is_none());
+    }
+}
@@ -0,0 +1,147 @@
+//! Memory-Mapped Files
+//!
+//! Read-only `mmap` wrapper used by the bulk input paths. Regular files are
+//! mapped instead of being copied into heap buffers; pipes, terminals and
+//! sockets are reported as not mappable so callers can fall back to
+//! buffered reads.
+
+use std::fs::File;
+use std::io;
+use std::path::Path;
+
+/// Read-only memory mapping of a whole file
+///
+/// The mapping reflects the file, not a snapshot: writes to the file show
+/// through, and truncating it while mapped makes reads past the new end
+/// raise SIGBUS. Only hand the bytes out where that lifetime is documented.
+pub struct MappedFile {
+    ptr: *const u8,
+    len: usize,
+}
+
+// The mapping is read-only and private, so sharing it across threads is safe
+unsafe impl Send for MappedFile {}
+unsafe impl Sync for MappedFile {}
+
+impl MappedFile {
+    /// Map the file at `path`; `Ok(None)` if it is not a regular file
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Option<Self>> {
+        let file = File::open(path)?;
+        Self::from_file(&file)
+    }
+
+    /// Map an open file; the mapping stays valid after the file is closed
+    #[cfg(unix)]
+    pub fn from_file(file: &File) -> io::Result<Option<Self>> {
+        use std::os::unix::io::AsRawFd;
+        Self::from_fd(file.as_raw_fd())
+    }
+
+    /// Map an open file (memory mapping is only supported on Unix)
+    #[cfg(not(unix))]
+    pub fn from_file(_file: &File) -> io::Result<Option<Self>> {
+        Ok(None)
+    }
+
+    /// Map the whole file behind a raw descriptor
+    ///
+    /// Returns `Ok(None)` when the descriptor does not refer to a regular
+    /// file, since pipes and terminals cannot be mapped.
+    #[cfg(unix)]
+    pub fn from_fd(fd: std::os::unix::io::RawFd) -> io::Result<Option<Self>> {
+        let mut stat: libc::stat = unsafe { std::mem::zeroed() };
+        if unsafe { libc::fstat(fd, &mut stat) } != 0 {
+            return Err(io::Error::last_os_error());
+        }
+        if stat.st_mode & libc::S_IFMT != libc::S_IFREG {
+            return Ok(None);
+        }
+
+        let len = stat.st_size as usize;
+        if len == 0 {
+            return Ok(Some(Self::empty()));
+        }
+
+        let ptr = unsafe {
+            libc::mmap(std::ptr::null_mut(), len, libc::PROT_READ, libc::MAP_PRIVATE, fd, 0)
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+
+        Ok(Some(Self { ptr: ptr as *const u8, len }))
+    }
+
+    fn empty() -> Self {
+        Self { ptr: std::ptr::NonNull::<u8>::dangling().as_ptr(), len: 0 }
+    }
+
+    /// Mapped bytes
+    pub fn as_bytes(&self) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(self.ptr, self.len) }
+    }
+
+    /// Mapped length in bytes
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Whether the mapped file is empty
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Hint the kernel that the mapping will be read front to back
+    ///
+    /// This enables aggressive read-ahead; failures are ignored because the
+    /// advice is only an optimization.
+    pub fn advise_sequential(&self) {
+        #[cfg(unix)]
+        if self.len > 0 {
+            unsafe {
+                libc::madvise(self.ptr as *mut libc::c_void, self.len, libc::MADV_SEQUENTIAL);
+            }
+        }
+    }
+}
+
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        #[cfg(unix)]
+        if self.len > 0 {
+            unsafe {
+                libc::munmap(self.ptr as *mut libc::c_void, self.len);
+            }
+        }
+    }
+}
+
+impl std::fmt::Debug for MappedFile {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("MappedFile").field("len", &self.len).finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Write;
+
+    #[test]
+    #[cfg(unix)]
+    fn test_map_regular_file() {
+        let path = std::env::temp_dir().join(format!("qi_mapped_{}.txt", std::process::id()));
+        std::fs::File::create(&path).unwrap().write_all("第一行\nsecond".as_bytes()).unwrap();
+
+        let mapped = MappedFile::open(&path).unwrap().expect("regular file should map");
+        mapped.advise_sequential();
+        assert_eq!(mapped.as_bytes(), "第一行\nsecond".as_bytes());
+
+        std::fs::write(&path, b"").unwrap();
+        let empty = MappedFile::open(&path).unwrap().unwrap();
+        assert!(empty.is_empty());
+        assert_eq!(empty.as_bytes(), b"");
+
+        std::fs::remove_file(&path).unwrap();
+    }
+}
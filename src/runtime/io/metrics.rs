@@ -0,0 +1,495 @@
+//! Lock-free I/O operation metrics.
+//!
+//! Every I/O path records into an `IoCounters`. It holds atomic counters
+//! and a latency histogram for each `IoOpKind`. These are striped over
+//! cache-line-aligned shards, and each thread keeps to the shard it was
+//! given on its first record, so threads recording at the same time
+//! normally write different lines and never wait for a lock. Readers add
+//! the shards up into an `IoMetricsSnapshot`.
+//!
+//! Counters are updated independently. A snapshot taken while operations
+//! are in flight may therefore include an operation's count but not yet
+//! its latency. That is acceptable for reporting.
+
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::OnceLock;
+use std::time::{Duration, SystemTime, UNIX_EPOCH};
+
+use super::IoStatistics;
+
+/// Number of latency buckets; bucket `i` holds latencies below `2^i` µs
+pub const LATENCY_BUCKETS: usize = 32;
+/// Upper bound on shards per counter set
+const MAX_SHARDS: usize = 16;
+
+/// Kind of I/O operation, used to index the counter arrays
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum IoOpKind {
+    /// Whole-file read
+    FileRead,
+    /// Whole-file write
+    FileWrite,
+    /// Append to a file
+    FileAppend,
+    /// HTTP GET
+    HttpGet,
+    /// HTTP POST
+    HttpPost,
+    /// Any other HTTP request made through `HttpClient`
+    HttpRequest,
+    /// TCP connection setup
+    TcpConnect,
+    /// Write to standard output
+    Print,
+}
+
+/// Broad class of an operation
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum IoCategory {
+    File,
+    Network,
+    Stdio,
+}
+
+impl IoOpKind {
+    /// Number of kinds
+    pub const COUNT: usize = 8;
+
+    /// All kinds in index order
+    pub const ALL: [IoOpKind; Self::COUNT] = [
+        IoOpKind::FileRead,
+        IoOpKind::FileWrite,
+        IoOpKind::FileAppend,
+        IoOpKind::HttpGet,
+        IoOpKind::HttpPost,
+        IoOpKind::HttpRequest,
+        IoOpKind::TcpConnect,
+        IoOpKind::Print,
+    ];
+
+    /// Stable name used in reports
+    pub fn name(self) -> &'static str {
+        match self {
+            IoOpKind::FileRead => "read_file",
+            IoOpKind::FileWrite => "write_file",
+            IoOpKind::FileAppend => "append_file",
+            IoOpKind::HttpGet => "http_get",
+            IoOpKind::HttpPost => "http_post",
+            IoOpKind::HttpRequest => "http_request",
+            IoOpKind::TcpConnect => "tcp_connect",
+            IoOpKind::Print => "print",
+        }
+    }
+
+    /// Class of the operation
+    pub fn category(self) -> IoCategory {
+        match self {
+            IoOpKind::FileRead | IoOpKind::FileWrite | IoOpKind::FileAppend => IoCategory::File,
+            IoOpKind::HttpGet | IoOpKind::HttpPost | IoOpKind::HttpRequest | IoOpKind::TcpConnect => {
+                IoCategory::Network
+            }
+            IoOpKind::Print => IoCategory::Stdio,
+        }
+    }
+
+    /// Whether the operation's bytes were read (`Some(true)`), written
+    /// (`Some(false)`), or it moves no payload (`None`)
+    pub fn reads(self) -> Option<bool> {
+        match self {
+            IoOpKind::FileRead | IoOpKind::HttpGet | IoOpKind::HttpRequest => Some(true),
+            IoOpKind::FileWrite | IoOpKind::FileAppend | IoOpKind::HttpPost | IoOpKind::Print => Some(false),
+            IoOpKind::TcpConnect => None,
+        }
+    }
+}
+
+/// Counters for one kind within one shard
+#[derive(Default)]
+struct OpCounters {
+    operations: AtomicU64,
+    failures: AtomicU64,
+    bytes: AtomicU64,
+    total_nanos: AtomicU64,
+    latency: [AtomicU64; LATENCY_BUCKETS],
+}
+
+/// One stripe of counters, on its own cache lines
+#[repr(align(64))]
+#[derive(Default)]
+struct Shard {
+    ops: [OpCounters; IoOpKind::COUNT],
+    /// Unix time in seconds of the last operation recorded here
+    last_operation: AtomicU64,
+}
+
+static NEXT_THREAD_SLOT: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    /// Handed out round-robin, so threads spread evenly over the shards
+    static THREAD_SLOT: usize = NEXT_THREAD_SLOT.fetch_add(1, Ordering::Relaxed);
+}
+
+/// Shards per counter set: the parallelism rounded up to a power of two
+fn shard_count() -> usize {
+    static COUNT: OnceLock<usize> = OnceLock::new();
+    *COUNT.get_or_init(|| {
+        std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .next_power_of_two()
+            .min(MAX_SHARDS)
+    })
+}
+
+/// Histogram bucket for a latency
+fn latency_bucket(elapsed: Duration) -> usize {
+    let micros = elapsed.as_micros().min(u64::MAX as u128) as u64;
+    ((u64::BITS - micros.leading_zeros()) as usize).min(LATENCY_BUCKETS - 1)
+}
+
+fn unix_seconds() -> u64 {
+    SystemTime::now().duration_since(UNIX_EPOCH).unwrap_or_default().as_secs()
+}
+
+/// Sharded, lock-free I/O counters
+pub struct IoCounters {
+    shards: Box<[Shard]>,
+}
+
+impl IoCounters {
+    /// Create zeroed counters
+    pub fn new() -> Self {
+        Self {
+            shards: (0..shard_count()).map(|_| Shard::default()).collect(),
+        }
+    }
+
+    fn shard(&self) -> &Shard {
+        let slot = THREAD_SLOT.with(|slot| *slot);
+        &self.shards[slot & (self.shards.len() - 1)]
+    }
+
+    /// Record a successful operation that moved `bytes` and took `elapsed`
+    pub fn record(&self, kind: IoOpKind, bytes: u64, elapsed: Duration) {
+        let shard = self.shard();
+        let counters = &shard.ops[kind as usize];
+        counters.operations.fetch_add(1, Ordering::Relaxed);
+        counters.bytes.fetch_add(bytes, Ordering::Relaxed);
+        counters
+            .total_nanos
+            .fetch_add(elapsed.as_nanos().min(u64::MAX as u128) as u64, Ordering::Relaxed);
+        counters.latency[latency_bucket(elapsed)].fetch_add(1, Ordering::Relaxed);
+        shard.last_operation.store(unix_seconds(), Ordering::Relaxed);
+    }
+
+    /// Record a failed operation
+    pub fn record_failure(&self, kind: IoOpKind) {
+        let shard = self.shard();
+        shard.ops[kind as usize].failures.fetch_add(1, Ordering::Relaxed);
+        shard.last_operation.store(unix_seconds(), Ordering::Relaxed);
+    }
+
+    /// Record an operation from its result
+    pub fn record_result<T, E>(&self, kind: IoOpKind, result: &Result<T, E>, bytes: u64, elapsed: Duration) {
+        match result {
+            Ok(_) => self.record(kind, bytes, elapsed),
+            Err(_) => self.record_failure(kind),
+        }
+    }
+
+    /// Sum all shards
+    pub fn snapshot(&self) -> IoMetricsSnapshot {
+        let mut snapshot = IoMetricsSnapshot::default();
+        for shard in self.shards.iter() {
+            for (total, counters) in snapshot.ops.iter_mut().zip(shard.ops.iter()) {
+                total.operations += counters.operations.load(Ordering::Relaxed);
+                total.failures += counters.failures.load(Ordering::Relaxed);
+                total.bytes += counters.bytes.load(Ordering::Relaxed);
+                total.total_nanos += counters.total_nanos.load(Ordering::Relaxed);
+                for (bucket, count) in total.latency.iter_mut().zip(counters.latency.iter()) {
+                    *bucket += count.load(Ordering::Relaxed);
+                }
+            }
+            let last = shard.last_operation.load(Ordering::Relaxed);
+            if last != 0 {
+                snapshot.last_operation = snapshot.last_operation.max(Some(last));
+            }
+        }
+        snapshot
+    }
+
+    /// Zero every counter
+    ///
+    /// Operations recorded concurrently with a reset may be partly kept.
+    pub fn reset(&self) {
+        for shard in self.shards.iter() {
+            for counters in shard.ops.iter() {
+                counters.operations.store(0, Ordering::Relaxed);
+                counters.failures.store(0, Ordering::Relaxed);
+                counters.bytes.store(0, Ordering::Relaxed);
+                counters.total_nanos.store(0, Ordering::Relaxed);
+                for bucket in counters.latency.iter() {
+                    bucket.store(0, Ordering::Relaxed);
+                }
+            }
+            shard.last_operation.store(0, Ordering::Relaxed);
+        }
+    }
+}
+
+impl Default for IoCounters {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl std::fmt::Debug for IoCounters {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("IoCounters")
+            .field("shards", &self.shards.len())
+            .field("total_operations", &self.snapshot().total_operations())
+            .finish()
+    }
+}
+
+/// Process-wide counters for FFI entry points that have no owning interface
+pub fn global() -> &'static IoCounters {
+    static GLOBAL: OnceLock<IoCounters> = OnceLock::new();
+    GLOBAL.get_or_init(IoCounters::new)
+}
+
+/// Merged counters for one kind
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct OpSnapshot {
+    /// Successful operations
+    pub operations: u64,
+    /// Failed operations
+    pub failures: u64,
+    /// Payload bytes moved by successful operations
+    pub bytes: u64,
+    /// Summed latency of successful operations
+    pub total_nanos: u64,
+    /// Latency histogram; bucket `i` counts latencies below `2^i` µs
+    /// (and at least `2^(i-1)` µs for `i > 0`)
+    pub latency: [u64; LATENCY_BUCKETS],
+}
+
+impl Default for OpSnapshot {
+    fn default() -> Self {
+        Self {
+            operations: 0,
+            failures: 0,
+            bytes: 0,
+            total_nanos: 0,
+            latency: [0; LATENCY_BUCKETS],
+        }
+    }
+}
+
+impl OpSnapshot {
+    /// Mean latency of successful operations
+    pub fn mean(&self) -> Duration {
+        if self.operations == 0 {
+            Duration::ZERO
+        } else {
+            Duration::from_nanos(self.total_nanos / self.operations)
+        }
+    }
+
+    /// Upper bound of the histogram bucket holding the `quantile`
+    /// (0.0..=1.0) latency, or zero when nothing was recorded
+    pub fn percentile(&self, quantile: f64) -> Duration {
+        let recorded: u64 = self.latency.iter().sum();
+        if recorded == 0 {
+            return Duration::ZERO;
+        }
+        let rank = ((recorded as f64 * quantile.clamp(0.0, 1.0)).ceil() as u64).max(1);
+        let mut seen = 0;
+        for (bucket, &count) in self.latency.iter().enumerate() {
+            seen += count;
+            if seen >= rank {
+                return Duration::from_micros(1u64 << bucket);
+            }
+        }
+        Duration::from_micros(1u64 << (LATENCY_BUCKETS - 1))
+    }
+
+    fn merge(&mut self, other: &OpSnapshot) {
+        self.operations += other.operations;
+        self.failures += other.failures;
+        self.bytes += other.bytes;
+        self.total_nanos += other.total_nanos;
+        for (bucket, count) in self.latency.iter_mut().zip(other.latency.iter()) {
+            *bucket += count;
+        }
+    }
+}
+
+/// Point-in-time totals of an `IoCounters`
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct IoMetricsSnapshot {
+    ops: [OpSnapshot; IoOpKind::COUNT],
+    /// Unix time in seconds of the most recent operation
+    pub last_operation: Option<u64>,
+}
+
+impl IoMetricsSnapshot {
+    /// Totals for one kind
+    pub fn get(&self, kind: IoOpKind) -> &OpSnapshot {
+        &self.ops[kind as usize]
+    }
+
+    /// Kinds with their totals, in index order
+    pub fn iter(&self) -> impl Iterator<Item = (IoOpKind, &OpSnapshot)> {
+        IoOpKind::ALL.iter().copied().zip(self.ops.iter())
+    }
+
+    /// Successful and failed operations of every kind
+    pub fn total_operations(&self) -> u64 {
+        self.ops.iter().map(|op| op.operations + op.failures).sum()
+    }
+
+    /// Successful and failed operations in one category
+    pub fn category_operations(&self, category: IoCategory) -> u64 {
+        self.iter()
+            .filter(|(kind, _)| kind.category() == category)
+            .map(|(_, op)| op.operations + op.failures)
+            .sum()
+    }
+
+    /// Bytes moved by reading kinds
+    pub fn bytes_read(&self) -> u64 {
+        self.bytes_where(true)
+    }
+
+    /// Bytes moved by writing kinds
+    pub fn bytes_written(&self) -> u64 {
+        self.bytes_where(false)
+    }
+
+    fn bytes_where(&self, reads: bool) -> u64 {
+        self.iter()
+            .filter(|(kind, _)| kind.reads() == Some(reads))
+            .map(|(_, op)| op.bytes)
+            .sum()
+    }
+
+    /// Latency totals over all kinds
+    pub fn combined(&self) -> OpSnapshot {
+        let mut combined = OpSnapshot::default();
+        for op in self.ops.iter() {
+            combined.merge(op);
+        }
+        combined
+    }
+
+    /// Add another snapshot's totals into this one
+    pub fn merge(&mut self, other: &IoMetricsSnapshot) {
+        for (op, other_op) in self.ops.iter_mut().zip(other.ops.iter()) {
+            op.merge(other_op);
+        }
+        self.last_operation = self.last_operation.max(other.last_operation);
+    }
+
+    /// Fold into the read/write summary used by the interface types
+    pub fn to_statistics(&self) -> IoStatistics {
+        let mut stats = IoStatistics::new();
+        let mut read_nanos = 0;
+        let mut write_nanos = 0;
+        for (kind, op) in self.iter() {
+            stats.failed_operations += op.failures;
+            if kind.category() == IoCategory::Network {
+                stats.network_operations += op.operations;
+            }
+            match kind.reads() {
+                Some(true) => {
+                    stats.successful_reads += op.operations;
+                    stats.bytes_read += op.bytes;
+                    read_nanos += op.total_nanos;
+                }
+                Some(false) => {
+                    stats.successful_writes += op.operations;
+                    stats.bytes_written += op.bytes;
+                    write_nanos += op.total_nanos;
+                }
+                None => {}
+            }
+        }
+        if stats.successful_reads > 0 {
+            stats.avg_read_time_ms = read_nanos as f64 / stats.successful_reads as f64 / 1e6;
+        }
+        if stats.successful_writes > 0 {
+            stats.avg_write_time_ms = write_nanos as f64 / stats.successful_writes as f64 / 1e6;
+        }
+        stats
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+
+    #[test]
+    fn test_record_and_snapshot() {
+        let counters = IoCounters::new();
+        counters.record(IoOpKind::FileRead, 1024, Duration::from_micros(300));
+        counters.record(IoOpKind::FileWrite, 512, Duration::from_millis(5));
+        counters.record_failure(IoOpKind::HttpGet);
+
+        let snapshot = counters.snapshot();
+        assert_eq!(snapshot.total_operations(), 3);
+        assert_eq!(snapshot.get(IoOpKind::FileRead).operations, 1);
+        assert_eq!(snapshot.get(IoOpKind::HttpGet).failures, 1);
+        assert_eq!(snapshot.bytes_read(), 1024);
+        assert_eq!(snapshot.bytes_written(), 512);
+        assert_eq!(snapshot.category_operations(IoCategory::File), 2);
+        assert!(snapshot.last_operation.is_some());
+
+        let stats = snapshot.to_statistics();
+        assert_eq!(stats.successful_reads, 1);
+        assert_eq!(stats.successful_writes, 1);
+        assert_eq!(stats.failed_operations, 1);
+        assert!((stats.avg_write_time_ms - 5.0).abs() < 1e-9);
+
+        counters.reset();
+        assert_eq!(counters.snapshot(), IoMetricsSnapshot::default());
+    }
+
+    #[test]
+    fn test_latency_percentiles() {
+        let counters = IoCounters::new();
+        for _ in 0..99 {
+            counters.record(IoOpKind::Print, 1, Duration::from_micros(3));
+        }
+        counters.record(IoOpKind::Print, 1, Duration::from_millis(20));
+
+        let print = *counters.snapshot().get(IoOpKind::Print);
+        assert_eq!(print.percentile(0.5), Duration::from_micros(4));
+        assert_eq!(print.percentile(0.99), Duration::from_micros(4));
+        assert_eq!(print.percentile(1.0), Duration::from_micros(32768));
+        assert_eq!(OpSnapshot::default().percentile(0.5), Duration::ZERO);
+    }
+
+    #[test]
+    fn test_concurrent_recording() {
+        let counters = Arc::new(IoCounters::new());
+        let threads: Vec<_> = (0..8)
+            .map(|_| {
+                let counters = Arc::clone(&counters);
+                std::thread::spawn(move || {
+                    for _ in 0..10_000 {
+                        counters.record(IoOpKind::TcpConnect, 0, Duration::from_micros(50));
+                    }
+                })
+            })
+            .collect();
+        for thread in threads {
+            thread.join().unwrap();
+        }
+
+        let snapshot = counters.snapshot();
+        assert_eq!(snapshot.get(IoOpKind::TcpConnect).operations, 80_000);
+        assert_eq!(snapshot.to_statistics().network_operations, 80_000);
+    }
+}
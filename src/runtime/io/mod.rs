@@ -4,23 +4,51 @@
 //! network operations, and standard I/O with comprehensive Chinese language support.
 
 pub mod filesystem;
+pub mod slab;
+pub mod metrics;
+pub mod handles;
+pub mod dns;
 pub mod http;
+pub mod http_parse;
+pub mod http_client;
+pub mod http_server;
+pub mod listener;
+pub mod udp;
 pub mod network_ffi;
 pub mod http_ffi;
+pub mod process;
+pub mod process_ffi;
 pub mod stdio;
+pub mod mapped;
+pub mod scanner;
+pub mod transfer;
+pub mod walker;
 pub mod interface;
 pub mod file;
 pub mod io_ffi;
 
 // Re-export main components
-pub use filesystem::{FileSystemInterface, FileOperation, FileEncoding};
+pub use filesystem::{FileSystemInterface, FileOperation, FileOperationType, FileEncoding};
+pub use slab::{HandleSlab, Handle};
+pub use metrics::{IoCounters, IoOpKind, IoMetricsSnapshot};
+pub use handles::{FileHandleTable, FileHandle};
+pub use dns::{Resolver, ResolverConfig, ResolverStats, PendingLookup};
 pub use http::{HttpClient, TcpManager, TimeoutManager, NetworkInterface, HttpRequest, HttpResponse};
+pub use http_client::{HttpTransport, ConnectionPool, ResponseHead, ResponseBody, StreamingResponse};
+pub use http_server::{HttpServer, HttpServerConfig, Request, Response, Router};
+pub use listener::{TcpListener, ListenerConfig};
+pub use udp::{UdpSocket, PacketBatch};
+pub use process::{ProcessBuilder, Process, Pipeline, PipeReader, PipeWriter, StdioMode, ProcessOutput};
 pub use interface::{IoInterface, IoConfig, IoStats, IoOperation, NetworkConfig};
-pub use file::{文件模块, 文件操作};
+pub use file::{文件模块, 文件操作, 追加器};
 
 // Create NetworkManager as TcpManager for compatibility
 pub type NetworkManager = TcpManager;
-pub use stdio::{StandardIo, ConsoleInterface};
+pub use stdio::{StandardIo, ConsoleInterface, with_stdin};
+pub use mapped::MappedFile;
+pub use scanner::{InputScanner, ByteLines, byte_lines};
+pub use transfer::{copy_file, Appender};
+pub use walker::{walk, walk_channel, WalkEntry, WalkOptions, EntryKind};
 
 /// I/O operation result type
 pub type IoResult<T> = Result<T, IoError>;
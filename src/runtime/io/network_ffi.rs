@@ -2,20 +2,38 @@
 //!
 //! 为 Qi 语言提供 C 接口的网络操作函数（TCP、UDP 等）
 
+use super::dns::{self, PendingLookup, Resolver};
 use super::http::{TcpConnectionConfig, TcpConnection, NetworkInterface};
+use super::listener::{ListenerConfig, TcpListener};
+use super::slab::HandleSlab;
+use super::udp::{PacketBatch, UdpSocket};
 use std::ffi::{CStr, CString};
-use std::os::raw::c_char;
+use std::os::raw::{c_char, c_void};
 use std::time::Duration;
-use std::sync::Mutex;
-use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
 
 // 全局网络接口实例
 use std::sync::OnceLock;
 static 全局网络接口: OnceLock<NetworkInterface> = OnceLock::new();
 
-// TCP 连接池和句柄计数器（使用全局静态变量）
-static TCP连接池: OnceLock<Mutex<HashMap<i64, TcpConnection>>> = OnceLock::new();
-static 连接句柄计数器: OnceLock<Mutex<i64>> = OnceLock::new();
+// TCP 连接表：句柄分配无锁，每个连接单独加锁，且只在查表期间持有；
+// 读写在连接的 Arc 上进行，阻塞的连接不会拖住其他连接
+static TCP连接表: OnceLock<HandleSlab<Arc<TcpConnection>>> = OnceLock::new();
+
+// TCP 监听表：服务循环持有 Arc，关闭句柄后循环随之退出
+static TCP监听表: OnceLock<HandleSlab<Arc<TcpListener>>> = OnceLock::new();
+
+// 后台解析表：句柄对应进行中的或已完成的解析
+static 解析表: OnceLock<HandleSlab<PendingLookup>> = OnceLock::new();
+
+// UDP 套接字表：每个套接字带一个复用的接收批次
+static UDP套接字表: OnceLock<HandleSlab<Arc<UDP套接字>>> = OnceLock::new();
+
+/// UDP 套接字及其批量接收缓冲区
+struct UDP套接字 {
+    套接字: UdpSocket,
+    批次: Mutex<PacketBatch>,
+}
 
 fn 获取网络接口() -> Option<&'static NetworkInterface> {
     全局网络接口.get()
@@ -29,12 +47,44 @@ fn 初始化网络接口() {
     });
 }
 
-fn 获取连接池() -> &'static Mutex<HashMap<i64, TcpConnection>> {
-    TCP连接池.get_or_init(|| Mutex::new(HashMap::new()))
+fn 获取连接表() -> &'static HandleSlab<Arc<TcpConnection>> {
+    TCP连接表.get_or_init(HandleSlab::new)
+}
+
+fn 查找连接(句柄: i64) -> Option<Arc<TcpConnection>> {
+    获取连接表().with(句柄, |连接| Arc::clone(连接))
+}
+
+fn 获取监听表() -> &'static HandleSlab<Arc<TcpListener>> {
+    TCP监听表.get_or_init(HandleSlab::new)
+}
+
+fn 获取解析表() -> &'static HandleSlab<PendingLookup> {
+    解析表.get_or_init(HandleSlab::new)
+}
+
+fn 查找监听器(句柄: i64) -> Option<Arc<TcpListener>> {
+    获取监听表().with(句柄, |监听器| Arc::clone(监听器))
+}
+
+fn 获取数据报表() -> &'static HandleSlab<Arc<UDP套接字>> {
+    UDP套接字表.get_or_init(HandleSlab::new)
 }
 
-fn 获取句柄计数器() -> &'static Mutex<i64> {
-    连接句柄计数器.get_or_init(|| Mutex::new(0))
+fn 查找数据报套接字(句柄: i64) -> Option<Arc<UDP套接字>> {
+    获取数据报表().with(句柄, |套接字| Arc::clone(套接字))
+}
+
+fn 解析目标(host: *const c_char, port: u16) -> Option<std::net::SocketAddr> {
+    if host.is_null() {
+        return None;
+    }
+    let 主机 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    dns::resolve_socket_addr(&主机, port).ok()
+}
+
+fn 超时参数(timeout_ms: i64) -> Option<Duration> {
+    if timeout_ms < 0 { None } else { Some(Duration::from_millis(timeout_ms as u64)) }
 }
 
 /// 初始化网络模块
@@ -65,16 +115,7 @@ pub extern "C" fn qi_network_tcp_connect(host: *const c_char, port: u16, timeout
         }
 
         match TcpConnection::connect(配置) {
-            Ok(连接) => {
-                let mut 句柄计数 = 获取句柄计数器().lock().unwrap();
-                *句柄计数 += 1;
-                let 句柄 = *句柄计数;
-
-                let mut 连接池 = 获取连接池().lock().unwrap();
-                连接池.insert(句柄, 连接);
-
-                句柄
-            }
+            Ok(连接) => 获取连接表().insert(Arc::new(连接)).unwrap_or(-1),
             Err(_) => -1,
         }
     }
@@ -88,8 +129,7 @@ pub extern "C" fn qi_network_tcp_read(handle: i64, buffer: *mut u8, buffer_size:
         return -1;
     }
 
-    let mut 连接池 = 获取连接池().lock().unwrap();
-    if let Some(连接) = 连接池.get_mut(&handle) {
+    if let Some(连接) = 查找连接(handle) {
         let 缓冲区 = unsafe { std::slice::from_raw_parts_mut(buffer, buffer_size as usize) };
         match 连接.read(缓冲区) {
             Ok(字节数) => 字节数 as i64,
@@ -108,8 +148,7 @@ pub extern "C" fn qi_network_tcp_write(handle: i64, data: *const u8, data_size:
         return -1;
     }
 
-    let mut 连接池 = 获取连接池().lock().unwrap();
-    if let Some(连接) = 连接池.get_mut(&handle) {
+    if let Some(连接) = 查找连接(handle) {
         let 数据 = unsafe { std::slice::from_raw_parts(data, data_size as usize) };
         match 连接.write(数据) {
             Ok(字节数) => 字节数 as i64,
@@ -120,15 +159,150 @@ pub extern "C" fn qi_network_tcp_write(handle: i64, data: *const u8, data_size:
     }
 }
 
+/// qi_network_tcp_connect_with_options 的选项位
+pub const TCP选项_NODELAY: i64 = 1;
+pub const TCP选项_QUICKACK: i64 = 2;
+pub const TCP选项_ZEROCOPY: i64 = 4;
+pub const TCP选项_BUSY_POLL: i64 = 8;
+
+/// 零拷贝发送的默认阈值；更小的写入走普通拷贝
+const 零拷贝阈值: usize = 16 * 1024;
+/// 启用忙轮询时的轮询时长
+const 忙轮询时长: Duration = Duration::from_micros(50);
+
+/// 带套接字选项的 TCP 连接
+/// options 为 TCP选项_* 的按位或；buffer_size > 0 时同时设置收发缓冲区大小
+/// 返回连接句柄（>0 成功，<0 失败）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_connect_with_options(
+    host: *const c_char,
+    port: u16,
+    timeout_ms: i64,
+    options: i64,
+    buffer_size: i64,
+) -> i64 {
+    if host.is_null() {
+        return -1;
+    }
+
+    let 主机 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    let mut 配置 = TcpConnectionConfig::new(主机, port)
+        .with_nodelay(options & TCP选项_NODELAY != 0)
+        .with_quickack(options & TCP选项_QUICKACK != 0);
+    if timeout_ms > 0 {
+        配置 = 配置.with_timeout(Duration::from_millis(timeout_ms as u64));
+    }
+    if options & TCP选项_ZEROCOPY != 0 {
+        配置 = 配置.with_zerocopy(零拷贝阈值);
+    }
+    if options & TCP选项_BUSY_POLL != 0 {
+        配置 = 配置.with_busy_poll(忙轮询时长);
+    }
+    if buffer_size > 0 {
+        配置 = 配置.with_buffer_sizes(Some(buffer_size as usize), Some(buffer_size as usize));
+    }
+
+    match TcpConnection::connect(配置) {
+        Ok(连接) => 获取连接表().insert(Arc::new(连接)).unwrap_or(-1),
+        Err(_) => -1,
+    }
+}
+
+/// 把 count 个 (指针, 长度) 转成切片；任一指针为空或长度为负时返回 None
+unsafe fn 收集缓冲区<'a>(buffers: *const *const u8, lengths: *const i64, count: i64) -> Option<Vec<&'a [u8]>> {
+    if buffers.is_null() || lengths.is_null() || count <= 0 {
+        return None;
+    }
+    let 指针表 = std::slice::from_raw_parts(buffers, count as usize);
+    let 长度表 = std::slice::from_raw_parts(lengths, count as usize);
+    指针表
+        .iter()
+        .zip(长度表)
+        .map(|(&指针, &长度)| match 长度 {
+            0 => Some(&[][..]),
+            n if n > 0 && !指针.is_null() => Some(std::slice::from_raw_parts(指针, n as usize)),
+            _ => None,
+        })
+        .collect()
+}
+
+/// 依次写出 count 个缓冲区（writev），例如帧头和负载，无需先拼接
+/// buffers 为缓冲区指针数组，lengths 为对应长度数组
+/// 返回写入的总字节数（<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_writev(handle: i64, buffers: *const *const u8, lengths: *const i64, count: i64) -> i64 {
+    let 分段 = match unsafe { 收集缓冲区(buffers, lengths, count) } {
+        Some(分段) => 分段,
+        None => return -1,
+    };
+
+    match 查找连接(handle).map(|连接| 连接.write_vectored(&分段)) {
+        Some(Ok(字节数)) => 字节数 as i64,
+        _ => -1,
+    }
+}
+
+/// 一次 readv 读入 count 个缓冲区，按顺序填满
+/// 返回读取的总字节数（0 表示对端关闭，<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_readv(handle: i64, buffers: *const *mut u8, lengths: *const i64, count: i64) -> i64 {
+    let 分段 = match unsafe { 收集缓冲区(buffers as *const *const u8, lengths, count) } {
+        Some(分段) => 分段,
+        None => return -1,
+    };
+    let 连接 = match 查找连接(handle) {
+        Some(连接) => 连接,
+        None => return -1,
+    };
+
+    let mut 目标: Vec<std::io::IoSliceMut<'_>> = 分段
+        .into_iter()
+        .map(|段| std::io::IoSliceMut::new(unsafe { std::slice::from_raw_parts_mut(段.as_ptr() as *mut u8, 段.len()) }))
+        .collect();
+    match 连接.read_vectored(&mut 目标) {
+        Ok(字节数) => 字节数 as i64,
+        Err(_) => -1,
+    }
+}
+
+/// 以 MSG_ZEROCOPY 写入大缓冲区（连接需带 TCP选项_ZEROCOPY）
+/// 在 qi_network_tcp_zerocopy_wait 返回 0 之前不得修改缓冲区内容
+/// 返回写入的字节数（<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_write_zerocopy(handle: i64, data: *const u8, data_size: i64) -> i64 {
+    if data.is_null() || data_size <= 0 {
+        return -1;
+    }
+
+    let 数据 = unsafe { std::slice::from_raw_parts(data, data_size as usize) };
+    match 查找连接(handle).map(|连接| 连接.write_zerocopy(数据)) {
+        Some(Ok(字节数)) => 字节数 as i64,
+        _ => -1,
+    }
+}
+
+/// 等待零拷贝发送完成，timeout_ms < 0 表示一直等待
+/// 返回仍未完成的发送数（0 表示缓冲区均可复用，<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_zerocopy_wait(handle: i64, timeout_ms: i64) -> i64 {
+    match 查找连接(handle).map(|连接| 连接.wait_zerocopy(超时参数(timeout_ms))) {
+        Some(Ok(未完成)) => 未完成 as i64,
+        _ => -1,
+    }
+}
+
 /// 关闭 TCP 连接
 /// 返回 1 成功，0 失败
+///
+/// 其他线程上仍在进行的读写会被 shutdown 唤醒并返回错误或 0。
 #[no_mangle]
 pub extern "C" fn qi_network_tcp_close(handle: i64) -> i64 {
-    let mut 连接池 = 获取连接池().lock().unwrap();
-    if 连接池.remove(&handle).is_some() {
-        1
-    } else {
-        0
+    match 获取连接表().remove(handle) {
+        Some(连接) => {
+            let _ = 连接.shutdown();
+            1
+        }
+        None => 0,
     }
 }
 
@@ -136,8 +310,7 @@ pub extern "C" fn qi_network_tcp_close(handle: i64) -> i64 {
 /// 返回 1 成功，0 失败
 #[no_mangle]
 pub extern "C" fn qi_network_tcp_flush(handle: i64) -> i64 {
-    let mut 连接池 = 获取连接池().lock().unwrap();
-    if let Some(连接) = 连接池.get_mut(&handle) {
+    if let Some(连接) = 查找连接(handle) {
         match 连接.flush() {
             Ok(_) => 1,
             Err(_) => 0,
@@ -150,8 +323,7 @@ pub extern "C" fn qi_network_tcp_flush(handle: i64) -> i64 {
 /// 获取 TCP 连接已读取的字节数
 #[no_mangle]
 pub extern "C" fn qi_network_tcp_bytes_read(handle: i64) -> i64 {
-    let 连接池 = 获取连接池().lock().unwrap();
-    if let Some(连接) = 连接池.get(&handle) {
+    if let Some(连接) = 查找连接(handle) {
         连接.bytes_read() as i64
     } else {
         -1
@@ -161,15 +333,270 @@ pub extern "C" fn qi_network_tcp_bytes_read(handle: i64) -> i64 {
 /// 获取 TCP 连接已写入的字节数
 #[no_mangle]
 pub extern "C" fn qi_network_tcp_bytes_written(handle: i64) -> i64 {
-    let 连接池 = 获取连接池().lock().unwrap();
-    if let Some(连接) = 连接池.get(&handle) {
+    if let Some(连接) = 查找连接(handle) {
         连接.bytes_written() as i64
     } else {
         -1
     }
 }
 
+/// 在指定地址和端口上监听 TCP 连接
+/// 每个运行时工作线程一个 SO_REUSEPORT 套接字；端口为 0 时自动选择，
+/// backlog <= 0 时使用默认值
+/// 返回监听句柄（>0 成功，<0 失败）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_listen(host: *const c_char, port: u16, backlog: i64) -> i64 {
+    if host.is_null() {
+        return -1;
+    }
+
+    let 主机 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    let 积压 = backlog.clamp(0, i32::MAX as i64) as i32;
+    let 配置 = ListenerConfig::new(主机, port).with_backlog(积压);
+    match TcpListener::bind(&配置) {
+        Ok(监听器) => 获取监听表().insert(Arc::new(监听器)).unwrap_or(-1),
+        Err(_) => -1,
+    }
+}
+
+/// 接受一个 TCP 连接
+/// timeout_ms < 0 表示一直等待
+/// 返回连接句柄（>0 成功，0 超时，<0 失败或监听已关闭）
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_accept(listener: i64, timeout_ms: i64) -> i64 {
+    let 监听器 = match 查找监听器(listener) {
+        Some(监听器) => 监听器,
+        None => return -1,
+    };
+
+    let 超时 = if timeout_ms < 0 { None } else { Some(Duration::from_millis(timeout_ms as u64)) };
+    match 监听器.accept(超时) {
+        Ok(Some((流, 对端))) => {
+            获取连接表().insert(Arc::new(TcpConnection::from_accepted(流, 对端))).unwrap_or(-1)
+        }
+        Ok(None) if 监听器.is_closed() => -1,
+        Ok(None) => 0,
+        Err(_) => -1,
+    }
+}
+
+/// 运行服务循环，直到监听句柄被关闭
+/// 每个连接在新线程上调用 handler(连接句柄)，返回后连接自动关闭
+/// 返回 1 正常结束，<0 失败
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_serve(listener: i64, handler: *const c_void) -> i64 {
+    if handler.is_null() {
+        return -1;
+    }
+    let 监听器 = match 查找监听器(listener) {
+        Some(监听器) => 监听器,
+        None => return -1,
+    };
+
+    let 处理函数 = unsafe { std::mem::transmute::<*const c_void, extern "C" fn(i64)>(handler) };
+    let 结果 = 监听器.serve(|连接| {
+        if let Some(句柄) = 获取连接表().insert(Arc::new(连接)) {
+            处理函数(句柄);
+            qi_network_tcp_close(句柄);
+        }
+    });
+    match 结果 {
+        Ok(()) => 1,
+        Err(_) => -1,
+    }
+}
+
+/// 获取监听器实际绑定的端口
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_listener_port(listener: i64) -> i64 {
+    match 查找监听器(listener) {
+        Some(监听器) => 监听器.local_addr().port() as i64,
+        None => -1,
+    }
+}
+
+/// 关闭监听器，正在等待的接受和服务循环随之返回
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_network_tcp_listener_close(listener: i64) -> i64 {
+    match 获取监听表().remove(listener) {
+        Some(监听器) => {
+            监听器.close();
+            1
+        }
+        None => 0,
+    }
+}
+
+/// 在指定地址和端口上绑定 UDP 套接字，端口为 0 时自动选择
+/// 返回套接字句柄（>0 成功，<0 失败）
+#[no_mangle]
+pub extern "C" fn qi_network_udp_bind(host: *const c_char, port: u16) -> i64 {
+    if host.is_null() {
+        return -1;
+    }
+
+    let 主机 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    match UdpSocket::bind(&主机, port) {
+        Ok(套接字) => {
+            let 条目 = UDP套接字 { 套接字, 批次: Mutex::new(PacketBatch::new(64, 2048)) };
+            获取数据报表().insert(Arc::new(条目)).unwrap_or(-1)
+        }
+        Err(_) => -1,
+    }
+}
+
+/// 向指定地址发送一个数据报
+/// 返回发送的字节数（<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_udp_send_to(
+    handle: i64,
+    host: *const c_char,
+    port: u16,
+    data: *const u8,
+    data_size: i64,
+) -> i64 {
+    if data.is_null() || data_size < 0 {
+        return -1;
+    }
+    let (条目, 目标) = match (查找数据报套接字(handle), 解析目标(host, port)) {
+        (Some(条目), Some(目标)) => (条目, 目标),
+        _ => return -1,
+    };
+
+    let 数据 = unsafe { std::slice::from_raw_parts(data, data_size as usize) };
+    match 条目.套接字.send_to(数据, 目标) {
+        Ok(字节数) => 字节数 as i64,
+        Err(_) => -1,
+    }
+}
+
+/// 接收一个数据报，超出缓冲区的部分被丢弃；timeout_ms < 0 表示一直等待
+/// 返回数据报长度（>=0），-2 超时，-1 失败或套接字已关闭
+#[no_mangle]
+pub extern "C" fn qi_network_udp_recv(handle: i64, buffer: *mut u8, buffer_size: i64, timeout_ms: i64) -> i64 {
+    if buffer.is_null() || buffer_size <= 0 {
+        return -1;
+    }
+    let 条目 = match 查找数据报套接字(handle) {
+        Some(条目) => 条目,
+        None => return -1,
+    };
+
+    let 缓冲区 = unsafe { std::slice::from_raw_parts_mut(buffer, buffer_size as usize) };
+    match 条目.套接字.recv_from(缓冲区, 超时参数(timeout_ms)) {
+        Ok(Some((字节数, _))) => 字节数 as i64,
+        Ok(None) if 条目.套接字.is_closed() => -1,
+        Ok(None) => -2,
+        Err(_) => -1,
+    }
+}
+
+/// 批量接收数据报（一次 recvmmsg），第 i 个数据报复制到 buffer + i * slot_size，
+/// 长度写入 lengths[i]；等待第一个数据报，之后只取已到达的
+/// 返回收到的数据报数（>=0，0 表示超时），<0 表示失败或套接字已关闭
+#[no_mangle]
+pub extern "C" fn qi_network_udp_recv_batch(
+    handle: i64,
+    buffer: *mut u8,
+    slot_size: i64,
+    lengths: *mut i64,
+    max_packets: i64,
+    timeout_ms: i64,
+) -> i64 {
+    if buffer.is_null() || lengths.is_null() || slot_size <= 0 || max_packets <= 0 {
+        return -1;
+    }
+    let 条目 = match 查找数据报套接字(handle) {
+        Some(条目) => 条目,
+        None => return -1,
+    };
+
+    let (槽大小, 最大数) = (slot_size as usize, max_packets as usize);
+    let mut 批次 = 条目.批次.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+    if 批次.capacity() != 最大数 || 批次.slot_size() != 槽大小 {
+        *批次 = PacketBatch::new(最大数, 槽大小);
+    }
+    let 数量 = match 条目.套接字.recv_batch(&mut 批次, 超时参数(timeout_ms)) {
+        Ok(0) if 条目.套接字.is_closed() => return -1,
+        Ok(数量) => 数量,
+        Err(_) => return -1,
+    };
+
+    let 缓冲区 = unsafe { std::slice::from_raw_parts_mut(buffer, 槽大小 * 最大数) };
+    let 长度表 = unsafe { std::slice::from_raw_parts_mut(lengths, 最大数) };
+    for (序号, (内容, _)) in 批次.iter().enumerate() {
+        缓冲区[序号 * 槽大小..序号 * 槽大小 + 内容.len()].copy_from_slice(内容);
+        长度表[序号] = 内容.len() as i64;
+    }
+    数量 as i64
+}
+
+/// 批量发送数据报（sendmmsg）到同一地址：data 中依次存放 count 个数据报，
+/// 第 i 个长 lengths[i] 字节
+/// 返回发送的数据报数（<0 表示错误）
+#[no_mangle]
+pub extern "C" fn qi_network_udp_send_batch(
+    handle: i64,
+    host: *const c_char,
+    port: u16,
+    data: *const u8,
+    lengths: *const i64,
+    count: i64,
+) -> i64 {
+    if data.is_null() || lengths.is_null() || count <= 0 {
+        return -1;
+    }
+    let (条目, 目标) = match (查找数据报套接字(handle), 解析目标(host, port)) {
+        (Some(条目), Some(目标)) => (条目, 目标),
+        _ => return -1,
+    };
+
+    let 长度表 = unsafe { std::slice::from_raw_parts(lengths, count as usize) };
+    if 长度表.iter().any(|&长度| 长度 < 0) {
+        return -1;
+    }
+    let 总长: i64 = 长度表.iter().sum();
+    let 数据 = unsafe { std::slice::from_raw_parts(data, 总长 as usize) };
+    let mut 偏移 = 0;
+    let 数据包: Vec<(&[u8], std::net::SocketAddr)> = 长度表
+        .iter()
+        .map(|&长度| {
+            let 内容 = &数据[偏移..偏移 + 长度 as usize];
+            偏移 += 长度 as usize;
+            (内容, 目标)
+        })
+        .collect();
+    match 条目.套接字.send_batch(&数据包) {
+        Ok(数量) => 数量 as i64,
+        Err(_) => -1,
+    }
+}
+
+/// 获取 UDP 套接字实际绑定的端口
+#[no_mangle]
+pub extern "C" fn qi_network_udp_local_port(handle: i64) -> i64 {
+    match 查找数据报套接字(handle) {
+        Some(条目) => 条目.套接字.local_addr().port() as i64,
+        None => -1,
+    }
+}
+
+/// 关闭 UDP 套接字，正在等待的接收随之返回
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_network_udp_close(handle: i64) -> i64 {
+    match 获取数据报表().remove(handle) {
+        Some(条目) => {
+            条目.套接字.close();
+            1
+        }
+        None => 0,
+    }
+}
+
 /// 解析域名到 IP 地址
+/// 结果在进程内缓存，同一主机的并发解析只发出一次查询
 /// 返回 IP 地址字符串（需要调用 qi_network_free_string 释放）
 #[no_mangle]
 pub extern "C" fn qi_network_resolve_host(host: *const c_char) -> *mut c_char {
@@ -177,24 +604,56 @@ pub extern "C" fn qi_network_resolve_host(host: *const c_char) -> *mut c_char {
         return std::ptr::null_mut();
     }
 
-    unsafe {
-        let 主机名 = CStr::from_ptr(host).to_string_lossy().to_string();
-
-        // 尝试解析为 socket 地址
-        use std::net::ToSocketAddrs;
-        let 地址字符串 = format!("{}:0", 主机名);
-
-        match 地址字符串.to_socket_addrs() {
-            Ok(mut 地址列表) => {
-                if let Some(地址) = 地址列表.next() {
-                    let ip字符串 = 地址.ip().to_string();
-                    CString::new(ip字符串).unwrap().into_raw()
-                } else {
-                    std::ptr::null_mut()
-                }
+    let 主机名 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    match dns::resolve(&主机名) {
+        Ok(地址列表) => CString::new(地址列表[0].to_string()).unwrap().into_raw(),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+/// 在后台解析域名，立即返回
+/// 返回解析句柄（>0 成功，<0 失败），用 qi_network_resolve_wait 取结果
+#[no_mangle]
+pub extern "C" fn qi_network_resolve_host_async(host: *const c_char) -> i64 {
+    if host.is_null() {
+        return -1;
+    }
+
+    let 主机名 = unsafe { CStr::from_ptr(host).to_string_lossy().to_string() };
+    获取解析表().insert(Resolver::global().resolve_async(&主机名)).unwrap_or(-1)
+}
+
+/// 检查后台解析是否完成
+/// 返回 1 已完成，0 进行中，-1 句柄无效
+#[no_mangle]
+pub extern "C" fn qi_network_resolve_ready(handle: i64) -> i64 {
+    match 获取解析表().with(handle, |解析| 解析.is_ready()) {
+        Some(true) => 1,
+        Some(false) => 0,
+        None => -1,
+    }
+}
+
+/// 等待后台解析结果，timeout_ms < 0 表示一直等待
+/// 完成后句柄释放；超时返回空指针且句柄仍可继续等待
+/// 返回 IP 地址字符串（需要调用 qi_network_free_string 释放），失败返回空指针
+#[no_mangle]
+pub extern "C" fn qi_network_resolve_wait(handle: i64, timeout_ms: i64) -> *mut c_char {
+    let 超时 = if timeout_ms < 0 { None } else { Some(Duration::from_millis(timeout_ms as u64)) };
+    // 在表外等待，避免持有槽锁阻塞其他调用
+    let 解析 = match 获取解析表().with(handle, |解析| 解析.clone()) {
+        Some(解析) => 解析,
+        None => return std::ptr::null_mut(),
+    };
+    match 解析.wait_timeout(超时) {
+        Some(结果) => {
+            获取解析表().remove(handle);
+            match 结果 {
+                Ok(地址列表) => CString::new(地址列表[0].to_string()).unwrap().into_raw(),
+                Err(_) => std::ptr::null_mut(),
             }
-            Err(_) => std::ptr::null_mut(),
         }
+        None => std::ptr::null_mut(),
     }
 }
 
@@ -294,4 +753,287 @@ mod tests {
             qi_network_free_string(ip_ptr);
         }
     }
+
+    #[test]
+    fn test_resolve_host_async() {
+        let host = CString::new("127.0.0.1").unwrap();
+        let handle = qi_network_resolve_host_async(host.as_ptr());
+        assert!(handle > 0);
+        assert_eq!(qi_network_resolve_ready(handle), 1);
+        let ip_ptr = qi_network_resolve_wait(handle, -1);
+        assert_eq!(unsafe { CStr::from_ptr(ip_ptr).to_string_lossy() }, "127.0.0.1");
+        qi_network_free_string(ip_ptr);
+        // The handle is released once the result has been taken
+        assert_eq!(qi_network_resolve_ready(handle), -1);
+
+        let host = CString::new("localhost").unwrap();
+        let handle = qi_network_resolve_host_async(host.as_ptr());
+        assert!(qi_network_resolve_ready(handle) >= 0);
+        let ip_ptr = qi_network_resolve_wait(handle, 5000);
+        if !ip_ptr.is_null() {
+            qi_network_free_string(ip_ptr);
+        }
+    }
+
+    /// 确保能同时打开约两千个描述符（客户端和服务端各一千）
+    fn 提高描述符上限() {
+        unsafe {
+            let mut 上限 = std::mem::zeroed::<libc::rlimit>();
+            if libc::getrlimit(libc::RLIMIT_NOFILE, &mut 上限) == 0 && 上限.rlim_cur < 4096 {
+                上限.rlim_cur = 上限.rlim_max.min(4096);
+                libc::setrlimit(libc::RLIMIT_NOFILE, &上限);
+            }
+        }
+    }
+
+    #[test]
+    fn test_concurrent_tcp_connections() {
+        use std::io::{Read, Write};
+        use std::net::TcpListener;
+
+        const 连接数: usize = 1000;
+        提高描述符上限();
+
+        // 回显服务器：每个连接一个线程；第一个连接是永不回复的慢对端
+        let 监听器 = TcpListener::bind("127.0.0.1:0").unwrap();
+        let 端口 = 监听器.local_addr().unwrap().port();
+        let 服务器 = std::thread::spawn(move || {
+            let mut 对端 = Vec::with_capacity(连接数 + 1);
+            for 序号 in 0..=连接数 {
+                let (mut 流, _) = 监听器.accept().unwrap();
+                对端.push(std::thread::spawn(move || {
+                    let mut 缓冲区 = [0u8; 64];
+                    loop {
+                        match 流.read(&mut 缓冲区) {
+                            Ok(0) | Err(_) => break,
+                            Ok(n) if 序号 > 0 => {
+                                if 流.write_all(&缓冲区[..n]).is_err() {
+                                    break;
+                                }
+                            }
+                            Ok(_) => {}
+                        }
+                    }
+                }));
+            }
+            for 线程 in 对端 {
+                线程.join().unwrap();
+            }
+        });
+
+        let 主机 = CString::new("127.0.0.1").unwrap();
+        let 慢连接 = qi_network_tcp_connect(主机.as_ptr(), 端口, 5000);
+        assert!(慢连接 > 0);
+
+        // 一个线程阻塞在慢连接的读取上，不应拖住其他连接
+        let 阻塞读取 = std::thread::spawn(move || {
+            let mut 缓冲区 = [0u8; 16];
+            assert_eq!(qi_network_tcp_write(慢连接, b"ping".as_ptr(), 4), 4);
+            qi_network_tcp_read(慢连接, 缓冲区.as_mut_ptr(), 缓冲区.len() as i64)
+        });
+
+        let 句柄: Vec<i64> = (0..连接数)
+            .map(|_| {
+                let 句柄 = qi_network_tcp_connect(主机.as_ptr(), 端口, 5000);
+                assert!(句柄 > 0);
+                句柄
+            })
+            .collect();
+        let mut 去重 = 句柄.clone();
+        去重.sort_unstable();
+        去重.dedup();
+        assert_eq!(去重.len(), 连接数);
+
+        std::thread::scope(|scope| {
+            for 分组 in 句柄.chunks(连接数 / 16) {
+                scope.spawn(move || {
+                    for &句柄 in 分组 {
+                        let 消息 = format!("连接{}", 句柄);
+                        assert_eq!(
+                            qi_network_tcp_write(句柄, 消息.as_ptr(), 消息.len() as i64),
+                            消息.len() as i64
+                        );
+                        let mut 回显 = vec![0u8; 消息.len()];
+                        let mut 已读 = 0;
+                        while 已读 < 回显.len() {
+                            let n = qi_network_tcp_read(
+                                句柄,
+                                回显[已读..].as_mut_ptr(),
+                                (回显.len() - 已读) as i64,
+                            );
+                            assert!(n > 0);
+                            已读 += n as usize;
+                        }
+                        assert_eq!(回显, 消息.as_bytes());
+                        assert_eq!(qi_network_tcp_bytes_written(句柄), 消息.len() as i64);
+                    }
+                });
+            }
+        });
+
+        for &句柄 in &句柄 {
+            assert_eq!(qi_network_tcp_close(句柄), 1);
+            assert_eq!(qi_network_tcp_close(句柄), 0);
+            assert_eq!(qi_network_tcp_write(句柄, b"x".as_ptr(), 1), -1);
+        }
+
+        // 关闭慢连接会唤醒阻塞在其上的读取
+        assert_eq!(qi_network_tcp_close(慢连接), 1);
+        assert!(阻塞读取.join().unwrap() <= 0);
+        服务器.join().unwrap();
+    }
+
+    extern "C" fn 回显处理(句柄: i64) {
+        let mut 缓冲区 = [0u8; 128];
+        loop {
+            let n = qi_network_tcp_read(句柄, 缓冲区.as_mut_ptr(), 缓冲区.len() as i64);
+            if n <= 0 || qi_network_tcp_write(句柄, 缓冲区.as_ptr(), n) != n {
+                break;
+            }
+        }
+    }
+
+    #[test]
+    fn test_tcp_listen_accept_and_serve() {
+        use std::io::{Read, Write};
+
+        let 主机 = CString::new("127.0.0.1").unwrap();
+        let 监听 = qi_network_tcp_listen(主机.as_ptr(), 0, 0);
+        assert!(监听 > 0);
+        let 端口 = qi_network_tcp_listener_port(监听) as u16;
+        assert!(端口 > 0);
+        assert_eq!(qi_network_tcp_accept(监听, 10), 0);
+
+        // 接受连接得到的句柄与客户端连接共用读写接口
+        let 客户端 = qi_network_tcp_connect(主机.as_ptr(), 端口, 5000);
+        let 服务端 = qi_network_tcp_accept(监听, 5000);
+        assert!(客户端 > 0 && 服务端 > 0);
+        assert_eq!(qi_network_tcp_write(客户端, b"ping".as_ptr(), 4), 4);
+        let mut 缓冲区 = [0u8; 4];
+        assert_eq!(qi_network_tcp_read(服务端, 缓冲区.as_mut_ptr(), 4), 4);
+        assert_eq!(&缓冲区, b"ping");
+        qi_network_tcp_close(客户端);
+        qi_network_tcp_close(服务端);
+
+        let 服务 = std::thread::spawn(move || qi_network_tcp_serve(监听, 回显处理 as *const c_void));
+        for i in 0..16 {
+            let mut 流 = std::net::TcpStream::connect(("127.0.0.1", 端口)).unwrap();
+            let 消息 = format!("回显{}", i);
+            流.write_all(消息.as_bytes()).unwrap();
+            let mut 回显 = vec![0u8; 消息.len()];
+            流.read_exact(&mut 回显).unwrap();
+            assert_eq!(回显, 消息.as_bytes());
+        }
+
+        assert_eq!(qi_network_tcp_listener_close(监听), 1);
+        assert_eq!(服务.join().unwrap(), 1);
+        assert_eq!(qi_network_tcp_listener_close(监听), 0);
+        assert_eq!(qi_network_tcp_accept(监听, 0), -1);
+    }
+
+    #[test]
+    fn test_udp_send_and_receive() {
+        let 主机 = CString::new("127.0.0.1").unwrap();
+        let 接收端 = qi_network_udp_bind(主机.as_ptr(), 0);
+        let 发送端 = qi_network_udp_bind(主机.as_ptr(), 0);
+        assert!(接收端 > 0 && 发送端 > 0);
+        let 端口 = qi_network_udp_local_port(接收端) as u16;
+
+        let mut 缓冲区 = [0u8; 64];
+        assert_eq!(qi_network_udp_recv(接收端, 缓冲区.as_mut_ptr(), 64, 10), -2);
+        assert_eq!(qi_network_udp_send_to(发送端, 主机.as_ptr(), 端口, b"ping".as_ptr(), 4), 4);
+        assert_eq!(qi_network_udp_recv(接收端, 缓冲区.as_mut_ptr(), 64, 5000), 4);
+        assert_eq!(&缓冲区[..4], b"ping");
+
+        // 三个数据报依次存放，一次发出
+        let 数据 = b"abbccc";
+        let 长度 = [1i64, 2, 3];
+        assert_eq!(qi_network_udp_send_batch(发送端, 主机.as_ptr(), 端口, 数据.as_ptr(), 长度.as_ptr(), 3), 3);
+        let mut 槽 = [0u8; 16 * 8];
+        let mut 收到长度 = [0i64; 8];
+        let mut 收到 = Vec::new();
+        while 收到.len() < 3 {
+            let n = qi_network_udp_recv_batch(接收端, 槽.as_mut_ptr(), 16, 收到长度.as_mut_ptr(), 8, 5000);
+            assert!(n > 0);
+            for i in 0..n as usize {
+                收到.push(槽[i * 16..i * 16 + 收到长度[i] as usize].to_vec());
+            }
+        }
+        assert_eq!(收到, vec![b"a".to_vec(), b"bb".to_vec(), b"ccc".to_vec()]);
+
+        assert_eq!(qi_network_udp_close(接收端), 1);
+        assert_eq!(qi_network_udp_close(接收端), 0);
+        assert_eq!(qi_network_udp_recv(接收端, 缓冲区.as_mut_ptr(), 64, 0), -1);
+        qi_network_udp_close(发送端);
+    }
+
+    #[test]
+    fn test_tcp_vectored_and_zerocopy() {
+        use std::io::{Read, Write};
+        use std::net::TcpListener;
+
+        let 监听器 = TcpListener::bind("127.0.0.1:0").unwrap();
+        let 端口 = 监听器.local_addr().unwrap().port();
+        let (已回帧, 等待回帧) = std::sync::mpsc::channel();
+        let 回显 = std::thread::spawn(move || {
+            let (mut 流, _) = 监听器.accept().unwrap();
+            let mut 帧 = [0u8; 9];
+            流.read_exact(&mut 帧).unwrap();
+            assert_eq!(&帧, b"\0\0\0\x05hello");
+            // 回环上 write_all 返回时数据已在对端接收队列中
+            流.write_all(&帧).unwrap();
+            已回帧.send(()).unwrap();
+
+            let mut 缓冲区 = vec![0u8; 64 * 1024];
+            loop {
+                match 流.read(&mut 缓冲区) {
+                    Ok(0) | Err(_) => break,
+                    Ok(n) => 流.write_all(&缓冲区[..n]).unwrap(),
+                }
+            }
+        });
+
+        let 主机 = CString::new("127.0.0.1").unwrap();
+        let 选项 = TCP选项_NODELAY | TCP选项_QUICKACK | TCP选项_ZEROCOPY | TCP选项_BUSY_POLL;
+        let 连接 = qi_network_tcp_connect_with_options(主机.as_ptr(), 端口, 5000, 选项, 256 * 1024);
+        assert!(连接 > 0);
+
+        // 帧头和负载分开传入，一次写出
+        let 帧头 = 5u32.to_be_bytes();
+        let 负载 = b"hello";
+        let 指针 = [帧头.as_ptr(), 负载.as_ptr()];
+        let 长度 = [4i64, 5];
+        assert_eq!(qi_network_tcp_writev(连接, 指针.as_ptr(), 长度.as_ptr(), 2), 9);
+        assert_eq!(qi_network_tcp_writev(连接, 指针.as_ptr(), [4i64, -1].as_ptr(), 2), -1);
+
+        // 一次读入帧头和负载两个缓冲区
+        等待回帧.recv().unwrap();
+        let mut 收帧头 = [0u8; 4];
+        let mut 收负载 = [0u8; 5];
+        let 读指针 = [收帧头.as_mut_ptr(), 收负载.as_mut_ptr()];
+        assert_eq!(qi_network_tcp_readv(连接, 读指针.as_ptr(), 长度.as_ptr(), 2), 9);
+        assert_eq!(u32::from_be_bytes(收帧头), 5);
+        assert_eq!(&收负载, b"hello");
+
+        // 大缓冲区走零拷贝（内核不支持时退回普通写入），等待完成后可复用
+        let 大块: Vec<u8> = (0..256 * 1024).map(|i| i as u8).collect();
+        let mut 已写 = 0usize;
+        let mut 回读 = Vec::with_capacity(大块.len());
+        let mut 缓冲区 = vec![0u8; 64 * 1024];
+        while 已写 < 大块.len() {
+            let n = qi_network_tcp_write_zerocopy(连接, 大块[已写..].as_ptr(), (大块.len() - 已写) as i64);
+            assert!(n > 0);
+            已写 += n as usize;
+            while 回读.len() < 已写 {
+                let m = qi_network_tcp_read(连接, 缓冲区.as_mut_ptr(), 缓冲区.len() as i64);
+                assert!(m > 0);
+                回读.extend_from_slice(&缓冲区[..m as usize]);
+            }
+        }
+        assert_eq!(回读, 大块);
+        assert_eq!(qi_network_tcp_zerocopy_wait(连接, 5000), 0);
+
+        qi_network_tcp_close(连接);
+        回显.join().unwrap();
+    }
 }
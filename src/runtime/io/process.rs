@@ -0,0 +1,1035 @@
+//! Child Processes
+//!
+//! Programs are spawned with `posix_spawnp`. glibc implements it with
+//! `clone(CLONE_VM | CLONE_VFORK)`, so the child borrows the parent's
+//! address space until it execs. Spawning therefore costs the same however
+//! large the runtime's heap is, unlike `fork`.
+//!
+//! Standard streams can be piped. The parent's ends of those pipes are
+//! non-blocking `PipeReader` and `PipeWriter` handles that stream data as
+//! it arrives. Like the sockets, they wait for readiness in `poll` in short
+//! slices, so a goroutine blocked on a child notices `close` promptly.
+//!
+//! `Pipeline` connects neighbouring children directly, the way a shell
+//! does, so data passed between them never goes through this process. When
+//! two separately spawned children need joining, `PipeReader::splice_to`
+//! moves data between their pipes with `splice` on Linux. The data is not
+//! copied into user space.
+
+use std::ffi::CString;
+use std::io;
+use std::os::unix::ffi::OsStrExt;
+use std::os::unix::io::{AsRawFd, FromRawFd, IntoRawFd, OwnedFd, RawFd};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+use super::{IoError, IoResult};
+
+/// Longest single wait in `poll` before re-checking for close
+const POLL_SLICE_MS: i32 = 100;
+/// Bytes moved per `splice` call (the default pipe capacity)
+const SPLICE_CHUNK: usize = 64 * 1024;
+/// Interval between exit checks where no pidfd is available
+const EXIT_POLL_INTERVAL: Duration = Duration::from_millis(5);
+
+/// Where a child's standard stream goes
+#[derive(Debug)]
+pub enum StdioMode {
+    /// Share the parent's stream
+    Inherit,
+    /// Connect a pipe whose other end the parent keeps
+    Piped,
+    /// Connect `/dev/null`
+    Null,
+    /// Hand over an existing descriptor, such as another child's output
+    Fd(OwnedFd),
+}
+
+/// Spawn configuration
+#[derive(Debug)]
+pub struct ProcessBuilder {
+    program: String,
+    args: Vec<String>,
+    env: Vec<(String, String)>,
+    stdin: StdioMode,
+    stdout: StdioMode,
+    stderr: StdioMode,
+}
+
+impl ProcessBuilder {
+    /// Run `program`, searched for in `PATH`, with inherited streams
+    pub fn new(program: impl Into<String>) -> Self {
+        Self {
+            program: program.into(),
+            args: Vec::new(),
+            env: Vec::new(),
+            stdin: StdioMode::Inherit,
+            stdout: StdioMode::Inherit,
+            stderr: StdioMode::Inherit,
+        }
+    }
+
+    /// Parse a command line split on whitespace; no shell quoting is applied
+    pub fn from_command_line(command_line: &str) -> Option<Self> {
+        let mut words = command_line.split_whitespace();
+        let program = words.next()?;
+        Some(Self::new(program).with_args(words))
+    }
+
+    /// Append arguments
+    pub fn with_args<I, S>(mut self, args: I) -> Self
+    where
+        I: IntoIterator<Item = S>,
+        S: Into<String>,
+    {
+        self.args.extend(args.into_iter().map(Into::into));
+        self
+    }
+
+    /// Set an environment variable for the child
+    pub fn with_env(mut self, key: impl Into<String>, value: impl Into<String>) -> Self {
+        self.env.push((key.into(), value.into()));
+        self
+    }
+
+    /// Set standard input
+    pub fn with_stdin(mut self, mode: StdioMode) -> Self {
+        self.stdin = mode;
+        self
+    }
+
+    /// Set standard output
+    pub fn with_stdout(mut self, mode: StdioMode) -> Self {
+        self.stdout = mode;
+        self
+    }
+
+    /// Set standard error
+    pub fn with_stderr(mut self, mode: StdioMode) -> Self {
+        self.stderr = mode;
+        self
+    }
+
+    /// Program name
+    pub fn program(&self) -> &str {
+        &self.program
+    }
+
+    /// Start the child
+    pub fn spawn(self) -> IoResult<Process> {
+        let program = c_string(&self.program)?;
+        let mut argv_owned = Vec::with_capacity(self.args.len() + 1);
+        argv_owned.push(program.clone());
+        for arg in &self.args {
+            argv_owned.push(c_string(arg)?);
+        }
+        let envp_owned = environment(&self.env);
+        let argv = null_terminated(&argv_owned);
+        let envp = null_terminated(&envp_owned);
+
+        let (stdin_child, stdin_parent) = child_stdio(self.stdin, true)?;
+        let (stdout_child, stdout_parent) = child_stdio(self.stdout, false)?;
+        let (stderr_child, stderr_parent) = child_stdio(self.stderr, false)?;
+
+        let mut actions = FileActions::new()?;
+        for (fd, target) in [(&stdin_child, 0), (&stdout_child, 1), (&stderr_child, 2)] {
+            if let Some(fd) = fd {
+                actions.dup2(fd.as_raw_fd(), target)?;
+            }
+        }
+        let attributes = SpawnAttributes::new()?;
+
+        let mut pid: libc::pid_t = 0;
+        let rc = unsafe {
+            libc::posix_spawnp(
+                &mut pid,
+                program.as_ptr(),
+                actions.as_ptr(),
+                attributes.as_ptr(),
+                argv.as_ptr(),
+                envp.as_ptr(),
+            )
+        };
+        // The child has its own copies now; closing ours lets EOF through
+        drop((stdin_child, stdout_child, stderr_child));
+        if rc != 0 {
+            return Err(spawn_error(&self.program, rc));
+        }
+
+        Ok(Process {
+            pid,
+            #[cfg(target_os = "linux")]
+            pidfd: pidfd_open(pid),
+            stdin: stdin_parent.map(PipeWriter::new),
+            stdout: stdout_parent.map(PipeReader::new),
+            stderr: stderr_parent.map(PipeReader::new),
+            status: Mutex::new(None),
+        })
+    }
+
+    /// Run to completion, collecting standard output and error
+    ///
+    /// Standard input is `/dev/null` unless set otherwise.
+    pub fn output(mut self) -> IoResult<ProcessOutput> {
+        if let StdioMode::Inherit = self.stdin {
+            self.stdin = StdioMode::Null;
+        }
+        let process = self
+            .with_stdout(StdioMode::Piped)
+            .with_stderr(StdioMode::Piped)
+            .spawn()?;
+        let (stdout, stderr) = read_both(process.stdout().unwrap(), process.stderr().unwrap())?;
+        let status = process.wait()?;
+        Ok(ProcessOutput { status, stdout, stderr })
+    }
+}
+
+/// Result of `ProcessBuilder::output`
+#[derive(Debug, Clone)]
+pub struct ProcessOutput {
+    /// Exit code, or 128 plus the signal number if the child was killed
+    pub status: i32,
+    /// Everything written to standard output
+    pub stdout: Vec<u8>,
+    /// Everything written to standard error
+    pub stderr: Vec<u8>,
+}
+
+impl ProcessOutput {
+    /// Whether the child exited with code 0
+    pub fn success(&self) -> bool {
+        self.status == 0
+    }
+}
+
+/// A spawned child
+///
+/// Dropping a `Process` closes the parent's pipe ends but does not wait
+/// for the child, the same as `std::process::Child`.
+#[derive(Debug)]
+pub struct Process {
+    pid: libc::pid_t,
+    /// Readable once the child exits, so timed waits can sleep in `poll`
+    #[cfg(target_os = "linux")]
+    pidfd: Option<OwnedFd>,
+    stdin: Option<PipeWriter>,
+    stdout: Option<PipeReader>,
+    stderr: Option<PipeReader>,
+    /// Exit code once the child has been reaped
+    status: Mutex<Option<i32>>,
+}
+
+impl Process {
+    /// Process ID
+    pub fn id(&self) -> u32 {
+        self.pid as u32
+    }
+
+    /// Parent's end of the child's standard input, if piped
+    pub fn stdin(&self) -> Option<&PipeWriter> {
+        self.stdin.as_ref()
+    }
+
+    /// Parent's end of the child's standard output, if piped
+    pub fn stdout(&self) -> Option<&PipeReader> {
+        self.stdout.as_ref()
+    }
+
+    /// Parent's end of the child's standard error, if piped
+    pub fn stderr(&self) -> Option<&PipeReader> {
+        self.stderr.as_ref()
+    }
+
+    /// Take ownership of the standard output pipe
+    pub fn take_stdout(&mut self) -> Option<PipeReader> {
+        self.stdout.take()
+    }
+
+    /// Close standard input so the child sees end of file
+    pub fn close_stdin(&self) {
+        if let Some(stdin) = &self.stdin {
+            stdin.close();
+        }
+    }
+
+    /// Wake any reads or writes waiting on this child's pipes
+    pub fn close_pipes(&self) {
+        self.close_stdin();
+        for reader in [&self.stdout, &self.stderr].into_iter().flatten() {
+            reader.close();
+        }
+    }
+
+    /// Exit code if the child has finished, without blocking
+    pub fn try_wait(&self) -> IoResult<Option<i32>> {
+        let mut status = self.status.lock().unwrap_or_else(|p| p.into_inner());
+        if status.is_none() {
+            *status = reap(self.pid, libc::WNOHANG)?;
+        }
+        Ok(*status)
+    }
+
+    /// Wait up to `timeout` for the child to finish
+    pub fn wait_timeout(&self, timeout: Duration) -> IoResult<Option<i32>> {
+        let deadline = Instant::now() + timeout;
+        loop {
+            if let Some(code) = self.try_wait()? {
+                return Ok(Some(code));
+            }
+            let remaining = match deadline.checked_duration_since(Instant::now()) {
+                Some(remaining) if !remaining.is_zero() => remaining,
+                _ => return Ok(None),
+            };
+            self.sleep_until_exit(remaining)?;
+        }
+    }
+
+    /// Wait for the child to finish
+    pub fn wait(&self) -> IoResult<i32> {
+        loop {
+            if let Some(code) = self.wait_timeout(Duration::from_millis(POLL_SLICE_MS as u64))? {
+                return Ok(code);
+            }
+        }
+    }
+
+    /// Send `signal` to the child; does nothing once it has been reaped
+    pub fn kill(&self, signal: i32) -> IoResult<()> {
+        // Holding the status lock keeps the PID from being reaped and reused
+        let status = self.status.lock().unwrap_or_else(|p| p.into_inner());
+        if status.is_none() && unsafe { libc::kill(self.pid, signal) } != 0 {
+            let error = io::Error::last_os_error();
+            if error.raw_os_error() != Some(libc::ESRCH) {
+                return Err(error.into());
+            }
+        }
+        Ok(())
+    }
+
+    #[cfg(target_os = "linux")]
+    fn sleep_until_exit(&self, limit: Duration) -> IoResult<()> {
+        match &self.pidfd {
+            Some(pidfd) => {
+                let millis = (limit.as_millis() as i32).clamp(1, POLL_SLICE_MS);
+                poll_one(pidfd.as_raw_fd(), libc::POLLIN, millis)?;
+                Ok(())
+            }
+            None => {
+                std::thread::sleep(limit.min(EXIT_POLL_INTERVAL));
+                Ok(())
+            }
+        }
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    fn sleep_until_exit(&self, limit: Duration) -> IoResult<()> {
+        std::thread::sleep(limit.min(EXIT_POLL_INTERVAL));
+        Ok(())
+    }
+}
+
+impl Drop for Process {
+    fn drop(&mut self) {
+        self.close_pipes();
+        // Reap it if it has already finished, so no zombie is left behind
+        let _ = self.try_wait();
+    }
+}
+
+/// Children connected stdout-to-stdin, like a shell pipeline
+#[derive(Debug)]
+pub struct Pipeline {
+    processes: Vec<Process>,
+}
+
+impl Pipeline {
+    /// Spawn every stage, feeding each stage's output to the next
+    ///
+    /// The first stage's standard input and the last stage's standard
+    /// output are whatever those builders set; the pipes in between are
+    /// held only by the children.
+    pub fn spawn(stages: Vec<ProcessBuilder>) -> IoResult<Self> {
+        if stages.is_empty() {
+            return Err(IoError::ResourceNotFound { resource: "空的进程管道".to_string() });
+        }
+        let last = stages.len() - 1;
+        let mut processes: Vec<Process> = Vec::with_capacity(stages.len());
+        for (index, mut stage) in stages.into_iter().enumerate() {
+            if let Some(previous) = processes.last_mut() {
+                let output = previous.take_stdout().expect("inner pipeline stages pipe their output");
+                stage = stage.with_stdin(StdioMode::Fd(output.into_fd()?));
+            }
+            if index < last {
+                stage = stage.with_stdout(StdioMode::Piped);
+            }
+            match stage.spawn() {
+                Ok(process) => processes.push(process),
+                Err(e) => {
+                    for process in &processes {
+                        let _ = process.kill(libc::SIGKILL);
+                        let _ = process.wait();
+                    }
+                    return Err(e);
+                }
+            }
+        }
+        Ok(Self { processes })
+    }
+
+    /// The stages, in order
+    pub fn processes(&self) -> &[Process] {
+        &self.processes
+    }
+
+    /// First stage's standard input, if piped
+    pub fn stdin(&self) -> Option<&PipeWriter> {
+        self.processes[0].stdin()
+    }
+
+    /// Last stage's standard output, if piped
+    pub fn stdout(&self) -> Option<&PipeReader> {
+        self.processes[self.processes.len() - 1].stdout()
+    }
+
+    /// Last stage's standard error, if piped
+    pub fn stderr(&self) -> Option<&PipeReader> {
+        self.processes[self.processes.len() - 1].stderr()
+    }
+
+    /// Close the first stage's standard input
+    pub fn close_stdin(&self) {
+        self.processes[0].close_stdin();
+    }
+
+    /// Wake any reads or writes waiting on the pipeline's pipes
+    pub fn close_pipes(&self) {
+        for process in &self.processes {
+            process.close_pipes();
+        }
+    }
+
+    /// Wait up to `timeout` for every stage; returns the last stage's code
+    pub fn wait_timeout(&self, timeout: Duration) -> IoResult<Option<i32>> {
+        let deadline = Instant::now() + timeout;
+        let mut code = None;
+        for process in &self.processes {
+            let remaining = deadline.saturating_duration_since(Instant::now());
+            code = process.wait_timeout(remaining)?;
+            if code.is_none() {
+                return Ok(None);
+            }
+        }
+        Ok(code)
+    }
+
+    /// Wait for every stage; returns the last stage's code
+    pub fn wait(&self) -> IoResult<i32> {
+        let mut code = 0;
+        for process in &self.processes {
+            code = process.wait()?;
+        }
+        Ok(code)
+    }
+
+    /// Whether every stage has finished
+    pub fn try_wait(&self) -> IoResult<Option<i32>> {
+        let mut code = None;
+        for process in &self.processes {
+            code = process.try_wait()?;
+            if code.is_none() {
+                return Ok(None);
+            }
+        }
+        Ok(code)
+    }
+
+    /// Send `signal` to every stage still running
+    pub fn kill(&self, signal: i32) -> IoResult<()> {
+        for process in &self.processes {
+            process.kill(signal)?;
+        }
+        Ok(())
+    }
+}
+
+/// Parent's read end of a child's output
+#[derive(Debug)]
+pub struct PipeReader {
+    fd: OwnedFd,
+    closed: AtomicBool,
+    eof: AtomicBool,
+}
+
+impl PipeReader {
+    fn new(fd: OwnedFd) -> Self {
+        Self { fd, closed: AtomicBool::new(false), eof: AtomicBool::new(false) }
+    }
+
+    /// Read whatever is available, waiting up to `timeout` for data
+    ///
+    /// Returns `Some(0)` at end of file and `None` on timeout or once the
+    /// reader is closed.
+    pub fn read(&self, buffer: &mut [u8], timeout: Option<Duration>) -> IoResult<Option<usize>> {
+        let fd = self.fd.as_raw_fd();
+        let result = retry_when_ready(fd, libc::POLLIN, &self.closed, timeout, || {
+            let n = unsafe { libc::read(fd, buffer.as_mut_ptr().cast(), buffer.len()) };
+            if n < 0 { Err(io::Error::last_os_error()) } else { Ok(n as usize) }
+        })?;
+        if result == Some(0) && !buffer.is_empty() {
+            self.eof.store(true, Ordering::Release);
+        }
+        Ok(result)
+    }
+
+    /// Read until end of file, appending to `out`
+    pub fn read_to_end(&self, out: &mut Vec<u8>) -> IoResult<usize> {
+        let start = out.len();
+        let mut chunk = [0u8; 16 * 1024];
+        while let Some(n) = self.read(&mut chunk, None)? {
+            if n == 0 {
+                break;
+            }
+            out.extend_from_slice(&chunk[..n]);
+        }
+        Ok(out.len() - start)
+    }
+
+    /// Move everything up to end of file into `target`
+    ///
+    /// On Linux the data goes pipe-to-pipe with `splice` and is never
+    /// copied into this process. Returns the number of bytes moved, which
+    /// is short if either side is closed first.
+    pub fn splice_to(&self, target: &PipeWriter) -> IoResult<u64> {
+        #[cfg(target_os = "linux")]
+        {
+            match self.splice_loop(target) {
+                Err(IoError::SystemIoError(e)) if e.raw_os_error() == Some(libc::EINVAL) => {}
+                result => return result,
+            }
+        }
+        self.copy_loop(target)
+    }
+
+    #[cfg(target_os = "linux")]
+    fn splice_loop(&self, target: &PipeWriter) -> IoResult<u64> {
+        let mut moved = 0u64;
+        loop {
+            if self.is_closed() || target.is_closed() {
+                return Ok(moved);
+            }
+            let result = target.with_fd(|out_fd| {
+                let n = unsafe {
+                    libc::splice(
+                        self.fd.as_raw_fd(),
+                        std::ptr::null_mut(),
+                        out_fd,
+                        std::ptr::null_mut(),
+                        SPLICE_CHUNK,
+                        libc::SPLICE_F_MOVE | libc::SPLICE_F_NONBLOCK,
+                    )
+                };
+                if n < 0 { Err(io::Error::last_os_error()) } else { Ok(n as usize) }
+            });
+            match result {
+                Ok(0) => {
+                    self.eof.store(true, Ordering::Release);
+                    return Ok(moved);
+                }
+                Ok(n) => moved += n as u64,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+                Err(e) if e.kind() == io::ErrorKind::WouldBlock => {
+                    // Either side may be the one that is not ready
+                    poll_one(self.fd.as_raw_fd(), libc::POLLIN, POLL_SLICE_MS)?;
+                    poll_one(target.raw_fd, libc::POLLOUT, POLL_SLICE_MS)?;
+                }
+                Err(e) if e.kind() == io::ErrorKind::BrokenPipe && moved > 0 => return Ok(moved),
+                Err(e) => return Err(e.into()),
+            }
+        }
+    }
+
+    fn copy_loop(&self, target: &PipeWriter) -> IoResult<u64> {
+        let mut moved = 0u64;
+        let mut chunk = vec![0u8; SPLICE_CHUNK];
+        while let Some(n) = self.read(&mut chunk, None)? {
+            if n == 0 || !target.write_all(&chunk[..n], None)? {
+                break;
+            }
+            moved += n as u64;
+        }
+        Ok(moved)
+    }
+
+    /// Whether end of file has been read
+    pub fn is_eof(&self) -> bool {
+        self.eof.load(Ordering::Acquire)
+    }
+
+    /// Stop reading and wake any waiting reader
+    pub fn close(&self) {
+        self.closed.store(true, Ordering::Release);
+    }
+
+    /// Check whether `close` has been called
+    pub fn is_closed(&self) -> bool {
+        self.closed.load(Ordering::Acquire)
+    }
+
+    /// Turn back into a blocking descriptor to hand to another child
+    pub fn into_fd(self) -> IoResult<OwnedFd> {
+        set_nonblocking(self.fd.as_raw_fd(), false)?;
+        Ok(self.fd)
+    }
+}
+
+/// Parent's write end of a child's standard input
+#[derive(Debug)]
+pub struct PipeWriter {
+    /// Taken on `close`; each write holds the lock only for its system call
+    fd: Mutex<Option<OwnedFd>>,
+    /// Descriptor number, only for `poll`
+    raw_fd: RawFd,
+    closed: AtomicBool,
+}
+
+impl PipeWriter {
+    fn new(fd: OwnedFd) -> Self {
+        Self { raw_fd: fd.as_raw_fd(), fd: Mutex::new(Some(fd)), closed: AtomicBool::new(false) }
+    }
+
+    /// Write all of `data`, waiting up to `timeout` between chunks
+    ///
+    /// Returns `false` if the timeout passed or the pipe was closed first.
+    /// A child that has exited shows up as a broken pipe error.
+    pub fn write_all(&self, mut data: &[u8], timeout: Option<Duration>) -> IoResult<bool> {
+        while !data.is_empty() {
+            let written = retry_when_ready(self.raw_fd, libc::POLLOUT, &self.closed, timeout, || {
+                self.with_fd(|fd| {
+                    let n = unsafe { libc::write(fd, data.as_ptr().cast(), data.len()) };
+                    if n < 0 { Err(io::Error::last_os_error()) } else { Ok(n as usize) }
+                })
+            })?;
+            match written {
+                Some(n) => data = &data[n..],
+                None => return Ok(false),
+            }
+        }
+        Ok(true)
+    }
+
+    /// Close the pipe so the child reads end of file
+    pub fn close(&self) {
+        self.closed.store(true, Ordering::Release);
+        self.fd.lock().unwrap_or_else(|p| p.into_inner()).take();
+    }
+
+    /// Check whether `close` has been called
+    pub fn is_closed(&self) -> bool {
+        self.closed.load(Ordering::Acquire)
+    }
+
+    fn with_fd<T>(&self, operation: impl FnOnce(RawFd) -> io::Result<T>) -> io::Result<T> {
+        match self.fd.lock().unwrap_or_else(|p| p.into_inner()).as_ref() {
+            Some(fd) => operation(fd.as_raw_fd()),
+            None => Err(io::ErrorKind::BrokenPipe.into()),
+        }
+    }
+}
+
+/// Run `operation`, waiting in `poll` whenever it would block
+///
+/// Returns `None` on timeout or once `closed` is set.
+fn retry_when_ready<T>(
+    fd: RawFd,
+    events: libc::c_short,
+    closed: &AtomicBool,
+    timeout: Option<Duration>,
+    mut operation: impl FnMut() -> io::Result<T>,
+) -> IoResult<Option<T>> {
+    let deadline = timeout.map(|timeout| Instant::now() + timeout);
+    loop {
+        if closed.load(Ordering::Acquire) {
+            return Ok(None);
+        }
+        match operation() {
+            Ok(value) => return Ok(Some(value)),
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+            Err(e) if e.kind() != io::ErrorKind::WouldBlock => return Err(e.into()),
+            Err(_) => {}
+        }
+
+        let slice = match deadline {
+            Some(deadline) => match deadline.checked_duration_since(Instant::now()) {
+                Some(remaining) if !remaining.is_zero() => {
+                    (remaining.as_millis() as i32).clamp(1, POLL_SLICE_MS)
+                }
+                _ => return Ok(None),
+            },
+            None => POLL_SLICE_MS,
+        };
+        poll_one(fd, events, slice)?;
+    }
+}
+
+/// Wait up to `timeout_ms` for `events` on one descriptor
+fn poll_one(fd: RawFd, events: libc::c_short, timeout_ms: i32) -> io::Result<()> {
+    let mut pollfd = libc::pollfd { fd, events, revents: 0 };
+    if unsafe { libc::poll(&mut pollfd, 1, timeout_ms) } < 0 {
+        let error = io::Error::last_os_error();
+        if error.kind() != io::ErrorKind::Interrupted {
+            return Err(error);
+        }
+    }
+    Ok(())
+}
+
+/// Drain two pipes at once, so neither child stream can fill up and stall
+fn read_both(stdout: &PipeReader, stderr: &PipeReader) -> IoResult<(Vec<u8>, Vec<u8>)> {
+    let mut outputs = (Vec::new(), Vec::new());
+    let mut chunk = [0u8; 16 * 1024];
+    let mut open = [true, true];
+    while open[0] || open[1] {
+        let mut pollfds = [
+            libc::pollfd { fd: if open[0] { stdout.fd.as_raw_fd() } else { -1 }, events: libc::POLLIN, revents: 0 },
+            libc::pollfd { fd: if open[1] { stderr.fd.as_raw_fd() } else { -1 }, events: libc::POLLIN, revents: 0 },
+        ];
+        if unsafe { libc::poll(pollfds.as_mut_ptr(), 2, -1) } < 0 {
+            let error = io::Error::last_os_error();
+            if error.kind() == io::ErrorKind::Interrupted {
+                continue;
+            }
+            return Err(error.into());
+        }
+        for (index, (reader, output)) in [(stdout, &mut outputs.0), (stderr, &mut outputs.1)].into_iter().enumerate() {
+            if open[index] && pollfds[index].revents != 0 {
+                match reader.read(&mut chunk, Some(Duration::ZERO))? {
+                    Some(0) => open[index] = false,
+                    Some(n) => output.extend_from_slice(&chunk[..n]),
+                    None => {}
+                }
+            }
+        }
+    }
+    Ok(outputs)
+}
+
+/// Reap `pid` with `waitpid`; `None` if it is still running under `WNOHANG`
+fn reap(pid: libc::pid_t, flags: libc::c_int) -> IoResult<Option<i32>> {
+    let mut status = 0;
+    loop {
+        let rc = unsafe { libc::waitpid(pid, &mut status, flags) };
+        if rc == 0 {
+            return Ok(None);
+        }
+        if rc < 0 {
+            let error = io::Error::last_os_error();
+            if error.kind() == io::ErrorKind::Interrupted {
+                continue;
+            }
+            return Err(error.into());
+        }
+        let code = if libc::WIFEXITED(status) {
+            libc::WEXITSTATUS(status)
+        } else if libc::WIFSIGNALED(status) {
+            128 + libc::WTERMSIG(status)
+        } else {
+            // Stopped or continued; keep waiting for a real exit
+            if flags & libc::WNOHANG != 0 {
+                return Ok(None);
+            }
+            continue;
+        };
+        return Ok(Some(code));
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn pidfd_open(pid: libc::pid_t) -> Option<OwnedFd> {
+    let fd = unsafe { libc::syscall(libc::SYS_pidfd_open, pid, 0) };
+    if fd < 0 {
+        None
+    } else {
+        Some(unsafe { OwnedFd::from_raw_fd(fd as RawFd) })
+    }
+}
+
+/// Child and parent ends for one standard stream
+///
+/// Pipes are close-on-exec, so a child only inherits the ends duplicated
+/// onto its own standard streams; otherwise a pipeline stage could hold
+/// another stage's pipe open and it would never see end of file.
+fn child_stdio(mode: StdioMode, input: bool) -> IoResult<(Option<OwnedFd>, Option<OwnedFd>)> {
+    match mode {
+        StdioMode::Inherit => Ok((None, None)),
+        StdioMode::Fd(fd) => Ok((Some(above_stdio(fd)?), None)),
+        StdioMode::Null => {
+            let flags = if input { libc::O_RDONLY } else { libc::O_WRONLY };
+            let path = b"/dev/null\0";
+            let fd = unsafe { libc::open(path.as_ptr().cast(), flags | libc::O_CLOEXEC) };
+            if fd < 0 {
+                return Err(io::Error::last_os_error().into());
+            }
+            Ok((Some(above_stdio(unsafe { OwnedFd::from_raw_fd(fd) })?), None))
+        }
+        StdioMode::Piped => {
+            let (read_end, write_end) = pipe()?;
+            let (child, parent) = if input { (read_end, write_end) } else { (write_end, read_end) };
+            set_nonblocking(parent.as_raw_fd(), true)?;
+            Ok((Some(above_stdio(child)?), Some(parent)))
+        }
+    }
+}
+
+/// Move a descriptor above 0-2 so `dup2` onto a standard stream always
+/// produces a fresh, inheritable copy
+fn above_stdio(fd: OwnedFd) -> IoResult<OwnedFd> {
+    if fd.as_raw_fd() > 2 {
+        return Ok(fd);
+    }
+    let moved = unsafe { libc::fcntl(fd.as_raw_fd(), libc::F_DUPFD_CLOEXEC, 3) };
+    if moved < 0 {
+        return Err(io::Error::last_os_error().into());
+    }
+    Ok(unsafe { OwnedFd::from_raw_fd(moved) })
+}
+
+fn pipe() -> IoResult<(OwnedFd, OwnedFd)> {
+    let mut fds = [0 as RawFd; 2];
+    #[cfg(target_os = "linux")]
+    let rc = unsafe { libc::pipe2(fds.as_mut_ptr(), libc::O_CLOEXEC) };
+    #[cfg(not(target_os = "linux"))]
+    let rc = unsafe { libc::pipe(fds.as_mut_ptr()) };
+    if rc != 0 {
+        return Err(io::Error::last_os_error().into());
+    }
+    let ends = unsafe { (OwnedFd::from_raw_fd(fds[0]), OwnedFd::from_raw_fd(fds[1])) };
+    #[cfg(not(target_os = "linux"))]
+    for fd in [ends.0.as_raw_fd(), ends.1.as_raw_fd()] {
+        unsafe { libc::fcntl(fd, libc::F_SETFD, libc::FD_CLOEXEC) };
+    }
+    Ok(ends)
+}
+
+fn set_nonblocking(fd: RawFd, nonblocking: bool) -> io::Result<()> {
+    let flags = unsafe { libc::fcntl(fd, libc::F_GETFL) };
+    if flags < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    let flags = if nonblocking { flags | libc::O_NONBLOCK } else { flags & !libc::O_NONBLOCK };
+    if unsafe { libc::fcntl(fd, libc::F_SETFL, flags) } < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(())
+}
+
+fn c_string(value: &str) -> IoResult<CString> {
+    CString::new(value).map_err(|_| IoError::EncodingError {
+        message: format!("进程参数包含空字符: {:?}", value),
+    })
+}
+
+/// The parent's environment with `overrides` applied, as `KEY=VALUE` strings
+fn environment(overrides: &[(String, String)]) -> Vec<CString> {
+    let mut entries: Vec<CString> = std::env::vars_os()
+        .filter(|(key, _)| !overrides.iter().any(|(name, _)| key.as_bytes() == name.as_bytes()))
+        .filter_map(|(key, value)| {
+            let mut entry = key.as_bytes().to_vec();
+            entry.push(b'=');
+            entry.extend_from_slice(value.as_bytes());
+            CString::new(entry).ok()
+        })
+        .collect();
+    entries.extend(overrides.iter().filter_map(|(key, value)| CString::new(format!("{}={}", key, value)).ok()));
+    entries
+}
+
+fn null_terminated(strings: &[CString]) -> Vec<*mut libc::c_char> {
+    strings
+        .iter()
+        .map(|s| s.as_ptr() as *mut libc::c_char)
+        .chain(std::iter::once(std::ptr::null_mut()))
+        .collect()
+}
+
+fn spawn_error(program: &str, errno: i32) -> IoError {
+    match errno {
+        libc::ENOENT => IoError::ResourceNotFound { resource: program.to_string() },
+        libc::EACCES | libc::EPERM => IoError::PermissionDenied { resource: program.to_string() },
+        _ => IoError::SystemIoError(io::Error::from_raw_os_error(errno)),
+    }
+}
+
+/// Owned `posix_spawn_file_actions_t`
+struct FileActions(libc::posix_spawn_file_actions_t);
+
+impl FileActions {
+    fn new() -> IoResult<Self> {
+        let mut actions = std::mem::MaybeUninit::uninit();
+        check_spawn(unsafe { libc::posix_spawn_file_actions_init(actions.as_mut_ptr()) })?;
+        Ok(Self(unsafe { actions.assume_init() }))
+    }
+
+    fn dup2(&mut self, fd: RawFd, target: RawFd) -> IoResult<()> {
+        check_spawn(unsafe { libc::posix_spawn_file_actions_adddup2(&mut self.0, fd, target) })
+    }
+
+    fn as_ptr(&self) -> *const libc::posix_spawn_file_actions_t {
+        &self.0
+    }
+}
+
+impl Drop for FileActions {
+    fn drop(&mut self) {
+        unsafe { libc::posix_spawn_file_actions_destroy(&mut self.0) };
+    }
+}
+
+/// Owned `posix_spawnattr_t` that clears the signal mask and restores
+/// `SIGPIPE`, which the Rust runtime ignores, to its default action
+struct SpawnAttributes(libc::posix_spawnattr_t);
+
+impl SpawnAttributes {
+    fn new() -> IoResult<Self> {
+        let mut attributes = std::mem::MaybeUninit::uninit();
+        check_spawn(unsafe { libc::posix_spawnattr_init(attributes.as_mut_ptr()) })?;
+        let mut attributes = Self(unsafe { attributes.assume_init() });
+        unsafe {
+            let mut signals = std::mem::MaybeUninit::uninit();
+            libc::sigemptyset(signals.as_mut_ptr());
+            check_spawn(libc::posix_spawnattr_setsigmask(&mut attributes.0, signals.as_ptr()))?;
+            libc::sigaddset(signals.as_mut_ptr(), libc::SIGPIPE);
+            check_spawn(libc::posix_spawnattr_setsigdefault(&mut attributes.0, signals.as_ptr()))?;
+            let flags = libc::POSIX_SPAWN_SETSIGMASK | libc::POSIX_SPAWN_SETSIGDEF;
+            check_spawn(libc::posix_spawnattr_setflags(&mut attributes.0, flags as libc::c_short))?;
+        }
+        Ok(attributes)
+    }
+
+    fn as_ptr(&self) -> *const libc::posix_spawnattr_t {
+        &self.0
+    }
+}
+
+impl Drop for SpawnAttributes {
+    fn drop(&mut self) {
+        unsafe { libc::posix_spawnattr_destroy(&mut self.0) };
+    }
+}
+
+fn check_spawn(rc: libc::c_int) -> IoResult<()> {
+    if rc == 0 {
+        Ok(())
+    } else {
+        Err(IoError::SystemIoError(io::Error::from_raw_os_error(rc)))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_spawn_streams_stdout() {
+        let process = ProcessBuilder::new("sh")
+            .with_args(["-c", "echo 第一行; echo second"])
+            .with_stdout(StdioMode::Piped)
+            .spawn()
+            .unwrap();
+
+        let mut output = Vec::new();
+        process.stdout().unwrap().read_to_end(&mut output).unwrap();
+        assert_eq!(String::from_utf8(output).unwrap(), "第一行\nsecond\n");
+        assert!(process.stdout().unwrap().is_eof());
+        assert_eq!(process.wait().unwrap(), 0);
+    }
+
+    #[test]
+    fn test_stdin_round_trip_and_exit_code() {
+        let process = ProcessBuilder::new("sh")
+            .with_args(["-c", "cat; exit 3"])
+            .with_stdin(StdioMode::Piped)
+            .with_stdout(StdioMode::Piped)
+            .spawn()
+            .unwrap();
+
+        assert!(process.stdin().unwrap().write_all(b"hello", None).unwrap());
+        let mut buffer = [0u8; 16];
+        let n = process.stdout().unwrap().read(&mut buffer, Some(Duration::from_secs(5))).unwrap();
+        assert_eq!(&buffer[..n.unwrap()], b"hello");
+
+        // Nothing more arrives until stdin is closed
+        assert_eq!(process.stdout().unwrap().read(&mut buffer, Some(Duration::from_millis(20))).unwrap(), None);
+        process.close_stdin();
+        assert_eq!(process.wait_timeout(Duration::from_secs(5)).unwrap(), Some(3));
+    }
+
+    #[test]
+    fn test_output_collects_both_streams() {
+        let output = ProcessBuilder::new("sh")
+            .with_args(["-c", "echo out; echo err >&2; exit 1"])
+            .with_env("QI_TEST_VALUE", "值")
+            .output()
+            .unwrap();
+        assert_eq!(output.stdout, b"out\n");
+        assert_eq!(output.stderr, b"err\n");
+        assert!(!output.success());
+
+        let output = ProcessBuilder::new("sh")
+            .with_args(["-c", "printf %s \"$QI_TEST_VALUE\""])
+            .with_env("QI_TEST_VALUE", "值")
+            .output()
+            .unwrap();
+        assert_eq!(String::from_utf8(output.stdout).unwrap(), "值");
+    }
+
+    #[test]
+    fn test_missing_program() {
+        let result = ProcessBuilder::new("qi-no-such-program").spawn();
+        assert!(matches!(result, Err(IoError::ResourceNotFound { .. })));
+    }
+
+    #[test]
+    fn test_pipeline_and_kill() {
+        let pipeline = Pipeline::spawn(vec![
+            ProcessBuilder::new("printf").with_args(["c\\na\\nb\\n"]),
+            ProcessBuilder::new("sort"),
+            ProcessBuilder::from_command_line("head -n 2").unwrap().with_stdout(StdioMode::Piped),
+        ])
+        .unwrap();
+        let mut output = Vec::new();
+        pipeline.stdout().unwrap().read_to_end(&mut output).unwrap();
+        assert_eq!(output, b"a\nb\n");
+        assert_eq!(pipeline.wait().unwrap(), 0);
+
+        let sleeper = ProcessBuilder::new("sleep").with_args(["30"]).spawn().unwrap();
+        assert_eq!(sleeper.try_wait().unwrap(), None);
+        sleeper.kill(libc::SIGKILL).unwrap();
+        assert_eq!(sleeper.wait().unwrap(), 128 + libc::SIGKILL);
+    }
+
+    #[test]
+    fn test_splice_between_children() {
+        let source = ProcessBuilder::new("sh")
+            .with_args(["-c", "seq 1 20000"])
+            .with_stdout(StdioMode::Piped)
+            .spawn()
+            .unwrap();
+        let sink = ProcessBuilder::new("wc")
+            .with_args(["-l"])
+            .with_stdin(StdioMode::Piped)
+            .with_stdout(StdioMode::Piped)
+            .spawn()
+            .unwrap();
+
+        let moved = source.stdout().unwrap().splice_to(sink.stdin().unwrap()).unwrap();
+        assert_eq!(moved, (1..=20000).map(|n: u32| n.to_string().len() as u64 + 1).sum::<u64>());
+        sink.close_stdin();
+
+        let mut count = Vec::new();
+        sink.stdout().unwrap().read_to_end(&mut count).unwrap();
+        assert_eq!(String::from_utf8(count).unwrap().trim(), "20000");
+        assert_eq!(source.wait().unwrap(), 0);
+        assert_eq!(sink.wait().unwrap(), 0);
+    }
+}
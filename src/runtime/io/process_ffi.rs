@@ -0,0 +1,354 @@
+//! 进程模块 FFI 接口
+//!
+//! 为 Qi 语言提供 C 接口的子进程操作：启动命令或管道，流式读写其标准流，
+//! 并可把一个进程的输出直接转接到另一个进程的输入
+
+use super::process::{Pipeline, PipeReader, ProcessBuilder, StdioMode};
+use super::slab::HandleSlab;
+use std::ffi::{CStr, CString};
+use std::os::raw::c_char;
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::Duration;
+
+/// 单次读取的最大字节数
+const 读取块大小: usize = 64 * 1024;
+
+// 进程表：每个句柄对应一条管道（单个命令即只有一段的管道）；
+// 读写与等待在条目的 Arc 上进行，不持有槽锁
+static 进程表: OnceLock<HandleSlab<Arc<进程条目>>> = OnceLock::new();
+
+/// 进程管道及其输出流中尚未凑成完整 UTF-8 字符的字节
+struct 进程条目 {
+    管道: Pipeline,
+    输出残留: Mutex<Vec<u8>>,
+    错误残留: Mutex<Vec<u8>>,
+}
+
+fn 获取进程表() -> &'static HandleSlab<Arc<进程条目>> {
+    进程表.get_or_init(HandleSlab::new)
+}
+
+fn 查找进程(句柄: i64) -> Option<Arc<进程条目>> {
+    获取进程表().with(句柄, |条目| Arc::clone(条目))
+}
+
+fn 超时参数(timeout_ms: i64) -> Option<Duration> {
+    if timeout_ms < 0 { None } else { Some(Duration::from_millis(timeout_ms as u64)) }
+}
+
+fn 读取命令行(command: *const c_char) -> Option<String> {
+    if command.is_null() {
+        return None;
+    }
+    Some(unsafe { CStr::from_ptr(command).to_string_lossy().to_string() })
+}
+
+fn 登记管道(管道: Pipeline) -> i64 {
+    let 条目 = 进程条目 { 管道, 输出残留: Mutex::new(Vec::new()), 错误残留: Mutex::new(Vec::new()) };
+    match 获取进程表().insert(Arc::new(条目)) {
+        Some(句柄) => 句柄,
+        None => -1,
+    }
+}
+
+/// 读取一段输出并转为字符串，末尾不完整的 UTF-8 字节留到下次；
+/// 读到文件结束时把残留字节一并交出
+fn 读取文本(读端: &PipeReader, 残留: &Mutex<Vec<u8>>, 超时: Option<Duration>) -> String {
+    let mut 残留 = 残留.lock().unwrap_or_else(|p| p.into_inner());
+    let mut 块 = vec![0u8; 读取块大小];
+    let 结束 = match 读端.read(&mut 块, 超时) {
+        Ok(Some(0)) | Err(_) => true,
+        Ok(Some(字节数)) => {
+            残留.extend_from_slice(&块[..字节数]);
+            false
+        }
+        Ok(None) => false,
+    };
+
+    let 可用 = if 结束 {
+        残留.len()
+    } else {
+        match std::str::from_utf8(&残留) {
+            Ok(_) => 残留.len(),
+            Err(e) if e.error_len().is_none() => e.valid_up_to(),
+            Err(_) => 残留.len(),
+        }
+    };
+    let 文本 = String::from_utf8_lossy(&残留[..可用]).into_owned();
+    残留.drain(..可用);
+    文本
+}
+
+fn 转为字符串指针(文本: String) -> *mut c_char {
+    // 子进程输出可能含空字符，截断到第一个空字符为止
+    let 字节 = match 文本.find('\0') {
+        Some(位置) => 文本[..位置].to_string(),
+        None => 文本,
+    };
+    CString::new(字节).unwrap_or_default().into_raw()
+}
+
+/// 启动命令，按空白切分参数（不经过 shell）
+/// 标准输入与输出接到管道；capture_stderr 非 0 时标准错误也接到管道，否则继承
+/// 返回进程句柄（>0 成功），-1 失败，-2 命令不存在
+#[no_mangle]
+pub extern "C" fn qi_process_spawn(command: *const c_char, capture_stderr: i64) -> i64 {
+    let 构建器 = match 读取命令行(command).as_deref().and_then(ProcessBuilder::from_command_line) {
+        Some(构建器) => 构建器,
+        None => return -1,
+    };
+    let 错误模式 = if capture_stderr != 0 { StdioMode::Piped } else { StdioMode::Inherit };
+    let 构建器 = 构建器
+        .with_stdin(StdioMode::Piped)
+        .with_stdout(StdioMode::Piped)
+        .with_stderr(错误模式);
+
+    match Pipeline::spawn(vec![构建器]) {
+        Ok(管道) => 登记管道(管道),
+        Err(super::IoError::ResourceNotFound { .. }) => -2,
+        Err(_) => -1,
+    }
+}
+
+/// 启动以 '|' 分隔的多段命令，相邻进程的输出直接接到下一个进程的输入，
+/// 数据不经过本进程；第一段的输入与最后一段的输出接到管道
+/// 返回进程句柄（>0 成功），-1 失败，-2 某个命令不存在
+#[no_mangle]
+pub extern "C" fn qi_process_pipeline(command: *const c_char) -> i64 {
+    let 命令行 = match 读取命令行(command) {
+        Some(命令行) => 命令行,
+        None => return -1,
+    };
+    let 段数 = 命令行.split('|').count();
+    let mut 各段 = Vec::with_capacity(段数);
+    for (序号, 段) in 命令行.split('|').enumerate() {
+        let mut 构建器 = match ProcessBuilder::from_command_line(段) {
+            Some(构建器) => 构建器,
+            None => return -1,
+        };
+        if 序号 == 0 {
+            构建器 = 构建器.with_stdin(StdioMode::Piped);
+        }
+        if 序号 + 1 == 段数 {
+            构建器 = 构建器.with_stdout(StdioMode::Piped);
+        }
+        各段.push(构建器);
+    }
+
+    match Pipeline::spawn(各段) {
+        Ok(管道) => 登记管道(管道),
+        Err(super::IoError::ResourceNotFound { .. }) => -2,
+        Err(_) => -1,
+    }
+}
+
+/// 向进程的标准输入写入字符串，管道满时等待
+/// 返回写入的字节数，-1 失败（进程已退出或输入已关闭）
+#[no_mangle]
+pub extern "C" fn qi_process_write(handle: i64, data: *const c_char) -> i64 {
+    if data.is_null() {
+        return -1;
+    }
+    let 条目 = match 查找进程(handle) {
+        Some(条目) => 条目,
+        None => return -1,
+    };
+    let 数据 = unsafe { CStr::from_ptr(data).to_bytes() };
+    match 条目.管道.stdin().map(|输入| 输入.write_all(数据, None)) {
+        Some(Ok(true)) => 数据.len() as i64,
+        _ => -1,
+    }
+}
+
+/// 关闭进程的标准输入，进程随之读到文件结束
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_process_close_input(handle: i64) -> i64 {
+    match 查找进程(handle) {
+        Some(条目) => {
+            条目.管道.close_stdin();
+            1
+        }
+        None => 0,
+    }
+}
+
+/// 读取进程已输出的内容，timeout_ms < 0 表示等到有数据为止
+/// 返回字符串（需要调用 qi_process_free_string 释放）；超时或输出结束时为空字符串，
+/// 用 qi_process_output_ended 区分；句柄无效返回空指针
+#[no_mangle]
+pub extern "C" fn qi_process_read(handle: i64, timeout_ms: i64) -> *mut c_char {
+    let 条目 = match 查找进程(handle) {
+        Some(条目) => 条目,
+        None => return std::ptr::null_mut(),
+    };
+    match 条目.管道.stdout() {
+        Some(输出) => 转为字符串指针(读取文本(输出, &条目.输出残留, 超时参数(timeout_ms))),
+        None => std::ptr::null_mut(),
+    }
+}
+
+/// 读取进程的标准错误（启动时须指定捕获），用法同 qi_process_read
+#[no_mangle]
+pub extern "C" fn qi_process_read_error(handle: i64, timeout_ms: i64) -> *mut c_char {
+    let 条目 = match 查找进程(handle) {
+        Some(条目) => 条目,
+        None => return std::ptr::null_mut(),
+    };
+    match 条目.管道.stderr() {
+        Some(错误) => 转为字符串指针(读取文本(错误, &条目.错误残留, 超时参数(timeout_ms))),
+        None => std::ptr::null_mut(),
+    }
+}
+
+/// 标准输出是否已读完
+/// 返回 1 已结束，0 仍可能有输出，-1 句柄无效
+#[no_mangle]
+pub extern "C" fn qi_process_output_ended(handle: i64) -> i64 {
+    match 查找进程(handle) {
+        Some(条目) => {
+            let 已结束 = 条目.管道.stdout().map_or(true, |输出| 输出.is_eof())
+                && 条目.输出残留.lock().unwrap_or_else(|p| p.into_inner()).is_empty();
+            已结束 as i64
+        }
+        None => -1,
+    }
+}
+
+/// 把 source 进程的全部输出转接到 target 进程的输入，完成后关闭 target 的输入；
+/// Linux 上用 splice 在两条管道间直接移动数据，阻塞到 source 输出结束
+/// 返回转接的字节数，-1 失败
+#[no_mangle]
+pub extern "C" fn qi_process_splice(source: i64, target: i64) -> i64 {
+    let (源, 目标) = match (查找进程(source), 查找进程(target)) {
+        (Some(源), Some(目标)) => (源, 目标),
+        _ => return -1,
+    };
+    let (输出, 输入) = match (源.管道.stdout(), 目标.管道.stdin()) {
+        (Some(输出), Some(输入)) => (输出, 输入),
+        _ => return -1,
+    };
+    let 结果 = 输出.splice_to(输入);
+    目标.管道.close_stdin();
+    match 结果 {
+        Ok(字节数) => 字节数 as i64,
+        Err(_) => -1,
+    }
+}
+
+/// 等待进程（管道则为全部进程）退出，timeout_ms < 0 表示一直等待
+/// 返回退出码（被信号终止时为 128 + 信号值；管道取最后一段），-2 超时，-1 失败
+#[no_mangle]
+pub extern "C" fn qi_process_wait(handle: i64, timeout_ms: i64) -> i64 {
+    let 条目 = match 查找进程(handle) {
+        Some(条目) => 条目,
+        None => return -1,
+    };
+    let 结果 = match 超时参数(timeout_ms) {
+        Some(超时) => 条目.管道.wait_timeout(超时),
+        None => 条目.管道.wait().map(Some),
+    };
+    match 结果 {
+        Ok(Some(退出码)) => 退出码 as i64,
+        Ok(None) => -2,
+        Err(_) => -1,
+    }
+}
+
+/// 向进程（管道则为全部进程）发送 SIGTERM
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_process_kill(handle: i64) -> i64 {
+    match 查找进程(handle).map(|条目| 条目.管道.kill(libc::SIGTERM)) {
+        Some(Ok(())) => 1,
+        _ => 0,
+    }
+}
+
+/// 关闭进程句柄；仍在运行的进程被强制终止并回收，正在等待的读写随之返回
+/// 返回 1 成功，0 失败
+#[no_mangle]
+pub extern "C" fn qi_process_close(handle: i64) -> i64 {
+    match 获取进程表().remove(handle) {
+        Some(条目) => {
+            条目.管道.close_pipes();
+            if !matches!(条目.管道.try_wait(), Ok(Some(_))) {
+                let _ = 条目.管道.kill(libc::SIGKILL);
+                let _ = 条目.管道.wait();
+            }
+            1
+        }
+        None => 0,
+    }
+}
+
+/// 释放进程模块返回的字符串
+#[no_mangle]
+pub extern "C" fn qi_process_free_string(s: *mut c_char) {
+    if !s.is_null() {
+        unsafe {
+            let _ = CString::from_raw(s);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn 读完(句柄: i64) -> String {
+        let mut 全部 = String::new();
+        while qi_process_output_ended(句柄) == 0 {
+            let 指针 = qi_process_read(句柄, 1000);
+            assert!(!指针.is_null());
+            全部.push_str(&unsafe { CStr::from_ptr(指针) }.to_string_lossy());
+            qi_process_free_string(指针);
+        }
+        全部
+    }
+
+    #[test]
+    fn test_spawn_write_read_wait() {
+        let 命令 = CString::new("cat").unwrap();
+        let 句柄 = qi_process_spawn(命令.as_ptr(), 0);
+        assert!(句柄 > 0);
+
+        let 数据 = CString::new("你好，进程\n").unwrap();
+        assert_eq!(qi_process_write(句柄, 数据.as_ptr()), 数据.as_bytes().len() as i64);
+        assert_eq!(qi_process_wait(句柄, 10), -2);
+        assert_eq!(qi_process_close_input(句柄), 1);
+
+        assert_eq!(读完(句柄), "你好，进程\n");
+        assert_eq!(qi_process_wait(句柄, -1), 0);
+        assert_eq!(qi_process_close(句柄), 1);
+        assert_eq!(qi_process_close(句柄), 0);
+    }
+
+    #[test]
+    fn test_pipeline_and_splice() {
+        let 管道命令 = CString::new("sort -r | head -n 2").unwrap();
+        let 管道 = qi_process_pipeline(管道命令.as_ptr());
+        let 来源命令 = CString::new("seq 1 5").unwrap();
+        let 来源 = qi_process_spawn(来源命令.as_ptr(), 1);
+        assert!(管道 > 0 && 来源 > 0);
+
+        assert_eq!(qi_process_splice(来源, 管道), 10);
+        assert_eq!(读完(管道), "5\n4\n");
+        assert_eq!(qi_process_wait(管道, 5000), 0);
+        assert_eq!(qi_process_wait(来源, 5000), 0);
+        qi_process_close(管道);
+        qi_process_close(来源);
+
+        let 缺失 = CString::new("qi-no-such-program --flag").unwrap();
+        assert_eq!(qi_process_spawn(缺失.as_ptr(), 0), -2);
+    }
+
+    #[test]
+    fn test_close_kills_running_process() {
+        let 命令 = CString::new("sleep 30").unwrap();
+        let 句柄 = qi_process_spawn(命令.as_ptr(), 0);
+        assert!(句柄 > 0);
+        assert_eq!(qi_process_close(句柄), 1);
+        assert_eq!(qi_process_wait(句柄, 0), -1);
+    }
+}
@@ -0,0 +1,386 @@
+//! Buffered Input Scanner
+//!
+//! Large-buffer reader for bulk input. Words, numbers and lines are parsed
+//! straight out of the buffer and handed out as borrowed slices, so scanning
+//! input does not allocate per item. When the source is a regular file it
+//! is memory-mapped and scanned in place instead of being copied.
+
+use std::fs::File;
+use std::io::{self, Read};
+use std::path::Path;
+
+use super::mapped::MappedFile;
+use super::{IoError, IoResult};
+use crate::runtime::stdlib::number_format::{parse_float_ascii, parse_int_ascii};
+
+/// Default scanner buffer size (1 MiB)
+pub const SCANNER_BUFFER_SIZE: usize = 1 << 20;
+
+/// Where the scanner's bytes come from
+enum ScanSource<R> {
+    /// Streamed through the internal buffer
+    Reader(R),
+    /// Whole input mapped into memory
+    Mapped(MappedFile),
+}
+
+/// Zero-copy token and line scanner over a reader or a mapped file
+pub struct InputScanner<R> {
+    source: ScanSource<R>,
+    buffer: Vec<u8>,
+    /// Start of unread input
+    pos: usize,
+    /// End of valid input in the buffer (or mapping)
+    end: usize,
+    eof: bool,
+}
+
+impl<R: Read> InputScanner<R> {
+    /// Create a scanner with the default buffer size
+    pub fn new(reader: R) -> Self {
+        Self::with_capacity(reader, SCANNER_BUFFER_SIZE)
+    }
+
+    /// Create a scanner with a specific initial buffer size
+    ///
+    /// The buffer still grows when a single line or word is longer than it.
+    pub fn with_capacity(reader: R, capacity: usize) -> Self {
+        Self {
+            source: ScanSource::Reader(reader),
+            buffer: vec![0; capacity.max(16)],
+            pos: 0,
+            end: 0,
+            eof: false,
+        }
+    }
+
+    /// Scan a mapped file starting at byte `offset`
+    pub fn from_mapped(mapped: MappedFile, offset: usize) -> Self {
+        let end = mapped.len();
+        Self {
+            source: ScanSource::Mapped(mapped),
+            buffer: Vec::new(),
+            pos: offset.min(end),
+            end,
+            eof: true,
+        }
+    }
+
+    /// Whether the input is scanned from a memory mapping
+    pub fn is_mapped(&self) -> bool {
+        matches!(self.source, ScanSource::Mapped(_))
+    }
+
+    fn filled(&self) -> &[u8] {
+        match &self.source {
+            ScanSource::Mapped(mapped) => mapped.as_bytes(),
+            ScanSource::Reader(_) => &self.buffer[..self.end],
+        }
+    }
+
+    /// Read more input after the unread bytes; returns `false` at end of input
+    fn refill(&mut self) -> IoResult<bool> {
+        if self.eof {
+            return Ok(false);
+        }
+        let reader = match &mut self.source {
+            ScanSource::Reader(reader) => reader,
+            ScanSource::Mapped(_) => return Ok(false),
+        };
+
+        // Move unread bytes to the front, growing only when they fill the buffer
+        if self.pos > 0 {
+            self.buffer.copy_within(self.pos..self.end, 0);
+            self.end -= self.pos;
+            self.pos = 0;
+        }
+        if self.end == self.buffer.len() {
+            let grown = self.buffer.len() * 2;
+            self.buffer.resize(grown, 0);
+        }
+
+        loop {
+            match reader.read(&mut self.buffer[self.end..]) {
+                Ok(0) => {
+                    self.eof = true;
+                    return Ok(false);
+                }
+                Ok(count) => {
+                    self.end += count;
+                    return Ok(true);
+                }
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                Err(e) => return Err(IoError::SystemIoError(e)),
+            }
+        }
+    }
+
+    /// Next whitespace-separated word as raw bytes
+    pub fn next_token(&mut self) -> IoResult<Option<&[u8]>> {
+        loop {
+            let skip = self.filled()[self.pos..].iter().position(|b| !b.is_ascii_whitespace());
+            match skip {
+                Some(count) => {
+                    self.pos += count;
+                    break;
+                }
+                None => {
+                    self.pos = self.end;
+                    if !self.refill()? {
+                        return Ok(None);
+                    }
+                }
+            }
+        }
+
+        // Bytes in [pos, pos + scanned) are known to be part of the token
+        let mut scanned = 0;
+        loop {
+            let found = self.filled()[self.pos + scanned..].iter().position(|b| b.is_ascii_whitespace());
+            match found {
+                Some(count) => {
+                    let start = self.pos;
+                    self.pos = start + scanned + count;
+                    return Ok(Some(&self.filled()[start..self.pos]));
+                }
+                None => {
+                    scanned = self.end - self.pos;
+                    if !self.refill()? {
+                        let start = self.pos;
+                        self.pos = self.end;
+                        return Ok(Some(&self.filled()[start..]));
+                    }
+                }
+            }
+        }
+    }
+
+    /// Next line without its `\n` / `\r\n` terminator
+    pub fn next_line(&mut self) -> IoResult<Option<&[u8]>> {
+        let mut scanned = 0;
+        loop {
+            let found = find_byte(&self.filled()[self.pos + scanned..], b'\n');
+            match found {
+                Some(count) => {
+                    let start = self.pos;
+                    let newline = start + scanned + count;
+                    self.pos = newline + 1;
+                    return Ok(Some(trim_carriage_return(&self.filled()[start..newline])));
+                }
+                None => {
+                    scanned = self.end - self.pos;
+                    if !self.refill()? {
+                        if self.pos == self.end {
+                            return Ok(None);
+                        }
+                        let start = self.pos;
+                        self.pos = self.end;
+                        return Ok(Some(trim_carriage_return(&self.filled()[start..])));
+                    }
+                }
+            }
+        }
+    }
+
+    /// Next word, validated as UTF-8
+    pub fn read_word(&mut self) -> IoResult<Option<&str>> {
+        match self.next_token()? {
+            Some(token) => std::str::from_utf8(token).map(Some).map_err(|_| IoError::EncodingError {
+                message: "输入单词不是有效的UTF-8".to_string(),
+            }),
+            None => Ok(None),
+        }
+    }
+
+    /// Next word parsed as a decimal integer
+    pub fn read_int(&mut self) -> IoResult<Option<i64>> {
+        match self.next_token()? {
+            Some(token) => parse_int_ascii(token).map(Some).ok_or_else(|| IoError::EncodingError {
+                message: format!("无效的整数输入: {}", String::from_utf8_lossy(token)),
+            }),
+            None => Ok(None),
+        }
+    }
+
+    /// Next word parsed as a decimal float
+    pub fn read_float(&mut self) -> IoResult<Option<f64>> {
+        match self.next_token()? {
+            Some(token) => parse_float_ascii(token).map(Some).ok_or_else(|| IoError::EncodingError {
+                message: format!("无效的浮点数输入: {}", String::from_utf8_lossy(token)),
+            }),
+            None => Ok(None),
+        }
+    }
+
+    /// Consume and return all remaining input
+    ///
+    /// Mapped input is returned in place; streamed input is read to the end
+    /// into the scanner buffer.
+    pub fn read_remaining(&mut self) -> IoResult<&[u8]> {
+        while self.refill()? {}
+        let start = self.pos;
+        self.pos = self.end;
+        Ok(&self.filled()[start..])
+    }
+}
+
+impl InputScanner<io::Stdin> {
+    /// Scanner over standard input, mapped when stdin is a regular file
+    ///
+    /// Mapping starts at stdin's current offset, so it should be created
+    /// before anything else has read from standard input.
+    pub fn stdin() -> Self {
+        #[cfg(unix)]
+        if let Ok(Some(mapped)) = MappedFile::from_fd(libc::STDIN_FILENO) {
+            let offset = unsafe { libc::lseek(libc::STDIN_FILENO, 0, libc::SEEK_CUR) };
+            mapped.advise_sequential();
+            // Leave the descriptor at end of file; the mapping now owns the rest
+            unsafe { libc::lseek(libc::STDIN_FILENO, 0, libc::SEEK_END) };
+            return Self::from_mapped(mapped, offset.max(0) as usize);
+        }
+        Self::new(io::stdin())
+    }
+}
+
+impl InputScanner<File> {
+    /// Scanner over a file for front-to-back reading
+    ///
+    /// Regular files are mapped with `MADV_SEQUENTIAL`; anything else (or a
+    /// file reporting zero size, such as `/proc` entries) is streamed
+    /// through the buffer with sequential read-ahead advice.
+    pub fn open(path: impl AsRef<Path>) -> IoResult<Self> {
+        let file = File::open(path)?;
+        if let Some(mapped) = MappedFile::from_file(&file)? {
+            if !mapped.is_empty() {
+                mapped.advise_sequential();
+                return Ok(Self::from_mapped(mapped, 0));
+            }
+        }
+
+        #[cfg(target_os = "linux")]
+        {
+            use std::os::unix::io::AsRawFd;
+            unsafe { libc::posix_fadvise(file.as_raw_fd(), 0, 0, libc::POSIX_FADV_SEQUENTIAL) };
+        }
+        Ok(Self::new(file))
+    }
+}
+
+impl<R> std::fmt::Debug for InputScanner<R> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("InputScanner")
+            .field("mapped", &matches!(self.source, ScanSource::Mapped(_)))
+            .field("buffered", &(self.end - self.pos))
+            .field("eof", &self.eof)
+            .finish()
+    }
+}
+
+/// Iterator over the lines of an in-memory buffer, yielding borrowed slices
+#[derive(Debug, Clone)]
+pub struct ByteLines<'a> {
+    remaining: &'a [u8],
+}
+
+/// Split `data` into lines without allocating
+pub fn byte_lines(data: &[u8]) -> ByteLines<'_> {
+    ByteLines { remaining: data }
+}
+
+impl<'a> Iterator for ByteLines<'a> {
+    type Item = &'a [u8];
+
+    fn next(&mut self) -> Option<&'a [u8]> {
+        if self.remaining.is_empty() {
+            return None;
+        }
+        let (line, rest) = match find_byte(self.remaining, b'\n') {
+            Some(index) => (&self.remaining[..index], &self.remaining[index + 1..]),
+            None => (self.remaining, &self.remaining[self.remaining.len()..]),
+        };
+        self.remaining = rest;
+        Some(trim_carriage_return(line))
+    }
+}
+
+fn trim_carriage_return(line: &[u8]) -> &[u8] {
+    match line.last() {
+        Some(b'\r') => &line[..line.len() - 1],
+        _ => line,
+    }
+}
+
+/// Find a byte eight bytes at a time (SWAR zero-byte test)
+pub fn find_byte(haystack: &[u8], needle: u8) -> Option<usize> {
+    const LO: u64 = 0x0101_0101_0101_0101;
+    const HI: u64 = 0x8080_8080_8080_8080;
+    let pattern = LO * needle as u64;
+
+    let mut chunks = haystack.chunks_exact(8);
+    let mut offset = 0;
+    for chunk in &mut chunks {
+        let word = u64::from_le_bytes(chunk.try_into().unwrap()) ^ pattern;
+        let zero = word.wrapping_sub(LO) & !word & HI;
+        if zero != 0 {
+            return Some(offset + (zero.trailing_zeros() / 8) as usize);
+        }
+        offset += 8;
+    }
+    chunks.remainder().iter().position(|&b| b == needle).map(|index| offset + index)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_tokens_across_buffer_boundaries() {
+        // A tiny buffer forces refills and growth in the middle of tokens
+        let input = "  12 -7\n3.5  词语\t1e3\n  9223372036854775807";
+        let mut scanner = InputScanner::with_capacity(input.as_bytes(), 4);
+
+        assert_eq!(scanner.read_int().unwrap(), Some(12));
+        assert_eq!(scanner.read_int().unwrap(), Some(-7));
+        assert_eq!(scanner.read_float().unwrap(), Some(3.5));
+        assert_eq!(scanner.read_word().unwrap(), Some("词语"));
+        assert_eq!(scanner.read_float().unwrap(), Some(1000.0));
+        assert_eq!(scanner.read_int().unwrap(), Some(i64::MAX));
+        assert_eq!(scanner.read_int().unwrap(), None);
+    }
+
+    #[test]
+    fn test_invalid_number_is_an_error() {
+        let mut scanner = InputScanner::new("abc".as_bytes());
+        assert!(scanner.read_int().is_err());
+    }
+
+    #[test]
+    fn test_lines() {
+        let input = "第一行\r\n\nlast";
+        let mut scanner = InputScanner::with_capacity(input.as_bytes(), 4);
+        assert_eq!(scanner.next_line().unwrap(), Some("第一行".as_bytes()));
+        assert_eq!(scanner.next_line().unwrap(), Some(&b""[..]));
+        assert_eq!(scanner.next_line().unwrap(), Some(&b"last"[..]));
+        assert_eq!(scanner.next_line().unwrap(), None);
+
+        let lines: Vec<&[u8]> = byte_lines(b"a\r\nb\n\nc\n").collect();
+        assert_eq!(lines, vec![&b"a"[..], b"b", b"", b"c"]);
+    }
+
+    #[test]
+    fn test_read_remaining_after_tokens() {
+        let mut scanner = InputScanner::with_capacity("1 rest of input".as_bytes(), 4);
+        assert_eq!(scanner.read_int().unwrap(), Some(1));
+        assert_eq!(scanner.read_remaining().unwrap(), b" rest of input");
+        assert_eq!(scanner.read_remaining().unwrap(), b"");
+    }
+
+    #[test]
+    fn test_find_byte() {
+        let data = b"0123456789abcdef\nxyz";
+        assert_eq!(find_byte(data, b'\n'), Some(16));
+        assert_eq!(find_byte(data, b'z'), Some(19));
+        assert_eq!(find_byte(data, b'!'), None);
+        assert_eq!(find_byte(&[0x81, b'\n'], b'\n'), Some(1));
+    }
+}
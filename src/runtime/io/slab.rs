@@ -0,0 +1,227 @@
+//! Handle Slab
+//!
+//! Generation-checked handle table shared by the runtime FFI layers. Slots
+//! live in lazily allocated segments that never move, so a lookup decodes
+//! the slot index from the handle and locks only that slot; there is no
+//! table-wide lock. A 31-bit generation packed into the handle is bumped
+//! when a slot is freed, so stale handles are rejected after reuse. Free
+//! slots are recycled through a tagged lock-free stack.
+
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::sync::{Mutex, MutexGuard, OnceLock};
+
+/// Slots per lazily allocated segment
+const SEGMENT_SIZE: usize = 1024;
+/// Maximum number of segments (about one million live handles)
+const SEGMENT_COUNT: usize = 1024;
+/// Generations use 31 bits so handles stay positive as `i64`
+const GENERATION_MASK: u32 = 0x7fff_ffff;
+
+/// Opaque handle: generation in the high 32 bits, slot index + 1 below
+pub type Handle = i64;
+
+struct Slot<T> {
+    /// Only changed while `value` is locked
+    generation: AtomicU32,
+    /// Next free slot index + 1 while this slot is on the free stack
+    next_free: AtomicU32,
+    value: Mutex<Option<T>>,
+}
+
+impl<T> Slot<T> {
+    fn new() -> Self {
+        Self {
+            generation: AtomicU32::new(1),
+            next_free: AtomicU32::new(0),
+            value: Mutex::new(None),
+        }
+    }
+
+    fn lock(&self) -> MutexGuard<'_, Option<T>> {
+        self.value.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+}
+
+/// Slab of values addressed by generation-checked handles
+pub struct HandleSlab<T> {
+    segments: Box<[OnceLock<Box<[Slot<T>]>>]>,
+    /// Number of slot indices handed out so far
+    next_fresh: AtomicU32,
+    /// Free stack head: ABA tag in the high 32 bits, slot index + 1 below
+    free_head: AtomicU64,
+}
+
+impl<T> HandleSlab<T> {
+    /// Create an empty slab; segments are allocated on first use
+    pub fn new() -> Self {
+        Self {
+            segments: (0..SEGMENT_COUNT).map(|_| OnceLock::new()).collect(),
+            next_fresh: AtomicU32::new(0),
+            free_head: AtomicU64::new(0),
+        }
+    }
+
+    /// Store `value` and return its handle; `None` when the slab is full
+    pub fn insert(&self, value: T) -> Option<Handle> {
+        let index = self.allocate_slot()?;
+        let slot = self.slot(index);
+        let mut guard = slot.lock();
+        let generation = slot.generation.load(Ordering::Acquire);
+        *guard = Some(value);
+        Some(((generation as i64) << 32) | (index as i64 + 1))
+    }
+
+    /// Run `operation` on the value behind `handle` with only its slot locked
+    ///
+    /// Returns `None` for unknown, closed or stale handles.
+    pub fn with<R>(&self, handle: Handle, operation: impl FnOnce(&mut T) -> R) -> Option<R> {
+        let (index, generation) = self.decode(handle)?;
+        let slot = self.slot(index);
+        // Cheap rejection of stale handles before taking the slot lock
+        if slot.generation.load(Ordering::Acquire) != generation {
+            return None;
+        }
+        let mut guard = slot.lock();
+        if slot.generation.load(Ordering::Acquire) != generation {
+            return None;
+        }
+        guard.as_mut().map(operation)
+    }
+
+    /// Take the value out and invalidate `handle`
+    pub fn remove(&self, handle: Handle) -> Option<T> {
+        let (index, generation) = self.decode(handle)?;
+        let slot = self.slot(index);
+        let value = {
+            let mut guard = slot.lock();
+            if slot.generation.load(Ordering::Acquire) != generation {
+                return None;
+            }
+            let value = guard.take()?;
+            let next = (generation.wrapping_add(1) & GENERATION_MASK).max(1);
+            slot.generation.store(next, Ordering::Release);
+            value
+        };
+        self.release_slot(index);
+        Some(value)
+    }
+
+    /// Number of slots ever allocated (live plus recycled)
+    pub fn allocated_slots(&self) -> usize {
+        (self.next_fresh.load(Ordering::Relaxed) as usize).min(SEGMENT_SIZE * SEGMENT_COUNT)
+    }
+
+    fn decode(&self, handle: Handle) -> Option<(u32, u32)> {
+        let index = (handle & 0xffff_ffff) as u32;
+        let generation = (handle >> 32) as u32;
+        if handle <= 0 || index == 0 || index as usize > self.allocated_slots() {
+            return None;
+        }
+        Some((index - 1, generation))
+    }
+
+    fn slot(&self, index: u32) -> &Slot<T> {
+        let index = index as usize;
+        let segment = self.segments[index / SEGMENT_SIZE]
+            .get_or_init(|| (0..SEGMENT_SIZE).map(|_| Slot::new()).collect());
+        &segment[index % SEGMENT_SIZE]
+    }
+
+    fn allocate_slot(&self) -> Option<u32> {
+        let mut head = self.free_head.load(Ordering::Acquire);
+        loop {
+            let top = head as u32;
+            if top == 0 {
+                break;
+            }
+            let next = self.slot(top - 1).next_free.load(Ordering::Relaxed);
+            let tagged = (((head >> 32) + 1) << 32) | next as u64;
+            match self.free_head.compare_exchange_weak(head, tagged, Ordering::AcqRel, Ordering::Acquire) {
+                Ok(_) => return Some(top - 1),
+                Err(current) => head = current,
+            }
+        }
+
+        let index = self.next_fresh.fetch_add(1, Ordering::AcqRel);
+        if index as usize >= SEGMENT_SIZE * SEGMENT_COUNT {
+            self.next_fresh.fetch_sub(1, Ordering::AcqRel);
+            return None;
+        }
+        Some(index)
+    }
+
+    fn release_slot(&self, index: u32) {
+        let slot = self.slot(index);
+        let mut head = self.free_head.load(Ordering::Relaxed);
+        loop {
+            slot.next_free.store(head as u32, Ordering::Relaxed);
+            let tagged = (((head >> 32) + 1) << 32) | (index as u64 + 1);
+            match self.free_head.compare_exchange_weak(head, tagged, Ordering::AcqRel, Ordering::Relaxed) {
+                Ok(_) => return,
+                Err(current) => head = current,
+            }
+        }
+    }
+}
+
+impl<T> Default for HandleSlab<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<T> std::fmt::Debug for HandleSlab<T> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("HandleSlab")
+            .field("allocated_slots", &self.allocated_slots())
+            .finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_insert_with_remove() {
+        let slab = HandleSlab::new();
+        let first = slab.insert(String::from("甲")).unwrap();
+        let second = slab.insert(String::from("乙")).unwrap();
+        assert_ne!(first, second);
+
+        assert_eq!(slab.with(first, |value| value.clone()), Some("甲".to_string()));
+        slab.with(second, |value| value.push('丙'));
+        assert_eq!(slab.remove(second), Some("乙丙".to_string()));
+        assert_eq!(slab.remove(second), None);
+        assert_eq!(slab.with(second, |_| ()), None);
+
+        // The freed slot is reused under a new generation
+        let third = slab.insert(String::from("丁")).unwrap();
+        assert_eq!(third & 0xffff_ffff, second & 0xffff_ffff);
+        assert_eq!(slab.with(second, |_| ()), None);
+        assert_eq!(slab.with(third, |value| value.clone()), Some("丁".to_string()));
+
+        assert_eq!(slab.with(0, |_| ()), None);
+        assert_eq!(slab.with(-1, |_| ()), None);
+        assert_eq!(slab.with(1 << 40, |_| ()), None);
+        assert_eq!(slab.allocated_slots(), 2);
+    }
+
+    #[test]
+    fn test_concurrent_insert_remove() {
+        let slab = HandleSlab::new();
+        std::thread::scope(|scope| {
+            for thread in 0..8u64 {
+                let slab = &slab;
+                scope.spawn(move || {
+                    for i in 0..1000 {
+                        let handle = slab.insert(thread * 10_000 + i).unwrap();
+                        assert_eq!(slab.with(handle, |value| *value), Some(thread * 10_000 + i));
+                        assert_eq!(slab.remove(handle), Some(thread * 10_000 + i));
+                    }
+                });
+            }
+        });
+        assert!(slab.allocated_slots() <= 8);
+    }
+}
@@ -3,14 +3,32 @@
 //! This module provides standard input/output operations with
 //! Chinese language support and console interface management.
 
-use std::io::{self, Write, Read};
+use std::io::{self, Write};
+use std::sync::{Mutex, OnceLock};
 use super::{IoResult, IoError};
+use super::scanner::InputScanner;
+use crate::runtime::stdlib::number_format::{format_float, format_int, FLOAT_BUFFER_SIZE, INT_BUFFER_SIZE};
+
+/// Process-wide scanner over standard input
+///
+/// Every reader of fd 0 (the runtime's input builtins and every
+/// `StandardIo`) goes through this one scanner. Two independent buffers
+/// would each swallow input the other should have seen.
+static STDIN_SCANNER: OnceLock<Mutex<InputScanner<io::Stdin>>> = OnceLock::new();
+
+/// Run `f` with exclusive access to the shared stdin scanner
+///
+/// The scanner is created on first use, so stdin can still be mapped when
+/// it is a regular file.
+pub fn with_stdin<T>(f: impl FnOnce(&mut InputScanner<io::Stdin>) -> T) -> T {
+    let scanner = STDIN_SCANNER.get_or_init(|| Mutex::new(InputScanner::stdin()));
+    let mut guard = scanner.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+    f(&mut guard)
+}
 
 /// Standard I/O interface
 #[derive(Debug)]
 pub struct StandardIo {
-    /// Input buffer
-    input_buffer: String,
     /// Output buffer
     output_buffer: String,
     /// Error buffer
@@ -23,7 +41,6 @@ impl StandardIo {
     /// Create new standard I/O interface
     pub fn new() -> Self {
         Self {
-            input_buffer: String::new(),
             output_buffer: String::new(),
             error_buffer: String::new(),
             use_buffering: true,
@@ -33,41 +50,55 @@ impl StandardIo {
     /// Create standard I/O with buffering disabled
     pub fn unbuffered() -> Self {
         Self {
-            input_buffer: String::new(),
             output_buffer: String::new(),
             error_buffer: String::new(),
             use_buffering: false,
         }
     }
 
+    /// Borrow the shared stdin scanner
+    ///
+    /// All reads go through one large buffer (or one mapping when stdin is
+    /// a regular file), shared with the runtime's input builtins, so line,
+    /// word and number reads can be mixed freely. Slices returned by the
+    /// scanner are only valid inside `f`.
+    pub fn with_input<T>(&mut self, f: impl FnOnce(&mut InputScanner<io::Stdin>) -> T) -> T {
+        with_stdin(f)
+    }
+
     /// Read a line from standard input
     pub fn read_line(&mut self) -> IoResult<String> {
-        let mut input = String::new();
+        self.with_input(|input| match input.next_line()? {
+            Some(line) => String::from_utf8(line.to_vec()).map_err(|_| IoError::EncodingError {
+                message: "输入行不是有效的UTF-8".to_string(),
+            }),
+            None => Ok(String::new()),
+        })
+    }
 
-        io::stdin()
-            .read_line(&mut input)
-            .map_err(|e| IoError::SystemIoError(e))?;
+    /// Read the next whitespace-separated word
+    pub fn read_word(&mut self) -> IoResult<Option<String>> {
+        self.with_input(|input| Ok(input.read_word()?.map(str::to_string)))
+    }
 
-        // Remove trailing newline
-        if input.ends_with('\n') {
-            input.pop();
-            if input.ends_with('\r') {
-                input.pop();
-            }
-        }
+    /// Read the next word as an integer
+    pub fn read_int(&mut self) -> IoResult<Option<i64>> {
+        self.with_input(|input| input.read_int())
+    }
 
-        Ok(input)
+    /// Read the next word as a float
+    pub fn read_float(&mut self) -> IoResult<Option<f64>> {
+        self.with_input(|input| input.read_float())
     }
 
     /// Read all input from standard input
     pub fn read_all(&mut self) -> IoResult<String> {
-        let mut input = String::new();
-
-        io::stdin()
-            .read_to_string(&mut input)
-            .map_err(|e| IoError::SystemIoError(e))?;
-
-        Ok(input)
+        self.with_input(|input| {
+            let bytes = input.read_remaining()?;
+            String::from_utf8(bytes.to_vec()).map_err(|_| IoError::EncodingError {
+                message: "标准输入不是有效的UTF-8".to_string(),
+            })
+        })
     }
 
     /// Print to standard output
@@ -120,22 +151,26 @@ impl StandardIo {
 
     /// Print integer value
     pub fn print_int(&mut self, value: i64) -> IoResult<()> {
-        self.print(&value.to_string())
+        let mut buffer = [0u8; INT_BUFFER_SIZE];
+        self.print(format_int(value, &mut buffer))
     }
 
     /// Print integer value with newline
     pub fn println_int(&mut self, value: i64) -> IoResult<()> {
-        self.println(&value.to_string())
+        let mut buffer = [0u8; INT_BUFFER_SIZE];
+        self.println(format_int(value, &mut buffer))
     }
 
     /// Print floating point value
     pub fn print_float(&mut self, value: f64) -> IoResult<()> {
-        self.print(&value.to_string())
+        let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+        self.print(format_float(value, &mut buffer))
     }
 
     /// Print floating point value with newline
     pub fn println_float(&mut self, value: f64) -> IoResult<()> {
-        self.println(&value.to_string())
+        let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+        self.println(format_float(value, &mut buffer))
     }
 
     /// Print boolean value
@@ -0,0 +1,482 @@
+//! File Transfer Primitives
+//!
+//! In-kernel file copies and batched appends. `copy_file` moves data with
+//! `copy_file_range` (falling back to `sendfile`, then to a userspace copy)
+//! so file contents never pass through a Qi string. `Appender` keeps one
+//! append-mode descriptor open, queues appended buffers and writes them with
+//! a single vectored write; durable appends from many threads share one
+//! `fdatasync` through group commit.
+
+use std::fs::{File, OpenOptions};
+use std::io::{self, IoSlice, Write};
+use std::path::Path;
+use std::sync::{Condvar, Mutex, MutexGuard};
+
+/// Queued bytes that trigger a vectored write
+pub const APPEND_BATCH_BYTES: usize = 64 * 1024;
+
+/// Maximum buffers per vectored write (Linux `IOV_MAX`)
+const MAX_IOVECS: usize = 1024;
+
+/// Copy the regular file `from` to `to`, returning the number of bytes copied
+///
+/// The destination is created or truncated and receives the source's
+/// permissions, like `std::fs::copy`.
+pub fn copy_file(from: impl AsRef<Path>, to: impl AsRef<Path>) -> io::Result<u64> {
+    let source = File::open(from)?;
+    let metadata = source.metadata()?;
+    if !metadata.is_file() {
+        return Err(io::Error::new(io::ErrorKind::InvalidInput, "只能复制常规文件"));
+    }
+
+    let dest = OpenOptions::new().write(true).create(true).truncate(true).open(to)?;
+    dest.set_permissions(metadata.permissions())?;
+    copy_contents(&source, &dest)
+}
+
+/// Copy from the current offset of `source` to the current offset of `dest`
+#[cfg(target_os = "linux")]
+fn copy_contents(source: &File, dest: &File) -> io::Result<u64> {
+    use std::os::unix::io::AsRawFd;
+
+    // Largest request copy_file_range and sendfile both accept
+    const CHUNK: usize = 1 << 30;
+
+    let (src, dst) = (source.as_raw_fd(), dest.as_raw_fd());
+    let mut copied = 0u64;
+    let mut use_copy_file_range = true;
+    loop {
+        let result = if use_copy_file_range {
+            unsafe { libc::copy_file_range(src, std::ptr::null_mut(), dst, std::ptr::null_mut(), CHUNK, 0) }
+        } else {
+            unsafe { libc::sendfile(dst, src, std::ptr::null_mut(), CHUNK) }
+        };
+
+        if result > 0 {
+            copied += result as u64;
+            continue;
+        }
+        if result == 0 {
+            // Pseudo-files report size 0 and copy nothing in-kernel; let a
+            // plain read loop decide whether they are really empty
+            if copied == 0 && use_copy_file_range {
+                return generic_copy(source, dest);
+            }
+            return Ok(copied);
+        }
+
+        let err = io::Error::last_os_error();
+        match err.raw_os_error() {
+            Some(libc::EINTR) => continue,
+            // Older kernels, cross-filesystem copies and unsupported filesystems
+            Some(libc::ENOSYS | libc::EXDEV | libc::EINVAL | libc::EOPNOTSUPP | libc::EPERM)
+                if use_copy_file_range =>
+            {
+                use_copy_file_range = false;
+            }
+            Some(libc::ENOSYS | libc::EINVAL) => return Ok(copied + generic_copy(source, dest)?),
+            _ => return Err(err),
+        }
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn copy_contents(source: &File, dest: &File) -> io::Result<u64> {
+    generic_copy(source, dest)
+}
+
+fn generic_copy(mut source: &File, mut dest: &File) -> io::Result<u64> {
+    io::copy(&mut source, &mut dest)
+}
+
+/// Appended data that has not reached the file yet
+struct AppendState {
+    pending: Vec<Vec<u8>>,
+    pending_bytes: usize,
+    /// Sequence number of the last queued append
+    appended: u64,
+    /// Every append up to this sequence number has been handed to
+    /// `write_pending`; the ones in `failed` never reached the file
+    written: u64,
+    /// Every append up to this sequence number has been through `fdatasync`;
+    /// the ones in `failed` did not survive it
+    synced: u64,
+    /// Last sequence number claimed by a group-commit leader
+    grouped: u64,
+    /// A group-commit leader is currently in `fdatasync`
+    syncing: bool,
+    /// Last sequence number covered by a finished `sync`
+    sync_reported: u64,
+    /// Appends whose write or `fdatasync` failed, oldest first
+    failed: Vec<FailedGroup>,
+}
+
+/// Sequence range of failed appends and their error
+struct FailedGroup {
+    first: u64,
+    last: u64,
+    kind: io::ErrorKind,
+    message: String,
+}
+
+/// Persistent append-only writer with vectored batching and group commit
+pub struct Appender {
+    file: File,
+    state: Mutex<AppendState>,
+    synced: Condvar,
+}
+
+impl Appender {
+    /// Open `path` for appending, creating it if needed
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Self> {
+        let file = OpenOptions::new().append(true).create(true).open(path)?;
+        Ok(Self {
+            file,
+            state: Mutex::new(AppendState {
+                pending: Vec::new(),
+                pending_bytes: 0,
+                appended: 0,
+                written: 0,
+                synced: 0,
+                grouped: 0,
+                syncing: false,
+                sync_reported: 0,
+                failed: Vec::new(),
+            }),
+            synced: Condvar::new(),
+        })
+    }
+
+    /// Queue `data`; it is written once enough appends have accumulated,
+    /// or on `flush`, `sync` or drop
+    ///
+    /// Taking the buffer by value lets callers hand over an owned `String`
+    /// or `Vec` without another copy.
+    pub fn append(&self, data: impl Into<Vec<u8>>) -> io::Result<()> {
+        let mut state = self.lock();
+        self.enqueue(&mut state, data.into());
+        if state.pending_bytes >= APPEND_BATCH_BYTES || state.pending.len() >= MAX_IOVECS {
+            self.write_pending(&mut state)?;
+        }
+        Ok(())
+    }
+
+    /// Append `data` and return once it is on stable storage
+    ///
+    /// Callers that arrive while another thread is in `fdatasync` queue
+    /// their data and wait; the next leader writes the whole group and
+    /// syncs it once.
+    pub fn append_durable(&self, data: impl Into<Vec<u8>>) -> io::Result<()> {
+        let mut state = self.lock();
+        let sequence = self.enqueue(&mut state, data.into());
+        self.commit(state, sequence, sequence)
+    }
+
+    /// Write queued appends to the file
+    ///
+    /// A failed write is also reported by the next `sync`.
+    pub fn flush(&self) -> io::Result<()> {
+        let mut state = self.lock();
+        self.write_pending(&mut state)
+    }
+
+    /// Make every append queued so far durable
+    ///
+    /// Fails if any append since the previous `sync` was lost, including
+    /// ones whose `append` or `flush` already returned the error.
+    pub fn sync(&self) -> io::Result<()> {
+        let state = self.lock();
+        let first = state.sync_reported + 1;
+        let sequence = state.appended;
+        let result = self.commit(state, first, sequence);
+        let mut state = self.lock();
+        state.sync_reported = state.sync_reported.max(sequence);
+        result
+    }
+
+    fn lock(&self) -> MutexGuard<'_, AppendState> {
+        self.state.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+
+    fn enqueue(&self, state: &mut AppendState, data: Vec<u8>) -> u64 {
+        if !data.is_empty() {
+            state.pending_bytes += data.len();
+            state.pending.push(data);
+        }
+        state.appended += 1;
+        state.appended
+    }
+
+    /// Wait until appends `first..=sequence` are durable, leading a group
+    /// commit if no other thread is
+    fn commit<'a>(&'a self, mut state: MutexGuard<'a, AppendState>, first: u64, sequence: u64) -> io::Result<()> {
+        loop {
+            // A later group syncing successfully does not make a failed one
+            // durable, so look up the caller's own appends before `synced`
+            if let Some(group) = state.failed.iter().find(|group| group.first <= sequence && first <= group.last) {
+                return Err(io::Error::new(group.kind, group.message.clone()));
+            }
+            if state.synced >= sequence {
+                return Ok(());
+            }
+
+            if state.syncing {
+                state = self.synced.wait(state).unwrap_or_else(|poisoned| poisoned.into_inner());
+                continue;
+            }
+
+            // Become the leader: write everything queued, then sync without
+            // holding the lock so later callers can join the next group
+            state.syncing = true;
+            let group_first = state.grouped + 1;
+            let group_end = state.appended;
+            state.grouped = group_end;
+            let written = self.write_pending(&mut state);
+            drop(state);
+            let result = written.and_then(|_| self.file.sync_data());
+
+            state = self.lock();
+            state.syncing = false;
+            state.synced = state.synced.max(group_end);
+            if let Err(e) = result {
+                record_failure(&mut state, group_first, group_end, &e);
+            }
+            self.synced.notify_all();
+        }
+    }
+
+    /// Write all queued buffers, `MAX_IOVECS` at a time
+    ///
+    /// Runs under the state lock so appends reach the file in order. On
+    /// error the unwritten data is dropped, the appends are recorded as
+    /// failed for later `commit` calls, and the error returned.
+    fn write_pending(&self, state: &mut AppendState) -> io::Result<()> {
+        let first = state.written + 1;
+        let last = state.appended;
+        state.written = last;
+        let mut pending = std::mem::take(&mut state.pending);
+        state.pending_bytes = 0;
+
+        let result = self.write_buffers(&pending);
+        if let Err(e) = &result {
+            record_failure(state, first, last, e);
+        }
+
+        // Keep the allocation for the next batch
+        pending.clear();
+        state.pending = pending;
+        result
+    }
+
+    fn write_buffers(&self, pending: &[Vec<u8>]) -> io::Result<()> {
+        let mut writer = &self.file;
+        let mut buffer = 0;
+        let mut offset = 0;
+        while buffer < pending.len() {
+            let end = (buffer + MAX_IOVECS).min(pending.len());
+            let mut slices = Vec::with_capacity(end - buffer);
+            slices.push(IoSlice::new(&pending[buffer][offset..]));
+            slices.extend(pending[buffer + 1..end].iter().map(|data| IoSlice::new(data)));
+
+            let mut written = match writer.write_vectored(&slices) {
+                Ok(0) => return Err(io::Error::from(io::ErrorKind::WriteZero)),
+                Ok(count) => count,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                Err(e) => return Err(e),
+            };
+
+            // Advance past fully written buffers, then into a partial one
+            while buffer < pending.len() && written >= pending[buffer].len() - offset {
+                written -= pending[buffer].len() - offset;
+                buffer += 1;
+                offset = 0;
+            }
+            offset += written;
+        }
+        Ok(())
+    }
+}
+
+/// Record appends `first..=last` as failed with `error`
+fn record_failure(state: &mut AppendState, first: u64, last: u64, error: &io::Error) {
+    if first > last {
+        return;
+    }
+    match state.failed.last_mut() {
+        // Overlapping or consecutive failures share one entry
+        Some(group) if group.last + 1 >= first => group.last = group.last.max(last),
+        _ => state.failed.push(FailedGroup {
+            first,
+            last,
+            kind: error.kind(),
+            message: error.to_string(),
+        }),
+    }
+}
+
+impl Drop for Appender {
+    fn drop(&mut self) {
+        let _ = self.flush();
+    }
+}
+
+impl std::fmt::Debug for Appender {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let state = self.lock();
+        f.debug_struct("Appender")
+            .field("pending_bytes", &state.pending_bytes)
+            .field("appended", &state.appended)
+            .field("synced", &state.synced)
+            .finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+
+    fn temp_path(name: &str) -> std::path::PathBuf {
+        std::env::temp_dir().join(format!("qi_transfer_{}_{}", name, std::process::id()))
+    }
+
+    #[test]
+    fn test_copy_file() {
+        let from = temp_path("copy_from");
+        let to = temp_path("copy_to");
+        let content: Vec<u8> = (0..300_000u32).map(|i| (i % 251) as u8).collect();
+        std::fs::write(&from, &content).unwrap();
+        std::fs::write(&to, b"old contents that are longer than nothing").unwrap();
+
+        assert_eq!(copy_file(&from, &to).unwrap(), content.len() as u64);
+        assert_eq!(std::fs::read(&to).unwrap(), content);
+
+        std::fs::write(&from, b"").unwrap();
+        assert_eq!(copy_file(&from, &to).unwrap(), 0);
+        assert!(std::fs::read(&to).unwrap().is_empty());
+
+        assert!(copy_file(temp_path("missing"), &to).is_err());
+        assert!(copy_file(std::env::temp_dir(), &to).is_err());
+
+        std::fs::remove_file(&from).unwrap();
+        std::fs::remove_file(&to).unwrap();
+    }
+
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn test_copy_pseudo_file() {
+        let to = temp_path("copy_proc");
+        let copied = copy_file("/proc/self/stat", &to).unwrap();
+        assert!(copied > 0);
+        assert_eq!(std::fs::metadata(&to).unwrap().len(), copied);
+        std::fs::remove_file(&to).unwrap();
+    }
+
+    #[test]
+    fn test_appender_batches_in_order() {
+        let path = temp_path("append");
+        let _ = std::fs::remove_file(&path);
+
+        let appender = Appender::open(&path).unwrap();
+        let mut expected = Vec::new();
+        for i in 0..3000 {
+            let line = format!("第{}行\n", i);
+            expected.extend_from_slice(line.as_bytes());
+            appender.append(line).unwrap();
+        }
+        appender.append(vec![b'x'; APPEND_BATCH_BYTES * 2]).unwrap();
+        expected.extend(std::iter::repeat(b'x').take(APPEND_BATCH_BYTES * 2));
+        appender.flush().unwrap();
+        assert_eq!(std::fs::read(&path).unwrap(), expected);
+
+        appender.append("尾").unwrap();
+        drop(appender);
+        expected.extend_from_slice("尾".as_bytes());
+        assert_eq!(std::fs::read(&path).unwrap(), expected);
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_group_commit_from_many_threads() {
+        let path = temp_path("group_commit");
+        let _ = std::fs::remove_file(&path);
+
+        let appender = Arc::new(Appender::open(&path).unwrap());
+        let threads: Vec<_> = (0..8)
+            .map(|thread| {
+                let appender = Arc::clone(&appender);
+                std::thread::spawn(move || {
+                    for i in 0..25 {
+                        appender.append_durable(format!("{}:{}\n", thread, i)).unwrap();
+                    }
+                })
+            })
+            .collect();
+        for thread in threads {
+            thread.join().unwrap();
+        }
+        appender.sync().unwrap();
+
+        let content = std::fs::read_to_string(&path).unwrap();
+        assert_eq!(content.lines().count(), 200);
+        for thread in 0..8 {
+            let order: Vec<_> = content
+                .lines()
+                .filter_map(|line| line.strip_prefix(&format!("{}:", thread)))
+                .map(|i| i.parse::<u32>().unwrap())
+                .collect();
+            assert_eq!(order, (0..25).collect::<Vec<_>>());
+        }
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_failed_group_is_not_reported_durable() {
+        let path = temp_path("failed_group");
+        let appender = Appender::open(&path).unwrap();
+        {
+            // Group 1..=3 failed, then group 4..=5 synced
+            let mut state = appender.lock();
+            state.appended = 5;
+            state.grouped = 5;
+            state.synced = 5;
+            state.failed.push(FailedGroup {
+                first: 1,
+                last: 3,
+                kind: io::ErrorKind::Other,
+                message: "fdatasync 失败".to_string(),
+            });
+        }
+        for sequence in 1..=3 {
+            let err = appender.commit(appender.lock(), sequence, sequence).unwrap_err();
+            assert_eq!(err.to_string(), "fdatasync 失败");
+        }
+        appender.commit(appender.lock(), 4, 4).unwrap();
+        appender.commit(appender.lock(), 5, 5).unwrap();
+        assert!(appender.commit(appender.lock(), 1, 5).is_err());
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn test_durable_append_reports_write_failure() {
+        let appender = Appender::open("/dev/full").unwrap();
+        assert!(appender.append_durable("满").is_err());
+        // The dropped append stays failed instead of being reported synced
+        assert!(appender.sync().is_err());
+    }
+
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn test_sync_reports_failed_flush() {
+        let appender = Appender::open("/dev/full").unwrap();
+        appender.append("丢失").unwrap();
+        assert!(appender.flush().is_err());
+        // Nothing is pending any more, but the dropped append was never written
+        assert!(appender.sync().is_err());
+        // Already reported; nothing new has been lost since
+        appender.sync().unwrap();
+    }
+}
@@ -0,0 +1,608 @@
+//! UDP Sockets
+//!
+//! Datagram side of the network module, shaped for high packet rates.
+//! Receives fill a reusable `PacketBatch` with one `recvmmsg` call, and
+//! sends hand a whole slice of packets to one `sendmmsg` call, so a batch
+//! costs one system call instead of one per packet. The batch owns a
+//! single contiguous buffer split into fixed-size slots, plus the message
+//! headers pointing into it, and is reused across calls.
+//!
+//! Where the kernel supports it, `send_segments` uses UDP GSO
+//! (`UDP_SEGMENT`) to pass many equal-sized datagrams down the stack as
+//! one, and `enable_gro` lets the kernel coalesce received datagrams;
+//! `PacketBatch::datagrams` splits those back apart. Sockets are
+//! non-blocking and wait for readiness in `poll` in short slices, like
+//! the TCP listener. Other Unix targets fall back to one call per packet.
+
+use std::io;
+use std::net::{SocketAddr, UdpSocket as StdUdpSocket};
+use std::os::unix::io::{AsRawFd, RawFd};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::time::{Duration, Instant};
+
+use super::dns;
+use super::listener::{raw_to_socket_addr, set_int_option, socket_addr_to_raw};
+use super::{IoError, IoResult};
+
+/// Longest single wait in `poll` before re-checking for shutdown
+const POLL_SLICE_MS: i32 = 100;
+/// Most messages passed to one `sendmmsg` (the kernel's `UIO_MAXIOV`)
+const MAX_SEND_BATCH: usize = 1024;
+/// Most segments the kernel accepts in one GSO send
+const MAX_GSO_SEGMENTS: usize = 64;
+/// Largest UDP payload over IPv4
+const MAX_DATAGRAM_SIZE: usize = 65507;
+/// Slot size needed to receive a GRO-coalesced datagram
+pub const GRO_SLOT_SIZE: usize = 65535;
+
+#[cfg(target_os = "linux")]
+const UDP_SEGMENT: libc::c_int = 103;
+#[cfg(target_os = "linux")]
+const UDP_GRO: libc::c_int = 104;
+/// Ancillary space for one `int`/`u16` control message, in `u64` words
+#[cfg(target_os = "linux")]
+const CONTROL_WORDS: usize = 4;
+
+/// Reusable receive buffers for `recv_batch`
+pub struct PacketBatch {
+    slot_size: usize,
+    data: Vec<u8>,
+    lengths: Vec<usize>,
+    /// GRO segment size per packet, 0 when not coalesced
+    segment_sizes: Vec<usize>,
+    truncated: Vec<bool>,
+    addrs: Vec<libc::sockaddr_storage>,
+    len: usize,
+    #[cfg(target_os = "linux")]
+    headers: Vec<libc::mmsghdr>,
+    #[cfg(target_os = "linux")]
+    iovecs: Vec<libc::iovec>,
+    #[cfg(target_os = "linux")]
+    controls: Vec<[u64; CONTROL_WORDS]>,
+}
+
+// The raw pointers in `headers` and `iovecs` only point into this batch
+// and are rebuilt before every receive
+unsafe impl Send for PacketBatch {}
+
+impl PacketBatch {
+    /// Allocate `capacity` slots of `slot_size` bytes each
+    pub fn new(capacity: usize, slot_size: usize) -> Self {
+        let capacity = capacity.max(1);
+        let slot_size = slot_size.max(1);
+        Self {
+            slot_size,
+            data: vec![0; capacity * slot_size],
+            lengths: vec![0; capacity],
+            segment_sizes: vec![0; capacity],
+            truncated: vec![false; capacity],
+            addrs: vec![unsafe { std::mem::zeroed() }; capacity],
+            len: 0,
+            #[cfg(target_os = "linux")]
+            headers: vec![unsafe { std::mem::zeroed() }; capacity],
+            #[cfg(target_os = "linux")]
+            iovecs: vec![libc::iovec { iov_base: std::ptr::null_mut(), iov_len: 0 }; capacity],
+            #[cfg(target_os = "linux")]
+            controls: vec![[0; CONTROL_WORDS]; capacity],
+        }
+    }
+
+    /// Number of slots
+    pub fn capacity(&self) -> usize {
+        self.lengths.len()
+    }
+
+    /// Bytes per slot
+    pub fn slot_size(&self) -> usize {
+        self.slot_size
+    }
+
+    /// Packets received by the last `recv_batch`
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Check whether the last `recv_batch` received nothing
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Payload of packet `index`
+    pub fn payload(&self, index: usize) -> &[u8] {
+        let start = index * self.slot_size;
+        &self.data[start..start + self.lengths[index]]
+    }
+
+    /// Sender of packet `index`
+    pub fn peer(&self, index: usize) -> Option<SocketAddr> {
+        raw_to_socket_addr(&self.addrs[index])
+    }
+
+    /// Check whether packet `index` was cut off at the slot size
+    pub fn is_truncated(&self, index: usize) -> bool {
+        self.truncated[index]
+    }
+
+    /// Iterate over received packets as `(payload, sender)`
+    pub fn iter(&self) -> impl Iterator<Item = (&[u8], Option<SocketAddr>)> + '_ {
+        (0..self.len).map(move |index| (self.payload(index), self.peer(index)))
+    }
+
+    /// Iterate over datagrams, splitting GRO-coalesced packets
+    pub fn datagrams(&self) -> impl Iterator<Item = (&[u8], Option<SocketAddr>)> + '_ {
+        (0..self.len).flat_map(move |index| {
+            let payload = self.payload(index);
+            let peer = self.peer(index);
+            let segment = match self.segment_sizes[index] {
+                0 => payload.len().max(1),
+                size => size,
+            };
+            let empty = payload.is_empty().then_some((payload, peer));
+            payload.chunks(segment).map(move |chunk| (chunk, peer)).chain(empty)
+        })
+    }
+
+    fn clear(&mut self) {
+        self.len = 0;
+    }
+
+    fn slot_mut(&mut self, index: usize) -> &mut [u8] {
+        let start = index * self.slot_size;
+        &mut self.data[start..start + self.slot_size]
+    }
+}
+
+impl std::fmt::Debug for PacketBatch {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("PacketBatch")
+            .field("capacity", &self.capacity())
+            .field("slot_size", &self.slot_size)
+            .field("len", &self.len)
+            .finish()
+    }
+}
+
+/// Non-blocking UDP socket with batched I/O
+#[derive(Debug)]
+pub struct UdpSocket {
+    socket: StdUdpSocket,
+    local_addr: SocketAddr,
+    closed: AtomicBool,
+    /// Cleared after the kernel rejects `UDP_SEGMENT`
+    gso: AtomicBool,
+}
+
+impl UdpSocket {
+    /// Bind to `host:port`; port 0 picks a free port
+    pub fn bind(host: &str, port: u16) -> IoResult<Self> {
+        let addr = dns::resolve_socket_addr(host, port)?;
+        let socket = StdUdpSocket::bind(addr).map_err(|e| IoError::NetworkOperationFailed {
+            endpoint: addr.to_string(),
+            message: format!("绑定失败: {}", e),
+        })?;
+        socket.set_nonblocking(true)?;
+        let local_addr = socket.local_addr()?;
+        Ok(Self {
+            socket,
+            local_addr,
+            closed: AtomicBool::new(false),
+            gso: AtomicBool::new(cfg!(target_os = "linux")),
+        })
+    }
+
+    /// Address the socket is bound to
+    pub fn local_addr(&self) -> SocketAddr {
+        self.local_addr
+    }
+
+    /// Set the kernel receive and send buffer sizes
+    pub fn set_buffer_sizes(&self, receive: usize, send: usize) -> IoResult<()> {
+        set_int_option(self.fd(), libc::SOL_SOCKET, libc::SO_RCVBUF, receive as libc::c_int)?;
+        set_int_option(self.fd(), libc::SOL_SOCKET, libc::SO_SNDBUF, send as libc::c_int)?;
+        Ok(())
+    }
+
+    /// Ask the kernel to coalesce received datagrams (UDP GRO)
+    ///
+    /// Returns `false` when unsupported. Batches used with GRO need
+    /// `GRO_SLOT_SIZE` slots to hold coalesced packets.
+    pub fn enable_gro(&self) -> bool {
+        #[cfg(target_os = "linux")]
+        return set_int_option(self.fd(), libc::SOL_UDP, UDP_GRO, 1).is_ok();
+        #[cfg(not(target_os = "linux"))]
+        return false;
+    }
+
+    /// Check whether GSO sends are still being attempted
+    pub fn gso_enabled(&self) -> bool {
+        self.gso.load(Ordering::Relaxed)
+    }
+
+    /// Send one datagram
+    pub fn send_to(&self, payload: &[u8], addr: SocketAddr) -> IoResult<usize> {
+        self.retry_when_ready(libc::POLLOUT, None, || self.socket.send_to(payload, addr))
+            .map(|sent| sent.unwrap_or(0))
+    }
+
+    /// Receive one datagram; `None` on timeout or after `close`
+    pub fn recv_from(&self, buffer: &mut [u8], timeout: Option<Duration>) -> IoResult<Option<(usize, SocketAddr)>> {
+        self.retry_when_ready(libc::POLLIN, timeout, || self.socket.recv_from(buffer))
+    }
+
+    /// Send every packet, batching them into `sendmmsg` calls
+    ///
+    /// Returns the number of packets sent, which is less than
+    /// `packets.len()` only if the socket is closed while waiting.
+    pub fn send_batch(&self, packets: &[(&[u8], SocketAddr)]) -> IoResult<usize> {
+        let mut sent = 0;
+        while sent < packets.len() {
+            let chunk = &packets[sent..packets.len().min(sent + MAX_SEND_BATCH)];
+            match self.retry_when_ready(libc::POLLOUT, None, || send_mmsg(self.fd(), chunk))? {
+                Some(count) => sent += count,
+                None => break,
+            }
+        }
+        Ok(sent)
+    }
+
+    /// Receive up to `batch.capacity()` packets with one `recvmmsg` call
+    ///
+    /// Waits up to `timeout` for the first packet (`None` waits until one
+    /// arrives or the socket is closed) and then takes whatever is queued.
+    /// Returns the number of packets received, 0 on timeout.
+    pub fn recv_batch(&self, batch: &mut PacketBatch, timeout: Option<Duration>) -> IoResult<usize> {
+        batch.clear();
+        let count = self.retry_when_ready(libc::POLLIN, timeout, || recv_mmsg(self.fd(), batch))?;
+        Ok(count.unwrap_or(0))
+    }
+
+    /// Send `payload` as datagrams of `segment_size` bytes to `addr`
+    ///
+    /// Uses UDP GSO so the kernel does the splitting; falls back to
+    /// `send_batch` when the kernel rejects it. Returns the number of
+    /// datagrams sent.
+    pub fn send_segments(&self, payload: &[u8], segment_size: usize, addr: SocketAddr) -> IoResult<usize> {
+        if segment_size == 0 || segment_size > MAX_DATAGRAM_SIZE {
+            return Err(IoError::NetworkOperationFailed {
+                endpoint: addr.to_string(),
+                message: format!("分段大小无效: {}", segment_size),
+            });
+        }
+        let per_send = (MAX_DATAGRAM_SIZE / segment_size).min(MAX_GSO_SEGMENTS) * segment_size;
+        let mut datagrams = 0;
+        for group in payload.chunks(per_send) {
+            if self.gso_enabled() && group.len() > segment_size {
+                match self.retry_when_ready(libc::POLLOUT, None, || send_gso(self.fd(), group, segment_size, addr)) {
+                    Ok(Some(_)) => {
+                        datagrams += (group.len() + segment_size - 1) / segment_size;
+                        continue;
+                    }
+                    Ok(None) => return Ok(datagrams),
+                    Err(IoError::SystemIoError(e)) if is_gso_unsupported(&e) => {
+                        self.gso.store(false, Ordering::Relaxed);
+                    }
+                    Err(e) => return Err(e),
+                }
+            }
+            let packets: Vec<(&[u8], SocketAddr)> = group.chunks(segment_size).map(|chunk| (chunk, addr)).collect();
+            datagrams += self.send_batch(&packets)?;
+        }
+        Ok(datagrams)
+    }
+
+    /// Wake waiting receivers and refuse further waits
+    pub fn close(&self) {
+        if !self.closed.swap(true, Ordering::AcqRel) {
+            // Wakes pollers on Linux even for unconnected sockets
+            unsafe { libc::shutdown(self.fd(), libc::SHUT_RDWR) };
+        }
+    }
+
+    /// Check whether `close` has been called
+    pub fn is_closed(&self) -> bool {
+        self.closed.load(Ordering::Acquire)
+    }
+
+    fn fd(&self) -> RawFd {
+        self.socket.as_raw_fd()
+    }
+
+    /// Run `operation`, waiting in `poll` whenever it would block
+    ///
+    /// Returns `None` on timeout or once the socket is closed.
+    fn retry_when_ready<T>(
+        &self,
+        events: libc::c_short,
+        timeout: Option<Duration>,
+        mut operation: impl FnMut() -> io::Result<T>,
+    ) -> IoResult<Option<T>> {
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        loop {
+            if self.is_closed() {
+                return Ok(None);
+            }
+            match operation() {
+                Ok(value) => return Ok(Some(value)),
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                Err(e) if e.kind() != io::ErrorKind::WouldBlock => return Err(e.into()),
+                Err(_) => {}
+            }
+
+            let slice = match deadline {
+                Some(deadline) => match deadline.checked_duration_since(Instant::now()) {
+                    Some(remaining) if !remaining.is_zero() => {
+                        (remaining.as_millis() as i32).clamp(1, POLL_SLICE_MS)
+                    }
+                    _ => return Ok(None),
+                },
+                None => POLL_SLICE_MS,
+            };
+            let mut pollfd = libc::pollfd { fd: self.fd(), events, revents: 0 };
+            if unsafe { libc::poll(&mut pollfd, 1, slice) } < 0 {
+                let error = io::Error::last_os_error();
+                if error.kind() != io::ErrorKind::Interrupted {
+                    return Err(error.into());
+                }
+            }
+        }
+    }
+}
+
+impl Drop for UdpSocket {
+    fn drop(&mut self) {
+        self.closed.store(true, Ordering::Release);
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn send_mmsg(fd: RawFd, packets: &[(&[u8], SocketAddr)]) -> io::Result<usize> {
+    let mut addrs: Vec<(libc::sockaddr_storage, libc::socklen_t)> =
+        packets.iter().map(|(_, addr)| socket_addr_to_raw(addr)).collect();
+    let mut iovecs: Vec<libc::iovec> = packets
+        .iter()
+        .map(|(payload, _)| libc::iovec { iov_base: payload.as_ptr() as *mut _, iov_len: payload.len() })
+        .collect();
+    let mut headers: Vec<libc::mmsghdr> = addrs
+        .iter_mut()
+        .zip(iovecs.iter_mut())
+        .map(|((storage, length), iovec)| {
+            let mut header: libc::mmsghdr = unsafe { std::mem::zeroed() };
+            header.msg_hdr.msg_name = storage as *mut _ as *mut libc::c_void;
+            header.msg_hdr.msg_namelen = *length;
+            header.msg_hdr.msg_iov = iovec;
+            header.msg_hdr.msg_iovlen = 1;
+            header
+        })
+        .collect();
+
+    let sent = unsafe { libc::sendmmsg(fd, headers.as_mut_ptr(), headers.len() as libc::c_uint, 0) };
+    if sent < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(sent as usize)
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn send_mmsg(fd: RawFd, packets: &[(&[u8], SocketAddr)]) -> io::Result<usize> {
+    for (index, (payload, addr)) in packets.iter().enumerate() {
+        let (storage, length) = socket_addr_to_raw(addr);
+        let result = unsafe {
+            libc::sendto(fd, payload.as_ptr() as *const _, payload.len(), 0, &storage as *const _ as *const _, length)
+        };
+        if result < 0 {
+            let error = io::Error::last_os_error();
+            return if index == 0 { Err(error) } else { Ok(index) };
+        }
+    }
+    Ok(packets.len())
+}
+
+#[cfg(target_os = "linux")]
+fn recv_mmsg(fd: RawFd, batch: &mut PacketBatch) -> io::Result<usize> {
+    let slot_size = batch.slot_size;
+    let data = batch.data.as_mut_ptr();
+    for index in 0..batch.capacity() {
+        batch.iovecs[index] = libc::iovec {
+            iov_base: unsafe { data.add(index * slot_size) } as *mut libc::c_void,
+            iov_len: slot_size,
+        };
+        let header = &mut batch.headers[index];
+        header.msg_len = 0;
+        header.msg_hdr.msg_name = &mut batch.addrs[index] as *mut _ as *mut libc::c_void;
+        header.msg_hdr.msg_namelen = std::mem::size_of::<libc::sockaddr_storage>() as libc::socklen_t;
+        header.msg_hdr.msg_iov = &mut batch.iovecs[index];
+        header.msg_hdr.msg_iovlen = 1;
+        header.msg_hdr.msg_control = batch.controls[index].as_mut_ptr() as *mut libc::c_void;
+        header.msg_hdr.msg_controllen = std::mem::size_of::<[u64; CONTROL_WORDS]>() as _;
+        header.msg_hdr.msg_flags = 0;
+    }
+
+    let received = unsafe {
+        libc::recvmmsg(
+            fd,
+            batch.headers.as_mut_ptr(),
+            batch.capacity() as libc::c_uint,
+            libc::MSG_DONTWAIT,
+            std::ptr::null_mut(),
+        )
+    };
+    if received < 0 {
+        return Err(io::Error::last_os_error());
+    }
+
+    let received = received as usize;
+    for index in 0..received {
+        let header = &batch.headers[index];
+        batch.lengths[index] = (header.msg_len as usize).min(slot_size);
+        batch.truncated[index] = header.msg_hdr.msg_flags & libc::MSG_TRUNC != 0;
+        batch.segment_sizes[index] = gro_segment_size(&header.msg_hdr);
+    }
+    batch.len = received;
+    Ok(received)
+}
+
+#[cfg(not(target_os = "linux"))]
+fn recv_mmsg(fd: RawFd, batch: &mut PacketBatch) -> io::Result<usize> {
+    let mut received = 0;
+    while received < batch.capacity() {
+        let mut length = std::mem::size_of::<libc::sockaddr_storage>() as libc::socklen_t;
+        let slot_size = batch.slot_size;
+        let address = &mut batch.addrs[received] as *mut _ as *mut libc::sockaddr;
+        let slot = batch.slot_mut(received).as_mut_ptr();
+        let result = unsafe { libc::recvfrom(fd, slot as *mut _, slot_size, libc::MSG_DONTWAIT, address, &mut length) };
+        if result < 0 {
+            let error = io::Error::last_os_error();
+            if received == 0 {
+                return Err(error);
+            }
+            break;
+        }
+        batch.lengths[received] = (result as usize).min(slot_size);
+        batch.truncated[received] = result as usize > slot_size;
+        batch.segment_sizes[received] = 0;
+        received += 1;
+    }
+    batch.len = received;
+    Ok(received)
+}
+
+#[cfg(target_os = "linux")]
+fn gro_segment_size(header: &libc::msghdr) -> usize {
+    let mut control = unsafe { libc::CMSG_FIRSTHDR(header) };
+    while !control.is_null() {
+        let message = unsafe { &*control };
+        if message.cmsg_level == libc::SOL_UDP && message.cmsg_type == UDP_GRO {
+            let value = unsafe { std::ptr::read_unaligned(libc::CMSG_DATA(control) as *const libc::c_int) };
+            return value.max(0) as usize;
+        }
+        control = unsafe { libc::CMSG_NXTHDR(header, control) };
+    }
+    0
+}
+
+#[cfg(target_os = "linux")]
+fn send_gso(fd: RawFd, payload: &[u8], segment_size: usize, addr: SocketAddr) -> io::Result<usize> {
+    let (mut storage, length) = socket_addr_to_raw(&addr);
+    let mut iovec = libc::iovec { iov_base: payload.as_ptr() as *mut _, iov_len: payload.len() };
+    let mut control = [0u64; CONTROL_WORDS];
+
+    let mut header: libc::msghdr = unsafe { std::mem::zeroed() };
+    header.msg_name = &mut storage as *mut _ as *mut libc::c_void;
+    header.msg_namelen = length;
+    header.msg_iov = &mut iovec;
+    header.msg_iovlen = 1;
+    header.msg_control = control.as_mut_ptr() as *mut libc::c_void;
+    header.msg_controllen = unsafe { libc::CMSG_SPACE(std::mem::size_of::<u16>() as u32) } as _;
+    unsafe {
+        let message = libc::CMSG_FIRSTHDR(&header);
+        (*message).cmsg_level = libc::SOL_UDP;
+        (*message).cmsg_type = UDP_SEGMENT;
+        (*message).cmsg_len = libc::CMSG_LEN(std::mem::size_of::<u16>() as u32) as _;
+        std::ptr::write_unaligned(libc::CMSG_DATA(message) as *mut u16, segment_size as u16);
+    }
+
+    let sent = unsafe { libc::sendmsg(fd, &header, 0) };
+    if sent < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(sent as usize)
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn send_gso(_fd: RawFd, _payload: &[u8], _segment_size: usize, _addr: SocketAddr) -> io::Result<usize> {
+    Err(io::Error::from_raw_os_error(libc::EOPNOTSUPP))
+}
+
+fn is_gso_unsupported(error: &io::Error) -> bool {
+    matches!(
+        error.raw_os_error(),
+        Some(libc::EINVAL) | Some(libc::ENOPROTOOPT) | Some(libc::EOPNOTSUPP) | Some(libc::EIO)
+    )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn 本地套接字() -> UdpSocket {
+        UdpSocket::bind("127.0.0.1", 0).unwrap()
+    }
+
+    #[test]
+    fn test_send_and_receive_batches() {
+        let 接收端 = 本地套接字();
+        let 发送端 = 本地套接字();
+        let 目标 = 接收端.local_addr();
+
+        let 负载: Vec<Vec<u8>> = (0..100u8).map(|i| vec![i; i as usize + 1]).collect();
+        let 数据包: Vec<(&[u8], SocketAddr)> = 负载.iter().map(|p| (p.as_slice(), 目标)).collect();
+        assert_eq!(发送端.send_batch(&数据包).unwrap(), 100);
+
+        // The same batch is reused; 100 packets take at least two calls
+        let mut 批次 = PacketBatch::new(64, 256);
+        let mut 收到 = Vec::new();
+        while 收到.len() < 100 {
+            let 数量 = 接收端.recv_batch(&mut 批次, Some(Duration::from_secs(5))).unwrap();
+            assert!(数量 > 0 && 数量 <= 64);
+            for (内容, 来源) in 批次.iter() {
+                assert_eq!(来源, Some(发送端.local_addr()));
+                收到.push(内容.to_vec());
+            }
+        }
+        assert_eq!(收到, 负载);
+
+        // Nothing queued: times out with an empty batch
+        assert_eq!(接收端.recv_batch(&mut 批次, Some(Duration::from_millis(20))).unwrap(), 0);
+        assert!(批次.is_empty());
+
+        // Packets larger than a slot are cut off and flagged
+        发送端.send_to(&[9u8; 300], 目标).unwrap();
+        接收端.recv_batch(&mut 批次, Some(Duration::from_secs(5))).unwrap();
+        assert_eq!(批次.payload(0).len(), 256);
+        assert!(批次.is_truncated(0));
+    }
+
+    #[test]
+    fn test_segmented_send_and_gro() {
+        let 接收端 = 本地套接字();
+        let 发送端 = 本地套接字();
+        let 目标 = 接收端.local_addr();
+
+        // 150 segments of 100 bytes; the last one is short
+        let gro = 接收端.enable_gro();
+        let 负载: Vec<u8> = (0..14_990u32).map(|i| (i / 100) as u8).collect();
+        assert_eq!(发送端.send_segments(&负载, 100, 目标).unwrap(), 150);
+
+        let mut 批次 = PacketBatch::new(64, if gro { GRO_SLOT_SIZE } else { 2048 });
+        let mut 收到: Vec<u8> = Vec::new();
+        let mut 数据报 = 0;
+        while 数据报 < 150 {
+            assert!(接收端.recv_batch(&mut 批次, Some(Duration::from_secs(5))).unwrap() > 0);
+            for (内容, _) in 批次.datagrams() {
+                assert!(内容.len() == 100 || (数据报 == 149 && 内容.len() == 90));
+                收到.extend_from_slice(内容);
+                数据报 += 1;
+            }
+        }
+        assert_eq!(收到, 负载);
+        assert!(发送端.send_segments(&负载, 0, 目标).is_err());
+    }
+
+    #[test]
+    fn test_close_wakes_receiver() {
+        let 套接字 = std::sync::Arc::new(本地套接字());
+        let 副本 = std::sync::Arc::clone(&套接字);
+        let 接收者 = std::thread::spawn(move || {
+            let mut 缓冲区 = [0u8; 16];
+            副本.recv_from(&mut 缓冲区, None).unwrap()
+        });
+        std::thread::sleep(Duration::from_millis(20));
+        套接字.close();
+        assert!(接收者.join().unwrap().is_none());
+
+        let mut 批次 = PacketBatch::new(4, 16);
+        assert_eq!(套接字.recv_batch(&mut 批次, None).unwrap(), 0);
+    }
+}
@@ -0,0 +1,554 @@
+//! Parallel Directory Walker
+//!
+//! Recursive directory traversal. `walk` runs its workers on the runtime's
+//! data-parallel pool; `walk_channel` runs them on threads of its own, since
+//! its producers block whenever the reader falls behind and must not hold
+//! pool threads. Directories are queued on a shared work list and read by
+//! whichever worker is free; a worker only waits for work while another one
+//! is reading a directory, so the walk finishes even when the pool runs
+//! workers one after another (nested in a busy pool). On Linux each directory is read
+//! with `getdents64` into a reused buffer and entry kinds come from
+//! `d_type`, so a walk issues no `stat` calls except on filesystems that
+//! report `DT_UNKNOWN`.
+//!
+//! Results can be collected, or streamed through a bounded channel while
+//! the walk is still running. Include and exclude globs are matched against
+//! paths relative to the root; an excluded directory is not descended into.
+
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver};
+use std::sync::{Condvar, Mutex};
+
+use glob::{MatchOptions, Pattern};
+
+use super::{IoError, IoResult};
+use crate::runtime::async_runtime::pool::parallel_for;
+use crate::runtime::async_runtime::PoolConfig;
+
+/// Entries buffered in a streaming walk before workers wait for the reader
+pub const WALK_CHANNEL_CAPACITY: usize = 4096;
+
+/// Kind of a directory entry, as reported by the directory listing
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum EntryKind {
+    File,
+    Directory,
+    Symlink,
+    Other,
+}
+
+/// One entry found by the walker
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct WalkEntry {
+    /// Full path (root joined with the relative path)
+    pub path: PathBuf,
+    /// Entry kind; symlinks are reported, never followed
+    pub kind: EntryKind,
+    /// 1 for direct children of the root
+    pub depth: usize,
+}
+
+/// Walk configuration
+#[derive(Debug, Clone)]
+pub struct WalkOptions {
+    max_depth: Option<usize>,
+    include: Vec<Pattern>,
+    exclude: Vec<Pattern>,
+    include_directories: bool,
+    threads: usize,
+}
+
+impl Default for WalkOptions {
+    fn default() -> Self {
+        Self {
+            max_depth: None,
+            include: Vec::new(),
+            exclude: Vec::new(),
+            include_directories: false,
+            threads: PoolConfig::default().worker_count.max(1),
+        }
+    }
+}
+
+impl WalkOptions {
+    /// Report files only, at any depth, on every worker
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Do not report entries deeper than `depth` (1 lists the root only)
+    pub fn with_max_depth(mut self, depth: usize) -> Self {
+        self.max_depth = Some(depth);
+        self
+    }
+
+    /// Only report entries whose relative path matches one of the include globs
+    pub fn with_include(mut self, glob: &str) -> IoResult<Self> {
+        self.include.push(parse_glob(glob)?);
+        Ok(self)
+    }
+
+    /// Skip entries matching `glob`, and do not descend into matching directories
+    pub fn with_exclude(mut self, glob: &str) -> IoResult<Self> {
+        self.exclude.push(parse_glob(glob)?);
+        Ok(self)
+    }
+
+    /// Also report directories, not just files and other entries
+    pub fn with_directories(mut self, include_directories: bool) -> Self {
+        self.include_directories = include_directories;
+        self
+    }
+
+    /// Maximum number of workers; the pool size caps how many run at once
+    pub fn with_threads(mut self, threads: usize) -> Self {
+        self.threads = threads.max(1);
+        self
+    }
+
+    fn is_excluded(&self, relative: &Path) -> bool {
+        self.exclude.iter().any(|pattern| pattern.matches_path_with(relative, glob_options()))
+    }
+
+    fn is_included(&self, relative: &Path) -> bool {
+        self.include.is_empty()
+            || self.include.iter().any(|pattern| pattern.matches_path_with(relative, glob_options()))
+    }
+}
+
+fn parse_glob(glob: &str) -> IoResult<Pattern> {
+    Pattern::new(glob).map_err(|e| IoError::EncodingError {
+        message: format!("无效的通配符模式 '{}': {}", glob, e),
+    })
+}
+
+/// `*` stays within one path component; `**` crosses directories
+fn glob_options() -> MatchOptions {
+    MatchOptions {
+        case_sensitive: true,
+        require_literal_separator: true,
+        require_literal_leading_dot: false,
+    }
+}
+
+/// Walk `root` and return every matching entry, sorted by path
+///
+/// Only an unreadable root is an error. A subdirectory that cannot be read
+/// (permission denied, removed mid-walk) is skipped and the rest of the tree
+/// is still returned; use `walk_channel` to see those errors.
+pub fn walk(root: impl AsRef<Path>, options: &WalkOptions) -> IoResult<Vec<WalkEntry>> {
+    let root = root.as_ref();
+    let root_directory = directory_path(root, Path::new(""));
+    let entries = Mutex::new(Vec::new());
+    let root_error = Mutex::new(None);
+    walk_with(root, options, Workers::Pool, &|result| {
+        match result {
+            Ok(entry) => entries.lock().unwrap().push(entry),
+            Err(error) => {
+                if let IoError::FileOperationFailed { path, .. } = &error {
+                    if Path::new(path) == root_directory {
+                        *root_error.lock().unwrap() = Some(error);
+                    }
+                }
+            }
+        }
+        true
+    });
+
+    if let Some(e) = root_error.into_inner().unwrap() {
+        return Err(e);
+    }
+    let mut entries = entries.into_inner().unwrap();
+    entries.sort_unstable_by(|a, b| a.path.cmp(&b.path));
+    Ok(entries)
+}
+
+/// Walk `root` on background threads, streaming entries as they are found
+///
+/// Entries arrive in no particular order. Errors for unreadable
+/// directories are sent in-line and the walk continues; dropping the
+/// receiver stops the walk.
+pub fn walk_channel(root: impl AsRef<Path>, options: WalkOptions) -> Receiver<IoResult<WalkEntry>> {
+    let (sender, receiver) = mpsc::sync_channel(WALK_CHANNEL_CAPACITY);
+    let root = root.as_ref().to_path_buf();
+    std::thread::spawn(move || {
+        walk_with(&root, &options, Workers::Threads, &|result| sender.send(result).is_ok());
+    });
+    receiver
+}
+
+/// Directories waiting to be read, and how many workers are reading one
+struct WorkQueue {
+    directories: Vec<(PathBuf, usize)>,
+    active: usize,
+}
+
+/// Where `walk_with` runs its workers
+#[derive(Clone, Copy)]
+enum Workers {
+    /// Up to `options.threads` jobs on the data-parallel pool
+    Pool,
+    /// `options.threads` scoped threads, for sinks that may block
+    Threads,
+}
+
+/// Run the walk on `options.threads` workers
+///
+/// `sink` receives every entry and error; returning `false` stops the walk.
+fn walk_with(root: &Path, options: &WalkOptions, workers: Workers, sink: &(dyn Fn(IoResult<WalkEntry>) -> bool + Sync)) {
+    let queue = Mutex::new(WorkQueue { directories: vec![(PathBuf::new(), 0)], active: 0 });
+    let ready = Condvar::new();
+    let stopped = AtomicBool::new(false);
+
+    let worker = || {
+        let mut reader = DirectoryReader::new();
+        let mut subdirectories = Vec::new();
+        loop {
+            let (relative, depth) = {
+                let mut state = queue.lock().unwrap();
+                loop {
+                    if stopped.load(Ordering::Relaxed) {
+                        return;
+                    }
+                    if let Some(next) = state.directories.pop() {
+                        state.active += 1;
+                        break next;
+                    }
+                    if state.active == 0 {
+                        ready.notify_all();
+                        return;
+                    }
+                    state = ready.wait(state).unwrap();
+                }
+            };
+
+            let directory = directory_path(root, &relative);
+            let result = reader.read(&directory, |name, kind| {
+                let child = relative.join(name);
+                if options.is_excluded(&child) {
+                    return true;
+                }
+                let child_depth = depth + 1;
+                if kind == EntryKind::Directory
+                    && options.max_depth.map_or(true, |max| child_depth < max)
+                {
+                    subdirectories.push((child.clone(), child_depth));
+                }
+                if (kind != EntryKind::Directory || options.include_directories) && options.is_included(&child) {
+                    let entry = WalkEntry { path: root.join(&child), kind, depth: child_depth };
+                    if !sink(Ok(entry)) {
+                        stopped.store(true, Ordering::Relaxed);
+                        return false;
+                    }
+                }
+                true
+            });
+            if let Err(e) = result {
+                if !sink(Err(IoError::FileOperationFailed {
+                    path: directory.to_string_lossy().to_string(),
+                    message: format!("读取目录失败: {}", e),
+                })) {
+                    stopped.store(true, Ordering::Relaxed);
+                }
+            }
+
+            let mut state = queue.lock().unwrap();
+            state.active -= 1;
+            let found = subdirectories.len();
+            state.directories.append(&mut subdirectories);
+            if found > 1 {
+                ready.notify_all();
+            } else if found == 1 || state.active == 0 {
+                ready.notify_one();
+            }
+            if stopped.load(Ordering::Relaxed) {
+                ready.notify_all();
+            }
+        }
+    };
+
+    if options.max_depth == Some(0) {
+        return;
+    }
+    match workers {
+        Workers::Pool => parallel_for(options.threads, |_| worker()),
+        Workers::Threads => std::thread::scope(|scope| {
+            for _ in 1..options.threads {
+                scope.spawn(&worker);
+            }
+            worker();
+        }),
+    }
+}
+
+/// Path of the directory at `relative` under `root`, as used in walk errors
+fn directory_path(root: &Path, relative: &Path) -> PathBuf {
+    root.join(relative)
+}
+
+/// Directory listing with a reusable buffer
+struct DirectoryReader {
+    #[cfg(target_os = "linux")]
+    buffer: Vec<u8>,
+}
+
+impl DirectoryReader {
+    fn new() -> Self {
+        Self {
+            #[cfg(target_os = "linux")]
+            buffer: vec![0; 64 * 1024],
+        }
+    }
+
+    /// Call `visit` for every entry except `.` and `..`; stop when it returns `false`
+    #[cfg(target_os = "linux")]
+    fn read(
+        &mut self,
+        directory: &Path,
+        mut visit: impl FnMut(&std::ffi::OsStr, EntryKind) -> bool,
+    ) -> std::io::Result<()> {
+        use std::ffi::{CString, OsStr};
+        use std::os::unix::ffi::OsStrExt;
+
+        let path = CString::new(directory.as_os_str().as_bytes())
+            .map_err(|_| std::io::Error::from(std::io::ErrorKind::InvalidInput))?;
+        let fd = unsafe {
+            libc::open(path.as_ptr(), libc::O_RDONLY | libc::O_DIRECTORY | libc::O_CLOEXEC)
+        };
+        if fd < 0 {
+            return Err(std::io::Error::last_os_error());
+        }
+        let _guard = FdGuard(fd);
+
+        loop {
+            let read = unsafe {
+                libc::syscall(libc::SYS_getdents64, fd, self.buffer.as_mut_ptr(), self.buffer.len())
+            };
+            if read < 0 {
+                let err = std::io::Error::last_os_error();
+                if err.kind() == std::io::ErrorKind::Interrupted {
+                    continue;
+                }
+                return Err(err);
+            }
+            if read == 0 {
+                return Ok(());
+            }
+
+            // struct linux_dirent64 { u64 d_ino; i64 d_off; u16 d_reclen; u8 d_type; char d_name[]; }
+            let mut offset = 0;
+            while offset < read as usize {
+                let record = &self.buffer[offset..];
+                let length = u16::from_ne_bytes([record[16], record[17]]) as usize;
+                let d_type = record[18];
+                let name_bytes = &record[19..length];
+                let name_end = name_bytes.iter().position(|&b| b == 0).unwrap_or(name_bytes.len());
+                let name = OsStr::from_bytes(&name_bytes[..name_end]);
+                offset += length;
+
+                if name == "." || name == ".." {
+                    continue;
+                }
+                let kind = match d_type {
+                    libc::DT_REG => EntryKind::File,
+                    libc::DT_DIR => EntryKind::Directory,
+                    libc::DT_LNK => EntryKind::Symlink,
+                    libc::DT_UNKNOWN => stat_kind(fd, name),
+                    _ => EntryKind::Other,
+                };
+                if !visit(name, kind) {
+                    return Ok(());
+                }
+            }
+        }
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    fn read(
+        &mut self,
+        directory: &Path,
+        mut visit: impl FnMut(&std::ffi::OsStr, EntryKind) -> bool,
+    ) -> std::io::Result<()> {
+        for entry in std::fs::read_dir(directory)? {
+            let entry = entry?;
+            let file_type = entry.file_type()?;
+            let kind = if file_type.is_symlink() {
+                EntryKind::Symlink
+            } else if file_type.is_dir() {
+                EntryKind::Directory
+            } else if file_type.is_file() {
+                EntryKind::File
+            } else {
+                EntryKind::Other
+            };
+            if !visit(&entry.file_name(), kind) {
+                break;
+            }
+        }
+        Ok(())
+    }
+}
+
+#[cfg(target_os = "linux")]
+struct FdGuard(libc::c_int);
+
+#[cfg(target_os = "linux")]
+impl Drop for FdGuard {
+    fn drop(&mut self) {
+        unsafe { libc::close(self.0) };
+    }
+}
+
+/// Entry kind for filesystems that do not fill in `d_type`
+#[cfg(target_os = "linux")]
+fn stat_kind(directory_fd: libc::c_int, name: &std::ffi::OsStr) -> EntryKind {
+    use std::os::unix::ffi::OsStrExt;
+
+    let Ok(name) = std::ffi::CString::new(name.as_bytes()) else {
+        return EntryKind::Other;
+    };
+    let mut stat: libc::stat = unsafe { std::mem::zeroed() };
+    if unsafe { libc::fstatat(directory_fd, name.as_ptr(), &mut stat, libc::AT_SYMLINK_NOFOLLOW) } != 0 {
+        return EntryKind::Other;
+    }
+    match stat.st_mode & libc::S_IFMT {
+        libc::S_IFREG => EntryKind::File,
+        libc::S_IFDIR => EntryKind::Directory,
+        libc::S_IFLNK => EntryKind::Symlink,
+        _ => EntryKind::Other,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn make_tree(name: &str) -> PathBuf {
+        let root = std::env::temp_dir().join(format!("qi_walker_{}_{}", name, std::process::id()));
+        let _ = std::fs::remove_dir_all(&root);
+        for directory in ["src/lexer", "src/parser", "target/debug", "docs"] {
+            std::fs::create_dir_all(root.join(directory)).unwrap();
+        }
+        for file in [
+            "Cargo.toml",
+            "src/main.rs",
+            "src/lexer/mod.rs",
+            "src/lexer/tokens.rs",
+            "src/parser/mod.rs",
+            "target/debug/qi",
+            "docs/说明.md",
+        ] {
+            std::fs::write(root.join(file), file).unwrap();
+        }
+        root
+    }
+
+    fn relative_paths(root: &Path, entries: &[WalkEntry]) -> Vec<String> {
+        entries
+            .iter()
+            .map(|entry| entry.path.strip_prefix(root).unwrap().to_string_lossy().replace('\\', "/"))
+            .collect()
+    }
+
+    #[test]
+    fn test_walk_all_files() {
+        let root = make_tree("all");
+        let entries = walk(&root, &WalkOptions::new().with_threads(4)).unwrap();
+        assert_eq!(
+            relative_paths(&root, &entries),
+            vec![
+                "Cargo.toml",
+                "docs/说明.md",
+                "src/lexer/mod.rs",
+                "src/lexer/tokens.rs",
+                "src/main.rs",
+                "src/parser/mod.rs",
+                "target/debug/qi",
+            ]
+        );
+        assert!(entries.iter().all(|entry| entry.kind == EntryKind::File));
+        std::fs::remove_dir_all(&root).unwrap();
+    }
+
+    #[test]
+    fn test_walk_globs_and_depth() {
+        let root = make_tree("filters");
+
+        let options = WalkOptions::new()
+            .with_include("**/*.rs")
+            .unwrap()
+            .with_exclude("src/parser")
+            .unwrap();
+        let entries = walk(&root, &options).unwrap();
+        assert_eq!(
+            relative_paths(&root, &entries),
+            vec!["src/lexer/mod.rs", "src/lexer/tokens.rs", "src/main.rs"]
+        );
+
+        let options = WalkOptions::new().with_max_depth(2).with_directories(true);
+        let entries = walk(&root, &options).unwrap();
+        assert_eq!(
+            relative_paths(&root, &entries),
+            vec![
+                "Cargo.toml",
+                "docs",
+                "docs/说明.md",
+                "src",
+                "src/lexer",
+                "src/main.rs",
+                "src/parser",
+                "target",
+                "target/debug",
+            ]
+        );
+        assert!(entries.iter().all(|entry| entry.depth <= 2));
+
+        assert!(WalkOptions::new().with_include("[").is_err());
+        std::fs::remove_dir_all(&root).unwrap();
+    }
+
+    #[test]
+    #[cfg(unix)]
+    fn test_walk_skips_unreadable_directories() {
+        use std::os::unix::fs::PermissionsExt;
+
+        let root = make_tree("unreadable");
+        let locked = root.join("src/parser");
+        std::fs::set_permissions(&locked, std::fs::Permissions::from_mode(0o000)).unwrap();
+
+        // Privileged users can read the directory anyway
+        if std::fs::read_dir(&locked).is_err() {
+            let entries = walk(&root, &WalkOptions::new().with_threads(4)).unwrap();
+            let paths = relative_paths(&root, &entries);
+            assert!(paths.contains(&"src/lexer/tokens.rs".to_string()));
+            assert!(!paths.contains(&"src/parser/mod.rs".to_string()));
+            assert_eq!(paths.len(), 6);
+
+            let errors = walk_channel(&root, WalkOptions::new()).iter().filter(|result| result.is_err()).count();
+            assert_eq!(errors, 1);
+        }
+
+        assert!(walk(root.join("missing"), &WalkOptions::new()).is_err());
+        std::fs::set_permissions(&locked, std::fs::Permissions::from_mode(0o755)).unwrap();
+        std::fs::remove_dir_all(&root).unwrap();
+    }
+
+    #[test]
+    fn test_walk_channel_streams_and_reports_errors() {
+        let root = make_tree("channel");
+        let received: Vec<_> = walk_channel(&root, WalkOptions::new().with_exclude("target").unwrap()).iter().collect();
+        assert_eq!(received.len(), 6);
+        assert!(received.iter().all(|result| result.is_ok()));
+
+        let missing = walk_channel(root.join("missing"), WalkOptions::new());
+        assert!(missing.recv().unwrap().is_err());
+        assert!(missing.recv().is_err());
+
+        // Dropping the receiver early must not hang the walkers
+        let early = walk_channel(&root, WalkOptions::new());
+        drop(early);
+
+        std::fs::remove_dir_all(&root).unwrap();
+    }
+}
@@ -5,6 +5,9 @@
 
 use std::collections::HashMap;
 use crate::runtime::{RuntimeResult, RuntimeError};
+use super::number_format::{
+    format_float, format_int, parse_float_ascii, parse_int_ascii, FLOAT_BUFFER_SIZE, INT_BUFFER_SIZE,
+};
 
 /// Conversion configuration
 #[derive(Debug, Clone)]
@@ -104,8 +107,13 @@ impl ConversionModule {
             }
         }
 
-        // Try Chinese number conversion first if enabled
-        if self.config.chinese_formatting {
+        // Plain ASCII decimal is by far the common case
+        if let Some(value) = parse_int_ascii(processed_input.as_bytes()) {
+            return Ok(value);
+        }
+
+        // Chinese numerals only need to be tried when non-ASCII characters appear
+        if self.config.chinese_formatting && !processed_input.is_ascii() {
             if let Ok(chinese_result) = self.chinese_to_int(processed_input) {
                 return Ok(chinese_result);
             }
@@ -127,7 +135,8 @@ impl ConversionModule {
         if self.config.chinese_formatting {
             Ok(self.int_to_chinese(value))
         } else {
-            Ok(value.to_string())
+            let mut buffer = [0u8; INT_BUFFER_SIZE];
+            Ok(format_int(value, &mut buffer).to_string())
         }
     }
 
@@ -147,8 +156,11 @@ impl ConversionModule {
             }
         }
 
-        // Try Chinese number conversion first if enabled
-        if self.config.chinese_formatting {
+        if processed_input.is_ascii() {
+            if let Some(value) = parse_float_ascii(processed_input.as_bytes()) {
+                return Ok(value);
+            }
+        } else if self.config.chinese_formatting {
             if let Ok(chinese_result) = self.chinese_to_float(processed_input) {
                 return Ok(chinese_result);
             }
@@ -170,7 +182,8 @@ impl ConversionModule {
         if self.config.chinese_formatting {
             Ok(self.float_to_chinese(value))
         } else {
-            Ok(value.to_string())
+            let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+            Ok(format_float(value, &mut buffer).to_string())
         }
     }
 
@@ -600,6 +613,21 @@ mod tests {
         assert_eq!(conversion.bool_to_string(false).unwrap(), "假");
     }
 
+    #[test]
+    fn test_ascii_fast_path_with_chinese_fallback() {
+        let mut conversion = ConversionModule::new();
+        conversion.set_chinese_formatting(true);
+
+        // ASCII digits never reach the Chinese numeral parser
+        assert_eq!(conversion.string_to_int(" 42 ").unwrap(), 42);
+        assert_eq!(conversion.string_to_float("2.5").unwrap(), 2.5);
+
+        // Non-ASCII input falls back to Chinese numerals
+        assert_eq!(conversion.string_to_int("三十").unwrap(), 30);
+        assert_eq!(conversion.string_to_float("二十").unwrap(), 20.0);
+        assert!(conversion.string_to_int("12x").is_err());
+    }
+
     #[test]
     fn test_base_conversions() {
         let conversion = ConversionModule::new();
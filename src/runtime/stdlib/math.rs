@@ -5,6 +5,7 @@
 
 use std::collections::HashMap;
 use crate::runtime::{RuntimeResult, RuntimeError};
+use super::vector_math;
 
 /// Mathematical operation configuration
 #[derive(Debug, Clone)]
@@ -411,6 +412,44 @@ impl MathModule {
         Ok(value.clamp(min, max))
     }
 
+    /// Sum a whole array; bounds are checked once on the result
+    pub fn sum_array(&self, values: &[f64]) -> RuntimeResult<f64> {
+        let result = vector_math::sum_f64(values);
+        self.check_bounds(result)?;
+
+        Ok(self.round_to_precision(result))
+    }
+
+    /// Mean of a whole array
+    pub fn mean_array(&self, values: &[f64]) -> RuntimeResult<f64> {
+        let result = vector_math::mean_f64(values)
+            .ok_or_else(|| RuntimeError::internal_error("空数组没有平均值", "空数组没有平均值"))?;
+        self.check_bounds(result)?;
+
+        Ok(self.round_to_precision(result))
+    }
+
+    /// Population variance of a whole array
+    pub fn variance_array(&self, values: &[f64]) -> RuntimeResult<f64> {
+        let result = vector_math::variance_f64(values)
+            .ok_or_else(|| RuntimeError::internal_error("空数组没有方差", "空数组没有方差"))?;
+        self.check_bounds(result)?;
+
+        Ok(self.round_to_precision(result))
+    }
+
+    /// Dot product of two arrays of equal length
+    pub fn dot_product(&self, a: &[f64], b: &[f64]) -> RuntimeResult<f64> {
+        if a.len() != b.len() {
+            return Err(RuntimeError::internal_error("点积数组长度不一致", "点积数组长度不一致"));
+        }
+
+        let result = vector_math::dot_f64(a, b);
+        self.check_bounds(result)?;
+
+        Ok(self.round_to_precision(result))
+    }
+
     /// Check if value is finite
     pub fn is_finite(&self, value: f64) -> bool {
         value.is_finite()
@@ -791,4 +830,18 @@ mod tests {
         let diff_from_full_precision = (result - 0.333333).abs();
         assert!(diff_from_full_precision > 0.001);
     }
-}
\ No newline at end of file
+
+    #[test]
+    fn test_array_operations() {
+        let math = MathModule::new();
+        let values = [1.0, 2.0, 3.0, 4.0];
+
+        assert_eq!(math.sum_array(&values).unwrap(), 10.0);
+        assert_eq!(math.mean_array(&values).unwrap(), 2.5);
+        assert_eq!(math.variance_array(&values).unwrap(), 1.25);
+        assert_eq!(math.dot_product(&values, &values).unwrap(), 30.0);
+
+        assert!(math.mean_array(&[]).is_err());
+        assert!(math.dot_product(&values, &values[..2]).is_err());
+    }
+}
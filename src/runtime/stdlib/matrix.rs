@@ -0,0 +1,410 @@
+//! 矩阵模块
+//!
+//! 提供行优先存储的稠密浮点矩阵 `矩阵`，以及矩阵乘法 (GEMM)、矩阵向量乘积
+//! 和转置。矩阵乘法采用缓存分块 + 寄存器分块：B 按 KC×NC 面板打包、A 按
+//! MC×KC 块打包，再由 MR×NR 微内核累加；微内核在运行时按 CPU 特性选择
+//! AVX2/FMA 版本或标量版本。较大的乘法按 C 的行带拆分到运行时的数据并行线程池执行。
+
+use super::{StdlibError, StdlibResult};
+use super::vector_math::{self, SimdLevel, PARALLEL_THRESHOLD};
+use crate::runtime::async_runtime::pool::parallel_for_each_row_band_mut;
+
+/// 微内核行数（A 的寄存器分块高度）
+const MR: usize = 6;
+/// 微内核列数（B 的寄存器分块宽度，两个 256 位寄存器）
+const NR: usize = 8;
+/// 打包面板的公共维度深度，使 A/B 条带驻留在 L1/L2
+const KC: usize = 256;
+/// 每次打包的 A 块行数（MR 的倍数，约占 L2 一半）
+const MC: usize = 72;
+/// 每次打包的 B 面板列数（NR 的倍数，约占 L3 的一部分）
+const NC: usize = 4080;
+/// 乘加次数 (m·n·k) 超过该值时并行计算
+const PARALLEL_MIN_FLOPS: usize = 1 << 22;
+/// 转置时使用的方块边长
+const TRANSPOSE_BLOCK: usize = 32;
+
+/// 微内核签名: (kc, 打包A, 打包B, C 起点, ldc, 有效行数, 有效列数)
+type MicroKernel = unsafe fn(usize, *const f64, *const f64, *mut f64, usize, usize, usize);
+
+/// 行优先稠密浮点矩阵
+#[derive(Debug, Clone, PartialEq)]
+pub struct 矩阵 {
+    行数: usize,
+    列数: usize,
+    数据: Vec<f64>,
+}
+
+impl 矩阵 {
+    /// 创建全零矩阵
+    pub fn 零矩阵(行数: usize, 列数: usize) -> Self {
+        Self { 行数, 列数, 数据: vec![0.0; 行数 * 列数] }
+    }
+
+    /// 创建单位矩阵
+    pub fn 单位矩阵(阶数: usize) -> Self {
+        let mut 结果 = Self::零矩阵(阶数, 阶数);
+        for i in 0..阶数 {
+            结果.数据[i * 阶数 + i] = 1.0;
+        }
+        结果
+    }
+
+    /// 从行优先数据创建矩阵
+    pub fn 从数据(行数: usize, 列数: usize, 数据: Vec<f64>) -> StdlibResult<Self> {
+        if 数据.len() != 行数 * 列数 {
+            return Err(维度错误("创建矩阵", format!(
+                "数据长度 {} 与 {}x{} 不匹配", 数据.len(), 行数, 列数
+            )));
+        }
+        Ok(Self { 行数, 列数, 数据 })
+    }
+
+    /// 行数
+    pub fn 行数(&self) -> usize {
+        self.行数
+    }
+
+    /// 列数
+    pub fn 列数(&self) -> usize {
+        self.列数
+    }
+
+    /// 行优先数据
+    pub fn 数据(&self) -> &[f64] {
+        &self.数据
+    }
+
+    /// 读取元素
+    pub fn 获取(&self, 行: usize, 列: usize) -> Option<f64> {
+        if 行 < self.行数 && 列 < self.列数 {
+            Some(self.数据[行 * self.列数 + 列])
+        } else {
+            None
+        }
+    }
+
+    /// 写入元素
+    pub fn 设置(&mut self, 行: usize, 列: usize, 值: f64) -> StdlibResult<()> {
+        if 行 >= self.行数 || 列 >= self.列数 {
+            return Err(维度错误("设置元素", format!(
+                "位置 ({}, {}) 超出 {}x{}", 行, 列, self.行数, self.列数
+            )));
+        }
+        self.数据[行 * self.列数 + 列] = 值;
+        Ok(())
+    }
+
+    /// 矩阵乘法 self · 右
+    pub fn 乘法(&self, 右: &矩阵) -> StdlibResult<矩阵> {
+        self.检查乘法维度(右)?;
+        let mut 结果 = Self::零矩阵(self.行数, 右.列数);
+        gemm(self.行数, 右.列数, self.列数, &self.数据, &右.数据, &mut 结果.数据);
+        Ok(结果)
+    }
+
+    /// 三重循环的朴素乘法，作为正确性与性能基准
+    pub fn 朴素乘法(&self, 右: &矩阵) -> StdlibResult<矩阵> {
+        self.检查乘法维度(右)?;
+        let (m, n, k) = (self.行数, 右.列数, self.列数);
+        let mut 结果 = Self::零矩阵(m, n);
+        for i in 0..m {
+            for j in 0..n {
+                let mut 和 = 0.0;
+                for p in 0..k {
+                    和 += self.数据[i * k + p] * 右.数据[p * n + j];
+                }
+                结果.数据[i * n + j] = 和;
+            }
+        }
+        Ok(结果)
+    }
+
+    /// 矩阵向量乘积 self · 向量
+    pub fn 矩阵向量乘(&self, 向量: &[f64]) -> StdlibResult<Vec<f64>> {
+        if 向量.len() != self.列数 {
+            return Err(维度错误("矩阵向量乘", format!(
+                "{}x{} 矩阵不能乘以长度 {} 的向量", self.行数, self.列数, 向量.len()
+            )));
+        }
+        let mut 结果 = vec![0.0; self.行数];
+        gemv(self.行数, self.列数, &self.数据, 向量, &mut 结果);
+        Ok(结果)
+    }
+
+    /// 转置
+    pub fn 转置(&self) -> 矩阵 {
+        let mut 结果 = Self::零矩阵(self.列数, self.行数);
+        transpose(self.行数, self.列数, &self.数据, &mut 结果.数据);
+        结果
+    }
+
+    fn 检查乘法维度(&self, 右: &矩阵) -> StdlibResult<()> {
+        if self.列数 != 右.行数 {
+            return Err(维度错误("矩阵乘法", format!(
+                "{}x{} 与 {}x{} 维度不匹配", self.行数, self.列数, 右.行数, 右.列数
+            )));
+        }
+        Ok(())
+    }
+}
+
+fn 维度错误(操作: &str, 消息: String) -> StdlibError {
+    StdlibError::MathError {
+        operation: 操作.to_string(),
+        message: 消息,
+    }
+}
+
+/// 计算 C += A·B，三者均为行优先连续存储
+///
+/// A 为 m×k，B 为 k×n，C 为 m×n。
+pub fn gemm(m: usize, n: usize, k: usize, a: &[f64], b: &[f64], c: &mut [f64]) {
+    assert!(a.len() >= m * k && b.len() >= k * n && c.len() >= m * n, "矩阵缓冲区长度不足");
+    if m == 0 || n == 0 || k == 0 {
+        return;
+    }
+
+    let kernel = select_kernel();
+    let parallel = m.saturating_mul(n).saturating_mul(k) >= PARALLEL_MIN_FLOPS && m >= 2 * MC;
+    let c = &mut c[..m * n];
+
+    // 每个行带在一个工作线程上走完全部 KC×NC 面板，A/B 打包缓冲区只分配一次；
+    // B 面板由各行带各自打包，省去面板之间的同步
+    let band = |first_row: usize, c_band: &mut [f64]| {
+        let rows = c_band.len() / n;
+        let mut packed_a = vec![0.0; round_up(MC.min(rows), MR) * KC.min(k)];
+        let mut packed_b = vec![0.0; KC.min(k) * round_up(NC.min(n), NR)];
+        for jc in (0..n).step_by(NC) {
+            let nc = NC.min(n - jc);
+            for pc in (0..k).step_by(KC) {
+                let kc = KC.min(k - pc);
+                pack_b(b, n, pc, jc, kc, nc, &mut packed_b);
+                for ic in (0..rows).step_by(MC) {
+                    let mc = MC.min(rows - ic);
+                    pack_a(a, k, first_row + ic, pc, mc, kc, &mut packed_a);
+                    macro_kernel(kernel, mc, nc, kc, &packed_a, &packed_b, &mut c_band[ic * n + jc..], n);
+                }
+            }
+        }
+    };
+
+    if parallel {
+        parallel_for_each_row_band_mut(c, n, MC, band);
+    } else {
+        band(0, c);
+    }
+}
+
+/// 计算 y = A·x，A 为 rows×cols 行优先
+pub fn gemv(rows: usize, cols: usize, a: &[f64], x: &[f64], y: &mut [f64]) {
+    assert!(a.len() >= rows * cols && x.len() >= cols && y.len() >= rows, "矩阵缓冲区长度不足");
+    let y = &mut y[..rows];
+    let band = |first_row: usize, out: &mut [f64]| {
+        for (offset, value) in out.iter_mut().enumerate() {
+            let row = (first_row + offset) * cols;
+            *value = vector_math::dot_f64(&a[row..row + cols], &x[..cols]);
+        }
+    };
+
+    if rows.saturating_mul(cols) >= PARALLEL_THRESHOLD {
+        let min_rows = (PARALLEL_THRESHOLD / cols.max(1)).max(1);
+        parallel_for_each_row_band_mut(y, 1, min_rows, band);
+    } else {
+        band(0, y);
+    }
+}
+
+/// 将 rows×cols 的 `a` 转置写入 cols×rows 的 `out`，按方块遍历以保持缓存局部性
+pub fn transpose(rows: usize, cols: usize, a: &[f64], out: &mut [f64]) {
+    assert!(a.len() >= rows * cols && out.len() >= rows * cols, "矩阵缓冲区长度不足");
+    for ib in (0..rows).step_by(TRANSPOSE_BLOCK) {
+        let i_end = (ib + TRANSPOSE_BLOCK).min(rows);
+        for jb in (0..cols).step_by(TRANSPOSE_BLOCK) {
+            let j_end = (jb + TRANSPOSE_BLOCK).min(cols);
+            for i in ib..i_end {
+                for j in jb..j_end {
+                    out[j * rows + i] = a[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+fn round_up(value: usize, multiple: usize) -> usize {
+    (value + multiple - 1) / multiple * multiple
+}
+
+fn select_kernel() -> MicroKernel {
+    match SimdLevel::detect() {
+        #[cfg(target_arch = "x86_64")]
+        SimdLevel::Avx2 | SimdLevel::Avx512 => kernel_avx2,
+        _ => kernel_scalar,
+    }
+}
+
+/// 将 A 的 mc×kc 子块打包为 MR 行一组的条带，每条内按列连续，不足处补零
+fn pack_a(a: &[f64], lda: usize, row0: usize, col0: usize, mc: usize, kc: usize, packed: &mut [f64]) {
+    for ir in (0..mc).step_by(MR) {
+        let sliver = &mut packed[ir * kc..(ir + MR) * kc];
+        for r in 0..MR {
+            if ir + r < mc {
+                let row = &a[(row0 + ir + r) * lda + col0..][..kc];
+                for (p, &value) in row.iter().enumerate() {
+                    sliver[p * MR + r] = value;
+                }
+            } else {
+                for p in 0..kc {
+                    sliver[p * MR + r] = 0.0;
+                }
+            }
+        }
+    }
+}
+
+/// 将 B 的 kc×nc 面板打包为 NR 列一组的条带，每条内按行连续，不足处补零
+fn pack_b(b: &[f64], ldb: usize, row0: usize, col0: usize, kc: usize, nc: usize, packed: &mut [f64]) {
+    for jr in (0..nc).step_by(NR) {
+        let cols = NR.min(nc - jr);
+        let sliver = &mut packed[jr * kc..(jr + NR) * kc];
+        for p in 0..kc {
+            let src = &b[(row0 + p) * ldb + col0 + jr..][..cols];
+            let dst = &mut sliver[p * NR..(p + 1) * NR];
+            dst[..cols].copy_from_slice(src);
+            dst[cols..].fill(0.0);
+        }
+    }
+}
+
+/// 遍历打包后的块，对每个 MR×NR 瓦片调用微内核
+#[allow(clippy::too_many_arguments)]
+fn macro_kernel(
+    kernel: MicroKernel,
+    mc: usize,
+    nc: usize,
+    kc: usize,
+    packed_a: &[f64],
+    packed_b: &[f64],
+    c: &mut [f64],
+    ldc: usize,
+) {
+    for jr in (0..nc).step_by(NR) {
+        let cols = NR.min(nc - jr);
+        let b_sliver = &packed_b[jr * kc..(jr + NR) * kc];
+        for ir in (0..mc).step_by(MR) {
+            let rows = MR.min(mc - ir);
+            let a_sliver = &packed_a[ir * kc..(ir + MR) * kc];
+            let tile = &mut c[ir * ldc + jr..];
+            debug_assert!(tile.len() >= (rows - 1) * ldc + cols);
+            // 条带长度已由切片检查，瓦片范围在 c 之内
+            unsafe { kernel(kc, a_sliver.as_ptr(), b_sliver.as_ptr(), tile.as_mut_ptr(), ldc, rows, cols) };
+        }
+    }
+}
+
+/// 将累加结果加回 C 的有效区域（边缘瓦片）
+unsafe fn add_tile(acc: &[[f64; NR]; MR], c: *mut f64, ldc: usize, rows: usize, cols: usize) {
+    for (r, acc_row) in acc.iter().enumerate().take(rows) {
+        for (j, &value) in acc_row.iter().enumerate().take(cols) {
+            *c.add(r * ldc + j) += value;
+        }
+    }
+}
+
+unsafe fn kernel_scalar(kc: usize, a: *const f64, b: *const f64, c: *mut f64, ldc: usize, rows: usize, cols: usize) {
+    let mut acc = [[0.0f64; NR]; MR];
+    for p in 0..kc {
+        let a_col = std::slice::from_raw_parts(a.add(p * MR), MR);
+        let b_row = std::slice::from_raw_parts(b.add(p * NR), NR);
+        for r in 0..MR {
+            for j in 0..NR {
+                acc[r][j] += a_col[r] * b_row[j];
+            }
+        }
+    }
+    add_tile(&acc, c, ldc, rows, cols);
+}
+
+/// 6×8 AVX2/FMA 微内核：12 个累加寄存器 + 2 个 B 寄存器 + 1 个广播寄存器
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2,fma")]
+unsafe fn kernel_avx2(kc: usize, a: *const f64, b: *const f64, c: *mut f64, ldc: usize, rows: usize, cols: usize) {
+    use std::arch::x86_64::*;
+
+    let mut lo = [_mm256_setzero_pd(); MR];
+    let mut hi = [_mm256_setzero_pd(); MR];
+    for p in 0..kc {
+        let b0 = _mm256_loadu_pd(b.add(p * NR));
+        let b1 = _mm256_loadu_pd(b.add(p * NR + 4));
+        for r in 0..MR {
+            let av = _mm256_broadcast_sd(&*a.add(p * MR + r));
+            lo[r] = _mm256_fmadd_pd(av, b0, lo[r]);
+            hi[r] = _mm256_fmadd_pd(av, b1, hi[r]);
+        }
+    }
+
+    if rows == MR && cols == NR {
+        for r in 0..MR {
+            let row = c.add(r * ldc);
+            _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), lo[r]));
+            _mm256_storeu_pd(row.add(4), _mm256_add_pd(_mm256_loadu_pd(row.add(4)), hi[r]));
+        }
+    } else {
+        let mut acc = [[0.0f64; NR]; MR];
+        for r in 0..MR {
+            _mm256_storeu_pd(acc[r].as_mut_ptr(), lo[r]);
+            _mm256_storeu_pd(acc[r].as_mut_ptr().add(4), hi[r]);
+        }
+        add_tile(&acc, c, ldc, rows, cols);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn 样例(行数: usize, 列数: usize, 种子: usize) -> 矩阵 {
+        let 数据 = (0..行数 * 列数)
+            .map(|i| (((i + 种子) * 2654435761) % 1000) as f64 / 100.0 - 5.0)
+            .collect();
+        矩阵::从数据(行数, 列数, 数据).unwrap()
+    }
+
+    fn 近似相等(左: &矩阵, 右: &矩阵) -> bool {
+        左.行数() == 右.行数()
+            && 左.列数() == 右.列数()
+            && 左.数据().iter().zip(右.数据()).all(|(x, y)| (x - y).abs() <= 1e-9 * x.abs().max(1.0))
+    }
+
+    #[test]
+    fn test_gemm_matches_naive() {
+        // 覆盖边缘瓦片、跨 KC 面板以及并行路径
+        for &(m, n, k) in &[(1, 1, 1), (7, 13, 5), (6, 8, 300), (67, 45, 513), (300, 70, 220)] {
+            let a = 样例(m, k, 1);
+            let b = 样例(k, n, 2);
+            assert!(近似相等(&a.乘法(&b).unwrap(), &a.朴素乘法(&b).unwrap()), "{}x{}x{}", m, n, k);
+        }
+    }
+
+    #[test]
+    fn test_identity_and_dimension_errors() {
+        let a = 样例(5, 5, 3);
+        assert!(近似相等(&a.乘法(&矩阵::单位矩阵(5)).unwrap(), &a));
+        assert!(a.乘法(&样例(4, 5, 0)).is_err());
+        assert!(矩阵::从数据(2, 2, vec![1.0]).is_err());
+        assert!(a.矩阵向量乘(&[1.0]).is_err());
+    }
+
+    #[test]
+    fn test_matvec_and_transpose() {
+        let a = 矩阵::从数据(2, 3, vec![1.0, 2.0, 3.0, 4.0, 5.0, 6.0]).unwrap();
+        assert_eq!(a.矩阵向量乘(&[1.0, 0.0, -1.0]).unwrap(), vec![-2.0, -2.0]);
+
+        let t = a.转置();
+        assert_eq!(t.数据(), &[1.0, 4.0, 2.0, 5.0, 3.0, 6.0]);
+        assert_eq!(t.获取(2, 1), Some(6.0));
+
+        let big = 样例(70, 45, 4);
+        assert_eq!(big.转置().转置(), big);
+    }
+}
@@ -8,6 +8,9 @@ pub mod string;
 pub mod math;
 pub mod system;
 pub mod conversion;
+pub mod number_format;
+pub mod vector_math;
+pub mod matrix;
 pub mod debug;
 pub mod crypto;
 pub mod crypto_ffi;
@@ -19,6 +22,7 @@ pub use system::{SystemModule, SystemInfo};
 pub use conversion::{ConversionModule, TypeConversion};
 pub use debug::{DebugModule, DebugInfo};
 pub use crypto::{加密模块, 加密操作, 编码格式};
+pub use matrix::矩阵;
 // StandardLibrary is defined below, no need to re-export
 
 /// Standard library result type
@@ -0,0 +1,288 @@
+//! Number Formatting and Parsing Module
+//!
+//! This module provides allocation-free integer and float formatting into
+//! caller-provided buffers, plus fast parsing paths for plain ASCII decimal
+//! input. Runtime FFI functions and standard I/O use these helpers so that
+//! printing or converting a number does not go through a heap `String`.
+
+use std::fmt::Write as _;
+
+/// Buffer size large enough for any `i64` in decimal (sign + 19 digits)
+pub const INT_BUFFER_SIZE: usize = 20;
+
+/// Buffer size large enough for any `f64` in its shortest decimal form
+///
+/// The longest outputs are subnormals such as `5e-324`, which print as
+/// `0.` followed by 323 zeros and up to 17 significant digits.
+pub const FLOAT_BUFFER_SIZE: usize = 384;
+
+/// Two-digit lookup table used by the integer formatter
+const DIGIT_PAIRS: &[u8; 200] = b"\
+0001020304050607080910111213141516171819\
+2021222324252627282930313233343536373839\
+4041424344454647484950515253545556575859\
+6061626364656667686970717273747576777879\
+8081828384858687888990919293949596979899";
+
+/// Powers of ten that are exactly representable as `f64`
+const EXACT_POWERS_OF_TEN: [f64; 23] = [
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+];
+
+/// Largest mantissa that converts to `f64` without rounding (2^53)
+const MAX_EXACT_MANTISSA: u64 = 1 << 53;
+
+/// Format an integer into a stack buffer and return the written text
+///
+/// Digits are produced two at a time from a lookup table, filling the
+/// buffer from the end, so no intermediate allocation takes place.
+pub fn format_int(value: i64, buffer: &mut [u8; INT_BUFFER_SIZE]) -> &str {
+    let mut position = INT_BUFFER_SIZE;
+    // unsigned_abs handles i64::MIN without overflow
+    let mut remaining = value.unsigned_abs();
+
+    while remaining >= 100 {
+        let pair = ((remaining % 100) * 2) as usize;
+        remaining /= 100;
+        position -= 2;
+        buffer[position] = DIGIT_PAIRS[pair];
+        buffer[position + 1] = DIGIT_PAIRS[pair + 1];
+    }
+
+    if remaining >= 10 {
+        let pair = (remaining * 2) as usize;
+        position -= 2;
+        buffer[position] = DIGIT_PAIRS[pair];
+        buffer[position + 1] = DIGIT_PAIRS[pair + 1];
+    } else {
+        position -= 1;
+        buffer[position] = b'0' + remaining as u8;
+    }
+
+    if value < 0 {
+        position -= 1;
+        buffer[position] = b'-';
+    }
+
+    // Only ASCII digits and '-' were written
+    unsafe { std::str::from_utf8_unchecked(&buffer[position..]) }
+}
+
+/// Fixed-capacity writer over a byte buffer used by `format_float`
+struct StackWriter<'a> {
+    buffer: &'a mut [u8],
+    length: usize,
+}
+
+impl std::fmt::Write for StackWriter<'_> {
+    fn write_str(&mut self, text: &str) -> std::fmt::Result {
+        let end = self.length + text.len();
+        if end > self.buffer.len() {
+            return Err(std::fmt::Error);
+        }
+        self.buffer[self.length..end].copy_from_slice(text.as_bytes());
+        self.length = end;
+        Ok(())
+    }
+}
+
+/// Format a float into a stack buffer using its shortest round-trip form
+///
+/// The output is identical to `f64`'s `Display` implementation (core's
+/// shortest-representation algorithm), but is written straight into the
+/// caller's buffer instead of a heap `String`.
+pub fn format_float(value: f64, buffer: &mut [u8; FLOAT_BUFFER_SIZE]) -> &str {
+    format_float_with_point(value, false, buffer)
+}
+
+/// Format a float, optionally forcing a trailing `.0` on whole values
+///
+/// Runtime printing shows `3.0` rather than `3` so that floats stay visibly
+/// distinct from integers; this matches the previous `{:.1}` behaviour.
+pub fn format_float_with_point(
+    value: f64,
+    force_decimal_point: bool,
+    buffer: &mut [u8; FLOAT_BUFFER_SIZE],
+) -> &str {
+    let length = {
+        let mut writer = StackWriter { buffer: &mut buffer[..], length: 0 };
+        // FLOAT_BUFFER_SIZE covers the longest possible Display output
+        let _ = write!(writer, "{}", value);
+        if force_decimal_point && value.is_finite() && value.fract() == 0.0 {
+            let _ = writer.write_str(".0");
+        }
+        writer.length
+    };
+
+    // Display output for f64 is always ASCII
+    unsafe { std::str::from_utf8_unchecked(&buffer[..length]) }
+}
+
+/// Parse a plain ASCII decimal integer: optional sign followed by digits
+///
+/// Returns `None` for empty input, stray characters or overflow, so callers
+/// can fall back to a slower path (or report an error) themselves.
+pub fn parse_int_ascii(bytes: &[u8]) -> Option<i64> {
+    let (negative, digits) = match bytes.first()? {
+        b'-' => (true, &bytes[1..]),
+        b'+' => (false, &bytes[1..]),
+        _ => (false, bytes),
+    };
+
+    if digits.is_empty() {
+        return None;
+    }
+
+    // Accumulate as a negative number so i64::MIN parses without overflow
+    let mut value: i64 = 0;
+    for &byte in digits {
+        let digit = byte.wrapping_sub(b'0');
+        if digit > 9 {
+            return None;
+        }
+        value = value.checked_mul(10)?.checked_sub(digit as i64)?;
+    }
+
+    if negative {
+        Some(value)
+    } else {
+        value.checked_neg()
+    }
+}
+
+/// Parse an ASCII decimal float
+///
+/// Simple inputs (at most 2^53 as an integer mantissa and a decimal exponent
+/// within ±22) are converted exactly with a single multiply or divide. All
+/// other ASCII input, including `inf`, `NaN` and long mantissas, is handed
+/// to the standard library parser.
+pub fn parse_float_ascii(bytes: &[u8]) -> Option<f64> {
+    if let Some(value) = parse_float_fast(bytes) {
+        return Some(value);
+    }
+
+    if !bytes.is_ascii() {
+        return None;
+    }
+
+    // ASCII was checked above
+    let text = unsafe { std::str::from_utf8_unchecked(bytes) };
+    text.parse::<f64>().ok()
+}
+
+/// Exact fast path for short decimal floats (Clinger's algorithm)
+fn parse_float_fast(bytes: &[u8]) -> Option<f64> {
+    let (negative, rest) = match bytes.first()? {
+        b'-' => (true, &bytes[1..]),
+        b'+' => (false, &bytes[1..]),
+        _ => (false, bytes),
+    };
+
+    let mut mantissa: u64 = 0;
+    let mut exponent: i32 = 0;
+    let mut digit_count = 0usize;
+    let mut index = 0usize;
+
+    while index < rest.len() && rest[index].is_ascii_digit() {
+        mantissa = mantissa.checked_mul(10)?.checked_add((rest[index] - b'0') as u64)?;
+        digit_count += 1;
+        index += 1;
+    }
+
+    if index < rest.len() && rest[index] == b'.' {
+        index += 1;
+        while index < rest.len() && rest[index].is_ascii_digit() {
+            mantissa = mantissa.checked_mul(10)?.checked_add((rest[index] - b'0') as u64)?;
+            exponent -= 1;
+            digit_count += 1;
+            index += 1;
+        }
+    }
+
+    if digit_count == 0 {
+        return None;
+    }
+
+    if index < rest.len() && (rest[index] == b'e' || rest[index] == b'E') {
+        index += 1;
+        let (exp_negative, exp_start) = match rest.get(index) {
+            Some(b'-') => (true, index + 1),
+            Some(b'+') => (false, index + 1),
+            _ => (false, index),
+        };
+        index = exp_start;
+
+        let mut explicit: i32 = 0;
+        while index < rest.len() && rest[index].is_ascii_digit() {
+            explicit = explicit.checked_mul(10)?.checked_add((rest[index] - b'0') as i32)?;
+            index += 1;
+        }
+        if index == exp_start {
+            return None;
+        }
+        exponent = exponent.checked_add(if exp_negative { -explicit } else { explicit })?;
+    }
+
+    if index != rest.len() || mantissa > MAX_EXACT_MANTISSA || exponent.abs() > 22 {
+        return None;
+    }
+
+    let base = mantissa as f64;
+    let value = if exponent >= 0 {
+        base * EXACT_POWERS_OF_TEN[exponent as usize]
+    } else {
+        base / EXACT_POWERS_OF_TEN[(-exponent) as usize]
+    };
+
+    Some(if negative { -value } else { value })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_format_int() {
+        let mut buffer = [0u8; INT_BUFFER_SIZE];
+        for value in [0, 7, -7, 10, 99, 100, -12345, 9876543210, i64::MAX, i64::MIN] {
+            assert_eq!(format_int(value, &mut buffer), value.to_string());
+        }
+    }
+
+    #[test]
+    fn test_format_float() {
+        let mut buffer = [0u8; FLOAT_BUFFER_SIZE];
+        for value in [0.0, -0.0, 3.14, 1e300, 5e-324, f64::MAX, f64::NAN, f64::INFINITY, 0.1 + 0.2] {
+            assert_eq!(format_float(value, &mut buffer), value.to_string());
+        }
+
+        assert_eq!(format_float_with_point(3.0, true, &mut buffer), "3.0");
+        assert_eq!(format_float_with_point(3.5, true, &mut buffer), "3.5");
+        assert_eq!(format_float_with_point(f64::INFINITY, true, &mut buffer), "inf");
+    }
+
+    #[test]
+    fn test_parse_int_ascii() {
+        assert_eq!(parse_int_ascii(b"123"), Some(123));
+        assert_eq!(parse_int_ascii(b"-456"), Some(-456));
+        assert_eq!(parse_int_ascii(b"+7"), Some(7));
+        assert_eq!(parse_int_ascii(b"9223372036854775807"), Some(i64::MAX));
+        assert_eq!(parse_int_ascii(b"-9223372036854775808"), Some(i64::MIN));
+        assert_eq!(parse_int_ascii(b"9223372036854775808"), None);
+        assert_eq!(parse_int_ascii(b""), None);
+        assert_eq!(parse_int_ascii(b"-"), None);
+        assert_eq!(parse_int_ascii(b"12a"), None);
+    }
+
+    #[test]
+    fn test_parse_float_ascii() {
+        for text in ["123.45", "-67.89", "0.1", "1e10", "2.5E-3", "9007199254740993", "1e-400", ".5", "5."] {
+            assert_eq!(parse_float_ascii(text.as_bytes()), text.parse::<f64>().ok(), "{}", text);
+        }
+        assert!(parse_float_ascii(b"NaN").unwrap().is_nan());
+        assert_eq!(parse_float_ascii(b"inf"), Some(f64::INFINITY));
+        assert_eq!(parse_float_ascii(b"abc"), None);
+        assert_eq!(parse_float_ascii("一".as_bytes()), None);
+    }
+}
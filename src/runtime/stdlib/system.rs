@@ -3,11 +3,15 @@
 //! This module provides system-level operations including environment
 //! variables, system information, and process management with Chinese
 //! language support.
+//!
+//! System information comes from `uname` and `/proc` without starting any
+//! subprocess. Commands run through `io::process`, which spawns with
+//! `posix_spawn` and can stream the child's output as it arrives.
 
 use std::env;
 use std::time::{SystemTime, UNIX_EPOCH};
-use std::process::Command;
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
+use crate::runtime::io::process::{Process, ProcessBuilder, StdioMode};
 use crate::runtime::{RuntimeResult, RuntimeError};
 
 /// System information structure
@@ -19,6 +23,8 @@ pub struct SystemInfo {
     pub architecture: String,
     /// Hostname
     pub hostname: String,
+    /// Kernel release
+    pub kernel_version: String,
     /// Number of CPU cores
     pub cpu_cores: usize,
     /// Total memory in bytes
@@ -140,20 +146,17 @@ impl SystemModule {
         let os_type = env::consts::OS.to_string();
         let architecture = env::consts::ARCH.to_string();
 
-        // Get hostname
-        let hostname = match Command::new("hostname").output() {
-            Ok(output) => {
-                let hostname_str = String::from_utf8_lossy(&output.stdout);
-                hostname_str.trim().to_string()
-            }
-            Err(_) => "未知".to_string(),
-        };
+        // Get hostname and kernel release in one uname call
+        let (hostname, kernel_version) = self.get_uname()
+            .unwrap_or_else(|| ("未知".to_string(), "未知".to_string()));
 
-        // Get CPU cores (fallback)
-        let cpu_cores = 1;
+        // Get CPU cores available to this process
+        let cpu_cores = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1);
 
-        // Get memory information (fallback)
-        let (total_memory, available_memory) = (0, 0);
+        // Get memory information (platform-specific)
+        let (total_memory, available_memory) = self.get_memory_info()?;
 
         // Get system uptime (platform-specific)
         let uptime = self.get_system_uptime()?;
@@ -166,6 +169,7 @@ impl SystemModule {
             os_type,
             architecture,
             hostname,
+            kernel_version,
             cpu_cores,
             total_memory,
             available_memory,
@@ -174,16 +178,62 @@ impl SystemModule {
         })
     }
 
+    /// Get hostname and kernel release
+    fn get_uname(&self) -> Option<(String, String)> {
+        #[cfg(unix)]
+        {
+            let mut name: libc::utsname = unsafe { std::mem::zeroed() };
+            if unsafe { libc::uname(&mut name) } != 0 {
+                return None;
+            }
+            let field = |chars: &[libc::c_char]| {
+                let bytes: Vec<u8> = chars.iter().take_while(|&&c| c != 0).map(|&c| c as u8).collect();
+                String::from_utf8_lossy(&bytes).into_owned()
+            };
+            Some((field(&name.nodename), field(&name.release)))
+        }
+
+        #[cfg(not(unix))]
+        {
+            None
+        }
+    }
+
     /// Get memory information
     fn get_memory_info(&self) -> RuntimeResult<(u64, u64)> {
-        // Fallback implementation - return zeros
-        Ok((0, 0))
+        // /proc/meminfo reports sizes in KB
+        let content = match std::fs::read_to_string("/proc/meminfo") {
+            Ok(content) => content,
+            Err(_) => return Ok((0, 0)),
+        };
+
+        let (mut total, mut available) = (0, 0);
+        for line in content.lines() {
+            let mut parts = line.split_whitespace();
+            let target = match parts.next() {
+                Some("MemTotal:") => &mut total,
+                Some("MemAvailable:") => &mut available,
+                _ => continue,
+            };
+            if let Some(Ok(kb)) = parts.next().map(str::parse::<u64>) {
+                *target = kb * 1024;
+            }
+        }
+        Ok((total, available))
     }
 
     /// Get system uptime
     fn get_system_uptime(&self) -> RuntimeResult<u64> {
-        // Fallback implementation - return zero
-        Ok(0)
+        // The first field of /proc/uptime is seconds since boot
+        match std::fs::read_to_string("/proc/uptime") {
+            Ok(content) => Ok(content
+                .split_whitespace()
+                .next()
+                .and_then(|seconds| seconds.parse::<f64>().ok())
+                .map(|seconds| seconds as u64)
+                .unwrap_or(0)),
+            Err(_) => Ok(0),
+        }
     }
 
     /// Get process information
@@ -403,12 +453,12 @@ impl SystemModule {
 
     /// Execute system command
     pub fn execute_command(&self, command: &str, args: &[&str]) -> RuntimeResult<String> {
-        let output = Command::new(command)
-            .args(args)
+        let output = ProcessBuilder::new(command)
+            .with_args(args.iter().copied())
             .output()
             .map_err(|e| RuntimeError::system_error(format!("执行命令失败: {} - {}", command, e), "执行命令失败".to_string()))?;
 
-        if output.status.success() {
+        if output.success() {
             let stdout = String::from_utf8_lossy(&output.stdout);
             Ok(stdout.to_string())
         } else {
@@ -417,27 +467,57 @@ impl SystemModule {
         }
     }
 
+    /// Start a command with piped standard streams
+    ///
+    /// Unlike `execute_command`, output can be read as it is produced and
+    /// input written while the command runs.
+    pub fn spawn_command(&self, command: &str, args: &[&str]) -> RuntimeResult<Process> {
+        ProcessBuilder::new(command)
+            .with_args(args.iter().copied())
+            .with_stdin(StdioMode::Piped)
+            .with_stdout(StdioMode::Piped)
+            .with_stderr(StdioMode::Piped)
+            .spawn()
+            .map_err(|e| RuntimeError::system_error(format!("启动命令失败: {} - {}", command, e), "启动命令失败".to_string()))
+    }
+
     /// Check if command exists
     pub fn command_exists(&self, command: &str) -> bool {
-        #[cfg(unix)]
-        {
-            match Command::new("which").arg(command).output() {
-                Ok(output) => output.status.success(),
-                Err(_) => false,
-            }
+        if command.contains(std::path::MAIN_SEPARATOR) {
+            return Self::is_executable(Path::new(command));
         }
 
-        #[cfg(windows)]
-        {
-            match Command::new("where").arg(command).output() {
-                Ok(output) => output.status.success(),
-                Err(_) => false,
+        // Search PATH directly rather than running `which`
+        let path = match env::var_os("PATH") {
+            Some(path) => path,
+            None => return false,
+        };
+        env::split_paths(&path).any(|dir| {
+            #[cfg(windows)]
+            {
+                ["", ".exe", ".cmd", ".bat"]
+                    .iter()
+                    .any(|ext| Self::is_executable(&dir.join(format!("{}{}", command, ext))))
             }
-        }
 
-        #[cfg(not(any(unix, windows)))]
-        {
-            false
+            #[cfg(not(windows))]
+            {
+                Self::is_executable(&dir.join(command))
+            }
+        })
+    }
+
+    /// Check whether a path is an executable file
+    fn is_executable(path: &Path) -> bool {
+        match std::fs::metadata(path) {
+            #[cfg(unix)]
+            Ok(metadata) => {
+                use std::os::unix::fs::PermissionsExt;
+                metadata.is_file() && metadata.permissions().mode() & 0o111 != 0
+            }
+            #[cfg(not(unix))]
+            Ok(metadata) => metadata.is_file(),
+            Err(_) => false,
         }
     }
 
@@ -608,6 +688,37 @@ mod tests {
         assert!(has_ls || has_which || system.command_exists("dir") || system.command_exists("where"));
     }
 
+    #[test]
+    fn test_system_info_without_subprocess() {
+        let mut system = SystemModule::new();
+        let info = system.get_system_info().unwrap();
+
+        assert!(!info.hostname.is_empty());
+        assert!(info.cpu_cores >= 1);
+        #[cfg(target_os = "linux")]
+        {
+            assert!(!info.kernel_version.is_empty());
+            assert!(info.total_memory > 0);
+            assert!(info.available_memory <= info.total_memory);
+        }
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn test_spawn_command_streams() {
+        let system = SystemModule::new();
+        let process = system.spawn_command("cat", &[]).unwrap();
+
+        let stdin = process.stdin().unwrap();
+        assert!(stdin.write_all("流式\n".as_bytes(), None).unwrap());
+        process.close_stdin();
+
+        let mut output = Vec::new();
+        process.stdout().unwrap().read_to_end(&mut output).unwrap();
+        assert_eq!(String::from_utf8(output).unwrap(), "流式\n");
+        assert_eq!(process.wait().unwrap(), 0);
+    }
+
     #[test]
     fn test_execute_command() {
         let system = SystemModule::new();
@@ -618,6 +729,9 @@ mod tests {
             let result = system.execute_command("echo", &["hello"]);
             assert!(result.is_ok());
             assert_eq!(result.unwrap().trim(), "hello");
+
+            assert!(system.execute_command("sh", &["-c", "echo failed >&2; exit 2"]).is_err());
+            assert!(system.execute_command("qi-no-such-command", &[]).is_err());
         }
 
         #[cfg(windows)]
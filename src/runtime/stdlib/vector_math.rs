@@ -0,0 +1,950 @@
+//! Vectorized Array Math Module
+//!
+//! This module provides whole-array kernels over `整数` (i64) and `浮点数`
+//! (f64) arrays: sum, min, max, dot product, mean, variance, element-wise
+//! sqrt/exp/ln and clamp. Each kernel is selected once per call from the
+//! widest SIMD instruction set the CPU reports at runtime, and arrays larger
+//! than `PARALLEL_THRESHOLD` are split across worker threads.
+//!
+//! Floating point reductions use several independent accumulators, so their
+//! results may differ from a strict left-to-right loop in the last bits.
+//! The SIMD `exp` and `ln` kernels are polynomial approximations accurate to
+//! a few ulp; lanes outside their fast range fall back to the scalar libm
+//! functions.
+
+use std::sync::OnceLock;
+
+use crate::runtime::async_runtime::pool::{parallel_for_each_chunk_mut, parallel_map_ranges};
+
+/// Element count above which kernels are split across worker threads
+pub const PARALLEL_THRESHOLD: usize = 1 << 18;
+
+/// Smallest chunk handed to a single worker thread
+const PARALLEL_MIN_CHUNK: usize = 1 << 16;
+
+/// SIMD instruction set used by the array kernels
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SimdLevel {
+    /// Portable scalar loops
+    Scalar,
+    /// 256-bit AVX2 with FMA
+    Avx2,
+    /// 512-bit AVX-512F (requires the `avx512` feature)
+    Avx512,
+}
+
+impl SimdLevel {
+    /// Detect the widest supported instruction set (cached after first call)
+    pub fn detect() -> Self {
+        static LEVEL: OnceLock<SimdLevel> = OnceLock::new();
+        *LEVEL.get_or_init(|| {
+            #[cfg(all(target_arch = "x86_64", feature = "avx512"))]
+            if is_x86_feature_detected!("avx512f") {
+                return SimdLevel::Avx512;
+            }
+            #[cfg(target_arch = "x86_64")]
+            if is_x86_feature_detected!("avx2") && is_x86_feature_detected!("fma") {
+                return SimdLevel::Avx2;
+            }
+            SimdLevel::Scalar
+        })
+    }
+}
+
+/// Select the kernel for the detected SIMD level
+///
+/// Every arm must have the same signature; the AVX arms are `unsafe` only
+/// because of `#[target_feature]`, which `SimdLevel::detect` has verified.
+macro_rules! dispatch {
+    ($name:ident ( $($arg:expr),* )) => {
+        match SimdLevel::detect() {
+            #[cfg(all(target_arch = "x86_64", feature = "avx512"))]
+            SimdLevel::Avx512 => unsafe { avx512::$name($($arg),*) },
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx2 => unsafe { avx2::$name($($arg),*) },
+            _ => scalar::$name($($arg),*),
+        }
+    };
+}
+
+/// Run a reduction serially or over parallel ranges and combine the parts
+fn reduce<T, F, C>(len: usize, kernel: F, combine: C) -> T
+where
+    T: Send,
+    F: Fn(std::ops::Range<usize>) -> T + Sync,
+    C: Fn(T, T) -> T,
+{
+    if len < PARALLEL_THRESHOLD {
+        return kernel(0..len);
+    }
+    parallel_map_ranges(len, PARALLEL_MIN_CHUNK, kernel)
+        .into_iter()
+        .reduce(combine)
+        .expect("并行归约至少包含一个分块")
+}
+
+/// Run an element-wise kernel serially or over parallel chunks
+fn map_in_place<F>(values: &mut [f64], kernel: F)
+where
+    F: Fn(&mut [f64]) + Sync,
+{
+    if values.len() < PARALLEL_THRESHOLD {
+        kernel(values);
+    } else {
+        parallel_for_each_chunk_mut(values, PARALLEL_MIN_CHUNK, kernel);
+    }
+}
+
+/// Sum of a float array (0.0 when empty)
+pub fn sum_f64(values: &[f64]) -> f64 {
+    reduce(values.len(), |range| dispatch!(sum_f64(&values[range])), |a, b| a + b)
+}
+
+/// Sum of an integer array with wrapping overflow (0 when empty)
+pub fn sum_i64(values: &[i64]) -> i64 {
+    reduce(values.len(), |range| dispatch!(sum_i64(&values[range])), i64::wrapping_add)
+}
+
+/// Smallest element of a float array
+///
+/// NaN elements are skipped; an array of only NaNs yields NaN.
+pub fn min_f64(values: &[f64]) -> Option<f64> {
+    if values.is_empty() {
+        return None;
+    }
+    Some(reduce(values.len(), |range| dispatch!(min_f64(&values[range])), scalar::min_of))
+}
+
+/// Largest element of a float array
+///
+/// NaN elements are skipped; an array of only NaNs yields NaN.
+pub fn max_f64(values: &[f64]) -> Option<f64> {
+    if values.is_empty() {
+        return None;
+    }
+    Some(reduce(values.len(), |range| dispatch!(max_f64(&values[range])), scalar::max_of))
+}
+
+/// Smallest element of an integer array
+pub fn min_i64(values: &[i64]) -> Option<i64> {
+    if values.is_empty() {
+        return None;
+    }
+    Some(reduce(values.len(), |range| dispatch!(min_i64(&values[range])), i64::min))
+}
+
+/// Largest element of an integer array
+pub fn max_i64(values: &[i64]) -> Option<i64> {
+    if values.is_empty() {
+        return None;
+    }
+    Some(reduce(values.len(), |range| dispatch!(max_i64(&values[range])), i64::max))
+}
+
+/// Dot product of two float arrays over their common length
+pub fn dot_f64(a: &[f64], b: &[f64]) -> f64 {
+    let len = a.len().min(b.len());
+    reduce(len, |range| dispatch!(dot_f64(&a[range.clone()], &b[range])), |x, y| x + y)
+}
+
+/// Arithmetic mean of a float array
+pub fn mean_f64(values: &[f64]) -> Option<f64> {
+    if values.is_empty() {
+        return None;
+    }
+    Some(sum_f64(values) / values.len() as f64)
+}
+
+/// Arithmetic mean of an integer array, accumulated in floating point
+pub fn mean_i64(values: &[i64]) -> Option<f64> {
+    if values.is_empty() {
+        return None;
+    }
+    let total = reduce(values.len(), |range| dispatch!(sum_i64_as_f64(&values[range])), |a, b| a + b);
+    Some(total / values.len() as f64)
+}
+
+/// Population variance of a float array (two passes for accuracy)
+pub fn variance_f64(values: &[f64]) -> Option<f64> {
+    let mean = mean_f64(values)?;
+    let squares = reduce(
+        values.len(),
+        |range| dispatch!(squared_deviation_f64(&values[range], mean)),
+        |a, b| a + b,
+    );
+    Some(squares / values.len() as f64)
+}
+
+/// Population variance of an integer array
+pub fn variance_i64(values: &[i64]) -> Option<f64> {
+    let mean = mean_i64(values)?;
+    let squares = reduce(
+        values.len(),
+        |range| dispatch!(squared_deviation_i64(&values[range], mean)),
+        |a, b| a + b,
+    );
+    Some(squares / values.len() as f64)
+}
+
+/// Replace every element with its square root
+pub fn sqrt_in_place(values: &mut [f64]) {
+    map_in_place(values, |part| dispatch!(sqrt_in_place(part)));
+}
+
+/// Replace every element with `e` raised to it
+pub fn exp_in_place(values: &mut [f64]) {
+    map_in_place(values, |part| dispatch!(exp_in_place(part)));
+}
+
+/// Replace every element with its natural logarithm
+pub fn ln_in_place(values: &mut [f64]) {
+    map_in_place(values, |part| dispatch!(ln_in_place(part)));
+}
+
+/// Clamp every float element into `[min, max]`; NaN elements are kept
+///
+/// Callers must ensure `min <= max`.
+pub fn clamp_f64_in_place(values: &mut [f64], min: f64, max: f64) {
+    map_in_place(values, |part| dispatch!(clamp_f64_in_place(part, min, max)));
+}
+
+/// Clamp every integer element into `[min, max]`
+///
+/// Callers must ensure `min <= max`.
+pub fn clamp_i64_in_place(values: &mut [i64], min: i64, max: i64) {
+    let kernel = |part: &mut [i64]| dispatch!(clamp_i64_in_place(part, min, max));
+    if values.len() < PARALLEL_THRESHOLD {
+        kernel(values);
+    } else {
+        parallel_for_each_chunk_mut(values, PARALLEL_MIN_CHUNK, kernel);
+    }
+}
+
+/// Portable kernels, also used for the tails of the SIMD loops
+mod scalar {
+    /// Minimum that skips NaN operands; NaN only when both are NaN
+    #[inline(always)]
+    pub fn min_of(current: f64, value: f64) -> f64 {
+        if value < current || current.is_nan() { value } else { current }
+    }
+
+    /// Maximum that skips NaN operands; NaN only when both are NaN
+    #[inline(always)]
+    pub fn max_of(current: f64, value: f64) -> f64 {
+        if value > current || current.is_nan() { value } else { current }
+    }
+
+    /// Clamp that keeps NaN, matching the operand order of the SIMD kernels
+    #[inline(always)]
+    pub fn clamp_of(value: f64, min: f64, max: f64) -> f64 {
+        let upper = if max < value { max } else { value };
+        if min > upper { min } else { upper }
+    }
+
+    pub fn sum_f64(values: &[f64]) -> f64 {
+        let mut acc = [0.0f64; 4];
+        let mut chunks = values.chunks_exact(4);
+        for chunk in &mut chunks {
+            for lane in 0..4 {
+                acc[lane] += chunk[lane];
+            }
+        }
+        let tail: f64 = chunks.remainder().iter().sum();
+        (acc[0] + acc[1]) + (acc[2] + acc[3]) + tail
+    }
+
+    pub fn sum_i64(values: &[i64]) -> i64 {
+        values.iter().fold(0i64, |acc, &v| acc.wrapping_add(v))
+    }
+
+    pub fn min_f64(values: &[f64]) -> f64 {
+        values.iter().fold(f64::NAN, |acc, &v| min_of(acc, v))
+    }
+
+    pub fn max_f64(values: &[f64]) -> f64 {
+        values.iter().fold(f64::NAN, |acc, &v| max_of(acc, v))
+    }
+
+    pub fn min_i64(values: &[i64]) -> i64 {
+        values.iter().copied().fold(i64::MAX, i64::min)
+    }
+
+    pub fn max_i64(values: &[i64]) -> i64 {
+        values.iter().copied().fold(i64::MIN, i64::max)
+    }
+
+    pub fn dot_f64(a: &[f64], b: &[f64]) -> f64 {
+        a.iter().zip(b).map(|(x, y)| x * y).sum()
+    }
+
+    pub fn squared_deviation_f64(values: &[f64], mean: f64) -> f64 {
+        values
+            .iter()
+            .map(|&v| {
+                let deviation = v - mean;
+                deviation * deviation
+            })
+            .sum()
+    }
+
+    pub fn sum_i64_as_f64(values: &[i64]) -> f64 {
+        values.iter().map(|&v| v as f64).sum()
+    }
+
+    pub fn squared_deviation_i64(values: &[i64], mean: f64) -> f64 {
+        values
+            .iter()
+            .map(|&v| {
+                let deviation = v as f64 - mean;
+                deviation * deviation
+            })
+            .sum()
+    }
+
+    pub fn sqrt_in_place(values: &mut [f64]) {
+        values.iter_mut().for_each(|v| *v = v.sqrt());
+    }
+
+    pub fn exp_in_place(values: &mut [f64]) {
+        values.iter_mut().for_each(|v| *v = v.exp());
+    }
+
+    pub fn ln_in_place(values: &mut [f64]) {
+        values.iter_mut().for_each(|v| *v = v.ln());
+    }
+
+    pub fn clamp_f64_in_place(values: &mut [f64], min: f64, max: f64) {
+        values.iter_mut().for_each(|v| *v = clamp_of(*v, min, max));
+    }
+
+    pub fn clamp_i64_in_place(values: &mut [i64], min: i64, max: i64) {
+        values.iter_mut().for_each(|v| *v = (*v).max(min).min(max));
+    }
+}
+
+/// AVX2 + FMA kernels: 4 lanes per register, 4 registers per iteration
+#[cfg(target_arch = "x86_64")]
+mod avx2 {
+    use std::arch::x86_64::*;
+
+    use super::scalar;
+
+    /// Elements consumed per unrolled iteration
+    const STEP: usize = 16;
+
+    #[inline(always)]
+    unsafe fn lanes_pd(v: __m256d) -> [f64; 4] {
+        let mut out = [0.0f64; 4];
+        _mm256_storeu_pd(out.as_mut_ptr(), v);
+        out
+    }
+
+    #[inline(always)]
+    unsafe fn lanes_epi64(v: __m256i) -> [i64; 4] {
+        let mut out = [0i64; 4];
+        _mm256_storeu_si256(out.as_mut_ptr() as *mut __m256i, v);
+        out
+    }
+
+    #[inline(always)]
+    unsafe fn hsum_pd(v: __m256d) -> f64 {
+        let l = lanes_pd(v);
+        (l[0] + l[1]) + (l[2] + l[3])
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn sum_f64(values: &[f64]) -> f64 {
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr();
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = _mm256_add_pd(*a, _mm256_loadu_pd(p.add(lane * 4)));
+            }
+        }
+        let total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        hsum_pd(total) + scalar::sum_f64(chunks.remainder())
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn sum_i64(values: &[i64]) -> i64 {
+        let mut acc = [_mm256_setzero_si256(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr() as *const __m256i;
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = _mm256_add_epi64(*a, _mm256_loadu_si256(p.add(lane)));
+            }
+        }
+        let total = _mm256_add_epi64(_mm256_add_epi64(acc[0], acc[1]), _mm256_add_epi64(acc[2], acc[3]));
+        lanes_epi64(total)
+            .iter()
+            .fold(scalar::sum_i64(chunks.remainder()), |sum, &v| sum.wrapping_add(v))
+    }
+
+    /// Lane-wise scalar::min_of: `_mm256_min_pd(x, acc)` already keeps acc
+    /// when x is NaN, and the blend takes x while acc is still NaN
+    #[inline(always)]
+    unsafe fn min_of_pd(acc: __m256d, x: __m256d) -> __m256d {
+        _mm256_blendv_pd(_mm256_min_pd(x, acc), x, _mm256_cmp_pd::<_CMP_UNORD_Q>(acc, acc))
+    }
+
+    /// Lane-wise scalar::max_of, see min_of_pd
+    #[inline(always)]
+    unsafe fn max_of_pd(acc: __m256d, x: __m256d) -> __m256d {
+        _mm256_blendv_pd(_mm256_max_pd(x, acc), x, _mm256_cmp_pd::<_CMP_UNORD_Q>(acc, acc))
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn min_f64(values: &[f64]) -> f64 {
+        // Accumulators start as NaN so an all-NaN lane stays NaN
+        let mut acc = [_mm256_set1_pd(f64::NAN); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr();
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = min_of_pd(*a, _mm256_loadu_pd(p.add(lane * 4)));
+            }
+        }
+        let merged = min_of_pd(min_of_pd(acc[0], acc[1]), min_of_pd(acc[2], acc[3]));
+        lanes_pd(merged)
+            .iter()
+            .fold(scalar::min_f64(chunks.remainder()), |m, &v| scalar::min_of(m, v))
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn max_f64(values: &[f64]) -> f64 {
+        let mut acc = [_mm256_set1_pd(f64::NAN); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr();
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = max_of_pd(*a, _mm256_loadu_pd(p.add(lane * 4)));
+            }
+        }
+        let merged = max_of_pd(max_of_pd(acc[0], acc[1]), max_of_pd(acc[2], acc[3]));
+        lanes_pd(merged)
+            .iter()
+            .fold(scalar::max_f64(chunks.remainder()), |m, &v| scalar::max_of(m, v))
+    }
+
+    // AVX2 has no 64-bit integer min/max, so compare and blend instead
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn min_i64(values: &[i64]) -> i64 {
+        let mut acc = [_mm256_set1_epi64x(i64::MAX); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr() as *const __m256i;
+            for (lane, a) in acc.iter_mut().enumerate() {
+                let v = _mm256_loadu_si256(p.add(lane));
+                *a = _mm256_blendv_epi8(*a, v, _mm256_cmpgt_epi64(*a, v));
+            }
+        }
+        acc.iter()
+            .flat_map(|&a| lanes_epi64(a))
+            .fold(scalar::min_i64(chunks.remainder()), i64::min)
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn max_i64(values: &[i64]) -> i64 {
+        let mut acc = [_mm256_set1_epi64x(i64::MIN); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr() as *const __m256i;
+            for (lane, a) in acc.iter_mut().enumerate() {
+                let v = _mm256_loadu_si256(p.add(lane));
+                *a = _mm256_blendv_epi8(*a, v, _mm256_cmpgt_epi64(v, *a));
+            }
+        }
+        acc.iter()
+            .flat_map(|&a| lanes_epi64(a))
+            .fold(scalar::max_i64(chunks.remainder()), i64::max)
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn dot_f64(a: &[f64], b: &[f64]) -> f64 {
+        let len = a.len().min(b.len());
+        let body = len - len % STEP;
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let (pa, pb) = (a.as_ptr(), b.as_ptr());
+        let mut i = 0;
+        while i < body {
+            for (lane, s) in acc.iter_mut().enumerate() {
+                let offset = i + lane * 4;
+                *s = _mm256_fmadd_pd(_mm256_loadu_pd(pa.add(offset)), _mm256_loadu_pd(pb.add(offset)), *s);
+            }
+            i += STEP;
+        }
+        let total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        hsum_pd(total) + scalar::dot_f64(&a[body..len], &b[body..len])
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn squared_deviation_f64(values: &[f64], mean: f64) -> f64 {
+        let center = _mm256_set1_pd(mean);
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr();
+            for (lane, a) in acc.iter_mut().enumerate() {
+                let d = _mm256_sub_pd(_mm256_loadu_pd(p.add(lane * 4)), center);
+                *a = _mm256_fmadd_pd(d, d, *a);
+            }
+        }
+        let total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        hsum_pd(total) + scalar::squared_deviation_f64(chunks.remainder(), mean)
+    }
+
+    /// Convert four i64 lanes to f64 (AVX2 has no cvtepi64_pd)
+    ///
+    /// Splits each lane into a high part offset by 3·2^67 and a low 48-bit
+    /// part offset by 2^52, removes the offsets and adds the halves, so the
+    /// only rounding is in the final add, as with `as f64`.
+    #[inline(always)]
+    unsafe fn i64_to_f64(x: __m256i) -> __m256d {
+        let high = _mm256_srai_epi32::<16>(x);
+        let high = _mm256_blend_epi16::<0x33>(high, _mm256_setzero_si256());
+        let high = _mm256_add_epi64(high, _mm256_castpd_si256(_mm256_set1_pd(442721857769029238784.0)));
+        let low = _mm256_blend_epi16::<0x88>(x, _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0)));
+        let high = _mm256_sub_pd(_mm256_castsi256_pd(high), _mm256_set1_pd(442726361368656609280.0));
+        _mm256_add_pd(high, _mm256_castsi256_pd(low))
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn sum_i64_as_f64(values: &[i64]) -> f64 {
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr() as *const __m256i;
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = _mm256_add_pd(*a, i64_to_f64(_mm256_loadu_si256(p.add(lane))));
+            }
+        }
+        let total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        hsum_pd(total) + scalar::sum_i64_as_f64(chunks.remainder())
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn squared_deviation_i64(values: &[i64], mean: f64) -> f64 {
+        let center = _mm256_set1_pd(mean);
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr() as *const __m256i;
+            for (lane, a) in acc.iter_mut().enumerate() {
+                let d = _mm256_sub_pd(i64_to_f64(_mm256_loadu_si256(p.add(lane))), center);
+                *a = _mm256_fmadd_pd(d, d, *a);
+            }
+        }
+        let total = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        hsum_pd(total) + scalar::squared_deviation_i64(chunks.remainder(), mean)
+    }
+
+    /// High and low parts of ln 2; `n * LN2_HI` is exact for |n| < 2^11
+    const LN2_HI: f64 = 6.93147180369123816490e-01;
+    const LN2_LO: f64 = 1.90821492927058770002e-10;
+
+    /// Evaluate `coefficients` (highest degree first) at `x` with FMAs
+    #[inline(always)]
+    unsafe fn horner(x: __m256d, coefficients: &[f64]) -> __m256d {
+        let mut acc = _mm256_set1_pd(coefficients[0]);
+        for &c in &coefficients[1..] {
+            acc = _mm256_fmadd_pd(acc, x, _mm256_set1_pd(c));
+        }
+        acc
+    }
+
+    /// Taylor coefficients 1/k! for k = 13 down to 0
+    const EXP_COEFFICIENTS: [f64; 14] = [
+        1.0 / 6227020800.0,
+        1.0 / 479001600.0,
+        1.0 / 39916800.0,
+        1.0 / 3628800.0,
+        1.0 / 362880.0,
+        1.0 / 40320.0,
+        1.0 / 5040.0,
+        1.0 / 720.0,
+        1.0 / 120.0,
+        1.0 / 24.0,
+        1.0 / 6.0,
+        0.5,
+        1.0,
+        1.0,
+    ];
+
+    /// `e^x` for |x| small enough that 2^n is a normal double
+    ///
+    /// x = n·ln2 + r with |r| <= ln2/2, e^r from its Taylor series
+    /// (truncation error below 1e-17), and 2^n built from exponent bits.
+    #[inline(always)]
+    unsafe fn exp_pd(x: __m256d) -> __m256d {
+        let n = _mm256_round_pd::<{ _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC }>(
+            _mm256_mul_pd(x, _mm256_set1_pd(std::f64::consts::LOG2_E)),
+        );
+        let r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_HI), x);
+        let r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_LO), r);
+        let p = horner(r, &EXP_COEFFICIENTS);
+        // n + 1023 + 2^52 holds the biased exponent in its low mantissa bits
+        let biased = _mm256_add_pd(n, _mm256_set1_pd(4503599627370496.0 + 1023.0));
+        let scale = _mm256_slli_epi64::<52>(_mm256_castpd_si256(biased));
+        _mm256_mul_pd(p, _mm256_castsi256_pd(scale))
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn exp_in_place(values: &mut [f64]) {
+        // Outside this range (and for NaN) the result is subnormal, zero,
+        // infinite or NaN; those lanes take the scalar path
+        let (lo, hi) = (_mm256_set1_pd(-708.0), _mm256_set1_pd(709.0));
+        let mut chunks = values.chunks_exact_mut(4);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            let x = _mm256_loadu_pd(p);
+            let in_range = _mm256_and_pd(_mm256_cmp_pd::<_CMP_GE_OQ>(x, lo), _mm256_cmp_pd::<_CMP_LE_OQ>(x, hi));
+            if _mm256_movemask_pd(in_range) == 0b1111 {
+                _mm256_storeu_pd(p, exp_pd(x));
+            } else {
+                scalar::exp_in_place(chunk);
+            }
+        }
+        scalar::exp_in_place(chunks.into_remainder());
+    }
+
+    /// Coefficients 2/(2k+1) for k = 11 down to 0 of
+    /// ln(m) = 2·atanh(s) = Σ 2·s^(2k+1)/(2k+1)
+    const LN_COEFFICIENTS: [f64; 12] = [
+        2.0 / 23.0,
+        2.0 / 21.0,
+        2.0 / 19.0,
+        2.0 / 17.0,
+        2.0 / 15.0,
+        2.0 / 13.0,
+        2.0 / 11.0,
+        2.0 / 9.0,
+        2.0 / 7.0,
+        2.0 / 5.0,
+        2.0 / 3.0,
+        2.0,
+    ];
+
+    /// `ln x` for positive, normal, finite x
+    ///
+    /// x = m·2^e with m in [√½, √2), s = (m-1)/(m+1) so |s| < 0.172, and the
+    /// atanh series in s² (truncation error below 1e-19).
+    #[inline(always)]
+    unsafe fn ln_pd(x: __m256d) -> __m256d {
+        let bits = _mm256_castpd_si256(x);
+        // Biased exponent as a double via the 2^52 trick
+        let two52 = _mm256_set1_pd(4503599627370496.0);
+        let biased = _mm256_or_si256(_mm256_srli_epi64::<52>(bits), _mm256_castpd_si256(two52));
+        let mut e = _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(4503599627370496.0 + 1023.0));
+        let mantissa = _mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(0x000F_FFFF_FFFF_FFFF)),
+            _mm256_castpd_si256(_mm256_set1_pd(1.0)),
+        );
+        let mut m = _mm256_castsi256_pd(mantissa);
+        let large = _mm256_cmp_pd::<_CMP_GT_OQ>(m, _mm256_set1_pd(std::f64::consts::SQRT_2));
+        m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), large);
+        e = _mm256_add_pd(e, _mm256_and_pd(large, _mm256_set1_pd(1.0)));
+
+        let one = _mm256_set1_pd(1.0);
+        let s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+        let ln_m = _mm256_mul_pd(s, horner(_mm256_mul_pd(s, s), &LN_COEFFICIENTS));
+        _mm256_fmadd_pd(e, _mm256_set1_pd(LN2_HI), _mm256_fmadd_pd(e, _mm256_set1_pd(LN2_LO), ln_m))
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn ln_in_place(values: &mut [f64]) {
+        // Zero, negative, subnormal, infinite and NaN lanes take the scalar path
+        let (lo, hi) = (_mm256_set1_pd(f64::MIN_POSITIVE), _mm256_set1_pd(f64::MAX));
+        let mut chunks = values.chunks_exact_mut(4);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            let x = _mm256_loadu_pd(p);
+            let in_range = _mm256_and_pd(_mm256_cmp_pd::<_CMP_GE_OQ>(x, lo), _mm256_cmp_pd::<_CMP_LE_OQ>(x, hi));
+            if _mm256_movemask_pd(in_range) == 0b1111 {
+                _mm256_storeu_pd(p, ln_pd(x));
+            } else {
+                scalar::ln_in_place(chunk);
+            }
+        }
+        scalar::ln_in_place(chunks.into_remainder());
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn sqrt_in_place(values: &mut [f64]) {
+        let mut chunks = values.chunks_exact_mut(4);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            _mm256_storeu_pd(p, _mm256_sqrt_pd(_mm256_loadu_pd(p)));
+        }
+        scalar::sqrt_in_place(chunks.into_remainder());
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn clamp_f64_in_place(values: &mut [f64], min: f64, max: f64) {
+        // Operand order keeps NaN lanes unchanged, see scalar::clamp_of
+        let (lo, hi) = (_mm256_set1_pd(min), _mm256_set1_pd(max));
+        let mut chunks = values.chunks_exact_mut(4);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            let upper = _mm256_min_pd(hi, _mm256_loadu_pd(p));
+            _mm256_storeu_pd(p, _mm256_max_pd(lo, upper));
+        }
+        scalar::clamp_f64_in_place(chunks.into_remainder(), min, max);
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub unsafe fn clamp_i64_in_place(values: &mut [i64], min: i64, max: i64) {
+        let (lo, hi) = (_mm256_set1_epi64x(min), _mm256_set1_epi64x(max));
+        let mut chunks = values.chunks_exact_mut(4);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr() as *mut __m256i;
+            let v = _mm256_loadu_si256(p);
+            let v = _mm256_blendv_epi8(v, lo, _mm256_cmpgt_epi64(lo, v));
+            let v = _mm256_blendv_epi8(v, hi, _mm256_cmpgt_epi64(v, hi));
+            _mm256_storeu_si256(p, v);
+        }
+        scalar::clamp_i64_in_place(chunks.into_remainder(), min, max);
+    }
+}
+
+/// AVX-512F kernels for the float reductions; integer paths and the
+/// exp/ln kernels reuse AVX2
+///
+/// AVX-512 target features need a newer compiler than the crate's minimum
+/// supported Rust version, so these are only built with `--features avx512`.
+#[cfg(all(target_arch = "x86_64", feature = "avx512"))]
+mod avx512 {
+    use std::arch::x86_64::*;
+
+    use super::scalar;
+
+    /// Elements consumed per unrolled iteration
+    const STEP: usize = 32;
+
+    #[inline(always)]
+    unsafe fn lanes_pd(v: __m512d) -> [f64; 8] {
+        let mut out = [0.0f64; 8];
+        _mm512_storeu_pd(out.as_mut_ptr(), v);
+        out
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn sum_f64(values: &[f64]) -> f64 {
+        let mut acc = [_mm512_setzero_pd(); 4];
+        let mut chunks = values.chunks_exact(STEP);
+        for chunk in &mut chunks {
+            let p = chunk.as_ptr();
+            for (lane, a) in acc.iter_mut().enumerate() {
+                *a = _mm512_add_pd(*a, _mm512_loadu_pd(p.add(lane * 8)));
+            }
+        }
+        let total = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+        _mm512_reduce_add_pd(total) + scalar::sum_f64(chunks.remainder())
+    }
+
+    /// Lane-wise scalar::min_of, see avx2::min_of_pd
+    #[inline(always)]
+    unsafe fn min_of_pd(acc: __m512d, x: __m512d) -> __m512d {
+        _mm512_mask_blend_pd(_mm512_cmp_pd_mask::<_CMP_UNORD_Q>(acc, acc), _mm512_min_pd(x, acc), x)
+    }
+
+    /// Lane-wise scalar::max_of, see avx2::min_of_pd
+    #[inline(always)]
+    unsafe fn max_of_pd(acc: __m512d, x: __m512d) -> __m512d {
+        _mm512_mask_blend_pd(_mm512_cmp_pd_mask::<_CMP_UNORD_Q>(acc, acc), _mm512_max_pd(x, acc), x)
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn min_f64(values: &[f64]) -> f64 {
+        let mut acc = _mm512_set1_pd(f64::NAN);
+        let mut chunks = values.chunks_exact(8);
+        for chunk in &mut chunks {
+            acc = min_of_pd(acc, _mm512_loadu_pd(chunk.as_ptr()));
+        }
+        lanes_pd(acc)
+            .iter()
+            .fold(scalar::min_f64(chunks.remainder()), |m, &v| scalar::min_of(m, v))
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn max_f64(values: &[f64]) -> f64 {
+        let mut acc = _mm512_set1_pd(f64::NAN);
+        let mut chunks = values.chunks_exact(8);
+        for chunk in &mut chunks {
+            acc = max_of_pd(acc, _mm512_loadu_pd(chunk.as_ptr()));
+        }
+        lanes_pd(acc)
+            .iter()
+            .fold(scalar::max_f64(chunks.remainder()), |m, &v| scalar::max_of(m, v))
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn dot_f64(a: &[f64], b: &[f64]) -> f64 {
+        let len = a.len().min(b.len());
+        let body = len - len % STEP;
+        let mut acc = [_mm512_setzero_pd(); 4];
+        let (pa, pb) = (a.as_ptr(), b.as_ptr());
+        let mut i = 0;
+        while i < body {
+            for (lane, s) in acc.iter_mut().enumerate() {
+                let offset = i + lane * 8;
+                *s = _mm512_fmadd_pd(_mm512_loadu_pd(pa.add(offset)), _mm512_loadu_pd(pb.add(offset)), *s);
+            }
+            i += STEP;
+        }
+        let total = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+        _mm512_reduce_add_pd(total) + scalar::dot_f64(&a[body..len], &b[body..len])
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn squared_deviation_f64(values: &[f64], mean: f64) -> f64 {
+        let center = _mm512_set1_pd(mean);
+        let mut acc = _mm512_setzero_pd();
+        let mut chunks = values.chunks_exact(8);
+        for chunk in &mut chunks {
+            let d = _mm512_sub_pd(_mm512_loadu_pd(chunk.as_ptr()), center);
+            acc = _mm512_fmadd_pd(d, d, acc);
+        }
+        _mm512_reduce_add_pd(acc) + scalar::squared_deviation_f64(chunks.remainder(), mean)
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn sqrt_in_place(values: &mut [f64]) {
+        let mut chunks = values.chunks_exact_mut(8);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            _mm512_storeu_pd(p, _mm512_sqrt_pd(_mm512_loadu_pd(p)));
+        }
+        scalar::sqrt_in_place(chunks.into_remainder());
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub unsafe fn clamp_f64_in_place(values: &mut [f64], min: f64, max: f64) {
+        let (lo, hi) = (_mm512_set1_pd(min), _mm512_set1_pd(max));
+        let mut chunks = values.chunks_exact_mut(8);
+        for chunk in &mut chunks {
+            let p = chunk.as_mut_ptr();
+            let upper = _mm512_min_pd(hi, _mm512_loadu_pd(p));
+            _mm512_storeu_pd(p, _mm512_max_pd(lo, upper));
+        }
+        scalar::clamp_f64_in_place(chunks.into_remainder(), min, max);
+    }
+
+    pub use super::avx2::{
+        clamp_i64_in_place, exp_in_place, ln_in_place, max_i64, min_i64, squared_deviation_i64, sum_i64,
+        sum_i64_as_f64,
+    };
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn floats(len: usize) -> Vec<f64> {
+        (0..len).map(|i| ((i * 37) % 101) as f64 - 50.25).collect()
+    }
+
+    fn ints(len: usize) -> Vec<i64> {
+        (0..len).map(|i| ((i as i64 * 7919) % 2003) - 1000).collect()
+    }
+
+    #[test]
+    fn test_reductions_match_scalar() {
+        // Odd lengths exercise the remainder loops; the large one goes parallel
+        for len in [0, 1, 3, 17, 1031, PARALLEL_THRESHOLD + 7] {
+            let f = floats(len);
+            let i = ints(len);
+
+            let expected: f64 = f.iter().sum();
+            assert!((sum_f64(&f) - expected).abs() <= 1e-6 * expected.abs().max(1.0));
+            assert_eq!(sum_i64(&i), i.iter().sum::<i64>());
+            assert_eq!(min_i64(&i), i.iter().copied().min());
+            assert_eq!(max_i64(&i), i.iter().copied().max());
+            assert_eq!(min_f64(&f), f.iter().copied().reduce(f64::min));
+            assert_eq!(max_f64(&f), f.iter().copied().reduce(f64::max));
+
+            let dot: f64 = f.iter().map(|v| v * v).sum();
+            assert!((dot_f64(&f, &f) - dot).abs() <= 1e-9 * dot.max(1.0));
+        }
+    }
+
+    #[test]
+    fn test_mean_and_variance() {
+        assert_eq!(mean_f64(&[]), None);
+        assert_eq!(mean_f64(&[1.0, 2.0, 3.0, 4.0]), Some(2.5));
+        assert_eq!(variance_f64(&[2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0]), Some(4.0));
+        assert_eq!(mean_i64(&[1, 2, 3, 4]), Some(2.5));
+        assert_eq!(variance_i64(&[2, 4, 4, 4, 5, 5, 7, 9]), Some(4.0));
+    }
+
+    #[test]
+    fn test_element_wise_kernels() {
+        let mut values: Vec<f64> = (0..37).map(|i| (i * i) as f64).collect();
+        sqrt_in_place(&mut values);
+        assert!(values.iter().enumerate().all(|(i, &v)| v == i as f64));
+
+        let mut values = vec![-3.0, 0.5, 7.0, f64::NAN, 2.0];
+        clamp_f64_in_place(&mut values, 0.0, 2.0);
+        assert_eq!(&values[..3], &[0.0, 0.5, 2.0]);
+        assert!(values[3].is_nan());
+
+        let mut values = ints(1031);
+        clamp_i64_in_place(&mut values, -10, 10);
+        assert!(values.iter().all(|&v| (-10..=10).contains(&v)));
+
+        let mut values = vec![0.0, 1.0];
+        exp_in_place(&mut values);
+        ln_in_place(&mut values);
+        assert!((values[1] - 1.0).abs() < 1e-12);
+    }
+
+    #[test]
+    fn test_nan_is_skipped_by_min_max() {
+        let values = [f64::NAN, 3.0, -1.0, f64::NAN];
+        assert_eq!(min_f64(&values), Some(-1.0));
+        assert_eq!(max_f64(&values), Some(3.0));
+
+        // All-NaN input yields NaN on the SIMD body and the scalar tail alike
+        for len in [3, 40] {
+            let values = vec![f64::NAN; len];
+            assert!(min_f64(&values).unwrap().is_nan());
+            assert!(max_f64(&values).unwrap().is_nan());
+        }
+    }
+
+    #[test]
+    fn test_exp_ln_match_libm() {
+        let mut inputs: Vec<f64> = (0..2000).map(|i| (i as f64 - 1000.0) * 0.7123).collect();
+        inputs.extend([0.0, -0.0, 1e-300, 709.5, -745.0, f64::INFINITY, f64::NEG_INFINITY, f64::NAN]);
+
+        let mut values = inputs.clone();
+        exp_in_place(&mut values);
+        for (&x, &y) in inputs.iter().zip(&values) {
+            let expected = x.exp();
+            assert!(y == expected || (y - expected).abs() <= 4.0 * f64::EPSILON * expected.abs() || (y.is_nan() && expected.is_nan()), "exp({}) = {}, 期望 {}", x, y, expected);
+        }
+
+        let mut values = inputs.clone();
+        ln_in_place(&mut values);
+        for (&x, &y) in inputs.iter().zip(&values) {
+            let expected = x.ln();
+            assert!(y == expected || (y - expected).abs() <= 4.0 * f64::EPSILON * expected.abs().max(1.0) || (y.is_nan() && expected.is_nan()), "ln({}) = {}, 期望 {}", x, y, expected);
+        }
+    }
+
+    #[test]
+    fn test_integer_statistics_match_scalar() {
+        let mut values = ints(1031);
+        values.extend([i64::MAX, i64::MIN, i64::MAX - 1, 1 << 53, -(1 << 60) - 3]);
+        let expected_mean = values.iter().map(|&v| v as f64).sum::<f64>() / values.len() as f64;
+        let mean = mean_i64(&values).unwrap();
+        assert!((mean - expected_mean).abs() <= 1e-9 * expected_mean.abs());
+
+        let values = ints(1031);
+        let mean = mean_i64(&values).unwrap();
+        let expected: f64 = values.iter().map(|&v| (v as f64 - mean).powi(2)).sum::<f64>() / values.len() as f64;
+        assert!((variance_i64(&values).unwrap() - expected).abs() <= 1e-9 * expected);
+    }
+}
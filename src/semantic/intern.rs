@@ -0,0 +1,269 @@
+//! Interned names and hash-consed types for semantic analysis
+//! 语义分析使用的名称驻留与类型哈希共享
+//!
+//! Every distinct identifier is stored once and referred to by a [`Name`];
+//! every distinct [`TypeNode`] is stored once and referred to by a
+//! [`TypeId`]. Both ids are plain `u32`s, so the symbol table can index
+//! flat vectors with them and the type checker can compare types with `==`
+//! on an integer instead of walking two trees.
+
+use crate::parser::ast::{BasicType, TypeNode};
+use std::collections::HashMap;
+use std::hash::{BuildHasherDefault, Hasher};
+
+/// Multiply-rotate hasher for short keys
+///
+/// Identifiers and type nodes are small and not attacker controlled, so
+/// SipHash's DoS resistance buys nothing here.
+#[derive(Default, Clone, Copy)]
+pub struct FxHasher {
+    hash: u64,
+}
+
+const SEED: u64 = 0x51_7c_c1_b7_27_22_0a_95;
+
+impl FxHasher {
+    #[inline]
+    fn add(&mut self, word: u64) {
+        self.hash = (self.hash.rotate_left(5) ^ word).wrapping_mul(SEED);
+    }
+}
+
+impl Hasher for FxHasher {
+    #[inline]
+    fn write(&mut self, bytes: &[u8]) {
+        let mut chunks = bytes.chunks_exact(8);
+        for chunk in &mut chunks {
+            self.add(u64::from_le_bytes(chunk.try_into().unwrap()));
+        }
+        let rest = chunks.remainder();
+        if !rest.is_empty() {
+            let mut word = [0u8; 8];
+            word[..rest.len()].copy_from_slice(rest);
+            self.add(u64::from_le_bytes(word));
+        }
+    }
+
+    #[inline]
+    fn write_u8(&mut self, i: u8) {
+        self.add(i as u64);
+    }
+
+    #[inline]
+    fn write_u32(&mut self, i: u32) {
+        self.add(i as u64);
+    }
+
+    #[inline]
+    fn write_u64(&mut self, i: u64) {
+        self.add(i);
+    }
+
+    #[inline]
+    fn write_usize(&mut self, i: usize) {
+        self.add(i as u64);
+    }
+
+    #[inline]
+    fn finish(&self) -> u64 {
+        self.hash
+    }
+}
+
+pub type FxBuildHasher = BuildHasherDefault<FxHasher>;
+pub type FxHashMap<K, V> = HashMap<K, V, FxBuildHasher>;
+
+/// Interned identifier
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct Name(u32);
+
+impl Name {
+    #[inline]
+    pub fn index(self) -> usize {
+        self.0 as usize
+    }
+}
+
+/// Identifier interner
+#[derive(Debug, Clone, Default)]
+pub struct NameInterner {
+    ids: FxHashMap<Box<str>, Name>,
+    names: Vec<Box<str>>,
+}
+
+impl NameInterner {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Intern `text`, allocating only the first time it is seen
+    pub fn intern(&mut self, text: &str) -> Name {
+        if let Some(&name) = self.ids.get(text) {
+            return name;
+        }
+        let name = Name(self.names.len() as u32);
+        self.names.push(text.into());
+        self.ids.insert(text.into(), name);
+        name
+    }
+
+    /// Look up `text` without interning it
+    pub fn get(&self, text: &str) -> Option<Name> {
+        self.ids.get(text).copied()
+    }
+
+    pub fn resolve(&self, name: Name) -> &str {
+        &self.names[name.index()]
+    }
+
+    pub fn len(&self) -> usize {
+        self.names.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.names.is_empty()
+    }
+}
+
+/// Hash-consed type
+///
+/// Two ids from the same [`TypeTable`] are equal exactly when the type
+/// nodes they stand for are equal.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct TypeId(u32);
+
+/// Basic types in declaration order, which is also the order
+/// [`TypeTable::new`] interns them in
+const BASIC_TYPES: [BasicType; 16] = [
+    BasicType::整数,
+    BasicType::长整数,
+    BasicType::短整数,
+    BasicType::字节,
+    BasicType::浮点数,
+    BasicType::布尔,
+    BasicType::字符,
+    BasicType::字符串,
+    BasicType::空,
+    BasicType::数组,
+    BasicType::字典,
+    BasicType::列表,
+    BasicType::集合,
+    BasicType::指针,
+    BasicType::引用,
+    BasicType::可变引用,
+];
+
+#[allow(non_upper_case_globals)]
+impl TypeId {
+    pub const 整数: TypeId = TypeId(0);
+    pub const 长整数: TypeId = TypeId(1);
+    pub const 短整数: TypeId = TypeId(2);
+    pub const 字节: TypeId = TypeId(3);
+    pub const 浮点数: TypeId = TypeId(4);
+    pub const 布尔: TypeId = TypeId(5);
+    pub const 字符: TypeId = TypeId(6);
+    pub const 字符串: TypeId = TypeId(7);
+    pub const 空: TypeId = TypeId(8);
+}
+
+/// Hash-consing table for [`TypeNode`]s
+#[derive(Debug, Clone)]
+pub struct TypeTable {
+    ids: FxHashMap<TypeNode, TypeId>,
+    nodes: Vec<TypeNode>,
+}
+
+impl TypeTable {
+    /// Create a table with every basic type pre-interned, so the
+    /// `TypeId::整数`-style constants are valid without a lookup
+    pub fn new() -> Self {
+        let mut table = Self {
+            ids: FxHashMap::default(),
+            nodes: Vec::new(),
+        };
+        for basic in BASIC_TYPES {
+            table.intern(&TypeNode::基础类型(basic));
+        }
+        table
+    }
+
+    /// Intern `node`; it is only copied the first time it is seen
+    pub fn intern(&mut self, node: &TypeNode) -> TypeId {
+        if let Some(&id) = self.ids.get(node) {
+            return id;
+        }
+        let id = TypeId(self.nodes.len() as u32);
+        self.nodes.push(node.clone());
+        self.ids.insert(node.clone(), id);
+        id
+    }
+
+    pub fn basic(&self, basic: BasicType) -> TypeId {
+        TypeId(basic as u32)
+    }
+
+    pub fn get(&self, id: TypeId) -> &TypeNode {
+        &self.nodes[id.0 as usize]
+    }
+
+    pub fn len(&self) -> usize {
+        self.nodes.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.nodes.is_empty()
+    }
+}
+
+impl Default for TypeTable {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parser::ast::ArrayType;
+
+    #[test]
+    fn test_name_interning() {
+        let mut names = NameInterner::new();
+        let a = names.intern("计数");
+        let b = names.intern("总和");
+        assert_ne!(a, b);
+        assert_eq!(names.intern("计数"), a);
+        assert_eq!(names.get("总和"), Some(b));
+        assert_eq!(names.get("未见过"), None);
+        assert_eq!(names.resolve(a), "计数");
+        assert_eq!(names.len(), 2);
+    }
+
+    #[test]
+    fn test_primitive_type_constants() {
+        let table = TypeTable::new();
+        assert_eq!(table.get(TypeId::整数), &TypeNode::基础类型(BasicType::整数));
+        assert_eq!(table.get(TypeId::字符串), &TypeNode::基础类型(BasicType::字符串));
+        assert_eq!(table.get(TypeId::空), &TypeNode::基础类型(BasicType::空));
+        assert_eq!(table.basic(BasicType::布尔), TypeId::布尔);
+        for basic in BASIC_TYPES {
+            assert_eq!(table.get(table.basic(basic)), &TypeNode::基础类型(basic));
+        }
+    }
+
+    #[test]
+    fn test_type_hashes_are_shared() {
+        let mut table = TypeTable::new();
+        let array = |size| TypeNode::数组类型(ArrayType {
+            element_type: Box::new(TypeNode::基础类型(BasicType::整数)),
+            size,
+        });
+        let a = table.intern(&array(Some(3)));
+        let b = table.intern(&array(Some(3)));
+        let c = table.intern(&array(None));
+        assert_eq!(a, b);
+        assert_ne!(a, c);
+        assert_eq!(table.intern(&TypeNode::基础类型(BasicType::整数)), TypeId::整数);
+        assert_eq!(table.get(a), &array(Some(3)));
+    }
+}
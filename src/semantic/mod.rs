@@ -1,12 +1,14 @@
 //! Type checking and semantic analysis for Qi language
 //! 类型检查和语义分析
 
+pub mod intern;
 pub mod scope;
 pub mod symbol_table;
 pub mod type_checker;
 pub mod module;
 pub mod methods;
 
+pub use intern::{Name, TypeId};
 pub use symbol_table::SymbolTable;
 pub use type_checker::TypeChecker;
 use crate::parser::AstNode;
@@ -140,10 +142,10 @@ impl SemanticAnalyzer {
         let condition_type = self.type_checker.check(&if_stmt.condition)
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
-        if !self.is_boolean_type(&condition_type) {
+        if !self.is_boolean_type(condition_type) {
             return Err(SemanticError::TypeMismatch(
                 "条件必须是布尔类型".to_string(),
-                format!("{:?}", condition_type)
+                self.describe(condition_type)
             ));
         }
 
@@ -178,10 +180,10 @@ impl SemanticAnalyzer {
         let condition_type = self.type_checker.check(&while_stmt.condition)
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
-        if !self.is_boolean_type(&condition_type) {
+        if !self.is_boolean_type(condition_type) {
             return Err(SemanticError::TypeMismatch(
                 "循环条件必须是布尔类型".to_string(),
-                format!("{:?}", condition_type)
+                self.describe(condition_type)
             ));
         }
 
@@ -238,31 +240,25 @@ impl SemanticAnalyzer {
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
         // Range should be array-like
-        match range_type {
-            crate::parser::ast::TypeNode::数组类型(_) => {
-                // Good, range is an array
-            }
-            _ => {
+        let element_type = match self.type_checker.type_node(range_type) {
+            crate::parser::ast::TypeNode::数组类型(array_type) => (*array_type.element_type).clone(),
+            other => {
                 return Err(SemanticError::TypeMismatch(
                     "对于循环期望数组类型".to_string(),
-                    format!("{:?}", range_type)
+                    format!("{:?}", other)
                 ));
             }
-        }
+        };
+        let element_type = self.type_checker.symbol_table.intern_type(&element_type);
 
         // Enter loop body scope
         self.type_checker.symbol_table.enter_scope();
 
         // Add loop variable to scope with array element type
-        let element_type = match &range_type {
-            crate::parser::ast::TypeNode::数组类型(array_type) => *array_type.element_type.clone(),
-            _ => crate::parser::ast::TypeNode::基础类型(crate::parser::ast::BasicType::空),
-        };
-
         let loop_var_symbol = crate::semantic::symbol_table::Symbol {
-            name: for_stmt.variable.clone(),
+            name: self.type_checker.symbol_table.intern(&for_stmt.variable),
             kind: crate::semantic::symbol_table::SymbolKind::变量,
-            type_node: element_type.clone(),
+            type_id: element_type,
             scope_level: self.type_checker.symbol_table.current_scope(),
             span: for_stmt.span,
             is_mutable: false,
@@ -339,10 +335,10 @@ impl SemanticAnalyzer {
 
             let expected_type = &func_info.parameters[i].type_annotation;
             if let Some(expected) = expected_type {
-                if &arg_type != expected {
+                if arg_type != self.type_checker.symbol_table.intern_type(expected) {
                     return Err(SemanticError::TypeMismatch(
-                        format!("参数 {} 类型不匹配: 期望 {:?}, 实际 {:?}",
-                            i + 1, expected, arg_type),
+                        format!("参数 {} 类型不匹配: 期望 {:?}, 实际 {}",
+                            i + 1, expected, self.describe(arg_type)),
                         "".to_string()
                     ));
                 }
@@ -357,8 +353,13 @@ impl SemanticAnalyzer {
     }
 
     /// Check if a type is boolean
-    fn is_boolean_type(&self, type_node: &crate::parser::ast::TypeNode) -> bool {
-        matches!(type_node, crate::parser::ast::TypeNode::基础类型(crate::parser::ast::BasicType::布尔))
+    fn is_boolean_type(&self, type_id: TypeId) -> bool {
+        type_id == TypeId::布尔
+    }
+
+    /// Debug rendering of an interned type for error messages
+    fn describe(&self, type_id: TypeId) -> String {
+        format!("{:?}", self.type_checker.type_node(type_id))
     }
 
     /// Analyze array access expression: array[index]
@@ -368,13 +369,13 @@ impl SemanticAnalyzer {
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
         // Check that array is actually an array type
-        match array_type {
+        match self.type_checker.type_node(array_type) {
             crate::parser::ast::TypeNode::数组类型(_) => {
                 // Good, it's an array
             }
-            _ => {
+            other => {
                 return Err(SemanticError::TypeMismatch(
-                    format!("期望数组类型，实际 {:?}", array_type),
+                    format!("期望数组类型，实际 {:?}", other),
                     "".to_string()
                 ));
             }
@@ -384,10 +385,10 @@ impl SemanticAnalyzer {
         let index_type = self.type_checker.check(&array_access.index)
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
-        if !self.is_integer_type(&index_type) {
+        if !self.is_integer_type(index_type) {
             return Err(SemanticError::TypeMismatch(
                 "数组索引必须是整数类型".to_string(),
-                format!("{:?}", index_type)
+                self.describe(index_type)
             ));
         }
 
@@ -412,8 +413,8 @@ impl SemanticAnalyzer {
 
             if element_type != first_type {
                 return Err(SemanticError::TypeMismatch(
-                    format!("数组元素类型不匹配: 元素 {} 类型 {:?} 与第一个元素类型 {:?} 不匹配",
-                        i + 1, element_type, first_type),
+                    format!("数组元素类型不匹配: 元素 {} 类型 {} 与第一个元素类型 {} 不匹配",
+                        i + 1, self.describe(element_type), self.describe(first_type)),
                     "".to_string()
                 ));
             }
@@ -433,10 +434,10 @@ impl SemanticAnalyzer {
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
         // At least one operand should be a string
-        if !self.is_string_type(&left_type) && !self.is_string_type(&right_type) {
+        if !self.is_string_type(left_type) && !self.is_string_type(right_type) {
             return Err(SemanticError::TypeMismatch(
                 "字符串连接至少需要一个操作数是字符串类型".to_string(),
-                format!("左操作数类型: {:?}, 右操作数类型: {:?}", left_type, right_type)
+                format!("左操作数类型: {}, 右操作数类型: {}", self.describe(left_type), self.describe(right_type))
             ));
         }
 
@@ -444,13 +445,13 @@ impl SemanticAnalyzer {
     }
 
     /// Check if a type is integer
-    fn is_integer_type(&self, type_node: &crate::parser::ast::TypeNode) -> bool {
-        matches!(type_node, crate::parser::ast::TypeNode::基础类型(crate::parser::ast::BasicType::整数))
+    fn is_integer_type(&self, type_id: TypeId) -> bool {
+        type_id == TypeId::整数
     }
 
     /// Check if a type is string
-    fn is_string_type(&self, type_node: &crate::parser::ast::TypeNode) -> bool {
-        matches!(type_node, crate::parser::ast::TypeNode::基础类型(crate::parser::ast::BasicType::字符串))
+    fn is_string_type(&self, type_id: TypeId) -> bool {
+        type_id == TypeId::字符串
     }
 
     /// Analyze struct declaration
@@ -463,21 +464,24 @@ impl SemanticAnalyzer {
         };
 
         // Add struct type to symbol table
+        let struct_type = self.type_checker.symbol_table.intern_type(
+            &crate::parser::ast::TypeNode::结构体类型(struct_type)
+        );
         let symbol = crate::semantic::symbol_table::Symbol {
-            name: struct_decl.name.clone(),
+            name: self.type_checker.symbol_table.intern(&struct_decl.name),
             kind: crate::semantic::symbol_table::SymbolKind::类型(
                 crate::semantic::symbol_table::TypeInfo {
                     definition: crate::semantic::symbol_table::TypeDefinition {},
                     is_builtin: false,
                 }
             ),
-            type_node: crate::parser::ast::TypeNode::结构体类型(struct_type),
+            type_id: struct_type,
             scope_level: self.type_checker.symbol_table.current_scope(),
             span: struct_decl.span,
             is_mutable: false,
         };
 
-        self.type_checker.symbol_table.define_symbol(symbol.clone())
+        self.type_checker.symbol_table.define_symbol(symbol)
             .map_err(|e| SemanticError::ScopeError(e.to_string()))?;
 
         Ok(())
@@ -505,21 +509,24 @@ impl SemanticAnalyzer {
         };
 
         // Add enum type to symbol table
+        let enum_type = self.type_checker.symbol_table.intern_type(
+            &crate::parser::ast::TypeNode::枚举类型(enum_type)
+        );
         let symbol = crate::semantic::symbol_table::Symbol {
-            name: enum_decl.name.clone(),
+            name: self.type_checker.symbol_table.intern(&enum_decl.name),
             kind: crate::semantic::symbol_table::SymbolKind::类型(
                 crate::semantic::symbol_table::TypeInfo {
                     definition: crate::semantic::symbol_table::TypeDefinition {},
                     is_builtin: false,
                 }
             ),
-            type_node: crate::parser::ast::TypeNode::枚举类型(enum_type),
+            type_id: enum_type,
             scope_level: self.type_checker.symbol_table.current_scope(),
             span: enum_decl.span,
             is_mutable: false,
         };
 
-        self.type_checker.symbol_table.define_symbol(symbol.clone())
+        self.type_checker.symbol_table.define_symbol(symbol)
             .map_err(|e| SemanticError::ScopeError(e.to_string()))?;
 
         Ok(())
@@ -539,7 +546,7 @@ impl SemanticAnalyzer {
         };
 
         // Extract struct type if it's a struct
-        let struct_type = match &symbol.type_node {
+        let struct_type = match self.type_checker.type_node(symbol.type_id) {
             crate::parser::ast::TypeNode::结构体类型(struct_type) => struct_type.clone(),
             _ => {
                 return Err(SemanticError::TypeMismatch(
@@ -571,10 +578,10 @@ impl SemanticAnalyzer {
                 let provided_type = self.type_checker.check(&provided_field.value)
                     .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
-                if provided_type != expected_field.type_annotation {
+                if provided_type != self.type_checker.symbol_table.intern_type(&expected_field.type_annotation) {
                     return Err(SemanticError::TypeMismatch(
-                        format!("字段 '{}' 类型不匹配: 期望 {:?}, 实际 {:?}",
-                            provided_field.name, expected_field.type_annotation, provided_type),
+                        format!("字段 '{}' 类型不匹配: 期望 {:?}, 实际 {}",
+                            provided_field.name, expected_field.type_annotation, self.describe(provided_type)),
                         "".to_string()
                     ));
                 }
@@ -596,7 +603,7 @@ impl SemanticAnalyzer {
             .map_err(|e| SemanticError::TypeMismatch(e.to_string(), "".to_string()))?;
 
         // Check that object is a struct type
-        match object_type {
+        match self.type_checker.type_node(object_type) {
             crate::parser::ast::TypeNode::结构体类型(struct_type) => {
                 // Check that field exists
                 let field_exists = struct_type.fields.iter()
@@ -1,5 +1,6 @@
 //! Scope management for Qi language
 
+use crate::semantic::intern::Name;
 use crate::semantic::symbol_table::Symbol;
 use crate::lexer::Span;
 
@@ -56,7 +57,7 @@ impl ScopeManager {
         }
     }
 
-    pub fn find_symbol(&self, name: &str) -> Option<&Symbol> {
+    pub fn find_symbol(&self, name: Name) -> Option<&Symbol> {
         let mut current_scope = self.current_scope;
 
         loop {
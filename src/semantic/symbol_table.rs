@@ -1,8 +1,16 @@
 //! Symbol table management for Qi language
+//!
+//! Names are interned, and the table keeps one flat slot per [`Name`]
+//! pointing at the innermost visible symbol with that name. Each symbol
+//! records the binding it shadowed, and symbols are pushed onto a single
+//! stack in definition order, which doubles as the undo log: leaving a
+//! scope pops that scope's symbols and restores whatever they shadowed.
+//! Lookups are one slot read, and popping a scope costs only the symbols
+//! it defined.
 
 use crate::parser::ast::TypeNode;
 use crate::lexer::Span;
-use std::collections::HashMap;
+use crate::semantic::intern::{Name, NameInterner, TypeId, TypeTable};
 
 /// Symbol kinds
 #[derive(Debug, Clone)]
@@ -17,7 +25,7 @@ pub enum SymbolKind {
 #[derive(Debug, Clone)]
 pub struct FunctionInfo {
     pub parameters: Vec<crate::parser::ast::Parameter>,
-    pub return_type: TypeNode,
+    pub return_type: TypeId,
     pub is_defined: bool,
 }
 
@@ -37,19 +45,32 @@ pub struct TypeDefinition {
 /// Symbol entry
 #[derive(Debug, Clone)]
 pub struct Symbol {
-    pub name: String,
+    pub name: Name,
     pub kind: SymbolKind,
-    pub type_node: TypeNode,
+    pub type_id: TypeId,
     pub scope_level: usize,
     pub span: Span,
     pub is_mutable: bool,
 }
 
+/// Defined symbol together with the binding it shadows
+#[derive(Debug, Clone)]
+struct Entry {
+    symbol: Symbol,
+    shadowed: Option<u32>,
+}
+
 /// Symbol table
 #[derive(Clone)]
 pub struct SymbolTable {
-    symbols: HashMap<String, Vec<Symbol>>,
-    current_scope: usize,
+    names: NameInterner,
+    types: TypeTable,
+    /// Innermost visible entry for each interned name
+    bindings: Vec<Option<u32>>,
+    /// Live symbols in definition order; popped when their scope exits
+    entries: Vec<Entry>,
+    /// Length of `entries` when each open scope was entered
+    scope_marks: Vec<usize>,
     errors: Vec<ScopeError>,
 }
 
@@ -75,47 +96,84 @@ pub enum ScopeError {
 impl SymbolTable {
     pub fn new() -> Self {
         Self {
-            symbols: HashMap::new(),
-            current_scope: 0,
+            names: NameInterner::new(),
+            types: TypeTable::new(),
+            bindings: Vec::new(),
+            entries: Vec::new(),
+            scope_marks: Vec::new(),
             errors: Vec::new(),
         }
     }
 
     pub fn enter_scope(&mut self) {
-        self.current_scope += 1;
+        self.scope_marks.push(self.entries.len());
     }
 
     pub fn exit_scope(&mut self) {
-        self.symbols.retain(|_, symbols| {
-            symbols.last().map_or(true, |sym| sym.scope_level <= self.current_scope - 1)
-        });
-        self.current_scope = self.current_scope.saturating_sub(1);
+        let Some(mark) = self.scope_marks.pop() else {
+            return;
+        };
+        while self.entries.len() > mark {
+            let entry = self.entries.pop().unwrap();
+            self.bindings[entry.symbol.name.index()] = entry.shadowed;
+        }
+    }
+
+    /// Intern an identifier
+    pub fn intern(&mut self, name: &str) -> Name {
+        let name = self.names.intern(name);
+        if name.index() >= self.bindings.len() {
+            self.bindings.resize(name.index() + 1, None);
+        }
+        name
+    }
+
+    pub fn name(&self, name: Name) -> &str {
+        self.names.resolve(name)
+    }
+
+    /// Hash-cons a type
+    pub fn intern_type(&mut self, type_node: &TypeNode) -> TypeId {
+        self.types.intern(type_node)
+    }
+
+    pub fn type_node(&self, id: TypeId) -> &TypeNode {
+        self.types.get(id)
+    }
+
+    pub fn types(&self) -> &TypeTable {
+        &self.types
     }
 
     pub fn define_symbol(&mut self, symbol: Symbol) -> Result<(), ScopeError> {
-        if let Some(existing_symbols) = self.symbols.get(&symbol.name) {
-            if let Some(existing) = existing_symbols.iter()
-                .find(|sym| sym.scope_level == self.current_scope) {
+        let slot = symbol.name.index();
+        let scope_start = self.scope_marks.last().copied().unwrap_or(0);
+        let shadowed = self.bindings[slot];
+
+        if let Some(existing) = shadowed {
+            if existing as usize >= scope_start {
                 return Err(ScopeError::NameConflict {
-                    name: symbol.name.clone(),
-                    existing_span: existing.span,
+                    name: self.names.resolve(symbol.name).to_string(),
+                    existing_span: self.entries[existing as usize].symbol.span,
                     new_span: symbol.span,
                 });
             }
         }
 
-        self.symbols.entry(symbol.name.clone())
-            .or_insert_with(Vec::new)
-            .push(symbol);
+        self.bindings[slot] = Some(self.entries.len() as u32);
+        self.entries.push(Entry { symbol, shadowed });
 
         Ok(())
     }
 
     pub fn lookup_symbol(&self, name: &str) -> Option<&Symbol> {
-        self.symbols.get(name)
-            .and_then(|symbols| symbols.iter()
-                .filter(|sym| sym.scope_level <= self.current_scope)
-                .max_by_key(|sym| sym.scope_level))
+        self.lookup(self.names.get(name)?)
+    }
+
+    /// Look up an already interned name
+    pub fn lookup(&self, name: Name) -> Option<&Symbol> {
+        let entry = (*self.bindings.get(name.index())?)?;
+        Some(&self.entries[entry as usize].symbol)
     }
 
     pub fn get_errors(&self) -> &[ScopeError] {
@@ -123,7 +181,7 @@ impl SymbolTable {
     }
 
     pub fn current_scope(&self) -> usize {
-        self.current_scope
+        self.scope_marks.len()
     }
 }
 
@@ -131,4 +189,101 @@ impl Default for SymbolTable {
     fn default() -> Self {
         Self::new()
     }
-}
\ No newline at end of file
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parser::ast::BasicType;
+
+    fn 变量(table: &mut SymbolTable, name: &str, type_id: TypeId, start: usize) -> Symbol {
+        Symbol {
+            name: table.intern(name),
+            kind: SymbolKind::变量,
+            type_id,
+            scope_level: table.current_scope(),
+            span: Span::new(start, start + name.len()),
+            is_mutable: false,
+        }
+    }
+
+    #[test]
+    fn test_shadowing_and_restore() {
+        let mut table = SymbolTable::new();
+        table.enter_scope();
+        let outer = 变量(&mut table, "x", TypeId::整数, 0);
+        table.define_symbol(outer).unwrap();
+
+        table.enter_scope();
+        let inner = 变量(&mut table, "x", TypeId::字符串, 10);
+        table.define_symbol(inner).unwrap();
+        assert_eq!(table.lookup_symbol("x").unwrap().type_id, TypeId::字符串);
+        assert_eq!(table.current_scope(), 2);
+
+        // 退出内层作用域后外层的 x 重新可见
+        table.exit_scope();
+        assert_eq!(table.lookup_symbol("x").unwrap().type_id, TypeId::整数);
+
+        table.exit_scope();
+        assert!(table.lookup_symbol("x").is_none());
+        assert_eq!(table.current_scope(), 0);
+    }
+
+    #[test]
+    fn test_duplicate_definition_in_same_scope() {
+        let mut table = SymbolTable::new();
+        table.enter_scope();
+        let first = 变量(&mut table, "总和", TypeId::整数, 0);
+        table.define_symbol(first).unwrap();
+        let second = 变量(&mut table, "总和", TypeId::整数, 20);
+        match table.define_symbol(second) {
+            Err(ScopeError::NameConflict { name, existing_span, new_span }) => {
+                assert_eq!(name, "总和");
+                assert_eq!(existing_span.start, 0);
+                assert_eq!(new_span.start, 20);
+            }
+            other => panic!("期望名称冲突, 实际 {:?}", other),
+        }
+    }
+
+    #[test]
+    fn test_exit_scope_only_undoes_its_own_definitions() {
+        let mut table = SymbolTable::new();
+        table.enter_scope();
+        let a = 变量(&mut table, "a", TypeId::整数, 0);
+        table.define_symbol(a).unwrap();
+
+        table.enter_scope();
+        let b = 变量(&mut table, "b", TypeId::布尔, 5);
+        table.define_symbol(b).unwrap();
+        assert!(table.lookup_symbol("a").is_some());
+        table.exit_scope();
+
+        assert!(table.lookup_symbol("a").is_some());
+        assert!(table.lookup_symbol("b").is_none());
+
+        // 退出后可以在外层重新定义同名符号
+        table.enter_scope();
+        let b = 变量(&mut table, "b", TypeId::浮点数, 30);
+        table.define_symbol(b).unwrap();
+        assert_eq!(table.lookup_symbol("b").unwrap().type_id, TypeId::浮点数);
+    }
+
+    #[test]
+    fn test_types_compare_by_id() {
+        let mut table = SymbolTable::new();
+        let int = table.intern_type(&TypeNode::基础类型(BasicType::整数));
+        assert_eq!(int, TypeId::整数);
+        assert_eq!(table.type_node(int), &TypeNode::基础类型(BasicType::整数));
+    }
+
+    #[test]
+    fn test_extra_exit_is_harmless() {
+        let mut table = SymbolTable::new();
+        table.exit_scope();
+        assert_eq!(table.current_scope(), 0);
+        let x = 变量(&mut table, "x", TypeId::整数, 0);
+        table.define_symbol(x).unwrap();
+        assert!(table.lookup_symbol("x").is_some());
+    }
+}
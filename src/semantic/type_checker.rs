@@ -1,6 +1,7 @@
 //! Type checking and inference for Qi language
 
 use crate::parser::ast::{AstNode, TypeNode, BasicType};
+use crate::semantic::intern::TypeId;
 use crate::semantic::symbol_table::SymbolTable;
 
 /// Type checker
@@ -65,7 +66,28 @@ impl TypeChecker {
         }
     }
 
-    pub fn check(&mut self, ast: &AstNode) -> Result<TypeNode, TypeError> {
+    /// Type node behind an interned id
+    pub fn type_node(&self, id: TypeId) -> &TypeNode {
+        self.symbol_table.type_node(id)
+    }
+
+    fn intern(&mut self, type_node: &TypeNode) -> TypeId {
+        self.symbol_table.intern_type(type_node)
+    }
+
+    /// Intern an optional annotation, defaulting to 空
+    fn intern_annotation(&mut self, annotation: &Option<TypeNode>) -> TypeId {
+        match annotation {
+            Some(type_node) => self.intern(type_node),
+            None => TypeId::空,
+        }
+    }
+
+    fn describe(&self, id: TypeId) -> String {
+        format!("{:?}", self.type_node(id))
+    }
+
+    pub fn check(&mut self, ast: &AstNode) -> Result<TypeId, TypeError> {
         match ast {
             AstNode::字面量表达式(literal) => self.check_literal(literal),
             AstNode::标识符表达式(identifier) => self.check_identifier(identifier),
@@ -84,8 +106,8 @@ impl TypeChecker {
             AstNode::当语句(while_stmt) => self.check_while_statement(while_stmt),
             AstNode::对于语句(for_stmt) => self.check_for_statement(for_stmt),
             AstNode::返回语句(return_stmt) => self.check_return_statement(return_stmt),
-            AstNode::跳出语句(_) => Ok(TypeNode::基础类型(crate::parser::ast::BasicType::空)),
-            AstNode::继续语句(_) => Ok(TypeNode::基础类型(crate::parser::ast::BasicType::空)),
+            AstNode::跳出语句(_) => Ok(TypeId::空),
+            AstNode::继续语句(_) => Ok(TypeId::空),
             AstNode::表达式语句(expr_stmt) => self.check_expression_statement(expr_stmt),
             AstNode::程序(program) => self.check_program(program),
             AstNode::结构体声明(struct_decl) => self.check_struct_declaration(struct_decl),
@@ -104,20 +126,20 @@ impl TypeChecker {
         }
     }
 
-    fn check_literal(&self, literal: &crate::parser::ast::LiteralExpression) -> Result<TypeNode, TypeError> {
-        let type_node = match literal.value {
-            crate::parser::ast::LiteralValue::整数(_) => TypeNode::基础类型(BasicType::整数),
-            crate::parser::ast::LiteralValue::浮点数(_) => TypeNode::基础类型(BasicType::浮点数),
-            crate::parser::ast::LiteralValue::字符串(_) => TypeNode::基础类型(BasicType::字符串),
-            crate::parser::ast::LiteralValue::布尔(_) => TypeNode::基础类型(BasicType::布尔),
-            crate::parser::ast::LiteralValue::字符(_) => TypeNode::基础类型(BasicType::字符),
+    fn check_literal(&self, literal: &crate::parser::ast::LiteralExpression) -> Result<TypeId, TypeError> {
+        let type_id = match literal.value {
+            crate::parser::ast::LiteralValue::整数(_) => TypeId::整数,
+            crate::parser::ast::LiteralValue::浮点数(_) => TypeId::浮点数,
+            crate::parser::ast::LiteralValue::字符串(_) => TypeId::字符串,
+            crate::parser::ast::LiteralValue::布尔(_) => TypeId::布尔,
+            crate::parser::ast::LiteralValue::字符(_) => TypeId::字符,
         };
-        Ok(type_node)
+        Ok(type_id)
     }
 
-    fn check_identifier(&self, identifier: &crate::parser::ast::IdentifierExpression) -> Result<TypeNode, TypeError> {
+    fn check_identifier(&self, identifier: &crate::parser::ast::IdentifierExpression) -> Result<TypeId, TypeError> {
         match self.symbol_table.lookup_symbol(&identifier.name) {
-            Some(symbol) => Ok(symbol.type_node.clone()),
+            Some(symbol) => Ok(symbol.type_id),
             None => Err(TypeError::UndefinedVariable {
                 name: identifier.name.clone(),
                 span: identifier.span,
@@ -125,7 +147,7 @@ impl TypeChecker {
         }
     }
 
-    fn check_binary(&mut self, binary: &crate::parser::ast::BinaryExpression) -> Result<TypeNode, TypeError> {
+    fn check_binary(&mut self, binary: &crate::parser::ast::BinaryExpression) -> Result<TypeId, TypeError> {
         let left_type = self.check(&binary.left)?;
         let right_type = self.check(&binary.right)?;
 
@@ -139,12 +161,12 @@ impl TypeChecker {
             crate::parser::ast::BinaryOperator::等于 |
             crate::parser::ast::BinaryOperator::不等于 => {
                 // Check that operands are compatible (both numeric or both strings for equality)
-                if self.are_comparable_types(&left_type, &right_type) {
-                    Ok(TypeNode::基础类型(BasicType::布尔))
+                if self.are_comparable_types(left_type, right_type) {
+                    Ok(TypeId::布尔)
                 } else {
                     Err(TypeError::TypeMismatch {
-                        expected: format!("{:?}", left_type),
-                        actual: format!("{:?}", right_type),
+                        expected: self.describe(left_type),
+                        actual: self.describe(right_type),
                         span: binary.span,
                     })
                 }
@@ -152,17 +174,17 @@ impl TypeChecker {
             // Arithmetic operators
             crate::parser::ast::BinaryOperator::加 => {
                 // Special handling for string concatenation
-                let is_left_string = matches!(left_type, TypeNode::基础类型(BasicType::字符串));
-                let is_right_string = matches!(right_type, TypeNode::基础类型(BasicType::字符串));
+                let is_left_string = left_type == TypeId::字符串;
+                let is_right_string = right_type == TypeId::字符串;
 
                 if is_left_string && is_right_string {
                     // Both operands are strings - string concatenation
-                    Ok(TypeNode::基础类型(BasicType::字符串))
+                    Ok(TypeId::字符串)
                 } else if is_left_string || is_right_string {
                     // One operand is string, other is not - invalid operation
                     return Err(TypeError::InvalidOperation {
                         operation: "字符串连接".to_string(),
-                        type_name: format!("{:?} + {:?}", left_type, right_type),
+                        type_name: format!("{} + {}", self.describe(left_type), self.describe(right_type)),
                         span: binary.span,
                     });
                 } else if left_type == right_type {
@@ -170,8 +192,8 @@ impl TypeChecker {
                     Ok(left_type)
                 } else {
                     Err(TypeError::TypeMismatch {
-                        expected: format!("{:?}", left_type),
-                        actual: format!("{:?}", right_type),
+                        expected: self.describe(left_type),
+                        actual: self.describe(right_type),
                         span: binary.span,
                     })
                 }
@@ -184,8 +206,8 @@ impl TypeChecker {
                     Ok(left_type)
                 } else {
                     Err(TypeError::TypeMismatch {
-                        expected: format!("{:?}", left_type),
-                        actual: format!("{:?}", right_type),
+                        expected: self.describe(left_type),
+                        actual: self.describe(right_type),
                         span: binary.span,
                     })
                 }
@@ -193,24 +215,26 @@ impl TypeChecker {
             // Logical operators work with boolean operands and return boolean
             crate::parser::ast::BinaryOperator::与 |
             crate::parser::ast::BinaryOperator::或 => {
-                match (&left_type, &right_type) {
-                    (TypeNode::基础类型(BasicType::布尔), TypeNode::基础类型(BasicType::布尔)) => {
-                        Ok(TypeNode::基础类型(BasicType::布尔))
-                    }
-                    _ => {
-                        Err(TypeError::TypeMismatch {
-                            expected: "布尔".to_string(),
-                            actual: format!("{:?} 和 {:?}", left_type, right_type),
-                            span: binary.span,
-                        })
-                    }
+                if left_type == TypeId::布尔 && right_type == TypeId::布尔 {
+                    Ok(TypeId::布尔)
+                } else {
+                    Err(TypeError::TypeMismatch {
+                        expected: "布尔".to_string(),
+                        actual: format!("{} 和 {}", self.describe(left_type), self.describe(right_type)),
+                        span: binary.span,
+                    })
                 }
             }
         }
     }
 
     /// Check if two types are compatible (for assignment/initialization)
-    fn are_types_compatible(&self, expected: &TypeNode, actual: &TypeNode) -> bool {
+    fn are_types_compatible(&self, expected: TypeId, actual: TypeId) -> bool {
+        expected == actual
+            || Self::are_nodes_compatible(self.type_node(expected), self.type_node(actual))
+    }
+
+    fn are_nodes_compatible(expected: &TypeNode, actual: &TypeNode) -> bool {
         match (expected, actual) {
             // Exact types are always compatible
             (expected, actual) if expected == actual => true,
@@ -218,7 +242,7 @@ impl TypeChecker {
             // Array type compatibility: Array<T> is compatible with Array<T>[N] regardless of size
             (TypeNode::数组类型(expected_array), TypeNode::数组类型(actual_array)) => {
                 // Check if element types are compatible, ignore size differences
-                self.are_types_compatible(&expected_array.element_type, &actual_array.element_type)
+                Self::are_nodes_compatible(&expected_array.element_type, &actual_array.element_type)
             }
 
             // Basic type compatibility with implicit conversions
@@ -233,13 +257,13 @@ impl TypeChecker {
 
                 // Check parameter types (contravariant)
                 for (exp_param, act_param) in expected_func.parameters.iter().zip(actual_func.parameters.iter()) {
-                    if !self.are_types_compatible(act_param, exp_param) {
+                    if !Self::are_nodes_compatible(act_param, exp_param) {
                         return false;
                     }
                 }
 
                 // Check return types (covariant)
-                self.are_types_compatible(&expected_func.return_type, &actual_func.return_type)
+                Self::are_nodes_compatible(&expected_func.return_type, &actual_func.return_type)
             }
 
             _ => false,
@@ -247,28 +271,20 @@ impl TypeChecker {
     }
 
     /// Check if two types are comparable
-    fn are_comparable_types(&self, left: &TypeNode, right: &TypeNode) -> bool {
-        match (left, right) {
-            // Numbers can be compared with each other
-            (TypeNode::基础类型(BasicType::整数), TypeNode::基础类型(BasicType::整数)) => true,
-            (TypeNode::基础类型(BasicType::浮点数), TypeNode::基础类型(BasicType::浮点数)) => true,
-            (TypeNode::基础类型(BasicType::整数), TypeNode::基础类型(BasicType::浮点数)) => true,
-            (TypeNode::基础类型(BasicType::浮点数), TypeNode::基础类型(BasicType::整数)) => true,
-            // Strings can be compared with each other (for equality)
-            (TypeNode::基础类型(BasicType::字符串), TypeNode::基础类型(BasicType::字符串)) => true,
-            // Booleans can be compared with each other
-            (TypeNode::基础类型(BasicType::布尔), TypeNode::基础类型(BasicType::布尔)) => true,
-            // Otherwise not comparable
-            _ => false,
-        }
+    fn are_comparable_types(&self, left: TypeId, right: TypeId) -> bool {
+        let is_number = |t: TypeId| t == TypeId::整数 || t == TypeId::浮点数;
+        // Numbers can be compared with each other
+        (is_number(left) && is_number(right))
+            // Strings and booleans can be compared with their own kind
+            || (left == right && (left == TypeId::字符串 || left == TypeId::布尔))
     }
 
-    pub fn check_function_call(&self, call: &crate::parser::ast::FunctionCallExpression) -> Result<TypeNode, TypeError> {
+    pub fn check_function_call(&self, call: &crate::parser::ast::FunctionCallExpression) -> Result<TypeId, TypeError> {
         match self.symbol_table.lookup_symbol(&call.callee) {
             Some(symbol) => {
                 if let crate::semantic::symbol_table::SymbolKind::函数(func_info) = &symbol.kind {
                     // TODO: Check parameter count and types
-                    Ok(func_info.return_type.clone())
+                    Ok(func_info.return_type)
                 } else {
                     Err(TypeError::FunctionCallError {
                         message: format!("'{}' 不是一个函数", call.callee),
@@ -283,7 +299,7 @@ impl TypeChecker {
         }
     }
 
-    fn check_assignment(&mut self, assignment: &crate::parser::ast::AssignmentExpression) -> Result<TypeNode, TypeError> {
+    fn check_assignment(&mut self, assignment: &crate::parser::ast::AssignmentExpression) -> Result<TypeId, TypeError> {
         let value_type = self.check(&assignment.value)?;
 
         // Check the target (LValue) and get its type
@@ -291,7 +307,7 @@ impl TypeChecker {
             AstNode::标识符表达式(ident) => {
                 // Simple variable assignment
                 match self.symbol_table.lookup_symbol(&ident.name) {
-                    Some(symbol) => Ok(symbol.type_node.clone()),
+                    Some(symbol) => Ok(symbol.type_id),
                     None => Err(TypeError::UndefinedVariable {
                         name: ident.name.clone(),
                         span: assignment.span,
@@ -321,15 +337,15 @@ impl TypeChecker {
             Ok(value_type)
         } else {
             Err(TypeError::TypeMismatch {
-                expected: format!("{:?}", target_type),
-                actual: format!("{:?}", value_type),
+                expected: self.describe(target_type),
+                actual: self.describe(value_type),
                 span: assignment.span,
             })
         }
     }
 
-    pub fn check_variable_declaration(&mut self, decl: &crate::parser::ast::VariableDeclaration) -> Result<TypeNode, TypeError> {
-        let declared_type = decl.type_annotation.clone();
+    pub fn check_variable_declaration(&mut self, decl: &crate::parser::ast::VariableDeclaration) -> Result<TypeId, TypeError> {
+        let declared_type = decl.type_annotation.as_ref().map(|t| self.intern(t));
 
         let initializer_type = if let Some(initializer) = &decl.initializer {
             Some(self.check(initializer)?)
@@ -341,10 +357,10 @@ impl TypeChecker {
         let final_type = if let Some(declared) = declared_type {
             // Check type compatibility
             if let Some(init_type) = initializer_type {
-                if !self.are_types_compatible(&declared, &init_type) {
+                if !self.are_types_compatible(declared, init_type) {
                     return Err(TypeError::TypeMismatch {
-                        expected: format!("{:?}", declared),
-                        actual: format!("{:?}", init_type),
+                        expected: self.describe(declared),
+                        actual: self.describe(init_type),
                         span: decl.span,
                     });
                 }
@@ -352,14 +368,14 @@ impl TypeChecker {
             declared
         } else {
             // Type inference: use initializer type or default to 空
-            initializer_type.unwrap_or_else(|| TypeNode::基础类型(BasicType::空))
+            initializer_type.unwrap_or(TypeId::空)
         };
 
         // Register the variable in the symbol table
         let var_symbol = crate::semantic::symbol_table::Symbol {
-            name: decl.name.clone(),
+            name: self.symbol_table.intern(&decl.name),
             kind: crate::semantic::symbol_table::SymbolKind::变量,
-            type_node: final_type.clone(),
+            type_id: final_type,
             scope_level: self.symbol_table.current_scope(),
             span: decl.span,
             is_mutable: decl.is_mutable,
@@ -375,19 +391,20 @@ impl TypeChecker {
         Ok(final_type)
     }
 
-    pub fn check_function_declaration(&mut self, func: &crate::parser::ast::FunctionDeclaration) -> Result<TypeNode, TypeError> {
+    pub fn check_function_declaration(&mut self, func: &crate::parser::ast::FunctionDeclaration) -> Result<TypeId, TypeError> {
         // Create function info
+        let return_type = self.intern_annotation(&func.return_type);
         let function_info = crate::semantic::symbol_table::FunctionInfo {
             parameters: func.parameters.clone(),
-            return_type: func.return_type.clone().unwrap_or_else(|| TypeNode::基础类型(BasicType::空)),
+            return_type,
             is_defined: true,
         };
 
         // Register function in current scope
         let function_symbol = crate::semantic::symbol_table::Symbol {
-            name: func.name.clone(),
+            name: self.symbol_table.intern(&func.name),
             kind: crate::semantic::symbol_table::SymbolKind::函数(function_info),
-            type_node: func.return_type.clone().unwrap_or_else(|| TypeNode::基础类型(BasicType::空)),
+            type_id: return_type,
             scope_level: self.symbol_table.current_scope(),
             span: func.span,
             is_mutable: false,
@@ -405,13 +422,12 @@ impl TypeChecker {
 
         // Process parameters and add them to function scope
         for param in &func.parameters {
-            let param_type = param.type_annotation.clone()
-                .unwrap_or_else(|| TypeNode::基础类型(BasicType::空));
+            let param_type = self.intern_annotation(&param.type_annotation);
 
             let param_symbol = crate::semantic::symbol_table::Symbol {
-                name: param.name.clone(),
+                name: self.symbol_table.intern(&param.name),
                 kind: crate::semantic::symbol_table::SymbolKind::变量,
-                type_node: param_type,
+                type_id: param_type,
                 scope_level: self.symbol_table.current_scope(),
                 span: param.span,
                 is_mutable: false,
@@ -436,50 +452,46 @@ impl TypeChecker {
         self.symbol_table.exit_scope();
 
         // Return function type
-        Ok(func.return_type.clone().unwrap_or_else(|| TypeNode::基础类型(BasicType::空)))
+        Ok(return_type)
     }
 
-    fn check_array_access(&mut self, array_access: &crate::parser::ast::ArrayAccessExpression) -> Result<TypeNode, TypeError> {
+    fn check_array_access(&mut self, array_access: &crate::parser::ast::ArrayAccessExpression) -> Result<TypeId, TypeError> {
         // Check array type
         let array_type = self.check(&array_access.array)?;
 
         // Check that it's an array type and extract element type
-        let element_type = match array_type {
-            TypeNode::数组类型(array_type) => *array_type.element_type,
-            _ => {
+        let element_type = match self.type_node(array_type) {
+            TypeNode::数组类型(array_type) => (*array_type.element_type).clone(),
+            other => {
                 return Err(TypeError::InvalidOperation {
                     operation: "数组访问".to_string(),
-                    type_name: format!("{:?}", array_type),
+                    type_name: format!("{:?}", other),
                     span: array_access.span,
                 });
             }
         };
+        let element_type = self.intern(&element_type);
 
         // Check index type (should be integer)
         let index_type = self.check(&array_access.index)?;
-        match index_type {
-            TypeNode::基础类型(BasicType::整数) => {
-                // Good, index is integer
-            }
-            _ => {
-                return Err(TypeError::TypeMismatch {
-                    expected: "整数".to_string(),
-                    actual: format!("{:?}", index_type),
-                    span: array_access.span,
-                });
-            }
+        if index_type != TypeId::整数 {
+            return Err(TypeError::TypeMismatch {
+                expected: "整数".to_string(),
+                actual: self.describe(index_type),
+                span: array_access.span,
+            });
         }
 
         Ok(element_type)
     }
 
-    fn check_array_literal(&mut self, array_literal: &crate::parser::ast::ArrayLiteralExpression) -> Result<TypeNode, TypeError> {
+    fn check_array_literal(&mut self, array_literal: &crate::parser::ast::ArrayLiteralExpression) -> Result<TypeId, TypeError> {
         // Empty array: infer as empty integer array for now
         if array_literal.elements.is_empty() {
-            return Ok(TypeNode::数组类型(crate::parser::ast::ArrayType {
+            return Ok(self.intern(&TypeNode::数组类型(crate::parser::ast::ArrayType {
                 element_type: Box::new(TypeNode::基础类型(BasicType::整数)),
                 size: Some(0),
-            }));
+            })));
         }
 
         // Get type of first element
@@ -490,45 +502,46 @@ impl TypeChecker {
             let element_type = self.check(element)?;
             if element_type != first_type {
                 return Err(TypeError::TypeMismatch {
-                    expected: format!("{:?}", first_type),
-                    actual: format!("{:?}", element_type),
+                    expected: self.describe(first_type),
+                    actual: self.describe(element_type),
                     span: array_literal.span, // Use array literal span as fallback
                 });
             }
         }
 
-        Ok(TypeNode::数组类型(crate::parser::ast::ArrayType {
-            element_type: Box::new(first_type),
+        let array_type = TypeNode::数组类型(crate::parser::ast::ArrayType {
+            element_type: Box::new(self.type_node(first_type).clone()),
             size: Some(array_literal.elements.len()),
-        }))
+        });
+        Ok(self.intern(&array_type))
     }
 
-    fn check_string_concat(&mut self, string_concat: &crate::parser::ast::StringConcatExpression) -> Result<TypeNode, TypeError> {
+    fn check_string_concat(&mut self, string_concat: &crate::parser::ast::StringConcatExpression) -> Result<TypeId, TypeError> {
         let left_type = self.check(&string_concat.left)?;
         let right_type = self.check(&string_concat.right)?;
 
         // At least one operand should be string
-        let is_left_string = matches!(left_type, TypeNode::基础类型(BasicType::字符串));
-        let is_right_string = matches!(right_type, TypeNode::基础类型(BasicType::字符串));
+        let is_left_string = left_type == TypeId::字符串;
+        let is_right_string = right_type == TypeId::字符串;
 
         if !is_left_string && !is_right_string {
             return Err(TypeError::InvalidOperation {
                 operation: "字符串连接".to_string(),
-                type_name: format!("{:?} + {:?}", left_type, right_type),
+                type_name: format!("{} + {}", self.describe(left_type), self.describe(right_type)),
                 span: string_concat.span,
             });
         }
 
         // String concatenation always results in string type
-        Ok(TypeNode::基础类型(BasicType::字符串))
+        Ok(TypeId::字符串)
     }
 
-    fn check_struct_literal(&mut self, struct_literal: &crate::parser::ast::StructLiteralExpression) -> Result<TypeNode, TypeError> {
+    fn check_struct_literal(&mut self, struct_literal: &crate::parser::ast::StructLiteralExpression) -> Result<TypeId, TypeError> {
         // Look up struct type definition
-        let struct_type = match self.symbol_table.lookup_symbol(&struct_literal.struct_name) {
+        let (struct_id, struct_type) = match self.symbol_table.lookup_symbol(&struct_literal.struct_name) {
             Some(symbol) => {
-                match &symbol.type_node {
-                    TypeNode::结构体类型(struct_type) => struct_type.clone(),
+                match self.symbol_table.type_node(symbol.type_id) {
+                    TypeNode::结构体类型(struct_type) => (symbol.type_id, struct_type.clone()),
                     _ => {
                         return Err(TypeError::General {
                             message: format!("'{}' 不是一个结构体类型", struct_literal.struct_name),
@@ -565,10 +578,10 @@ impl TypeChecker {
 
             if let Some(expected_field) = expected_field {
                 let provided_type = self.check(&provided_field.value)?;
-                if provided_type != expected_field.type_annotation {
+                if provided_type != self.intern(&expected_field.type_annotation) {
                     return Err(TypeError::TypeMismatch {
                         expected: format!("{:?}", expected_field.type_annotation),
-                        actual: format!("{:?}", provided_type),
+                        actual: self.describe(provided_type),
                         span: provided_field.span,
                     });
                 }
@@ -581,51 +594,48 @@ impl TypeChecker {
         }
 
         // Return the struct type
-        Ok(TypeNode::结构体类型(struct_type))
+        Ok(struct_id)
     }
 
-    fn check_field_access(&mut self, field_access: &crate::parser::ast::FieldAccessExpression) -> Result<TypeNode, TypeError> {
+    fn check_field_access(&mut self, field_access: &crate::parser::ast::FieldAccessExpression) -> Result<TypeId, TypeError> {
         // Check object type
         let object_type = self.check(&field_access.object)?;
 
         // Check that object is a struct type
-        match object_type {
+        let field_type = match self.type_node(object_type) {
             TypeNode::结构体类型(struct_type) => {
                 // Check that field exists
                 if let Some(field) = struct_type.fields.iter().find(|f| f.name == field_access.field) {
-                    // Return the field's type
-                    Ok(field.type_annotation.clone())
+                    field.type_annotation.clone()
                 } else {
-                    Err(TypeError::General {
+                    return Err(TypeError::General {
                         message: format!("结构体 '{}' 没有字段 '{}'", struct_type.name, field_access.field),
                         span: field_access.span,
-                    })
+                    });
                 }
             }
-            _ => {
-                Err(TypeError::InvalidOperation {
+            other => {
+                return Err(TypeError::InvalidOperation {
                     operation: "字段访问".to_string(),
-                    type_name: format!("{:?}", object_type),
+                    type_name: format!("{:?}", other),
                     span: field_access.span,
-                })
+                });
             }
-        }
+        };
+
+        // Return the field's type
+        Ok(self.intern(&field_type))
     }
 
-    fn check_if_statement(&mut self, if_stmt: &crate::parser::ast::IfStatement) -> Result<TypeNode, TypeError> {
+    fn check_if_statement(&mut self, if_stmt: &crate::parser::ast::IfStatement) -> Result<TypeId, TypeError> {
         // Check condition type
         let condition_type = self.check(&if_stmt.condition)?;
-        match condition_type {
-            TypeNode::基础类型(BasicType::布尔) => {
-                // Good, condition is boolean
-            }
-            _ => {
-                return Err(TypeError::TypeMismatch {
-                    expected: "布尔".to_string(),
-                    actual: format!("{:?}", condition_type),
-                    span: if_stmt.span,
-                });
-            }
+        if condition_type != TypeId::布尔 {
+            return Err(TypeError::TypeMismatch {
+                expected: "布尔".to_string(),
+                actual: self.describe(condition_type),
+                span: if_stmt.span,
+            });
         }
 
         // Enter new scope for then branch
@@ -645,23 +655,18 @@ impl TypeChecker {
             }
             self.symbol_table.exit_scope();
         }
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_while_statement(&mut self, while_stmt: &crate::parser::ast::WhileStatement) -> Result<TypeNode, TypeError> {
+    fn check_while_statement(&mut self, while_stmt: &crate::parser::ast::WhileStatement) -> Result<TypeId, TypeError> {
         // Check condition type
         let condition_type = self.check(&while_stmt.condition)?;
-        match condition_type {
-            TypeNode::基础类型(BasicType::布尔) => {
-                // Good, condition is boolean
-            }
-            _ => {
-                return Err(TypeError::TypeMismatch {
-                    expected: "布尔".to_string(),
-                    actual: format!("{:?}", condition_type),
-                    span: while_stmt.span,
-                });
-            }
+        if condition_type != TypeId::布尔 {
+            return Err(TypeError::TypeMismatch {
+                expected: "布尔".to_string(),
+                actual: self.describe(condition_type),
+                span: while_stmt.span,
+            });
         }
 
         // Enter new scope for loop body
@@ -678,40 +683,34 @@ impl TypeChecker {
         self.symbol_table.exit_scope();
 
         // While statement doesn't produce a value
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_for_statement(&mut self, for_stmt: &crate::parser::ast::ForStatement) -> Result<TypeNode, TypeError> {
+    fn check_for_statement(&mut self, for_stmt: &crate::parser::ast::ForStatement) -> Result<TypeId, TypeError> {
         // Check range type
         let range_type = self.check(&for_stmt.range)?;
 
         // Range should be array-like
-        match range_type {
-            TypeNode::数组类型(_) => {
-                // Good, range is an array
-            }
-            _ => {
+        let element_type = match self.type_node(range_type) {
+            TypeNode::数组类型(array_type) => (*array_type.element_type).clone(),
+            other => {
                 return Err(TypeError::TypeMismatch {
                     expected: "数组".to_string(),
-                    actual: format!("{:?}", range_type),
+                    actual: format!("{:?}", other),
                     span: for_stmt.span,
                 });
             }
-        }
+        };
+        let element_type = self.intern(&element_type);
 
         // Enter new scope for loop body
         self.symbol_table.enter_scope();
 
         // Add loop variable to scope with array element type
-        let element_type = match &range_type {
-            TypeNode::数组类型(array_type) => *array_type.element_type.clone(),
-            _ => TypeNode::基础类型(BasicType::空),
-        };
-
         let loop_var_symbol = crate::semantic::symbol_table::Symbol {
-            name: for_stmt.variable.clone(),
+            name: self.symbol_table.intern(&for_stmt.variable),
             kind: crate::semantic::symbol_table::SymbolKind::变量,
-            type_node: element_type.clone(),
+            type_id: element_type,
             scope_level: self.symbol_table.current_scope(),
             span: for_stmt.span,
             is_mutable: false,
@@ -735,10 +734,10 @@ impl TypeChecker {
         self.symbol_table.exit_scope();
 
         // For statement doesn't produce a value
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_return_statement(&mut self, return_stmt: &crate::parser::ast::ReturnStatement) -> Result<TypeNode, TypeError> {
+    fn check_return_statement(&mut self, return_stmt: &crate::parser::ast::ReturnStatement) -> Result<TypeId, TypeError> {
         // Type check return value if present
         if let Some(value) = &return_stmt.value {
             let value_type = self.check(value)?;
@@ -746,16 +745,16 @@ impl TypeChecker {
             Ok(value_type)
         } else {
             // Return without value returns 空 type
-            Ok(TypeNode::基础类型(BasicType::空))
+            Ok(TypeId::空)
         }
     }
 
-    fn check_expression_statement(&mut self, expr_stmt: &crate::parser::ast::ExpressionStatement) -> Result<TypeNode, TypeError> {
+    fn check_expression_statement(&mut self, expr_stmt: &crate::parser::ast::ExpressionStatement) -> Result<TypeId, TypeError> {
         // Type check the expression
         self.check(&expr_stmt.expression)
     }
 
-    fn check_block_statement(&mut self, block_stmt: &crate::parser::ast::BlockStatement) -> Result<TypeNode, TypeError> {
+    fn check_block_statement(&mut self, block_stmt: &crate::parser::ast::BlockStatement) -> Result<TypeId, TypeError> {
         // Enter new scope for block
         self.symbol_table.enter_scope();
 
@@ -770,10 +769,10 @@ impl TypeChecker {
         self.symbol_table.exit_scope();
 
         // Block statement doesn't produce a value
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_program(&mut self, program: &crate::parser::ast::Program) -> Result<TypeNode, TypeError> {
+    fn check_program(&mut self, program: &crate::parser::ast::Program) -> Result<TypeId, TypeError> {
         // Enter global scope
         self.symbol_table.enter_scope();
 
@@ -787,16 +786,16 @@ impl TypeChecker {
         // Exit global scope
         self.symbol_table.exit_scope();
 
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_struct_declaration(&mut self, struct_decl: &crate::parser::ast::StructDeclaration) -> Result<TypeNode, TypeError> {
+    fn check_struct_declaration(&mut self, struct_decl: &crate::parser::ast::StructDeclaration) -> Result<TypeId, TypeError> {
         // Create struct type
-        let struct_type = TypeNode::结构体类型(crate::parser::ast::StructType {
+        let struct_type = self.intern(&TypeNode::结构体类型(crate::parser::ast::StructType {
             name: struct_decl.name.clone(),
             fields: struct_decl.fields.clone(),
             methods: vec![], // 方法在方法声明时添加
-        });
+        }));
 
         // Create type info for struct
         let type_info = crate::semantic::symbol_table::TypeInfo {
@@ -806,9 +805,9 @@ impl TypeChecker {
 
         // Register struct type in symbol table
         let struct_symbol = crate::semantic::symbol_table::Symbol {
-            name: struct_decl.name.clone(),
+            name: self.symbol_table.intern(&struct_decl.name),
             kind: crate::semantic::symbol_table::SymbolKind::类型(type_info),
-            type_node: struct_type.clone(),
+            type_id: struct_type,
             scope_level: self.symbol_table.current_scope(),
             span: struct_decl.span,
             is_mutable: false,
@@ -824,12 +823,12 @@ impl TypeChecker {
         Ok(struct_type)
     }
 
-    fn check_enum_declaration(&mut self, enum_decl: &crate::parser::ast::EnumDeclaration) -> Result<TypeNode, TypeError> {
+    fn check_enum_declaration(&mut self, enum_decl: &crate::parser::ast::EnumDeclaration) -> Result<TypeId, TypeError> {
         // Create enum type
-        let enum_type = TypeNode::枚举类型(crate::parser::ast::EnumType {
+        let enum_type = self.intern(&TypeNode::枚举类型(crate::parser::ast::EnumType {
             name: enum_decl.name.clone(),
             variants: enum_decl.variants.clone(),
-        });
+        }));
 
         // Create type info for enum
         let type_info = crate::semantic::symbol_table::TypeInfo {
@@ -839,9 +838,9 @@ impl TypeChecker {
 
         // Register enum type in symbol table
         let enum_symbol = crate::semantic::symbol_table::Symbol {
-            name: enum_decl.name.clone(),
+            name: self.symbol_table.intern(&enum_decl.name),
             kind: crate::semantic::symbol_table::SymbolKind::类型(type_info),
-            type_node: enum_type.clone(),
+            type_id: enum_type,
             scope_level: self.symbol_table.current_scope(),
             span: enum_decl.span,
             is_mutable: false,
@@ -858,7 +857,7 @@ impl TypeChecker {
     }
 
 
-    fn check_loop_statement(&mut self, loop_stmt: &crate::parser::ast::LoopStatement) -> Result<TypeNode, TypeError> {
+    fn check_loop_statement(&mut self, loop_stmt: &crate::parser::ast::LoopStatement) -> Result<TypeId, TypeError> {
         // Enter new scope for loop body
         self.symbol_table.enter_scope();
 
@@ -873,14 +872,14 @@ impl TypeChecker {
         self.symbol_table.exit_scope();
 
         // Loop statement doesn't produce a value
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
     pub fn get_errors(&self) -> &[TypeError] {
         &self.errors
     }
 
-    fn check_method_declaration(&mut self, method_decl: &crate::parser::ast::MethodDeclaration) -> Result<TypeNode, TypeError> {
+    fn check_method_declaration(&mut self, method_decl: &crate::parser::ast::MethodDeclaration) -> Result<TypeId, TypeError> {
         // 1. 验证接收者类型存在
         if self.symbol_table.lookup_symbol(&method_decl.receiver_type).is_none() {
             return Err(TypeError::General {
@@ -894,9 +893,9 @@ impl TypeChecker {
 
         // 添加接收者参数到作用域 (类似 self 参数)
         let receiver_symbol = crate::semantic::symbol_table::Symbol {
-            name: method_decl.receiver_name.clone(),
+            name: self.symbol_table.intern(&method_decl.receiver_name),
             kind: crate::semantic::symbol_table::SymbolKind::变量,
-            type_node: TypeNode::基础类型(BasicType::整数), // 简化：暂时用整数类型
+            type_id: TypeId::整数, // 简化：暂时用整数类型
             scope_level: self.symbol_table.current_scope(),
             span: method_decl.span,
             is_mutable: method_decl.is_receiver_mutable,
@@ -911,13 +910,12 @@ impl TypeChecker {
 
         // 添加方法参数到作用域
         for param in &method_decl.parameters {
-            let param_type = param.type_annotation.clone()
-                .unwrap_or_else(|| TypeNode::基础类型(BasicType::空));
+            let param_type = self.intern_annotation(&param.type_annotation);
 
             let param_symbol = crate::semantic::symbol_table::Symbol {
-                name: param.name.clone(),
+                name: self.symbol_table.intern(&param.name),
                 kind: crate::semantic::symbol_table::SymbolKind::变量,
-                type_node: param_type,
+                type_id: param_type,
                 scope_level: self.symbol_table.current_scope(),
                 span: param.span,
                 is_mutable: false,
@@ -944,15 +942,15 @@ impl TypeChecker {
         // 这需要在符号表中维护类型的方法信息
 
         // 返回方法返回类型
-        Ok(method_decl.return_type.clone().unwrap_or_else(|| TypeNode::基础类型(BasicType::空)))
+        Ok(self.intern_annotation(&method_decl.return_type))
     }
 
-    fn check_method_call(&mut self, method_call: &crate::parser::ast::MethodCallExpression) -> Result<TypeNode, TypeError> {
+    fn check_method_call(&mut self, method_call: &crate::parser::ast::MethodCallExpression) -> Result<TypeId, TypeError> {
         // 1. 检查对象类型
         let object_type = self.check(&method_call.object)?;
 
         // 2. 验证对象是结构体类型
-        match &object_type {
+        match self.type_node(object_type) {
             TypeNode::结构体类型(_struct_type) => {
                 // TODO: 验证方法存在于结构体类型中
                 // 目前简化处理：假设方法存在
@@ -967,19 +965,19 @@ impl TypeChecker {
 
                 // 4. TODO: 返回方法的实际返回类型
                 // 目前简化：返回整数类型
-                Ok(TypeNode::基础类型(BasicType::整数))
+                Ok(TypeId::整数)
             }
-            _ => {
+            other => {
                 Err(TypeError::InvalidOperation {
                     operation: format!("方法调用 '{}'", method_call.method_name),
-                    type_name: format!("{:?}", object_type),
+                    type_name: format!("{:?}", other),
                     span: method_call.span,
                 })
             }
         }
     }
 
-    fn check_await_expression(&mut self, await_expr: &crate::parser::ast::AwaitExpression) -> Result<TypeNode, TypeError> {
+    fn check_await_expression(&mut self, await_expr: &crate::parser::ast::AwaitExpression) -> Result<TypeId, TypeError> {
         // Type check the awaited expression
         let awaited_type = self.check(&await_expr.expression)?;
 
@@ -988,15 +986,15 @@ impl TypeChecker {
         Ok(awaited_type)
     }
 
-    fn check_goroutine_spawn(&mut self, goroutine_expr: &crate::parser::ast::GoroutineSpawnExpression) -> Result<TypeNode, TypeError> {
+    fn check_goroutine_spawn(&mut self, goroutine_expr: &crate::parser::ast::GoroutineSpawnExpression) -> Result<TypeId, TypeError> {
         // Type check the goroutine expression
         self.check(&goroutine_expr.expression)?;
 
         // Goroutine spawn expressions return void (no meaningful return value)
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_channel_create(&mut self, channel_expr: &crate::parser::ast::ChannelCreateExpression) -> Result<TypeNode, TypeError> {
+    fn check_channel_create(&mut self, channel_expr: &crate::parser::ast::ChannelCreateExpression) -> Result<TypeId, TypeError> {
         // Type check the capacity if present
         if let Some(capacity) = &channel_expr.capacity {
             self.check(capacity)?;
@@ -1004,10 +1002,10 @@ impl TypeChecker {
 
         // Channel creation returns a channel type
         // TODO: Add proper channel type representation
-        Ok(TypeNode::基础类型(BasicType::字符串)) // Temporary placeholder
+        Ok(TypeId::字符串) // Temporary placeholder
     }
 
-    fn check_channel_send(&mut self, send_expr: &crate::parser::ast::ChannelSendExpression) -> Result<TypeNode, TypeError> {
+    fn check_channel_send(&mut self, send_expr: &crate::parser::ast::ChannelSendExpression) -> Result<TypeId, TypeError> {
         // Type check the channel
         self.check(&send_expr.channel)?;
 
@@ -1015,19 +1013,19 @@ impl TypeChecker {
         self.check(&send_expr.value)?;
 
         // Channel send expressions return void
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_channel_receive(&mut self, recv_expr: &crate::parser::ast::ChannelReceiveExpression) -> Result<TypeNode, TypeError> {
+    fn check_channel_receive(&mut self, recv_expr: &crate::parser::ast::ChannelReceiveExpression) -> Result<TypeId, TypeError> {
         // Type check the channel
         self.check(&recv_expr.channel)?;
 
         // Channel receive expressions return the channel element type
         // TODO: Add proper channel type inference
-        Ok(TypeNode::基础类型(BasicType::整数)) // Temporary placeholder
+        Ok(TypeId::整数) // Temporary placeholder
     }
 
-    fn check_select(&mut self, select_expr: &crate::parser::ast::SelectExpression) -> Result<TypeNode, TypeError> {
+    fn check_select(&mut self, select_expr: &crate::parser::ast::SelectExpression) -> Result<TypeId, TypeError> {
         // Type check each select case
         for case in &select_expr.cases {
             match &case.kind {
@@ -1051,30 +1049,32 @@ impl TypeChecker {
         }
 
         // Select statements return void
-        Ok(TypeNode::基础类型(BasicType::空))
+        Ok(TypeId::空)
     }
 
-    fn check_address_of(&mut self, addr_of_expr: &crate::parser::ast::AddressOfExpression) -> Result<TypeNode, TypeError> {
+    fn check_address_of(&mut self, addr_of_expr: &crate::parser::ast::AddressOfExpression) -> Result<TypeId, TypeError> {
         // Type check the inner expression
         let inner_type = self.check(&addr_of_expr.expression)?;
 
         // Return a pointer type to the inner type
-        Ok(TypeNode::指针类型(crate::parser::ast::PointerType {
-            target_type: Box::new(inner_type),
-        }))
+        let pointer_type = TypeNode::指针类型(crate::parser::ast::PointerType {
+            target_type: Box::new(self.type_node(inner_type).clone()),
+        });
+        Ok(self.intern(&pointer_type))
     }
 
-    fn check_dereference(&mut self, deref_expr: &crate::parser::ast::DereferenceExpression) -> Result<TypeNode, TypeError> {
+    fn check_dereference(&mut self, deref_expr: &crate::parser::ast::DereferenceExpression) -> Result<TypeId, TypeError> {
         // Type check the pointer expression
         let ptr_type = self.check(&deref_expr.expression)?;
 
         // If it's a pointer type, return the target type
-        if let TypeNode::指针类型(ptr) = ptr_type {
-            Ok(*ptr.target_type)
+        if let TypeNode::指针类型(ptr) = self.type_node(ptr_type) {
+            let target_type = (*ptr.target_type).clone();
+            Ok(self.intern(&target_type))
         } else {
             // For now, allow dereferencing any type (will be refined later)
             // This is because variables are internally pointers in LLVM
-            Ok(TypeNode::基础类型(BasicType::整数))
+            Ok(TypeId::整数)
         }
     }
 }
@@ -1,16 +1,38 @@
 //! Compilation cache for Qi language
+//!
+//! Cached artifacts are stored as `<key>.<source_hash>.data` in the cache
+//! directory, so a data file only ever holds the output for one exact
+//! input. The index (`index.bin`) is an append-only binary log: `put` and
+//! `invalidate` append a single record instead of rewriting the whole
+//! index, and the log is compacted once it holds many more records than
+//! live entries.
+//!
+//! Several compiler processes may share one cache directory. Data files
+//! are written to a temporary file and renamed into place, index appends
+//! and compaction hold an exclusive lock on `index.lock`, and every index
+//! record carries a checksum so a torn append is ignored on load.
 
-use std::path::PathBuf;
-use std::time::{SystemTime, UNIX_EPOCH};
 use std::collections::HashMap;
-use serde::{Deserialize, Serialize};
+use std::fs::{File, OpenOptions};
+use std::io::Write;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::{SystemTime, UNIX_EPOCH};
+use sha2::{Digest, Sha256};
+
+const INDEX_FILE: &str = "index.bin";
+const LOCK_FILE: &str = "index.lock";
+const INDEX_MAGIC: &[u8; 8] = b"QICACHE1";
+
+const RECORD_PUT: u8 = 1;
+const RECORD_REMOVE: u8 = 2;
 
 /// Cache entry
-#[derive(Debug, Clone, Serialize, Deserialize)]
+#[derive(Debug, Clone, PartialEq, Eq)]
 pub struct CacheEntry {
     pub timestamp: u64,
     pub source_hash: String,
-    pub compiled_data: Vec<u8>,
     pub dependencies: Vec<PathBuf>,
     pub target_triple: String,
     pub optimization_level: String,
@@ -21,6 +43,8 @@ pub struct CompilationCache {
     entries: HashMap<String, CacheEntry>,
     cache_dir: PathBuf,
     max_entries: usize,
+    /// Records in the on-disk log, as far as this process knows
+    log_records: usize,
 }
 
 /// Cache errors
@@ -30,15 +54,87 @@ pub enum CacheError {
     #[error("缓存 I/O 错误: {0}")]
     Io(#[from] std::io::Error),
 
-    /// Serialization error
-    #[error("缓存序列化错误: {0}")]
-    Serialization(#[from] serde_json::Error),
-
     /// Cache not found
     #[error("缓存未找到: {0}")]
     NotFound(String),
 }
 
+/// SHA-256 over length-prefixed fields, used to build cache keys
+///
+/// Prefixing each field with its length keeps `("ab", "c")` and
+/// `("a", "bc")` from hashing alike.
+pub struct ContentHasher(Sha256);
+
+impl ContentHasher {
+    pub fn new() -> Self {
+        Self(Sha256::new())
+    }
+
+    pub fn field(&mut self, bytes: impl AsRef<[u8]>) -> &mut Self {
+        let bytes = bytes.as_ref();
+        self.0.update((bytes.len() as u64).to_le_bytes());
+        self.0.update(bytes);
+        self
+    }
+
+    /// Lowercase hex digest
+    pub fn finish(self) -> String {
+        to_hex(&self.0.finalize())
+    }
+}
+
+impl Default for ContentHasher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// SHA-256 of `bytes` as lowercase hex
+pub fn hash_bytes(bytes: &[u8]) -> String {
+    to_hex(&Sha256::digest(bytes))
+}
+
+/// Identifier of the running compiler build, for cache keys
+///
+/// Package version plus a hash of the compiler executable's path, size and
+/// modification time, computed once per process from one `stat`. Any
+/// rebuild or reinstall of the compiler changes the id even when the
+/// package version is unchanged, without reading the executable itself.
+/// Falls back to the bare package version if the executable cannot be
+/// located.
+pub fn compiler_build_id() -> &'static str {
+    static BUILD_ID: OnceLock<String> = OnceLock::new();
+    BUILD_ID.get_or_init(|| match executable_identity() {
+        Ok(identity) => format!("{}-{}", env!("CARGO_PKG_VERSION"), identity),
+        Err(_) => env!("CARGO_PKG_VERSION").to_string(),
+    })
+}
+
+/// Hash of the running executable's path, size and modification time
+fn executable_identity() -> std::io::Result<String> {
+    let executable = std::env::current_exe()?;
+    let metadata = std::fs::metadata(&executable)?;
+    let modified = metadata.modified()?.duration_since(UNIX_EPOCH).unwrap_or_default();
+
+    let mut hasher = ContentHasher::new();
+    hasher
+        .field(executable.to_string_lossy().as_bytes())
+        .field(metadata.len().to_le_bytes())
+        .field(modified.as_secs().to_le_bytes())
+        .field(modified.subsec_nanos().to_le_bytes());
+    Ok(hasher.finish())
+}
+
+fn to_hex(bytes: &[u8]) -> String {
+    const DIGITS: &[u8; 16] = b"0123456789abcdef";
+    let mut hex = String::with_capacity(bytes.len() * 2);
+    for &byte in bytes {
+        hex.push(DIGITS[(byte >> 4) as usize] as char);
+        hex.push(DIGITS[(byte & 0xf) as usize] as char);
+    }
+    hex
+}
+
 impl CompilationCache {
     pub fn new() -> Result<Self, CacheError> {
         let cache_dir = std::env::current_dir()?.join(".qi_cache");
@@ -53,22 +149,41 @@ impl CompilationCache {
             entries: HashMap::new(),
             cache_dir,
             max_entries: 1000,
+            log_records: 0,
         };
 
         cache.load_cache_index()?;
         Ok(cache)
     }
 
-    pub fn get(&mut self, key: &str, source_hash: &str) -> Option<&CacheEntry> {
-        if let Some(entry) = self.entries.get(key) {
-            if entry.source_hash == source_hash {
-                return Some(entry);
-            }
+    pub fn get(&self, key: &str, source_hash: &str) -> Option<&CacheEntry> {
+        self.entries.get(key).filter(|entry| entry.source_hash == source_hash)
+    }
+
+    /// Path of the cached data for `key`, if an entry with `source_hash`
+    /// exists and its data file is present
+    pub fn lookup(&self, key: &str, source_hash: &str) -> Option<PathBuf> {
+        self.get(key, source_hash)?;
+        let data_path = self.data_path(key, source_hash);
+        data_path.is_file().then_some(data_path)
+    }
+
+    /// Copy the cached data for `key` to `dest`
+    ///
+    /// Returns `Ok(false)` on a miss, including when another process
+    /// removed the data file after the index was read.
+    pub fn fetch(&self, key: &str, source_hash: &str, dest: &Path) -> Result<bool, CacheError> {
+        let Some(data_path) = self.lookup(key, source_hash) else {
+            return Ok(false);
+        };
+        match std::fs::copy(&data_path, dest) {
+            Ok(_) => Ok(true),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(false),
+            Err(e) => Err(e.into()),
         }
-        None
     }
 
-    pub fn put(&mut self, key: String, source_hash: String, compiled_data: Vec<u8>,
+    pub fn put(&mut self, key: String, source_hash: String, compiled_data: &[u8],
                dependencies: Vec<PathBuf>, target_triple: String, optimization_level: String) -> Result<(), CacheError> {
         let timestamp = SystemTime::now()
             .duration_since(UNIX_EPOCH)
@@ -78,15 +193,20 @@ impl CompilationCache {
         let entry = CacheEntry {
             timestamp,
             source_hash,
-            compiled_data,
             dependencies,
             target_triple,
             optimization_level,
         };
 
-        self.entries.insert(key.clone(), entry);
-        self.save_cache_index()?;
-        self.save_cache_data(&key)?;
+        // Data first, so an index record never points at a missing file
+        write_atomic(&self.data_path(&key, &entry.source_hash), compiled_data)?;
+        self.append_record(&encode_put(&key, &entry))?;
+
+        if let Some(old) = self.entries.insert(key.clone(), entry) {
+            if old.source_hash != self.entries[&key].source_hash {
+                self.remove_cache_data(&key, &old.source_hash)?;
+            }
+        }
 
         // Cleanup old entries if necessary
         self.cleanup()?;
@@ -95,22 +215,24 @@ impl CompilationCache {
     }
 
     pub fn invalidate(&mut self, key: &str) -> Result<(), CacheError> {
-        if self.entries.remove(key).is_some() {
-            self.save_cache_index()?;
-            self.remove_cache_data(key)?;
+        if let Some(entry) = self.entries.remove(key) {
+            self.append_record(&encode_remove(key))?;
+            self.remove_cache_data(key, &entry.source_hash)?;
         }
         Ok(())
     }
 
     pub fn clear(&mut self) -> Result<(), CacheError> {
+        let _lock = IndexLock::acquire(&self.cache_dir)?;
         self.entries.clear();
-        self.save_cache_index()?;
+        write_atomic(&self.cache_dir.join(INDEX_FILE), INDEX_MAGIC)?;
+        self.log_records = 0;
 
         // Remove all cache data files
         for entry in std::fs::read_dir(&self.cache_dir)? {
             let entry = entry?;
             let path = entry.path();
-            if path.is_file() && path.file_name() != Some(std::ffi::OsStr::new("index.json")) {
+            if path.is_file() && path.extension() == Some(std::ffi::OsStr::new("data")) {
                 std::fs::remove_file(path)?;
             }
         }
@@ -118,66 +240,109 @@ impl CompilationCache {
         Ok(())
     }
 
+    fn data_path(&self, key: &str, source_hash: &str) -> PathBuf {
+        self.cache_dir.join(format!("{}.{}.data", key, source_hash))
+    }
+
     fn load_cache_index(&mut self) -> Result<(), CacheError> {
-        let index_path = self.cache_dir.join("index.json");
-        if index_path.exists() {
-            let content = std::fs::read_to_string(index_path)?;
-            let loaded_entries: HashMap<String, CacheEntry> = serde_json::from_str(&content)?;
-            self.entries = loaded_entries;
-        }
+        let (entries, records) = read_index(&self.cache_dir.join(INDEX_FILE))?;
+        self.entries = entries;
+        self.log_records = records;
         Ok(())
     }
 
-    fn save_cache_index(&self) -> Result<(), CacheError> {
-        let index_path = self.cache_dir.join("index.json");
-        let content = serde_json::to_string_pretty(&self.entries)?;
-        std::fs::write(index_path, content)?;
+    /// Append one record to the index log
+    fn append_record(&mut self, record: &[u8]) -> Result<(), CacheError> {
+        let _lock = IndexLock::acquire(&self.cache_dir)?;
+        let index_path = self.cache_dir.join(INDEX_FILE);
+
+        let mut file = OpenOptions::new().create(true).append(true).read(true).open(&index_path)?;
+        let len = file.metadata()?.len();
+        if len == 0 {
+            file.write_all(INDEX_MAGIC)?;
+        } else if !has_magic(&index_path)? {
+            // Unreadable index: start a fresh log holding only this record
+            drop(file);
+            let mut fresh = INDEX_MAGIC.to_vec();
+            fresh.extend_from_slice(record);
+            write_atomic(&index_path, &fresh)?;
+            self.log_records = 1;
+            return Ok(());
+        }
+
+        // A single write per record; the checksum covers a torn one
+        file.write_all(record)?;
+        self.log_records += 1;
         Ok(())
     }
 
-    fn save_cache_data(&self, key: &str) -> Result<(), CacheError> {
-        if let Some(entry) = self.entries.get(key) {
-            let data_path = self.cache_dir.join(format!("{}.data", key));
-            std::fs::write(data_path, &entry.compiled_data)?;
+    /// Rewrite the index log with one record per live entry
+    ///
+    /// Records appended by other processes since this one loaded the index
+    /// are merged in first; for a key present in both, the newer entry wins.
+    fn compact(&mut self, evicted: &[String]) -> Result<(), CacheError> {
+        let _lock = IndexLock::acquire(&self.cache_dir)?;
+        let index_path = self.cache_dir.join(INDEX_FILE);
+
+        let (mut entries, _) = read_index(&index_path)?;
+        for (key, entry) in self.entries.drain() {
+            match entries.get(&key) {
+                Some(existing) if existing.timestamp > entry.timestamp => {}
+                _ => {
+                    entries.insert(key, entry);
+                }
+            }
         }
+        for key in evicted {
+            entries.remove(key);
+        }
+
+        let mut content = INDEX_MAGIC.to_vec();
+        for (key, entry) in &entries {
+            content.extend_from_slice(&encode_put(key, entry));
+        }
+        write_atomic(&index_path, &content)?;
+
+        self.log_records = entries.len();
+        self.entries = entries;
         Ok(())
     }
 
-    fn remove_cache_data(&self, key: &str) -> Result<(), CacheError> {
-        let data_path = self.cache_dir.join(format!("{}.data", key));
-        if data_path.exists() {
-            std::fs::remove_file(data_path)?;
+    fn remove_cache_data(&self, key: &str, source_hash: &str) -> Result<(), CacheError> {
+        match std::fs::remove_file(self.data_path(key, source_hash)) {
+            Err(e) if e.kind() != std::io::ErrorKind::NotFound => Err(e.into()),
+            _ => Ok(()),
         }
-        Ok(())
     }
 
     fn cleanup(&mut self) -> Result<(), CacheError> {
         if self.entries.len() <= self.max_entries {
+            if self.log_records > 2 * self.entries.len() + 64 {
+                self.compact(&[])?;
+            }
             return Ok(());
         }
 
         // Sort entries by timestamp (oldest first)
-        let entries: Vec<_> = self.entries.iter()
+        let mut sorted_entries: Vec<_> = self.entries.iter()
             .map(|(k, v)| (k.clone(), v.timestamp))
             .collect();
-
-        let mut sorted_entries = entries;
         sorted_entries.sort_by_key(|(_, timestamp)| *timestamp);
 
         // Remove oldest entries
         let to_remove = sorted_entries.len() - self.max_entries;
-        let keys_to_remove: Vec<String> = sorted_entries.iter()
+        let keys_to_remove: Vec<String> = sorted_entries.into_iter()
             .take(to_remove)
-            .map(|(key, _)| key.clone())
+            .map(|(key, _)| key)
             .collect();
 
-        for key in keys_to_remove {
-            self.remove_cache_data(&key)?;
-            self.entries.remove(&key);
+        for key in &keys_to_remove {
+            if let Some(entry) = self.entries.remove(key) {
+                self.remove_cache_data(key, &entry.source_hash)?;
+            }
         }
 
-        self.save_cache_index()?;
-        Ok(())
+        self.compact(&keys_to_remove)
     }
 
     pub fn is_dependency_modified(&self, dependencies: &[PathBuf], timestamp: u64) -> bool {
@@ -221,4 +386,327 @@ impl Default for CompilationCache {
     fn default() -> Self {
         Self::new().expect("Failed to create default compilation cache")
     }
-}
\ No newline at end of file
+}
+
+/// Exclusive lock on the cache directory's index, released on drop
+///
+/// Only enforced on Unix, where it is an advisory `flock`.
+struct IndexLock {
+    _file: File,
+}
+
+impl IndexLock {
+    fn acquire(cache_dir: &Path) -> std::io::Result<Self> {
+        let file = OpenOptions::new()
+            .create(true)
+            .truncate(false)
+            .write(true)
+            .open(cache_dir.join(LOCK_FILE))?;
+        #[cfg(unix)]
+        {
+            use std::os::unix::io::AsRawFd;
+            loop {
+                if unsafe { libc::flock(file.as_raw_fd(), libc::LOCK_EX) } == 0 {
+                    break;
+                }
+                let error = std::io::Error::last_os_error();
+                if error.kind() != std::io::ErrorKind::Interrupted {
+                    return Err(error);
+                }
+            }
+        }
+        Ok(Self { _file: file })
+    }
+}
+
+/// Write `bytes` to a temporary file next to `path`, then rename it over
+/// `path`, so readers see either the old or the new contents
+fn write_atomic(path: &Path, bytes: &[u8]) -> std::io::Result<()> {
+    static COUNTER: AtomicU64 = AtomicU64::new(0);
+    let file_name = path.file_name().map(|n| n.to_string_lossy()).unwrap_or_default();
+    let temp_path = path.with_file_name(format!(
+        ".{}.{}.{}.tmp",
+        file_name,
+        std::process::id(),
+        COUNTER.fetch_add(1, Ordering::Relaxed),
+    ));
+    let result = std::fs::write(&temp_path, bytes).and_then(|_| std::fs::rename(&temp_path, path));
+    if result.is_err() {
+        let _ = std::fs::remove_file(&temp_path);
+    }
+    result
+}
+
+fn has_magic(index_path: &Path) -> std::io::Result<bool> {
+    use std::io::Read;
+    let mut magic = [0u8; 8];
+    let mut file = File::open(index_path)?;
+    Ok(file.read_exact(&mut magic).is_ok() && &magic == INDEX_MAGIC)
+}
+
+// Index log format, all integers little-endian:
+//
+//   log     := "QICACHE1" record*
+//   record  := len:u32 checksum:u32 payload[len]
+//   payload := RECORD_PUT key:str timestamp:u64 source_hash:str
+//              target_triple:str optimization_level:str count:u32 dep:str*
+//            | RECORD_REMOVE key:str
+//   str     := len:u32 utf8[len]
+
+/// Replay the index log; returns the live entries and the record count
+fn read_index(index_path: &Path) -> std::io::Result<(HashMap<String, CacheEntry>, usize)> {
+    let mut entries = HashMap::new();
+    let content = match std::fs::read(index_path) {
+        Ok(content) => content,
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok((entries, 0)),
+        Err(e) => return Err(e),
+    };
+    if !content.starts_with(INDEX_MAGIC) {
+        return Ok((entries, 0));
+    }
+
+    let mut records = 0;
+    let mut rest = &content[INDEX_MAGIC.len()..];
+    while rest.len() >= 8 {
+        let len = u32::from_le_bytes(rest[..4].try_into().unwrap()) as usize;
+        let checksum = u32::from_le_bytes(rest[4..8].try_into().unwrap());
+        let Some(payload) = rest.get(8..8 + len) else {
+            break;
+        };
+        if checksum32(payload) != checksum {
+            break;
+        }
+        rest = &rest[8 + len..];
+        records += 1;
+
+        let mut reader = Reader(payload);
+        match decode_record(&mut reader) {
+            Some((key, Some(entry))) => {
+                entries.insert(key, entry);
+            }
+            Some((key, None)) => {
+                entries.remove(&key);
+            }
+            None => break,
+        }
+    }
+    Ok((entries, records))
+}
+
+fn decode_record(reader: &mut Reader<'_>) -> Option<(String, Option<CacheEntry>)> {
+    let tag = reader.u8()?;
+    let key = reader.str()?;
+    match tag {
+        RECORD_PUT => {
+            let timestamp = reader.u64()?;
+            let source_hash = reader.str()?;
+            let target_triple = reader.str()?;
+            let optimization_level = reader.str()?;
+            let count = reader.u32()?;
+            let mut dependencies = Vec::with_capacity(count.min(64) as usize);
+            for _ in 0..count {
+                dependencies.push(PathBuf::from(reader.str()?));
+            }
+            Some((key, Some(CacheEntry {
+                timestamp,
+                source_hash,
+                dependencies,
+                target_triple,
+                optimization_level,
+            })))
+        }
+        RECORD_REMOVE => Some((key, None)),
+        _ => None,
+    }
+}
+
+fn encode_put(key: &str, entry: &CacheEntry) -> Vec<u8> {
+    let mut payload = vec![RECORD_PUT];
+    put_str(&mut payload, key);
+    payload.extend_from_slice(&entry.timestamp.to_le_bytes());
+    put_str(&mut payload, &entry.source_hash);
+    put_str(&mut payload, &entry.target_triple);
+    put_str(&mut payload, &entry.optimization_level);
+    payload.extend_from_slice(&(entry.dependencies.len() as u32).to_le_bytes());
+    for dep in &entry.dependencies {
+        put_str(&mut payload, &dep.to_string_lossy());
+    }
+    frame(payload)
+}
+
+fn encode_remove(key: &str) -> Vec<u8> {
+    let mut payload = vec![RECORD_REMOVE];
+    put_str(&mut payload, key);
+    frame(payload)
+}
+
+fn frame(payload: Vec<u8>) -> Vec<u8> {
+    let mut record = Vec::with_capacity(payload.len() + 8);
+    record.extend_from_slice(&(payload.len() as u32).to_le_bytes());
+    record.extend_from_slice(&checksum32(&payload).to_le_bytes());
+    record.extend_from_slice(&payload);
+    record
+}
+
+fn put_str(buffer: &mut Vec<u8>, s: &str) {
+    buffer.extend_from_slice(&(s.len() as u32).to_le_bytes());
+    buffer.extend_from_slice(s.as_bytes());
+}
+
+/// FNV-1a, enough to spot a torn or garbled record
+fn checksum32(bytes: &[u8]) -> u32 {
+    bytes.iter().fold(0x811c_9dc5u32, |hash, &byte| (hash ^ byte as u32).wrapping_mul(0x0100_0193))
+}
+
+struct Reader<'a>(&'a [u8]);
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, n: usize) -> Option<&'a [u8]> {
+        if self.0.len() < n {
+            return None;
+        }
+        let (head, tail) = self.0.split_at(n);
+        self.0 = tail;
+        Some(head)
+    }
+
+    fn u8(&mut self) -> Option<u8> {
+        Some(self.take(1)?[0])
+    }
+
+    fn u32(&mut self) -> Option<u32> {
+        Some(u32::from_le_bytes(self.take(4)?.try_into().ok()?))
+    }
+
+    fn u64(&mut self) -> Option<u64> {
+        Some(u64::from_le_bytes(self.take(8)?.try_into().ok()?))
+    }
+
+    fn str(&mut self) -> Option<String> {
+        let len = self.u32()? as usize;
+        String::from_utf8(self.take(len)?.to_vec()).ok()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn 缓存(dir: &Path) -> CompilationCache {
+        CompilationCache::with_cache_dir(dir.to_path_buf()).unwrap()
+    }
+
+    fn 放入(cache: &mut CompilationCache, key: &str, hash: &str, data: &[u8]) {
+        cache.put(key.to_string(), hash.to_string(), data, vec![PathBuf::from("主.qi")],
+                  "Linux".to_string(), "基础优化".to_string()).unwrap();
+    }
+
+    #[test]
+    fn test_hit_and_invalidation() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut cache = 缓存(dir.path());
+        放入(&mut cache, "模块", "aaaa", b"object-1");
+
+        let dest = dir.path().join("主.o");
+        assert!(cache.fetch("模块", "aaaa", &dest).unwrap());
+        assert_eq!(std::fs::read(&dest).unwrap(), b"object-1");
+        assert!(!cache.fetch("模块", "bbbb", &dest).unwrap());
+
+        // 新的源码哈希替换旧条目并删除旧数据文件
+        放入(&mut cache, "模块", "bbbb", b"object-2");
+        assert!(cache.get("模块", "aaaa").is_none());
+        assert!(!cache.data_path("模块", "aaaa").exists());
+
+        cache.invalidate("模块").unwrap();
+        assert!(cache.lookup("模块", "bbbb").is_none());
+    }
+
+    #[test]
+    fn test_index_reload() {
+        let dir = tempfile::tempdir().unwrap();
+        {
+            let mut cache = 缓存(dir.path());
+            放入(&mut cache, "甲", "1111", b"a");
+            放入(&mut cache, "乙", "2222", b"b");
+            cache.invalidate("甲").unwrap();
+        }
+
+        let cache = 缓存(dir.path());
+        assert!(cache.get("甲", "1111").is_none());
+        let entry = cache.get("乙", "2222").unwrap();
+        assert_eq!(entry.target_triple, "Linux");
+        assert_eq!(entry.dependencies, vec![PathBuf::from("主.qi")]);
+        assert_eq!(cache.stats().total_entries, 1);
+    }
+
+    #[test]
+    fn test_truncated_record_is_ignored() {
+        let dir = tempfile::tempdir().unwrap();
+        {
+            let mut cache = 缓存(dir.path());
+            放入(&mut cache, "甲", "1111", b"a");
+            放入(&mut cache, "乙", "2222", b"b");
+        }
+        let index_path = dir.path().join(INDEX_FILE);
+        let content = std::fs::read(&index_path).unwrap();
+        std::fs::write(&index_path, &content[..content.len() - 3]).unwrap();
+
+        let cache = 缓存(dir.path());
+        assert!(cache.get("甲", "1111").is_some());
+        assert!(cache.get("乙", "2222").is_none());
+    }
+
+    #[test]
+    fn test_two_caches_share_a_directory() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut first = 缓存(dir.path());
+        let mut second = 缓存(dir.path());
+        放入(&mut first, "甲", "1111", b"a");
+        放入(&mut second, "乙", "2222", b"b");
+
+        // 压缩时合并另一个进程追加的记录
+        first.compact(&[]).unwrap();
+        assert!(first.get("乙", "2222").is_some());
+
+        let reloaded = 缓存(dir.path());
+        assert!(reloaded.get("甲", "1111").is_some());
+        assert!(reloaded.get("乙", "2222").is_some());
+    }
+
+    #[test]
+    fn test_oldest_entry_evicted_over_capacity() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut cache = 缓存(dir.path());
+        cache.set_max_entries(2);
+        for (i, key) in ["甲", "乙", "丙"].iter().enumerate() {
+            放入(&mut cache, key, &format!("{:04}", i), b"x");
+            if let Some(entry) = cache.entries.get_mut(*key) {
+                entry.timestamp = i as u64;
+            }
+        }
+        assert_eq!(cache.stats().total_entries, 2);
+        assert!(cache.get("甲", "0000").is_none());
+        assert!(!cache.data_path("甲", "0000").exists());
+        assert_eq!(缓存(dir.path()).stats().total_entries, 2);
+    }
+
+    #[test]
+    fn test_content_hash_separates_fields() {
+        let mut a = ContentHasher::new();
+        a.field("ab").field("c");
+        let mut b = ContentHasher::new();
+        b.field("a").field("bc");
+        assert_ne!(a.finish(), b.finish());
+        assert_eq!(hash_bytes(b"").len(), 64);
+    }
+
+    #[test]
+    fn test_compiler_build_id_names_version_and_executable() {
+        let build = compiler_build_id()
+            .strip_prefix(concat!(env!("CARGO_PKG_VERSION"), "-"))
+            .unwrap();
+        assert_eq!(build, executable_identity().unwrap());
+        assert_eq!(build.len(), 64);
+        assert!(std::ptr::eq(compiler_build_id(), compiler_build_id()));
+    }
+}
@@ -0,0 +1,47 @@
+//! Process memory statistics
+
+/// Peak resident set size of the compiler process in bytes
+///
+/// Returns `None` on platforms without `getrusage`.
+pub fn peak_rss_bytes() -> Option<u64> {
+    #[cfg(unix)]
+    {
+        let mut usage: libc::rusage = unsafe { std::mem::zeroed() };
+        if unsafe { libc::getrusage(libc::RUSAGE_SELF, &mut usage) } != 0 {
+            return None;
+        }
+        let max_rss = usage.ru_maxrss as u64;
+        // macOS reports bytes, other Unix systems report kilobytes
+        if cfg!(target_os = "macos") {
+            Some(max_rss)
+        } else {
+            Some(max_rss * 1024)
+        }
+    }
+    #[cfg(not(unix))]
+    {
+        None
+    }
+}
+
+/// Format the peak RSS for verbose output, e.g. "123.4 MB"
+pub fn format_peak_rss() -> String {
+    match peak_rss_bytes() {
+        Some(bytes) => format!("{:.1} MB", bytes as f64 / (1024.0 * 1024.0)),
+        None => "未知".to_string(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[cfg(unix)]
+    fn test_peak_memory() {
+        let before = peak_rss_bytes().unwrap();
+        let block = vec![1u8; 32 << 20];
+        std::hint::black_box(&block);
+        assert!(peak_rss_bytes().unwrap() >= before.max(32 << 20));
+    }
+}
@@ -2,6 +2,7 @@
 
 pub mod cache;
 pub mod diagnostics;
+pub mod memory;
 pub mod source;
 
 pub use cache::CompilationCache;
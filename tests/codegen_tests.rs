@@ -30,7 +30,7 @@ fn test_code_generator_with_optimization() {
 #[test]
 fn test_simple_variable_codegen() {
     let source = "变量 x = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -50,7 +50,7 @@ fn test_simple_variable_codegen() {
 #[test]
 fn test_function_codegen() {
     let source = "函数 test() { 返回 42; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -72,7 +72,7 @@ fn test_function_codegen() {
 #[test]
 fn test_function_with_return_codegen() {
     let source = "函数 main() { 返回 0; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -93,7 +93,7 @@ fn test_function_with_return_codegen() {
 #[test]
 fn test_multiple_statements_codegen() {
     let source = "变量 x = 10; 变量 y = 20; 变量 z = x + y;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -115,7 +115,7 @@ fn test_multiple_statements_codegen() {
 #[test]
 fn test_arithmetic_expression_codegen() {
     let source = "变量 result = (1 + 2) * 3;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -137,7 +137,7 @@ fn test_arithmetic_expression_codegen() {
 #[test]
 fn test_string_literal_codegen() {
     let source = "变量 message = \"Hello, World!\";";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -157,7 +157,7 @@ fn test_string_literal_codegen() {
 #[test]
 fn test_character_literal_codegen() {
     let source = "变量 ch = 'A';";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -177,7 +177,7 @@ fn test_character_literal_codegen() {
 #[test]
 fn test_boolean_expression_codegen() {
     let source = "变量 flag = 真;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -197,7 +197,7 @@ fn test_boolean_expression_codegen() {
 #[test]
 fn test_comparison_operations_codegen() {
     let source = "变量 result = a > b;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -219,7 +219,7 @@ fn test_comparison_operations_codegen() {
 #[test]
 fn test_if_statement_codegen() {
     let source = "如果 x > 5 { 变量 y = 10; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -241,7 +241,7 @@ fn test_if_statement_codegen() {
 #[test]
 fn test_while_loop_codegen() {
     let source = "当 i < 10 { i = i + 1; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -263,7 +263,7 @@ fn test_while_loop_codegen() {
 #[test]
 fn test_function_call_codegen() {
     let source = "变量 result = test();";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -285,7 +285,7 @@ fn test_function_call_codegen() {
 #[test]
 fn test_function_call_with_arguments_codegen() {
     let source = "变量 result = add(1, 2);";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -305,7 +305,7 @@ fn test_function_call_with_arguments_codegen() {
 #[test]
 fn test_cross_platform_codegen() {
     let source = "变量 x = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -335,7 +335,7 @@ fn test_cross_platform_codegen() {
 #[test]
 fn test_optimization_levels() {
     let source = "变量 x = 42; 变量 y = x * 2;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -367,7 +367,7 @@ fn test_optimization_levels() {
 #[test]
 fn test_codegen_without_optimization() {
     let source = "变量 x = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -416,7 +416,7 @@ fn test_complex_program_codegen() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -438,7 +438,7 @@ fn test_complex_program_codegen() {
 #[test]
 fn test_codegen_error_handling() {
     let source = ""; // Empty program
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -454,7 +454,7 @@ fn test_codegen_error_handling() {
 #[test]
 fn test_codegen_ir_structure() {
     let source = "变量 x = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -485,7 +485,7 @@ fn test_multiple_function_codegen() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -504,4 +504,59 @@ fn test_multiple_function_codegen() {
                            ir.matches("@").count();
         assert!(function_count >= 2); // At least add and multiply
     }
-}
\ No newline at end of file
+}
+
+#[test]
+fn test_math_calls_lower_to_intrinsics() {
+    let source = "变量 x = sqrt(16.0);";
+    let mut lexer = Lexer::new(source);
+    let tokens = lexer.tokenize().unwrap();
+
+    let parser = Parser::new();
+    let program = parser.parse(tokens).unwrap();
+
+    let mut generator = CodeGenerator::new(CompilationTarget::Linux);
+    let ir = generator.generate(&AstNode::程序(program.clone())).unwrap();
+
+    // Direct calls use the intrinsic; the FFI symbol stays declared for indirect calls
+    assert!(ir.contains("@llvm.sqrt.f64(double"));
+    assert!(!ir.contains("call double @qi_runtime_math_sqrt"));
+    assert!(ir.contains("declare double @qi_runtime_math_sqrt(double)"));
+
+    let mut fast_generator = CodeGenerator::new(CompilationTarget::Linux);
+    fast_generator.set_fast_math(true);
+    let fast_ir = fast_generator.generate(&AstNode::程序(program)).unwrap();
+    assert!(fast_ir.contains("call fast double @llvm.sqrt.f64"));
+}
+
+#[test]
+fn test_array_math_calls_use_registered_signatures() {
+    let source = "变量 数据 = [1, 2, 3]; 变量 和 = 数组求和(数据, 3);";
+    let mut lexer = Lexer::new(source);
+    let tokens = lexer.tokenize().unwrap();
+
+    let parser = Parser::new();
+    let program = parser.parse(tokens).unwrap();
+
+    let mut generator = CodeGenerator::new(CompilationTarget::Linux);
+    let ir = generator.generate(&AstNode::程序(program)).unwrap();
+
+    assert!(ir.contains("declare i64 @qi_runtime_array_sum_int(ptr %0, i64 %1)"));
+    assert!(ir.contains("call i64 @qi_runtime_array_sum_int(ptr"));
+}
+
+#[test]
+fn test_file_handle_binary_calls_use_registered_signatures() {
+    let source = "变量 文件 = 打开文件(\"数据.bin\", \"w\"); 变量 结果 = 文件写入整数(文件, 42); 关闭文件(文件);";
+    let mut lexer = Lexer::new(source);
+    let tokens = lexer.tokenize().unwrap();
+
+    let parser = Parser::new();
+    let program = parser.parse(tokens).unwrap();
+
+    let mut generator = CodeGenerator::new(CompilationTarget::Linux);
+    let ir = generator.generate(&AstNode::程序(program)).unwrap();
+
+    assert!(ir.contains("declare i64 @qi_runtime_file_write_int(i64 %0, i64 %1)"));
+    assert!(ir.contains("call i64 @qi_runtime_file_write_int(i64"));
+}
@@ -209,7 +209,7 @@ fn test_control_flow_semantic_analysis() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -231,7 +231,7 @@ fn test_loop_type_validation() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -256,7 +256,7 @@ fn test_control_flow_codegen() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -286,7 +286,7 @@ fn test_control_flow_keywords_tokenization() {
     let keywords = vec!["如果", "否则", "当", "对于"];
 
     for keyword in keywords {
-        let mut lexer = Lexer::new(keyword.to_string());
+        let mut lexer = Lexer::new(keyword);
         let tokens = lexer.tokenize().unwrap();
 
         assert!(!tokens.is_empty(), "Failed to tokenize keyword: {}", keyword);
@@ -7,7 +7,7 @@ use qi_compiler::utils::diagnostics::DiagnosticManager;
 #[test]
 fn test_lexer_diagnostics_integration() {
     let source = "变量 x = 5 @ 3;"; // Invalid character
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     // Test that lexer collects diagnostics
@@ -21,7 +21,7 @@ fn test_lexer_diagnostics_integration() {
 #[test]
 fn test_lexer_unterminated_string_diagnostics() {
     let source = r#"变量 message = "unclosed string;"#;
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let diagnostics = lexer.diagnostics();
@@ -34,7 +34,7 @@ fn test_lexer_unterminated_string_diagnostics() {
 #[test]
 fn test_lexer_multiple_errors() {
     let source = "变量 x = @; 变量 y = 'unclosed; 变量 z = 123.456.789;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let diagnostics = lexer.diagnostics();
@@ -48,7 +48,7 @@ fn test_lexer_multiple_errors() {
 #[test]
 fn test_lexer_span_information_in_diagnostics() {
     let source = "变量 x = @invalid;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let _diagnostics = lexer.diagnostics();
@@ -61,7 +61,7 @@ fn test_lexer_span_information_in_diagnostics() {
 #[test]
 fn test_empty_source_diagnostics() {
     let source = "";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_ok());
@@ -74,7 +74,7 @@ fn test_empty_source_diagnostics() {
 #[test]
 fn test_valid_source_no_diagnostics() {
     let source = "变量 x = 42; 变量 y = \"hello\";";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_ok());
@@ -87,7 +87,7 @@ fn test_valid_source_no_diagnostics() {
 #[test]
 fn test_diagnostics_format_chinese() {
     let source = "变量 x = @;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let formatted = lexer.format_diagnostics();
@@ -99,7 +99,7 @@ fn test_diagnostics_format_chinese() {
 #[test]
 fn test_diagnostics_error_summary() {
     let source = "变量 x = @; 变量 y = #;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let (error_count, warning_count) = lexer.get_error_summary();
@@ -113,7 +113,7 @@ fn test_diagnostics_error_summary() {
 fn test_unicode_error_diagnostics() {
     // Chinese characters should be handled without errors
     let source = "变量 中文 = 123;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     // Should handle Chinese characters without errors
@@ -132,7 +132,7 @@ fn test_comment_handling_no_diagnostics() {
     /** Doc block comment */
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_ok());
@@ -154,7 +154,7 @@ fn test_diagnostic_manager_creation() {
 #[test]
 fn test_diagnostics_with_line_and_column() {
     let source = "变量 x = 5;\n变量 y = @;\n变量 z = 10;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let formatted = lexer.format_diagnostics();
@@ -14,7 +14,7 @@ fn test_compiler_creation() {
 #[test]
 fn test_lexer_chinese_keywords() {
     let source = "如果 否则 当 对于 函数 返回 变量 常量 整数 字符串 布尔 浮点数".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
 
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
@@ -45,7 +45,7 @@ fn test_lexer_chinese_keywords() {
 fn test_parser_basic_statements() {
     // Test variable declaration
     let source = "变量 x = 42;".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
     let parser = Parser::new();
@@ -60,7 +60,7 @@ fn test_parser_basic_statements() {
 fn test_parser_chinese_keywords() {
     // Test Chinese variable declaration
     let source = "变量 数字 = 42; 常量 PI = 3.14;".to_string();
-    let mut lexer = Lexer::new(source.clone());
+    let mut lexer = Lexer::new(&source);
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
     println!("Tokens for Chinese keywords test:");
@@ -100,7 +100,7 @@ fn test_parser_chinese_keywords() {
 fn test_simple_expression() {
     // Test expression parsing
     let source = "42;".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
     let parser = Parser::new();
@@ -145,7 +145,7 @@ fn test_basic_compilation_pipeline() {
 #[test]
 fn test_control_flow_chinese_keywords() {
     let source = "如果 否则 当 对于 与 或".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
 
     let tokens = lexer.tokenize().expect("Should tokenize control flow keywords");
 
@@ -191,7 +191,7 @@ fn test_control_flow_type_checking() {
     // Test that type checking infrastructure exists and can be created
     let source = "42;".to_string();
 
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
     let parser = Parser::new();
@@ -226,7 +226,7 @@ fn test_control_flow_type_checking() {
 #[test]
 fn test_character_literal_tokenization() {
     let source = "'A' '5' '!';".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
 
     let tokens = lexer.tokenize().expect("Should tokenize character literals successfully");
 
@@ -248,7 +248,7 @@ fn test_character_literal_tokenization() {
 #[test]
 fn test_character_literal_parsing() {
     let source = "变量 c = 'A';".to_string();
-    let mut lexer = Lexer::new(source);
+    let mut lexer = Lexer::new(&source);
     let tokens = lexer.tokenize().expect("Should tokenize successfully");
 
     println!("Tokens generated:");
@@ -787,7 +787,7 @@ fn test_invalid_character_error_message() {
     use qi_compiler::lexer::{Lexer, LexicalError};
 
     let source = "变量 x = 5 @ 3;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_err());
@@ -812,7 +812,7 @@ fn test_unterminated_string_error_message() {
     use qi_compiler::lexer::{Lexer, LexicalError};
 
     let source = "变量 message = \"hello world;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_err());
@@ -6,7 +6,7 @@ use qi_compiler::lexer::*;
 #[test]
 fn test_tokenization_of_basic_tokens() {
     let source = "(){},;:.";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let expected_kinds = vec![
@@ -30,7 +30,7 @@ fn test_tokenization_of_basic_tokens() {
 #[test]
 fn test_chinese_keywords() {
     let source = "如果 否则 当 对于 函数 返回 变量 常量 整数 字符串 布尔 浮点数";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let expected_keywords = vec![
@@ -58,7 +58,7 @@ fn test_chinese_keywords() {
 #[test]
 fn test_chinese_identifiers() {
     let source = "变量名 函数名 用户标识符";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // All Chinese characters should be recognized as identifiers
@@ -70,7 +70,7 @@ fn test_chinese_identifiers() {
 #[test]
 fn test_mixed_chinese_english() {
     let source = "变量 myVar = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let expected_kinds = vec![
@@ -92,7 +92,7 @@ fn test_mixed_chinese_english() {
 #[test]
 fn test_string_literals() {
     let source = r#"变量 消息 = "你好，世界！";"#;
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     assert_eq!(tokens[0].kind, TokenKind::变量);
@@ -106,14 +106,14 @@ fn test_string_literals() {
 #[test]
 fn test_numeric_literals() {
     let source = "42";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     assert_eq!(tokens[0].kind, TokenKind::整数字面量(42));
     
     // Test floats separately
     let source2 = "3.14";
-    let mut lexer2 = Lexer::new(source2.to_string());
+    let mut lexer2 = Lexer::new(source2);
     let tokens2 = lexer2.tokenize().unwrap();
     
     assert!(matches!(tokens2[0].kind, TokenKind::浮点数字面量));
@@ -122,7 +122,7 @@ fn test_numeric_literals() {
 #[test]
 fn test_character_literals() {
     let source = "'A' '中' '\\n'";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     assert_eq!(tokens.len(), 4); // 3 chars + EOF
@@ -134,7 +134,7 @@ fn test_character_literals() {
 #[test]
 fn test_operators() {
     let source = "+ - * / = == != < > <= >=";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let expected_operators = vec![
@@ -161,7 +161,7 @@ fn test_operators() {
 #[test]
 fn test_empty_input() {
     let source = "";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     assert_eq!(tokens.len(), 1);
@@ -171,7 +171,7 @@ fn test_empty_input() {
 #[test]
 fn test_whitespace_handling() {
     let source = "   \t\n  变量 x = 1;  \n\t";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // Should have: 变量, x, =, 1, ;, 文件结束
@@ -184,7 +184,7 @@ fn test_whitespace_handling() {
 #[test]
 fn test_invalid_character() {
     let source = "变量 x = @;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_err());
@@ -202,7 +202,7 @@ fn test_invalid_character() {
 #[test]
 fn test_unterminated_string() {
     let source = r#"变量 消息 = "未终止字符串"#;
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_err());
@@ -224,7 +224,7 @@ fn test_comments_are_skipped() {
     /** This is a doc block comment */
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // Should only tokenize the actual code, not comments
@@ -251,7 +251,7 @@ fn test_comments_are_skipped() {
 #[test]
 fn test_span_information() {
     let source = "x = 42";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // Test that span information is correctly recorded for simple tokens
@@ -267,7 +267,7 @@ fn test_span_information() {
 #[test]
 fn test_line_and_column_tracking() {
     let source = "变量 x = 1;\n变量 y = 2;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // First line
@@ -283,7 +283,7 @@ fn test_line_and_column_tracking() {
 #[test]
 fn test_diagnostics_collection() {
     let source = "变量 x = 5 @ 3;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let result = lexer.tokenize();
 
     assert!(result.is_err());
@@ -299,7 +299,7 @@ fn test_diagnostics_collection() {
 #[test]
 fn test_error_summary() {
     let source = "变量 x = 5 @ 3;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let _result = lexer.tokenize().unwrap_err();
 
     let (error_count, warning_count) = lexer.get_error_summary();
@@ -327,7 +327,7 @@ fn test_complex_source_tokenization() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // Should tokenize successfully
@@ -346,7 +346,7 @@ fn test_complex_source_tokenization() {
 #[test]
 fn test_arrows_and_special_tokens() {
     let source = "->";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     assert_eq!(tokens.len(), 2); // -> + EOF
@@ -356,7 +356,7 @@ fn test_arrows_and_special_tokens() {
 #[test]
 fn test_unicode_support() {
     let source = "变量 中文变量名 = '中';\n字符串 火箭 = \"火箭\";";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     // Should handle Unicode characters properly
@@ -13,7 +13,7 @@ fn test_package_declaration() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -33,7 +33,7 @@ fn test_import_statement() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -55,7 +55,7 @@ fn test_import_with_alias() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -73,7 +73,7 @@ fn test_public_function() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -98,7 +98,7 @@ fn test_private_function_default() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -124,7 +124,7 @@ fn test_public_struct() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
@@ -155,7 +155,7 @@ fn test_multiple_imports() {
 }
 "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
     let parser = Parser::new();
     let program = parser.parse(tokens).unwrap();
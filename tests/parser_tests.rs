@@ -7,7 +7,7 @@ use qi_compiler::parser::*;
 #[test]
 fn test_parse_empty_program() {
     let source = "";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -32,7 +32,7 @@ fn test_parse_direct_source() {
 #[test]
 fn test_parse_simple_variable_declaration() {
     let source = "变量 x = 10;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -46,7 +46,7 @@ fn test_parse_simple_variable_declaration() {
 #[test]
 fn test_parse_multiple_statements() {
     let source = "变量 x = 10; 变量 y = 20;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
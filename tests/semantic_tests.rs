@@ -47,7 +47,7 @@ fn test_semantic_analyzer_creation() {
 #[test]
 fn test_simple_variable_analysis() {
     let source = "变量 x = 42;";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -63,7 +63,7 @@ fn test_simple_variable_analysis() {
 #[test]
 fn test_function_declaration_analysis() {
     let source = "函数 test() { 返回 42; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -79,7 +79,7 @@ fn test_function_declaration_analysis() {
 #[test]
 fn test_if_statement_analysis() {
     let source = "如果 x > 5 { 变量 y = 10; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -95,7 +95,7 @@ fn test_if_statement_analysis() {
 #[test]
 fn test_while_statement_analysis() {
     let source = "当 i < 10 { i = i + 1; }";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -125,7 +125,7 @@ fn test_complex_program_analysis() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -206,7 +206,7 @@ fn test_nested_scope_analysis() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -250,7 +250,7 @@ fn test_symbol_table_error_handling() {
 #[test]
 fn test_analyzer_with_empty_program() {
     let source = "";
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();
@@ -322,7 +322,7 @@ fn test_multiple_error_accumulation() {
     }
     "#;
 
-    let mut lexer = Lexer::new(source.to_string());
+    let mut lexer = Lexer::new(source);
     let tokens = lexer.tokenize().unwrap();
 
     let parser = Parser::new();